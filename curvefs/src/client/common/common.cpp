@@ -36,6 +36,9 @@ std::ostream &operator<<(std::ostream &os, MetaServerOpType optype) {
     case MetaServerOpType::ListDentry:
         os << "ListDentry";
         break;
+    case MetaServerOpType::ListDentryPlus:
+        os << "ListDentryPlus";
+        break;
     case MetaServerOpType::CreateDentry:
         os << "CreateDentry";
         break;
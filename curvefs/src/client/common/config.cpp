@@ -203,6 +203,46 @@ void InitDiskCacheOption(Configuration *conf,
                               &diskCacheOption->avgReadFileBytes);
     conf->GetValueFatalIfFail("diskCache.avgReadFileIops",
                               &diskCacheOption->avgReadFileIops);
+    LOG_IF(WARNING, !conf->GetBoolValue("diskCache.segment.enable",
+                                        &diskCacheOption->segmentEnable))
+        << "Not found `diskCache.segment.enable` in conf, use default value `"
+        << std::boolalpha << diskCacheOption->segmentEnable << '`';
+    LOG_IF(WARNING, !conf->GetUInt64Value("diskCache.segment.size",
+                                          &diskCacheOption->segmentSize))
+        << "Not found `diskCache.segment.size` in conf, use default value `"
+        << diskCacheOption->segmentSize << '`';
+}
+
+void InitReadAheadOption(Configuration *conf,
+                         ReadAheadOption *readAheadOption) {
+    LOG_IF(WARNING, !conf->GetBoolValue("s3.readAhead.enable",
+                                        &readAheadOption->enable))
+        << "Not found `s3.readAhead.enable` in conf, use default value `"
+        << std::boolalpha << readAheadOption->enable << '`';
+    LOG_IF(WARNING, !conf->GetUInt64Value("s3.readAhead.minBytes",
+                                          &readAheadOption->minBytes))
+        << "Not found `s3.readAhead.minBytes` in conf, use default value `"
+        << readAheadOption->minBytes << '`';
+    LOG_IF(WARNING, !conf->GetUInt64Value("s3.readAhead.maxBytes",
+                                          &readAheadOption->maxBytes))
+        << "Not found `s3.readAhead.maxBytes` in conf, use default value `"
+        << readAheadOption->maxBytes << '`';
+    LOG_IF(FATAL, readAheadOption->minBytes == 0 ||
+                      readAheadOption->minBytes > readAheadOption->maxBytes)
+        << "Invalid read ahead window, minBytes: " << readAheadOption->minBytes
+        << ", maxBytes: " << readAheadOption->maxBytes;
+}
+
+void InitPageArenaOption(Configuration *conf,
+                         PageArenaOption *pageArenaOption) {
+    LOG_IF(WARNING, !conf->GetBoolValue("s3.pageArena.enable",
+                                        &pageArenaOption->enable))
+        << "Not found `s3.pageArena.enable` in conf, use default value `"
+        << std::boolalpha << pageArenaOption->enable << '`';
+    LOG_IF(WARNING, !conf->GetBoolValue("s3.pageArena.hugePage",
+                                        &pageArenaOption->hugePage))
+        << "Not found `s3.pageArena.hugePage` in conf, use default value `"
+        << std::boolalpha << pageArenaOption->hugePage << '`';
 }
 
 void InitS3Option(Configuration *conf, S3Option *s3Opt) {
@@ -221,6 +261,12 @@ void InitS3Option(Configuration *conf, S3Option *s3Opt) {
                               &s3Opt->s3ClientAdaptorOpt.chunkFlushThreads);
     conf->GetValueFatalIfFail("s3.writeCacheMaxByte",
                               &s3Opt->s3ClientAdaptorOpt.writeCacheMaxByte);
+    LOG_IF(WARNING, !conf->GetUInt64Value(
+                        "s3.writeCacheMaxBytePerFile",
+                        &s3Opt->s3ClientAdaptorOpt.writeCacheMaxBytePerFile))
+        << "Not found `s3.writeCacheMaxBytePerFile` in conf, "
+           "use default value `"
+        << s3Opt->s3ClientAdaptorOpt.writeCacheMaxBytePerFile << '`';
     conf->GetValueFatalIfFail("s3.readCacheMaxByte",
                               &s3Opt->s3ClientAdaptorOpt.readCacheMaxByte);
     conf->GetValueFatalIfFail("s3.readCacheThreads",
@@ -237,6 +283,8 @@ void InitS3Option(Configuration *conf, S3Option *s3Opt) {
     ::curve::common::InitS3AdaptorOptionExceptS3InfoOption(conf,
                                                            &s3Opt->s3AdaptrOpt);
     InitDiskCacheOption(conf, &s3Opt->s3ClientAdaptorOpt.diskCacheOpt);
+    InitReadAheadOption(conf, &s3Opt->s3ClientAdaptorOpt.readAheadOpt);
+    InitPageArenaOption(conf, &s3Opt->s3ClientAdaptorOpt.pageArenaOpt);
 }
 
 void InitVolumeOption(Configuration *conf, VolumeOption *volumeOpt) {
@@ -338,6 +386,16 @@ void InitFileSystemOption(Configuration* c, FileSystemOption* option) {
     {  // rpc option
         auto o = &option->rpcOption;
         c->GetValueFatalIfFail("fs.rpc.listDentryLimit", &o->listDentryLimit);
+        o->listDentryPlus = true;
+        o->listDentryPlusStreaming = true;
+        LOG_IF(WARNING, !c->GetBoolValue("fs.rpc.listDentryPlus",
+                                         &o->listDentryPlus))
+            << "Not found `fs.rpc.listDentryPlus` in conf, default: "
+            << o->listDentryPlus;
+        LOG_IF(WARNING, !c->GetBoolValue("fs.rpc.listDentryPlusStreaming",
+                                         &o->listDentryPlusStreaming))
+            << "Not found `fs.rpc.listDentryPlusStreaming` in conf, default: "
+            << o->listDentryPlusStreaming;
     }
     {  // defer sync option
         auto o = &option->deferSyncOption;
@@ -420,6 +478,8 @@ void SetFuseClientS3Option(FuseClientOption *clientOption,
     clientOption->s3Opt.s3ClientAdaptorOpt.blockSize = fsS3Opt.blockSize;
     clientOption->s3Opt.s3ClientAdaptorOpt.chunkSize = fsS3Opt.chunkSize;
     clientOption->s3Opt.s3ClientAdaptorOpt.objectPrefix = fsS3Opt.objectPrefix;
+    clientOption->s3Opt.s3ClientAdaptorOpt.objectCodec =
+        static_cast<curvefs::common::ObjectCodecType>(fsS3Opt.objectCodec);
     clientOption->s3Opt.s3AdaptrOpt.s3Address = fsS3Opt.s3Address;
     clientOption->s3Opt.s3AdaptrOpt.ak = fsS3Opt.ak;
     clientOption->s3Opt.s3AdaptrOpt.sk = fsS3Opt.sk;
@@ -435,6 +495,7 @@ void S3Info2FsS3Option(const curvefs::common::S3Info& s3,
     fsS3Opt->blockSize = s3.blocksize();
     fsS3Opt->chunkSize = s3.chunksize();
     fsS3Opt->objectPrefix = s3.has_objectprefix() ? s3.objectprefix() : 0;
+    fsS3Opt->objectCodec = s3.objectcodec();
 }
 
 }  // namespace common
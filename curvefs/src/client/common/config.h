@@ -65,6 +65,8 @@ struct ExcutorOpt {
     uint64_t maxRetryTimesBeforeConsiderSuspend = 20;
     uint32_t batchInodeAttrLimit = 10000;
     bool enableRenameParallel = false;
+    // set by filesystem info rather than configuration
+    bool enableFollowerRead = false;
 };
 
 struct LeaseOpt {
@@ -112,6 +114,27 @@ struct DiskCacheOption {
     uint64_t avgFlushIops;
     // the read throttle iops of disk cache
     uint64_t avgReadFileIops;
+    // keep read cache in segment files instead of one file per obj
+    bool segmentEnable = false;
+    // size of one segment file
+    uint64_t segmentSize = 256 * 1024 * 1024;
+};
+
+struct ReadAheadOption {
+    // read ahead sequential streams into memory read cache
+    bool enable = false;
+    // the first window of a stream, and the min size after shrinking
+    uint64_t minBytes = 1 * 1024 * 1024;
+    // the max window size
+    uint64_t maxBytes = 16 * 1024 * 1024;
+};
+
+struct PageArenaOption {
+    // allocate pages of memory cache from an arena of
+    // readCacheMaxByte + writeCacheMaxByte bytes
+    bool enable = false;
+    // ask for transparent huge pages of the arena
+    bool hugePage = false;
 };
 
 struct S3ClientAdaptorOption {
@@ -124,6 +147,9 @@ struct S3ClientAdaptorOption {
     uint32_t chunkFlushThreads;
     uint32_t flushIntervalSec;
     uint64_t writeCacheMaxByte;
+    // the writer of a file is throttled once the file has this many dirty
+    // bytes in write cache, |0| means only writeCacheMaxByte applies
+    uint64_t writeCacheMaxBytePerFile = 0;
     uint64_t readCacheMaxByte;
     uint32_t readCacheThreads;
     uint32_t nearfullRatio;
@@ -131,7 +157,12 @@ struct S3ClientAdaptorOption {
     uint32_t maxReadRetryIntervalMs;
     uint32_t readRetryIntervalMs;
     uint32_t objectPrefix;
+    // objects are encoded by the codec of the fs if it is not CODEC_NONE
+    curvefs::common::ObjectCodecType objectCodec =
+        curvefs::common::CODEC_NONE;
     DiskCacheOption diskCacheOpt;
+    ReadAheadOption readAheadOpt;
+    PageArenaOption pageArenaOpt;
 };
 
 struct S3Option {
@@ -203,6 +234,10 @@ struct OpenFilesOption {
 
 struct RPCOption {
     uint32_t listDentryLimit;
+    // list dentrys together with attributes for readdir
+    bool listDentryPlus;
+    // receive dentrys and attributes by stream
+    bool listDentryPlusStreaming;
 };
 
 struct DeferSyncOption {
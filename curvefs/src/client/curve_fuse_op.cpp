@@ -21,6 +21,9 @@
  * Author: xuchaojie
  */
 
+#include <sys/uio.h>
+
+#include <climits>
 #include <string>
 #include <memory>
 #include <cstring>
@@ -48,6 +51,7 @@
 
 using ::curve::common::Configuration;
 using ::curvefs::client::CURVEFS_ERROR;
+using ::curvefs::client::CacheSegment;
 using ::curvefs::client::FuseClient;
 using ::curvefs::client::FuseS3Client;
 using ::curvefs::client::FuseVolumeClient;
@@ -341,6 +345,27 @@ void QueryWarmup(fuse_req_t req, fuse_ino_t ino, size_t size) {
     return fs->ReplyBuffer(req, data.data(), data.length());
 }
 
+// reply pages of memory cache by writev, without copying them
+void ReplyCacheSegments(fuse_req_t req,
+                        const std::vector<CacheSegment>& segments) {
+    auto fs = Client()->GetFileSystem();
+    // one more iovec is used by fuse for the reply header
+    if (segments.size() < IOV_MAX) {
+        std::vector<struct iovec> iov(segments.size());
+        for (size_t i = 0; i < segments.size(); i++) {
+            iov[i].iov_base = const_cast<char*>(segments[i].data);
+            iov[i].iov_len = segments[i].len;
+        }
+        return fs->ReplyIov(req, iov.data(), iov.size());
+    }
+
+    std::string data;
+    for (const auto& segment : segments) {
+        data.append(segment.data, segment.len);
+    }
+    return fs->ReplyBuffer(req, data.data(), data.size());
+}
+
 void ReadThrottleAdd(size_t size) { Client()->Add(true, size); }
 void WriteThrottleAdd(size_t size) { Client()->Add(false, size); }
 
@@ -608,7 +633,6 @@ void FuseOpRead(fuse_req_t req,
                 struct fuse_file_info* fi) {
     CURVEFS_ERROR rc;
     size_t rSize = 0;
-    std::unique_ptr<char[]> buffer(new char[size]);
     auto client = Client();
     auto fs = client->GetFileSystem();
     MetricGuard(Read);
@@ -618,6 +642,15 @@ void FuseOpRead(fuse_req_t req,
     });
 
     ReadThrottleAdd(size);
+    // all in memory cache, reply the cached pages directly
+    std::vector<CacheSegment> segments;
+    if (client->FuseOpReadCacheSegments(ino, size, off, fi, &segments,
+                                        &rSize)) {
+        rc = CURVEFS_ERROR::OK;
+        return ReplyCacheSegments(req, segments);
+    }
+
+    std::unique_ptr<char[]> buffer(new char[size]);
     rc = client->FuseOpRead(req, ino, size, off, fi, buffer.get(), &rSize);
     if (rc != CURVEFS_ERROR::OK) {
         return fs->ReplyError(req, rc);
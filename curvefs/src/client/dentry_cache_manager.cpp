@@ -156,5 +156,47 @@ CURVEFS_ERROR DentryCacheManagerImpl::ListDentry(uint64_t parent,
     return CURVEFS_ERROR::OK;
 }
 
+CURVEFS_ERROR DentryCacheManagerImpl::ListDentryPlus(uint64_t parent,
+    std::list<Dentry> *dentryList,
+    std::map<uint64_t, InodeAttr> *attrs,
+    uint32_t limit, bool streaming) {
+    dentryList->clear();
+    attrs->clear();
+
+    std::string last = "";
+    while (true) {
+        std::list<Dentry> part;
+        std::list<InodeAttr> partAttrs;
+        MetaStatusCode ret = metaClient_->ListDentryPlus(
+            fsId_, parent, last, limit, streaming, &part, &partAttrs);
+        VLOG(6) << "ListDentryPlus fsId = " << fsId_ << ", parent = " << parent
+                << ", last = " << last << ", count = " << limit
+                << ", ret = " << ret << ", part.size() = " << part.size()
+                << ", partAttrs.size() = " << partAttrs.size();
+        if (ret != MetaStatusCode::OK) {
+            LOG(ERROR) << "metaClient_ ListDentryPlus failed"
+                       << ", MetaStatusCode_Name = " << MetaStatusCode_Name(ret)
+                       << ", parent = " << parent << ", last = " << last
+                       << ", count = " << limit;
+            return ToFSError(ret);
+        }
+
+        for (auto &attr : partAttrs) {
+            uint64_t ino = attr.inodeid();
+            attrs->emplace(ino, std::move(attr));
+        }
+        bool done = part.size() < limit;
+        if (!part.empty()) {
+            last = part.back().name();
+            dentryList->splice(dentryList->end(), part);
+        }
+        if (done) {
+            break;
+        }
+    }
+
+    return CURVEFS_ERROR::OK;
+}
+
 }  // namespace client
 }  // namespace curvefs
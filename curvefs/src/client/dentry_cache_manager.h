@@ -38,6 +38,7 @@
 #include "curvefs/src/client/filesystem/error.h"
 
 using ::curvefs::metaserver::Dentry;
+using ::curvefs::metaserver::InodeAttr;
 
 namespace curvefs {
 namespace client {
@@ -70,6 +71,13 @@ class DentryCacheManager {
         std::list<Dentry> *dentryList, uint32_t limit,
         bool onlyDir = false, uint32_t nlink = 0) = 0;
 
+    // list all dentrys of |parent| together with the attributes of their
+    // inodes in the same partition as |parent|
+    virtual CURVEFS_ERROR ListDentryPlus(uint64_t parent,
+        std::list<Dentry> *dentryList,
+        std::map<uint64_t, InodeAttr> *attrs,
+        uint32_t limit, bool streaming) = 0;
+
  protected:
     uint32_t fsId_;
 };
@@ -96,6 +104,11 @@ class DentryCacheManagerImpl : public DentryCacheManager {
         std::list<Dentry> *dentryList, uint32_t limit,
         bool dirOnly = false, uint32_t nlink = 0) override;
 
+    CURVEFS_ERROR ListDentryPlus(uint64_t parent,
+        std::list<Dentry> *dentryList,
+        std::map<uint64_t, InodeAttr> *attrs,
+        uint32_t limit, bool streaming) override;
+
     std::string GetDentryCacheKey(uint64_t parent, const std::string &name) {
         return std::to_string(parent) + kDentryKeyDelimiter + name;
     }
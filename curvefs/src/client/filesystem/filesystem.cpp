@@ -160,6 +160,10 @@ void FileSystem::ReplyBuffer(Request req, const char *buf, size_t size) {
     fuse_reply_buf(req, buf, size);
 }
 
+void FileSystem::ReplyIov(Request req, const struct iovec *iov, int count) {
+    fuse_reply_iov(req, iov, count);
+}
+
 void FileSystem::ReplyStatfs(Request req, const struct statvfs *stbuf) {
     fuse_reply_statfs(req, stbuf);
 }
@@ -301,6 +305,13 @@ CURVEFS_ERROR FileSystem::ReadDir(Request req,
         return rc;
     }
 
+    // the entries exist now, drop their negative lookup results
+    if (option_.lookupCacheOption.negativeTimeoutSec > 0) {
+        (*entries)->Iterate([&](DirEntry* dirEntry) {
+            negative_->Delete(ino, dirEntry->name);
+        });
+    }
+
     (*entries)->SetMtime(FindHandler(fi->fh)->mtime);
     dirCache_->Put(ino, *entries);
     return CURVEFS_ERROR::OK;
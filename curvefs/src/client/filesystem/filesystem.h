@@ -24,6 +24,7 @@
 #define CURVEFS_SRC_CLIENT_FILESYSTEM_FILESYSTEM_H_
 
 #include <gtest/gtest_prod.h>
+#include <sys/uio.h>
 
 #include <memory>
 #include <string>
@@ -108,6 +109,8 @@ class FileSystem {
 
     void ReplyBuffer(Request req, const char *buf, size_t size);
 
+    void ReplyIov(Request req, const struct iovec *iov, int count);
+
     void ReplyStatfs(Request req, const struct statvfs *stbuf);
 
     void ReplyXattr(Request req, size_t size);
@@ -75,17 +75,27 @@ CURVEFS_ERROR RPCClient::ReadDir(Ino ino,
     uint32_t limit = option_.listDentryLimit;
 
     std::list<Dentry> dentries;
-    CURVEFS_ERROR rc = dentryManager_->ListDentry(ino, &dentries, limit);
+    std::map<uint64_t, InodeAttr> attrs;
+    CURVEFS_ERROR rc;
+    if (option_.listDentryPlus) {
+        rc = dentryManager_->ListDentryPlus(ino, &dentries, &attrs, limit,
+                                            option_.listDentryPlusStreaming);
+    } else {
+        rc = dentryManager_->ListDentry(ino, &dentries, limit);
+    }
     if (rc != CURVEFS_ERROR::OK) {
         LOG(ERROR) << "rpc(readdir::ListDentry) failed, retCode = " << rc
                    << ", ino = " << ino;
         return rc;
     }
 
+    // only get attributes which are not returned with dentries,
+    // e.g. inodes in other partitions
     std::set<uint64_t> inos;
-    std::map<uint64_t, InodeAttr> attrs;
     std::for_each(dentries.begin(), dentries.end(), [&](Dentry& dentry){
-        inos.emplace(dentry.inodeid());
+        if (attrs.find(dentry.inodeid()) == attrs.end()) {
+            inos.emplace(dentry.inodeid());
+        }
     });
     rc = inodeManager_->BatchGetInodeAttrAsync(ino, &inos, &attrs);
     if (rc != CURVEFS_ERROR::OK) {
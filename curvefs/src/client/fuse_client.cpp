@@ -95,6 +95,7 @@ DECLARE_uint64(fuseClientBurstReadBytesSecs);
 namespace curvefs {
 namespace client {
 
+using common::ExcutorOpt;
 using common::MetaCacheOpt;
 using rpcclient::ChannelManager;
 using rpcclient::Cli2ClientImpl;
@@ -164,8 +165,12 @@ CURVEFS_ERROR FuseClient::Init(const FuseClientOption &option) {
         fs_ = std::make_shared<FileSystem>(option_.fileSystemOption, member);
     }
 
+    // follower read is enabled per filesystem
+    ExcutorOpt excutorOpt = option.excutorOpt;
+    excutorOpt.enableFollowerRead =
+        fsInfo_ != nullptr && fsInfo_->enablefollowerread();
     MetaStatusCode ret2 =
-        metaClient_->Init(option.excutorOpt, option.excutorInternalOpt,
+        metaClient_->Init(excutorOpt, option.excutorInternalOpt,
                           metaCache, channelManager);
     if (ret2 != MetaStatusCode::OK) {
         return CURVEFS_ERROR::INTERNAL;
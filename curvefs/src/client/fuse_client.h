@@ -149,6 +149,27 @@ class FuseClient {
                                      struct fuse_file_info* fi, char* buffer,
                                      size_t* rSize) = 0;
 
+    /**
+     * @brief read without copying if data is all in memory cache
+     * @param[out] segments reference the cached pages, which are kept alive
+     *             until segments are released
+     * @return false if data is not all in memory cache, FuseOpRead should
+     *         be used then
+     */
+    virtual bool FuseOpReadCacheSegments(fuse_ino_t ino, size_t size,
+                                         off_t off,
+                                         struct fuse_file_info* fi,
+                                         std::vector<CacheSegment>* segments,
+                                         size_t* rSize) {
+        (void)ino;
+        (void)size;
+        (void)off;
+        (void)fi;
+        (void)segments;
+        (void)rSize;
+        return false;
+    }
+
     virtual CURVEFS_ERROR FuseOpLookup(fuse_req_t req,
                                        fuse_ino_t parent,
                                        const char* name,
@@ -21,6 +21,7 @@
  */
 
 
+#include <algorithm>
 #include <memory>
 #include <vector>
 
@@ -262,21 +263,58 @@ CURVEFS_ERROR FuseS3Client::FuseOpRead(fuse_req_t req, fuse_ino_t ino,
         return CURVEFS_ERROR::INTERNAL;
     }
     *rSize = rRet;
+    OnReadDone(inodeWrapper, *rSize, start);
 
+    VLOG(9) << "read end, read size = " << *rSize;
+    return ret;
+}
+
+bool FuseS3Client::FuseOpReadCacheSegments(fuse_ino_t ino, size_t size,
+                                           off_t off,
+                                           struct fuse_file_info *fi,
+                                           std::vector<CacheSegment> *segments,
+                                           size_t *rSize) {
+    // leave the checks of direct io to FuseOpRead
+    if (fi->flags & O_DIRECT) {
+        return false;
+    }
+
+    uint64_t start = butil::cpuwide_time_us();
+    std::shared_ptr<InodeWrapper> inodeWrapper;
+    if (inodeManager_->GetInode(ino, inodeWrapper) != CURVEFS_ERROR::OK) {
+        return false;
+    }
+    uint64_t fileSize = inodeWrapper->GetLength();
+    if (size == 0 || static_cast<int64_t>(fileSize) <= off) {
+        return false;
+    }
+    size_t len = std::min<uint64_t>(size, fileSize - off);
+
+    if (!s3Adaptor_->ReadCacheSegments(ino, off, len, segments)) {
+        return false;
+    }
+    *rSize = len;
+    OnReadDone(inodeWrapper, *rSize, start);
+
+    VLOG(9) << "read cache segments end, read size = " << *rSize
+            << ", segments = " << segments->size();
+    return true;
+}
+
+void FuseS3Client::OnReadDone(
+    const std::shared_ptr<InodeWrapper> &inodeWrapper, size_t rSize,
+    uint64_t start) {
     if (fsMetric_.get() != nullptr) {
-        fsMetric_->userRead.bps.count << rRet;
+        fsMetric_->userRead.bps.count << rSize;
         fsMetric_->userRead.qps.count << 1;
         uint64_t duration = butil::cpuwide_time_us() - start;
         fsMetric_->userRead.latency << duration;
-        fsMetric_->userReadIoSize.set_value(rRet);
+        fsMetric_->userReadIoSize.set_value(rSize);
     }
 
     ::curve::common::UniqueLock lgGuard = inodeWrapper->GetUniqueLock();
     inodeWrapper->UpdateTimestampLocked(kAccessTime);
     inodeManager_->ShipToFlush(inodeWrapper);
-
-    VLOG(9) << "read end, read size = " << *rSize;
-    return ret;
 }
 
 CURVEFS_ERROR FuseS3Client::FuseOpCreate(fuse_req_t req, fuse_ino_t parent,
@@ -371,6 +409,14 @@ CURVEFS_ERROR FuseS3Client::Truncate(InodeWrapper *inode, uint64_t length) {
     return s3Adaptor_->Truncate(inode, length);
 }
 
+CURVEFS_ERROR FuseS3Client::FuseOpRelease(fuse_req_t req, fuse_ino_t ino,
+                                          struct fuse_file_info *fi) {
+    CURVEFS_ERROR rc = FuseClient::FuseOpRelease(req, ino, fi);
+    // prefetched data is useless after close
+    s3Adaptor_->CancelReadAhead(ino);
+    return rc;
+}
+
 CURVEFS_ERROR FuseS3Client::FuseOpFlush(fuse_req_t req, fuse_ino_t ino,
                                         struct fuse_file_info *fi) {
     (void)req;
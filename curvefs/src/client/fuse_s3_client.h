@@ -89,6 +89,11 @@ class FuseS3Client : public FuseClient {
         char *buffer,
         size_t *rSize) override;
 
+    bool FuseOpReadCacheSegments(fuse_ino_t ino, size_t size, off_t off,
+                                 struct fuse_file_info *fi,
+                                 std::vector<CacheSegment> *segments,
+                                 size_t *rSize) override;
+
     CURVEFS_ERROR FuseOpCreate(fuse_req_t req,
                                fuse_ino_t parent,
                                const char* name,
@@ -118,6 +123,9 @@ class FuseS3Client : public FuseClient {
     CURVEFS_ERROR FuseOpFlush(fuse_req_t req, fuse_ino_t ino,
         struct fuse_file_info *fi) override;
 
+    CURVEFS_ERROR FuseOpRelease(fuse_req_t req, fuse_ino_t ino,
+        struct fuse_file_info *fi) override;
+
     CURVEFS_ERROR Truncate(InodeWrapper *inode, uint64_t length) override;
 
  private:
@@ -125,6 +133,10 @@ class FuseS3Client : public FuseClient {
 
     void FlushData() override;
 
+    // update metrics and access time after read
+    void OnReadDone(const std::shared_ptr<InodeWrapper> &inodeWrapper,
+                    size_t rSize, uint64_t start);
+
  private:
     // s3 adaptor
     std::shared_ptr<S3ClientAdaptor> s3Adaptor_;
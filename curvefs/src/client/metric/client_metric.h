@@ -74,6 +74,7 @@ struct MetaServerClientMetric {
     // dentry
     InterfaceMetric getDentry;
     InterfaceMetric listDentry;
+    InterfaceMetric listDentryPlus;
     InterfaceMetric createDentry;
     InterfaceMetric deleteDentry;
 
@@ -96,6 +97,7 @@ struct MetaServerClientMetric {
 
     MetaServerClientMetric()
         : getDentry(prefix, "getDentry"), listDentry(prefix, "listDentry"),
+          listDentryPlus(prefix, "listDentryPlus"),
           createDentry(prefix, "createDentry"),
           deleteDentry(prefix, "deleteDentry"), getInode(prefix, "getInode"),
           batchGetInodeAttr(prefix, "batchGetInodeAttr"),
@@ -198,6 +200,8 @@ struct S3MultiManagerMetric {
     bvar::Adder<int64_t> writeDataCacheByte;
     bvar::Adder<int64_t> readDataCacheNum;
     bvar::Adder<int64_t> readDataCacheByte;
+    bvar::Adder<int64_t> pageArenaUsedByte;
+    bvar::Adder<int64_t> pageArenaOverflowByte;
 
     S3MultiManagerMetric() {
         fileManagerNum.expose_as(prefix, "file_manager_num");
@@ -206,6 +210,8 @@ struct S3MultiManagerMetric {
         writeDataCacheByte.expose_as(prefix, "write_data_cache_byte");
         readDataCacheNum.expose_as(prefix, "read_data_cache_num");
         readDataCacheByte.expose_as(prefix, "read_data_cache_byte");
+        pageArenaUsedByte.expose_as(prefix, "page_arena_used_byte");
+        pageArenaOverflowByte.expose_as(prefix, "page_arena_overflow_byte");
     }
 };
 
@@ -240,6 +246,17 @@ struct S3Metric {
     InterfaceMetric adaptorReadDiskCache;
     bvar::Status<uint32_t> readSize;
     bvar::Status<uint32_t> writeSize;
+    // reads in read ahead range served by memory cache or not
+    bvar::Adder<uint64_t> readAheadHit;
+    bvar::Adder<uint64_t> readAheadMiss;
+    bvar::Adder<uint64_t> readAheadBytes;
+    bvar::Status<uint64_t> readAheadWindow;
+    // reads served by an inflight download of the same object
+    bvar::Adder<uint64_t> readDedupHit;
+    bvar::Adder<uint64_t> readDedupBytes;
+    // objects encoded by the codec of the fs
+    InterfaceMetric adaptorEncodeObject;
+    bvar::Adder<int64_t> encodeSavedBytes;
 
     explicit S3Metric(const std::string &name = "")
         : fsName(!name.empty() ? name
@@ -251,7 +268,15 @@ struct S3Metric {
           adaptorReadS3(prefix, fsName + "_adaptor_read_s3"),
           adaptorReadDiskCache(prefix, fsName + "_adaptor_read_disk_cache"),
           readSize(prefix, fsName + "_adaptor_read_size", 0),
-          writeSize(prefix, fsName + "_adaptor_write_size", 0) {}
+          writeSize(prefix, fsName + "_adaptor_write_size", 0),
+          readAheadHit(prefix, fsName + "_adaptor_readahead_hit"),
+          readAheadMiss(prefix, fsName + "_adaptor_readahead_miss"),
+          readAheadBytes(prefix, fsName + "_adaptor_readahead_bytes"),
+          readAheadWindow(prefix, fsName + "_adaptor_readahead_window", 0),
+          readDedupHit(prefix, fsName + "_adaptor_read_dedup_hit"),
+          readDedupBytes(prefix, fsName + "_adaptor_read_dedup_bytes"),
+          adaptorEncodeObject(prefix, fsName + "_adaptor_encode_object"),
+          encodeSavedBytes(prefix, fsName + "_adaptor_encode_saved_bytes") {}
 };
 
 struct DiskCacheMetric {
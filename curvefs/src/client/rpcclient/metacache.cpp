@@ -555,6 +555,68 @@ bool MetaCache::GetPartitionIdByInodeId(uint32_t fsID, uint64_t inodeID,
     return true;
 }
 
+void MetaCache::UpdateAppliedIndex(const CopysetGroupID &groupID,
+                                   uint64_t appliedIndex) {
+    const auto key = CalcLogicPoolCopysetID(groupID);
+    {
+        ReadLockGuard rl(rwlock4AppliedIndex_);
+        auto iter = appliedIndex_.find(key);
+        if (iter != appliedIndex_.end() && iter->second >= appliedIndex) {
+            return;
+        }
+    }
+
+    WriteLockGuard wl(rwlock4AppliedIndex_);
+    auto &index = appliedIndex_[key];
+    index = std::max(index, appliedIndex);
+}
+
+uint64_t MetaCache::GetAppliedIndex(const CopysetGroupID &groupID) {
+    const auto key = CalcLogicPoolCopysetID(groupID);
+    ReadLockGuard rl(rwlock4AppliedIndex_);
+    auto iter = appliedIndex_.find(key);
+    return iter == appliedIndex_.end() ? 0 : iter->second;
+}
+
+void MetaCache::SelectReadReplica(CopysetTarget *target) {
+    CopysetInfo<MetaserverID> copysetInfo;
+    if (!GetCopysetInfowithCopySetID(target->groupID, &copysetInfo) ||
+        copysetInfo.csinfos_.empty()) {
+        return;
+    }
+
+    // choose the faster one of two random replicas, rather than the fastest
+    // one, so that requests of all clients won't rush to the same replica
+    const auto &peers = copysetInfo.csinfos_;
+    auto index = butil::fast_rand() % peers.size();
+    auto another = butil::fast_rand() % peers.size();
+    if (GetServerLatency(peers[another].peerID) <
+        GetServerLatency(peers[index].peerID)) {
+        index = another;
+    }
+
+    target->metaServerID = peers[index].peerID;
+    target->endPoint = peers[index].externalAddr.addr_;
+}
+
+void MetaCache::UpdateServerLatency(MetaserverID id, uint64_t latencyUs) {
+    std::lock_guard<Mutex> lg(latencyMutex_);
+    auto iter = serverLatencyUs_.find(id);
+    if (iter == serverLatencyUs_.end()) {
+        serverLatencyUs_.emplace(id, latencyUs);
+    } else {
+        // exponential moving average, the weight of new latency is 1/8
+        iter->second = (iter->second * 7 + latencyUs) / 8;
+    }
+}
+
+uint64_t MetaCache::GetServerLatency(MetaserverID id) {
+    // metaserver which has never served requests is preferred
+    std::lock_guard<Mutex> lg(latencyMutex_);
+    auto iter = serverLatencyUs_.find(id);
+    return iter == serverLatencyUs_.end() ? 0 : iter->second;
+}
+
 }  // namespace rpcclient
 }  // namespace client
 }  // namespace curvefs
@@ -147,6 +147,23 @@ class MetaCache {
     virtual bool GetPartitionIdByInodeId(uint32_t fsID, uint64_t inodeID,
                                          PartitionID *pid);
 
+    // Record the applied index returned by metaserver of the copyset. It's
+    // only a hint for followers to redirect requests at once if they fall
+    // behind, linearizability is guaranteed by the leader's read index.
+    virtual void UpdateAppliedIndex(const CopysetGroupID &groupID,
+                                    uint64_t appliedIndex);
+
+    // Return 0 if no request of the copyset has returned
+    virtual uint64_t GetAppliedIndex(const CopysetGroupID &groupID);
+
+    // Select a replica of target's copyset to serve readonly request, and
+    // replica with lower latency is preferred. Target is unchanged if
+    // the copyset is unknown.
+    virtual void SelectReadReplica(CopysetTarget *target);
+
+    // Record latency of a readonly request served by the metaserver
+    virtual void UpdateServerLatency(MetaserverID id, uint64_t latencyUs);
+
     bool RefreshTxId();
 
     // list or create partitions for fs
@@ -185,6 +202,8 @@ class MetaCache {
     bool GetCopysetInfowithCopySetID(const CopysetGroupID &groupID,
                                      CopysetInfo<MetaserverID> *targetInfo);
 
+    uint64_t GetServerLatency(MetaserverID id);
+
 
     // key tansform
     static PoolIDCopysetID
@@ -201,6 +220,12 @@ class MetaCache {
     PartitionInfoList partitionInfos_;
     RWLock rwlock4copysetInfoMap_;
     CopysetInfoMap copysetInfoMap_;
+    RWLock rwlock4AppliedIndex_;
+    std::unordered_map<PoolIDCopysetID, uint64_t> appliedIndex_;
+
+    // moving average of readonly requests' latency of each metaserver
+    Mutex latencyMutex_;
+    std::unordered_map<MetaserverID, uint64_t> serverLatencyUs_;
 
     Mutex createMutex_;
 
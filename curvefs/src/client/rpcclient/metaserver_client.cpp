@@ -55,6 +55,7 @@ namespace rpcclient {
 using CreateDentryExcutor = TaskExecutor;
 using GetDentryExcutor = TaskExecutor;
 using ListDentryExcutor = TaskExecutor;
+using ListDentryPlusExcutor = TaskExecutor;
 using DeleteDentryExcutor = TaskExecutor;
 using PrepareRenameTxExcutor = TaskExecutor;
 using DeleteInodeExcutor = TaskExecutor;
@@ -94,6 +95,16 @@ MetaStatusCode MetaServerClientImpl::Init(
         uint64_t txId, brpc::Channel * channel,                                \
         brpc::Controller * cntl, TaskExecutorDone * taskExecutorDone) -> int
 
+// Record the applied index of the copyset which serves the request, and the
+// following readonly requests must see it, see MetaCache::UpdateAppliedIndex
+template <typename ResponseT>
+void UpdateAppliedIndex(MetaCache *metaCache, const CopysetGroupID &groupID,
+                        const ResponseT &response) {
+    if (response.has_appliedindex()) {
+        metaCache->UpdateAppliedIndex(groupID, response.appliedindex());
+    }
+}
+
 class MetaServerClientRpcDoneBase : public google::protobuf::Closure {
  public:
     MetaServerClientRpcDoneBase(TaskExecutorDone *done,
@@ -137,6 +148,11 @@ MetaStatusCode MetaServerClientImpl::GetDentry(uint32_t fsId, uint64_t inodeid,
         request.set_name(name);
         request.set_txid(txId);
 
+        if (opt_.enableFollowerRead) {
+            request.set_appliedindex(
+                metaCache_->GetAppliedIndex({poolID, copysetID}));
+        }
+
         curvefs::metaserver::MetaServerService_Stub stub(channel);
         stub.GetDentry(cntl, &request, &response, nullptr);
 
@@ -149,6 +165,7 @@ MetaStatusCode MetaServerClientImpl::GetDentry(uint32_t fsId, uint64_t inodeid,
             return -cntl->ErrorCode();
         }
         MetaStatusCode ret = response.statuscode();
+        UpdateAppliedIndex(metaCache_.get(), {poolID, copysetID}, response);
 
         if (ret != MetaStatusCode::OK) {
             LOG_IF(WARNING, ret != MetaStatusCode::NOT_FOUND)
@@ -174,6 +191,7 @@ MetaStatusCode MetaServerClientImpl::GetDentry(uint32_t fsId, uint64_t inodeid,
     auto taskCtx = std::make_shared<TaskContext>(MetaServerOpType::GetDentry,
                                                  task, fsId, inodeid, false,
                                                  opt_.enableRenameParallel);
+    taskCtx->followerRead = opt_.enableFollowerRead;
     GetDentryExcutor excutor(opt_, metaCache_, channelManager_,
                              std::move(taskCtx));
     return ConvertToMetaStatusCode(excutor.DoRPCTask());
@@ -199,6 +217,11 @@ MetaStatusCode MetaServerClientImpl::ListDentry(uint32_t fsId, uint64_t inodeid,
         request.set_count(count);
         request.set_onlydir(onlyDir);
 
+        if (opt_.enableFollowerRead) {
+            request.set_appliedindex(
+                metaCache_->GetAppliedIndex({poolID, copysetID}));
+        }
+
         curvefs::metaserver::MetaServerService_Stub stub(channel);
         stub.ListDentry(cntl, &request, &response, nullptr);
 
@@ -212,6 +235,7 @@ MetaStatusCode MetaServerClientImpl::ListDentry(uint32_t fsId, uint64_t inodeid,
         }
 
         MetaStatusCode ret = response.statuscode();
+        UpdateAppliedIndex(metaCache_.get(), {poolID, copysetID}, response);
         if (ret != MetaStatusCode::OK) {
             LOG(WARNING) << "ListDentry: fsId = " << fsId
                          << ", inodeid = " << inodeid << ", last = " << last
@@ -232,11 +256,137 @@ MetaStatusCode MetaServerClientImpl::ListDentry(uint32_t fsId, uint64_t inodeid,
     auto taskCtx = std::make_shared<TaskContext>(MetaServerOpType::ListDentry,
                                                  task, fsId, inodeid, false,
                                                  opt_.enableRenameParallel);
+    taskCtx->followerRead = opt_.enableFollowerRead;
     ListDentryExcutor excutor(opt_, metaCache_, channelManager_,
                               std::move(taskCtx));
     return ConvertToMetaStatusCode(excutor.DoRPCTask());
 }
 
+namespace {
+
+struct ParseDentryPlusCallBack {
+    explicit ParseDentryPlusCallBack(metaserver::DentryPlusList *list)
+        : entries(list) {}
+
+    bool operator()(butil::IOBuf *data) const {
+        metaserver::DentryPlusList batch;
+        if (!brpc::ParsePbFromIOBuf(&batch, *data)) {
+            LOG(ERROR) << "Failed to parse dentry plus list";
+            return false;
+        }
+
+        entries->MergeFrom(batch);
+        return true;
+    }
+
+    metaserver::DentryPlusList *entries;
+};
+
+}  // namespace
+
+MetaStatusCode MetaServerClientImpl::ListDentryPlus(
+    uint32_t fsId, uint64_t inodeid, const std::string &last, uint32_t count,
+    bool streaming, std::list<Dentry> *dentryList,
+    std::list<InodeAttr> *attrs) {
+    auto task = RPCTask {
+        (void)taskExecutorDone;
+        metric_.listDentryPlus.qps.count << 1;
+        LatencyUpdater updater(&metric_.listDentryPlus.latency);
+        metaserver::ListDentryPlusRequest request;
+        metaserver::ListDentryPlusResponse response;
+        request.set_poolid(poolID);
+        request.set_copysetid(copysetID);
+        request.set_partitionid(partitionID);
+        request.set_fsid(fsId);
+        request.set_dirinodeid(inodeid);
+        request.set_txid(txId);
+        request.set_last(last);
+        request.set_count(count);
+        request.set_streaming(streaming);
+
+        if (opt_.enableFollowerRead) {
+            request.set_appliedindex(
+                metaCache_->GetAppliedIndex({poolID, copysetID}));
+        }
+
+        // for streaming, filled by the receive callback
+        metaserver::DentryPlusList entries;
+        std::shared_ptr<StreamConnection> connection;
+        auto closeConn = absl::MakeCleanup([this, &connection]() {
+            if (connection != nullptr) {
+                streamClient_.Close(connection);
+            }
+        });
+
+        if (streaming) {
+            StreamOptions opts(opt_.rpcStreamIdleTimeoutMS);
+            connection = streamClient_.Connect(
+                cntl, ParseDentryPlusCallBack{&entries}, opts);
+            if (connection == nullptr) {
+                LOG(ERROR) << "Failed to connection remote side, ino: "
+                           << inodeid << ", poolid: " << poolID
+                           << ", copysetid: " << copysetID
+                           << ", remote side: " << cntl->remote_side();
+                return MetaStatusCode::RPC_STREAM_ERROR;
+            }
+        }
+
+        curvefs::metaserver::MetaServerService_Stub stub(channel);
+        stub.ListDentryPlus(cntl, &request, &response, nullptr);
+
+        if (cntl->Failed()) {
+            metric_.listDentryPlus.eps.count << 1;
+            LOG(WARNING) << "ListDentryPlus Failed, errorcode = "
+                         << cntl->ErrorCode()
+                         << ", error content:" << cntl->ErrorText()
+                         << ", log id = " << cntl->log_id();
+            return -cntl->ErrorCode();
+        }
+
+        MetaStatusCode ret = response.statuscode();
+        UpdateAppliedIndex(metaCache_.get(), {poolID, copysetID}, response);
+        if (ret != MetaStatusCode::OK) {
+            LOG(WARNING) << "ListDentryPlus: fsId = " << fsId
+                         << ", inodeid = " << inodeid << ", last = " << last
+                         << ", count = " << count << ", errcode = " << ret
+                         << ", errmsg = " << MetaStatusCode_Name(ret);
+            return ret;
+        }
+
+        if (streaming) {
+            auto status = connection->WaitAllDataReceived();
+            if (status != StreamStatus::STREAM_OK) {
+                LOG(ERROR) << "Failed to receive data, status: " << status;
+                return MetaStatusCode::RPC_STREAM_ERROR;
+            }
+        } else {
+            entries.mutable_dentrys()->Swap(response.mutable_dentrys());
+            entries.mutable_attr()->Swap(response.mutable_attr());
+        }
+
+        for (auto &dentry : *entries.mutable_dentrys()) {
+            dentryList->push_back(std::move(dentry));
+        }
+        for (auto &attr : *entries.mutable_attr()) {
+            attrs->push_back(std::move(attr));
+        }
+
+        VLOG(6) << "ListDentryPlus done, fsId = " << fsId
+                << ", inodeid = " << inodeid << ", last = " << last
+                << ", dentrys = " << entries.dentrys_size()
+                << ", attrs = " << entries.attr_size();
+        return ret;
+    };
+
+    auto taskCtx = std::make_shared<TaskContext>(
+        MetaServerOpType::ListDentryPlus, task, fsId, inodeid, streaming,
+        opt_.enableRenameParallel);
+    taskCtx->followerRead = opt_.enableFollowerRead;
+    ListDentryPlusExcutor excutor(opt_, metaCache_, channelManager_,
+                                  std::move(taskCtx));
+    return ConvertToMetaStatusCode(excutor.DoRPCTask());
+}
+
 MetaStatusCode MetaServerClientImpl::CreateDentry(const Dentry &dentry) {
     auto task = RPCTask {
         (void)taskExecutorDone;
@@ -274,6 +424,7 @@ MetaStatusCode MetaServerClientImpl::CreateDentry(const Dentry &dentry) {
         }
 
         MetaStatusCode ret = response.statuscode();
+        UpdateAppliedIndex(metaCache_.get(), {poolID, copysetID}, response);
         if (ret != MetaStatusCode::OK) {
             LOG(WARNING) << "CreateDentry:  dentry = " << dentry.DebugString()
                          << ", errcode = " << ret
@@ -329,6 +480,7 @@ MetaStatusCode MetaServerClientImpl::DeleteDentry(uint32_t fsId,
         }
 
         MetaStatusCode ret = response.statuscode();
+        UpdateAppliedIndex(metaCache_.get(), {poolID, copysetID}, response);
         if (ret != MetaStatusCode::OK) {
             LOG(WARNING) << "DeleteDentry:  fsid = " << fsId
                          << ", inodeid = " << inodeid << ", name = " << name
@@ -376,6 +528,7 @@ MetaServerClientImpl::PrepareRenameTx(const std::vector<Dentry> &dentrys) {
         }
 
         auto rc = response.statuscode();
+        UpdateAppliedIndex(metaCache_.get(), {poolID, copysetID}, response);
         if (rc != MetaStatusCode::OK) {
             LOG(WARNING) << "PrepareRenameTx: retCode = " << rc
                          << ", message = " << MetaStatusCode_Name(rc);
@@ -411,6 +564,11 @@ MetaStatusCode MetaServerClientImpl::GetInode(uint32_t fsId, uint64_t inodeid,
         request.set_inodeid(inodeid);
         request.set_supportstreaming(true);
 
+        if (opt_.enableFollowerRead) {
+            request.set_appliedindex(
+                metaCache_->GetAppliedIndex({poolID, copysetID}));
+        }
+
         curvefs::metaserver::MetaServerService_Stub stub(channel);
         stub.GetInode(cntl, &request, &response, nullptr);
 
@@ -423,6 +581,7 @@ MetaStatusCode MetaServerClientImpl::GetInode(uint32_t fsId, uint64_t inodeid,
         }
 
         MetaStatusCode ret = response.statuscode();
+        UpdateAppliedIndex(metaCache_.get(), {poolID, copysetID}, response);
         if (ret != MetaStatusCode::OK) {
             LOG_IF(WARNING, ret != MetaStatusCode::NOT_FOUND)
                 << "GetInode: inodeid:" << inodeid << ", errcode = " << ret
@@ -448,6 +607,7 @@ MetaStatusCode MetaServerClientImpl::GetInode(uint32_t fsId, uint64_t inodeid,
 
     auto taskCtx = std::make_shared<TaskContext>(MetaServerOpType::GetInode,
                                                  task, fsId, inodeid);
+    taskCtx->followerRead = opt_.enableFollowerRead;
     GetInodeExcutor excutor(opt_, metaCache_, channelManager_,
                             std::move(taskCtx));
     return ConvertToMetaStatusCode(excutor.DoRPCTask());
@@ -524,6 +684,7 @@ void BatchGetInodeAttrRpcDone::Run() {
     }
 
     MetaStatusCode ret = response.statuscode();
+    UpdateAppliedIndex(metaCache.get(), taskCtx->target.groupID, response);
     if (ret != MetaStatusCode::OK) {
         LOG(WARNING) << "batchGetInodeAttr failed"
                      << ", errcode = " << ret
@@ -568,6 +729,11 @@ MetaServerClientImpl::BatchGetInodeAttr(uint32_t fsId,
             request.set_fsid(fsId);
             *request.mutable_inodeid() = {it.begin(), it.end()};
 
+            if (opt_.enableFollowerRead) {
+                request.set_appliedindex(
+                    metaCache_->GetAppliedIndex({poolID, copysetID}));
+            }
+
             curvefs::metaserver::MetaServerService_Stub stub(channel);
             stub.BatchGetInodeAttr(cntl, &request, &response, nullptr);
 
@@ -581,6 +747,7 @@ MetaServerClientImpl::BatchGetInodeAttr(uint32_t fsId,
             }
 
             MetaStatusCode ret = response.statuscode();
+            UpdateAppliedIndex(metaCache_.get(), {poolID, copysetID}, response);
             if (ret != MetaStatusCode::OK) {
                 LOG(WARNING) << "BatchGetInodeAttr failed, errcode = " << ret
                              << ", errmsg = " << MetaStatusCode_Name(ret);
@@ -599,6 +766,7 @@ MetaServerClientImpl::BatchGetInodeAttr(uint32_t fsId,
         };
         auto taskCtx = std::make_shared<TaskContext>(
             MetaServerOpType::BatchGetInodeAttr, task, fsId, inodeId);
+        taskCtx->followerRead = opt_.enableFollowerRead;
         BatchGetInodeAttrExcutor excutor(opt_, metaCache_, channelManager_,
                                          std::move(taskCtx));
         auto ret = ConvertToMetaStatusCode(excutor.DoRPCTask());
@@ -629,6 +797,10 @@ MetaStatusCode MetaServerClientImpl::BatchGetInodeAttrAsync(
         request.set_partitionid(partitionID);
         request.set_fsid(fsId);
         *request.mutable_inodeid() = {inodeIds.begin(), inodeIds.end()};
+        if (opt_.enableFollowerRead) {
+            request.set_appliedindex(
+                metaCache_->GetAppliedIndex({poolID, copysetID}));
+        }
         auto *rpcDone =
             new BatchGetInodeAttrRpcDone(taskExecutorDone, &metric_);
         curvefs::metaserver::MetaServerService_Stub stub(channel);
@@ -637,6 +809,7 @@ MetaStatusCode MetaServerClientImpl::BatchGetInodeAttrAsync(
     };
     auto taskCtx = std::make_shared<TaskContext>(
         MetaServerOpType::BatchGetInodeAttr, task, fsId, *inodeIds.begin());
+    taskCtx->followerRead = opt_.enableFollowerRead;
     auto excutor = std::make_shared<BatchGetInodeAttrExcutor>(
         opt_, metaCache_, channelManager_, std::move(taskCtx));
     TaskExecutorDone *taskDone =
@@ -676,6 +849,11 @@ MetaServerClientImpl::BatchGetXAttr(uint32_t fsId,
             request.set_fsid(fsId);
             *request.mutable_inodeid() = {it.begin(), it.end()};
 
+            if (opt_.enableFollowerRead) {
+                request.set_appliedindex(
+                    metaCache_->GetAppliedIndex({poolID, copysetID}));
+            }
+
             curvefs::metaserver::MetaServerService_Stub stub(channel);
             stub.BatchGetXAttr(cntl, &request, &response, nullptr);
 
@@ -689,6 +867,7 @@ MetaServerClientImpl::BatchGetXAttr(uint32_t fsId,
             }
 
             MetaStatusCode ret = response.statuscode();
+            UpdateAppliedIndex(metaCache_.get(), {poolID, copysetID}, response);
             if (ret != MetaStatusCode::OK) {
                 LOG(WARNING) << "BatchGetXAttr failed, errcode = " << ret
                              << ", errmsg = " << MetaStatusCode_Name(ret);
@@ -707,6 +886,7 @@ MetaServerClientImpl::BatchGetXAttr(uint32_t fsId,
         };
         auto taskCtx = std::make_shared<TaskContext>(
             MetaServerOpType::BatchGetInodeAttr, task, fsId, inodeId);
+        taskCtx->followerRead = opt_.enableFollowerRead;
         BatchGetInodeAttrExcutor excutor(opt_, metaCache_, channelManager_,
                                          std::move(taskCtx));
         auto ret = ConvertToMetaStatusCode(excutor.DoRPCTask());
@@ -746,6 +926,7 @@ MetaServerClientImpl::UpdateInode(const UpdateInodeRequest &request,
         }
 
         MetaStatusCode ret = response.statuscode();
+        UpdateAppliedIndex(metaCache_.get(), {poolID, copysetID}, response);
         if (ret != MetaStatusCode::OK) {
             LOG(WARNING) << "UpdateInode:  request: " << request.DebugString()
                          << ", errcode = " << ret
@@ -866,6 +1047,7 @@ void UpdateInodeRpcDone::Run() {
     }
 
     MetaStatusCode ret = response.statuscode();
+    UpdateAppliedIndex(metaCache.get(), taskCtx->target.groupID, response);
     if (ret != MetaStatusCode::OK) {
         LOG(WARNING) << "UpdateInode:  inodeid = " << taskCtx->inodeID
                      << ", errcode = " << ret
@@ -1009,6 +1191,7 @@ MetaStatusCode MetaServerClientImpl::GetOrModifyS3ChunkInfo(
         }
 
         MetaStatusCode ret = response.statuscode();
+        UpdateAppliedIndex(metaCache_.get(), {poolID, copysetID}, response);
         if (ret != MetaStatusCode::OK) {
             LOG(WARNING) << "GetOrModifyS3ChunkInfo, inodeId: " << inodeId
                          << ", fsId: " << fsId << ", errorcode: " << ret
@@ -1072,6 +1255,7 @@ void GetOrModifyS3ChunkInfoRpcDone::Run() {
     }
 
     MetaStatusCode ret = response.statuscode();
+    UpdateAppliedIndex(metaCache.get(), taskCtx->target.groupID, response);
     if (ret != MetaStatusCode::OK) {
         LOG(WARNING) << "GetOrModifyS3ChunkInfo, inodeId: " << taskCtx->inodeID
                      << ", fsId: " << taskCtx->fsID << ", errorcode: " << ret
@@ -1160,6 +1344,7 @@ MetaStatusCode MetaServerClientImpl::CreateInode(const InodeParam &param,
         }
 
         MetaStatusCode ret = response.statuscode();
+        UpdateAppliedIndex(metaCache_.get(), {poolID, copysetID}, response);
         if (ret != MetaStatusCode::OK) {
             LOG(WARNING) << "CreateInode:  param = " << param
                          << ", errcode = " << ret
@@ -1222,6 +1407,7 @@ MetaStatusCode MetaServerClientImpl::CreateManageInode(const InodeParam &param,
         }
 
         MetaStatusCode ret = response.statuscode();
+        UpdateAppliedIndex(metaCache_.get(), {poolID, copysetID}, response);
         if (ret != MetaStatusCode::OK) {
             LOG(WARNING) << "CreateManageInode:  param = " << param
                          << ", errcode = " << ret
@@ -1279,6 +1465,7 @@ MetaStatusCode MetaServerClientImpl::DeleteInode(uint32_t fsId,
         }
 
         MetaStatusCode ret = response.statuscode();
+        UpdateAppliedIndex(metaCache_.get(), {poolID, copysetID}, response);
         if (ret != MetaStatusCode::OK) {
             LOG(WARNING) << "DeleteInode:  fsid = " << fsId
                          << ", inodeid = " << inodeid << ", errcode = " << ret
@@ -1322,6 +1509,7 @@ void UpdateVolumeExtentRpcDone::Run() {
     }
 
     auto st = response.statuscode();
+    UpdateAppliedIndex(metaCache.get(), taskCtx->target.groupID, response);
     if (st != MetaStatusCode::OK) {
         metric_->updateVolumeExtent.eps.count << 1;
         LOG(WARNING) << "UpdateVolumeExtent failed, error: "
@@ -1440,6 +1628,7 @@ MetaServerClientImpl::GetVolumeExtent(uint32_t fsId, uint64_t inodeId,
         }
 
         auto st = response.statuscode();
+        UpdateAppliedIndex(metaCache_.get(), {poolID, copysetID}, response);
         if (st != MetaStatusCode::OK) {
             metric_.getVolumeExtent.eps.count << 1;
             LOG(WARNING) << "GetVolumeExtent failed, inodeid: " << inodeId
@@ -1500,6 +1689,7 @@ MetaStatusCode MetaServerClientImpl::UpdateDeallocatableBlockGroup(
         }
 
         auto rc = response.statuscode();
+        UpdateAppliedIndex(metaCache_.get(), {poolID, copysetID}, response);
         if (rc != MetaStatusCode::OK) {
             metric_.updateDeallocatableBlockGroup.eps.count << 1;
             LOG(WARNING) << "UpdateDeallocatableBlockGroup: retCode = " << rc
@@ -92,6 +92,14 @@ class MetaServerClient {
                                       bool onlyDir,
                                       std::list<Dentry> *dentryList) = 0;
 
+    // list dentrys with the attributes of their inodes which are in the same
+    // partition as |inodeid|, attributes of other inodes are not returned
+    virtual MetaStatusCode ListDentryPlus(uint32_t fsId, uint64_t inodeid,
+                                          const std::string &last,
+                                          uint32_t count, bool streaming,
+                                          std::list<Dentry> *dentryList,
+                                          std::list<InodeAttr> *attrs) = 0;
+
     virtual MetaStatusCode CreateDentry(const Dentry &dentry) = 0;
 
     virtual MetaStatusCode DeleteDentry(uint32_t fsId, uint64_t inodeid,
@@ -200,6 +208,12 @@ class MetaServerClientImpl : public MetaServerClient {
                               bool onlyDir,
                               std::list<Dentry> *dentryList) override;
 
+    MetaStatusCode ListDentryPlus(uint32_t fsId, uint64_t inodeid,
+                                  const std::string &last, uint32_t count,
+                                  bool streaming,
+                                  std::list<Dentry> *dentryList,
+                                  std::list<InodeAttr> *attrs) override;
+
     MetaStatusCode CreateDentry(const Dentry &dentry) override;
 
     MetaStatusCode DeleteDentry(uint32_t fsId, uint64_t inodeid,
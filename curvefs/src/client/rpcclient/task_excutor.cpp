@@ -115,6 +115,10 @@ int TaskExecutor::DoRPCTaskInner(TaskExecutorDone *done) {
 bool TaskExecutor::OnReturn(int retCode) {
     bool needRetry = false;
 
+    if (task_->followerRead) {
+        UpdateServerLatency(retCode);
+    }
+
     // rpc fail
     if (retCode < 0) {
         needRetry = true;
@@ -225,6 +229,10 @@ bool TaskExecutor::GetTarget() {
         LOG(ERROR) << "fetch target for task fail, " << task_->TaskContextStr();
         return false;
     }
+
+    if (task_->followerRead) {
+        metaCache_->SelectReadReplica(&task_->target);
+    }
     return true;
 }
 
@@ -246,12 +254,27 @@ bool TaskExecutor::OnPartitionNotExist() {
     return metaCache_->ListPartitions(task_->fsID);
 }
 
-void TaskExecutor::OnReDirected() { RefreshLeader(); }
+void TaskExecutor::OnReDirected() {
+    if (!task_->followerRead) {
+        RefreshLeader();
+        return;
+    }
+
+    // the replica can't serve the request, e.g., it's a follower which falls
+    // behind, so retry on the cached leader directly
+    task_->followerRead = false;
+    MetaserverID oldTarget = task_->target.metaServerID;
+    bool ok = metaCache_->GetTargetLeader(&task_->target);
+    task_->retryDirectly = ok && oldTarget != task_->target.metaServerID;
+}
 
 void TaskExecutor::RefreshLeader() {
     // refresh leader according to copyset
     MetaserverID oldTarget = task_->target.metaServerID;
 
+    // retry on leader only, as the replica may be unavailable
+    task_->followerRead = false;
+
     bool ok =
         metaCache_->GetTargetLeader(&task_->target, true);
 
@@ -264,6 +287,14 @@ void TaskExecutor::RefreshLeader() {
     task_->retryDirectly = (oldTarget != task_->target.metaServerID);
 }
 
+void TaskExecutor::UpdateServerLatency(int retCode) {
+    // failed metaserver is treated as slow one, so the following requests
+    // prefer other replicas
+    uint64_t latencyUs = retCode < 0 ? task_->rpcTimeoutMs * 1000
+                                     : task_->cntl_.latency_us();
+    metaCache_->UpdateServerLatency(task_->target.metaServerID, latencyUs);
+}
+
 void TaskExecutor::OnPartitionAllocIDFail() {
     metaCache_->MarkPartitionUnavailable(task_->target.partitionID);
     task_->target.Reset();
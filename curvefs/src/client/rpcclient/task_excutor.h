@@ -83,7 +83,8 @@ class TaskContext {
         std::ostringstream oss;
         oss << "{" << optype << ",fsid=" << fsID << ",inodeid=" << inodeID
             << ",streaming=" << streaming
-            << ",refreshTxId=" << refreshTxId << "}";
+            << ",refreshTxId=" << refreshTxId
+            << ",followerRead=" << followerRead << "}";
         return oss.str();
     }
 
@@ -107,6 +108,10 @@ class TaskContext {
 
     bool refreshTxId = false;
 
+    // whether readonly request can be sent to followers, it's reset after
+    // retry on leader
+    bool followerRead = false;
+
     brpc::Controller cntl_;
 };
 
@@ -156,6 +161,7 @@ class TaskExecutor {
 
     // retry policy
     void RefreshLeader();
+    void UpdateServerLatency(int retCode);
     uint64_t OverLoadBackOff();
     uint64_t TimeoutBackOff();
     void SetRetryParam();
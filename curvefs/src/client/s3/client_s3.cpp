@@ -21,11 +21,17 @@
  */
 #include "curvefs/src/client/s3/client_s3.h"
 
+#include "src/common/concurrent/count_down_event.h"
+
 namespace curvefs {
 namespace client {
 
 void S3ClientImpl::Init(const curve::common::S3AdapterOption &option) {
     s3Adapter_->Init(option);
+    if (option.transferOpt.partSize > 0) {
+        transferEngine_.reset(new curve::common::S3TransferEngine(
+            s3Adapter_.get(), option.transferOpt));
+    }
 }
 
 void S3ClientImpl::Deinit() {
@@ -38,7 +44,11 @@ int S3ClientImpl::Upload(const std::string &name, const char *buf,
     const Aws::String aws_key(name.c_str(), name.size());
 
     VLOG(9) << "upload start, aws_key:" << aws_key << ",length:" << length;
-    ret = s3Adapter_->PutObject(aws_key, buf, length);
+    if (transferEngine_ != nullptr) {
+        ret = transferEngine_->PutObject(name, buf, length);
+    } else {
+        ret = s3Adapter_->PutObject(aws_key, buf, length);
+    }
     if (ret < 0) {
         LOG(WARNING) << "upload error:" << ret;
     }
@@ -58,10 +68,39 @@ void S3ClientImpl::UploadAsync(
 
 int S3ClientImpl::Download(const std::string &name, char *buf, uint64_t offset,
                            uint64_t length) {
+    curve::common::CountDownEvent event(1);
+    bool served = false;
+    auto flight = readFlight_.JoinOrLead(name, offset, length, buf,
+                                         [&](bool ok) {
+                                             served = ok;
+                                             event.Signal();
+                                         });
+    if (flight == nullptr) {
+        VLOG(9) << "download join inflight read, name:" << name
+                << ",offset:" << offset << ",length:" << length;
+        event.Wait();
+        if (served) {
+            OnDedup(length);
+            return 0;
+        }
+        return DoDownload(name, buf, offset, length);
+    }
+
+    int ret = DoDownload(name, buf, offset, length);
+    readFlight_.Finish(flight, buf, ret < 0 ? 0 : length);
+    return ret;
+}
+
+int S3ClientImpl::DoDownload(const std::string &name, char *buf,
+                             uint64_t offset, uint64_t length) {
     int ret = 0;
     VLOG(9) << "download start, name:" << name << ",offset:" << offset
             << ",length:" << length;
-    ret = s3Adapter_->GetObject(name, buf, offset, length);
+    if (transferEngine_ != nullptr) {
+        ret = transferEngine_->GetObject(name, buf, offset, length);
+    } else {
+        ret = s3Adapter_->GetObject(name, buf, offset, length);
+    }
     if (ret < 0) {
         const Aws::String aws_key(name.c_str(), name.size());
         if (!s3Adapter_->ObjectExist(aws_key)) {
@@ -80,8 +119,41 @@ void S3ClientImpl::DownloadAsync(
     VLOG(9) << "download async start, name:" << context->key
             << ",offset:" << context->offset << ",length:" << context->len;
 
+    auto adapter = s3Adapter_;
+    auto flight = readFlight_.JoinOrLead(
+        context->key, context->offset, context->len, context->buf,
+        [this, adapter, context](bool served) {
+            if (!served) {
+                adapter->GetObjectAsync(context);
+                return;
+            }
+            OnDedup(context->len);
+            context->retCode = 0;
+            context->actualLen = context->len;
+            context->cb(adapter.get(), context);
+        });
+    if (flight == nullptr) {
+        return;
+    }
+
+    // serve the waiters before the caller takes the buffer back
+    auto originCallback = context->cb;
+    context->cb = [this, flight, originCallback](
+                      const curve::common::S3Adapter *adapter,
+                      const std::shared_ptr<GetObjectAsyncContext> &ctx) {
+        readFlight_.Finish(flight, ctx->buf,
+                           ctx->retCode == 0 ? ctx->actualLen : 0);
+        ctx->cb = originCallback;
+        ctx->cb(adapter, ctx);
+    };
     s3Adapter_->GetObjectAsync(context);
-    return;
+}
+
+void S3ClientImpl::OnDedup(uint64_t length) {
+    if (metric_ != nullptr) {
+        metric_->readDedupHit << 1;
+        metric_->readDedupBytes << length;
+    }
 }
 
 }  // namespace client
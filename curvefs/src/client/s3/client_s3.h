@@ -24,13 +24,17 @@
 
 #include <string>
 #include <memory>
+#include "curvefs/src/client/metric/client_metric.h"
+#include "curvefs/src/client/s3/client_s3_single_flight.h"
 #include "src/common/s3_adapter.h"
+#include "src/common/s3_transfer_engine.h"
 
 namespace curvefs {
 namespace client {
 
 using curve::common::GetObjectAsyncContext;
 using curve::common::PutObjectAsyncContext;
+using curvefs::client::metric::S3Metric;
 
 namespace common {
 DECLARE_bool(useFakeS3);
@@ -50,6 +54,9 @@ class S3Client {
                          uint64_t length) = 0;
     virtual void DownloadAsync(
         std::shared_ptr<GetObjectAsyncContext> context) = 0;
+    virtual void InitMetrics(std::shared_ptr<S3Metric> metric) {
+        (void)metric;
+    }
 };
 
 class S3ClientImpl : public S3Client {
@@ -71,12 +78,29 @@ class S3ClientImpl : public S3Client {
     int Download(const std::string& name, char* buf, uint64_t offset,
                  uint64_t length);
     void DownloadAsync(std::shared_ptr<GetObjectAsyncContext> context);
+    void InitMetrics(std::shared_ptr<S3Metric> metric) {
+        metric_ = metric;
+    }
     void SetAdapter(std::shared_ptr<curve::common::S3Adapter> adapter) {
         s3Adapter_ = adapter;
+        if (transferEngine_ != nullptr) {
+            transferEngine_.reset(new curve::common::S3TransferEngine(
+                s3Adapter_.get(), s3Adapter_->GetTransferOption()));
+        }
     }
 
+ private:
+    int DoDownload(const std::string& name, char* buf, uint64_t offset,
+                   uint64_t length);
+    void OnDedup(uint64_t length);
+
  private:
     std::shared_ptr<curve::common::S3Adapter> s3Adapter_;
+    // split large objects into parts transferred concurrently
+    std::unique_ptr<curve::common::S3TransferEngine> transferEngine_;
+    // concurrent downloads of the same object share one request
+    ReadSingleFlight readFlight_;
+    std::shared_ptr<S3Metric> metric_;
 };
 
 }  // namespace client
@@ -53,14 +53,17 @@ S3ClientAdaptorImpl::Init(
     }
     prefetchBlocks_ = option.prefetchBlocks;
     prefetchExecQueueNum_ = option.prefetchExecQueueNum;
+    readAheadOption_ = option.readAheadOpt;
     diskCacheType_ = option.diskCacheOpt.diskCacheType;
     memCacheNearfullRatio_ = option.nearfullRatio;
     throttleBaseSleepUs_ = option.baseSleepUs;
     flushIntervalSec_ = option.flushIntervalSec;
     chunkFlushThreads_ = option.chunkFlushThreads;
+    writeCacheMaxBytePerFile_ = option.writeCacheMaxBytePerFile;
     maxReadRetryIntervalMs_ = option.maxReadRetryIntervalMs;
     readRetryIntervalMs_ = option.readRetryIntervalMs;
     objectPrefix_ = option.objectPrefix;
+    objectCodec_ = option.objectCodec;
     client_ = client;
     inodeManager_ = inodeManager;
     mdsClient_ = mdsClient;
@@ -68,6 +71,15 @@ S3ClientAdaptorImpl::Init(
     waitInterval_.Init(option.intervalSec * 1000);
     diskCacheManagerImpl_ = diskCacheManagerImpl;
     kvClientManager_ = std::move(kvClientManager);
+    if (option.pageArenaOpt.enable) {
+        pageArena_ = std::make_shared<PageArena>(
+            pageSize_, option.readCacheMaxByte + option.writeCacheMaxByte,
+            option.pageArenaOpt.hugePage);
+        if (!pageArena_->Init()) {
+            LOG(ERROR) << "Init page arena failed";
+            return CURVEFS_ERROR::INTERNAL;
+        }
+    }
     if (HasDiskCache()) {
         diskCacheManagerImpl_ = diskCacheManagerImpl;
         if (diskCacheManagerImpl_->Init(option) < 0) {
@@ -94,15 +106,22 @@ S3ClientAdaptorImpl::Init(
               << ", chunk size: " << chunkSize_
               << ", prefetchBlocks: " << prefetchBlocks_
               << ", prefetchExecQueueNum: " << prefetchExecQueueNum_
+              << ", readAhead: " << readAheadOption_.enable
+              << ", readAheadMinBytes: " << readAheadOption_.minBytes
+              << ", readAheadMaxBytes: " << readAheadOption_.maxBytes
               << ", intervalSec: " << option.intervalSec
               << ", flushIntervalSec: " << option.flushIntervalSec
               << ", writeCacheMaxByte: " << option.writeCacheMaxByte
+              << ", writeCacheMaxBytePerFile: "
+              << option.writeCacheMaxBytePerFile
               << ", readCacheMaxByte: " << option.readCacheMaxByte
               << ", readCacheThreads: " << option.readCacheThreads
               << ", nearfullRatio: " << option.nearfullRatio
-              << ", baseSleepUs: " << option.baseSleepUs;
+              << ", baseSleepUs: " << option.baseSleepUs
+              << ", objectCodec: "
+              << curvefs::common::ObjectCodecType_Name(objectCodec_);
     // start chunk flush threads
-    taskPool_.Start(chunkFlushThreads_);
+    flushScheduler_.Start(chunkFlushThreads_);
     return CURVEFS_ERROR::OK;
 }
 
@@ -111,19 +130,28 @@ int S3ClientAdaptorImpl::Write(uint64_t inodeId, uint64_t offset,
     VLOG(6) << "write start offset:" << offset << ", len:" << length
             << ", fsId:" << fsId_ << ", inodeId:" << inodeId;
     uint64_t start = butil::cpuwide_time_us();
-    {
-        std::lock_guard<std::mutex> lockGuard(ioMtx_);
-        fsCacheManager_->DataCacheByteInc(length);
-        uint64_t size = fsCacheManager_->GetDataCacheSize();
-        const uint64_t maxSize = fsCacheManager_->GetDataCacheMaxSize();
-        if (size >= maxSize) {
-            VLOG(6) << "write cache is full, wait flush. size: " << size
-                    << ", maxSize: " << maxSize;
-            // offer to do flush
-            waitInterval_.StopWait();
-            fsCacheManager_->WaitFlush();
+    fsCacheManager_->DataCacheByteInc(length);
+    FileCacheManagerPtr fileCacheManager =
+        fsCacheManager_->FindOrCreateFileCacheManager(fsId_, inodeId);
+    if (NeedThrottleWrite(fileCacheManager->GetDirtyBytes())) {
+        // only the writer of a file which holds too much dirty data pays,
+        // by flushing its own file
+        VLOG(6) << "write cache of inode: " << inodeId
+                << " is too large, flush it. dirty bytes: "
+                << fileCacheManager->GetDirtyBytes();
+        // offer to do flush
+        waitInterval_.StopWait();
+        FlushScheduler::SyncGuard guard(&flushScheduler_, inodeId);
+        fileCacheManager->Flush(false, false);
+        if (NeedThrottleWrite(fileCacheManager->GetDirtyBytes())) {
+            // no data cache is full or old enough, e.g. random writes
+            fileCacheManager->Flush(true, false);
         }
     }
+    if (pageArena_ != nullptr && pageArena_->IsExhausted()) {
+        // make room for the pages of this write
+        fsCacheManager_->ReclaimReadCache(length + pageSize_);
+    }
     const uint64_t memCacheRatio = fsCacheManager_->MemCacheRatio();
     int64_t exceedRatio = memCacheRatio - memCacheNearfullRatio_;
     if (exceedRatio > 0) {
@@ -140,8 +168,6 @@ int S3ClientAdaptorImpl::Write(uint64_t inodeId, uint64_t offset,
                     << memCacheRatio << ", exponent is: " << exponent;
         }
     }
-    FileCacheManagerPtr fileCacheManager =
-        fsCacheManager_->FindOrCreateFileCacheManager(fsId_, inodeId);
     int ret = fileCacheManager->Write(offset, length, buf);
     fsCacheManager_->DataCacheByteDec(length);
     if (s3Metric_ != nullptr) {
@@ -152,6 +178,26 @@ int S3ClientAdaptorImpl::Write(uint64_t inodeId, uint64_t offset,
     return ret;
 }
 
+bool S3ClientAdaptorImpl::NeedThrottleWrite(uint64_t fileDirtyBytes) {
+    uint64_t size = fsCacheManager_->GetDataCacheSize();
+    const uint64_t maxSize = fsCacheManager_->GetDataCacheMaxSize();
+    if (fileDirtyBytes == 0) {
+        return false;
+    }
+    if (writeCacheMaxBytePerFile_ > 0 &&
+        fileDirtyBytes >= writeCacheMaxBytePerFile_) {
+        return true;
+    }
+    // when write cache is full, throttle files holding more than an even
+    // share of it, the others go on
+    if (size < maxSize) {
+        return false;
+    }
+    uint64_t fileNum = std::max<uint64_t>(fsCacheManager_->GetDirtyFileNum(),
+                                          1);
+    return fileDirtyBytes >= size / fileNum;
+}
+
 int S3ClientAdaptorImpl::Read(uint64_t inodeId, uint64_t offset,
                               uint64_t length, char *buf) {
     VLOG(6) << "read start offset:" << offset << ", len:" << length
@@ -174,6 +220,72 @@ int S3ClientAdaptorImpl::Read(uint64_t inodeId, uint64_t offset,
     return ret;
 }
 
+bool S3ClientAdaptorImpl::ReadCacheSegments(
+    uint64_t inodeId, uint64_t offset, uint64_t length,
+    std::vector<CacheSegment> *segments) {
+    uint64_t start = butil::cpuwide_time_us();
+    FileCacheManagerPtr fileCacheManager =
+        fsCacheManager_->FindFileCacheManager(inodeId);
+    if (!fileCacheManager ||
+        !fileCacheManager->ReadCacheSegments(offset, length, segments)) {
+        return false;
+    }
+    if (s3Metric_ != nullptr) {
+        CollectMetrics(&s3Metric_->adaptorRead, length, start);
+        s3Metric_->readSize.set_value(length);
+    }
+    VLOG(6) << "read cache segments end, inodeId: " << inodeId
+            << ", offset: " << offset << ", len: " << length
+            << ", segments: " << segments->size();
+    return true;
+}
+
+bool S3ClientAdaptorImpl::EncodeObject(const char *data, uint64_t length,
+                                       std::string *out) {
+    uint64_t start = butil::cpuwide_time_us();
+    if (!S3ObjectCodec::Encode(objectCodec_, blockSize_, data, length, out)) {
+        return false;
+    }
+    if (s3Metric_ != nullptr) {
+        CollectMetrics(&s3Metric_->adaptorEncodeObject, length, start);
+        s3Metric_->encodeSavedBytes << static_cast<int64_t>(length) -
+                                           static_cast<int64_t>(out->size());
+    }
+    return true;
+}
+
+int S3ClientAdaptorImpl::ReadObject(const std::string &name, bool compressed,
+                                    const S3ObjectCodec::RangeReader &reader,
+                                    uint64_t offset, uint64_t length,
+                                    char *buf) {
+    if (!compressed) {
+        return reader(offset, length, buf);
+    }
+
+    // the header is read once and kept, then a read only needs the frames
+    std::string header;
+    bool cached = objectHeaderCache_.Get(name, &header);
+    if (!cached) {
+        header.resize(S3ObjectCodec::HeaderSize(blockSize_));
+        int ret = reader(0, header.size(), &header[0]);
+        if (ret < 0) {
+            return ret;
+        }
+    }
+    int ret = S3ObjectCodec::DecodeRange(blockSize_, header, reader, offset,
+                                         length, buf);
+    if (ret < 0) {
+        LOG(WARNING) << "read compressed object " << name
+                     << " fail, offset: " << offset << ", len: " << length
+                     << ", ret: " << ret;
+        return ret;
+    }
+    if (!cached) {
+        objectHeaderCache_.Put(name, header);
+    }
+    return ret;
+}
+
 CURVEFS_ERROR S3ClientAdaptorImpl::Truncate(InodeWrapper *inodeWrapper,
                                             uint64_t size) {
     const auto *inode = inodeWrapper->GetInodeLocked();
@@ -257,6 +369,16 @@ void S3ClientAdaptorImpl::ReleaseCache(uint64_t inodeId) {
     return;
 }
 
+void S3ClientAdaptorImpl::CancelReadAhead(uint64_t inodeId) {
+    FileCacheManagerPtr fileCacheManager =
+        fsCacheManager_->FindFileCacheManager(inodeId);
+    if (!fileCacheManager) {
+        return;
+    }
+    VLOG(9) << "CancelReadAhead inode:" << inodeId;
+    fileCacheManager->CancelReadAhead();
+}
+
 CURVEFS_ERROR S3ClientAdaptorImpl::Flush(uint64_t inodeId) {
     FileCacheManagerPtr fileCacheManager =
         fsCacheManager_->FindFileCacheManager(inodeId);
@@ -264,6 +386,7 @@ CURVEFS_ERROR S3ClientAdaptorImpl::Flush(uint64_t inodeId) {
         return CURVEFS_ERROR::OK;
     }
     VLOG(6) << "Flush data of inodeId:" << inodeId;
+    FlushScheduler::SyncGuard guard(&flushScheduler_, inodeId);
     return fileCacheManager->Flush(true, false);
 }
 
@@ -319,7 +442,7 @@ int S3ClientAdaptorImpl::Stop() {
         }
         diskCacheManagerImpl_->UmountDiskCache();
     }
-    taskPool_.Stop();
+    flushScheduler_.Stop();
     client_->Deinit();
     return 0;
 }
@@ -343,6 +466,7 @@ int S3ClientAdaptorImpl::ExecAsyncDownloadTask(
 void S3ClientAdaptorImpl::InitMetrics(const std::string &fsName) {
     fsName_ = fsName;
     s3Metric_ = std::make_shared<S3Metric>(fsName);
+    client_->InitMetrics(s3Metric_);
     if (HasDiskCache()) {
         diskCacheManagerImpl_->InitMetrics(fsName);
     }
@@ -365,7 +489,11 @@ CURVEFS_ERROR S3ClientAdaptorImpl::FlushAllCache(uint64_t inodeId) {
 
     // force flush data in memory to s3
     VLOG(6) << "FlushAllCache, flush memory data of inodeId:" << inodeId;
-    CURVEFS_ERROR ret = fileCacheManager->Flush(true, false);
+    CURVEFS_ERROR ret;
+    {
+        FlushScheduler::SyncGuard guard(&flushScheduler_, inodeId);
+        ret = fileCacheManager->Flush(true, false);
+    }
     if (ret != CURVEFS_ERROR::OK) {
         return ret;
     }
@@ -396,7 +524,7 @@ void S3ClientAdaptorImpl::Enqueue(
     auto task = [this, context]() {
         this->FlushChunkClosure(context);
     };
-    taskPool_.Enqueue(task);
+    flushScheduler_.Enqueue(context->inode, task);
 }
 
 int S3ClientAdaptorImpl::FlushChunkClosure(
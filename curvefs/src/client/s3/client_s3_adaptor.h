@@ -38,7 +38,10 @@
 #include "curvefs/src/client/rpcclient/mds_client.h"
 #include "curvefs/src/client/s3/client_s3.h"
 #include "curvefs/src/client/s3/client_s3_cache_manager.h"
+#include "curvefs/src/client/s3/client_s3_flush_scheduler.h"
 #include "curvefs/src/client/s3/disk_cache_manager_impl.h"
+#include "curvefs/src/common/s3_object_codec.h"
+#include "src/common/lru_cache.h"
 #include "src/common/wait_interval.h"
 namespace curvefs {
 namespace client {
@@ -52,6 +55,8 @@ using curvefs::metaserver::S3ChunkInfo;
 using curvefs::metaserver::S3ChunkInfoList;
 using rpcclient::MdsClient;
 using curvefs::client::metric::S3Metric;
+using curvefs::common::ObjectCodecType;
+using curvefs::common::S3ObjectCodec;
 
 class DiskCacheManagerImpl;
 class FlushChunkCacheContext;
@@ -81,9 +86,16 @@ class S3ClientAdaptor {
                       const char *buf) = 0;
     virtual int Read(uint64_t inodeId, uint64_t offset, uint64_t length,
                      char *buf) = 0;
+    // read without copying if the range is all in memory read cache,
+    // segments reference the cached pages
+    virtual bool ReadCacheSegments(uint64_t inodeId, uint64_t offset,
+                                   uint64_t length,
+                                   std::vector<CacheSegment> *segments) = 0;
     virtual CURVEFS_ERROR Truncate(InodeWrapper *inodeWrapper,
                                    uint64_t size) = 0;
     virtual void ReleaseCache(uint64_t inodeId) = 0;
+    // stop reading ahead for the file, it is closed
+    virtual void CancelReadAhead(uint64_t inodeId) = 0;
     virtual CURVEFS_ERROR Flush(uint64_t inodeId) = 0;
     virtual CURVEFS_ERROR FlushAllCache(uint64_t inodeId) = 0;
     virtual CURVEFS_ERROR FsSync() = 0;
@@ -139,8 +151,11 @@ class S3ClientAdaptorImpl : public S3ClientAdaptor {
     int Write(uint64_t inodeId, uint64_t offset, uint64_t length,
               const char *buf);
     int Read(uint64_t inodeId, uint64_t offset, uint64_t length, char *buf);
+    bool ReadCacheSegments(uint64_t inodeId, uint64_t offset, uint64_t length,
+                           std::vector<CacheSegment> *segments);
     CURVEFS_ERROR Truncate(InodeWrapper *inodeWrapper, uint64_t size);
     void ReleaseCache(uint64_t inodeId);
+    void CancelReadAhead(uint64_t inodeId);
     CURVEFS_ERROR Flush(uint64_t inodeId);
     CURVEFS_ERROR FlushAllCache(uint64_t inodeId);
     CURVEFS_ERROR FsSync();
@@ -154,6 +169,16 @@ class S3ClientAdaptorImpl : public S3ClientAdaptor {
     uint32_t GetObjectPrefix() {
         return objectPrefix_;
     }
+    ObjectCodecType GetObjectCodec() {
+        return objectCodec_;
+    }
+    // encode the data of an object to be stored by the codec of the fs
+    bool EncodeObject(const char *data, uint64_t length, std::string *out);
+    // read |length| bytes at |offset| of the data in object |name|, the
+    // object is read as stored by |reader|, and decoded if |compressed|
+    int ReadObject(const std::string &name, bool compressed,
+                   const S3ObjectCodec::RangeReader &reader, uint64_t offset,
+                   uint64_t length, char *buf);
 
     std::shared_ptr<FsCacheManager> GetFsCacheManager() {
         return fsCacheManager_;
@@ -163,6 +188,13 @@ class S3ClientAdaptorImpl : public S3ClientAdaptor {
     uint32_t GetPrefetchBlocks() {
         return prefetchBlocks_;
     }
+    const ReadAheadOption &GetReadAheadOption() const {
+        return readAheadOption_;
+    }
+    // nullptr if page arena is disabled
+    std::shared_ptr<PageArena> GetPageArena() {
+        return pageArena_;
+    }
     uint32_t GetDiskCacheType() {
         return diskCacheType_;
     }
@@ -221,8 +253,13 @@ class S3ClientAdaptorImpl : public S3ClientAdaptor {
     }
 
  private:
+    static const uint64_t kObjectHeaderCacheNum = 4096;
+
     void BackGroundFlush();
 
+    // whether the writer of a file should flush the file before writing
+    bool NeedThrottleWrite(uint64_t fileDirtyBytes);
+
     using AsyncDownloadTask = std::function<void()>;
 
     static int ExecAsyncDownloadTask(void* meta, bthread::TaskIterator<AsyncDownloadTask>& iter);  // NOLINT
@@ -251,18 +288,24 @@ class S3ClientAdaptorImpl : public S3ClientAdaptor {
     uint64_t chunkSize_;
     uint32_t prefetchBlocks_;
     uint32_t prefetchExecQueueNum_;
+    ReadAheadOption readAheadOption_;
+    std::shared_ptr<PageArena> pageArena_;
     std::string allocateServerEps_;
     uint32_t flushIntervalSec_;
     uint32_t chunkFlushThreads_;
+    uint64_t writeCacheMaxBytePerFile_;
     uint32_t memCacheNearfullRatio_;
     uint32_t throttleBaseSleepUs_;
     uint32_t maxReadRetryIntervalMs_;
     uint32_t readRetryIntervalMs_;
     uint32_t objectPrefix_;
+    ObjectCodecType objectCodec_ = curvefs::common::CODEC_NONE;
+    // headers of compressed objects, objects are never overwritten
+    curve::common::LRUCache<std::string, std::string> objectHeaderCache_{
+        kObjectHeaderCacheNum};
     Thread bgFlushThread_;
     std::atomic<bool> toStop_;
     std::mutex mtx_;
-    std::mutex ioMtx_;
     std::condition_variable cond_;
     curve::common::WaitInterval waitInterval_;
     std::shared_ptr<FsCacheManager> fsCacheManager_;
@@ -278,8 +321,7 @@ class S3ClientAdaptorImpl : public S3ClientAdaptor {
 
     int FlushChunkClosure(std::shared_ptr<FlushChunkCacheContext> context);
 
-    TaskThreadPool<bthread::Mutex, bthread::ConditionVariable>
-        taskPool_;
+    FlushScheduler flushScheduler_;
 
     std::shared_ptr<KVClientManager> kvClientManager_ = nullptr;
 };
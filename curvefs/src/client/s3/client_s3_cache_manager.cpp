@@ -24,6 +24,8 @@
 
 #include <bvar/bvar.h>
 #include <sys/types.h>
+#include <algorithm>
+#include <iterator>
 #include <utility>
 #include "absl/synchronization/blocking_counter.h"
 #include "absl/cleanup/cleanup.h"
@@ -78,6 +80,24 @@ void FsCacheManager::DataCacheByteDec(uint64_t v) {
     wDataCacheByte_.fetch_sub(v, std::memory_order_relaxed);
 }
 
+void FsCacheManager::DataCacheByteInc(uint64_t v,
+                                      std::atomic<uint64_t> *fileDirtyBytes) {
+    DataCacheByteInc(v);
+    if (fileDirtyBytes != nullptr && v > 0 &&
+        fileDirtyBytes->fetch_add(v, std::memory_order_relaxed) == 0) {
+        dirtyFileNum_.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void FsCacheManager::DataCacheByteDec(uint64_t v,
+                                      std::atomic<uint64_t> *fileDirtyBytes) {
+    DataCacheByteDec(v);
+    if (fileDirtyBytes != nullptr && v > 0 &&
+        fileDirtyBytes->fetch_sub(v, std::memory_order_relaxed) == v) {
+        dirtyFileNum_.fetch_sub(1, std::memory_order_relaxed);
+    }
+}
+
 FileCacheManagerPtr FsCacheManager::FindFileCacheManager(uint64_t inodeId) {
     ReadLockGuard readLockGuard(rwLock_);
 
@@ -135,25 +155,13 @@ bool FsCacheManager::Set(DataCachePtr dataCache,
     // trim cache without consider dataCache's size, because its size is
     // expected to be very smaller than `readCacheMaxByte_`
     if (lruByte_ >= readCacheMaxByte_) {
-        uint64_t retiredBytes = 0;
-        auto iter = lruReadDataCacheList_.end();
-
-        while (lruByte_ >= readCacheMaxByte_) {
-            --iter;
-            auto &trim = *iter;
-            trim->SetReadCacheState(false);
-            lruByte_ -= trim->GetActualLen();
-            retiredBytes += trim->GetActualLen();
+        RetireReadCacheLocked(lruByte_ - readCacheMaxByte_ + 1);
+    } else if (s3ClientAdaptor_ != nullptr) {
+        // memory of page arena is shared with write cache
+        auto pageArena = s3ClientAdaptor_->GetPageArena();
+        if (pageArena != nullptr && pageArena->IsExhausted()) {
+            RetireReadCacheLocked(dataCache->GetActualLen());
         }
-
-        std::list<DataCachePtr> retired;
-        retired.splice(retired.end(), lruReadDataCacheList_, iter,
-                       lruReadDataCacheList_.end());
-
-        VLOG(3) << "lru release " << retiredBytes << " bytes, retired "
-                << retired.size() << " data cache";
-
-        releaseReadCache_.Release(&retired);
     }
 
     lruByte_ += dataCache->GetActualLen();
@@ -163,6 +171,37 @@ bool FsCacheManager::Set(DataCachePtr dataCache,
     return true;
 }
 
+void FsCacheManager::ReclaimReadCache(uint64_t bytes) {
+    std::lock_guard<std::mutex> lk(lruMtx_);
+    RetireReadCacheLocked(bytes);
+}
+
+void FsCacheManager::RetireReadCacheLocked(uint64_t bytes) {
+    uint64_t retiredBytes = 0;
+    auto iter = lruReadDataCacheList_.end();
+
+    while (retiredBytes < bytes && iter != lruReadDataCacheList_.begin()) {
+        --iter;
+        auto &trim = *iter;
+        trim->SetReadCacheState(false);
+        lruByte_ -= trim->GetActualLen();
+        retiredBytes += trim->GetActualLen();
+    }
+
+    if (iter == lruReadDataCacheList_.end()) {
+        return;
+    }
+
+    std::list<DataCachePtr> retired;
+    retired.splice(retired.end(), lruReadDataCacheList_, iter,
+                   lruReadDataCacheList_.end());
+
+    VLOG(3) << "lru release " << retiredBytes << " bytes, retired "
+            << retired.size() << " data cache";
+
+    releaseReadCache_.Release(&retired);
+}
+
 void FsCacheManager::Get(std::list<DataCachePtr>::iterator iter) {
     std::lock_guard<std::mutex> lk(lruMtx_);
 
@@ -240,6 +279,21 @@ CURVEFS_ERROR FsCacheManager::FsSync(bool force) {
     return CURVEFS_ERROR::OK;
 }
 
+FileCacheManager::FileCacheManager(
+    uint32_t fsid, uint64_t inode, S3ClientAdaptorImpl *s3ClientAdaptor,
+    std::shared_ptr<KVClientManager> kvClientManager,
+    std::shared_ptr<TaskThreadPool<>> threadPool)
+    : fsId_(fsid), inode_(inode), s3ClientAdaptor_(s3ClientAdaptor),
+      kvClientManager_(std::move(kvClientManager)),
+      readTaskPool_(threadPool) {
+    // read ahead lands data in memory read cache, which is not used with cto
+    if (s3ClientAdaptor_ != nullptr &&
+        s3ClientAdaptor_->GetReadAheadOption().enable &&
+        !curvefs::client::common::FLAGS_enableCto) {
+        readAhead_.reset(new ReadAhead(s3ClientAdaptor_->GetReadAheadOption()));
+    }
+}
+
 int FileCacheManager::Write(uint64_t offset, uint64_t length,
                             const char *dataBuf) {
     uint64_t chunkSize = s3ClientAdaptor_->GetChunkSize();
@@ -296,7 +350,7 @@ FileCacheManager::FindOrCreateChunkCacheManager(uint64_t index) {
 
     ChunkCacheManagerPtr chunkCacheManager =
         std::make_shared<ChunkCacheManager>(index, s3ClientAdaptor_,
-                                            kvClientManager_);
+                                            kvClientManager_, dirtyBytes_);
     auto ret = chunkCacheMap_.emplace(index, chunkCacheManager);
     g_s3MultiManagerMetric->chunkManagerNum << 1;
     assert(ret.second);
@@ -432,11 +486,13 @@ int FileCacheManager::Read(uint64_t inodeId, uint64_t offset, uint64_t length,
     std::vector<ReadRequest> memCacheMissRequest;
     ReadFromMemCache(offset, length, dataBuf, &actualReadLen,
                      &memCacheMissRequest);
+    if (readAhead_ != nullptr) {
+        ReadAheadAsync(inodeId, offset, length, memCacheMissRequest.empty());
+    }
     if (memCacheMissRequest.empty()) {
         return actualReadLen;
     }
 
-
     // 2. read from localcache and remote cluster
     std::shared_ptr<InodeWrapper> inodeWrapper;
     auto inodeManager = s3ClientAdaptor_->GetInodeCacheManager();
@@ -475,7 +531,44 @@ int FileCacheManager::Read(uint64_t inodeId, uint64_t offset, uint64_t length,
     return actualReadLen;
 }
 
+bool FileCacheManager::ReadCacheSegments(
+    uint64_t offset, uint64_t length, std::vector<CacheSegment> *segments) {
+    uint64_t index = 0, chunkPos = 0, chunkSize = 0;
+    GetChunkLoc(offset, &index, &chunkPos, &chunkSize);
+
+    uint64_t leftLen = length;
+    while (leftLen > 0) {
+        uint64_t readLen =
+            chunkPos + leftLen > chunkSize ? chunkSize - chunkPos : leftLen;
+        ChunkCacheManagerPtr chunkCacheManager;
+        {
+            ReadLockGuard readLockGuard(rwLock_);
+            auto iter = chunkCacheMap_.find(index);
+            if (iter != chunkCacheMap_.end()) {
+                chunkCacheManager = iter->second;
+            }
+        }
+        if (chunkCacheManager == nullptr ||
+            !chunkCacheManager->ReadByReadCacheSegments(chunkPos, readLen,
+                                                        segments)) {
+            VLOG(9) << "read cache segments miss, inode: " << inode_
+                    << ", index: " << index << ", chunkPos: " << chunkPos;
+            segments->clear();
+            return false;
+        }
+        leftLen -= readLen;
+        index++;
+        chunkPos = 0;
+    }
+
+    if (readAhead_ != nullptr) {
+        ReadAheadAsync(inode_, offset, length, true);
+    }
+    return true;
+}
+
 bool FileCacheManager::ReadKVRequestFromLocalCache(const std::string &name,
+                                                   bool compressed,
                                                    char *databuf,
                                                    uint64_t offset,
                                                    uint64_t len) {
@@ -487,8 +580,12 @@ bool FileCacheManager::ReadKVRequestFromLocalCache(const std::string &name,
         return false;
     }
 
-    if (0 > s3ClientAdaptor_->GetDiskCacheManager()->Read(name, databuf, offset,
-                                                          len)) {
+    auto diskCache = s3ClientAdaptor_->GetDiskCacheManager();
+    auto reader = [&](uint64_t off, uint64_t n, char *buf) {
+        return diskCache->Read(name, buf, off, n);
+    };
+    if (0 > s3ClientAdaptor_->ReadObject(name, compressed, reader, offset, len,
+                                         databuf)) {
         LOG(WARNING) << "object " << name << " not cached in disk";
         return false;
     }
@@ -501,6 +598,7 @@ bool FileCacheManager::ReadKVRequestFromLocalCache(const std::string &name,
 }
 
 bool FileCacheManager::ReadKVRequestFromRemoteCache(const std::string &name,
+                                                    bool compressed,
                                                     char *databuf,
                                                     uint64_t offset,
                                                     uint64_t length) {
@@ -508,25 +606,33 @@ bool FileCacheManager::ReadKVRequestFromRemoteCache(const std::string &name,
         return false;
     }
 
-    auto task = std::make_shared<GetKVCacheTask>(name, databuf, offset, length);
-    CountDownEvent event(1);
-    task->done = [&](const std::shared_ptr<GetKVCacheTask> &task) {
-        (void)task;
-        event.Signal();
-        return;
+    auto reader = [&](uint64_t off, uint64_t n, char *buf) {
+        auto task = std::make_shared<GetKVCacheTask>(name, buf, off, n);
+        CountDownEvent event(1);
+        task->done = [&](const std::shared_ptr<GetKVCacheTask> &task) {
+            (void)task;
+            event.Signal();
+            return;
+        };
+        kvClientManager_->Get(task);
+        event.Wait();
+        return task->res ? 0 : -1;
     };
-    kvClientManager_->Get(task);
-    event.Wait();
-
-    return task->res;
+    return s3ClientAdaptor_->ReadObject(name, compressed, reader, offset,
+                                        length, databuf) == 0;
 }
 
 bool FileCacheManager::ReadKVRequestFromS3(const std::string &name,
-                                           char *databuf, uint64_t offset,
-                                           uint64_t length, int *ret) {
+                                           bool compressed, char *databuf,
+                                           uint64_t offset, uint64_t length,
+                                           int *ret) {
     uint64_t start = butil::cpuwide_time_us();
-    *ret = s3ClientAdaptor_->GetS3Client()->Download(name, databuf, offset,
-                                                     length);
+    auto client = s3ClientAdaptor_->GetS3Client();
+    auto reader = [&](uint64_t off, uint64_t n, char *buf) {
+        return client->Download(name, buf, off, n);
+    };
+    *ret = s3ClientAdaptor_->ReadObject(name, compressed, reader, offset,
+                                        length, databuf);
     if (*ret < 0) {
         LOG(ERROR) << "object " << name << " read from s3 fail, ret = " << *ret;
         return false;
@@ -607,14 +713,15 @@ void FileCacheManager::ProcessKVRequest(const S3ReadRequest &req, char *dataBuf,
 
         // read from localcache -> remotecache -> s3
         do {
-            if (ReadKVRequestFromLocalCache(name, currentBuf,
+            if (ReadKVRequestFromLocalCache(name, req.compressed, currentBuf,
                                             blockPos - objectOffset,
                                             currentReadLen)) {
                 VLOG(9) << "read " << name << " from local cache ok";
                 break;
             }
 
-            if (ReadKVRequestFromRemoteCache(name, currentBuf,
+            if (ReadKVRequestFromRemoteCache(name, req.compressed,
+                                             currentBuf,
                                              blockPos - objectOffset,
                                              currentReadLen)) {
                 VLOG(9) << "read " << name << " from remote cache ok";
@@ -622,8 +729,9 @@ void FileCacheManager::ProcessKVRequest(const S3ReadRequest &req, char *dataBuf,
             }
 
             int ret = 0;
-            if (ReadKVRequestFromS3(name, currentBuf, blockPos - objectOffset,
-                                    currentReadLen, &ret)) {
+            if (ReadKVRequestFromS3(name, req.compressed, currentBuf,
+                                    blockPos - objectOffset, currentReadLen,
+                                    &ret)) {
                 VLOG(9) << "read " << name << " from s3 ok";
                 break;
             }
@@ -674,6 +782,10 @@ void FileCacheManager::PrefetchForBlock(const S3ReadRequest &req,
         uint64_t maxReadLen = (blockIndex + 1) * blockSize;
         uint64_t needReadLen =
             maxReadLen > fileLen ? fileLen - blockIndex * blockSize : blockSize;
+        if (req.compressed) {
+            // the object is read to its end, as it is stored
+            needReadLen = S3ObjectCodec::MaxObjectSize(blockSize, needReadLen);
+        }
 
         prefetchObjs.push_back(std::make_pair(name, needReadLen));
 
@@ -686,6 +798,118 @@ void FileCacheManager::PrefetchForBlock(const S3ReadRequest &req,
     PrefetchS3Objs(prefetchObjs);
 }
 
+namespace {
+
+// a read ahead window, it is split into kv requests like a user read
+struct ReadAheadTask {
+    ReadAheadRange range;
+    uint64_t fileLen;
+    std::unique_ptr<char[]> buf;
+    std::vector<S3ReadRequest> requests;
+    std::atomic<uint64_t> remaining;
+    std::once_flag cancelFlag;
+    std::atomic<bool> isCanceled{false};
+    std::atomic<int> retCode{0};
+};
+
+}  // namespace
+
+void FileCacheManager::ReadAheadAsync(uint64_t inodeId, uint64_t offset,
+                                      uint64_t length, bool memCacheHit) {
+    ReadAheadRange range;
+    ReadAhead::Result result =
+        readAhead_->OnRead(offset, length, memCacheHit, &range);
+    const auto &metric = s3ClientAdaptor_->s3Metric_;
+    if (metric != nullptr) {
+        if (result == ReadAhead::Result::HIT) {
+            metric->readAheadHit << 1;
+        } else if (result == ReadAhead::Result::MISS) {
+            metric->readAheadMiss << 1;
+        }
+        metric->readAheadWindow.set_value(readAhead_->GetWindowSize());
+    }
+    if (range.len == 0) {
+        return;
+    }
+
+    std::shared_ptr<InodeWrapper> inodeWrapper;
+    auto inodeManager = s3ClientAdaptor_->GetInodeCacheManager();
+    if (CURVEFS_ERROR::OK != inodeManager->GetInode(inodeId, inodeWrapper)) {
+        LOG(WARNING) << "read ahead get inode = " << inodeId << " fail";
+        return;
+    }
+    uint64_t fileLen = inodeWrapper->GetLength();
+    if (range.offset >= fileLen) {
+        return;
+    }
+    range.len = std::min(range.len, fileLen - range.offset);
+
+    VLOG(9) << "read ahead inode = " << inodeId
+            << ", offset = " << range.offset << ", len = " << range.len;
+    auto self = shared_from_this();
+    readTaskPool_->Enqueue([self, inodeWrapper, range]() {
+        self->DoReadAhead(inodeWrapper, range);
+    });
+}
+
+void FileCacheManager::DoReadAhead(
+    const std::shared_ptr<InodeWrapper> &inodeWrapper,
+    const ReadAheadRange &range) {
+    if (readAhead_->IsCanceled(range.epoch)) {
+        return;
+    }
+
+    auto task = std::make_shared<ReadAheadTask>();
+    task->range = range;
+    task->fileLen = inodeWrapper->GetLength();
+    task->buf.reset(new char[range.len]);
+
+    uint64_t actualReadLen = 0;
+    std::vector<ReadRequest> memCacheMissRequest;
+    ReadFromMemCache(range.offset, range.len, task->buf.get(), &actualReadLen,
+                     &memCacheMissRequest);
+    if (!memCacheMissRequest.empty()) {
+        GenerateKVRequest(inodeWrapper, memCacheMissRequest, task->buf.get(),
+                          &task->requests);
+    }
+    if (task->requests.empty()) {
+        readAhead_->OnDone(range);
+        return;
+    }
+
+    // every kv request is a task of the read pool, so user reads are not
+    // blocked behind a whole window, and data is added to memory read
+    // cache by ProcessKVRequest as soon as each request is done
+    auto self = shared_from_this();
+    task->remaining.store(task->requests.size(), std::memory_order_relaxed);
+    for (size_t i = 0; i < task->requests.size(); i++) {
+        readTaskPool_->Enqueue([self, task, i]() {
+            if (!task->isCanceled.load() &&
+                !self->readAhead_->IsCanceled(task->range.epoch)) {
+                self->ProcessKVRequest(task->requests[i], task->buf.get(),
+                                       task->fileLen, task->cancelFlag,
+                                       task->isCanceled, task->retCode);
+            } else {
+                task->isCanceled.store(true);
+            }
+            if (task->remaining.fetch_sub(1) != 1 || task->isCanceled.load()) {
+                return;
+            }
+            self->readAhead_->OnDone(task->range);
+            const auto &metric = self->s3ClientAdaptor_->s3Metric_;
+            if (metric != nullptr) {
+                metric->readAheadBytes << task->range.len;
+            }
+        });
+    }
+}
+
+void FileCacheManager::CancelReadAhead() {
+    if (readAhead_ != nullptr) {
+        readAhead_->Cancel();
+    }
+}
+
 class AsyncPrefetchCallback {
  public:
     AsyncPrefetchCallback(uint64_t inode, S3ClientAdaptorImpl *s3Client)
@@ -825,6 +1049,7 @@ void FileCacheManager::HandleReadRequest(
                     s3ChunkInfoOffset % chunkSize % blockSize;
                 s3Request.readOffset = bufOffset + readOffset;
                 s3Request.compaction = s3ChunkInfo.compaction();
+                s3Request.compressed = s3ChunkInfo.compressed();
                 s3Request.fsId = fsId;
                 s3Request.inodeId = inodeId;
                 requests->push_back(s3Request);
@@ -845,6 +1070,7 @@ void FileCacheManager::HandleReadRequest(
                     s3ChunkInfoOffset % chunkSize % blockSize;
                 s3Request.readOffset = bufOffset + readOffset;
                 s3Request.compaction = s3ChunkInfo.compaction();
+                s3Request.compressed = s3ChunkInfo.compressed();
                 s3Request.fsId = fsId;
                 s3Request.inodeId = inodeId;
                 requests->push_back(s3Request);
@@ -886,6 +1112,7 @@ void FileCacheManager::HandleReadRequest(
                 }
                 s3Request.readOffset = bufOffset + readOffset;
                 s3Request.compaction = s3ChunkInfo.compaction();
+                s3Request.compressed = s3ChunkInfo.compressed();
                 s3Request.fsId = fsId;
                 s3Request.inodeId = inodeId;
                 requests->push_back(s3Request);
@@ -910,6 +1137,7 @@ void FileCacheManager::HandleReadRequest(
                 }
                 s3Request.readOffset = bufOffset + readOffset;
                 s3Request.compaction = s3ChunkInfo.compaction();
+                s3Request.compressed = s3ChunkInfo.compressed();
                 s3Request.fsId = fsId;
                 s3Request.inodeId = inodeId;
                 requests->push_back(s3Request);
@@ -1010,6 +1238,7 @@ void FileCacheManager::GenerateS3Request(ReadRequest request,
 
 
 void FileCacheManager::ReleaseCache() {
+    CancelReadAhead();
     WriteLockGuard writeLockGuard(rwLock_);
 
     uint64_t chunNum = chunkCacheMap_.size();
@@ -1375,6 +1604,62 @@ void ChunkCacheManager::ReadByReadCache(uint64_t chunkPos, uint64_t readLen,
     return;
 }
 
+bool ChunkCacheManager::ReadByReadCacheSegments(
+    uint64_t chunkPos, uint64_t readLen,
+    std::vector<CacheSegment> *segments) {
+    ReadLockGuard readLockGuard(rwLockChunk_);
+    // data in write cache or being flushed is newer than read cache,
+    // caches in a map do not overlap each other
+    auto overlapped = [&](uint64_t pos, uint64_t len) {
+        return pos < chunkPos + readLen && chunkPos < pos + len;
+    };
+    {
+        ReadLockGuard writeCacheLock(rwLockWrite_);
+        auto iter = dataWCacheMap_.lower_bound(chunkPos + readLen);
+        if (iter != dataWCacheMap_.begin() &&
+            overlapped(std::prev(iter)->second->GetChunkPos(),
+                       std::prev(iter)->second->GetLen())) {
+            return false;
+        }
+    }
+    {
+        curve::common::LockGuard lg(flushingDataCacheMtx_);
+        if (!IsFlushDataEmpty() &&
+            overlapped(flushingDataCache_->GetChunkPos(),
+                       flushingDataCache_->GetLen())) {
+            return false;
+        }
+    }
+
+    ReadLockGuard readCacheLock(rwLockRead_);
+    auto iter = dataRCacheMap_.upper_bound(chunkPos);
+    if (iter == dataRCacheMap_.begin()) {
+        return false;
+    }
+    --iter;
+    while (readLen > 0) {
+        if (iter == dataRCacheMap_.end()) {
+            return false;
+        }
+        DataCachePtr &dataCache = (*iter->second);
+        uint64_t dcChunkPos = dataCache->GetChunkPos();
+        uint64_t dcLen = dataCache->GetLen();
+        if (chunkPos < dcChunkPos || chunkPos >= dcChunkPos + dcLen) {
+            return false;
+        }
+        uint64_t len = std::min(readLen, dcChunkPos + dcLen - chunkPos);
+        if (!dataCache->GetCacheSegments(chunkPos - dcChunkPos, len,
+                                         segments)) {
+            return false;
+        }
+        s3ClientAdaptor_->GetFsCacheManager()->Get(iter->second);
+        chunkPos += len;
+        readLen -= len;
+        ++iter;
+    }
+    return true;
+}
+
 void ChunkCacheManager::ReadByFlushData(uint64_t chunkPos, uint64_t readLen,
                                         char *dataBuf, uint64_t dataBufOffset,
                                         std::vector<ReadRequest> *requests) {
@@ -1497,8 +1782,7 @@ DataCachePtr ChunkCacheManager::FindWriteableDataCache(
                 s3ClientAdaptor_->GetFsCacheManager()->DataCacheNumFetchSub(1);
                 VLOG(9) << "FindWriteableDataCache() DataCacheByteDec1 len:"
                         << iter->second->GetLen();
-                s3ClientAdaptor_->GetFsCacheManager()->DataCacheByteDec(
-                    iter->second->GetActualLen());
+                DirtyByteDec(iter->second->GetActualLen());
                 dataWCacheMap_.erase(iter);
             }
             return dataCache;
@@ -1524,8 +1808,7 @@ void ChunkCacheManager::WriteNewDataCache(S3ClientAdaptorImpl *s3ClientAdaptor,
         return;
     }
     s3ClientAdaptor_->FsSyncSignalAndDataCacheInc();
-    s3ClientAdaptor_->GetFsCacheManager()->DataCacheByteInc(
-        dataCache->GetActualLen());
+    DirtyByteInc(dataCache->GetActualLen());
     return;
 }
 
@@ -1588,8 +1871,7 @@ void ChunkCacheManager::ReleaseCache() {
 
         for (auto &dataWCache : dataWCacheMap_) {
             s3ClientAdaptor_->GetFsCacheManager()->DataCacheNumFetchSub(1);
-            s3ClientAdaptor_->GetFsCacheManager()->DataCacheByteDec(
-                dataWCache.second->GetActualLen());
+            DirtyByteDec(dataWCache.second->GetActualLen());
         }
         dataWCacheMap_.clear();
         s3ClientAdaptor_->GetFsCacheManager()->FlushSignal();
@@ -1623,14 +1905,12 @@ void ChunkCacheManager::TruncateWriteCache(uint64_t chunkPos) {
         uint64_t dcActualLen = rIter->second->GetActualLen();
         if (dcChunkPos >= chunkPos) {
             s3ClientAdaptor_->GetFsCacheManager()->DataCacheNumFetchSub(1);
-            s3ClientAdaptor_->GetFsCacheManager()->DataCacheByteDec(
-                dcActualLen);
+            DirtyByteDec(dcActualLen);
             dataWCacheMap_.erase(next(rIter).base());
         } else if ((dcChunkPos < chunkPos) &&
                    ((dcChunkPos + dcLen) > chunkPos)) {
             rIter->second->Truncate(chunkPos - dcChunkPos);
-            s3ClientAdaptor_->GetFsCacheManager()->DataCacheByteDec(
-                dcActualLen - rIter->second->GetActualLen());
+            DirtyByteDec(dcActualLen - rIter->second->GetActualLen());
             break;
         } else {
             break;
@@ -1657,11 +1937,20 @@ void ChunkCacheManager::TruncateReadCache(uint64_t chunkPos) {
     }
 }
 
+void ChunkCacheManager::DirtyByteInc(uint64_t v) {
+    s3ClientAdaptor_->GetFsCacheManager()->DataCacheByteInc(
+        v, fileDirtyBytes_.get());
+}
+
+void ChunkCacheManager::DirtyByteDec(uint64_t v) {
+    s3ClientAdaptor_->GetFsCacheManager()->DataCacheByteDec(
+        v, fileDirtyBytes_.get());
+}
+
 void ChunkCacheManager::ReleaseWriteDataCache(const DataCachePtr &dataCache) {
     s3ClientAdaptor_->GetFsCacheManager()->DataCacheNumFetchSub(1);
     VLOG(9) << "chunk flush DataCacheByteDec len:" << dataCache->GetActualLen();
-    s3ClientAdaptor_->GetFsCacheManager()->DataCacheByteDec(
-        dataCache->GetActualLen());
+    DirtyByteDec(dataCache->GetActualLen());
     if (!s3ClientAdaptor_->GetFsCacheManager()->WriteCacheIsFull()) {
         VLOG(9) << "write cache is not full, signal wait.";
         s3ClientAdaptor_->GetFsCacheManager()->FlushSignal();
@@ -1758,8 +2047,7 @@ void ChunkCacheManager::AddWriteDataCacheForTest(DataCachePtr dataCache) {
 
     dataWCacheMap_.emplace(dataCache->GetChunkPos(), dataCache);
     s3ClientAdaptor_->GetFsCacheManager()->DataCacheNumInc();
-    s3ClientAdaptor_->GetFsCacheManager()->DataCacheByteInc(
-        dataCache->GetActualLen());
+    DirtyByteInc(dataCache->GetActualLen());
 }
 
 DataCache::DataCache(S3ClientAdaptorImpl *s3ClientAdaptor,
@@ -1768,7 +2056,7 @@ DataCache::DataCache(S3ClientAdaptorImpl *s3ClientAdaptor,
                      std::shared_ptr<KVClientManager> kvClientManager)
     : s3ClientAdaptor_(std::move(s3ClientAdaptor)),
       chunkCacheManager_(chunkCacheManager), status_(DataCacheStatus::Dirty),
-      inReadCache_(false) {
+      inReadCache_(false), pageArena_(s3ClientAdaptor->GetPageArena()) {
     uint64_t blockSize = s3ClientAdaptor->GetBlockSize();
     uint32_t pageSize = s3ClientAdaptor->GetPageSize();
     chunkPos_ = chunkPos;
@@ -1800,14 +2088,11 @@ DataCache::DataCache(S3ClientAdaptorImpl *s3ClientAdaptor,
                 m = blockLen;
             }
 
-            PageData *pageData = new PageData();
-            pageData->data = new char[pageSize];
-            memset(pageData->data, 0, pageSize);
+            PageData *pageData = NewPage(pageIndex, pageSize);
             memcpy(pageData->data + pagePos, data + dataOffset, m);
             if (pagePos + m < pageSize) {
                 tailZeroLen = pageSize - pagePos - m;
             }
-            pageData->index = pageIndex;
             assert(pdMap.count(pageIndex) == 0);
             pdMap.emplace(pageIndex, pageData);
             pageIndex++;
@@ -1866,10 +2151,7 @@ void DataCache::CopyBufToDataCache(uint64_t dataCachePos, uint64_t len,
             if (pdMap.count(pageIndex)) {
                 pageData = pdMap[pageIndex];
             } else {
-                pageData = new PageData();
-                pageData->data = new char[pageSize];
-                memset(pageData->data, 0, pageSize);
-                pageData->index = pageIndex;
+                pageData = NewPage(pageIndex, pageSize);
                 pdMap.emplace(pageIndex, pageData);
                 addLen += pageSize;
             }
@@ -1926,10 +2208,7 @@ void DataCache::AddDataBefore(uint64_t len, const char *data) {
             if (pdMap.count(pageIndex)) {
                 pageData = pdMap[pageIndex];
             } else {
-                pageData = new PageData();
-                pageData->data = new char[pageSize];
-                memset(pageData->data, 0, pageSize);
-                pageData->index = pageIndex;
+                pageData = NewPage(pageIndex, pageSize);
                 pdMap.emplace(pageIndex, pageData);
             }
             memcpy(pageData->data + pagePos, data + dataOffset, m);
@@ -2048,7 +2327,7 @@ void DataCache::Write(uint64_t chunkPos, uint64_t len, const char *data,
                                data + chunkPos_ - chunkPos);
             AddDataBefore(chunkPos_ - chunkPos, data);
             addByte = actualLen_ - oldSize;
-            s3ClientAdaptor_->GetFsCacheManager()->DataCacheByteInc(addByte);
+            chunkCacheManager_->DirtyByteInc(addByte);
             chunkCacheManager_->UpdateWriteCacheMap(oldChunkPos, this);
             chunkCacheManager_->rwLockWrite_.Unlock();
             return;
@@ -2072,8 +2351,7 @@ void DataCache::Write(uint64_t chunkPos, uint64_t len, const char *data,
                             len);
                     AddDataBefore(chunkPos_ - chunkPos, data);
                     addByte = actualLen_ - oldSize;
-                    s3ClientAdaptor_->GetFsCacheManager()->DataCacheByteInc(
-                        addByte);
+                    chunkCacheManager_->DirtyByteInc(addByte);
                     chunkCacheManager_->UpdateWriteCacheMap(oldChunkPos, this);
                     chunkCacheManager_->rwLockWrite_.Unlock();
                     return;
@@ -2089,7 +2367,7 @@ void DataCache::Write(uint64_t chunkPos, uint64_t len, const char *data,
                                data + chunkPos_ - chunkPos);
             AddDataBefore(chunkPos_ - chunkPos, data);
             addByte = actualLen_ - oldSize;
-            s3ClientAdaptor_->GetFsCacheManager()->DataCacheByteInc(addByte);
+            chunkCacheManager_->DirtyByteInc(addByte);
             chunkCacheManager_->UpdateWriteCacheMap(oldChunkPos, this);
             chunkCacheManager_->rwLockWrite_.Unlock();
             return;
@@ -2122,8 +2400,7 @@ void DataCache::Write(uint64_t chunkPos, uint64_t len, const char *data,
                         (*iter)->GetChunkPos() + (*iter)->GetLen() - chunkPos -
                             len);
                     addByte = actualLen_ - oldSize;
-                    s3ClientAdaptor_->GetFsCacheManager()->DataCacheByteInc(
-                        addByte);
+                    chunkCacheManager_->DirtyByteInc(addByte);
                     return;
                 }
             }
@@ -2134,7 +2411,7 @@ void DataCache::Write(uint64_t chunkPos, uint64_t len, const char *data,
             oldSize = actualLen_;
             CopyBufToDataCache(chunkPos - chunkPos_, len, data);
             addByte = actualLen_ - oldSize;
-            s3ClientAdaptor_->GetFsCacheManager()->DataCacheByteInc(addByte);
+            chunkCacheManager_->DirtyByteInc(addByte);
             return;
         }
     }
@@ -2174,7 +2451,7 @@ void DataCache::Truncate(uint64_t size) {
             if (pagePos == 0) {
                 if (pdMap.count(pageIndex)) {
                     pageData = pdMap[pageIndex];
-                    delete pageData->data;
+                    DeletePage(pageData);
                     pdMap.erase(pageIndex);
                     actualLen_ -= pageSize;
                 }
@@ -2209,6 +2486,38 @@ void DataCache::Truncate(uint64_t size) {
     return;
 }
 
+PageData *DataCache::NewPage(uint64_t pageIndex, uint32_t pageSize) {
+    PageData *pageData = new PageData();
+    if (pageArena_ != nullptr) {
+        pageData->data = pageArena_->Allocate();
+        if (pageArena_->Contains(pageData->data)) {
+            g_s3MultiManagerMetric->pageArenaUsedByte << pageSize;
+        } else {
+            g_s3MultiManagerMetric->pageArenaOverflowByte << pageSize;
+        }
+    } else {
+        pageData->data = new char[pageSize];
+    }
+    memset(pageData->data, 0, pageSize);
+    pageData->index = pageIndex;
+    return pageData;
+}
+
+void DataCache::DeletePage(PageData *pageData) {
+    if (pageArena_ != nullptr) {
+        int64_t pageSize = pageArena_->GetPageSize();
+        if (pageArena_->Contains(pageData->data)) {
+            g_s3MultiManagerMetric->pageArenaUsedByte << -pageSize;
+        } else {
+            g_s3MultiManagerMetric->pageArenaOverflowByte << -pageSize;
+        }
+        pageArena_->Free(pageData->data);
+    } else {
+        delete[] pageData->data;
+    }
+    delete pageData;
+}
+
 void DataCache::Release() {
     chunkCacheManager_->ReleaseReadDataCache(chunkPos_);
 }
@@ -2262,6 +2571,43 @@ void DataCache::CopyDataCacheToBuf(uint64_t offset, uint64_t len, char *data) {
     return;
 }
 
+bool DataCache::GetCacheSegments(uint64_t offset, uint64_t len,
+                                 std::vector<CacheSegment> *segments) {
+    assert(offset + len <= len_);
+    uint64_t blockSize = s3ClientAdaptor_->GetBlockSize();
+    uint64_t pageSize = s3ClientAdaptor_->GetPageSize();
+    uint64_t pos = chunkPos_ + offset;
+    std::shared_ptr<const void> holder = shared_from_this();
+
+    while (len > 0) {
+        uint64_t blockIndex = pos / blockSize;
+        uint64_t blockPos = pos % blockSize;
+        uint64_t pageIndex = blockPos / pageSize;
+        uint64_t pagePos = blockPos % pageSize;
+        uint64_t n = std::min({len, pageSize - pagePos, blockSize - blockPos});
+
+        auto blockIter = dataMap_.find(blockIndex);
+        if (blockIter == dataMap_.end()) {
+            return false;
+        }
+        auto pageIter = blockIter->second.find(pageIndex);
+        if (pageIter == blockIter->second.end()) {
+            return false;
+        }
+        const char *data = pageIter->second->data + pagePos;
+        // pages from the arena may be adjacent
+        if (!segments->empty() && segments->back().holder == holder &&
+            segments->back().data + segments->back().len == data) {
+            segments->back().len += n;
+        } else {
+            segments->push_back(CacheSegment{data, n, holder});
+        }
+        pos += n;
+        len -= n;
+    }
+    return true;
+}
+
 CURVEFS_ERROR DataCache::Flush(uint64_t inodeId, bool toS3) {
     VLOG(9) << "DataCache Flush. chunkPos=" << chunkPos_ << ", len=" << len_
             << ", chunkIndex=" << chunkCacheManager_->GetIndex()
@@ -2284,6 +2630,14 @@ CURVEFS_ERROR DataCache::Flush(uint64_t inodeId, bool toS3) {
         return ret;
     }
 
+    // objects are stored encoded, in s3 and in all the caches
+    std::vector<std::string> encoded;
+    if (s3ClientAdaptor_->GetObjectCodec() != curvefs::common::CODEC_NONE &&
+        !EncodeFlushTasks(s3Tasks, kvCacheTasks, &encoded)) {
+        delete[] data;
+        return CURVEFS_ERROR::INTERNAL;
+    }
+
     // exec flush task
     FlushTaskExecute(GetCachePolicy(toS3), s3Tasks, kvCacheTasks);
     delete[] data;
@@ -2360,6 +2714,30 @@ CURVEFS_ERROR DataCache::PrepareFlushTasks(
     return CURVEFS_ERROR::OK;
 }
 
+bool DataCache::EncodeFlushTasks(
+    const std::vector<std::shared_ptr<PutObjectAsyncContext>> &s3Tasks,
+    const std::vector<std::shared_ptr<SetKVCacheTask>> &kvCacheTasks,
+    std::vector<std::string> *encoded) {
+    encoded->resize(s3Tasks.size());
+    for (size_t i = 0; i < s3Tasks.size(); i++) {
+        const auto &context = s3Tasks[i];
+        std::string *object = &(*encoded)[i];
+        if (!s3ClientAdaptor_->EncodeObject(context->buffer,
+                                            context->bufferSize, object)) {
+            LOG(ERROR) << "encode object fail, name = " << context->key;
+            return false;
+        }
+        context->buffer = object->data();
+        context->bufferSize = object->size();
+        // kv cache tasks are of the same objects in the same order
+        if (i < kvCacheTasks.size()) {
+            kvCacheTasks[i]->value = object->data();
+            kvCacheTasks[i]->length = object->size();
+        }
+    }
+    return true;
+}
+
 CachePolicy DataCache::GetCachePolicy(bool toS3) {
     const bool mayCache =
         s3ClientAdaptor_->HasDiskCache() &&
@@ -2449,6 +2827,9 @@ void DataCache::PrepareS3ChunkInfo(uint64_t chunkId, uint64_t offset,
     info->set_len(len);
     info->set_size(len);
     info->set_zero(false);
+    if (s3ClientAdaptor_->GetObjectCodec() != curvefs::common::CODEC_NONE) {
+        info->set_compressed(true);
+    }
     VLOG(6) << "UpdateInodeChunkInfo chunkId:" << chunkId
             << ",offset:" << offset << ", len:" << len;
     return;
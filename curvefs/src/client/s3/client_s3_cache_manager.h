@@ -23,6 +23,7 @@
 #define CURVEFS_SRC_CLIENT_S3_CLIENT_S3_CACHE_MANAGER_H_
 
 #include <algorithm>
+#include <atomic>
 #include <cstring>
 #include <list>
 #include <map>
@@ -36,6 +37,8 @@
 #include "curvefs/proto/metaserver.pb.h"
 #include "curvefs/src/client/filesystem/error.h"
 #include "curvefs/src/client/s3/client_s3.h"
+#include "curvefs/src/client/s3/client_s3_page_arena.h"
+#include "curvefs/src/client/s3/client_s3_readahead.h"
 #include "src/common/concurrent/concurrent.h"
 #include "src/common/concurrent/task_thread_pool.h"
 #include "curvefs/src/client/kvclient/kvclient_manager.h"
@@ -58,6 +61,8 @@ using FileCacheManagerPtr = std::shared_ptr<FileCacheManager>;
 using ChunkCacheManagerPtr = std::shared_ptr<ChunkCacheManager>;
 using DataCachePtr = std::shared_ptr<DataCache>;
 using WeakDataCachePtr = std::weak_ptr<DataCache>;
+// dirty bytes of a file in write cache, shared by its chunks
+using DirtyBytesPtr = std::shared_ptr<std::atomic<uint64_t>>;
 using curve::common::GetObjectAsyncCallBack;
 using curve::common::PutObjectAsyncCallBack;
 using curve::common::S3Adapter;
@@ -96,6 +101,7 @@ struct S3ReadRequest {
     uint64_t fsId;
     uint64_t inodeId;
     uint64_t compaction;
+    bool compressed = false;  // objects are encoded by the fs codec
 
     std::string DebugString() const {
         std::ostringstream os;
@@ -103,7 +109,7 @@ struct S3ReadRequest {
            << ", len = " << len << ", objectOffset = " << objectOffset
            << ", readOffset = " << readOffset << ", fsId = " << fsId
            << ", inodeId = " << inodeId << ", compaction = " << compaction
-           << " )";
+           << ", compressed = " << compressed << " )";
         return os.str();
     }
 };
@@ -127,6 +133,13 @@ struct PageData {
 };
 using PageDataMap = std::map<uint64_t, PageData *>;
 
+// a piece of data in memory read cache, holder keeps the pages alive
+struct CacheSegment {
+    const char *data;
+    uint64_t len;
+    std::shared_ptr<const void> holder;
+};
+
 enum DataCacheStatus {
     Dirty = 1,
     Flush = 2,
@@ -143,8 +156,7 @@ class DataCache : public std::enable_shared_from_this<DataCache> {
         for (; iter != dataMap_.end(); iter++) {
             auto pageIter = iter->second.begin();
             for (; pageIter != iter->second.end(); pageIter++) {
-                delete[] pageIter->second->data;
-                delete pageIter->second;
+                DeletePage(pageIter->second);
             }
         }
     }
@@ -176,6 +188,11 @@ class DataCache : public std::enable_shared_from_this<DataCache> {
 
     uint64_t GetActualLen() { return actualLen_; }
 
+    // get [offset, offset + len) of the data cache as the pages it is in,
+    // return false if some page does not exist
+    bool GetCacheSegments(uint64_t offset, uint64_t len,
+                          std::vector<CacheSegment> *segments);
+
     virtual CURVEFS_ERROR Flush(uint64_t inodeId, bool toS3 = false);
     void Release();
     bool IsDirty() {
@@ -209,12 +226,23 @@ class DataCache : public std::enable_shared_from_this<DataCache> {
                              const char *data);
     void AddDataBefore(uint64_t len, const char *data);
 
+    // new zeroed page, from page arena if it is enabled
+    PageData *NewPage(uint64_t pageIndex, uint32_t pageSize);
+    void DeletePage(PageData *pageData);
+
     CURVEFS_ERROR PrepareFlushTasks(
         uint64_t inodeId, char *data,
         std::vector<std::shared_ptr<PutObjectAsyncContext>> *s3Tasks,
         std::vector<std::shared_ptr<SetKVCacheTask>> *kvCacheTasks,
         uint64_t *chunkId, uint64_t *writeOffset);
 
+    // replace the data of flush tasks with the encoded objects, which are
+    // kept in |encoded|
+    bool EncodeFlushTasks(
+        const std::vector<std::shared_ptr<PutObjectAsyncContext>> &s3Tasks,
+        const std::vector<std::shared_ptr<SetKVCacheTask>> &kvCacheTasks,
+        std::vector<std::string> *encoded);
+
     void FlushTaskExecute(
         CachePolicy cachePolicy,
         const std::vector<std::shared_ptr<PutObjectAsyncContext>> &s3Tasks,
@@ -234,6 +262,8 @@ class DataCache : public std::enable_shared_from_this<DataCache> {
     std::atomic<int> status_;
     std::atomic<bool> inReadCache_;
     std::map<uint64_t, PageDataMap> dataMap_;  // first is block index
+    // pages of merged data cache are moved here, they share one arena
+    std::shared_ptr<PageArena> pageArena_;
 
     std::shared_ptr<KVClientManager> kvClientManager_;
 };
@@ -256,10 +286,12 @@ class ChunkCacheManager
     : public std::enable_shared_from_this<ChunkCacheManager> {
  public:
     ChunkCacheManager(uint64_t index, S3ClientAdaptorImpl *s3ClientAdaptor,
-                      std::shared_ptr<KVClientManager> kvClientManager)
+                      std::shared_ptr<KVClientManager> kvClientManager,
+                      DirtyBytesPtr fileDirtyBytes = nullptr)
         : index_(index), s3ClientAdaptor_(s3ClientAdaptor),
           flushingDataCache_(nullptr),
-          kvClientManager_(std::move(kvClientManager)) {}
+          kvClientManager_(std::move(kvClientManager)),
+          fileDirtyBytes_(std::move(fileDirtyBytes)) {}
     virtual ~ChunkCacheManager() = default;
     void ReadChunk(uint64_t index, uint64_t chunkPos, uint64_t readLen,
                    char *dataBuf, uint64_t dataBufOffset,
@@ -281,6 +313,10 @@ class ChunkCacheManager
     virtual void ReadByFlushData(uint64_t chunkPos, uint64_t readLen,
                                  char *dataBuf, uint64_t dataBufOffset,
                                  std::vector<ReadRequest> *requests);
+    // read from read cache without copying, return false if the range is
+    // not all in read cache or is overlapped by write cache
+    bool ReadByReadCacheSegments(uint64_t chunkPos, uint64_t readLen,
+                                 std::vector<CacheSegment> *segments);
     virtual CURVEFS_ERROR Flush(uint64_t inodeId, bool force,
                                 bool toS3 = false);
     uint64_t GetIndex() { return index_; }
@@ -292,6 +328,9 @@ class ChunkCacheManager
     virtual void ReleaseCache();
     void TruncateCache(uint64_t chunkPos);
     void UpdateWriteCacheMap(uint64_t oldChunkPos, DataCache *dataCache);
+    // account dirty bytes of write cache to both the fs and the file
+    void DirtyByteInc(uint64_t v);
+    void DirtyByteDec(uint64_t v);
     // for unit test
     void AddWriteDataCacheForTest(DataCachePtr dataCache);
     void ReleaseCacheForTest() {
@@ -326,17 +365,17 @@ class ChunkCacheManager
     curve::common::Mutex flushingDataCacheMtx_;
 
     std::shared_ptr<KVClientManager> kvClientManager_;
+    // nullptr if dirty bytes of the file are not accounted
+    DirtyBytesPtr fileDirtyBytes_;
 };
 
-class FileCacheManager {
+class FileCacheManager
+    : public std::enable_shared_from_this<FileCacheManager> {
  public:
     FileCacheManager(uint32_t fsid, uint64_t inode,
                      S3ClientAdaptorImpl *s3ClientAdaptor,
                      std::shared_ptr<KVClientManager> kvClientManager,
-                     std::shared_ptr<TaskThreadPool<>> threadPool)
-        : fsId_(fsid), inode_(inode), s3ClientAdaptor_(s3ClientAdaptor),
-          kvClientManager_(std::move(kvClientManager)),
-          readTaskPool_(threadPool) {}
+                     std::shared_ptr<TaskThreadPool<>> threadPool);
     FileCacheManager() = default;
     ~FileCacheManager() = default;
 
@@ -353,10 +392,23 @@ class FileCacheManager {
     virtual int Read(uint64_t inodeId, uint64_t offset, uint64_t length,
                      char *dataBuf);
 
+    // read without copying if the range is all in memory read cache,
+    // segments reference the cached pages
+    bool ReadCacheSegments(uint64_t offset, uint64_t length,
+                           std::vector<CacheSegment> *segments);
+
+    // cancel inflight read ahead and reset the sequential stream
+    void CancelReadAhead();
+
     bool IsEmpty() { return chunkCacheMap_.empty(); }
 
     uint64_t GetInodeId() const { return inode_; }
 
+    // bytes of dirty data of the file in write cache
+    uint64_t GetDirtyBytes() const {
+        return dirtyBytes_->load(std::memory_order_relaxed);
+    }
+
     void SetChunkCacheManagerForTest(uint64_t index,
                                      ChunkCacheManagerPtr chunkCacheManager) {
         WriteLockGuard writeLockGuard(rwLock_);
@@ -434,16 +486,19 @@ class FileCacheManager {
                           std::atomic<int> &retCode);     // NOLINT
 
     // read kv request from local disk cache
-    bool ReadKVRequestFromLocalCache(const std::string &name, char *databuf,
-                                     uint64_t offset, uint64_t len);
+    bool ReadKVRequestFromLocalCache(const std::string &name, bool compressed,
+                                     char *databuf, uint64_t offset,
+                                     uint64_t len);
 
     // read kv request from remote cache like memcached
-    bool ReadKVRequestFromRemoteCache(const std::string &name, char *databuf,
+    bool ReadKVRequestFromRemoteCache(const std::string &name,
+                                      bool compressed, char *databuf,
                                       uint64_t offset, uint64_t length);
 
     // read kv request from s3
-    bool ReadKVRequestFromS3(const std::string &name, char *databuf,
-                             uint64_t offset, uint64_t length, int *ret);
+    bool ReadKVRequestFromS3(const std::string &name, bool compressed,
+                             char *databuf, uint64_t offset, uint64_t length,
+                             int *ret);
 
     // read retry policy when read from s3 occur not exist error
     int HandleReadS3NotExist(uint32_t retry,
@@ -454,6 +509,15 @@ class FileCacheManager {
                          uint64_t blockSize, uint64_t chunkSize,
                          uint64_t startBlockIndex);
 
+    // update read ahead state with a user read, and issue the next window
+    // of a sequential stream in background
+    void ReadAheadAsync(uint64_t inodeId, uint64_t offset, uint64_t length,
+                        bool memCacheHit);
+
+    // read the window into memory read cache
+    void DoReadAhead(const std::shared_ptr<InodeWrapper> &inodeWrapper,
+                     const ReadAheadRange &range);
+
  private:
     friend class AsyncPrefetchCallback;
 
@@ -468,6 +532,10 @@ class FileCacheManager {
 
     std::shared_ptr<KVClientManager> kvClientManager_;
     std::shared_ptr<TaskThreadPool<>> readTaskPool_;
+    // nullptr if read ahead is disabled
+    std::unique_ptr<ReadAhead> readAhead_;
+    // shared with chunks of the file, which may outlive the file cache
+    DirtyBytesPtr dirtyBytes_ = std::make_shared<std::atomic<uint64_t>>(0);
 };
 
 class FsCacheManager {
@@ -495,6 +563,9 @@ class FsCacheManager {
     bool Delete(std::list<DataCachePtr>::iterator iter);
     void Get(std::list<DataCachePtr>::iterator iter);
 
+    // retire the least recently used read cache of at least bytes
+    void ReclaimReadCache(uint64_t bytes);
+
     CURVEFS_ERROR FsSync(bool force);
     uint64_t GetDataCacheNum() {
         return wDataCacheNum_.load(std::memory_order_relaxed);
@@ -551,6 +622,13 @@ class FsCacheManager {
     void DataCacheNumFetchSub(uint64_t v);
     void DataCacheByteInc(uint64_t v);
     void DataCacheByteDec(uint64_t v);
+    // also account dirty bytes of a file, and count the files which have
+    // dirty data
+    void DataCacheByteInc(uint64_t v, std::atomic<uint64_t> *fileDirtyBytes);
+    void DataCacheByteDec(uint64_t v, std::atomic<uint64_t> *fileDirtyBytes);
+    uint64_t GetDirtyFileNum() {
+        return dirtyFileNum_.load(std::memory_order_relaxed);
+    }
 
  private:
     class ReadCacheReleaseExecutor {
@@ -573,6 +651,8 @@ class FsCacheManager {
         std::thread t_;
     };
 
+    void RetireReadCacheLocked(uint64_t bytes);
+
  private:
     std::unordered_map<uint64_t, FileCacheManagerPtr>
         fileCacheManagerMap_;  // first is inodeid
@@ -583,6 +663,7 @@ class FsCacheManager {
     uint64_t lruByte_;
     std::atomic<uint64_t> wDataCacheNum_;
     std::atomic<uint64_t> wDataCacheByte_;
+    std::atomic<uint64_t> dirtyFileNum_{0};
     uint64_t readCacheMaxByte_;
     uint64_t writeCacheMaxByte_;
     S3ClientAdaptorImpl *s3ClientAdaptor_;
@@ -0,0 +1,166 @@
+/*
+ *  Copyright (c) 2023 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include "curvefs/src/client/s3/client_s3_flush_scheduler.h"
+
+#include <glog/logging.h>
+
+#include <utility>
+
+namespace curvefs {
+namespace client {
+
+const uint32_t FlushScheduler::kSyncBurst;
+
+FlushScheduler::~FlushScheduler() {
+    Stop();
+}
+
+void FlushScheduler::Start(uint32_t threadNum) {
+    std::lock_guard<std::mutex> lk(mtx_);
+    if (running_) {
+        return;
+    }
+    running_ = true;
+    for (uint32_t i = 0; i < threadNum; i++) {
+        workers_.emplace_back(&FlushScheduler::Run, this);
+    }
+}
+
+void FlushScheduler::Stop() {
+    {
+        std::lock_guard<std::mutex> lk(mtx_);
+        if (!running_) {
+            return;
+        }
+        running_ = false;
+    }
+    cond_.notify_all();
+    for (auto &worker : workers_) {
+        worker.join();
+    }
+    workers_.clear();
+}
+
+void FlushScheduler::Enqueue(uint64_t inodeId, Task task) {
+    {
+        std::lock_guard<std::mutex> lk(mtx_);
+        if (running_) {
+            InodeQueue *queue = &queues_[inodeId];
+            queue->tasks.emplace_back(std::move(task));
+            queuedTaskNum_++;
+            if (queue->ring == kNone) {
+                Reschedule(inodeId, queue);
+            }
+            cond_.notify_one();
+            return;
+        }
+    }
+    // not running, nobody would serve the task
+    VLOG(9) << "flush scheduler is not running, run task of inode: "
+            << inodeId << " in place";
+    task();
+}
+
+void FlushScheduler::SyncBegin(uint64_t inodeId) {
+    std::lock_guard<std::mutex> lk(mtx_);
+    InodeQueue *queue = &queues_[inodeId];
+    if (queue->syncRef++ == 0 && queue->ring == kBackground) {
+        Reschedule(inodeId, queue);
+    }
+}
+
+void FlushScheduler::SyncEnd(uint64_t inodeId) {
+    std::lock_guard<std::mutex> lk(mtx_);
+    auto iter = queues_.find(inodeId);
+    if (iter == queues_.end() || iter->second.syncRef == 0) {
+        LOG(ERROR) << "unpaired sync end of inode: " << inodeId;
+        return;
+    }
+    InodeQueue *queue = &iter->second;
+    if (--queue->syncRef == 0) {
+        Reschedule(inodeId, queue);
+        if (queue->ring == kNone) {
+            queues_.erase(iter);
+        }
+    }
+}
+
+uint64_t FlushScheduler::GetQueuedTaskNum() {
+    std::lock_guard<std::mutex> lk(mtx_);
+    return queuedTaskNum_;
+}
+
+void FlushScheduler::Reschedule(uint64_t inodeId, InodeQueue *queue) {
+    if (queue->ring != kNone) {
+        rings_[queue->ring].erase(queue->pos);
+        queue->ring = kNone;
+    }
+    if (queue->tasks.empty()) {
+        return;
+    }
+    queue->ring = queue->syncRef > 0 ? kSync : kBackground;
+    queue->pos = rings_[queue->ring].insert(rings_[queue->ring].end(),
+                                            inodeId);
+}
+
+bool FlushScheduler::Pick(Task *task) {
+    Ring ring;
+    if (rings_[kSync].empty()) {
+        if (rings_[kBackground].empty()) {
+            return false;
+        }
+        ring = kBackground;
+    } else if (syncServed_ >= kSyncBurst && !rings_[kBackground].empty()) {
+        ring = kBackground;
+    } else {
+        ring = kSync;
+    }
+    syncServed_ = ring == kSync ? syncServed_ + 1 : 0;
+
+    uint64_t inodeId = rings_[ring].front();
+    auto iter = queues_.find(inodeId);
+    InodeQueue *queue = &iter->second;
+    *task = std::move(queue->tasks.front());
+    queue->tasks.pop_front();
+    queuedTaskNum_--;
+    // move to the back of its ring, so the next task is of another inode
+    Reschedule(inodeId, queue);
+    if (queue->ring == kNone && queue->syncRef == 0) {
+        queues_.erase(iter);
+    }
+    return true;
+}
+
+void FlushScheduler::Run() {
+    while (true) {
+        Task task;
+        {
+            std::unique_lock<std::mutex> lk(mtx_);
+            cond_.wait(lk, [this]() {
+                return !running_ || queuedTaskNum_ > 0;
+            });
+            if (!Pick(&task)) {
+                // stopped and drained
+                return;
+            }
+        }
+        task();
+    }
+}
+
+}  // namespace client
+}  // namespace curvefs
@@ -0,0 +1,113 @@
+/*
+ *  Copyright (c) 2023 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#ifndef CURVEFS_SRC_CLIENT_S3_CLIENT_S3_FLUSH_SCHEDULER_H_
+#define CURVEFS_SRC_CLIENT_S3_CLIENT_S3_FLUSH_SCHEDULER_H_
+
+#include <condition_variable>  // NOLINT
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <list>
+#include <mutex>  // NOLINT
+#include <thread>  // NOLINT
+#include <unordered_map>
+#include <vector>
+
+namespace curvefs {
+namespace client {
+
+/**
+ * Schedule chunk flush tasks of the write cache.
+ *
+ * Tasks are queued per inode, and workers take one task from each inode
+ * in turn, so a file with many dirty chunks can not starve the others.
+ *
+ * An inode someone is blocked on (fsync, close or a throttled writer) is
+ * marked sync between SyncBegin() and SyncEnd(), its tasks are served
+ * before the ones of background flush. To keep background flush going,
+ * one background task is served after every kSyncBurst sync tasks.
+ */
+class FlushScheduler {
+ public:
+    using Task = std::function<void()>;
+
+    FlushScheduler() = default;
+    ~FlushScheduler();
+
+    FlushScheduler(const FlushScheduler &) = delete;
+    FlushScheduler &operator=(const FlushScheduler &) = delete;
+
+    void Start(uint32_t threadNum);
+
+    // stop workers after the queued tasks are done
+    void Stop();
+
+    void Enqueue(uint64_t inodeId, Task task);
+
+    void SyncBegin(uint64_t inodeId);
+    void SyncEnd(uint64_t inodeId);
+
+    class SyncGuard {
+     public:
+        SyncGuard(FlushScheduler *scheduler, uint64_t inodeId)
+            : scheduler_(scheduler), inodeId_(inodeId) {
+            scheduler_->SyncBegin(inodeId_);
+        }
+        ~SyncGuard() { scheduler_->SyncEnd(inodeId_); }
+
+     private:
+        FlushScheduler *scheduler_;
+        uint64_t inodeId_;
+    };
+
+    uint64_t GetQueuedTaskNum();
+
+ private:
+    enum Ring { kSync = 0, kBackground = 1, kNone = 2 };
+
+    struct InodeQueue {
+        std::deque<Task> tasks;
+        uint32_t syncRef = 0;
+        Ring ring = kNone;
+        std::list<uint64_t>::iterator pos;
+    };
+
+    static const uint32_t kSyncBurst = 8;
+
+    void Run();
+    // put the inode into the ring of its priority, or remove it from the
+    // rings if it has no task
+    void Reschedule(uint64_t inodeId, InodeQueue *queue);
+    bool Pick(Task *task);
+
+ private:
+    std::mutex mtx_;
+    std::condition_variable cond_;
+    bool running_ = false;
+    std::vector<std::thread> workers_;
+
+    std::unordered_map<uint64_t, InodeQueue> queues_;
+    // inodes which have queued tasks, in the order to be served
+    std::list<uint64_t> rings_[2];
+    uint32_t syncServed_ = 0;
+    uint64_t queuedTaskNum_ = 0;
+};
+
+}  // namespace client
+}  // namespace curvefs
+
+#endif  // CURVEFS_SRC_CLIENT_S3_CLIENT_S3_FLUSH_SCHEDULER_H_
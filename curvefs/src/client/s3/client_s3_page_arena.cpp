@@ -0,0 +1,165 @@
+/*
+ *  Copyright (c) 2023 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include "curvefs/src/client/s3/client_s3_page_arena.h"
+
+#include <glog/logging.h>
+#include <sys/mman.h>
+
+#include <cerrno>
+#include <cstring>
+
+namespace curvefs {
+namespace client {
+
+namespace {
+
+const uint64_t kHugePageSize = 2 * 1024 * 1024;
+const uint64_t kIndexMask = 0xffffffffULL;
+
+}  // namespace
+
+PageArena::PageArena(uint32_t pageSize, uint64_t capacity, bool hugePage)
+    : pageSize_(pageSize), capacity_(capacity), hugePage_(hugePage),
+      region_(nullptr), regionSize_(0), base_(nullptr), size_(0),
+      totalPages_(0), carved_(0), freeHead_(0), usedPages_(0),
+      overflowPages_(0) {}
+
+PageArena::~PageArena() {
+    if (region_ != nullptr) {
+        munmap(region_, regionSize_);
+    }
+}
+
+bool PageArena::Init() {
+    uint64_t pages = pageSize_ == 0 ? 0 : capacity_ / pageSize_;
+    if (pages > kIndexMask - 1) {
+        pages = kIndexMask - 1;
+    }
+    if (pages == 0) {
+        LOG(WARNING) << "page arena is empty, pageSize: " << pageSize_
+                     << ", capacity: " << capacity_;
+        return true;
+    }
+
+    // reserve one more huge page to align the arena to huge page
+    uint64_t size = pages * pageSize_;
+    regionSize_ = size + kHugePageSize;
+    void *region = mmap(nullptr, regionSize_, PROT_READ | PROT_WRITE,
+                        MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    if (region == MAP_FAILED) {
+        LOG(ERROR) << "reserve page arena fail, size: " << regionSize_
+                   << ", error: " << strerror(errno);
+        regionSize_ = 0;
+        return false;
+    }
+    region_ = static_cast<char *>(region);
+    uintptr_t aligned = (reinterpret_cast<uintptr_t>(region_) +
+                         kHugePageSize - 1) & ~(kHugePageSize - 1);
+    base_ = reinterpret_cast<char *>(aligned);
+    size_ = size;
+    totalPages_ = static_cast<uint32_t>(pages);
+
+    if (hugePage_ && madvise(base_, size_, MADV_HUGEPAGE) != 0) {
+        LOG(WARNING) << "page arena madvise huge page fail, error: "
+                     << strerror(errno);
+    }
+
+    next_.reset(new std::atomic<uint32_t>[totalPages_]);
+    for (uint32_t i = 0; i < totalPages_; i++) {
+        next_[i].store(0, std::memory_order_relaxed);
+    }
+
+    LOG(INFO) << "page arena init, page size: " << pageSize_
+              << ", pages: " << totalPages_ << ", huge page: " << hugePage_;
+    return true;
+}
+
+char *PageArena::Allocate() {
+    uint32_t index = 0;
+    if (PopFree(&index) || Carve(&index)) {
+        usedPages_.fetch_add(1, std::memory_order_relaxed);
+        return base_ + static_cast<uint64_t>(index) * pageSize_;
+    }
+
+    overflowPages_.fetch_add(1, std::memory_order_relaxed);
+    return new char[pageSize_];
+}
+
+void PageArena::Free(char *page) {
+    if (!Contains(page)) {
+        overflowPages_.fetch_sub(1, std::memory_order_relaxed);
+        delete[] page;
+        return;
+    }
+
+    PushFree(static_cast<uint32_t>((page - base_) / pageSize_));
+    usedPages_.fetch_sub(1, std::memory_order_relaxed);
+}
+
+bool PageArena::IsExhausted() const {
+    return (freeHead_.load(std::memory_order_relaxed) & kIndexMask) == 0 &&
+           carved_.load(std::memory_order_relaxed) >= totalPages_;
+}
+
+bool PageArena::PopFree(uint32_t *index) {
+    uint64_t head = freeHead_.load(std::memory_order_acquire);
+    while (true) {
+        uint32_t first = static_cast<uint32_t>(head & kIndexMask);
+        if (first == 0) {
+            return false;
+        }
+        // next_ may be changed if the page is popped by others, the tag
+        // makes the exchange fail in that case
+        uint64_t next = next_[first - 1].load(std::memory_order_relaxed);
+        uint64_t newHead = (((head >> 32) + 1) << 32) | next;
+        if (freeHead_.compare_exchange_weak(head, newHead,
+                                            std::memory_order_acq_rel,
+                                            std::memory_order_acquire)) {
+            *index = first - 1;
+            return true;
+        }
+    }
+}
+
+void PageArena::PushFree(uint32_t index) {
+    uint64_t head = freeHead_.load(std::memory_order_relaxed);
+    while (true) {
+        next_[index].store(static_cast<uint32_t>(head & kIndexMask),
+                           std::memory_order_relaxed);
+        uint64_t newHead = (((head >> 32) + 1) << 32) | (index + 1);
+        if (freeHead_.compare_exchange_weak(head, newHead,
+                                            std::memory_order_release,
+                                            std::memory_order_relaxed)) {
+            return;
+        }
+    }
+}
+
+bool PageArena::Carve(uint32_t *index) {
+    uint32_t carved = carved_.load(std::memory_order_relaxed);
+    while (carved < totalPages_) {
+        if (carved_.compare_exchange_weak(carved, carved + 1,
+                                          std::memory_order_relaxed)) {
+            *index = carved;
+            return true;
+        }
+    }
+    return false;
+}
+
+}  // namespace client
+}  // namespace curvefs
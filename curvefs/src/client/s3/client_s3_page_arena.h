@@ -0,0 +1,112 @@
+/*
+ *  Copyright (c) 2023 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#ifndef CURVEFS_SRC_CLIENT_S3_CLIENT_S3_PAGE_ARENA_H_
+#define CURVEFS_SRC_CLIENT_S3_CLIENT_S3_PAGE_ARENA_H_
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+#include "src/common/uncopyable.h"
+
+namespace curvefs {
+namespace client {
+
+/**
+ * Fixed size page allocator for the memory read/write cache.
+ *
+ * The whole arena is reserved as one virtual memory region at Init, it
+ * is backed by physical memory as pages are first used, and transparent
+ * huge pages are asked for if hugePage is set. Freed pages are kept in a
+ * lock free free list (a tagged Treiber stack of page indexes) and are
+ * reused before untouched pages, so memory used by the cache never goes
+ * beyond the arena, and never fragments the heap.
+ *
+ * When all pages of the arena are in use, pages are allocated from heap
+ * and counted as overflow, callers are expected to reclaim cache before
+ * it happens, see FsCacheManager::ReclaimReadCache.
+ */
+class PageArena : public curve::common::Uncopyable {
+ public:
+    PageArena(uint32_t pageSize, uint64_t capacity, bool hugePage);
+    ~PageArena();
+
+    /**
+     * @brief Reserve the arena
+     * @return false if the memory can not be reserved
+     */
+    bool Init();
+
+    // allocate a page, never returns nullptr
+    char *Allocate();
+
+    void Free(char *page);
+
+    // whether all pages of the arena are in use
+    bool IsExhausted() const;
+
+    bool Contains(const char *page) const {
+        return page >= base_ && page < base_ + size_;
+    }
+
+    uint32_t GetPageSize() const { return pageSize_; }
+
+    uint64_t GetCapacity() const { return size_; }
+
+    // bytes of arena pages in use
+    uint64_t GetUsedBytes() const {
+        return usedPages_.load(std::memory_order_relaxed) * pageSize_;
+    }
+
+    // bytes of pages allocated from heap
+    uint64_t GetOverflowBytes() const {
+        return overflowPages_.load(std::memory_order_relaxed) * pageSize_;
+    }
+
+ private:
+    bool PopFree(uint32_t *index);
+    void PushFree(uint32_t index);
+    bool Carve(uint32_t *index);
+
+ private:
+    const uint32_t pageSize_;
+    const uint64_t capacity_;
+    const bool hugePage_;
+
+    // the reserved region, and the usable part of it
+    char *region_;
+    uint64_t regionSize_;
+    char *base_;
+    uint64_t size_;
+    uint32_t totalPages_;
+
+    // pages at and after it are never used
+    std::atomic<uint32_t> carved_;
+    // high 32 bits is tag against ABA, low 32 bits is index + 1 of the
+    // first free page, 0 if the list is empty
+    std::atomic<uint64_t> freeHead_;
+    // index + 1 of the next free page
+    std::unique_ptr<std::atomic<uint32_t>[]> next_;
+
+    std::atomic<uint64_t> usedPages_;
+    std::atomic<uint64_t> overflowPages_;
+};
+
+}  // namespace client
+}  // namespace curvefs
+
+#endif  // CURVEFS_SRC_CLIENT_S3_CLIENT_S3_PAGE_ARENA_H_
@@ -0,0 +1,109 @@
+/*
+ *  Copyright (c) 2023 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include "curvefs/src/client/s3/client_s3_readahead.h"
+
+#include <algorithm>
+
+namespace curvefs {
+namespace client {
+
+ReadAhead::ReadAhead(const ReadAheadOption &option)
+    : option_(option), prevEnd_(0), start_(0), size_(0), nextSize_(0),
+      begin_(0), readyEnd_(0), epoch_(0) {}
+
+ReadAhead::Result ReadAhead::OnRead(uint64_t offset, uint64_t len,
+                                    bool memCacheHit, ReadAheadRange *range) {
+    std::lock_guard<std::mutex> lk(mtx_);
+    range->len = 0;
+
+    const uint64_t end = offset + len;
+    const bool inRange =
+        size_ > 0 && offset >= begin_ && offset < start_ + size_;
+    const bool sequential = offset == prevEnd_ || inRange;
+    prevEnd_ = end;
+    if (!sequential) {
+        if (size_ > 0) {
+            ResetLocked();
+        }
+        return Result::NONE;
+    }
+
+    Result result = Result::NONE;
+    if (inRange) {
+        result = memCacheHit ? Result::HIT : Result::MISS;
+        if (!memCacheHit && end <= readyEnd_) {
+            // read ahead data is evicted before it is used
+            nextSize_ = std::max(option_.minBytes, size_ / 2);
+        }
+    }
+
+    if (size_ == 0) {
+        // start of a stream
+        start_ = end;
+        begin_ = end;
+        readyEnd_ = end;
+        nextSize_ = std::min(std::max(option_.minBytes, 2 * len),
+                             option_.maxBytes);
+    } else if (end > start_) {
+        // the latest window is reached, issue the next one
+        start_ = std::max(start_ + size_, end);
+    } else {
+        return result;
+    }
+
+    size_ = nextSize_;
+    nextSize_ = std::min(2 * size_, option_.maxBytes);
+    range->offset = start_;
+    range->len = size_;
+    range->epoch = epoch_.load(std::memory_order_relaxed);
+    return result;
+}
+
+void ReadAhead::OnDone(const ReadAheadRange &range) {
+    std::lock_guard<std::mutex> lk(mtx_);
+    if (IsCanceled(range.epoch)) {
+        return;
+    }
+
+    // windows may be done out of order, only a contiguous range is counted
+    if (range.offset <= readyEnd_) {
+        readyEnd_ = std::max(readyEnd_, range.offset + range.len);
+    }
+}
+
+void ReadAhead::Cancel() {
+    std::lock_guard<std::mutex> lk(mtx_);
+    ResetLocked();
+    prevEnd_ = 0;
+}
+
+uint64_t ReadAhead::GetWindowSize() const {
+    std::lock_guard<std::mutex> lk(mtx_);
+    return size_;
+}
+
+void ReadAhead::ResetLocked() {
+    start_ = 0;
+    size_ = 0;
+    nextSize_ = 0;
+    begin_ = 0;
+    readyEnd_ = 0;
+    epoch_.fetch_add(1, std::memory_order_release);
+}
+
+}  // namespace client
+}  // namespace curvefs
@@ -0,0 +1,108 @@
+/*
+ *  Copyright (c) 2023 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#ifndef CURVEFS_SRC_CLIENT_S3_CLIENT_S3_READAHEAD_H_
+#define CURVEFS_SRC_CLIENT_S3_CLIENT_S3_READAHEAD_H_
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>  // NOLINT
+
+#include "curvefs/src/client/common/config.h"
+
+namespace curvefs {
+namespace client {
+
+using ::curvefs::client::common::ReadAheadOption;
+
+// range of file to read ahead
+struct ReadAheadRange {
+    uint64_t offset = 0;
+    uint64_t len = 0;
+    // ranges issued before the stream is reset are canceled
+    uint64_t epoch = 0;
+};
+
+/**
+ * Sequential read ahead state of one file, it works like the readahead
+ * of the kernel page cache.
+ *
+ * A read that starts at the end of the previous read, or lands in the
+ * read ahead range, belongs to a sequential stream. The first read of a
+ * stream opens a window of max(minBytes, 2 * read length) right after
+ * it, each time a read reaches the latest window, the next window is
+ * issued after it with double size, up to maxBytes. A random read ends
+ * the stream and cancels the inflight windows.
+ *
+ * If a read misses memory cache in the range that is already read ahead,
+ * the data is evicted before it is used, the next window is shrunk to
+ * half of the latest one.
+ */
+class ReadAhead {
+ public:
+    enum class Result {
+        // read is not in the read ahead range
+        NONE,
+        HIT,
+        MISS,
+    };
+
+    explicit ReadAhead(const ReadAheadOption &option);
+
+    /**
+     * @brief Update state with a user read
+     * @param memCacheHit whether the read is all served by memory cache
+     * @param[out] range the range to read ahead, len is 0 if none
+     */
+    Result OnRead(uint64_t offset, uint64_t len, bool memCacheHit,
+                  ReadAheadRange *range);
+
+    // data of range is in memory cache now
+    void OnDone(const ReadAheadRange &range);
+
+    bool IsCanceled(uint64_t epoch) const {
+        return epoch != epoch_.load(std::memory_order_acquire);
+    }
+
+    // cancel inflight ranges and reset the stream
+    void Cancel();
+
+    uint64_t GetWindowSize() const;
+
+ private:
+    void ResetLocked();
+
+ private:
+    const ReadAheadOption option_;
+
+    mutable std::mutex mtx_;
+    // end offset of the previous read
+    uint64_t prevEnd_;
+    // the latest window, size_ is 0 if there is no stream
+    uint64_t start_;
+    uint64_t size_;
+    // size of the next window
+    uint64_t nextSize_;
+    // [begin_, readyEnd_) is read ahead into memory cache
+    uint64_t begin_;
+    uint64_t readyEnd_;
+    std::atomic<uint64_t> epoch_;
+};
+
+}  // namespace client
+}  // namespace curvefs
+
+#endif  // CURVEFS_SRC_CLIENT_S3_CLIENT_S3_READAHEAD_H_
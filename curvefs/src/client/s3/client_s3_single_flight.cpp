@@ -0,0 +1,103 @@
+/*
+ *  Copyright (c) 2023 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include "curvefs/src/client/s3/client_s3_single_flight.h"
+
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+namespace curvefs {
+namespace client {
+
+ReadSingleFlight::ReadSingleFlight(uint32_t shardNum) {
+    shardNum = std::max(shardNum, 1u);
+    shards_.reserve(shardNum);
+    for (uint32_t i = 0; i < shardNum; i++) {
+        shards_.emplace_back(new Shard());
+    }
+}
+
+ReadSingleFlight::Shard *ReadSingleFlight::GetShard(const std::string &name) {
+    return shards_[std::hash<std::string>()(name) % shards_.size()].get();
+}
+
+ReadSingleFlight::FlightPtr
+ReadSingleFlight::JoinOrLead(const std::string &name, uint64_t offset,
+                             uint64_t len, char *buf, WaitDone done) {
+    Shard *shard = GetShard(name);
+    std::lock_guard<std::mutex> lk(shard->mtx);
+    auto &flights = shard->flights[name];
+    for (auto &flight : flights) {
+        if (flight->offset <= offset &&
+            offset + len <= flight->offset + flight->len) {
+            flight->waiters.push_back(Waiter{buf, offset, len,
+                                             std::move(done)});
+            return nullptr;
+        }
+    }
+
+    auto flight = std::make_shared<Flight>();
+    flight->name = name;
+    flight->offset = offset;
+    flight->len = len;
+    flights.push_back(flight);
+    return flight;
+}
+
+void ReadSingleFlight::Finish(const FlightPtr &flight, const char *data,
+                              uint64_t actualLen) {
+    std::vector<Waiter> waiters;
+    {
+        Shard *shard = GetShard(flight->name);
+        std::lock_guard<std::mutex> lk(shard->mtx);
+        auto iter = shard->flights.find(flight->name);
+        if (iter != shard->flights.end()) {
+            auto &flights = iter->second;
+            flights.erase(std::remove(flights.begin(), flights.end(), flight),
+                          flights.end());
+            if (flights.empty()) {
+                shard->flights.erase(iter);
+            }
+        }
+        waiters.swap(flight->waiters);
+    }
+
+    // no one can join the flight now
+    const uint64_t end = flight->offset + std::min(actualLen, flight->len);
+    for (auto &waiter : waiters) {
+        bool served = waiter.offset + waiter.len <= end;
+        if (served) {
+            memcpy(waiter.buf, data + (waiter.offset - flight->offset),
+                   waiter.len);
+        }
+        waiter.done(served);
+    }
+}
+
+uint64_t ReadSingleFlight::GetFlightNum() {
+    uint64_t num = 0;
+    for (auto &shard : shards_) {
+        std::lock_guard<std::mutex> lk(shard->mtx);
+        for (auto &item : shard->flights) {
+            num += item.second.size();
+        }
+    }
+    return num;
+}
+
+}  // namespace client
+}  // namespace curvefs
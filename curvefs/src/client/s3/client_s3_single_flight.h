@@ -0,0 +1,102 @@
+/*
+ *  Copyright (c) 2023 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#ifndef CURVEFS_SRC_CLIENT_S3_CLIENT_S3_SINGLE_FLIGHT_H_
+#define CURVEFS_SRC_CLIENT_S3_CLIENT_S3_SINGLE_FLIGHT_H_
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>  // NOLINT
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace curvefs {
+namespace client {
+
+/**
+ * Coalesce concurrent downloads of the same object.
+ *
+ * The first reader of a range leads a flight and downloads it. A reader
+ * arriving while a flight of the same object is in progress and covers
+ * its range waits for that flight and gets a copy of the data, instead of
+ * sending another request to s3.
+ *
+ * Flights are kept in shards by object name, so readers of different
+ * objects do not contend on one lock.
+ */
+class ReadSingleFlight {
+ public:
+    // called once the flight a waiter joined is finished, served is false
+    // if the flight failed or read less than the waiter needs, the waiter
+    // should read by itself then
+    using WaitDone = std::function<void(bool served)>;
+
+    struct Waiter {
+        char *buf;
+        uint64_t offset;
+        uint64_t len;
+        WaitDone done;
+    };
+
+    struct Flight {
+        std::string name;
+        uint64_t offset;
+        uint64_t len;
+        std::vector<Waiter> waiters;
+    };
+
+    using FlightPtr = std::shared_ptr<Flight>;
+
+    explicit ReadSingleFlight(uint32_t shardNum = 64);
+
+    /**
+     * @brief join an inflight read covering [offset, offset + len) of the
+     *        object, or lead a new one
+     * @return nullptr if joined, done is called once the flight finishes;
+     *         otherwise the caller leads the returned flight and must call
+     *         Finish() when its read is done
+     */
+    FlightPtr JoinOrLead(const std::string &name, uint64_t offset,
+                         uint64_t len, char *buf, WaitDone done);
+
+    /**
+     * @brief finish a flight and serve its waiters
+     * @param data data of the flight range, only used during the call
+     * @param actualLen bytes read into data, 0 if the read failed
+     */
+    void Finish(const FlightPtr &flight, const char *data,
+                uint64_t actualLen);
+
+    uint64_t GetFlightNum();
+
+ private:
+    struct Shard {
+        std::mutex mtx;
+        std::unordered_map<std::string, std::vector<FlightPtr>> flights;
+    };
+
+    Shard *GetShard(const std::string &name);
+
+ private:
+    std::vector<std::unique_ptr<Shard>> shards_;
+};
+
+}  // namespace client
+}  // namespace curvefs
+
+#endif  // CURVEFS_SRC_CLIENT_S3_CLIENT_S3_SINGLE_FLIGHT_H_
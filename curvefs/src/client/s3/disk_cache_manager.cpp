@@ -21,6 +21,7 @@
  */
 #include <sys/vfs.h>
 #include <errno.h>
+#include <algorithm>
 #include <string>
 #include <cstdio>
 #include <memory>
@@ -97,12 +98,20 @@ int DiskCacheManager::Init(std::shared_ptr<S3Client> client,
         LOG(ERROR) << "create cache dir error, ret = " << ret;
         return ret;
     }
-    // load all cache read file
-    // the all value of cachedObjName_ is set false
-    ret = cacheRead_->LoadAllCacheReadFile(cachedObjName_);
-    if (ret < 0) {
-        LOG(ERROR) << "load all cache read file error. ret = " << ret;
-        return ret;
+    if (option.diskCacheOpt.segmentEnable) {
+        ret = InitSegmentCache();
+        if (ret < 0) {
+            LOG(ERROR) << "init segment cache error. ret = " << ret;
+            return ret;
+        }
+    } else {
+        // load all cache read file
+        // the all value of cachedObjName_ is set false
+        ret = cacheRead_->LoadAllCacheReadFile(cachedObjName_);
+        if (ret < 0) {
+            LOG(ERROR) << "load all cache read file error. ret = " << ret;
+            return ret;
+        }
     }
 
     // start async upload thread
@@ -136,6 +145,42 @@ int DiskCacheManager::Init(std::shared_ptr<S3Client> client,
     return 0;
 }
 
+int DiskCacheManager::InitSegmentCache() {
+    // the rest of the usable space is left for write cache
+    uint64_t capacity = maxUsableSpaceBytes_ / 100 * safeRatio_;
+    auto cacheSegment = std::make_shared<DiskCacheSegment>(posixWrapper_);
+    // if file has not been uploaded to S3, it can only be read from cache,
+    // so the segment holding it can not be evicted
+    std::string cacheWriteFullDir = GetCacheWriteFullDir();
+    cacheSegment->SetPinnedFunc(
+        [this, cacheWriteFullDir](const std::string &name) {
+            std::string cacheWriteFile = cacheWriteFullDir + "/" +
+                curvefs::common::s3util::GenPathByObjName(name,
+                                                          objectPrefix_);
+            struct stat statFile;
+            return posixWrapper_->stat(cacheWriteFile.c_str(),
+                                       &statFile) == 0;
+        });
+    int ret = cacheSegment->Init(cacheDir_ + "/segment",
+                                 option_.diskCacheOpt.segmentSize, capacity);
+    if (ret < 0) {
+        return ret;
+    }
+    cacheSegment_ = cacheSegment;
+    // write cache files are copied into segment rather than linked, count
+    // them until they are uploaded and removed
+    cacheWrite_->SetRemoveCallback([this](uint64_t length) {
+        // the files left in write cache dir are not counted if failed
+        // to get the size of it
+        DecDiskUsedBytes(std::min(length, usedBytes_.load()));
+    });
+    // the used size of segments is got from the index, only the write
+    // cache dir is walked, before the files left in it are uploaded
+    SetDiskInitUsedBytes(cacheWriteFullDir);
+    diskUsedInit_.store(true);
+    return 0;
+}
+
 void DiskCacheManager::InitQosParam() {
     ReadWriteThrottleParams params;
     params.iopsWrite = ThrottleParams(FLAGS_avgFlushIops, 0, 0);
@@ -156,15 +201,25 @@ int DiskCacheManager::UploadWriteCacheByInode(const std::string &inode) {
 }
 
 int DiskCacheManager::ClearReadCache(const std::list<std::string> &files) {
+    if (cacheSegment_ != nullptr) {
+        return cacheSegment_->ClearReadCache(files);
+    }
     return cacheRead_->ClearReadCache(files);
 }
 
 void DiskCacheManager::AddCache(const std::string &name) {
+    // segment cache is indexed by itself, and trimmed by segment
+    if (cacheSegment_ != nullptr) {
+        return;
+    }
     cachedObjName_->Put(name);
     VLOG(9) << "cache size is: " << cachedObjName_->Size();
 }
 
 bool DiskCacheManager::IsCached(const std::string &name) {
+    if (cacheSegment_ != nullptr) {
+        return cacheSegment_->IsCached(name);
+    }
     if (!cachedObjName_->IsCached(name)) {
         VLOG(9) << "not cached, name = " << name;
         return false;
@@ -184,6 +239,9 @@ int DiskCacheManager::UmountDiskCache() {
     }
     TrimStop();
     cacheWrite_->AsyncUploadStop();
+    if (cacheSegment_ != nullptr) {
+        cacheSegment_->Close();
+    }
     LOG_IF(ERROR, !IsCacheClean()) << "umount disk cache error.";
     LOG(INFO) << "umount disk cache end.";
     return 0;
@@ -244,6 +302,9 @@ int DiskCacheManager::ReadDiskFile(const std::string name, char *buf,
                                    uint64_t offset, uint64_t length) {
     // read throttle
     diskCacheThrottle_.Add(true, length);
+    if (cacheSegment_ != nullptr) {
+        return cacheSegment_->ReadDiskFile(name, buf, offset, length);
+    }
     return cacheRead_->ReadDiskFile(name, buf, offset, length);
 }
 
@@ -251,12 +312,24 @@ int DiskCacheManager::WriteReadDirect(const std::string fileName,
                                       const char *buf, uint64_t length) {
     // write hrottle
     diskCacheThrottle_.Add(false, length);
+    if (cacheSegment_ != nullptr) {
+        return WriteSegmentCache(fileName, buf, length, false);
+    }
     int ret = cacheRead_->WriteDiskFile(fileName, buf, length);
     if (ret > 0)
         AddDiskUsedBytes(ret);
     return ret;
 }
 
+int DiskCacheManager::WriteSegmentCache(const std::string &fileName,
+                                        const char *buf, uint64_t length,
+                                        bool force) {
+    int ret = cacheSegment_->WriteDiskFile(fileName, buf, length, force);
+    if (ret > 0 && metric_.get() != nullptr)
+        metric_->diskUsedBytes.set_value(GetDiskUsedbytes());
+    return ret;
+}
+
 int DiskCacheManager::LinkWriteToRead(const std::string fileName,
                                       const std::string fullWriteDir,
                                       const std::string fullReadDir) {
@@ -286,9 +359,9 @@ int64_t DiskCacheManager::SetDiskFsUsedRatio() {
     return usedPercent;
 }
 
-void DiskCacheManager::SetDiskInitUsedBytes() {
+void DiskCacheManager::SetDiskInitUsedBytes(const std::string &dir) {
     std::string cmd = "timeout " + std::to_string(cmdTimeoutSec_) + " du -sb " +
-                      cacheDir_ + " | awk '{printf $1}' ";
+                      dir + " | awk '{printf $1}' ";
     SysUtils sysUtils;
     std::string result = sysUtils.RunSysCmd(cmd);
     if (result.empty()) {
@@ -466,12 +539,16 @@ void DiskCacheManager::InitMetrics(const std::string &fsName) {
     metric_ = std::make_shared<DiskCacheMetric>(fsName);
     cacheWrite_->InitMetrics(metric_);
     cacheRead_->InitMetrics(metric_);
+    if (cacheSegment_ != nullptr) {
+        metric_->diskUsedBytes.set_value(GetDiskUsedbytes());
+        return;
+    }
     // this function move to here from init，
     // Otherwise, you can't get the original metric.
     // SetDiskInitUsedBytes may takes a long time,
     // so use a separate thread to do this.
     diskInitThread_ = curve::common::Thread(
-      &DiskCacheManager::SetDiskInitUsedBytes, this);
+      &DiskCacheManager::SetDiskInitUsedBytes, this, cacheDir_);
 }
 
 }  // namespace client
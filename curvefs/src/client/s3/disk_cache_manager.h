@@ -40,6 +40,7 @@
 #include "curvefs/src/client/s3/client_s3.h"
 #include "curvefs/src/client/s3/disk_cache_write.h"
 #include "curvefs/src/client/s3/disk_cache_read.h"
+#include "curvefs/src/client/s3/disk_cache_segment.h"
 #include "curvefs/src/client/common/config.h"
 namespace curvefs {
 namespace client {
@@ -89,6 +90,18 @@ class DiskCacheManager {
     int LinkWriteToRead(const std::string fileName,
                         const std::string fullWriteDir,
                         const std::string fullReadDir);
+    /**
+     * @brief whether read cache is kept in segment files,
+     *        see diskCache.segment.enable
+     */
+    bool IsSegmentCache() const { return cacheSegment_ != nullptr; }
+    /**
+     * @brief put obj into segment cache, it takes the place of
+     *        LinkWriteToRead when IsSegmentCache
+     * @return success: write length, fail : < 0
+     */
+    int WriteSegmentCache(const std::string &fileName, const char *buf,
+                          uint64_t length, bool force);
     int UploadAllCacheWriteFile();
     int UploadWriteCacheByInode(const std::string &inode);
     int ClearReadCache(const std::list<std::string> &files);
@@ -143,11 +156,17 @@ class DiskCacheManager {
                 << ", now is: " << usedBytes_.load();
         return;
     }
-    void SetDiskInitUsedBytes();
+    void SetDiskInitUsedBytes(const std::string &dir);
     uint64_t GetDiskUsedbytes() {
+        // usedBytes_ only counts write cache files with segment cache
+        if (cacheSegment_ != nullptr) {
+            return cacheSegment_->GetUsedBytes() + usedBytes_.load();
+        }
         return usedBytes_.load();
     }
 
+    int InitSegmentCache();
+
     void InitQosParam();
     /**
      * @brief trim cache func.
@@ -182,6 +201,8 @@ class DiskCacheManager {
     std::string cacheDir_;
     std::shared_ptr<DiskCacheWrite> cacheWrite_;
     std::shared_ptr<DiskCacheRead> cacheRead_;
+    // not null if read cache is kept in segment files
+    std::shared_ptr<DiskCacheSegment> cacheSegment_;
 
     std::shared_ptr<SglLRUCache<std::string>> cachedObjName_;
 
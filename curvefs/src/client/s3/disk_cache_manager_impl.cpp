@@ -121,6 +121,18 @@ int DiskCacheManagerImpl::WriteDiskFile(const std::string name, const char *buf,
         return writeRet;
     }
     // add read cache
+    if (diskCacheManager_->IsSegmentCache()) {
+        // the obj must be readable from cache before it is uploaded,
+        // so sync it as the write cache file
+        int segmentRet = diskCacheManager_->WriteSegmentCache(
+            name, buf, length, forceFlush_);
+        if (segmentRet < 0) {
+            LOG(ERROR) << "write segment cache error. ret = " << segmentRet;
+            return segmentRet;
+        }
+        diskCacheManager_->AsyncUploadEnqueue(name);
+        return 0;
+    }
     std::string cacheWriteFullDir, cacheReadFullDir;
     cacheWriteFullDir = diskCacheManager_->GetCacheWriteFullDir();
     cacheReadFullDir = diskCacheManager_->GetCacheReadFullDir();
@@ -0,0 +1,691 @@
+/*
+ *  Copyright (c) 2023 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include "curvefs/src/client/s3/disk_cache_segment.h"
+
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <glog/logging.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <limits>
+#include <set>
+
+#include "src/common/crc32.h"
+
+namespace curvefs {
+namespace client {
+
+using curve::common::ReadLockGuard;
+using curve::common::WriteLockGuard;
+
+namespace {
+
+const char kSegmentPrefix[] = "segment_";
+const char kIndexSuffix[] = ".index";
+const char kTmpSuffix[] = ".tmp";
+
+const uint32_t kRecordMagic = 0x43535243;  // "CSRC"
+const uint32_t kIndexMagic = 0x43534958;   // "CSIX"
+const uint32_t kIndexVersion = 1;
+const uint32_t kMaxNameLen = 4096;
+
+// crc covers the header after it, and the name
+struct RecordHeader {
+    uint32_t magic;
+    uint32_t crc;
+    uint64_t seq;
+    uint32_t nameLen;
+    uint32_t dataLen;
+    uint32_t dataCrc;
+    uint32_t reserved;
+};
+
+// crc covers the header after it, and all entries
+struct IndexHeader {
+    uint32_t magic;
+    uint32_t crc;
+    uint32_t version;
+    uint32_t id;
+    uint64_t seq;
+    uint64_t count;
+    uint64_t length;
+};
+
+// followed by name
+struct IndexEntry {
+    uint64_t offset;
+    uint32_t length;
+    uint32_t nameLen;
+};
+
+static_assert(sizeof(RecordHeader) == 32, "unexpected record header size");
+static_assert(sizeof(IndexHeader) == 40, "unexpected index header size");
+static_assert(sizeof(IndexEntry) == 16, "unexpected index entry size");
+
+const size_t kHeaderCrcOffset = offsetof(RecordHeader, seq);
+const size_t kIndexCrcOffset = offsetof(IndexHeader, version);
+
+uint32_t RecordCrc(const RecordHeader &header, const char *name) {
+    uint32_t crc = curve::common::CRC32(
+        reinterpret_cast<const char *>(&header) + kHeaderCrcOffset,
+        sizeof(header) - kHeaderCrcOffset);
+    return curve::common::CRC32(crc, name, header.nameLen);
+}
+
+uint32_t IndexCrc(const IndexHeader &header, const char *body) {
+    uint32_t crc = curve::common::CRC32(
+        reinterpret_cast<const char *>(&header) + kIndexCrcOffset,
+        sizeof(header) - kIndexCrcOffset);
+    return curve::common::CRC32(crc, body, header.length);
+}
+
+bool HasSuffix(const std::string &name, const std::string &suffix) {
+    return name.size() > suffix.size() &&
+           name.compare(name.size() - suffix.size(), suffix.size(),
+                        suffix) == 0;
+}
+
+// parse id from segment_<id>
+bool ParseSegmentId(const std::string &name, uint32_t *id) {
+    const std::string prefix(kSegmentPrefix);
+    if (name.size() <= prefix.size() ||
+        name.size() > prefix.size() + 10 ||
+        name.compare(0, prefix.size(), prefix) != 0) {
+        return false;
+    }
+    uint64_t value = 0;
+    for (size_t i = prefix.size(); i < name.size(); i++) {
+        if (name[i] < '0' || name[i] > '9') {
+            return false;
+        }
+        value = value * 10 + (name[i] - '0');
+    }
+    if (value > std::numeric_limits<uint32_t>::max()) {
+        return false;
+    }
+    *id = static_cast<uint32_t>(value);
+    return true;
+}
+
+}  // namespace
+
+DiskCacheSegment::DiskCacheSegment(
+    std::shared_ptr<PosixWrapper> posixWrapper)
+    : posixWrapper_(posixWrapper), segmentSize_(0), segmentNum_(0),
+      active_(nullptr), nextSeq_(1), clock_(0), usedBytes_(0) {}
+
+DiskCacheSegment::~DiskCacheSegment() {
+    Close();
+}
+
+std::string DiskCacheSegment::SegmentPath(uint32_t id) const {
+    return dir_ + "/" + kSegmentPrefix + std::to_string(id);
+}
+
+std::string DiskCacheSegment::IndexPath(uint32_t id) const {
+    return SegmentPath(id) + kIndexSuffix;
+}
+
+int DiskCacheSegment::Init(const std::string &dir, uint64_t segmentSize,
+                           uint64_t capacity) {
+    dir_ = dir;
+    segmentSize_ = segmentSize;
+    uint64_t segmentNum = segmentSize == 0 ? 0 : capacity / segmentSize;
+    if (segmentNum == 0 || segmentSize <= sizeof(RecordHeader) ||
+        segmentNum > std::numeric_limits<uint32_t>::max()) {
+        LOG(ERROR) << "invalid segment cache option, segment size: "
+                   << segmentSize << ", capacity: " << capacity;
+        return -1;
+    }
+    segmentNum_ = static_cast<uint32_t>(segmentNum);
+
+    struct stat statFile;
+    if (posixWrapper_->stat(dir_.c_str(), &statFile) < 0 &&
+        posixWrapper_->mkdir(dir_.c_str(), 0755) < 0 && errno != EEXIST) {
+        LOG(ERROR) << "create segment dir error. errno = " << errno
+                   << ", dir = " << dir_;
+        return -1;
+    }
+
+    DIR *cacheDir = posixWrapper_->opendir(dir_.c_str());
+    if (cacheDir == nullptr) {
+        LOG(ERROR) << "opendir error, errno = " << errno
+                   << ", dir = " << dir_;
+        return -1;
+    }
+    segments_.resize(segmentNum_);
+    struct dirent *cacheDirent;
+    while ((cacheDirent = posixWrapper_->readdir(cacheDir)) != nullptr) {
+        std::string name(cacheDirent->d_name);
+        uint32_t id = 0;
+        if (HasSuffix(name, kTmpSuffix)) {
+            // index not renamed before crash
+            posixWrapper_->remove((dir_ + "/" + name).c_str());
+            continue;
+        }
+        if (!ParseSegmentId(name, &id)) {
+            continue;
+        }
+        if (id >= segmentNum_) {
+            // capacity is shrunk
+            posixWrapper_->remove(IndexPath(id).c_str());
+            posixWrapper_->remove(SegmentPath(id).c_str());
+            continue;
+        }
+
+        std::unique_ptr<Segment> segment(new Segment());
+        segment->id = id;
+        if (OpenSegment(segment.get(), false) < 0) {
+            continue;
+        }
+        if (!LoadIndex(segment.get())) {
+            RecoverSegment(segment.get());
+        }
+        if (segment->seq >= nextSeq_) {
+            nextSeq_ = segment->seq + 1;
+        }
+        segments_[id] = std::move(segment);
+    }
+    posixWrapper_->closedir(cacheDir);
+    clock_.store(nextSeq_);
+
+    LOG(INFO) << "segment cache init success, dir: " << dir_
+              << ", segment size: " << segmentSize_
+              << ", segment num: " << segmentNum_
+              << ", cached objs: " << GetCachedNum()
+              << ", used bytes: " << GetUsedBytes();
+    return 0;
+}
+
+void DiskCacheSegment::Close() {
+    std::lock_guard<std::mutex> lk(appendMtx_);
+    if (active_ != nullptr && !active_->entries.empty()) {
+        SealSegment(active_);
+    }
+    active_ = nullptr;
+    for (auto &segment : segments_) {
+        if (segment != nullptr && segment->fd >= 0) {
+            posixWrapper_->close(segment->fd);
+            segment->fd = -1;
+        }
+    }
+}
+
+int DiskCacheSegment::OpenSegment(Segment *segment, bool create) {
+    std::string path = SegmentPath(segment->id);
+    int flags = create ? O_RDWR | O_CREAT : O_RDWR;
+    segment->fd = posixWrapper_->open(path.c_str(), flags, 0644);
+    if (segment->fd < 0) {
+        LOG(ERROR) << "open segment error, errno = " << errno
+                   << ", segment = " << path;
+        return -1;
+    }
+    // keep the segment contiguous on disk, and never fail appending
+    // with ENOSPC
+    if (posixWrapper_->fallocate(segment->fd, 0, 0, segmentSize_) < 0) {
+        LOG(WARNING) << "fallocate segment error, errno = " << errno
+                     << ", segment = " << path;
+    }
+    return 0;
+}
+
+bool DiskCacheSegment::LoadIndex(Segment *segment) {
+    std::string path = IndexPath(segment->id);
+    int fd = posixWrapper_->open(path.c_str(), O_RDONLY, 0644);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat statFile;
+    if (posixWrapper_->fstat(fd, &statFile) < 0 ||
+        statFile.st_size < static_cast<off_t>(sizeof(IndexHeader))) {
+        posixWrapper_->close(fd);
+        LOG(WARNING) << "invalid segment index, index = " << path;
+        posixWrapper_->remove(path.c_str());
+        return false;
+    }
+    uint64_t size = statFile.st_size;
+    void *addr = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    posixWrapper_->close(fd);
+    if (addr == MAP_FAILED) {
+        LOG(ERROR) << "mmap segment index error, errno = " << errno
+                   << ", index = " << path;
+        return false;
+    }
+
+    const char *data = static_cast<const char *>(addr);
+    IndexHeader header;
+    memcpy(&header, data, sizeof(header));
+    const char *body = data + sizeof(header);
+    bool valid = header.magic == kIndexMagic &&
+                 header.version == kIndexVersion &&
+                 header.id == segment->id &&
+                 header.length == size - sizeof(header) &&
+                 header.crc == IndexCrc(header, body);
+
+    std::vector<Entry> entries;
+    uint64_t pos = 0;
+    uint64_t end = 0;
+    for (uint64_t i = 0; valid && i < header.count; i++) {
+        IndexEntry entry;
+        if (pos + sizeof(entry) > header.length) {
+            valid = false;
+            break;
+        }
+        memcpy(&entry, body + pos, sizeof(entry));
+        pos += sizeof(entry);
+        uint64_t recordEnd = entry.offset + sizeof(RecordHeader) +
+                             entry.nameLen + entry.length;
+        if (entry.nameLen == 0 || entry.nameLen > kMaxNameLen ||
+            pos + entry.nameLen > header.length ||
+            recordEnd > segmentSize_) {
+            valid = false;
+            break;
+        }
+        entries.push_back(
+            Entry{std::string(body + pos, entry.nameLen), entry.offset,
+                  entry.length});
+        pos += entry.nameLen;
+        end = std::max(end, recordEnd);
+    }
+    munmap(addr, size);
+    if (!valid) {
+        LOG(WARNING) << "invalid segment index, index = " << path;
+        posixWrapper_->remove(path.c_str());
+        return false;
+    }
+
+    WriteLockGuard lg(rwLock_);
+    for (const auto &entry : entries) {
+        AddEntryLocked(segment, entry);
+    }
+    segment->seq = header.seq;
+    segment->offset = end;
+    segment->sealed = true;
+    segment->lastAccess.store(header.seq);
+    return true;
+}
+
+void DiskCacheSegment::RecoverSegment(Segment *segment) {
+    std::vector<Entry> entries;
+    std::vector<char> buf;
+    uint64_t seq = 0;
+    uint64_t offset = 0;
+    while (offset + sizeof(RecordHeader) <= segmentSize_) {
+        RecordHeader header;
+        ssize_t ret = posixWrapper_->pread(segment->fd, &header,
+                                           sizeof(header), offset);
+        if (ret != static_cast<ssize_t>(sizeof(header)) ||
+            header.magic != kRecordMagic || header.nameLen == 0 ||
+            header.nameLen > kMaxNameLen) {
+            break;
+        }
+        // records after the last one appended are left by the previous
+        // use of the segment
+        if (seq != 0 && header.seq != seq) {
+            break;
+        }
+        uint64_t recordLen =
+            sizeof(header) + header.nameLen + header.dataLen;
+        if (offset + recordLen > segmentSize_) {
+            break;
+        }
+        buf.resize(header.nameLen + header.dataLen);
+        ret = posixWrapper_->pread(segment->fd, buf.data(), buf.size(),
+                                   offset + sizeof(header));
+        if (ret != static_cast<ssize_t>(buf.size()) ||
+            header.crc != RecordCrc(header, buf.data()) ||
+            header.dataCrc != curve::common::CRC32(
+                                  buf.data() + header.nameLen,
+                                  header.dataLen)) {
+            break;
+        }
+        seq = header.seq;
+        entries.push_back(Entry{std::string(buf.data(), header.nameLen),
+                                offset, header.dataLen});
+        offset += recordLen;
+    }
+
+    if (entries.empty()) {
+        return;
+    }
+    {
+        WriteLockGuard lg(rwLock_);
+        for (const auto &entry : entries) {
+            AddEntryLocked(segment, entry);
+        }
+    }
+    segment->seq = seq;
+    segment->offset = offset;
+    segment->lastAccess.store(seq);
+    SealSegment(segment);
+    LOG(INFO) << "recover segment " << segment->id << ", objs: "
+              << entries.size() << ", length: " << offset;
+}
+
+int DiskCacheSegment::SealSegment(Segment *segment) {
+    // the segment is never appended any more, even if it fails
+    segment->sealed = true;
+    if (posixWrapper_->fdatasync(segment->fd) < 0) {
+        LOG(ERROR) << "sync segment error, errno = " << errno
+                   << ", segment = " << segment->id;
+        return -1;
+    }
+    return WriteIndex(segment);
+}
+
+int DiskCacheSegment::WriteIndex(Segment *segment) {
+    std::string body;
+    for (const auto &entry : segment->entries) {
+        IndexEntry indexEntry;
+        indexEntry.offset = entry.offset;
+        indexEntry.length = entry.length;
+        indexEntry.nameLen = entry.name.size();
+        body.append(reinterpret_cast<const char *>(&indexEntry),
+                    sizeof(indexEntry));
+        body.append(entry.name);
+    }
+    IndexHeader header;
+    header.magic = kIndexMagic;
+    header.version = kIndexVersion;
+    header.id = segment->id;
+    header.seq = segment->seq;
+    header.count = segment->entries.size();
+    header.length = body.size();
+    header.crc = IndexCrc(header, body.data());
+    body.insert(0, reinterpret_cast<const char *>(&header), sizeof(header));
+
+    std::string path = IndexPath(segment->id);
+    std::string tmpPath = path + kTmpSuffix;
+    int fd = posixWrapper_->open(tmpPath.c_str(),
+                                 O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        LOG(ERROR) << "open segment index error, errno = " << errno
+                   << ", index = " << tmpPath;
+        return -1;
+    }
+    ssize_t ret = posixWrapper_->write(fd, body.data(), body.size());
+    if (ret != static_cast<ssize_t>(body.size()) ||
+        posixWrapper_->fsync(fd) < 0) {
+        LOG(ERROR) << "write segment index error, errno = " << errno
+                   << ", index = " << tmpPath;
+        posixWrapper_->close(fd);
+        posixWrapper_->remove(tmpPath.c_str());
+        return -1;
+    }
+    posixWrapper_->close(fd);
+    if (posixWrapper_->rename(tmpPath.c_str(), path.c_str()) < 0) {
+        LOG(ERROR) << "rename segment index error, errno = " << errno
+                   << ", index = " << path;
+        posixWrapper_->remove(tmpPath.c_str());
+        return -1;
+    }
+    VLOG(3) << "seal segment " << segment->id << ", objs: "
+            << segment->entries.size() << ", length: " << segment->offset;
+    return 0;
+}
+
+DiskCacheSegment::Segment *DiskCacheSegment::AllocateSegment() {
+    Segment *target = nullptr;
+    std::vector<Segment *> sealed;
+    for (uint32_t id = 0; id < segmentNum_ && target == nullptr; id++) {
+        Segment *segment = segments_[id].get();
+        if (segment == nullptr) {
+            std::unique_ptr<Segment> created(new Segment());
+            created->id = id;
+            if (OpenSegment(created.get(), true) < 0) {
+                return nullptr;
+            }
+            target = created.get();
+            WriteLockGuard lg(rwLock_);
+            segments_[id] = std::move(created);
+        } else if (!segment->sealed && segment != active_) {
+            // nothing is recovered from it
+            target = segment;
+        } else if (segment->sealed) {
+            sealed.push_back(segment);
+        }
+    }
+    if (target == nullptr) {
+        std::sort(sealed.begin(), sealed.end(),
+                  [](const Segment *a, const Segment *b) {
+                      return a->lastAccess.load() < b->lastAccess.load();
+                  });
+        for (Segment *segment : sealed) {
+            if (!IsPinned(segment)) {
+                target = segment;
+                break;
+            }
+        }
+        if (target == nullptr) {
+            LOG(WARNING) << "all sealed segments are pinned, segments: "
+                         << sealed.size();
+            return nullptr;
+        }
+        if (!EvictSegment(target)) {
+            return nullptr;
+        }
+    }
+
+    target->seq = nextSeq_++;
+    target->offset = 0;
+    target->sealed = false;
+    target->lastAccess.store(clock_.fetch_add(1) + 1);
+    return target;
+}
+
+bool DiskCacheSegment::IsPinned(Segment *segment) {
+    if (!pinned_) {
+        return false;
+    }
+    std::vector<std::string> names;
+    {
+        ReadLockGuard lg(rwLock_);
+        for (const auto &entry : segment->entries) {
+            names.push_back(entry.name);
+        }
+    }
+    for (const auto &name : names) {
+        if (pinned_(name)) {
+            VLOG(6) << "segment " << segment->id << " is pinned by " << name;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool DiskCacheSegment::EvictSegment(Segment *segment) {
+    size_t evicted = 0;
+    {
+        WriteLockGuard lg(rwLock_);
+        for (const auto &entry : segment->entries) {
+            auto iter = index_.find(entry.name);
+            if (iter != index_.end() && iter->second.segment == segment->id) {
+                usedBytes_.fetch_sub(iter->second.length);
+                index_.erase(iter);
+                evicted++;
+            }
+        }
+        segment->entries.clear();
+    }
+    // the index must be gone before the segment is overwritten
+    std::string path = IndexPath(segment->id);
+    if (posixWrapper_->remove(path.c_str()) < 0 && errno != ENOENT) {
+        LOG(ERROR) << "remove segment index error, errno = " << errno
+                   << ", index = " << path;
+        return false;
+    }
+    VLOG(3) << "evict segment " << segment->id << ", objs: " << evicted;
+    return true;
+}
+
+void DiskCacheSegment::AddEntryLocked(Segment *segment, const Entry &entry) {
+    Location location;
+    location.segment = segment->id;
+    location.offset = entry.offset + sizeof(RecordHeader) + entry.name.size();
+    location.length = entry.length;
+    if (!index_.emplace(entry.name, location).second) {
+        return;
+    }
+    segment->entries.push_back(entry);
+    usedBytes_.fetch_add(entry.length);
+}
+
+bool DiskCacheSegment::IsCached(const std::string &name) {
+    ReadLockGuard lg(rwLock_);
+    return index_.find(name) != index_.end();
+}
+
+uint64_t DiskCacheSegment::GetCachedNum() {
+    ReadLockGuard lg(rwLock_);
+    return index_.size();
+}
+
+int DiskCacheSegment::WriteDiskFile(const std::string &name, const char *buf,
+                                    uint64_t length, bool force) {
+    uint64_t recordLen = sizeof(RecordHeader) + name.size() + length;
+    if (name.empty() || name.size() > kMaxNameLen ||
+        recordLen > segmentSize_) {
+        LOG(ERROR) << "obj can not be put into segment, name = " << name
+                   << ", length = " << length;
+        return -1;
+    }
+    uint32_t dataCrc = curve::common::CRC32(buf, length);
+
+    std::lock_guard<std::mutex> lk(appendMtx_);
+    if (IsCached(name)) {
+        return length;
+    }
+    if (active_ == nullptr || active_->offset + recordLen > segmentSize_) {
+        if (active_ != nullptr) {
+            SealSegment(active_);
+        }
+        active_ = AllocateSegment();
+        if (active_ == nullptr) {
+            LOG(ERROR) << "no segment can be used, name = " << name;
+            return -1;
+        }
+    }
+
+    RecordHeader header;
+    header.magic = kRecordMagic;
+    header.seq = active_->seq;
+    header.nameLen = name.size();
+    header.dataLen = length;
+    header.dataCrc = dataCrc;
+    header.reserved = 0;
+    header.crc = RecordCrc(header, name.data());
+    std::string head(reinterpret_cast<const char *>(&header), sizeof(header));
+    head.append(name);
+
+    // the record is not in index until all of it is written, a failed
+    // record is overwritten by the next one
+    uint64_t offset = active_->offset;
+    if (posixWrapper_->pwrite(active_->fd, head.data(), head.size(),
+                              offset) != static_cast<ssize_t>(head.size()) ||
+        posixWrapper_->pwrite(active_->fd, buf, length,
+                              offset + head.size()) !=
+            static_cast<ssize_t>(length)) {
+        LOG(ERROR) << "write segment error, errno = " << errno
+                   << ", segment = " << active_->id << ", name = " << name;
+        return -1;
+    }
+    if (force && posixWrapper_->fdatasync(active_->fd) < 0) {
+        LOG(ERROR) << "sync segment error, errno = " << errno
+                   << ", segment = " << active_->id << ", name = " << name;
+        return -1;
+    }
+
+    WriteLockGuard lg(rwLock_);
+    AddEntryLocked(active_, Entry{name, offset,
+                                  static_cast<uint32_t>(length)});
+    active_->offset += recordLen;
+    return length;
+}
+
+int DiskCacheSegment::ReadDiskFile(const std::string &name, char *buf,
+                                   uint64_t offset, uint64_t length) {
+    // hold the read lock, so that the segment is not evicted during reading
+    ReadLockGuard lg(rwLock_);
+    auto iter = index_.find(name);
+    if (iter == index_.end()) {
+        VLOG(6) << "obj is not in segment cache, name = " << name;
+        return -1;
+    }
+    const Location &location = iter->second;
+    if (offset + length > location.length) {
+        LOG(ERROR) << "read segment cache out of range, name = " << name
+                   << ", offset = " << offset << ", length = " << length
+                   << ", obj length = " << location.length;
+        return -1;
+    }
+    Segment *segment = segments_[location.segment].get();
+    segment->lastAccess.store(clock_.fetch_add(1) + 1,
+                              std::memory_order_relaxed);
+    ssize_t ret = posixWrapper_->pread(segment->fd, buf, length,
+                                       location.offset + offset);
+    if (ret < 0) {
+        LOG(ERROR) << "read segment error, errno = " << errno
+                   << ", segment = " << segment->id << ", name = " << name;
+    }
+    return ret;
+}
+
+int DiskCacheSegment::ClearReadCache(const std::list<std::string> &files) {
+    // the index of sealed segments is rewritten, keep them from being
+    // evicted and reused meanwhile
+    std::lock_guard<std::mutex> lk(appendMtx_);
+    std::set<Segment *> sealed;
+    {
+        WriteLockGuard lg(rwLock_);
+        for (const auto &file : files) {
+            auto iter = index_.find(file);
+            if (iter == index_.end()) {
+                continue;
+            }
+            // drop it from the segment too, so that it is not loaded from
+            // the index again
+            Segment *segment = segments_[iter->second.segment].get();
+            auto &entries = segment->entries;
+            entries.erase(std::remove_if(entries.begin(), entries.end(),
+                                         [&file](const Entry &entry) {
+                                             return entry.name == file;
+                                         }),
+                          entries.end());
+            if (segment->sealed) {
+                sealed.insert(segment);
+            }
+            usedBytes_.fetch_sub(iter->second.length);
+            index_.erase(iter);
+        }
+    }
+    int ret = 0;
+    for (Segment *segment : sealed) {
+        if (WriteIndex(segment) < 0) {
+            ret = -1;
+        }
+    }
+    return ret;
+}
+
+}  // namespace client
+}  // namespace curvefs
@@ -0,0 +1,176 @@
+/*
+ *  Copyright (c) 2023 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#ifndef CURVEFS_SRC_CLIENT_S3_DISK_CACHE_SEGMENT_H_
+#define CURVEFS_SRC_CLIENT_S3_DISK_CACHE_SEGMENT_H_
+
+#include <atomic>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "src/common/concurrent/rw_lock.h"
+#include "curvefs/src/common/wrap_posix.h"
+
+namespace curvefs {
+namespace client {
+
+using curve::common::RWLock;
+using curvefs::common::PosixWrapper;
+
+/**
+ * Log structured read cache on local disk.
+ *
+ * Objects are appended into a fixed number of pre-allocated segment files
+ * instead of being kept as one file per object:
+ *
+ *   <dir>/segment_<id>        records of RecordHeader | name | data
+ *   <dir>/segment_<id>.index  index of a sealed segment
+ *
+ * A segment is sealed when it is full, its data is synced and then its
+ * index is written to a temporary file and renamed, so an index on disk
+ * always describes durable data. At startup indexes are mmap-loaded and
+ * checked by crc, a segment without a valid index (the one being appended
+ * on crash) is recovered by scanning its records.
+ *
+ * When all segments are used, the least recently read sealed segment is
+ * evicted as a whole and reused, no per-object file is ever removed.
+ * A segment holding a pinned obj (e.g. not uploaded yet, so it can only be
+ * read from cache) is never evicted.
+ */
+class DiskCacheSegment {
+ public:
+    // return true if the obj can not be evicted now
+    using PinnedFunc = std::function<bool(const std::string &name)>;
+
+    explicit DiskCacheSegment(std::shared_ptr<PosixWrapper> posixWrapper);
+    virtual ~DiskCacheSegment();
+
+    /**
+     * @brief load segments under dir
+     * @param[in] dir segment dir, created if not exist
+     * @param[in] segmentSize size of one segment file
+     * @param[in] capacity the max bytes all segments can use
+     * @return success: 0, fail : < 0
+     */
+    int Init(const std::string &dir, uint64_t segmentSize, uint64_t capacity);
+
+    void SetPinnedFunc(PinnedFunc pinned) { pinned_ = std::move(pinned); }
+
+    /**
+     * @brief seal the segment being appended and close all segments
+     */
+    void Close();
+
+    bool IsCached(const std::string &name);
+
+    /**
+     * @brief append obj into the current segment
+     * @param[in] force if true, sync data before the obj is visible
+     * @return success: write length, fail : < 0
+     */
+    int WriteDiskFile(const std::string &name, const char *buf,
+                      uint64_t length, bool force);
+
+    /**
+     * @return success: read length, fail : < 0
+     */
+    int ReadDiskFile(const std::string &name, char *buf, uint64_t offset,
+                     uint64_t length);
+
+    // drop objs from the index, their space is reused with the segment
+    int ClearReadCache(const std::list<std::string> &files);
+
+    // bytes of objs in all segments
+    uint64_t GetUsedBytes() const {
+        return usedBytes_.load(std::memory_order_relaxed);
+    }
+
+    uint64_t GetCachedNum();
+
+    uint32_t GetSegmentNum() const { return segmentNum_; }
+
+ private:
+    struct Entry {
+        std::string name;
+        // offset of the record in segment
+        uint64_t offset;
+        uint32_t length;
+    };
+
+    struct Segment {
+        uint32_t id = 0;
+        int fd = -1;
+        // generation of the segment, bumped every time it is reused
+        uint64_t seq = 0;
+        // append position
+        uint64_t offset = 0;
+        bool sealed = false;
+        std::atomic<uint64_t> lastAccess{0};
+        std::vector<Entry> entries;
+    };
+
+    struct Location {
+        uint32_t segment;
+        // offset of the data in segment
+        uint64_t offset;
+        uint32_t length;
+    };
+
+    std::string SegmentPath(uint32_t id) const;
+    std::string IndexPath(uint32_t id) const;
+
+    int OpenSegment(Segment *segment, bool create);
+    bool LoadIndex(Segment *segment);
+    void RecoverSegment(Segment *segment);
+    int SealSegment(Segment *segment);
+    int WriteIndex(Segment *segment);
+    // get an empty segment for appending, evict one if there is none
+    Segment *AllocateSegment();
+    bool IsPinned(Segment *segment);
+    bool EvictSegment(Segment *segment);
+    // must hold the write lock
+    void AddEntryLocked(Segment *segment, const Entry &entry);
+
+ private:
+    std::shared_ptr<PosixWrapper> posixWrapper_;
+    std::string dir_;
+    uint64_t segmentSize_;
+    uint32_t segmentNum_;
+    PinnedFunc pinned_;
+
+    // serialize appending, sealing, evicting and rewriting index
+    std::mutex appendMtx_;
+    Segment *active_;
+    uint64_t nextSeq_;
+
+    // protect index_ and entries of segments
+    RWLock rwLock_;
+    std::unordered_map<std::string, Location> index_;
+    std::vector<std::unique_ptr<Segment>> segments_;
+
+    std::atomic<uint64_t> clock_;
+    std::atomic<uint64_t> usedBytes_;
+};
+
+}  // namespace client
+}  // namespace curvefs
+
+#endif  // CURVEFS_SRC_CLIENT_S3_DISK_CACHE_SEGMENT_H_
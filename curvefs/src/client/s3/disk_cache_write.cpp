@@ -437,6 +437,9 @@ int DiskCacheWrite::RemoveFile(const std::string fileName) {
     std::string fileFullPath;
     fileFullPath = GetCacheIoFullDir();
     std::string fullFileName = fileFullPath + "/" + fileName;
+    struct stat statFile;
+    bool statOk = removeCallback_ &&
+                  posixWrapper_->stat(fullFileName.c_str(), &statFile) == 0;
     int ret = posixWrapper_->remove(fullFileName.c_str());
     if (ret < 0) {
         LOG(ERROR) << "remove disk file error, file = " << fileName
@@ -444,6 +447,9 @@ int DiskCacheWrite::RemoveFile(const std::string fileName) {
         return -1;
     }
     cachedObjName_->MoveBack(fileName);
+    if (statOk) {
+        removeCallback_(statFile.st_size);
+    }
     VLOG(9) << "remove file success, file = " << fileName;
     return 0;
 }
@@ -26,6 +26,7 @@
 #include <bthread/condition_variable.h>
 #include <bthread/mutex.h>
 
+#include <functional>
 #include <memory>
 #include <string>
 #include <list>
@@ -102,6 +103,13 @@ class DiskCacheWrite : public DiskCacheBase {
     * @brief remove from write cache
     */
     virtual int RemoveFile(const std::string fileName);
+    /**
+     * @brief set the callback called with the file length after a file
+     *        is removed from write cache
+     */
+    void SetRemoveCallback(std::function<void(uint64_t length)> cb) {
+        removeCallback_ = std::move(cb);
+    }
     virtual int ReadFile(const std::string name, char** buf,
       uint64_t* size);
     /**
@@ -162,6 +170,7 @@ class DiskCacheWrite : public DiskCacheBase {
     std::shared_ptr<DiskCacheMetric> metric_;
 
     std::shared_ptr<SglLRUCache<std::string>> cachedObjName_;
+    std::function<void(uint64_t length)> removeCallback_;
 };
 
 }  // namespace client
@@ -36,6 +36,7 @@
 #include "curvefs/src/client/inode_wrapper.h"
 #include "curvefs/src/client/kvclient/kvclient_manager.h"
 #include "curvefs/src/client/s3/client_s3_cache_manager.h"
+#include "curvefs/src/common/s3_object_codec.h"
 #include "curvefs/src/common/s3util.h"
 #include "src/common/concurrent/concurrent.h"
 #include "src/common/string_util.h"
@@ -372,6 +373,13 @@ void WarmupManagerS3Impl::TravelChunk(fuse_ino_t ino,
         compaction = chunkinfo.compaction();
         offset = chunkinfo.offset();
         len = chunkinfo.len();
+        // compressed objects are read to their end, as they are stored
+        auto objLen = [&chunkinfo, blockSize](uint64_t rawLen) {
+            return chunkinfo.compressed()
+                       ? curvefs::common::S3ObjectCodec::MaxObjectSize(
+                             blockSize, rawLen)
+                       : rawLen;
+        };
         // the offset in the chunk
         uint64_t chunkPos = offset % chunkSize;
         // the first blockIndex
@@ -380,7 +388,7 @@ void WarmupManagerS3Impl::TravelChunk(fuse_ino_t ino,
         if (len < blockSize) {  // just one block
             auto objectName = curvefs::common::s3util::GenObjName(
                 chunkid, blockIndexBegin, compaction, fsId, ino, objectPrefix);
-            prefetchObjs->push_back(std::make_pair(objectName, len));
+            prefetchObjs->push_back(std::make_pair(objectName, objLen(len)));
         } else {
             // the offset in the block
             uint64_t blockPos = chunkPos % blockSize;
@@ -414,7 +422,7 @@ void WarmupManagerS3Impl::TravelChunk(fuse_ino_t ino,
                     chunkid, blockIndexBegin, compaction,
                     fsId, ino, objectPrefix);
                 prefetchObjs->push_back(
-                    std::make_pair(objectName, firstBlockSize));
+                    std::make_pair(objectName, objLen(firstBlockSize)));
             } else {
                 travelStartIndex = blockIndexBegin;
             }
@@ -429,7 +437,7 @@ void WarmupManagerS3Impl::TravelChunk(fuse_ino_t ino,
                 // there is no need to care about the order
                 // in which objects are downloaded
                 prefetchObjs->push_back(
-                    std::make_pair(objectName, lastBlockSize));
+                    std::make_pair(objectName, objLen(lastBlockSize)));
             } else {
                 travelEndIndex = blockIndexEnd;
             }
@@ -447,7 +455,8 @@ void WarmupManagerS3Impl::TravelChunk(fuse_ino_t ino,
                  blockIndex <= travelEndIndex; blockIndex++) {
                 auto objectName = curvefs::common::s3util::GenObjName(
                     chunkid, blockIndex, compaction, fsId, ino, objectPrefix);
-                prefetchObjs->push_back(std::make_pair(objectName, blockSize));
+                prefetchObjs->push_back(
+                    std::make_pair(objectName, objLen(blockSize)));
             }
         }
     }
@@ -691,7 +700,7 @@ void WarmupManagerS3Impl::PutObjectToCache(
     switch (iter->second.GetStorageType()) {
     case curvefs::client::common::WarmupStorageType::kWarmupStorageTypeDisk:
         ret = s3Adaptor_->GetDiskCacheManager()->WriteReadDirect(
-            context->key, context->buf, context->len);
+            context->key, context->buf, context->actualLen);
         if (ret < 0) {
             LOG_EVERY_SECOND(INFO)
                 << "write read directly failed, key: " << context->key;
@@ -701,7 +710,7 @@ void WarmupManagerS3Impl::PutObjectToCache(
     case curvefs::client::common::WarmupStorageType::kWarmupStorageTypeKvClient:
         if (kvClientManager_ != nullptr) {
             kvClientManager_->Set(std::make_shared<SetKVCacheTask>(
-                context->key, context->buf, context->len,
+                context->key, context->buf, context->actualLen,
                 [context](const std::shared_ptr<SetKVCacheTask> &) {
                     delete[] context->buf;
                 }));
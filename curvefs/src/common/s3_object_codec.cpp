@@ -0,0 +1,258 @@
+/*
+ *  Copyright (c) 2023 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include "curvefs/src/common/s3_object_codec.h"
+
+#include <glog/logging.h>
+#include <lz4.h>
+#include <zstd.h>
+
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+namespace curvefs {
+namespace common {
+
+namespace {
+
+// fast level, frames are small and decoded on the read path
+const int kZstdLevel = 1;
+
+void PutFixed32(char *dst, uint32_t value) {
+    for (int i = 0; i < 4; i++) {
+        dst[i] = static_cast<char>((value >> (8 * i)) & 0xff);
+    }
+}
+
+uint32_t GetFixed32(const char *src) {
+    const unsigned char *p = reinterpret_cast<const unsigned char *>(src);
+    return static_cast<uint32_t>(p[0]) | static_cast<uint32_t>(p[1]) << 8 |
+           static_cast<uint32_t>(p[2]) << 16 |
+           static_cast<uint32_t>(p[3]) << 24;
+}
+
+uint32_t FrameNum(uint64_t len) {
+    return (len + S3ObjectCodec::kFrameSize - 1) / S3ObjectCodec::kFrameSize;
+}
+
+}  // namespace
+
+const uint32_t S3ObjectCodec::kFrameSize;
+const uint32_t S3ObjectCodec::kMagic;
+const uint8_t S3ObjectCodec::kVersion;
+const uint32_t S3ObjectCodec::kFixedHeaderSize;
+const uint32_t S3ObjectCodec::kRawFrameFlag;
+
+uint64_t S3ObjectCodec::HeaderSize(uint64_t blockSize) {
+    return kFixedHeaderSize + 4 * static_cast<uint64_t>(FrameNum(blockSize));
+}
+
+uint64_t S3ObjectCodec::MaxObjectSize(uint64_t blockSize, uint64_t rawLen) {
+    // frames which do not shrink are stored as they are
+    return HeaderSize(blockSize) + rawLen;
+}
+
+bool S3ObjectCodec::Encode(ObjectCodecType codec, uint64_t blockSize,
+                           const char *data, uint64_t len, std::string *out) {
+    if (codec != CODEC_LZ4 && codec != CODEC_ZSTD) {
+        LOG(ERROR) << "unknown object codec: " << codec;
+        return false;
+    }
+    if (len > blockSize) {
+        LOG(ERROR) << "object len " << len << " exceeds block size "
+                   << blockSize;
+        return false;
+    }
+
+    const uint64_t headerSize = HeaderSize(blockSize);
+    const uint32_t frameNum = FrameNum(len);
+    const size_t bound = codec == CODEC_LZ4 ? LZ4_compressBound(kFrameSize)
+                                            : ZSTD_compressBound(kFrameSize);
+    std::vector<uint32_t> frameLens(frameNum);
+    out->reserve(headerSize + frameNum * bound);
+    out->assign(headerSize, '\0');
+    for (uint32_t i = 0; i < frameNum; i++) {
+        const char *src = data + static_cast<uint64_t>(i) * kFrameSize;
+        const uint32_t srcLen = std::min<uint64_t>(
+            kFrameSize, len - static_cast<uint64_t>(i) * kFrameSize);
+        const size_t pos = out->size();
+        out->resize(pos + bound);
+        size_t n = 0;
+        if (codec == CODEC_LZ4) {
+            int ret = LZ4_compress_default(src, &(*out)[pos], srcLen, bound);
+            n = ret > 0 ? ret : 0;
+        } else {
+            size_t ret =
+                ZSTD_compress(&(*out)[pos], bound, src, srcLen, kZstdLevel);
+            n = ZSTD_isError(ret) ? 0 : ret;
+        }
+        if (n == 0 || n >= srcLen) {
+            memcpy(&(*out)[pos], src, srcLen);
+            out->resize(pos + srcLen);
+            frameLens[i] = srcLen | kRawFrameFlag;
+        } else {
+            out->resize(pos + n);
+            frameLens[i] = n;
+        }
+    }
+
+    char *header = &(*out)[0];
+    PutFixed32(header, kMagic);
+    header[4] = static_cast<char>(kVersion);
+    header[5] = static_cast<char>(codec);
+    PutFixed32(header + 8, len);
+    PutFixed32(header + 12, frameNum);
+    for (uint32_t i = 0; i < frameNum; i++) {
+        PutFixed32(header + kFixedHeaderSize + 4 * i, frameLens[i]);
+    }
+    return true;
+}
+
+bool S3ObjectCodec::Decode(uint64_t blockSize, const std::string &object,
+                           std::string *out) {
+    const std::string header = object.substr(0, HeaderSize(blockSize));
+    Header h;
+    if (!ParseHeader(blockSize, header, &h)) {
+        LOG(ERROR) << "bad object header, object size: " << object.size();
+        return false;
+    }
+    auto reader = [&object](uint64_t offset, uint64_t len, char *buf) {
+        if (offset + len > object.size()) {
+            return -1;
+        }
+        memcpy(buf, object.data() + offset, len);
+        return 0;
+    };
+    out->resize(h.rawLen);
+    return DecodeRange(blockSize, header, reader, 0, h.rawLen, &(*out)[0]) ==
+           0;
+}
+
+int S3ObjectCodec::DecodeRange(uint64_t blockSize, const std::string &header,
+                               const RangeReader &reader, uint64_t offset,
+                               uint64_t len, char *buf) {
+    Header h;
+    if (!ParseHeader(blockSize, header, &h)) {
+        LOG(ERROR) << "bad object header";
+        return -1;
+    }
+    if (offset + len > h.rawLen) {
+        LOG(ERROR) << "read [" << offset << ", " << offset + len
+                   << ") out of object len " << h.rawLen;
+        return -1;
+    }
+    if (len == 0) {
+        return 0;
+    }
+
+    // read the frames covering the range at once
+    const uint32_t first = offset / kFrameSize;
+    const uint32_t last = (offset + len - 1) / kFrameSize;
+    uint64_t storedOffset = HeaderSize(blockSize);
+    uint64_t storedLen = 0;
+    for (uint32_t i = 0; i < first; i++) {
+        storedOffset += FrameLen(h, i);
+    }
+    for (uint32_t i = first; i <= last; i++) {
+        storedLen += FrameLen(h, i);
+    }
+    std::unique_ptr<char[]> stored(new char[storedLen]);
+    int ret = reader(storedOffset, storedLen, stored.get());
+    if (ret < 0) {
+        return ret;
+    }
+
+    std::unique_ptr<char[]> frameBuf;
+    const char *frame = stored.get();
+    for (uint32_t i = first; i <= last; i++) {
+        const uint64_t frameBegin = static_cast<uint64_t>(i) * kFrameSize;
+        const uint32_t rawFrameLen =
+            std::min<uint64_t>(kFrameSize, h.rawLen - frameBegin);
+        const uint64_t begin = std::max(offset, frameBegin);
+        const uint64_t end = std::min(offset + len, frameBegin + rawFrameLen);
+        const uint32_t frameLen = FrameLen(h, i);
+        char *dst = buf + (begin - offset);
+        if (GetFixed32(h.frameLens + 4 * i) & kRawFrameFlag) {
+            if (frameLen != rawFrameLen) {
+                LOG(ERROR) << "bad raw frame " << i << ", len: " << frameLen;
+                return -1;
+            }
+            memcpy(dst, frame + (begin - frameBegin), end - begin);
+        } else if (end - begin == rawFrameLen) {
+            // the whole frame is wanted, decode into place
+            if (!DecodeFrame(h.codec, frame, frameLen, dst, rawFrameLen)) {
+                return -1;
+            }
+        } else {
+            if (frameBuf == nullptr) {
+                frameBuf.reset(new char[kFrameSize]);
+            }
+            if (!DecodeFrame(h.codec, frame, frameLen, frameBuf.get(),
+                             rawFrameLen)) {
+                return -1;
+            }
+            memcpy(dst, frameBuf.get() + (begin - frameBegin), end - begin);
+        }
+        frame += frameLen;
+    }
+    return 0;
+}
+
+bool S3ObjectCodec::ParseHeader(uint64_t blockSize, const std::string &header,
+                                Header *out) {
+    if (header.size() < HeaderSize(blockSize)) {
+        return false;
+    }
+    const char *p = header.data();
+    if (GetFixed32(p) != kMagic ||
+        static_cast<uint8_t>(p[4]) != kVersion) {
+        return false;
+    }
+    const int codec = static_cast<uint8_t>(p[5]);
+    if (codec != CODEC_LZ4 && codec != CODEC_ZSTD) {
+        return false;
+    }
+    out->codec = static_cast<ObjectCodecType>(codec);
+    out->rawLen = GetFixed32(p + 8);
+    out->frameNum = GetFixed32(p + 12);
+    out->frameLens = p + kFixedHeaderSize;
+    return out->rawLen <= blockSize && out->frameNum == FrameNum(out->rawLen);
+}
+
+uint32_t S3ObjectCodec::FrameLen(const Header &header, uint32_t index) {
+    return GetFixed32(header.frameLens + 4 * index) & ~kRawFrameFlag;
+}
+
+bool S3ObjectCodec::DecodeFrame(ObjectCodecType codec, const char *frame,
+                                uint32_t frameLen, char *out,
+                                uint32_t rawLen) {
+    bool ok;
+    if (codec == CODEC_LZ4) {
+        int ret = LZ4_decompress_safe(frame, out, frameLen, rawLen);
+        ok = ret == static_cast<int>(rawLen);
+    } else {
+        size_t ret = ZSTD_decompress(out, rawLen, frame, frameLen);
+        ok = !ZSTD_isError(ret) && ret == rawLen;
+    }
+    LOG_IF(ERROR, !ok) << "decode frame fail, codec: " << codec
+                       << ", frame len: " << frameLen;
+    return ok;
+}
+
+}  // namespace common
+}  // namespace curvefs
@@ -0,0 +1,97 @@
+/*
+ *  Copyright (c) 2023 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#ifndef CURVEFS_SRC_COMMON_S3_OBJECT_CODEC_H_
+#define CURVEFS_SRC_COMMON_S3_OBJECT_CODEC_H_
+
+#include <cstdint>
+#include <functional>
+#include <string>
+
+#include "curvefs/proto/common.pb.h"
+
+namespace curvefs {
+namespace common {
+
+/**
+ * Encode and decode the s3 objects of a fs with a codec.
+ *
+ * Data of an object is cut into frames of kFrameSize, every frame is
+ * compressed alone, so a range of the data is decoded from the frames it
+ * covers, without reading the whole object. An encoded object is:
+ *
+ *   | header | frame 0 | frame 1 | ... |
+ *
+ * header: magic(4) | version(1) | codec(1) | reserved(2) | rawLen(4) |
+ *         frameNum(4) | stored length of every frame(4 * maxFrameNum)
+ *
+ * maxFrameNum is decided by the block size of the fs, so the header is of
+ * fixed size for a fs, and can be read without knowing the object. Integers
+ * are little endian. A frame which does not shrink is stored as it is,
+ * kRawFrameFlag is set in its length.
+ */
+class S3ObjectCodec {
+ public:
+    // read |len| bytes at |offset| of the stored object into |buf|,
+    // return a negative number on error
+    using RangeReader =
+        std::function<int(uint64_t offset, uint64_t len, char *buf)>;
+
+    static const uint32_t kFrameSize = 64 * 1024;
+
+    static uint64_t HeaderSize(uint64_t blockSize);
+
+    // the stored object is no larger than this
+    static uint64_t MaxObjectSize(uint64_t blockSize, uint64_t rawLen);
+
+    static bool Encode(ObjectCodecType codec, uint64_t blockSize,
+                       const char *data, uint64_t len, std::string *out);
+
+    // decode the whole object
+    static bool Decode(uint64_t blockSize, const std::string &object,
+                       std::string *out);
+
+    // decode |len| bytes at |offset| of the data into |buf|, |header| is
+    // the first HeaderSize() bytes of the object, frames are read by
+    // |reader|, return the error of |reader|, or -1 if the object is bad
+    static int DecodeRange(uint64_t blockSize, const std::string &header,
+                           const RangeReader &reader, uint64_t offset,
+                           uint64_t len, char *buf);
+
+ private:
+    static const uint32_t kMagic = 0x31534643;  // "CFS1"
+    static const uint8_t kVersion = 1;
+    static const uint32_t kFixedHeaderSize = 16;
+    static const uint32_t kRawFrameFlag = 1u << 31;
+
+    struct Header {
+        ObjectCodecType codec;
+        uint32_t rawLen;
+        uint32_t frameNum;
+        const char *frameLens;
+    };
+
+    static bool ParseHeader(uint64_t blockSize, const std::string &header,
+                            Header *out);
+    static uint32_t FrameLen(const Header &header, uint32_t index);
+    static bool DecodeFrame(ObjectCodecType codec, const char *frame,
+                            uint32_t frameLen, char *out, uint32_t rawLen);
+};
+
+}  // namespace common
+}  // namespace curvefs
+
+#endif  // CURVEFS_SRC_COMMON_S3_OBJECT_CODEC_H_
@@ -57,6 +57,9 @@ FsInfoWrapper::FsInfoWrapper(const ::curvefs::mds::CreateFsRequest* request,
     } else {
         fsInfo.set_recycletimehour(1);
     }
+    if (request->has_enablefollowerread()) {
+        fsInfo.set_enablefollowerread(request->enablefollowerread());
+    }
 
     const auto& detail = request->fsdetail();
     fsInfo.set_allocated_detail(new FsDetail(detail));
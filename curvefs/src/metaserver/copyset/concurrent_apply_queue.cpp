@@ -67,6 +67,7 @@ bool ApplyQueue::CheckOptAndInit(const ApplyOption &opt) {
     wqueuedepth_ = opt.wqueuedepth;
     rconcurrentsize_ = opt.rconcurrentsize;
     rqueuedepth_ = opt.rqueuedepth;
+    lockfreequeue_ = opt.lockfreequeue;
 
     return true;
 }
@@ -74,7 +75,7 @@ bool ApplyQueue::CheckOptAndInit(const ApplyOption &opt) {
 void ApplyQueue::InitThreadPool(
     ThreadPoolType type, int concurrent, int depth) {
     for (int i = 0; i < concurrent; i++) {
-        auto asyncth = new (std::nothrow) TaskThread(depth);
+        auto asyncth = new (std::nothrow) TaskThread(depth, lockfreequeue_);
         CHECK(asyncth != nullptr) << "allocate failed!";
 
         switch (type) {
@@ -108,11 +109,11 @@ void ApplyQueue::Run(ThreadPoolType type, int index) {
     while (start_) {
         switch (type) {
         case ThreadPoolType::READ:
-            rapplyMap_[index]->tq.Pop()();
+            rapplyMap_[index]->RunOne();
             break;
 
         case ThreadPoolType::WRITE:
-            wapplyMap_[index]->tq.Pop()();
+            wapplyMap_[index]->RunOne();
             break;
         }
     }
@@ -126,14 +127,14 @@ void ApplyQueue::Stop() {
     LOG(INFO) << "stop ApplyQueue...";
     auto wakeup = []() {};
     for (auto iter : rapplyMap_) {
-        iter.second->tq.Push(wakeup);
+        iter.second->Push(wakeup);
         iter.second->th.join();
         delete iter.second;
     }
     rapplyMap_.clear();
 
     for (auto iter : wapplyMap_) {
-        iter.second->tq.Push(wakeup);
+        iter.second->Push(wakeup);
         iter.second->th.join();
         delete iter.second;
     }
@@ -153,7 +154,7 @@ void ApplyQueue::Flush() {
     };
 
     for (int i = 0; i < wconcurrentsize_; i++) {
-        wapplyMap_[i]->tq.Push(flushtask);
+        wapplyMap_[i]->Push(flushtask);
     }
 
     event.Wait();
@@ -170,11 +171,11 @@ void ApplyQueue::FlushAll() {
     };
 
     for (int i = 0; i < wconcurrentsize_; i++) {
-        wapplyMap_[i]->tq.Push(flushtask);
+        wapplyMap_[i]->Push(flushtask);
     }
 
     for (int i = 0; i < rconcurrentsize_; i++) {
-        rapplyMap_[i]->tq.Push(flushtask);
+        rapplyMap_[i]->Push(flushtask);
     }
 
     event.Wait();
@@ -184,6 +185,7 @@ ThreadPoolType ApplyQueue::Schedule(OperatorType optype) {
     switch (optype) {
     case OperatorType::GetDentry:
     case OperatorType::ListDentry:
+    case OperatorType::ListDentryPlus:
     case OperatorType::GetInode:
     case OperatorType::BatchGetInodeAttr:
     case OperatorType::BatchGetXAttr:
@@ -28,12 +28,14 @@
 #include <glog/logging.h>
 
 #include <atomic>
+#include <memory>
 #include <thread>
 #include <unordered_map>
 #include <utility>
 
 #include "include/curve_compiler_specific.h"
 #include "src/common/concurrent/count_down_event.h"
+#include "src/common/concurrent/mpsc_task_queue.h"
 #include "src/common/concurrent/task_queue.h"
 #include "curvefs/src/metaserver/copyset/operator_type.h"
 
@@ -42,6 +44,7 @@ namespace metaserver {
 namespace copyset {
 
 using curve::common::CountDownEvent;
+using curve::common::GenericTaskThread;
 using curve::common::GenericTaskQueue;
 
 struct ApplyOption {
@@ -49,11 +52,15 @@ struct ApplyOption {
     int wqueuedepth = 1;
     int rconcurrentsize = 1;
     int rqueuedepth = 1;
-    ApplyOption(int wsize, int wdepth, int rsize, int rdepth) :
+    // use lock-free mpsc queue instead of mutex based task queue
+    bool lockfreequeue = false;
+    ApplyOption(int wsize, int wdepth, int rsize, int rdepth,
+                bool lockfree = false) :
         wconcurrentsize(wsize),
         wqueuedepth(wdepth),
         rconcurrentsize(rsize),
-        rqueuedepth(rdepth) {}
+        rqueuedepth(rdepth),
+        lockfreequeue(lockfree) {}
     ApplyOption() {}
 };
 
@@ -74,6 +81,7 @@ class CURVE_CACHELINE_ALIGNMENT ApplyQueue {
                   rqueuedepth_(0),
                   wconcurrentsize_(0),
                   wqueuedepth_(0),
+                  lockfreequeue_(false),
                   cond_(0) {}
 
     /**
@@ -94,13 +102,27 @@ class CURVE_CACHELINE_ALIGNMENT ApplyQueue {
      */
     template <class F, class... Args>
     bool Push(uint64_t key, OperatorType optype, F&& f, Args&&... args) {
-        switch (Schedule(optype)) {
+        return Push(key, Schedule(optype), std::forward<F>(f),
+                    std::forward<Args>(args)...);
+    }
+
+    /**
+     * Push: push task to the specified thread pool, tasks with the same key
+     *       in the same pool are executed in the order they are pushed
+     * @param[in] key: used to hash task to specified queue
+     * @param[in] type: thread pool which the task is pushed to
+     * @param[in] f: task
+     * @param[in] args: param to excute task
+     */
+    template <class F, class... Args>
+    bool Push(uint64_t key, ThreadPoolType type, F&& f, Args&&... args) {
+        switch (type) {
             case ThreadPoolType::READ:
-                rapplyMap_[Hash(key, rconcurrentsize_)]->tq.Push(
+                rapplyMap_[Hash(key, rconcurrentsize_)]->Push(
                         std::forward<F>(f), std::forward<Args>(args)...);
                 break;
             case ThreadPoolType::WRITE:
-                wapplyMap_[Hash(key, wconcurrentsize_)]->tq.Push(
+                wapplyMap_[Hash(key, wconcurrentsize_)]->Push(
                         std::forward<F>(f), std::forward<Args>(args)...);
                 break;
         }
@@ -130,17 +152,15 @@ class CURVE_CACHELINE_ALIGNMENT ApplyQueue {
     }
 
  private:
-    struct TaskThread {
-        std::thread th;
-        GenericTaskQueue<bthread::Mutex, bthread::ConditionVariable> tq;
-        explicit TaskThread(size_t capacity) : tq(capacity) {}
-    };
+    using TaskThread =
+        GenericTaskThread<bthread::Mutex, bthread::ConditionVariable>;
 
     std::atomic<bool> start_;
     int rconcurrentsize_;
     int rqueuedepth_;
     int wconcurrentsize_;
     int wqueuedepth_;
+    bool lockfreequeue_;
     CountDownEvent cond_;
     CURVE_CACHELINE_ALIGNMENT std::unordered_map<int, TaskThread*> wapplyMap_;
     CURVE_CACHELINE_ALIGNMENT std::unordered_map<int, TaskThread*> rapplyMap_;
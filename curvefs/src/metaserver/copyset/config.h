@@ -82,6 +82,15 @@ struct CopysetNodeOptions {
     // apply queue options
     ApplyOption applyQueueOption;
 
+    // the max number of write operators of a partition proposed in one raft
+    // log entry, batching is disabled if it's not larger than 1
+    // Default: 1
+    uint32_t proposeBatchSize;
+
+    // time in microseconds the first operator of a batch waits for others
+    // Default: 100
+    uint32_t proposeBatchWaitUs;
+
     // filesystem adaptor
     curve::fs::LocalFileSystem* localFileSystem;
 
@@ -104,6 +113,8 @@ inline CopysetNodeOptions::CopysetNodeOptions()
       finishLoadMargin(2000),
       checkLoadMarginIntervalMs(1000),
       applyQueueOption(),
+      proposeBatchSize(1),
+      proposeBatchWaitUs(100),
       localFileSystem(nullptr),
       trashOptions(),
       raftNodeOptions() {}
@@ -22,9 +22,11 @@
 
 #include "curvefs/src/metaserver/copyset/copyset_node.h"
 
+#include <braft/local_file_meta.pb.h>
 #include <braft/protobuf_file.h>
 #include <braft/util.h>
 #include <brpc/channel.h>
+#include <butil/time.h>
 #include <glog/logging.h>
 
 #include <functional>
@@ -41,6 +43,7 @@
 #include "curvefs/src/metaserver/copyset/copyset_node_manager.h"
 #include "curvefs/src/metaserver/copyset/meta_operator_closure.h"
 #include "curvefs/src/metaserver/copyset/metric.h"
+#include "curvefs/src/metaserver/copyset/propose_batcher.h"
 #include "curvefs/src/metaserver/copyset/raft_log_codec.h"
 #include "curvefs/src/metaserver/copyset/snapshot_closure.h"
 #include "curvefs/src/metaserver/copyset/utils.h"
@@ -86,13 +89,19 @@ CopysetNode::CopysetNode(PoolId poolId, CopysetId copysetId,
       copysetDataPath_(),
       metaStore_(),
       appliedIndex_(0),
+      dispatchedIndex_(0),
+      dispatchWaiters_(0),
       epochFile_(),
       applyQueue_(nullptr),
+      proposeBatcher_(nullptr),
       latestLoadSnapshotIndex_(0),
       confChangeMtx_(),
       ongoingConfChange_(),
       metric_(absl::make_unique<OperatorMetric>(poolId_, copysetId_)),
-      isLoading_(false) {}
+      isLoading_(false),
+      raftNodeInited_(false),
+      snapshotChecksumsMtx_(),
+      snapshotChecksums_() {}
 
 CopysetNode::~CopysetNode() {
     Stop();
@@ -131,6 +140,11 @@ bool CopysetNode::Init(const CopysetNodeOptions& options) {
         return false;
     }
 
+    if (options_.proposeBatchSize > 1) {
+        proposeBatcher_ = absl::make_unique<ProposeBatcher>(
+            this, options_.proposeBatchSize, options_.proposeBatchWaitUs);
+    }
+
     // init braft lease
     if (options.enbaleLeaseRead) {
         braft::FLAGS_raft_enable_leader_lease = true;
@@ -169,6 +183,8 @@ bool CopysetNode::Start() {
         return false;
     }
 
+    raftNodeInited_.store(true, std::memory_order_release);
+
     LOG(INFO) << "Run copyset success, copyset: " << name_;
     return true;
 }
@@ -310,7 +326,100 @@ void CopysetNode::on_apply(braft::Iterator& iter) {
             timer.stop();
             g_concurrent_apply_from_log_wait_latency << timer.u_elapsed();
         }
+
+        dispatchedIndex_.store(iter.index(), std::memory_order_release);
+    }
+
+    NotifyDispatched();
+}
+
+void CopysetNode::NotifyDispatched() {
+    // pairs with the increment of dispatchWaiters_, so either the waiter
+    // sees the new dispatched index, or it's woken up here
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (dispatchWaiters_.load(std::memory_order_relaxed) > 0) {
+        std::lock_guard<Mutex> lock(dispatchMtx_);
+        dispatchCond_.notify_all();
+    }
+}
+
+bool CopysetNode::WaitDispatchedIndex(uint64_t index) {
+    if (GetDispatchedIndex() >= index) {
+        return true;
+    }
+
+    const int64_t deadline =
+        butil::gettimeofday_us() +
+        options_.raftNodeOptions.election_timeout_ms * 1000L;
+    std::unique_lock<Mutex> lock(dispatchMtx_);
+    dispatchWaiters_.fetch_add(1, std::memory_order_seq_cst);
+    auto waitersGuard = absl::MakeCleanup(
+        [this]() { dispatchWaiters_.fetch_sub(1, std::memory_order_relaxed); });
+    while (GetDispatchedIndex() < index) {
+        int64_t remain = deadline - butil::gettimeofday_us();
+        if (remain <= 0) {
+            return false;
+        }
+        dispatchCond_.wait_for(lock, remain);
+    }
+    return true;
+}
+
+bool CopysetNode::GetReadIndex(uint64_t* readIndex) {
+    braft::NodeStatus status;
+    raftNode_->get_status(&status);
+
+    // the lease is valid only after the leader committed a log of its term,
+    // and no other leader can be elected while it's valid, so every write
+    // replied before is committed at or before current committed index
+    braft::LeaderLeaseStatus leaseStatus;
+    GetLeaderLeaseStatus(&leaseStatus);
+    if (!IsLeaseLeader(leaseStatus)) {
+        return false;
+    }
+
+    *readIndex = status.committed_index;
+    return true;
+}
+
+bool CopysetNode::FetchReadIndex(const braft::PeerId& leaderId,
+                                 uint64_t* readIndex) {
+    brpc::Controller cntl;
+    cntl.set_timeout_ms(options_.raftNodeOptions.election_timeout_ms);
+    brpc::Channel channel;
+
+    int rc = channel.Init(leaderId.addr, nullptr);
+    if (rc != 0) {
+        LOG(WARNING) << "Init channel to leader failed, leader address: "
+                     << leaderId.addr << ", copyset: " << name_;
+        return false;
+    }
+
+    ReadIndexRequest request;
+    ReadIndexResponse response;
+    request.set_poolid(poolId_);
+    request.set_copysetid(copysetId_);
+
+    CopysetService_Stub stub(&channel);
+    stub.GetReadIndex(&cntl, &request, &response, nullptr);
+
+    if (cntl.Failed()) {
+        LOG(WARNING) << "Get read index failed, leader address: "
+                     << leaderId.addr << ", error: " << cntl.ErrorText()
+                     << ", copyset: " << name_;
+        return false;
     }
+
+    if (response.status() != COPYSET_OP_STATUS::COPYSET_OP_STATUS_SUCCESS ||
+        !response.has_readindex()) {
+        LOG(WARNING) << "Get read index failed, leader address: "
+                     << leaderId.addr << ", response: "
+                     << response.ShortDebugString() << ", copyset: " << name_;
+        return false;
+    }
+
+    *readIndex = response.readindex();
+    return true;
 }
 
 void CopysetNode::on_shutdown() {
@@ -331,6 +440,11 @@ class OnSnapshotSaveDoneClosureImpl : public OnSnapshotSaveDoneClosure {
         std::unique_ptr<OnSnapshotSaveDoneClosureImpl> selfGuard(this);
         brpc::ClosureGuard doneGuard(snapDone_);
 
+        if (ctx_->success) {
+            uint64_t totalFiles = 0;
+            node_->UpdateSnapshotChecksums(writer_, &totalFiles);
+        }
+
         RaftSnapshotMetric::GetInstance().OnSnapshotSaveDone(ctx_);
     }
 
@@ -448,10 +562,23 @@ int CopysetNode::on_snapshot_load(braft::SnapshotReader* reader) {
         return -1;
     }
 
+    uint64_t totalFiles = 0;
+    uint64_t reusedFiles = UpdateSnapshotChecksums(reader, &totalFiles);
+    if (raftNodeInited_.load(std::memory_order_acquire)) {
+        RaftSnapshotMetric::GetInstance().OnSnapshotInstalled(
+            reusedFiles, totalFiles - reusedFiles);
+        LOG(INFO) << "Copyset " << name_ << " installed snapshot from leader, "
+                  << reusedFiles << " of " << totalFiles
+                  << " files are reused from the last snapshot";
+    }
+
     braft::SnapshotMeta meta;
     reader->load_meta(&meta);
     auto prevIndex =
         absl::exchange(latestLoadSnapshotIndex_, meta.last_included_index());
+    dispatchedIndex_.store(meta.last_included_index(),
+                           std::memory_order_release);
+    NotifyDispatched();
     LOG(INFO) << "Copyset " << name_ << " load snapshot from '"
               << reader->get_path()
               << "' success, update load snapshot index from " << prevIndex
@@ -460,6 +587,29 @@ int CopysetNode::on_snapshot_load(braft::SnapshotReader* reader) {
     return 0;
 }
 
+uint64_t CopysetNode::UpdateSnapshotChecksums(braft::Snapshot* snapshot,
+                                              uint64_t* totalFiles) {
+    std::vector<std::string> files;
+    snapshot->list_files(&files);
+    *totalFiles = files.size();
+
+    std::unordered_set<std::string> checksums;
+    for (const auto& file : files) {
+        braft::LocalFileMeta meta;
+        if (snapshot->get_file_meta(file, &meta) == 0 && meta.has_checksum()) {
+            checksums.insert(meta.checksum());
+        }
+    }
+
+    std::lock_guard<Mutex> lk(snapshotChecksumsMtx_);
+    uint64_t reused = 0;
+    for (const auto& checksum : checksums) {
+        reused += snapshotChecksums_.count(checksum);
+    }
+    snapshotChecksums_.swap(checksums);
+    return reused;
+}
+
 void CopysetNode::on_leader_start(int64_t term) {
     /*
      * Invoke order in on_leader_start: 
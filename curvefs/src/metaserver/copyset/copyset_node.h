@@ -24,11 +24,13 @@
 #define CURVEFS_SRC_METASERVER_COPYSET_COPYSET_NODE_H_
 
 #include <braft/raft.h>
+#include <bthread/condition_variable.h>
 #include <gtest/gtest_prod.h>
 
 #include <list>
 #include <memory>
 #include <string>
+#include <unordered_set>
 #include <vector>
 #include <map>
 
@@ -53,6 +55,7 @@ using ::curve::mds::heartbeat::ConfigChangeType;
 using ::curvefs::mds::heartbeat::BlockGroupStatInfo;
 
 class CopysetNodeManager;
+class ProposeBatcher;
 
 // Implement our own business raft state machine
 class CopysetNode : public braft::StateMachine {
@@ -111,6 +114,31 @@ class CopysetNode : public braft::StateMachine {
 
     uint64_t GetAppliedIndex() const;
 
+    // Get index of the latest log which has been pushed to apply queue or
+    // included in the loaded snapshot, operators pushed to apply queue after
+    // it will see the results of all logs before it of the same partition
+    virtual uint64_t GetDispatchedIndex() const;
+
+    // Wait until the log of index is dispatched, return false if it isn't
+    // dispatched in an election timeout
+    virtual bool WaitDispatchedIndex(uint64_t index);
+
+    // Get read index as the leader, i.e., the committed index while holding
+    // a valid lease, all writes replied before it are committed before the
+    // index. Return false if current node isn't a lease leader.
+    bool GetReadIndex(uint64_t* readIndex);
+
+    // Fetch read index from the leader, a follower which has dispatched the
+    // log of the read index can serve readonly requests linearizably
+    virtual bool FetchReadIndex(const braft::PeerId& leaderId,
+                                uint64_t* readIndex);
+
+    // Record checksums of files in the latest snapshot of current copyset,
+    // and return the number of files whose checksum exists in the previous
+    // one, i.e., files which needn't be transferred while installing snapshot
+    uint64_t UpdateSnapshotChecksums(braft::Snapshot* snapshot,
+                                     uint64_t* totalFiles);
+
     /**
      * @brief Get current copyset node's leader status
      * @return true if success, otherwise return false
@@ -132,6 +160,9 @@ class CopysetNode : public braft::StateMachine {
 
     ApplyQueue* GetApplyQueue() const;
 
+    // return nullptr if propose batching is disabled
+    ProposeBatcher* GetProposeBatcher() const;
+
     OperatorMetric* GetMetric() const;
 
     const std::string& Name() const;
@@ -210,6 +241,9 @@ class CopysetNode : public braft::StateMachine {
  private:
     void InitRaftNodeOptions();
 
+    // Wake up requests waiting for dispatched index
+    void NotifyDispatched();
+
     bool FetchLeaderStatus(const braft::PeerId& peerId,
                            braft::NodeStatus* leaderStatus);
 
@@ -252,10 +286,20 @@ class CopysetNode : public braft::StateMachine {
     // applied log index
     std::atomic<uint64_t> appliedIndex_;
 
+    // log index dispatched to apply queue, see GetDispatchedIndex
+    std::atomic<uint64_t> dispatchedIndex_;
+
+    // requests waiting for dispatched index, see WaitDispatchedIndex
+    std::atomic<uint32_t> dispatchWaiters_;
+    Mutex dispatchMtx_;
+    bthread::ConditionVariable dispatchCond_;
+
     std::unique_ptr<ConfEpochFile> epochFile_;
 
     std::unique_ptr<ApplyQueue> applyQueue_;
 
+    std::unique_ptr<ProposeBatcher> proposeBatcher_;
+
     mutable Mutex confMtx_;
 
     int64_t latestLoadSnapshotIndex_;
@@ -267,6 +311,15 @@ class CopysetNode : public braft::StateMachine {
     std::unique_ptr<OperatorMetric> metric_;
 
     std::atomic<bool> isLoading_;
+
+    // whether raft node is initialized, snapshot loaded before it is the
+    // local one, and after it is installed from leader
+    std::atomic<bool> raftNodeInited_;
+
+    Mutex snapshotChecksumsMtx_;
+
+    // checksums of files in the latest snapshot
+    std::unordered_set<std::string> snapshotChecksums_;
 };
 
 inline void CopysetNode::Propose(const braft::Task& task) {
@@ -304,6 +357,10 @@ inline uint64_t CopysetNode::GetAppliedIndex() const {
     return appliedIndex_.load(std::memory_order::memory_order_acquire);
 }
 
+inline uint64_t CopysetNode::GetDispatchedIndex() const {
+    return dispatchedIndex_.load(std::memory_order_acquire);
+}
+
 inline void CopysetNode::GetStatus(braft::NodeStatus* status) {
     raftNode_->get_status(status);
 }
@@ -316,6 +373,10 @@ inline ApplyQueue* CopysetNode::GetApplyQueue() const {
     return applyQueue_.get();
 }
 
+inline ProposeBatcher* CopysetNode::GetProposeBatcher() const {
+    return proposeBatcher_.get();
+}
+
 inline OperatorMetric* CopysetNode::GetMetric() const {
     return metric_.get();
 }
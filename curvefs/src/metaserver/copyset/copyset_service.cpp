@@ -77,6 +77,35 @@ void CopysetServiceImpl::GetCopysetsStatus(
     }
 }
 
+void CopysetServiceImpl::GetReadIndex(
+    google::protobuf::RpcController* /*controller*/,
+    const ReadIndexRequest* request, ReadIndexResponse* response,
+    google::protobuf::Closure* done) {
+    brpc::ClosureGuard doneGuard(done);
+
+    auto* node =
+        manager_->GetCopysetNode(request->poolid(), request->copysetid());
+    if (!node) {
+        LOG(WARNING) << "GetReadIndex failed, copyset "
+                     << ToGroupIdString(request->poolid(),
+                                        request->copysetid())
+                     << " not exists";
+        response->set_status(
+            COPYSET_OP_STATUS::COPYSET_OP_STATUS_COPYSET_NOTEXIST);
+        return;
+    }
+
+    uint64_t readIndex = 0;
+    if (!node->GetReadIndex(&readIndex)) {
+        response->set_status(
+            COPYSET_OP_STATUS::COPYSET_OP_STATUS_NOT_LEASE_LEADER);
+        return;
+    }
+
+    response->set_readindex(readIndex);
+    response->set_status(COPYSET_OP_STATUS::COPYSET_OP_STATUS_SUCCESS);
+}
+
 COPYSET_OP_STATUS CopysetServiceImpl::CreateOneCopyset(
     const CreateCopysetRequest::Copyset& copyset) {
     int exists = manager_->IsCopysetNodeExist(copyset);
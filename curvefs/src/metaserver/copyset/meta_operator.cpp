@@ -32,6 +32,7 @@
 #include "curvefs/proto/metaserver.pb.h"
 #include "curvefs/src/common/rpc_stream.h"
 #include "curvefs/src/metaserver/copyset/meta_operator_closure.h"
+#include "curvefs/src/metaserver/copyset/propose_batcher.h"
 #include "curvefs/src/metaserver/copyset/raft_log_codec.h"
 #include "curvefs/src/metaserver/metastore.h"
 #include "curvefs/src/metaserver/streaming_utils.h"
@@ -40,6 +41,8 @@
 static bvar::LatencyRecorder
     g_concurrent_fast_apply_wait_latency("concurrent_fast_apply_wait");
 
+static bvar::Adder<uint64_t> g_follower_read_count("follower_read_count");
+
 
 namespace curvefs {
 namespace metaserver {
@@ -60,6 +63,14 @@ void MetaOperator::Propose() {
 
     // check if current node is leader
     if (!IsLeaderTerm()) {
+        // follower read: readonly operator is served by follower if it has
+        // applied the log that the request depends on
+        if (CanBypassPropose() && CanReadOnFollower()) {
+            FollowerReadTask();
+            doneGuard.release();
+            return;
+        }
+
         RedirectRequest();
         return;
     }
@@ -87,6 +98,14 @@ void MetaOperator::Propose() {
         // reuse `ProposeTask`, propose to raft
     }
 
+    // writes of the same partition may share one raft log entry
+    auto* batcher = node_->GetProposeBatcher();
+    if (batcher != nullptr && CanBatchPropose()) {
+        doneGuard.release();
+        batcher->Propose(this);
+        return;
+    }
+
     // propose to raft
     if (ProposeTask()) {
         doneGuard.release();
@@ -98,11 +117,7 @@ void MetaOperator::RedirectRequest() { Redirect(); }
 bool MetaOperator::ProposeTask() {
     timerPropose.start();
     butil::IOBuf log;
-    bool success = RaftLogCodec::Encode(GetOperatorType(), request_, &log);
-    if (!success) {
-        LOG(ERROR) << "meta request encode failed, type: "
-                   << OperatorTypeName(GetOperatorType())
-                   << ", request: " << request_->ShortDebugString();
+    if (!EncodeTo(&log)) {
         OnFailed(MetaStatusCode::UNKNOWN_ERROR);
         return false;
     }
@@ -117,6 +132,16 @@ bool MetaOperator::ProposeTask() {
     return true;
 }
 
+bool MetaOperator::EncodeTo(butil::IOBuf* log) const {
+    bool success = RaftLogCodec::Encode(GetOperatorType(), request_, log);
+    if (!success) {
+        LOG(ERROR) << "meta request encode failed, type: "
+                   << OperatorTypeName(GetOperatorType())
+                   << ", request: " << request_->ShortDebugString();
+    }
+    return success;
+}
+
 void MetaOperator::FastApplyTask() {
     butil::Timer timer;
     timer.start();
@@ -129,6 +154,45 @@ void MetaOperator::FastApplyTask() {
     g_concurrent_fast_apply_wait_latency << timer.u_elapsed();
 }
 
+bool MetaOperator::CanReadOnFollower() const {
+    if (node_->IsLoading()) {
+        return false;
+    }
+
+    braft::PeerId leaderId = node_->GetLeaderId();
+    if (leaderId.is_empty()) {
+        return false;
+    }
+
+    // the follower hasn't applied the logs the client has seen, it's far
+    // behind the leader, so don't bother to wait
+    if (node_->GetDispatchedIndex() < ClientAppliedIndex()) {
+        return false;
+    }
+
+    // the read index covers every write replied before this read, so the
+    // read is linearizable once the follower dispatched its log
+    uint64_t readIndex = 0;
+    if (!node_->FetchReadIndex(leaderId, &readIndex)) {
+        return false;
+    }
+
+    return node_->WaitDispatchedIndex(readIndex);
+}
+
+void MetaOperator::FollowerReadTask() {
+    // the operator is pushed to the write queue of its partition, so it is
+    // executed after all the dispatched logs of the partition are applied
+    followerRead_ = true;
+    uint64_t index = node_->GetDispatchedIndex();
+    auto task =
+        std::bind(&MetaOperator::OnApply, this, index,
+                  new MetaOperatorClosure(this), TimeUtility::GetTimeofDayUs());
+    node_->GetApplyQueue()->Push(HashCode(), ThreadPoolType::WRITE,
+                                 std::move(task));
+    g_follower_read_count << 1;
+}
+
 #define OPERATOR_CAN_BY_PASS_PROPOSE(TYPE)                                     \
     bool TYPE##Operator::CanBypassPropose() const {                            \
         return true;                                                           \
@@ -137,6 +201,7 @@ void MetaOperator::FastApplyTask() {
 // below operator are readonly, so can enable lease read
 OPERATOR_CAN_BY_PASS_PROPOSE(GetDentry);
 OPERATOR_CAN_BY_PASS_PROPOSE(ListDentry);
+OPERATOR_CAN_BY_PASS_PROPOSE(ListDentryPlus);
 OPERATOR_CAN_BY_PASS_PROPOSE(GetInode);
 OPERATOR_CAN_BY_PASS_PROPOSE(BatchGetInodeAttr);
 OPERATOR_CAN_BY_PASS_PROPOSE(BatchGetXAttr);
@@ -144,6 +209,36 @@ OPERATOR_CAN_BY_PASS_PROPOSE(GetVolumeExtent);
 
 #undef OPERATOR_CAN_BY_PASS_PROPOSE
 
+#define OPERATOR_CLIENT_APPLIED_INDEX(TYPE)                                    \
+    uint64_t TYPE##Operator::ClientAppliedIndex() const {                      \
+        return static_cast<const TYPE##Request*>(request_)->appliedindex();    \
+    }
+
+// below readonly operators can be served by follower
+OPERATOR_CLIENT_APPLIED_INDEX(GetDentry);
+OPERATOR_CLIENT_APPLIED_INDEX(ListDentry);
+OPERATOR_CLIENT_APPLIED_INDEX(ListDentryPlus);
+OPERATOR_CLIENT_APPLIED_INDEX(GetInode);
+OPERATOR_CLIENT_APPLIED_INDEX(BatchGetInodeAttr);
+OPERATOR_CLIENT_APPLIED_INDEX(BatchGetXAttr);
+
+#undef OPERATOR_CLIENT_APPLIED_INDEX
+
+#define OPERATOR_CAN_BATCH_PROPOSE(TYPE)                                       \
+    bool TYPE##Operator::CanBatchPropose() const {                             \
+        return true;                                                           \
+    }
+
+// below operators are small writes, which are frequent when creating and
+// removing files
+OPERATOR_CAN_BATCH_PROPOSE(CreateDentry);
+OPERATOR_CAN_BATCH_PROPOSE(DeleteDentry);
+OPERATOR_CAN_BATCH_PROPOSE(CreateInode);
+OPERATOR_CAN_BATCH_PROPOSE(UpdateInode);
+OPERATOR_CAN_BATCH_PROPOSE(DeleteInode);
+
+#undef OPERATOR_CAN_BATCH_PROPOSE
+
 #define OPERATOR_ON_APPLY(TYPE)                                                \
     void TYPE##Operator::OnApply(int64_t index,                                \
                                  google::protobuf::Closure *done,              \
@@ -158,7 +253,9 @@ OPERATOR_CAN_BY_PASS_PROPOSE(GetVolumeExtent);
         uint64_t executeTime = TimeUtility::GetTimeofDayUs() - timeUs;         \
         node_->GetMetric()->ExecuteLatency(OperatorType::TYPE, executeTime);   \
         if (status == MetaStatusCode::OK) {                                    \
-            node_->UpdateAppliedIndex(index);                                  \
+            if (!followerRead_) {                                              \
+                node_->UpdateAppliedIndex(index);                              \
+            }                                                                  \
             static_cast<TYPE##Response *>(response_)->set_appliedindex(        \
                 std::max<uint64_t>(index, node_->GetAppliedIndex()));          \
             node_->GetMetric()->OnOperatorComplete(                            \
@@ -173,14 +270,9 @@ OPERATOR_CAN_BY_PASS_PROPOSE(GetVolumeExtent);
 
 OPERATOR_ON_APPLY(GetDentry);
 OPERATOR_ON_APPLY(ListDentry);
-OPERATOR_ON_APPLY(CreateDentry);
-OPERATOR_ON_APPLY(DeleteDentry);
 OPERATOR_ON_APPLY(GetInode);
 OPERATOR_ON_APPLY(BatchGetInodeAttr);
 OPERATOR_ON_APPLY(BatchGetXAttr);
-OPERATOR_ON_APPLY(CreateInode);
-OPERATOR_ON_APPLY(UpdateInode);
-OPERATOR_ON_APPLY(DeleteInode);
 OPERATOR_ON_APPLY(CreateRootInode);
 OPERATOR_ON_APPLY(CreateManageInode);
 OPERATOR_ON_APPLY(CreatePartition);
@@ -191,6 +283,54 @@ OPERATOR_ON_APPLY(UpdateDeallocatableBlockGroup);
 
 #undef OPERATOR_ON_APPLY
 
+// batchable operators are applied in two steps, so BatchOperator can commit
+// the writes of all its operators before replying any of them
+#define BATCHABLE_OPERATOR_ON_APPLY(TYPE)                                      \
+    void TYPE##Operator::OnApply(int64_t index,                                \
+                                 google::protobuf::Closure *done,              \
+                                 uint64_t startTimeUs) {                       \
+        brpc::ClosureGuard doneGuard(done);                                    \
+        Complete(index, Execute(startTimeUs), startTimeUs);                    \
+    }                                                                          \
+                                                                               \
+    MetaStatusCode TYPE##Operator::Execute(uint64_t startTimeUs) {             \
+        uint64_t timeUs = TimeUtility::GetTimeofDayUs();                       \
+        node_->GetMetric()->WaitInQueueLatency(OperatorType::TYPE,             \
+                                               timeUs - startTimeUs);          \
+        auto status = node_->GetMetaStore()->TYPE(                             \
+            static_cast<const TYPE##Request *>(request_),                      \
+            static_cast<TYPE##Response *>(response_));                         \
+        uint64_t executeTime = TimeUtility::GetTimeofDayUs() - timeUs;         \
+        node_->GetMetric()->ExecuteLatency(OperatorType::TYPE, executeTime);   \
+        return status;                                                         \
+    }                                                                          \
+                                                                               \
+    void TYPE##Operator::Complete(int64_t index, MetaStatusCode status,        \
+                                  uint64_t startTimeUs) {                      \
+        auto *response = static_cast<TYPE##Response *>(response_);             \
+        response->set_statuscode(status);                                      \
+        if (status == MetaStatusCode::OK) {                                    \
+            node_->UpdateAppliedIndex(index);                                  \
+            response->set_appliedindex(                                        \
+                std::max<uint64_t>(index, node_->GetAppliedIndex()));          \
+            node_->GetMetric()->OnOperatorComplete(                            \
+                OperatorType::TYPE,                                            \
+                TimeUtility::GetTimeofDayUs() - startTimeUs, true);            \
+        } else {                                                               \
+            node_->GetMetric()->OnOperatorComplete(                            \
+                OperatorType::TYPE,                                            \
+                TimeUtility::GetTimeofDayUs() - startTimeUs, false);           \
+        }                                                                      \
+    }
+
+BATCHABLE_OPERATOR_ON_APPLY(CreateDentry);
+BATCHABLE_OPERATOR_ON_APPLY(DeleteDentry);
+BATCHABLE_OPERATOR_ON_APPLY(CreateInode);
+BATCHABLE_OPERATOR_ON_APPLY(UpdateInode);
+BATCHABLE_OPERATOR_ON_APPLY(DeleteInode);
+
+#undef BATCHABLE_OPERATOR_ON_APPLY
+
 // NOTE: now we need struct `brpc::Controller` for sending data by stream,
 // so we redefine OnApply() and OnApplyFromLog() instead of using macro.
 // It may not be an elegant implementation, can you provide a better idea?
@@ -291,6 +431,64 @@ void GetVolumeExtentOperator::OnApply(int64_t index,
     }
 }
 
+void ListDentryPlusOperator::OnApply(int64_t index,
+                                     google::protobuf::Closure *done,
+                                     uint64_t startTimeUs) {
+    brpc::ClosureGuard doneGuard(done);
+    const auto *request = static_cast<const ListDentryPlusRequest *>(request_);
+    auto *response = static_cast<ListDentryPlusResponse *>(response_);
+    auto *metaStore = node_->GetMetaStore();
+
+    uint64_t timeUs = TimeUtility::GetTimeofDayUs();
+    node_->GetMetric()->WaitInQueueLatency(OperatorType::ListDentryPlus,
+                                           timeUs - startTimeUs);
+    auto st = metaStore->ListDentryPlus(request, response);
+    node_->GetMetric()->ExecuteLatency(OperatorType::ListDentryPlus,
+                                       TimeUtility::GetTimeofDayUs() - timeUs);
+    node_->GetMetric()->OnOperatorComplete(
+        OperatorType::ListDentryPlus,
+        TimeUtility::GetTimeofDayUs() - startTimeUs, st == MetaStatusCode::OK);
+
+    if (st != MetaStatusCode::OK) {
+        return;
+    }
+
+    if (!followerRead_) {
+        node_->UpdateAppliedIndex(index);
+    }
+    response->set_appliedindex(
+        std::max<uint64_t>(index, node_->GetAppliedIndex()));
+    if (!request->streaming()) {
+        return;
+    }
+
+    // in streaming mode, swap dentrys and attributes out and send them by
+    // streaming, so a large directory is not replied in one huge message
+    DentryPlusList entries;
+    entries.mutable_dentrys()->Swap(response->mutable_dentrys());
+    entries.mutable_attr()->Swap(response->mutable_attr());
+
+    // accept client's streaming request
+    auto *cntl = static_cast<brpc::Controller *>(cntl_);
+    auto streamingServer = metaStore->GetStreamServer();
+    auto connection = streamingServer->Accept(cntl);
+    if (connection == nullptr) {
+        LOG(ERROR) << "Accept streaming connection failed";
+        response->set_statuscode(MetaStatusCode::RPC_STREAM_ERROR);
+        return;
+    }
+
+    // run done
+    done->Run();
+    doneGuard.release();
+
+    // send dentrys and attributes
+    st = StreamingSendDentryPlus(connection.get(), entries);
+    if (st != MetaStatusCode::OK) {
+        LOG(ERROR) << "Send dentrys and attributes by stream failed";
+    }
+}
+
 #define OPERATOR_ON_APPLY_FROM_LOG(TYPE)                                       \
     void TYPE##Operator::OnApplyFromLog(uint64_t startTimeUs) {                \
         std::unique_ptr<TYPE##Operator> selfGuard(this);                       \
@@ -341,6 +539,7 @@ void GetOrModifyS3ChunkInfoOperator::OnApplyFromLog(uint64_t startTimeUs) {
 // below operator are readonly, so on apply from log do nothing
 READONLY_OPERATOR_ON_APPLY_FROM_LOG(GetDentry);
 READONLY_OPERATOR_ON_APPLY_FROM_LOG(ListDentry);
+READONLY_OPERATOR_ON_APPLY_FROM_LOG(ListDentryPlus);
 READONLY_OPERATOR_ON_APPLY_FROM_LOG(GetInode);
 READONLY_OPERATOR_ON_APPLY_FROM_LOG(BatchGetInodeAttr);
 READONLY_OPERATOR_ON_APPLY_FROM_LOG(BatchGetXAttr);
@@ -356,6 +555,7 @@ READONLY_OPERATOR_ON_APPLY_FROM_LOG(GetVolumeExtent);
 
 OPERATOR_REDIRECT(GetDentry);
 OPERATOR_REDIRECT(ListDentry);
+OPERATOR_REDIRECT(ListDentryPlus);
 OPERATOR_REDIRECT(CreateDentry);
 OPERATOR_REDIRECT(DeleteDentry);
 OPERATOR_REDIRECT(GetInode);
@@ -383,6 +583,7 @@ OPERATOR_REDIRECT(UpdateDeallocatableBlockGroup);
 
 OPERATOR_ON_FAILED(GetDentry);
 OPERATOR_ON_FAILED(ListDentry);
+OPERATOR_ON_FAILED(ListDentryPlus);
 OPERATOR_ON_FAILED(CreateDentry);
 OPERATOR_ON_FAILED(DeleteDentry);
 OPERATOR_ON_FAILED(GetInode);
@@ -410,6 +611,7 @@ OPERATOR_ON_FAILED(UpdateDeallocatableBlockGroup);
 
 OPERATOR_HASH_CODE(GetDentry);
 OPERATOR_HASH_CODE(ListDentry);
+OPERATOR_HASH_CODE(ListDentryPlus);
 OPERATOR_HASH_CODE(CreateDentry);
 OPERATOR_HASH_CODE(DeleteDentry);
 OPERATOR_HASH_CODE(GetInode);
@@ -448,6 +650,7 @@ PARTITION_OPERATOR_HASH_CODE(CreatePartition);
 
 OPERATOR_TYPE(GetDentry);
 OPERATOR_TYPE(ListDentry);
+OPERATOR_TYPE(ListDentryPlus);
 OPERATOR_TYPE(CreateDentry);
 OPERATOR_TYPE(DeleteDentry);
 OPERATOR_TYPE(GetInode);
@@ -468,6 +671,91 @@ OPERATOR_TYPE(UpdateDeallocatableBlockGroup);
 
 #undef OPERATOR_TYPE
 
+BatchOperator::BatchOperator(
+    CopysetNode* node, std::vector<std::unique_ptr<MetaOperator>> operators)
+    : MetaOperator(node, nullptr, false),
+      operators_(std::move(operators)),
+      hashCode_(operators_.front()->HashCode()) {}
+
+void BatchOperator::OnApply(int64_t index, google::protobuf::Closure* done,
+                            uint64_t startTimeUs) {
+    brpc::ClosureGuard doneGuard(done);
+    // writes of all operators are committed in one storage transaction if
+    // the storage supports batch, an operator which failed has undone its
+    // own writes, and requests are replied after the commit, so none of
+    // them sees an uncommitted result
+    auto* metaStore = node_->GetMetaStore();
+    const bool batched = metaStore->BeginBatch();
+    std::vector<MetaStatusCode> status;
+    status.reserve(operators_.size());
+    for (auto& op : operators_) {
+        status.push_back(op->Execute(startTimeUs));
+    }
+
+    // operators have updated in-memory states, e.g., the inode and dentry
+    // counters, which can't be rolled back with the storage
+    if (batched && !metaStore->CommitBatch()) {
+        LOG(FATAL) << "Fail to commit batch, copyset: " << node_->Name()
+                   << ", index: " << index
+                   << ", operators: " << operators_.size();
+    }
+
+    for (size_t i = 0; i < operators_.size(); ++i) {
+        MetaOperator* current = operators_[i].release();
+        brpc::ClosureGuard currentGuard(new MetaOperatorClosure(current));
+        current->Complete(index, status[i], startTimeUs);
+    }
+    operators_.clear();
+}
+
+void BatchOperator::OnApplyFromLog(uint64_t startTimeUs) {
+    std::unique_ptr<BatchOperator> selfGuard(this);
+    auto* metaStore = node_->GetMetaStore();
+    const bool batched = metaStore->BeginBatch();
+    for (auto& op : operators_) {
+        op.release()->OnApplyFromLog(startTimeUs);
+    }
+    operators_.clear();
+
+    // operators have been applied, a lost write breaks the state machine
+    if (batched && !metaStore->CommitBatch()) {
+        LOG(FATAL) << "Fail to commit batch from log, copyset: "
+                   << node_->Name();
+    }
+}
+
+uint64_t BatchOperator::HashCode() const { return hashCode_; }
+
+OperatorType BatchOperator::GetOperatorType() const {
+    return OperatorType::Batch;
+}
+
+bool BatchOperator::EncodeTo(butil::IOBuf* log) const {
+    butil::IOBuf entries;
+    for (const auto& op : operators_) {
+        if (!op->EncodeTo(&entries)) {
+            return false;
+        }
+    }
+    return RaftLogCodec::EncodeBatch(entries, log);
+}
+
+void BatchOperator::Redirect() {
+    for (auto& op : operators_) {
+        brpc::ClosureGuard doneGuard(op->Closure());
+        op->RedirectRequest();
+    }
+    operators_.clear();
+}
+
+void BatchOperator::OnFailed(MetaStatusCode code) {
+    for (auto& op : operators_) {
+        brpc::ClosureGuard doneGuard(op->Closure());
+        op->OnFailed(code);
+    }
+    operators_.clear();
+}
+
 }  // namespace copyset
 }  // namespace metaserver
 }  // namespace curvefs
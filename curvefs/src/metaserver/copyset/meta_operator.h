@@ -26,6 +26,9 @@
 #include <brpc/controller.h>
 #include <google/protobuf/message.h>
 
+#include <memory>
+#include <vector>
+
 #include "curvefs/proto/metaserver.pb.h"
 #include "curvefs/src/common/rpc_stream.h"
 #include "curvefs/src/metaserver/copyset/operator_type.h"
@@ -118,11 +121,27 @@ class MetaOperator {
      */
     bool ProposeTask();
 
+    /**
+     * @brief Encode current operator into raft log
+     */
+    virtual bool EncodeTo(butil::IOBuf* log) const;
+
     /**
      * @brief Directly push operator to concurrently module
      */
     void FastApplyTask();
 
+    /**
+     * @brief Whether current follower can serve a readonly operator, i.e.,
+     *        it has dispatched the log of the read index got from leader
+     */
+    bool CanReadOnFollower() const;
+
+    /**
+     * @brief Push readonly operator to concurrently module of follower
+     */
+    void FollowerReadTask();
+
  private:
     /**
      * @brief Redirect request if current node is not leader
@@ -140,6 +159,41 @@ class MetaOperator {
         return false;
     }
 
+    /**
+     * @brief The appliedindex carried by readonly request, i.e., the latest
+     *        applied index the client has seen, and 0 means unknown
+     */
+    virtual uint64_t ClientAppliedIndex() const {
+        return 0;
+    }
+
+    /**
+     * @brief Whether an operator can share a raft log entry with other
+     *        operators of the same partition, see ProposeBatcher
+     */
+    virtual bool CanBatchPropose() const {
+        return false;
+    }
+
+    /**
+     * @brief Execute a batchable operator without replying its request,
+     *        BatchOperator executes all its operators before committing them
+     *        in one storage transaction
+     */
+    virtual MetaStatusCode Execute(uint64_t startTimeUs) {
+        return MetaStatusCode::UNKNOWN_ERROR;
+    }
+
+    /**
+     * @brief Set the final status of an executed batchable operator into its
+     *        response, the caller replies the request afterwards
+     */
+    virtual void Complete(int64_t index, MetaStatusCode status,
+                          uint64_t startTimeUs) {}
+
+    friend class BatchOperator;
+    friend class ProposeBatcher;
+
  protected:
     CopysetNode* node_;
 
@@ -158,6 +212,9 @@ class MetaOperator {
     // whether own request, if true, delete request when destory
     const bool ownRequest_;
 
+    // whether served by follower, which mustn't update the applied index
+    bool followerRead_ = false;
+
  public:
     butil::Timer timerPropose;
 };
@@ -181,6 +238,8 @@ class GetDentryOperator : public MetaOperator {
     void OnFailed(MetaStatusCode code) override;
 
     bool CanBypassPropose() const override;
+
+    uint64_t ClientAppliedIndex() const override;
 };
 
 class ListDentryOperator : public MetaOperator {
@@ -202,6 +261,31 @@ class ListDentryOperator : public MetaOperator {
     void OnFailed(MetaStatusCode code) override;
 
     bool CanBypassPropose() const override;
+
+    uint64_t ClientAppliedIndex() const override;
+};
+
+class ListDentryPlusOperator : public MetaOperator {
+ public:
+    using MetaOperator::MetaOperator;
+
+    void OnApply(int64_t index, google::protobuf::Closure* done,
+                 uint64_t startTimeUs) override;
+
+    void OnApplyFromLog(uint64_t startTimeUs) override;
+
+    uint64_t HashCode() const override;
+
+    OperatorType GetOperatorType() const override;
+
+ private:
+    void Redirect() override;
+
+    void OnFailed(MetaStatusCode code) override;
+
+    bool CanBypassPropose() const override;
+
+    uint64_t ClientAppliedIndex() const override;
 };
 
 class CreateDentryOperator : public MetaOperator {
@@ -221,6 +305,13 @@ class CreateDentryOperator : public MetaOperator {
     void Redirect() override;
 
     void OnFailed(MetaStatusCode code) override;
+
+    bool CanBatchPropose() const override;
+
+    MetaStatusCode Execute(uint64_t startTimeUs) override;
+
+    void Complete(int64_t index, MetaStatusCode status,
+                  uint64_t startTimeUs) override;
 };
 
 class DeleteDentryOperator : public MetaOperator {
@@ -240,6 +331,13 @@ class DeleteDentryOperator : public MetaOperator {
     void Redirect() override;
 
     void OnFailed(MetaStatusCode code) override;
+
+    bool CanBatchPropose() const override;
+
+    MetaStatusCode Execute(uint64_t startTimeUs) override;
+
+    void Complete(int64_t index, MetaStatusCode status,
+                  uint64_t startTimeUs) override;
 };
 
 class GetInodeOperator : public MetaOperator {
@@ -261,6 +359,8 @@ class GetInodeOperator : public MetaOperator {
     void OnFailed(MetaStatusCode code) override;
 
     bool CanBypassPropose() const override;
+
+    uint64_t ClientAppliedIndex() const override;
 };
 
 class BatchGetInodeAttrOperator : public MetaOperator {
@@ -282,6 +382,8 @@ class BatchGetInodeAttrOperator : public MetaOperator {
     void OnFailed(MetaStatusCode code) override;
 
     bool CanBypassPropose() const override;
+
+    uint64_t ClientAppliedIndex() const override;
 };
 
 class BatchGetXAttrOperator : public MetaOperator {
@@ -303,6 +405,8 @@ class BatchGetXAttrOperator : public MetaOperator {
     void OnFailed(MetaStatusCode code) override;
 
     bool CanBypassPropose() const override;
+
+    uint64_t ClientAppliedIndex() const override;
 };
 
 class CreateInodeOperator : public MetaOperator {
@@ -322,6 +426,13 @@ class CreateInodeOperator : public MetaOperator {
     void Redirect() override;
 
     void OnFailed(MetaStatusCode code) override;
+
+    bool CanBatchPropose() const override;
+
+    MetaStatusCode Execute(uint64_t startTimeUs) override;
+
+    void Complete(int64_t index, MetaStatusCode status,
+                  uint64_t startTimeUs) override;
 };
 
 class UpdateInodeOperator : public MetaOperator {
@@ -341,6 +452,13 @@ class UpdateInodeOperator : public MetaOperator {
     void Redirect() override;
 
     void OnFailed(MetaStatusCode code) override;
+
+    bool CanBatchPropose() const override;
+
+    MetaStatusCode Execute(uint64_t startTimeUs) override;
+
+    void Complete(int64_t index, MetaStatusCode status,
+                  uint64_t startTimeUs) override;
 };
 
 class GetOrModifyS3ChunkInfoOperator : public MetaOperator {
@@ -379,6 +497,13 @@ class DeleteInodeOperator : public MetaOperator {
     void Redirect() override;
 
     void OnFailed(MetaStatusCode code) override;
+
+    bool CanBatchPropose() const override;
+
+    MetaStatusCode Execute(uint64_t startTimeUs) override;
+
+    void Complete(int64_t index, MetaStatusCode status,
+                  uint64_t startTimeUs) override;
 };
 
 class CreateRootInodeOperator : public MetaOperator {
@@ -556,6 +681,41 @@ class UpdateDeallocatableBlockGroupOperator : public MetaOperator {
     void OnFailed(MetaStatusCode code) override;
 };
 
+// Write operators of the same partition which are proposed in one raft log
+// entry, operators are applied one by one in their order in the batch, and
+// their writes are committed in one storage transaction
+class BatchOperator : public MetaOperator {
+ public:
+    BatchOperator(CopysetNode* node,
+                  std::vector<std::unique_ptr<MetaOperator>> operators);
+
+    void OnApply(int64_t index, google::protobuf::Closure* done,
+                 uint64_t startTimeUs) override;
+
+    void OnApplyFromLog(uint64_t startTimeUs) override;
+
+    uint64_t HashCode() const override;
+
+    OperatorType GetOperatorType() const override;
+
+    size_t Size() const {
+        return operators_.size();
+    }
+
+ private:
+    bool EncodeTo(butil::IOBuf* log) const override;
+
+    void Redirect() override;
+
+    void OnFailed(MetaStatusCode code) override;
+
+ private:
+    std::vector<std::unique_ptr<MetaOperator>> operators_;
+
+    // all operators in a batch have the same hash code
+    const uint64_t hashCode_;
+};
+
 }  // namespace copyset
 }  // namespace metaserver
 }  // namespace curvefs
@@ -141,16 +141,31 @@ class RaftSnapshotMetric {
         delete ctx;
     }
 
+    // Called after loading a snapshot installed from leader, |reusedFiles|
+    // are kept from the last snapshot of current node, and |receivedFiles|
+    // are copied from leader
+    void OnSnapshotInstalled(uint64_t reusedFiles, uint64_t receivedFiles) {
+        installCount_ << 1;
+        reusedFiles_ << reusedFiles;
+        receivedFiles_ << receivedFiles;
+    }
+
  private:
     RaftSnapshotMetric()
         : latRecorder_("copyset_snapshot_latency"),
           errorCount_("copyset_snapshot_error_count"),
-          flying_("copyset_snapshot_flying_count") {}
+          flying_("copyset_snapshot_flying_count"),
+          installCount_("copyset_snapshot_install_count"),
+          reusedFiles_("copyset_snapshot_install_reused_files"),
+          receivedFiles_("copyset_snapshot_install_received_files") {}
 
  private:
     bvar::LatencyRecorder latRecorder_;
     bvar::Adder<uint64_t> errorCount_;
     bvar::Adder<int64_t> flying_;
+    bvar::Adder<uint64_t> installCount_;
+    bvar::Adder<uint64_t> reusedFiles_;
+    bvar::Adder<uint64_t> receivedFiles_;
 };
 
 }  // namespace copyset
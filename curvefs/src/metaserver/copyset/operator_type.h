@@ -53,6 +53,9 @@ enum class OperatorType : uint32_t {
     UpdateVolumeExtent = 16,
     CreateManageInode = 17,
     UpdateDeallocatableBlockGroup = 18,
+    ListDentryPlus = 19,
+    // several write operators of the same partition in one raft log entry
+    Batch = 20,
 
     // NOTE:
     //   Add new operator before `OperatorTypeMax`
@@ -0,0 +1,98 @@
+/*
+ *  Copyright (c) 2023 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include "curvefs/src/metaserver/copyset/propose_batcher.h"
+
+#include <brpc/closure_guard.h>
+#include <bthread/bthread.h>
+
+#include <mutex>
+#include <utility>
+
+#include "absl/memory/memory.h"
+#include "curvefs/src/metaserver/copyset/meta_operator.h"
+
+namespace curvefs {
+namespace metaserver {
+namespace copyset {
+
+ProposeBatcher::ProposeBatcher(CopysetNode* node, uint32_t maxBatchSize,
+                               uint32_t waitUs)
+    : node_(node), maxBatchSize_(maxBatchSize), waitUs_(waitUs) {}
+
+void ProposeBatcher::Propose(MetaOperator* op) {
+    const uint64_t hashCode = op->HashCode();
+    std::vector<std::unique_ptr<MetaOperator>> operators;
+    bool first = false;
+    {
+        std::lock_guard<bthread::Mutex> lk(mtx_);
+        auto& batch = pending_[hashCode];
+        batch.emplace_back(op);
+        if (batch.size() >= maxBatchSize_) {
+            operators.swap(batch);
+            pending_.erase(hashCode);
+        } else {
+            first = batch.size() == 1;
+        }
+    }
+
+    if (!operators.empty()) {
+        ProposeBatch(std::move(operators));
+        return;
+    }
+
+    // the first operator proposes the batch after waiting for others
+    if (!first) {
+        return;
+    }
+
+    bthread_usleep(waitUs_);
+    {
+        std::lock_guard<bthread::Mutex> lk(mtx_);
+        auto iter = pending_.find(hashCode);
+        if (iter == pending_.end()) {
+            // proposed as it's full
+            return;
+        }
+        operators.swap(iter->second);
+        pending_.erase(iter);
+    }
+
+    ProposeBatch(std::move(operators));
+}
+
+void ProposeBatcher::ProposeBatch(
+    std::vector<std::unique_ptr<MetaOperator>> operators) {
+    std::unique_ptr<MetaOperator> op;
+    if (operators.size() == 1) {
+        // propose it alone, so the raft log is same as without batching
+        op = std::move(operators.front());
+    } else {
+        op = absl::make_unique<BatchOperator>(node_, std::move(operators));
+    }
+
+    if (op->ProposeTask()) {
+        op.release();
+        return;
+    }
+
+    // operators has been failed in ProposeTask
+    brpc::ClosureGuard doneGuard(op->Closure());
+}
+
+}  // namespace copyset
+}  // namespace metaserver
+}  // namespace curvefs
@@ -0,0 +1,75 @@
+/*
+ *  Copyright (c) 2023 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#ifndef CURVEFS_SRC_METASERVER_COPYSET_PROPOSE_BATCHER_H_
+#define CURVEFS_SRC_METASERVER_COPYSET_PROPOSE_BATCHER_H_
+
+#include <bthread/mutex.h>
+
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace curvefs {
+namespace metaserver {
+namespace copyset {
+
+class CopysetNode;
+class MetaOperator;
+
+// Propose write operators of the same partition in one raft log entry.
+//
+// The first operator of a partition waits |waitUs| for others, then proposes
+// all operators arrived as a BatchOperator. A batch is proposed at once when
+// it has |maxBatchSize| operators. Operators are batched only with those of
+// the same partition, so they are applied by the same apply queue worker as
+// before, in the order they arrived.
+class ProposeBatcher {
+ public:
+    ProposeBatcher(CopysetNode* node, uint32_t maxBatchSize, uint32_t waitUs);
+
+    ProposeBatcher(const ProposeBatcher&) = delete;
+    ProposeBatcher& operator=(const ProposeBatcher&) = delete;
+
+    /**
+     * @brief Propose an operator with others, the operator's closure is
+     *        run after it is applied or failed
+     */
+    void Propose(MetaOperator* op);
+
+ private:
+    void ProposeBatch(std::vector<std::unique_ptr<MetaOperator>> operators);
+
+ private:
+    CopysetNode* node_;
+
+    const uint32_t maxBatchSize_;
+
+    const uint32_t waitUs_;
+
+    bthread::Mutex mtx_;
+
+    // operators waiting to be proposed, key is operator's hash code
+    std::unordered_map<uint64_t, std::vector<std::unique_ptr<MetaOperator>>>
+        pending_;
+};
+
+}  // namespace copyset
+}  // namespace metaserver
+}  // namespace curvefs
+
+#endif  // CURVEFS_SRC_METASERVER_COPYSET_PROPOSE_BATCHER_H_
@@ -27,6 +27,8 @@
 
 #include <memory>
 #include <type_traits>
+#include <utility>
+#include <vector>
 
 #include "curvefs/proto/metaserver.pb.h"
 
@@ -93,6 +95,25 @@ bool RaftLogCodec::Encode(OperatorType type,
     return false;
 }
 
+bool RaftLogCodec::EncodeBatch(const butil::IOBuf& entries,
+                               butil::IOBuf* log) {
+    // same layout as a single operator, request is replaced by entries
+    const uint32_t networkType =
+        butil::HostToNet32(static_cast<uint32_t>(OperatorType::Batch));
+    log->append(&networkType, sizeof(networkType));
+
+    if (CURVE_UNLIKELY(entries.size() > INT_MAX)) {
+        LOG(ERROR) << "Batch's size is too large, size: " << entries.size();
+        return false;
+    }
+
+    const uint32_t networkEntriesSize =
+        butil::HostToNet32(static_cast<uint32_t>(entries.size()));
+    log->append(&networkEntriesSize, sizeof(networkEntriesSize));
+    log->append(entries);
+    return true;
+}
+
 std::unique_ptr<MetaOperator> RaftLogCodec::Decode(CopysetNode* node,
                                                    butil::IOBuf log) {
     uint32_t logtype;
@@ -169,6 +190,11 @@ std::unique_ptr<MetaOperator> RaftLogCodec::Decode(CopysetNode* node,
             return ParseFromRaftLog<UpdateDeallocatableBlockGroupOperator,
                                     UpdateDeallocatableBlockGroupRequest>(
                 node, type, meta);
+        case OperatorType::ListDentryPlus:
+            return ParseFromRaftLog<ListDentryPlusOperator,
+                                    ListDentryPlusRequest>(node, type, meta);
+        case OperatorType::Batch:
+            return DecodeBatch(node, std::move(meta));
         // Add new case before `OperatorType::OperatorTypeMax`
         case OperatorType::OperatorTypeMax:
             break;
@@ -182,6 +208,39 @@ std::unique_ptr<MetaOperator> RaftLogCodec::Decode(CopysetNode* node,
     return nullptr;
 }
 
+std::unique_ptr<MetaOperator> RaftLogCodec::DecodeBatch(
+    CopysetNode* node, butil::IOBuf entries) {
+    std::vector<std::unique_ptr<MetaOperator>> operators;
+    while (!entries.empty()) {
+        // every entry is: type | request length | request
+        uint32_t header[2];
+        if (entries.copy_to(header, sizeof(header)) != sizeof(header)) {
+            LOG(ERROR) << "Fail to parse batch from raft log, bad entry";
+            return nullptr;
+        }
+
+        const size_t entrySize = sizeof(header) + butil::NetToHost32(header[1]);
+        butil::IOBuf entry;
+        if (entries.cutn(&entry, entrySize) != entrySize) {
+            LOG(ERROR) << "Fail to parse batch from raft log, entry truncated";
+            return nullptr;
+        }
+
+        auto op = Decode(node, std::move(entry));
+        if (op == nullptr) {
+            return nullptr;
+        }
+        operators.push_back(std::move(op));
+    }
+
+    if (operators.empty()) {
+        LOG(ERROR) << "Fail to parse batch from raft log, empty batch";
+        return nullptr;
+    }
+
+    return absl::make_unique<BatchOperator>(node, std::move(operators));
+}
+
 }  // namespace copyset
 }  // namespace metaserver
 }  // namespace curvefs
@@ -41,6 +41,12 @@ class RaftLogCodec {
                        const google::protobuf::Message* request,
                        butil::IOBuf* log);
 
+    /**
+     * @brief Encode entries of several operators to butil::IOBuf,
+     *        every entry is encoded by `Encode`
+     */
+    static bool EncodeBatch(const butil::IOBuf& entries, butil::IOBuf* log);
+
     /**
      * @brief Decode from butil::IOBuf and create corresponding metaoperator
      */
@@ -48,6 +54,9 @@ class RaftLogCodec {
                                                 butil::IOBuf log);
 
  private:
+    static std::unique_ptr<MetaOperator> DecodeBatch(CopysetNode* node,
+                                                     butil::IOBuf entries);
+
     static constexpr size_t kOperatorTypeSize = sizeof(OperatorType);
 };
 
@@ -28,6 +28,7 @@
 
 #include "src/common/string_util.h"
 #include "curvefs/src/metaserver/dentry_storage.h"
+#include "curvefs/src/metaserver/storage/utils.h"
 
 namespace curvefs {
 namespace metaserver {
@@ -504,5 +505,16 @@ MetaStatusCode DentryStorage::Clear() {
     return MetaStatusCode::OK;
 }
 
+MetaStatusCode DentryStorage::MigrateLegacyKeys() {
+    WriteLockGuard lg(rwLock_);
+    DentryVec vec;
+    if (!storage::MigrateLegacyKeys(kvStorage_.get(), table4Dentry_, true,
+                                    &vec)) {
+        LOG(ERROR) << "DentryStorage migrate legacy keys failed";
+        return MetaStatusCode::STORAGE_INTERNAL_ERROR;
+    }
+    return MetaStatusCode::OK;
+}
+
 }  // namespace metaserver
 }  // namespace curvefs
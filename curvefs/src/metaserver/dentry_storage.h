@@ -135,6 +135,9 @@ class DentryStorage {
 
     MetaStatusCode Clear();
 
+    // rewrite keys saved by previous versions into current format
+    MetaStatusCode MigrateLegacyKeys();
+
  private:
     std::string DentryKey(const Dentry& entry);
 
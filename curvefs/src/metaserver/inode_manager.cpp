@@ -288,9 +288,11 @@ MetaStatusCode InodeManager::UpdateInode(const UpdateInodeRequest& request) {
     NameLockGuard lg(inodeLock_, GetInodeLockName(
             request.fsid(), request.inodeid()));
 
+    // extended attributes are saved apart from the inode and are replaced
+    // as a whole, so only get inode attributes here
     Inode old;
-    MetaStatusCode ret =
-        inodeStorage_->Get(Key4Inode(request.fsid(), request.inodeid()), &old);
+    MetaStatusCode ret = inodeStorage_->Get(
+        Key4Inode(request.fsid(), request.inodeid()), &old, false);
     if (ret != MetaStatusCode::OK) {
         LOG(ERROR) << "GetInode fail, " << request.ShortDebugString()
                    << ", ret: " << MetaStatusCode_Name(ret);
@@ -298,6 +300,7 @@ MetaStatusCode InodeManager::UpdateInode(const UpdateInodeRequest& request) {
     }
 
     bool needUpdate = false;
+    bool needUpdateXAttr = false;
     bool needAddTrash = false;
 
 #define UPDATE_INODE(param)                  \
@@ -340,6 +343,7 @@ MetaStatusCode InodeManager::UpdateInode(const UpdateInodeRequest& request) {
                 << ", inodeid: " << request.inodeid();
         *(old.mutable_xattr()) = request.xattr();
         needUpdate = true;
+        needUpdateXAttr = true;
     }
 
     bool fileNeedDeallocate =
@@ -347,7 +351,8 @@ MetaStatusCode InodeManager::UpdateInode(const UpdateInodeRequest& request) {
     bool s3NeedTrash = (needAddTrash && (FsFileType::TYPE_S3 == old.type()));
 
     if (needUpdate) {
-        ret = inodeStorage_->Update(old, fileNeedDeallocate);
+        ret = inodeStorage_->Update(old, fileNeedDeallocate,
+                                    needUpdateXAttr);
         if (ret != MetaStatusCode::OK) {
             LOG(ERROR) << "UpdateInode fail, " << request.ShortDebugString()
                        << ", ret: " << MetaStatusCode_Name(ret);
@@ -479,7 +484,7 @@ MetaStatusCode InodeManager::UpdateInodeWhenCreateOrRemoveSubNode(
 
     Inode inode;
     MetaStatusCode ret = inodeStorage_->Get(
-        Key4Inode(fsId, inodeId), &inode);
+        Key4Inode(fsId, inodeId), &inode, false);
     if (ret != MetaStatusCode::OK) {
         LOG(ERROR) << "GetInode fail, " << inode.ShortDebugString()
                    << ", ret = " << MetaStatusCode_Name(ret);
@@ -506,7 +511,7 @@ MetaStatusCode InodeManager::UpdateInodeWhenCreateOrRemoveSubNode(
         }
     }
 
-    ret = inodeStorage_->Update(inode);
+    ret = inodeStorage_->Update(inode, false, false);
     if (ret != MetaStatusCode::OK) {
         LOG(ERROR) << "UpdateInode fail, " << inode.ShortDebugString()
                    << ", ret = " << MetaStatusCode_Name(ret);
@@ -36,6 +36,7 @@
 #include "curvefs/src/metaserver/storage/status.h"
 #include "curvefs/src/metaserver/inode_storage.h"
 #include "curvefs/src/metaserver/storage/converter.h"
+#include "curvefs/src/metaserver/storage/utils.h"
 #include "curvefs/src/metaserver/common/types.h"
 
 namespace curvefs {
@@ -56,6 +57,29 @@ using ::curvefs::metaserver::storage::Key4InodeAuxInfo;
 using ::curvefs::metaserver::storage::Key4DeallocatableBlockGroup;
 using ::curvefs::metaserver::storage::Prefix4AllDeallocatableBlockGroup;
 
+namespace {
+
+// the inode record saved in inode table carries no xattr, see
+// InodeStorage::SetXAttr(), but whether the inode has xattrs is recorded
+// if they are saved together, so readers can skip the xattr table
+const Inode& StripXAttr(const Inode& inode, bool saveXAttr, Inode* buffer) {
+    if (!saveXAttr && inode.xattr().empty()) {
+        return inode;
+    }
+    *buffer = inode;
+    buffer->clear_xattr();
+    if (saveXAttr) {
+        buffer->set_hasxattr(!inode.xattr().empty());
+    }
+    return *buffer;
+}
+
+bool MayHaveXAttr(const Inode& record) {
+    return !record.has_hasxattr() || record.hasxattr();
+}
+
+}  // namespace
+
 InodeStorage::InodeStorage(std::shared_ptr<KVStorage> kvStorage,
                            std::shared_ptr<NameGenerator> nameGenerator,
                            uint64_t nInode)
@@ -64,6 +88,7 @@ InodeStorage::InodeStorage(std::shared_ptr<KVStorage> kvStorage,
       table4S3ChunkInfo_(nameGenerator->GetS3ChunkInfoTableName()),
       table4VolumeExtent_(nameGenerator->GetVolumeExtentTableName()),
       table4InodeAuxInfo_(nameGenerator->GetInodeAuxInfoTableName()),
+      table4InodeXAttr_(nameGenerator->GetInodeXAttrTableName()),
       table4DeallocatableInode_(
           nameGenerator->GetDeallocatableInodeTableName()),
       table4DeallocatableBlockGroup_(
@@ -86,7 +111,26 @@ MetaStatusCode InodeStorage::Insert(const Inode& inode) {
     }
 
     // key not found
-    s = kvStorage_->HSet(table4Inode_, skey, inode);
+    if (inode.xattr().empty()) {
+        s = kvStorage_->HSet(table4Inode_, skey,
+                             StripXAttr(inode, true, &out));
+    } else {
+        auto txn = kvStorage_->BeginTransaction();
+        if (nullptr == txn) {
+            return MetaStatusCode::STORAGE_INTERNAL_ERROR;
+        }
+        s = txn->HSet(table4Inode_, skey, StripXAttr(inode, true, &out));
+        if (s.ok()) {
+            s = SetXAttr(txn, skey, inode);
+        }
+        if (s.ok()) {
+            s = txn->Commit();
+        } else if (!txn->Rollback().ok()) {
+            LOG(ERROR) << "rollback transaction failed, inode="
+                       << key.SerializeToString();
+        }
+    }
+
     if (s.ok()) {
         nInode_++;
         return MetaStatusCode::OK;
@@ -95,10 +139,18 @@ MetaStatusCode InodeStorage::Insert(const Inode& inode) {
     return MetaStatusCode::STORAGE_INTERNAL_ERROR;
 }
 
-MetaStatusCode InodeStorage::Get(const Key4Inode& key, Inode* inode) {
+MetaStatusCode InodeStorage::Get(const Key4Inode& key, Inode* inode,
+                                 bool withXAttr) {
     ReadLockGuard lg(rwLock_);
     std::string skey = conv_.SerializeToString(key);
     Status s = kvStorage_->HGet(table4Inode_, skey, inode);
+    if (s.ok() && withXAttr) {
+        if (MayHaveXAttr(*inode)) {
+            s = LoadXAttr(skey, inode->mutable_xattr());
+        }
+        inode->clear_hasxattr();
+    }
+
     if (s.ok()) {
         return MetaStatusCode::OK;
     } else if (s.IsNotFound()) {
@@ -151,14 +203,32 @@ MetaStatusCode InodeStorage::GetAttr(const Key4Inode& key,
     if (inode.xattr_size() > 0) {
         *(attr->mutable_xattr()) = inode.xattr();
     }
+
+    // the client reads xattr (e.g. directory summary) from attribute
+    if (MayHaveXAttr(inode)) {
+        s = LoadXAttr(skey, attr->mutable_xattr());
+        if (!s.ok()) {
+            return MetaStatusCode::STORAGE_INTERNAL_ERROR;
+        }
+    }
     return MetaStatusCode::OK;
 }
 
 MetaStatusCode InodeStorage::GetXAttr(const Key4Inode& key, XAttr *xattr) {
     ReadLockGuard lg(rwLock_);
-    Inode inode;
+    XAttr out;
     std::string skey = conv_.SerializeToString(key);
-    Status s = kvStorage_->HGet(table4Inode_, skey, &inode);
+    Status s = kvStorage_->HGet(table4InodeXAttr_, skey, &out);
+    if (s.ok()) {
+        *(xattr->mutable_xattrinfos()) = out.xattrinfos();
+        return MetaStatusCode::OK;
+    } else if (!s.IsNotFound()) {
+        return MetaStatusCode::STORAGE_INTERNAL_ERROR;
+    }
+
+    // inode without xattr, or the inode not exist
+    Inode inode;
+    s = kvStorage_->HGet(table4Inode_, skey, &inode);
     if (s.IsNotFound()) {
         return MetaStatusCode::NOT_FOUND;
     } else if (!s.ok()) {
@@ -174,7 +244,22 @@ MetaStatusCode InodeStorage::GetXAttr(const Key4Inode& key, XAttr *xattr) {
 MetaStatusCode InodeStorage::Delete(const Key4Inode& key) {
     WriteLockGuard lg(rwLock_);
     std::string skey = conv_.SerializeToString(key);
-    Status s = kvStorage_->HDel(table4Inode_, skey);
+    auto txn = kvStorage_->BeginTransaction();
+    if (nullptr == txn) {
+        return MetaStatusCode::STORAGE_INTERNAL_ERROR;
+    }
+
+    Status s = txn->HDel(table4Inode_, skey);
+    if (s.ok()) {
+        s = txn->HDel(table4InodeXAttr_, skey);
+    }
+    if (s.ok()) {
+        s = txn->Commit();
+    } else if (!txn->Rollback().ok()) {
+        LOG(ERROR) << "rollback transaction failed, inode="
+                   << key.SerializeToString();
+    }
+
     if (s.ok()) {
         // NOTE: for rocksdb storage, it will never check whether
         // the key exist in delete(), so if the client delete the
@@ -189,21 +274,24 @@ MetaStatusCode InodeStorage::Delete(const Key4Inode& key) {
     return MetaStatusCode::STORAGE_INTERNAL_ERROR;
 }
 
-MetaStatusCode InodeStorage::Update(const Inode &inode, bool inodeDeallocate) {
+MetaStatusCode InodeStorage::Update(const Inode &inode, bool inodeDeallocate,
+                                    bool updateXAttr) {
     WriteLockGuard lg(rwLock_);
     Key4Inode key(inode.fsid(), inode.inodeid());
     std::string skey = conv_.SerializeToString(key);
+    Inode buffer;
+    const Inode& attr = StripXAttr(inode, updateXAttr, &buffer);
 
-    // only update inodes
-    if (!inodeDeallocate) {
-        Status s = kvStorage_->HSet(table4Inode_, skey, inode);
+    // only update inode attributes
+    if (!inodeDeallocate && !updateXAttr) {
+        Status s = kvStorage_->HSet(table4Inode_, skey, attr);
         if (s.ok()) {
             return MetaStatusCode::OK;
         }
         return MetaStatusCode::STORAGE_INTERNAL_ERROR;
     }
 
-    // update inode and update deallocatable inode list
+    // update inode with xattr or deallocatable inode list
     google::protobuf::Empty value;
     auto txn = kvStorage_->BeginTransaction();
     if (nullptr == txn) {
@@ -212,8 +300,12 @@ MetaStatusCode InodeStorage::Update(const Inode &inode, bool inodeDeallocate) {
 
     std::string step = "update inode " + key.SerializeToString();
 
-    Status s = txn->HSet(table4Inode_, skey, inode);
-    if (s.ok()) {
+    Status s = txn->HSet(table4Inode_, skey, attr);
+    if (s.ok() && updateXAttr) {
+        s = SetXAttr(txn, skey, inode);
+        step = "update xattr of inode " + key.SerializeToString();
+    }
+    if (s.ok() && inodeDeallocate) {
         s = txn->HSet(table4DeallocatableInode_, skey, value);
         step = "add inode " + key.SerializeToString() +
                " to inode deallocatable list";
@@ -235,6 +327,29 @@ MetaStatusCode InodeStorage::Update(const Inode &inode, bool inodeDeallocate) {
     return MetaStatusCode::OK;
 }
 
+Status InodeStorage::SetXAttr(Transaction txn, const std::string& skey,
+                              const Inode& inode) {
+    if (inode.xattr().empty()) {
+        return txn->HDel(table4InodeXAttr_, skey);
+    }
+
+    XAttr xattr;
+    xattr.set_fsid(inode.fsid());
+    xattr.set_inodeid(inode.inodeid());
+    *(xattr.mutable_xattrinfos()) = inode.xattr();
+    return txn->HSet(table4InodeXAttr_, skey, xattr);
+}
+
+Status InodeStorage::LoadXAttr(const std::string& skey, XAttrMap* xattr) {
+    XAttr out;
+    Status s = kvStorage_->HGet(table4InodeXAttr_, skey, &out);
+    if (s.ok()) {
+        *xattr = out.xattrinfos();
+    } else if (s.IsNotFound()) {
+        return Status::OK();
+    }
+    return s;
+}
 
 std::shared_ptr<Iterator> InodeStorage::GetAllInode() {
     ReadLockGuard lg(rwLock_);
@@ -306,6 +421,96 @@ MetaStatusCode InodeStorage::Clear() {
         return MetaStatusCode::STORAGE_INTERNAL_ERROR;
     }
 
+    s = kvStorage_->HClear(table4InodeXAttr_);
+    if (!s.ok()) {
+        LOG(ERROR) << "InodeStorage clear inode xattr table failed";
+        return MetaStatusCode::STORAGE_INTERNAL_ERROR;
+    }
+
+    return MetaStatusCode::OK;
+}
+
+MetaStatusCode InodeStorage::MigrateLegacyKeys() {
+    WriteLockGuard lg(rwLock_);
+    Inode inode;
+    google::protobuf::Empty empty;
+    S3ChunkInfoList list;
+    VolumeExtentSlice slice;
+    if (!storage::MigrateLegacyKeys(kvStorage_.get(), table4Inode_, false,
+                                    &inode) ||
+        !storage::MigrateLegacyKeys(kvStorage_.get(),
+                                    table4DeallocatableInode_, false,
+                                    &empty) ||
+        !storage::MigrateLegacyKeys(kvStorage_.get(), table4S3ChunkInfo_,
+                                    true, &list) ||
+        !storage::MigrateLegacyKeys(kvStorage_.get(), table4VolumeExtent_,
+                                    true, &slice)) {
+        LOG(ERROR) << "InodeStorage migrate legacy keys failed";
+        return MetaStatusCode::STORAGE_INTERNAL_ERROR;
+    }
+    return MetaStatusCode::OK;
+}
+
+MetaStatusCode InodeStorage::MigrateInodeXAttr() {
+    WriteLockGuard lg(rwLock_);
+    auto iterator = kvStorage_->HGetAll(table4Inode_);
+    if (iterator->Status() != 0) {
+        LOG(ERROR) << "failed to get iterator for all inode";
+        return MetaStatusCode::STORAGE_INTERNAL_ERROR;
+    }
+
+    // collect inodes first, as iterator of memory storage is invalidated
+    // by modification, inodes without xattr are also rewritten to record
+    // that they have none
+    Inode inode;
+    uint64_t count = 0;
+    std::vector<std::pair<std::string, Inode>> inodes;
+    for (iterator->SeekToFirst(); iterator->Valid(); iterator->Next()) {
+        if (!iterator->ParseFromValue(&inode)) {
+            LOG(ERROR) << "failed to parse inode, key = "
+                       << iterator->Key();
+            return MetaStatusCode::PARSE_FROM_STRING_FAILED;
+        } else if (!inode.has_hasxattr()) {
+            count += inode.xattr().empty() ? 0 : 1;
+            inodes.emplace_back(iterator->Key(), inode);
+        }
+    }
+
+    if (inodes.empty()) {
+        return MetaStatusCode::OK;
+    }
+
+    auto txn = kvStorage_->BeginTransaction();
+    if (nullptr == txn) {
+        return MetaStatusCode::STORAGE_INTERNAL_ERROR;
+    }
+
+    Status s;
+    for (const auto& item : inodes) {
+        s = SetXAttr(txn, item.first, item.second);
+        if (s.ok()) {
+            s = txn->HSet(table4Inode_, item.first,
+                          StripXAttr(item.second, true, &inode));
+        }
+        if (!s.ok()) {
+            LOG(ERROR) << "migrate xattr of inode failed, inodeId = "
+                       << item.second.inodeid()
+                       << ", status = " << s.ToString();
+            break;
+        }
+    }
+
+    if (!s.ok()) {
+        if (!txn->Rollback().ok()) {
+            LOG(ERROR) << "rollback transaction failed";
+        }
+        return MetaStatusCode::STORAGE_INTERNAL_ERROR;
+    } else if (!txn->Commit().ok()) {
+        LOG(ERROR) << "commit transaction failed";
+        return MetaStatusCode::STORAGE_INTERNAL_ERROR;
+    }
+
+    LOG(INFO) << "migrated xattr of " << count << " inodes";
     return MetaStatusCode::OK;
 }
 
@@ -54,6 +54,7 @@ using ::curvefs::metaserver::storage::NameGenerator;
 using S3ChunkInfoMap = google::protobuf::Map<uint64_t, S3ChunkInfoList>;
 using DeallocatableBlockGroupVec =
     google::protobuf::RepeatedPtrField<DeallocatableBlockGroup>;
+using XAttrMap = google::protobuf::Map<std::string, std::string>;
 using Transaction = std::shared_ptr<StorageTransaction>;
 
 class InodeStorage {
@@ -73,9 +74,12 @@ class InodeStorage {
      * @brief get inode from storage
      * @param[in] key: the key of inode want to get
      * @param[out] inode: the inode got
+     * @param[in] withXAttr: whether to get the extended attributes,
+     *                       which are saved apart from the inode
      * @return If inode not exist, return NOT_FOUND; else return OK
      */
-    MetaStatusCode Get(const Key4Inode& key, Inode* inode);
+    MetaStatusCode Get(const Key4Inode& key, Inode* inode,
+                       bool withXAttr = true);
 
     /**
      * @brief get inode attribute from storage
@@ -104,10 +108,14 @@ class InodeStorage {
      * @brief update inode from storage
      * @param[in] inode: the inode want to update
      * @param[in] inodeDeallocate: Whether the inode needs to deallocate space
+     * @param[in] updateXAttr: Whether to replace the extended attributes with
+     *                         the ones in inode, otherwise keep them as is
      * @return If inode not exist, return NOT_FOUND; else replace and return OK
      */
-    MetaStatusCode Update(const Inode& inode, bool inodeDeallocate = false);
+    MetaStatusCode Update(const Inode& inode, bool inodeDeallocate = false,
+                          bool updateXAttr = true);
 
+    // NOTE: the inodes iterated carry no extended attributes
     std::shared_ptr<Iterator> GetAllInode();
 
     bool GetAllInodeId(std::list<uint64_t>* ids);
@@ -121,6 +129,13 @@ class InodeStorage {
 
     MetaStatusCode Clear();
 
+    // rewrite keys saved by previous versions into current format
+    MetaStatusCode MigrateLegacyKeys();
+
+    // move extended attributes saved inside inode by previous versions
+    // into xattr table
+    MetaStatusCode MigrateInodeXAttr();
+
     // s3chunkinfo
     MetaStatusCode ModifyInodeS3ChunkInfoList(uint32_t fsId,
                                               uint64_t inodeId,
@@ -167,6 +182,13 @@ class InodeStorage {
         std::vector<DeallocatableBlockGroup> *deallocatableBlockGroupVec);
 
  private:
+    // extended attributes are saved in xattr table rather than inside
+    // the inode, so that the inode stays small for attribute updates
+    storage::Status SetXAttr(Transaction txn, const std::string& skey,
+                             const Inode& inode);
+
+    storage::Status LoadXAttr(const std::string& skey, XAttrMap* xattr);
+
     MetaStatusCode UpdateInodeS3MetaSize(Transaction txn, uint32_t fsId,
                                          uint64_t inodeId, uint64_t size4add,
                                          uint64_t size4del);
@@ -203,6 +225,7 @@ class InodeStorage {
     std::string table4S3ChunkInfo_;
     std::string table4VolumeExtent_;
     std::string table4InodeAuxInfo_;
+    std::string table4InodeXAttr_;
     std::string table4DeallocatableBlockGroup_;
     std::string table4DeallocatableInode_;
 
@@ -700,6 +700,27 @@ void Metaserver::InitCopysetNodeOptions() {
                 &copysetNodeOptions_.applyQueueOption.rconcurrentsize));
     LOG_IF(FATAL, !conf_->GetIntValue("applyqueue.read_queue_depth",
                 &copysetNodeOptions_.applyQueueOption.rqueuedepth));
+    ret = conf_->GetBoolValue("applyqueue.lock_free_queue",
+                &copysetNodeOptions_.applyQueueOption.lockfreequeue);
+    LOG_IF(WARNING, ret == false)
+        << "config no applyqueue.lock_free_queue info, using default value "
+        << copysetNodeOptions_.applyQueueOption.lockfreequeue;
+    ret = conf_->GetUInt32Value("copyset.propose_batch_size",
+                &copysetNodeOptions_.proposeBatchSize);
+    LOG_IF(WARNING, ret == false)
+        << "config no copyset.propose_batch_size info, using default value "
+        << copysetNodeOptions_.proposeBatchSize;
+    ret = conf_->GetUInt32Value("copyset.propose_batch_wait_us",
+                &copysetNodeOptions_.proposeBatchWaitUs);
+    LOG_IF(WARNING, ret == false)
+        << "config no copyset.propose_batch_wait_us info, using default value "
+        << copysetNodeOptions_.proposeBatchWaitUs;
+    ret = conf_->GetBoolValue("copyset.raft_filter_before_copy_remote",
+        &copysetNodeOptions_.raftNodeOptions.filter_before_copy_remote);
+    LOG_IF(WARNING, ret == false)
+        << "config no copyset.raft_filter_before_copy_remote info, "
+           "using default value "
+        << copysetNodeOptions_.raftNodeOptions.filter_before_copy_remote;
     LOG_IF(FATAL, !conf_->GetStringValue("copyset.trash.uri",
                 &copysetNodeOptions_.trashOptions.trashUri));
     LOG_IF(FATAL, !conf_->GetUInt32Value("copyset.trash.expired_aftersec",
@@ -35,6 +35,7 @@ namespace metaserver {
 
 using ::curvefs::metaserver::copyset::GetDentryOperator;
 using ::curvefs::metaserver::copyset::ListDentryOperator;
+using ::curvefs::metaserver::copyset::ListDentryPlusOperator;
 using ::curvefs::metaserver::copyset::CreateDentryOperator;
 using ::curvefs::metaserver::copyset::DeleteDentryOperator;
 using ::curvefs::metaserver::copyset::GetInodeOperator;
@@ -123,6 +124,17 @@ void MetaServerServiceImpl::ListDentry(
                                           request->copysetid());
 }
 
+void MetaServerServiceImpl::ListDentryPlus(
+    ::google::protobuf::RpcController* controller,
+    const ::curvefs::metaserver::ListDentryPlusRequest* request,
+    ::curvefs::metaserver::ListDentryPlusResponse* response,
+    ::google::protobuf::Closure* done) {
+    OperatorHelper helper(copysetNodeManager_, inflightThrottle_);
+    helper.operator()<ListDentryPlusOperator>(controller, request, response,
+                                              done, request->poolid(),
+                                              request->copysetid());
+}
+
 void MetaServerServiceImpl::CreateDentry(
     ::google::protobuf::RpcController* controller,
     const ::curvefs::metaserver::CreateDentryRequest* request,
@@ -50,6 +50,11 @@ class MetaServerServiceImpl : public MetaServerService {
                     const ::curvefs::metaserver::ListDentryRequest* request,
                     ::curvefs::metaserver::ListDentryResponse* response,
                     ::google::protobuf::Closure* done) override;
+    void ListDentryPlus(
+        ::google::protobuf::RpcController* controller,
+        const ::curvefs::metaserver::ListDentryPlusRequest* request,
+        ::curvefs::metaserver::ListDentryPlusResponse* response,
+        ::google::protobuf::Closure* done) override;
     void CreateDentry(::google::protobuf::RpcController* controller,
                       const ::curvefs::metaserver::CreateDentryRequest* request,
                       ::curvefs::metaserver::CreateDentryResponse* response,
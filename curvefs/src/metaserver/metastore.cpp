@@ -21,6 +21,7 @@
  */
 #include "curvefs/src/metaserver/metastore.h"
 
+#include <braft/local_file_meta.pb.h>
 #include <braft/storage.h>
 #include <glog/logging.h>
 #include <sys/types.h>
@@ -55,13 +56,14 @@ namespace metaserver {
 
 using ::curve::common::ReadLockGuard;
 using ::curve::common::WriteLockGuard;
-using ::curvefs::metaserver::storage::DumpFileClosure;
+using ::curvefs::metaserver::storage::CheckpointFile;
 using KVStorage = ::curvefs::metaserver::storage::KVStorage;
 using Key4S3ChunkInfoList = ::curvefs::metaserver::storage::Key4S3ChunkInfoList;
 
 using ::curvefs::metaserver::storage::MemoryStorage;
 using ::curvefs::metaserver::storage::RocksDBStorage;
 using ::curvefs::metaserver::storage::StorageOptions;
+using STORAGE_TYPE = ::curvefs::metaserver::storage::KVStorage::STORAGE_TYPE;
 
 namespace {
 const char *const kMetaDataFilename = "metadata";
@@ -136,26 +138,62 @@ bool MetaStoreImpl::Load(const std::string &pathname) {
         return false;
     }
 
+    // storage checkpoint of a previous version has keys in text format,
+    // and extended attributes inside inodes
+    for (auto &part : partitionMap_) {
+        if (version <= storage::kDumpFileV3 &&
+            !part.second->MigrateLegacyKeys()) {
+            LOG(ERROR) << "Failed to migrate keys of partition "
+                       << part.first;
+            return false;
+        }
+        if (version <= storage::kDumpFileV4 &&
+            !part.second->MigrateInodeXAttr()) {
+            LOG(ERROR) << "Failed to migrate inode xattr of partition "
+                       << part.first;
+            return false;
+        }
+    }
+
     startCompacts();
     return true;
 }
 
-void MetaStoreImpl::SaveBackground(const std::string &path,
-                                   DumpFileClosure *child,
-                                   OnSnapshotSaveDoneClosure *done) {
-    LOG(INFO) << "Save metadata to file background.";
-    MetaStoreFStream fstream(&partitionMap_, kvStorage_,
-                             copysetNode_->GetPoolId(),
-                             copysetNode_->GetCopysetId());
-    bool succ = fstream.Save(path, child);
-    LOG(INFO) << "Save metadata to file " << (succ ? "success" : "fail");
+bool MetaStoreImpl::CheckpointStorage(std::shared_ptr<KVStorage> storage,
+                                      const std::string &dir,
+                                      OnSnapshotSaveDoneClosure *done) {
+    brpc::ClosureGuard doneGuard(done);
 
-    if (succ) {
-        done->SetSuccess();
-    } else {
+    butil::Timer timer;
+    timer.start();
+    std::vector<CheckpointFile> files;
+    bool succ = storage->Checkpoint(dir, &files);
+    if (!succ) {
         done->SetError(MetaStatusCode::SAVE_META_FAIL);
+        return false;
     }
-    done->Run();
+
+    timer.stop();
+    g_storage_checkpoint_latency << timer.u_elapsed();
+
+    // add files to snapshot writer
+    // file is a relative path under the given directory
+    auto *writer = done->GetSnapshotWriter();
+    writer->add_file(kMetaDataFilename);
+
+    // with checksum, follower keeps the files it already has in its last
+    // snapshot instead of copying them from leader again while installing
+    // snapshot, see also `filter_before_copy_remote` of braft
+    for (const auto &f : files) {
+        braft::LocalFileMeta meta;
+        if (!f.checksum.empty()) {
+            meta.set_checksum(f.checksum);
+        }
+        writer->add_file(f.filename, &meta);
+    }
+
+    done->SetSuccess();
+    return true;
 }
 
 bool MetaStoreImpl::Save(const std::string &dir,
@@ -174,30 +212,17 @@ bool MetaStoreImpl::Save(const std::string &dir,
         return false;
     }
 
-    // checkpoint storage
-    butil::Timer timer;
-    timer.start();
-    std::vector<std::string> files;
-    succ = kvStorage_->Checkpoint(dir, &files);
-    if (!succ) {
-        done->SetError(MetaStatusCode::SAVE_META_FAIL);
-        return false;
-    }
-
-    timer.stop();
-    g_storage_checkpoint_latency << timer.u_elapsed();
-
-    // add files to snapshot writer
-    // file is a relative path under the given directory
-    auto *writer = done->GetSnapshotWriter();
-    writer->add_file(kMetaDataFilename);
-
-    for (const auto &f : files) {
-        writer->add_file(f);
+    // snapshot of memory storage costs O(1), and the following modifications
+    // don't affect it, so dump it in background to avoid blocking the apply
+    if (kvStorage_->Type() == STORAGE_TYPE::MEMORY_STORAGE) {
+        auto storage = std::static_pointer_cast<MemoryStorage>(kvStorage_);
+        std::thread(&MetaStoreImpl::CheckpointStorage, storage->Snapshot(),
+                    dir, doneGuard.release())
+            .detach();
+        return true;
     }
 
-    done->SetSuccess();
-    return true;
+    return CheckpointStorage(kvStorage_, dir, doneGuard.release());
 }
 
 bool MetaStoreImpl::ClearInternal() {
@@ -445,6 +470,53 @@ MetaStatusCode MetaStoreImpl::ListDentry(const ListDentryRequest *request,
     return rc;
 }
 
+MetaStatusCode
+MetaStoreImpl::ListDentryPlus(const ListDentryPlusRequest *request,
+                              ListDentryPlusResponse *response) {
+    uint32_t fsId = request->fsid();
+    ReadLockGuard readLockGuard(rwLock_);
+    std::shared_ptr<Partition> partition;
+    GET_PARTITION_OR_RETURN(partition);
+
+    Dentry dentry;
+    dentry.set_fsid(fsId);
+    dentry.set_parentinodeid(request->dirinodeid());
+    dentry.set_txid(request->txid());
+    if (request->has_last()) {
+        dentry.set_name(request->last());
+    }
+
+    std::vector<Dentry> dentrys;
+    auto rc = partition->ListDentry(dentry, &dentrys, request->count(), false);
+    if (rc != MetaStatusCode::OK) {
+        response->set_statuscode(rc);
+        return rc;
+    }
+
+    // attributes of inodes in other partitions are left to the client
+    std::unordered_set<uint64_t> inodeIds;
+    for (const auto &d : dentrys) {
+        uint64_t inodeId = d.inodeid();
+        if (!partition->IsInodeBelongs(fsId, inodeId) ||
+            !inodeIds.insert(inodeId).second) {
+            continue;
+        }
+        InodeAttr attr;
+        rc = partition->GetInodeAttr(fsId, inodeId, &attr);
+        if (rc == MetaStatusCode::OK) {
+            *response->add_attr() = std::move(attr);
+        } else if (rc != MetaStatusCode::NOT_FOUND) {
+            response->clear_attr();
+            response->set_statuscode(rc);
+            return rc;
+        }
+    }
+
+    *response->mutable_dentrys() = {dentrys.begin(), dentrys.end()};
+    response->set_statuscode(MetaStatusCode::OK);
+    return MetaStatusCode::OK;
+}
+
 MetaStatusCode
 MetaStoreImpl::PrepareRenameTx(const PrepareRenameTxRequest *request,
                                PrepareRenameTxResponse *response) {
@@ -809,6 +881,36 @@ MetaStatusCode MetaStoreImpl::UpdateDeallocatableBlockGroup(
     return st;
 }
 
+bool MetaStoreImpl::BeginBatch() {
+    ReadLockGuard guard(rwLock_);
+    if (kvStorage_ == nullptr) {
+        return false;
+    }
+
+    auto s = kvStorage_->BeginBatch();
+    if (s.IsNotSupported()) {
+        return false;
+    } else if (!s.ok()) {
+        LOG(ERROR) << "Begin batch failed, status = " << s.ToString();
+        return false;
+    }
+    return true;
+}
+
+bool MetaStoreImpl::CommitBatch() {
+    ReadLockGuard guard(rwLock_);
+    if (kvStorage_ == nullptr) {
+        return false;
+    }
+
+    auto s = kvStorage_->CommitBatch();
+    if (!s.ok()) {
+        LOG(ERROR) << "Commit batch failed, status = " << s.ToString();
+        return false;
+    }
+    return true;
+}
+
 bool MetaStoreImpl::InitStorage() {
     if (storageOptions_.type == "memory") {
         kvStorage_ = std::make_shared<MemoryStorage>(storageOptions_);
@@ -49,6 +49,8 @@ using curvefs::metaserver::GetDentryRequest;
 using curvefs::metaserver::GetDentryResponse;
 using curvefs::metaserver::ListDentryRequest;
 using curvefs::metaserver::ListDentryResponse;
+using curvefs::metaserver::ListDentryPlusRequest;
+using curvefs::metaserver::ListDentryPlusResponse;
 using curvefs::metaserver::CreateDentryRequest;
 using curvefs::metaserver::CreateDentryResponse;
 using curvefs::metaserver::DeleteDentryRequest;
@@ -141,6 +143,10 @@ class MetaStore {
     virtual MetaStatusCode ListDentry(const ListDentryRequest* request,
                                       ListDentryResponse* response) = 0;
 
+    virtual MetaStatusCode ListDentryPlus(
+        const ListDentryPlusRequest* request,
+        ListDentryPlusResponse* response) = 0;
+
     virtual MetaStatusCode PrepareRenameTx(
         const PrepareRenameTxRequest* request,
         PrepareRenameTxResponse* response) = 0;
@@ -193,6 +199,14 @@ class MetaStore {
     virtual MetaStatusCode UpdateDeallocatableBlockGroup(
         const UpdateDeallocatableBlockGroupRequest *request,
         UpdateDeallocatableBlockGroupResponse *response) = 0;
+
+    // batch, storage writes of the calling thread between BeginBatch() and
+    // CommitBatch() are committed together, see KVStorage::BeginBatch().
+    // BeginBatch() returns false if the storage doesn't support it, then
+    // every write is committed on its own
+    virtual bool BeginBatch() = 0;
+
+    virtual bool CommitBatch() = 0;
 };
 
 class MetaStoreImpl : public MetaStore {
@@ -234,6 +248,9 @@ class MetaStoreImpl : public MetaStore {
     MetaStatusCode ListDentry(const ListDentryRequest* request,
                               ListDentryResponse* response) override;
 
+    MetaStatusCode ListDentryPlus(const ListDentryPlusRequest* request,
+                                  ListDentryPlusResponse* response) override;
+
     MetaStatusCode PrepareRenameTx(const PrepareRenameTxRequest* request,
                                    PrepareRenameTxResponse* response) override;
 
@@ -286,14 +303,19 @@ class MetaStoreImpl : public MetaStore {
         const UpdateDeallocatableBlockGroupRequest *request,
         UpdateDeallocatableBlockGroupResponse *response) override;
 
+    // batch
+    bool BeginBatch() override;
+
+    bool CommitBatch() override;
+
  private:
     FRIEND_TEST(MetastoreTest, partition);
     FRIEND_TEST(MetastoreTest, test_inode);
     FRIEND_TEST(MetastoreTest, test_dentry);
     FRIEND_TEST(MetastoreTest, persist_success);
     FRIEND_TEST(MetastoreTest, DISABLED_persist_deleting_partition_success);
-    FRIEND_TEST(MetastoreTest, persist_partition_fail);
-    FRIEND_TEST(MetastoreTest, persist_dentry_fail);
+    FRIEND_TEST(MetastoreTest, persist_partition_with_memory_storage);
+    FRIEND_TEST(MetastoreTest, persist_dentry_with_memory_storage);
     FRIEND_TEST(MetastoreTest, testBatchGetInodeAttr);
     FRIEND_TEST(MetastoreTest, testBatchGetXAttr);
     FRIEND_TEST(MetastoreTest, GetOrModifyS3ChunkInfo);
@@ -308,9 +330,10 @@ class MetaStoreImpl : public MetaStore {
                              uint64_t chunkIndex,
                              const std::string& value);
 
-    void SaveBackground(const std::string& path,
-                        DumpFileClosure* child,
-                        OnSnapshotSaveDoneClosure* done);
+    // Checkpoint the storage to the snapshot directory, and run the done
+    static bool CheckpointStorage(std::shared_ptr<KVStorage> storage,
+                                  const std::string& dir,
+                                  OnSnapshotSaveDoneClosure* done);
 
     bool InitStorage();
 
@@ -46,7 +46,6 @@ using ::curvefs::metaserver::storage::LoadFromFile;
 using ::curvefs::metaserver::storage::SaveToFile;
 
 using ContainerType = std::unordered_map<std::string, std::string>;
-using STORAGE_TYPE = ::curvefs::metaserver::storage::KVStorage::STORAGE_TYPE;
 using ChildrenType =
     ::curvefs::metaserver::storage::MergeIterator::ChildrenType;  // NOLINT
 using DumpFileClosure = ::curvefs::metaserver::storage::DumpFileClosure;
@@ -403,8 +402,9 @@ bool MetaStoreFStream::Save(const std::string &path, DumpFileClosure *done) {
     }
 
     auto mergeIterator = std::make_shared<MergeIterator>(children);
-    bool background = (kvStorage_->Type() == STORAGE_TYPE::MEMORY_STORAGE);
-    bool succ = SaveToFile(path, mergeIterator, background, done);
+    // the metadata file only contains partitions and pending transactions,
+    // the data of storage is saved by its checkpoint, so no need to fork
+    bool succ = SaveToFile(path, mergeIterator, false, done);
     if (succ) {
         LOG(INFO) << "MetaStoreFStream save success";
     } else {
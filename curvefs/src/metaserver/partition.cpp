@@ -394,6 +394,29 @@ bool Partition::Clear() {
     return true;
 }
 
+bool Partition::MigrateLegacyKeys() {
+    if (inodeStorage_->MigrateLegacyKeys() != MetaStatusCode::OK) {
+        LOG(ERROR) << "Migrate inode storage failed";
+        return false;
+    } else if (dentryStorage_->MigrateLegacyKeys() != MetaStatusCode::OK) {
+        LOG(ERROR) << "Migrate dentry storage failed";
+        return false;
+    }
+
+    LOG(INFO) << "Migrate legacy keys of partition "
+              << partitionInfo_.partitionid() << " success";
+    return true;
+}
+
+bool Partition::MigrateInodeXAttr() {
+    if (inodeStorage_->MigrateInodeXAttr() != MetaStatusCode::OK) {
+        LOG(ERROR) << "Migrate inode xattr of partition "
+                   << partitionInfo_.partitionid() << " failed";
+        return false;
+    }
+    return true;
+}
+
 uint64_t Partition::GetNewInodeId() {
     if (partitionInfo_.nextid() > partitionInfo_.end()) {
         partitionInfo_.set_status(PartitionStatus::READONLY);
@@ -195,6 +195,13 @@ class Partition {
 
     bool Clear();
 
+    // rewrite storage keys saved by previous versions into current format
+    bool MigrateLegacyKeys();
+
+    // move extended attributes saved inside inodes by previous versions
+    // into their own table
+    bool MigrateInodeXAttr();
+
     void SetManageFlag(bool flag) { partitionInfo_.set_manageflag(flag); }
 
     bool GetManageFlag() {
@@ -166,7 +166,7 @@ CompactInodeJob::BuildValidList(const S3ChunkInfoList& s3chunkinfolist,
         const auto& info = s3chunkinfolist.s3chunks(v.second.second);
         validList.emplace_back(v.first, v.second.first, info.chunkid(),
                                info.compaction(), info.offset(), info.len(),
-                               info.zero());
+                               info.zero(), info.compressed());
     }
 
     return validList;
@@ -206,20 +206,23 @@ void CompactInodeJob::GenS3ReadRequests(
                 // all what we need is only part of block
                 reqs->emplace_back(reqIndex++, false, std::move(objName),
                                    curr->begin - s3objBegin,
-                                   curr->end - curr->begin + 1);
+                                   curr->end - curr->begin + 1,
+                                   curr->compressed);
             } else if (curr->begin >= s3objBegin && curr->end > s3objEnd) {
                 // not last block, what we need is part of block
                 reqs->emplace_back(reqIndex++, false, std::move(objName),
                                    curr->begin - s3objBegin,
-                                   s3objEnd - curr->begin + 1);
+                                   s3objEnd - curr->begin + 1,
+                                   curr->compressed);
             } else if (curr->begin < s3objBegin && curr->end > s3objEnd) {
                 // what we need is full block
                 reqs->emplace_back(reqIndex++, false, std::move(objName), 0,
-                                   blockSize);
+                                   blockSize, curr->compressed);
             } else if (curr->begin < s3objBegin && curr->end <= s3objEnd) {
                 // last block, what we need is part of block
                 reqs->emplace_back(reqIndex++, false, std::move(objName), 0,
-                                   curr->end - s3objBegin + 1);
+                                   curr->end - s3objBegin + 1,
+                                   curr->compressed);
                 break;
             }
         }
@@ -298,6 +301,16 @@ int CompactInodeJob::ReadFullChunk(
                     std::chrono::seconds(retryInterval));
                 continue;
             }
+            // all requests of an object share the same flag
+            if (reqs.front()->compressed) {
+                std::string raw;
+                if (!S3ObjectCodec::Decode(ctx.blockSize, buf, &raw)) {
+                    LOG(WARNING)
+                        << "s3compact: decode s3 obj " << objName << " failed";
+                    return -1;
+                }
+                buf.swap(raw);
+            }
             for (const auto& req : reqs) {
                 readContent[req->reqIndex] = buf.substr(req->off, req->len);
             }
@@ -359,9 +372,19 @@ int CompactInodeJob::WriteFullChunk(
             newOff + chunkLen - 1, offRoundDown + (index + 1) * blockSize - 1);
         VLOG(9) << "s3compact: put " << objName << ", [" << s3objBegin << "-"
                 << s3objEnd << "]";
-        ret = ctx.s3adapter->PutObject(
-            aws_key,
-            fullChunk.substr(s3objBegin - newOff, s3objEnd - s3objBegin + 1));
+        std::string obj =
+            fullChunk.substr(s3objBegin - newOff, s3objEnd - s3objBegin + 1);
+        if (ctx.objectCodec != curvefs::common::CODEC_NONE) {
+            std::string encoded;
+            if (!S3ObjectCodec::Encode(ctx.objectCodec, blockSize, obj.data(),
+                                       obj.size(), &encoded)) {
+                LOG(WARNING) << "s3compact: encode s3 object " << objName
+                             << " failed";
+                return -1;
+            }
+            obj.swap(encoded);
+        }
+        ret = ctx.s3adapter->PutObject(aws_key, obj);
         if (ret != 0) {
             LOG(WARNING) << "s3compact: put s3 object " << objName << " failed";
             return ret;
@@ -406,10 +429,11 @@ bool CompactInodeJob::CompactPrecheck(const struct S3CompactTask& task,
 }
 
 S3Adapter* CompactInodeJob::SetupS3Adapter(uint64_t fsId,
-                                                  uint64_t* s3adapterIndex,
-                                                  uint64_t* blockSize,
-                                                  uint64_t* chunkSize,
-                                                  uint32_t* objectPrefix) {
+                                           uint64_t* s3adapterIndex,
+                                           uint64_t* blockSize,
+                                           uint64_t* chunkSize,
+                                           uint32_t* objectPrefix,
+                                           ObjectCodecType* objectCodec) {
     auto pairResult = opts_->s3adapterManager->GetS3Adapter();
     *s3adapterIndex = pairResult.first;
     auto s3adapter = pairResult.second;
@@ -424,6 +448,7 @@ S3Adapter* CompactInodeJob::SetupS3Adapter(uint64_t fsId,
         *blockSize = s3info.blocksize();
         *chunkSize = s3info.chunksize();
         *objectPrefix = s3info.objectprefix();
+        *objectCodec = s3info.objectcodec();
         if (s3adapter->GetS3Ak() != s3info.ak() ||
             s3adapter->GetS3Sk() != s3info.sk() ||
             s3adapter->GetS3Endpoint() != s3info.endpoint()) {
@@ -513,6 +538,9 @@ void CompactInodeJob::CompactChunk(
     toAdd.set_len(fullChunk.length());
     toAdd.set_size(fullChunk.length());
     toAdd.set_zero(false);
+    if (compactCtx.objectCodec != curvefs::common::CODEC_NONE) {
+        toAdd.set_compressed(true);
+    }
     *toAddList.add_s3chunks() = std::move(toAdd);
     s3ChunkInfoAdd->insert({index, std::move(toAddList)});
     // to remove
@@ -559,8 +587,10 @@ void CompactInodeJob::CompactChunks(const S3CompactTask& task) {
     uint64_t chunkSize;
     uint64_t s3adapterIndex;
     uint32_t objectPrefix;
-    S3Adapter* s3adapter = SetupS3Adapter(task.inodeKey.fsId, &s3adapterIndex,
-                                        &blockSize, &chunkSize, &objectPrefix);
+    ObjectCodecType objectCodec;
+    S3Adapter* s3adapter =
+        SetupS3Adapter(task.inodeKey.fsId, &s3adapterIndex, &blockSize,
+                       &chunkSize, &objectPrefix, &objectCodec);
     if (s3adapter == nullptr) return;
     // need compact?
     std::vector<uint64_t> needCompact =
@@ -574,7 +604,7 @@ void CompactInodeJob::CompactChunks(const S3CompactTask& task) {
     // 1. read full chunk & write new objs, each chunk one by one
     struct S3CompactCtx compactCtx {
         task.inodeKey.inodeId, task.inodeKey.fsId, task.pinfo, blockSize,
-            chunkSize, s3adapterIndex, objectPrefix, s3adapter
+            chunkSize, s3adapterIndex, objectPrefix, s3adapter, objectCodec
     };
     std::unordered_map<uint64_t, std::vector<std::string>> objsAddedMap;
     ::google::protobuf::Map<uint64_t, S3ChunkInfoList> s3ChunkInfoAdd;
@@ -34,6 +34,7 @@
 #include <utility>
 #include <vector>
 
+#include "curvefs/src/common/s3_object_codec.h"
 #include "curvefs/src/metaserver/copyset/copyset_node.h"
 #include "curvefs/src/metaserver/inode_storage.h"
 #include "curvefs/src/metaserver/s3compact_manager.h"
@@ -46,6 +47,8 @@ using curve::common::InitS3AdaptorOptionExceptS3InfoOption;
 using curve::common::S3Adapter;
 using curve::common::S3AdapterOption;
 using curve::common::TaskThreadPool;
+using curvefs::common::ObjectCodecType;
+using curvefs::common::S3ObjectCodec;
 using curvefs::metaserver::copyset::CopysetNode;
 using curvefs::metaserver::copyset::CopysetNodeManager;
 
@@ -100,6 +103,8 @@ class CompactInodeJob {
         uint64_t s3adapterIndex;
         uint32_t objectPrefix;
         S3Adapter* s3adapter;
+        // codec of the objects written by compaction
+        ObjectCodecType objectCodec;
     };
 
     struct S3NewChunkInfo {
@@ -114,14 +119,16 @@ class CompactInodeJob {
         std::string objName;
         uint64_t off;
         uint64_t len;
+        bool compressed;
 
         S3Request(uint64_t reqIndex, bool zero, std::string objName,
-                  uint64_t off, uint64_t len)
+                  uint64_t off, uint64_t len, bool compressed = false)
             : reqIndex(reqIndex),
               zero(zero),
               objName(std::move(objName)),
               off(off),
-              len(len) {}
+              len(len),
+              compressed(compressed) {}
     };
 
     // node for building valid list
@@ -133,16 +140,18 @@ class CompactInodeJob {
         uint64_t chunkoff;
         uint64_t chunklen;
         bool zero;
+        bool compressed;
         Node(uint64_t begin, uint64_t end, uint64_t chunkid,
              uint64_t compaction, uint64_t chunkoff, uint64_t chunklen,
-             bool zero)
+             bool zero, bool compressed = false)
             : begin(begin),
               end(end),
               chunkid(chunkid),
               compaction(compaction),
               chunkoff(chunkoff),
               chunklen(chunklen),
-              zero(zero) {}
+              zero(zero),
+              compressed(compressed) {}
     };
 
     // closure for updating inode, simply wait
@@ -172,7 +181,8 @@ class CompactInodeJob {
     bool CompactPrecheck(const struct S3CompactTask& task, Inode* inode);
     S3Adapter* SetupS3Adapter(uint64_t fsid, uint64_t* s3adapterIndex,
                               uint64_t* blockSize, uint64_t* chunkSize,
-                              uint32_t* objectPrefix);
+                              uint32_t* objectPrefix,
+                              ObjectCodecType* objectCodec);
     void DeleteObjs(const std::vector<std::string>& objsAdded,
                     S3Adapter* s3adapter);
     std::list<struct Node> BuildValidList(
@@ -22,6 +22,7 @@
 
 #include <inttypes.h>
 #include <glog/logging.h>
+#include <butil/sys_byteorder.h>
 
 #include <cstring>
 #include <string>
@@ -61,7 +62,8 @@ NameGenerator::NameGenerator(uint32_t partitionId)
       tableName4S3ChunkInfo_(Format(kTypeS3ChunkInfo, partitionId)),
       tableName4Dentry_(Format(kTypeDentry, partitionId)),
       tableName4VolumeExtent_(Format(kTypeVolumeExtent, partitionId)),
-      tableName4InodeAuxInfo_(Format(kTypeInodeAuxInfo, partitionId)) {}
+      tableName4InodeAuxInfo_(Format(kTypeInodeAuxInfo, partitionId)),
+      tableName4InodeXAttr_(Format(kTypeInodeXAttr, partitionId)) {}
 
 std::string NameGenerator::GetInodeTableName() const {
     return tableName4Inode_;
@@ -91,6 +93,10 @@ std::string NameGenerator::GetInodeAuxInfoTableName() const {
     return tableName4InodeAuxInfo_;
 }
 
+std::string NameGenerator::GetInodeXAttrTableName() const {
+    return tableName4InodeXAttr_;
+}
+
 size_t NameGenerator::GetFixedLength() {
     size_t length = sizeof(kTypeInode) + sizeof(uint32_t) + strlen(kDelimiter);
     LOG(INFO) << "Tablename fixed length is " << length;
@@ -105,6 +111,109 @@ std::string NameGenerator::Format(KEY_TYPE type, uint32_t partitionId) {
         absl::string_view(buf, sizeof(buf)));
 }
 
+bool IsTextKey(const std::string& key) {
+    return !key.empty() && key[0] != kBinaryKeyVersion;
+}
+
+namespace {
+
+// version + type + fsId + at most 5 uint64 fields
+constexpr size_t kMaxBinaryKeyLength =
+    2 + sizeof(uint32_t) + 5 * sizeof(uint64_t);
+
+// Encode a binary key into a buffer on stack
+class KeyEncoder {
+ public:
+    explicit KeyEncoder(KEY_TYPE type) : pos_(buf_) {
+        *pos_++ = kBinaryKeyVersion;
+        *pos_++ = static_cast<char>(type);
+    }
+
+    KeyEncoder& Put32(uint32_t value) {
+        value = butil::HostToNet32(value);
+        std::memcpy(pos_, &value, sizeof(value));
+        pos_ += sizeof(value);
+        return *this;
+    }
+
+    KeyEncoder& Put64(uint64_t value) {
+        value = butil::HostToNet64(value);
+        std::memcpy(pos_, &value, sizeof(value));
+        pos_ += sizeof(value);
+        return *this;
+    }
+
+    std::string ToString() const {
+        return std::string(buf_, pos_ - buf_);
+    }
+
+    std::string ToString(const std::string& suffix) const {
+        return absl::StrCat(absl::string_view(buf_, pos_ - buf_), suffix);
+    }
+
+ private:
+    char buf_[kMaxBinaryKeyLength];
+    char* pos_;
+};
+
+// Decode a binary key in place
+class KeyDecoder {
+ public:
+    KeyDecoder(const std::string& key, KEY_TYPE type)
+        : data_(key.data()), left_(key.size()) {
+        valid_ = left_ >= 2 && data_[0] == kBinaryKeyVersion &&
+                 data_[1] == static_cast<char>(type);
+        if (valid_) {
+            data_ += 2;
+            left_ -= 2;
+        }
+    }
+
+    bool Get32(uint32_t* value) {
+        if (!valid_ || left_ < sizeof(*value)) {
+            return false;
+        }
+        std::memcpy(value, data_, sizeof(*value));
+        *value = butil::NetToHost32(*value);
+        data_ += sizeof(*value);
+        left_ -= sizeof(*value);
+        return true;
+    }
+
+    bool Get64(uint64_t* value) {
+        if (!valid_ || left_ < sizeof(*value)) {
+            return false;
+        }
+        std::memcpy(value, data_, sizeof(*value));
+        *value = butil::NetToHost64(*value);
+        data_ += sizeof(*value);
+        left_ -= sizeof(*value);
+        return true;
+    }
+
+    // take all the remaining bytes
+    bool GetRest(std::string* value) {
+        if (!valid_) {
+            return false;
+        }
+        value->assign(data_, left_);
+        data_ += left_;
+        left_ = 0;
+        return true;
+    }
+
+    bool Done() const {
+        return valid_ && left_ == 0;
+    }
+
+ private:
+    const char* data_;
+    size_t left_;
+    bool valid_;
+};
+
+}  // namespace
+
 Key4Inode::Key4Inode()
     : fsId(0), inodeId(0) {}
 
@@ -119,29 +228,29 @@ bool Key4Inode::operator==(const Key4Inode& rhs) {
 }
 
 std::string Key4Inode::SerializeToString() const {
-    return absl::StrCat(keyType_, ":", fsId, ":", inodeId);
+    return KeyEncoder(keyType_).Put32(fsId).Put64(inodeId).ToString();
 }
 
 bool Key4Inode::ParseFromString(const std::string& value) {
-    std::vector<std::string> items;
-    SplitString(value, ":", &items);
-    return items.size() == 3 && CompareType(items[0], keyType_) &&
-        StringToUl(items[1], &fsId) && StringToUll(items[2], &inodeId);
+    if (IsTextKey(value)) {
+        std::vector<std::string> items;
+        SplitString(value, ":", &items);
+        return items.size() == 3 && CompareType(items[0], keyType_) &&
+            StringToUl(items[1], &fsId) && StringToUll(items[2], &inodeId);
+    }
+
+    KeyDecoder decoder(value, keyType_);
+    return decoder.Get32(&fsId) && decoder.Get64(&inodeId) && decoder.Done();
 }
 
 std::string Prefix4AllInode::SerializeToString() const {
-    return absl::StrCat(keyType_, ":");
+    return KeyEncoder(keyType_).ToString();
 }
 
 bool Prefix4AllInode::ParseFromString(const std::string& value) {
-    std::vector<std::string> items;
-    SplitString(value, ":", &items);
-    return items.size() == 1 && CompareType(items[0], keyType_);
+    return KeyDecoder(value, keyType_).Done();
 }
 
-const size_t Key4S3ChunkInfoList::kMaxUint64Length_ =
-    std::to_string(std::numeric_limits<uint64_t>::max()).size();
-
 Key4S3ChunkInfoList::Key4S3ChunkInfoList()
     : fsId(0),
       inodeId(0),
@@ -164,20 +273,33 @@ Key4S3ChunkInfoList::Key4S3ChunkInfoList(uint32_t fsId,
       size(size) {}
 
 std::string Key4S3ChunkInfoList::SerializeToString() const {
-    return absl::StrCat(keyType_, ":", fsId, ":", inodeId, ":",
-        chunkIndex, ":", absl::StrFormat("%020" PRIu64"", firstChunkId), ":",
-        absl::StrFormat("%020" PRIu64"", lastChunkId), ":", size);
+    return KeyEncoder(keyType_)
+        .Put32(fsId)
+        .Put64(inodeId)
+        .Put64(chunkIndex)
+        .Put64(firstChunkId)
+        .Put64(lastChunkId)
+        .Put64(size)
+        .ToString();
 }
 
 bool Key4S3ChunkInfoList::ParseFromString(const std::string& value) {
-    std::vector<std::string> items;
-    SplitString(value, ":", &items);
-    return items.size() == 7 && CompareType(items[0], keyType_) &&
-        StringToUl(items[1], &fsId) && StringToUll(items[2], &inodeId) &&
-        StringToUll(items[3], &chunkIndex) &&
-        StringToUll(items[4], &firstChunkId) &&
-        StringToUll(items[5], &lastChunkId) &&
-        StringToUll(items[6], &size);
+    if (IsTextKey(value)) {
+        std::vector<std::string> items;
+        SplitString(value, ":", &items);
+        return items.size() == 7 && CompareType(items[0], keyType_) &&
+            StringToUl(items[1], &fsId) && StringToUll(items[2], &inodeId) &&
+            StringToUll(items[3], &chunkIndex) &&
+            StringToUll(items[4], &firstChunkId) &&
+            StringToUll(items[5], &lastChunkId) &&
+            StringToUll(items[6], &size);
+    }
+
+    KeyDecoder decoder(value, keyType_);
+    return decoder.Get32(&fsId) && decoder.Get64(&inodeId) &&
+           decoder.Get64(&chunkIndex) && decoder.Get64(&firstChunkId) &&
+           decoder.Get64(&lastChunkId) && decoder.Get64(&size) &&
+           decoder.Done();
 }
 
 Prefix4ChunkIndexS3ChunkInfoList::Prefix4ChunkIndexS3ChunkInfoList()
@@ -190,17 +312,18 @@ Prefix4ChunkIndexS3ChunkInfoList::Prefix4ChunkIndexS3ChunkInfoList(
     : fsId(fsId), inodeId(inodeId), chunkIndex(chunkIndex) {}
 
 std::string Prefix4ChunkIndexS3ChunkInfoList::SerializeToString() const {
-    return absl::StrCat(keyType_, ":", fsId, ":", inodeId, ":",
-        chunkIndex, ":");
+    return KeyEncoder(keyType_)
+        .Put32(fsId)
+        .Put64(inodeId)
+        .Put64(chunkIndex)
+        .ToString();
 }
 
 bool Prefix4ChunkIndexS3ChunkInfoList::ParseFromString(
     const std::string& value) {
-    std::vector<std::string> items;
-    SplitString(value, ":", &items);
-    return items.size() == 4 && CompareType(items[0], keyType_) &&
-        StringToUl(items[1], &fsId) && StringToUll(items[2], &inodeId) &&
-        StringToUll(items[3], &chunkIndex);
+    KeyDecoder decoder(value, keyType_);
+    return decoder.Get32(&fsId) && decoder.Get64(&inodeId) &&
+           decoder.Get64(&chunkIndex) && decoder.Done();
 }
 
 Prefix4InodeS3ChunkInfoList::Prefix4InodeS3ChunkInfoList()
@@ -211,24 +334,20 @@ Prefix4InodeS3ChunkInfoList::Prefix4InodeS3ChunkInfoList(uint32_t fsId,
     : fsId(fsId), inodeId(inodeId) {}
 
 std::string Prefix4InodeS3ChunkInfoList::SerializeToString() const {
-    return absl::StrCat(keyType_, ":", fsId, ":", inodeId, ":");
+    return KeyEncoder(keyType_).Put32(fsId).Put64(inodeId).ToString();
 }
 
 bool Prefix4InodeS3ChunkInfoList::ParseFromString(const std::string& value) {
-    std::vector<std::string> items;
-    SplitString(value, ":", &items);
-    return items.size() == 3 && CompareType(items[0], keyType_) &&
-        StringToUl(items[1], &fsId) && StringToUll(items[2], &inodeId);
+    KeyDecoder decoder(value, keyType_);
+    return decoder.Get32(&fsId) && decoder.Get64(&inodeId) && decoder.Done();
 }
 
 std::string Prefix4AllS3ChunkInfoList::SerializeToString() const {
-    return absl::StrCat(kTypeS3ChunkInfo, ":");
+    return KeyEncoder(keyType_).ToString();
 }
 
 bool Prefix4AllS3ChunkInfoList::ParseFromString(const std::string& value) {
-    std::vector<std::string> items;
-    SplitString(value, ":", &items);
-    return items.size() == 1 && CompareType(items[0], keyType_);
+    return KeyDecoder(value, keyType_).Done();
 }
 
 Key4Dentry::Key4Dentry(uint32_t fsId,
@@ -237,12 +356,17 @@ Key4Dentry::Key4Dentry(uint32_t fsId,
     : fsId(fsId), parentInodeId(parentInodeId), name(name) {}
 
 std::string Key4Dentry::SerializeToString() const {
-    return absl::StrCat(keyType_, kDelimiter, fsId,
-                        kDelimiter, parentInodeId,
-                        kDelimiter, name);
+    return KeyEncoder(keyType_).Put32(fsId).Put64(parentInodeId).ToString(
+        name);
 }
 
 bool Key4Dentry::ParseFromString(const std::string& value) {
+    if (!IsTextKey(value)) {
+        KeyDecoder decoder(value, keyType_);
+        return decoder.Get32(&fsId) && decoder.Get64(&parentInodeId) &&
+               decoder.GetRest(&name);
+    }
+
     std::vector<std::string> items;
     SplitString(value, ":", &items);
     if (items.size() < 3 ||
@@ -268,26 +392,21 @@ Prefix4SameParentDentry::Prefix4SameParentDentry(uint32_t fsId,
     : fsId(fsId), parentInodeId(parentInodeId) {}
 
 std::string Prefix4SameParentDentry::SerializeToString() const {
-    return absl::StrCat(keyType_, kDelimiter, fsId,
-                        kDelimiter, parentInodeId,
-                        kDelimiter);
+    return KeyEncoder(keyType_).Put32(fsId).Put64(parentInodeId).ToString();
 }
 
 bool Prefix4SameParentDentry::ParseFromString(const std::string& value) {
-    std::vector<std::string> items;
-    SplitString(value, ":", &items);
-    return items.size() == 3 && CompareType(items[0], keyType_) &&
-           StringToUl(items[1], &fsId) && StringToUll(items[2], &parentInodeId);
+    KeyDecoder decoder(value, keyType_);
+    return decoder.Get32(&fsId) && decoder.Get64(&parentInodeId) &&
+           decoder.Done();
 }
 
 std::string Prefix4AllDentry::SerializeToString() const {
-    return absl::StrCat(keyType_, ":");
+    return KeyEncoder(keyType_).ToString();
 }
 
 bool Prefix4AllDentry::ParseFromString(const std::string& value) {
-    std::vector<std::string> items;
-    SplitString(value, ":", &items);
-    return items.size() == 1 && CompareType(items[0], keyType_);
+    return KeyDecoder(value, keyType_).Done();
 }
 
 Key4VolumeExtentSlice::Key4VolumeExtentSlice(uint32_t fsId,
@@ -296,19 +415,26 @@ Key4VolumeExtentSlice::Key4VolumeExtentSlice(uint32_t fsId,
     : fsId_(fsId), inodeId_(inodeId), offset_(offset) {}
 
 std::string Key4VolumeExtentSlice::SerializeToString() const {
-    return absl::StrCat(keyType_, kDelimiter, fsId_, kDelimiter, inodeId_,
-                        kDelimiter, offset_);
+    return KeyEncoder(keyType_)
+        .Put32(fsId_)
+        .Put64(inodeId_)
+        .Put64(offset_)
+        .ToString();
 }
 
 bool Key4VolumeExtentSlice::ParseFromString(const std::string& value) {
-    // TODO(wuhanqing): reduce unnecessary creation of temporary strings,
-    //                  but, currently, `absl::from_chars` only support floating
-    //                  point
-    std::vector<std::string> items;
-    SplitString(value, kDelimiter, &items);
-    return items.size() == 4 && CompareType(items[0], keyType_) &&
-           StringToUl(items[1], &fsId_) && StringToUll(items[2], &inodeId_) &&
-           StringToUll(items[3], &offset_);
+    if (IsTextKey(value)) {
+        std::vector<std::string> items;
+        SplitString(value, kDelimiter, &items);
+        return items.size() == 4 && CompareType(items[0], keyType_) &&
+               StringToUl(items[1], &fsId_) &&
+               StringToUll(items[2], &inodeId_) &&
+               StringToUll(items[3], &offset_);
+    }
+
+    KeyDecoder decoder(value, keyType_);
+    return decoder.Get32(&fsId_) && decoder.Get64(&inodeId_) &&
+           decoder.Get64(&offset_) && decoder.Done();
 }
 
 Prefix4InodeVolumeExtent::Prefix4InodeVolumeExtent(uint32_t fsId,
@@ -316,25 +442,21 @@ Prefix4InodeVolumeExtent::Prefix4InodeVolumeExtent(uint32_t fsId,
     : fsId_(fsId), inodeId_(inodeId) {}
 
 std::string Prefix4InodeVolumeExtent::SerializeToString() const {
-    return absl::StrCat(keyType_, kDelimiter, fsId_, kDelimiter, inodeId_,
-                        kDelimiter);
+    return KeyEncoder(keyType_).Put32(fsId_).Put64(inodeId_).ToString();
 }
 
 bool Prefix4InodeVolumeExtent::ParseFromString(const std::string &value) {
-    std::vector<std::string> items;
-    SplitString(value, kDelimiter, &items);
-    return items.size() == 3 && CompareType(items[0], keyType_) &&
-           StringToUl(items[1], &fsId_) && StringToUll(items[2], &inodeId_);
+    KeyDecoder decoder(value, keyType_);
+    return decoder.Get32(&fsId_) && decoder.Get64(&inodeId_) &&
+           decoder.Done();
 }
 
 std::string Prefix4AllVolumeExtent::SerializeToString() const {
-    return absl::StrCat(keyType_, kDelimiter);
+    return KeyEncoder(keyType_).ToString();
 }
 
 bool Prefix4AllVolumeExtent::ParseFromString(const std::string &value) {
-    std::vector<std::string> items;
-    SplitString(value, kDelimiter, &items);
-    return items.size() == 1 && CompareType(items[0], keyType_);
+    return KeyDecoder(value, keyType_).Done();
 }
 
 Key4InodeAuxInfo::Key4InodeAuxInfo(uint32_t fsId,
@@ -378,6 +500,43 @@ std::string Converter::SerializeToString(const StorageKey& key) {
     return key.SerializeToString();
 }
 
+bool Converter::UpgradeKey(const std::string& key, std::string* out) {
+    // text keys start with its type, see KEY_TYPE
+    auto upgrade = [&](StorageKey* storageKey) {
+        if (!storageKey->ParseFromString(key)) {
+            return false;
+        }
+        *out = storageKey->SerializeToString();
+        return true;
+    };
+
+    if (IsTextKey(key) && key.size() > 1 && key[1] == ':') {
+        switch (key[0] - '0') {
+            case kTypeInode: {
+                Key4Inode inodeKey;
+                return upgrade(&inodeKey);
+            }
+            case kTypeS3ChunkInfo: {
+                Key4S3ChunkInfoList s3ChunkInfoKey;
+                return upgrade(&s3ChunkInfoKey);
+            }
+            case kTypeDentry: {
+                Key4Dentry dentryKey;
+                return upgrade(&dentryKey);
+            }
+            case kTypeVolumeExtent: {
+                Key4VolumeExtentSlice sliceKey;
+                return upgrade(&sliceKey);
+            }
+            default:
+                break;
+        }
+    }
+
+    *out = key;
+    return true;
+}
+
 bool Converter::SerializeToString(const google::protobuf::Message& entry,
                                   std::string* value) {
     if (!entry.IsInitialized()) {
@@ -46,6 +46,7 @@ enum KEY_TYPE : unsigned char {
     kTypeBlockGroup = 6,
     kTypeDeallocatableBlockGroup = 7,
     kTypeDeallocatableInode = 8,
+    kTypeInodeXAttr = 9,
 };
 
 // NOTE: you must generate all table name by NameGenerator class for
@@ -67,6 +68,8 @@ class NameGenerator {
 
     std::string GetInodeAuxInfoTableName() const;
 
+    std::string GetInodeXAttrTableName() const;
+
     std::string GetBlockGroupStatisticTableName() const;
 
     std::string GetDeallocatableBlockGroupTableName() const;
@@ -84,6 +87,7 @@ class NameGenerator {
     std::string tableName4Dentry_;
     std::string tableName4VolumeExtent_;
     std::string tableName4InodeAuxInfo_;
+    std::string tableName4InodeXAttr_;
 };
 
 class StorageKey {
@@ -97,12 +101,12 @@ class StorageKey {
 /* rules for key serialization:
  *   Key4Inode                        : kTypeInode:fsId:inodeId
  *   Prefix4AllInode                  : kTypeInode:
- *   Key4S3ChunkInfoList              : kTypeS3ChunkInfo:fsId:inodeId:chunkIndex:firstChunkId:lastChunkId  // NOLINT
+ *   Key4S3ChunkInfoList              : kTypeS3ChunkInfo:fsId:inodeId:chunkIndex:firstChunkId:lastChunkId:size  // NOLINT
  *   Prefix4ChunkIndexS3ChunkInfoList : kTypeS3ChunkInfo:fsId:inodeId:chunkIndex:  // NOLINT
  *   Prefix4InodeS3ChunkInfoList      : kTypeS3ChunkInfo:fsId:inodeId:
  *   Prefix4AllS3ChunkInfoList        : kTypeS3ChunkInfo:
- *   Key4Dentry                       : kTypeDentry:parentInodeId:name
- *   Prefix4SameParentDentry          : kTypeDentry:parentInodeId:
+ *   Key4Dentry                       : kTypeDentry:fsId:parentInodeId:name
+ *   Prefix4SameParentDentry          : kTypeDentry:fsId:parentInodeId:
  *   Prefix4AllDentry                 : kTypeDentry:
  *   Key4VolumeExtentSlice            : kTypeExtent:fsId:inodeId:sliceOffset
  *   Prefix4InodeVolumeExtent         : kTypeExtent:fsId:inodeId:
@@ -110,8 +114,23 @@ class StorageKey {
  *   Key4InodeAuxInfo                 : kTypeInodeAuxInfo:fsId:inodeId
  *   Key4DeallocatableBlockGroup      : kTypeBlockGroup:fsId:volumeOffset
  *   Prefix4AllDeallocatableBlockGroup: kTypeBlockGroup:
+ *
+ * keys of inode, s3chunkinfo, dentry and volume extent are in binary format:
+ *   | version | type | fields ... |
+ *   version: 1 byte, kBinaryKeyVersion, which is never an ascii digit
+ *   type   : 1 byte, KEY_TYPE
+ *   fields : fixed-length big-endian integers, fsId is 4 bytes and others
+ *            are 8 bytes, name of dentry is appended as is
+ * so they are ordered by fields numerically, and ':' above is only for
+ * readability. Other keys are in text format, as all keys were before.
  */
 
+static constexpr char kBinaryKeyVersion = 0x01;
+
+// Whether the key is in text format, keys of inode, s3chunkinfo, dentry
+// and volume extent in text format are saved by previous versions
+bool IsTextKey(const std::string& key);
+
 class Key4Inode : public StorageKey {
  public:
     Key4Inode();
@@ -161,7 +180,6 @@ class Key4S3ChunkInfoList : public StorageKey {
     bool ParseFromString(const std::string& value) override;
 
  public:
-    static const size_t kMaxUint64Length_;
     static const KEY_TYPE keyType_ = kTypeS3ChunkInfo;
 
      uint32_t fsId;
@@ -376,6 +394,11 @@ class Converter {
     // for key
     std::string SerializeToString(const StorageKey& key);
 
+    // Convert a key saved by previous versions into current format,
+    // |key| is returned as is if it's already in current format.
+    // Return false if |key| is malformed.
+    bool UpgradeKey(const std::string& key, std::string* out);
+
     // for value
     bool SerializeToString(const google::protobuf::Message& entry,
                            std::string* value);
@@ -23,6 +23,8 @@
 #ifndef CURVEFS_SRC_METASERVER_STORAGE_DUMPFILE_H_
 #define CURVEFS_SRC_METASERVER_STORAGE_DUMPFILE_H_
 
+#include <signal.h>
+
 #include <cstdint>
 #include <memory>
 #include <string>
@@ -87,6 +89,14 @@ enum DumpFileVersion : uint8_t {
     // kDumpFileV2 (because they're not inserted into rocksdb), other metadata
     // is saved by rocksdb
     kDumpFileV3 = 3,
+    // Version 4 is same as kDumpFileV3, except that storage keys of inodes,
+    // dentries, s3chunkinfo and volume extents saved by rocksdb are in
+    // binary format, see also converter.h
+    kDumpFileV4 = 4,
+    // Version 5 is same as kDumpFileV4, except that extended attributes of
+    // inodes are saved in a separate table rather than inside the inodes,
+    // and the inodes record whether they have any
+    kDumpFileV5 = 5,
 };
 
 std::ostream& operator<<(std::ostream& os, DUMPFILE_ERROR code);
@@ -21,10 +21,16 @@
  */
 
 #include <glog/logging.h>
+#include <google/protobuf/descriptor.h>
+#include <google/protobuf/message.h>
 
 #include <string>
 #include <memory>
+#include <utility>
 
+#include "absl/cleanup/cleanup.h"
+#include "absl/strings/string_view.h"
+#include "curvefs/src/metaserver/storage/dumpfile.h"
 #include "curvefs/src/metaserver/storage/utils.h"
 #include "curvefs/src/metaserver/storage/memory_storage.h"
 
@@ -84,11 +90,11 @@ bool MemoryStorage::Close() {
 #define GET(TYPE, NAME, KEY, VALUE)             \
 do {                                            \
     auto container = GET_CONTAINER(TYPE, NAME); \
-    auto iter = container->find(KEY);           \
-    if (iter == container->end()) {             \
+    auto found = container->Find(KEY);          \
+    if (found == nullptr) {                     \
         return Status::NotFound();              \
     }                                           \
-    VALUE->CopyFrom(*iter->second.Message());   \
+    VALUE->CopyFrom(*found->Message());         \
     return Status::OK();                        \
 } while (0)
 
@@ -96,23 +102,24 @@ do {                                            \
 #define GET_SERALIZED(TYPE, NAME, KEY, VALUE)    \
 do {                                             \
     auto container = GET_CONTAINER(TYPE, NAME);  \
-    auto iter = container->find(KEY);            \
-    if (iter == container->end()) {              \
+    auto found = container->Find(KEY);           \
+    if (found == nullptr) {                      \
         return Status::NotFound();               \
     }                                            \
                                                  \
-    if (!VALUE->ParseFromString(iter->second)) { \
+    if (!VALUE->ParseFromString(*found)) {       \
         return Status::ParsedFailed();           \
     }                                            \
     return Status::OK();                         \
 } while (0)
 
-#define SET(TYPE, NAME, KEY, VALUE)                 \
-    do {                                            \
-        auto container = GET_CONTAINER(TYPE, NAME); \
-        auto valueWrapper = ValueWrapper(VALUE);    \
-        (*container)[KEY].Swap(valueWrapper);       \
-        return Status::OK();                        \
+// NOTE: modifications hold the read lock to exclude Snapshot()
+#define SET(TYPE, NAME, KEY, VALUE)                     \
+    do {                                                \
+        auto container = GET_CONTAINER(TYPE, NAME);     \
+        ReadLockGuard readLockGuard(rwLock_);           \
+        container->Insert(KEY, ValueWrapper(VALUE));    \
+        return Status::OK();                            \
     } while (0)
 
 #define SET_SERALIZED(TYPE, NAME, KEY, VALUE)   \
@@ -122,10 +129,8 @@ do {                                            \
     if (!VALUE.SerializeToString(&svalue)) {    \
         return Status::SerializedFailed();      \
     }                                           \
-    auto ret = container->emplace(KEY, svalue); \
-    if (!ret.second) {                          \
-        ret.first->second = svalue;             \
-    }                                           \
+    ReadLockGuard readLockGuard(rwLock_);       \
+    container->Insert(KEY, std::move(svalue));  \
     return Status::OK();                        \
 } while (0)
 
@@ -133,25 +138,23 @@ do {                                            \
 #define DEL(TYPE, NAME, KEY)                    \
 do {                                            \
     auto container = GET_CONTAINER(TYPE, NAME); \
-    auto iter = container->find(KEY);           \
-    if (iter != container->end()) {             \
-        container->erase(iter);                 \
-    }                                           \
+    ReadLockGuard readLockGuard(rwLock_);       \
+    container->Erase(KEY);                      \
     return Status::OK();                        \
 } while (0)
 
 
-#define SEEK(TYPE, NAME, PREFIX)                                            \
+#define SEEK(TYPE, ITERATOR, NAME, PREFIX)                                  \
 do {                                                                        \
     auto container = GET_CONTAINER(TYPE, NAME);                             \
-    return std::make_shared<TYPE##Iterator<TYPE##Type>>(container, PREFIX); \
+    return std::make_shared<ITERATOR<TYPE##Type>>(*container, PREFIX);      \
 } while (0)
 
 
-#define GET_ALL(TYPE, NAME)                                             \
+#define GET_ALL(TYPE, ITERATOR, NAME)                                   \
 do {                                                                    \
     auto container = GET_CONTAINER(TYPE, NAME);                         \
-    return std::make_shared<TYPE##Iterator<TYPE##Type>>(container, ""); \
+    return std::make_shared<ITERATOR<TYPE##Type>>(*container, "");      \
 } while (0)
 
 
@@ -165,6 +168,7 @@ do {                                            \
 #define CLEAR(TYPE, NAME)                       \
 do {                                            \
     auto container = GET_CONTAINER(TYPE, NAME); \
+    ReadLockGuard readLockGuard(rwLock_);       \
     container->clear();                         \
     return Status::OK();                        \
 } while (0)
@@ -200,10 +204,10 @@ Status MemoryStorage::HDel(const std::string& name,
 
 std::shared_ptr<Iterator> MemoryStorage::HGetAll(const std::string& name) {
     if (options_.compression) {
-        GET_ALL(UnorderedSeralizedContainer, name);
+        GET_ALL(UnorderedSeralizedContainer, SeralizedContainerIterator, name);
         return nullptr;
     }
-    GET_ALL(UnorderedContainer, name);
+    GET_ALL(UnorderedContainer, MessageContainerIterator, name);
 }
 
 size_t MemoryStorage::HSize(const std::string& name) {
@@ -253,18 +257,19 @@ Status MemoryStorage::SDel(const std::string& name, const std::string& key) {
 std::shared_ptr<Iterator> MemoryStorage::SSeek(const std::string& name,
                                                 const std::string& prefix) {
     if (options_.compression) {
-        SEEK(OrderedSeralizedContainer, name, prefix);
+        SEEK(OrderedSeralizedContainer, SeralizedContainerIterator, name,
+             prefix);
         return nullptr;
     }
-    SEEK(OrderedContainer, name, prefix);
+    SEEK(OrderedContainer, MessageContainerIterator, name, prefix);
 }
 
 std::shared_ptr<Iterator> MemoryStorage::SGetAll(const std::string& name) {
     if (options_.compression) {
-        GET_ALL(OrderedSeralizedContainer, name);
+        GET_ALL(OrderedSeralizedContainer, SeralizedContainerIterator, name);
         return nullptr;
     }
-    GET_ALL(OrderedContainer, name);
+    GET_ALL(OrderedContainer, MessageContainerIterator, name);
 }
 
 size_t MemoryStorage::SSize(const std::string& name) {
@@ -299,18 +304,227 @@ StorageOptions MemoryStorage::GetStorageOptions() const {
     return options_;
 }
 
+namespace {
+
+const char* const kMemoryStorageFilename = "memory_storage";
+
+const char kHashTable = 'h';
+const char kSortedTable = 's';
+
+void PutLengthPrefixed(const std::string& str, std::string* dst) {
+    uint32_t length = str.size();
+    for (int shift = 24; shift >= 0; shift -= 8) {
+        dst->push_back(static_cast<char>((length >> shift) & 0xff));
+    }
+    dst->append(str);
+}
+
+bool GetLengthPrefixed(absl::string_view* src, std::string* str) {
+    if (src->size() < sizeof(uint32_t)) {
+        return false;
+    }
+
+    uint32_t length = 0;
+    for (size_t i = 0; i < sizeof(uint32_t); i++) {
+        length = (length << 8) | static_cast<uint8_t>((*src)[i]);
+    }
+    src->remove_prefix(sizeof(uint32_t));
+    if (src->size() < length) {
+        return false;
+    }
+    str->assign(src->data(), length);
+    src->remove_prefix(length);
+    return true;
+}
+
+// TableIterator saves entries of a table into checkpoint:
+//   key  : | kind (1 byte) | length (4 bytes) | table name | key |
+//   value: | length (4 bytes) | message type | serialized value |
+// the message type is empty if the table saves serialized values.
+class TableIterator : public Iterator {
+ public:
+    TableIterator(char kind,
+                  const std::string& name,
+                  std::shared_ptr<Iterator> iterator)
+        : prefix_(1, kind), iterator_(std::move(iterator)) {
+        PutLengthPrefixed(name, &prefix_);
+    }
+
+    uint64_t Size() override { return iterator_->Size(); }
+
+    bool Valid() override { return iterator_->Valid(); }
+
+    void SeekToFirst() override { iterator_->SeekToFirst(); }
+
+    void Next() override { iterator_->Next(); }
+
+    std::string Key() override { return prefix_ + iterator_->Key(); }
+
+    std::string Value() override {
+        std::string value;
+        const ValueType* message = iterator_->RawValue();
+        PutLengthPrefixed(message ? message->GetTypeName() : "", &value);
+        value.append(iterator_->Value());
+        return value;
+    }
+
+    int Status() override { return iterator_->Status(); }
+
+ private:
+    std::string prefix_;
+    std::shared_ptr<Iterator> iterator_;
+};
+
+template <typename IteratorType, typename DictType>
+void AddTables(char kind,
+               const DictType& dict,
+               MergeIterator::ChildrenType* children) {
+    for (const auto& item : dict) {
+        auto iterator = std::make_shared<IteratorType>(*item.second, "");
+        children->push_back(
+            std::make_shared<TableIterator>(kind, item.first, iterator));
+    }
+}
+
+template <typename DictType>
+void CopyDict(const DictType& from, DictType* to) {
+    using ContainerType = typename DictType::mapped_type::element_type;
+    for (const auto& item : from) {
+        to->emplace(item.first, std::make_shared<ContainerType>(*item.second));
+    }
+}
+
+}  // namespace
+
+std::shared_ptr<MemoryStorage> MemoryStorage::Snapshot() {
+    auto snapshot = std::make_shared<MemoryStorage>(options_);
+    WriteLockGuard writeLockGuard(rwLock_);
+    CopyDict(UnorderedContainerDict_, &snapshot->UnorderedContainerDict_);
+    CopyDict(UnorderedSeralizedContainerDict_,
+             &snapshot->UnorderedSeralizedContainerDict_);
+    CopyDict(OrderedContainerDict_, &snapshot->OrderedContainerDict_);
+    CopyDict(OrderedSeralizedContainerDict_,
+             &snapshot->OrderedSeralizedContainerDict_);
+    return snapshot;
+}
+
 bool MemoryStorage::Checkpoint(const std::string& dir,
-                               std::vector<std::string>* files) {
-    (void)dir;
-    (void)files;
-    LOG(WARNING) << "Not supported";
-    return false;
+                               std::vector<CheckpointFile>* files) {
+    auto snapshot = Snapshot();
+    MergeIterator::ChildrenType children;
+    AddTables<MessageContainerIterator<UnorderedContainerType>>(
+        kHashTable, snapshot->UnorderedContainerDict_, &children);
+    AddTables<SeralizedContainerIterator<UnorderedSeralizedContainerType>>(
+        kHashTable, snapshot->UnorderedSeralizedContainerDict_, &children);
+    AddTables<MessageContainerIterator<OrderedContainerType>>(
+        kSortedTable, snapshot->OrderedContainerDict_, &children);
+    AddTables<SeralizedContainerIterator<OrderedSeralizedContainerType>>(
+        kSortedTable, snapshot->OrderedSeralizedContainerDict_, &children);
+
+    const std::string pathname = dir + "/" + kMemoryStorageFilename;
+    DumpFile dumpfile(pathname);
+    if (dumpfile.Open() != DUMPFILE_ERROR::OK) {
+        LOG(ERROR) << "Failed to open dumpfile `" << pathname << "`";
+        return false;
+    }
+    auto defer = absl::MakeCleanup([&dumpfile]() { dumpfile.Close(); });
+
+    auto iterator = std::make_shared<MergeIterator>(children);
+    auto rc = dumpfile.Save(iterator);
+    if (rc != DUMPFILE_ERROR::OK || iterator->Status() != 0) {
+        LOG(ERROR) << "Failed to save storage to `" << pathname
+                   << "`, retCode = " << rc;
+        return false;
+    }
+
+    // dump file is rewritten every time, so it has no checksum
+    files->push_back({kMemoryStorageFilename, ""});
+    return true;
 }
 
 bool MemoryStorage::Recover(const std::string& dir) {
-    (void)dir;
-    LOG(WARNING) << "Not supported";
-    return false;
+    LOG(INFO) << "Recovering storage from `" << dir << "`";
+
+    const std::string pathname = dir + "/" + kMemoryStorageFilename;
+    DumpFile dumpfile(pathname);
+    if (dumpfile.Open() != DUMPFILE_ERROR::OK) {
+        LOG(ERROR) << "Failed to open dumpfile `" << pathname << "`";
+        return false;
+    }
+    auto defer = absl::MakeCleanup([&dumpfile]() { dumpfile.Close(); });
+
+    ClearAll();
+    auto iterator = dumpfile.Load();
+    for (iterator->SeekToFirst(); iterator->Valid(); iterator->Next()) {
+        if (!RecoverEntry(iterator->Key(), iterator->Value())) {
+            LOG(ERROR) << "Failed to recover entry from `" << pathname << "`";
+            return false;
+        }
+    }
+
+    if (dumpfile.GetLoadStatus() != DUMPFILE_LOAD_STATUS::COMPLETE) {
+        LOG(ERROR) << "Failed to load dumpfile `" << pathname << "`";
+        return false;
+    }
+    return true;
+}
+
+void MemoryStorage::ClearAll() {
+    WriteLockGuard writeLockGuard(rwLock_);
+    UnorderedContainerDict_.clear();
+    UnorderedSeralizedContainerDict_.clear();
+    OrderedContainerDict_.clear();
+    OrderedSeralizedContainerDict_.clear();
+}
+
+bool MemoryStorage::RecoverEntry(const std::string& key,
+                                 const std::string& value) {
+    absl::string_view skey(key);
+    absl::string_view svalue(value);
+    std::string name;
+    std::string type;
+    if (skey.empty() ||
+        (skey[0] != kHashTable && skey[0] != kSortedTable)) {
+        return false;
+    }
+    bool ordered = (skey[0] == kSortedTable);
+    skey.remove_prefix(1);
+    if (!GetLengthPrefixed(&skey, &name) ||
+        !GetLengthPrefixed(&svalue, &type)) {
+        return false;
+    }
+
+    std::string ukey(skey.data(), skey.size());
+    if (options_.compression) {
+        std::string uvalue(svalue.data(), svalue.size());
+        if (ordered) {
+            GET_CONTAINER(OrderedSeralizedContainer, name)
+                ->Insert(ukey, std::move(uvalue));
+        } else {
+            GET_CONTAINER(UnorderedSeralizedContainer, name)
+                ->Insert(ukey, std::move(uvalue));
+        }
+        return true;
+    }
+
+    auto descriptor =
+        google::protobuf::DescriptorPool::generated_pool()
+            ->FindMessageTypeByName(type);
+    if (descriptor == nullptr) {
+        LOG(ERROR) << "Unknown message type `" << type << "`, the storage"
+                   << " maybe saved with compression";
+        return false;
+    }
+
+    std::unique_ptr<ValueType> message(
+        google::protobuf::MessageFactory::generated_factory()
+            ->GetPrototype(descriptor)->New());
+    if (!message->ParseFromArray(svalue.data(), svalue.size())) {
+        return false;
+    }
+    Status s = ordered ? SSet(name, ukey, *message)
+                       : HSet(name, ukey, *message);
+    return s.ok();
 }
 
 }  // namespace storage
@@ -29,13 +29,13 @@
 #include <unordered_map>
 #include <vector>
 
-#include "absl/container/btree_map.h"
 #include "src/common/string_util.h"
 #include "src/common/concurrent/rw_lock.h"
 #include "curvefs/proto/metaserver.pb.h"
 #include "curvefs/src/metaserver/storage/common.h"
 #include "curvefs/src/metaserver/storage/storage.h"
 #include "curvefs/src/metaserver/storage/iterator.h"
+#include "curvefs/src/metaserver/storage/persistent_map.h"
 #include "curvefs/src/metaserver/storage/value_wrapper.h"
 
 namespace curvefs {
@@ -50,19 +50,18 @@ using ::curvefs::metaserver::S3ChunkInfoList;
 using ::curvefs::metaserver::VolumeExtentSlice;
 using STORAGE_TYPE = KVStorage::STORAGE_TYPE;
 
+// NOTE: all tables are persistent maps, which are copied in O(1), so the
+// whole storage can be snapshotted in O(number of tables), and iterators
+// iterate the snapshot of table when they're created.
 class MemoryStorage : public KVStorage, public StorageTransaction {
  public:
-    using UnorderedContainerType =
-        std::unordered_map<std::string, ValueWrapper>;
+    using UnorderedContainerType = PersistentMap<ValueWrapper>;
 
-    using UnorderedSeralizedContainerType =
-        std::unordered_map<std::string, std::string>;
+    using UnorderedSeralizedContainerType = PersistentMap<std::string>;
 
-    using OrderedContainerType =
-        absl::btree_map<std::string, ValueWrapper>;
+    using OrderedContainerType = PersistentMap<ValueWrapper>;
 
-    using OrderedSeralizedContainerType =
-        absl::btree_map<std::string, std::string>;
+    using OrderedSeralizedContainerType = PersistentMap<std::string>;
 
  public:
     explicit MemoryStorage(StorageOptions options);
@@ -112,17 +111,29 @@ class MemoryStorage : public KVStorage, public StorageTransaction {
 
     // NOTE: now we can't support transaction for memory storage,
     // so these interface is dummy, it will pretend everything works well.
+    // Batch isn't supported either, see KVStorage::BeginBatch().
     std::shared_ptr<StorageTransaction> BeginTransaction() override;
 
     Status Commit() override;
 
     Status Rollback() override;
 
+    // Save a snapshot of storage into a dump file under the directory,
+    // the storage can be modified while saving
     bool Checkpoint(const std::string& dir,
-                    std::vector<std::string>* files) override;
+                    std::vector<CheckpointFile>* files) override;
 
     bool Recover(const std::string& dir) override;
 
+    // Return a logical snapshot of the storage, which shares all data with
+    // current storage and costs O(number of tables)
+    std::shared_ptr<MemoryStorage> Snapshot();
+
+ private:
+    void ClearAll();
+
+    bool RecoverEntry(const std::string& key, const std::string& value);
+
  private:
     RWLock rwLock_;
     StorageOptions options_;
@@ -147,7 +158,7 @@ class MemoryStorage : public KVStorage, public StorageTransaction {
 template<typename ContainerType>
 class MemoryStorageIterator : public Iterator {
  public:
-    MemoryStorageIterator(std::shared_ptr<ContainerType> container,
+    MemoryStorageIterator(const ContainerType& container,
                           const std::string& prefix)
         : prefix_(prefix),
           status_(0),
@@ -156,29 +167,31 @@ class MemoryStorageIterator : public Iterator {
 
     // NOTE: now we can't caclute the size for range operate
     uint64_t Size() override {
-        return (prefix_.size() > 0) ? 0 : container_->size();
+        return (prefix_.size() > 0) ? 0 : container_.size();
     }
 
     bool Valid() override {
         if (status_ != 0) {
             return false;
-        } else if (current_ == container_->end()) {
+        } else if (!current_.Valid()) {
             return false;
         } else if (prefixChecking_ && prefix_.size() > 0 &&
-            !StringStartWith(current_->first, prefix_)) {
+            !StringStartWith(current_.Key(), prefix_)) {
             return false;
         }
         return true;
     }
 
-    void SeekToFirst() override {}
+    void SeekToFirst() override {
+        current_ = container_.LowerBound(prefix_);
+    }
 
     void Next() override {
-        current_++;
+        current_.Next();
     }
 
     std::string Key() override {
-        return current_->first;
+        return current_.Key();
     }
 
     std::string Value() override {
@@ -197,73 +210,19 @@ class MemoryStorageIterator : public Iterator {
     std::string prefix_;
     int status_;
     bool prefixChecking_;
-    std::shared_ptr<ContainerType> container_;
-    typename ContainerType::const_iterator current_;
-};
-
-template<typename ContainerType>
-class UnorderedContainerIterator : public MemoryStorageIterator<ContainerType> {
- public:
-    using MemoryStorageIterator<ContainerType>::MemoryStorageIterator;
-
-    void SeekToFirst() override {
-        this->current_ = this->container_->begin();
-    }
-
-    std::string Value() override {
-        std::string svalue;
-        auto message = this->current_->second.Message();
-        if (!message->SerializeToString(&svalue)) {
-            this->status_ = -1;
-        }
-        return svalue;
-    }
-
-    const ValueType* RawValue() const override {
-        return this->current_->second.Message();
-    }
-
-    bool ParseFromValue(ValueType* value) override {
-        auto message = this->current_->second.Message();
-        value->CopyFrom(*message);
-        return true;
-    }
+    // snapshot of the table
+    ContainerType container_;
+    typename ContainerType::Iterator current_;
 };
 
 template<typename ContainerType>
-class UnorderedSeralizedContainerIterator :
-public MemoryStorageIterator<ContainerType> {
+class MessageContainerIterator : public MemoryStorageIterator<ContainerType> {
  public:
     using MemoryStorageIterator<ContainerType>::MemoryStorageIterator;
 
-    void SeekToFirst() override {
-        this->current_ = this->container_->begin();
-    }
-
-    std::string Value() override {
-        return this->current_->second;
-    }
-
-    bool ParseFromValue(ValueType* value) override {
-        if (!value->ParseFromString(this->current_->second)) {
-            return false;
-        }
-        return true;
-    }
-};
-
-template<typename ContainerType>
-class OrderedContainerIterator : public MemoryStorageIterator<ContainerType> {
- public:
-    using MemoryStorageIterator<ContainerType>::MemoryStorageIterator;
-
-    void SeekToFirst() override {
-        this->current_ = this->container_->lower_bound(this->prefix_);
-    }
-
     std::string Value() override {
         std::string svalue;
-        auto message = this->current_->second.Message();
+        auto message = this->current_.GetValue().Message();
         if (!message->SerializeToString(&svalue)) {
             this->status_ = -1;
         }
@@ -271,32 +230,28 @@ class OrderedContainerIterator : public MemoryStorageIterator<ContainerType> {
     }
 
     const ValueType* RawValue() const override {
-        return this->current_->second.Message();
+        return this->current_.GetValue().Message();
     }
 
     bool ParseFromValue(ValueType* value) override {
-        auto message = this->current_->second.Message();
+        auto message = this->current_.GetValue().Message();
         value->CopyFrom(*message);
         return true;
     }
 };
 
 template<typename ContainerType>
-class OrderedSeralizedContainerIterator :
+class SeralizedContainerIterator :
 public MemoryStorageIterator<ContainerType> {
  public:
     using MemoryStorageIterator<ContainerType>::MemoryStorageIterator;
 
-    void SeekToFirst() override {
-        this->current_ = this->container_->lower_bound(this->prefix_);
-    }
-
     std::string Value() override {
-        return this->current_->second;
+        return this->current_.GetValue();
     }
 
     bool ParseFromValue(ValueType* value) override {
-        if (!value->ParseFromString(this->current_->second)) {
+        if (!value->ParseFromString(this->current_.GetValue())) {
             return false;
         }
         return true;
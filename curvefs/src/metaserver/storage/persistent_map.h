@@ -0,0 +1,291 @@
+/*
+ *  Copyright (c) 2023 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#ifndef CURVEFS_SRC_METASERVER_STORAGE_PERSISTENT_MAP_H_
+#define CURVEFS_SRC_METASERVER_STORAGE_PERSISTENT_MAP_H_
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace curvefs {
+namespace metaserver {
+namespace storage {
+
+// PersistentMap is an ordered map from string to `Value`, and copying it
+// costs O(1): the copy shares all nodes with the origin, and each of them
+// only copies the nodes on the path it modifies (copy-on-write), so a copy
+// is a logical snapshot of the map.
+//
+// Nodes owned by one map only are modified in place, so a map that has
+// never been copied behaves like a plain AVL tree.
+//
+// NOTE: like the standard containers, a map must not be read and modified
+// concurrently, but different copies can be used in different threads.
+template <typename Value>
+class PersistentMap {
+ private:
+    struct Node;
+    using NodePtr = std::shared_ptr<Node>;
+
+    struct Node {
+        Node(const std::string& k, Value&& v)
+            : key(k), value(std::move(v)), height(1) {}
+
+        std::string key;
+        Value value;
+        NodePtr left;
+        NodePtr right;
+        int32_t height;
+    };
+
+ public:
+    // Iterator holds the map's root, so it iterates the snapshot of the map
+    // when it's created, regardless of the following modifications.
+    class Iterator {
+     public:
+        Iterator() = default;
+
+        bool Valid() const { return !stack_.empty(); }
+
+        void Next() {
+            const Node* node = stack_.back();
+            stack_.pop_back();
+            PushLeft(node->right.get());
+        }
+
+        const std::string& Key() const { return stack_.back()->key; }
+
+        const Value& GetValue() const { return stack_.back()->value; }
+
+     private:
+        friend class PersistentMap;
+
+        explicit Iterator(NodePtr root) : root_(std::move(root)) {}
+
+        void PushLeft(const Node* node) {
+            for (; node != nullptr; node = node->left.get()) {
+                stack_.push_back(node);
+            }
+        }
+
+     private:
+        NodePtr root_;
+        std::vector<const Node*> stack_;
+    };
+
+ public:
+    PersistentMap() : size_(0) {}
+
+    size_t size() const { return size_; }
+
+    bool empty() const { return size_ == 0; }
+
+    void clear() {
+        root_.reset();
+        size_ = 0;
+    }
+
+    const Value* Find(const std::string& key) const {
+        const Node* node = root_.get();
+        while (node != nullptr) {
+            if (key < node->key) {
+                node = node->left.get();
+            } else if (node->key < key) {
+                node = node->right.get();
+            } else {
+                return &node->value;
+            }
+        }
+        return nullptr;
+    }
+
+    // Insert or replace the value of key
+    void Insert(const std::string& key, Value value) {
+        if (Insert(&root_, key, &value)) {
+            size_++;
+        }
+    }
+
+    // Return false if the key not found
+    bool Erase(const std::string& key) {
+        if (Find(key) == nullptr) {
+            return false;
+        }
+        Erase(&root_, key);
+        size_--;
+        return true;
+    }
+
+    Iterator Begin() const {
+        Iterator iter(root_);
+        iter.PushLeft(root_.get());
+        return iter;
+    }
+
+    // Return the iterator to the first key not less than the given key
+    Iterator LowerBound(const std::string& key) const {
+        Iterator iter(root_);
+        const Node* node = root_.get();
+        while (node != nullptr) {
+            if (node->key < key) {
+                node = node->right.get();
+            } else {
+                iter.stack_.push_back(node);
+                node = node->left.get();
+            }
+        }
+        return iter;
+    }
+
+ private:
+    static int32_t Height(const NodePtr& node) {
+        return node ? node->height : 0;
+    }
+
+    static void UpdateHeight(Node* node) {
+        node->height = std::max(Height(node->left), Height(node->right)) + 1;
+    }
+
+    // Make sure the node is owned by current map only before modify it,
+    // otherwise it may be shared with other copies, so copy it.
+    static Node* Mutable(NodePtr* node) {
+        if (node->use_count() != 1) {
+            *node = std::make_shared<Node>(**node);
+        } else {
+            // pairs with the release of reference count decrement
+            // in other copies which had shared the node
+            std::atomic_thread_fence(std::memory_order_acquire);
+        }
+        return node->get();
+    }
+
+    // REQUIRES: the node and its left child are not null
+    static void RotateRight(NodePtr* node) {
+        Node* n = Mutable(node);
+        Mutable(&n->left);
+        NodePtr pivot = std::move(n->left);
+        n->left = std::move(pivot->right);
+        UpdateHeight(n);
+        pivot->right = std::move(*node);
+        *node = std::move(pivot);
+        UpdateHeight(node->get());
+    }
+
+    // REQUIRES: the node and its right child are not null
+    static void RotateLeft(NodePtr* node) {
+        Node* n = Mutable(node);
+        Mutable(&n->right);
+        NodePtr pivot = std::move(n->right);
+        n->right = std::move(pivot->left);
+        UpdateHeight(n);
+        pivot->left = std::move(*node);
+        *node = std::move(pivot);
+        UpdateHeight(node->get());
+    }
+
+    // REQUIRES: the node is not null and owned by current map
+    static void Rebalance(NodePtr* node) {
+        Node* n = node->get();
+        int32_t factor = Height(n->left) - Height(n->right);
+        if (factor > 1) {
+            if (Height(n->left->left) < Height(n->left->right)) {
+                RotateLeft(&n->left);
+            }
+            RotateRight(node);
+        } else if (factor < -1) {
+            if (Height(n->right->right) < Height(n->right->left)) {
+                RotateRight(&n->right);
+            }
+            RotateLeft(node);
+        } else {
+            UpdateHeight(n);
+        }
+    }
+
+    // Return true if a new node inserted
+    static bool Insert(NodePtr* node, const std::string& key, Value* value) {
+        if (!*node) {
+            *node = std::make_shared<Node>(key, std::move(*value));
+            return true;
+        }
+
+        bool inserted = false;
+        Node* n = Mutable(node);
+        if (key < n->key) {
+            inserted = Insert(&n->left, key, value);
+        } else if (n->key < key) {
+            inserted = Insert(&n->right, key, value);
+        } else {
+            n->value = std::move(*value);
+            return false;
+        }
+
+        if (inserted) {
+            Rebalance(node);
+        }
+        return inserted;
+    }
+
+    // Detach the minimum node of the subtree, and move out its key and value
+    static void EraseMin(NodePtr* node, std::string* key, Value* value) {
+        Node* n = Mutable(node);
+        if (!n->left) {
+            *key = std::move(n->key);
+            *value = std::move(n->value);
+            NodePtr right = std::move(n->right);
+            *node = std::move(right);
+            return;
+        }
+
+        EraseMin(&n->left, key, value);
+        Rebalance(node);
+    }
+
+    // REQUIRES: the key exists in the subtree
+    static void Erase(NodePtr* node, const std::string& key) {
+        Node* n = Mutable(node);
+        if (key < n->key) {
+            Erase(&n->left, key);
+        } else if (n->key < key) {
+            Erase(&n->right, key);
+        } else if (!n->left || !n->right) {
+            NodePtr child = n->left ? std::move(n->left) : std::move(n->right);
+            *node = std::move(child);
+            return;
+        } else {
+            EraseMin(&n->right, &n->key, &n->value);
+        }
+        Rebalance(node);
+    }
+
+ private:
+    friend class PersistentMapTest;
+
+    NodePtr root_;
+    size_t size_;
+};
+
+}  // namespace storage
+}  // namespace metaserver
+}  // namespace curvefs
+
+#endif  // CURVEFS_SRC_METASERVER_STORAGE_PERSISTENT_MAP_H_
@@ -26,6 +26,7 @@
 #include <iostream>
 #include <unordered_map>
 
+#include "absl/strings/str_cat.h"
 #include "src/common/timeutility.h"
 #include "curvefs/src/metaserver/storage/utils.h"
 #include "curvefs/src/metaserver/storage/storage.h"
@@ -33,6 +34,7 @@
 #include "curvefs/src/metaserver/storage/rocksdb_perf.h"
 #include "curvefs/src/metaserver/storage/rocksdb_storage.h"
 #include "curvefs/src/metaserver/storage/rocksdb_options.h"
+#include "rocksdb/table_properties.h"
 #include "rocksdb/utilities/checkpoint.h"
 #include "src/fs/local_filesystem.h"
 
@@ -44,6 +46,18 @@ using ::curve::common::TimeUtility;
 
 const std::string RocksDBStorage::kDelimiter_ = ":";  // NOLINT
 
+namespace {
+
+// Batch transaction of the calling thread, see RocksDBStorage::BeginBatch()
+struct BatchContext {
+    const TransactionDB* txnDB = nullptr;
+    Transaction* txn = nullptr;
+};
+
+thread_local BatchContext batchContext;
+
+}  // namespace
+
 Status ToStorageStatus(const ROCKSDB_NAMESPACE::Status& s) {
     if (s.ok()) {
         return Status::OK();
@@ -79,7 +93,8 @@ RocksDBStorage::RocksDBStorage(StorageOptions options)
 }
 
 RocksDBStorage::RocksDBStorage(const RocksDBStorage& storage,
-                               ROCKSDB_NAMESPACE::Transaction* txn)
+                               ROCKSDB_NAMESPACE::Transaction* txn,
+                               bool nested)
     : inited_(storage.inited_),
       options_(storage.options_),
       db_(storage.db_),
@@ -87,6 +102,7 @@ RocksDBStorage::RocksDBStorage(const RocksDBStorage& storage,
       handles_(storage.handles_),
       InTransaction_(true),
       txn_(txn),
+      nested_(nested),
       dbOptions_(storage.dbOptions_),
       dbTransOptions_(storage.dbTransOptions_),
       dbWriteOptions_(storage.dbWriteOptions_),
@@ -183,10 +199,8 @@ std::string RocksDBStorage::ToInternalName(const std::string& name,
 std::string RocksDBStorage::ToInternalKey(const std::string& name,
                                           const std::string& key,
                                           bool ordered) {
-    std::string iname = ToInternalName(name, ordered, true);
-    std::ostringstream oss;
-    oss << iname << kDelimiter_ << key;
-    std::string ikey = oss.str();
+    std::string ikey =
+        absl::StrCat(ToInternalName(name, ordered, true), kDelimiter_, key);
     VLOG(9) << "ikey = " << ikey << " (ordered = " << ordered
             << ", name = " << name << ", key = " << key << ")"
             << ", size = " << ikey.size();
@@ -210,9 +224,10 @@ Status RocksDBStorage::Get(const std::string& name,
     std::string svalue;
     std::string ikey = ToInternalKey(name, key, ordered);
     auto handle = GetColumnFamilyHandle(ordered);
+    auto txn = ActiveTransaction();
     {
         RocksDBPerfGuard guard(OP_GET);
-        s = InTransaction_ ? txn_->Get(dbReadOptions_, handle, ikey, &svalue) :
+        s = txn != nullptr ? txn->Get(dbReadOptions_, handle, ikey, &svalue) :
                              db_->Get(dbReadOptions_, handle, ikey, &svalue);
     }
     if (s.ok() && !value->ParseFromString(svalue)) {
@@ -234,9 +249,10 @@ Status RocksDBStorage::Set(const std::string& name,
 
     auto handle = GetColumnFamilyHandle(ordered);
     std::string ikey = ToInternalKey(name, key, ordered);
+    auto txn = ActiveTransaction();
     RocksDBPerfGuard guard(OP_PUT);
-    ROCKSDB_NAMESPACE::Status s = InTransaction_ ?
-        txn_->Put(handle, ikey, svalue) :
+    ROCKSDB_NAMESPACE::Status s = txn != nullptr ?
+        txn->Put(handle, ikey, svalue) :
         db_->Put(dbWriteOptions_, handle, ikey, svalue);
     return ToStorageStatus(s);
 }
@@ -250,9 +266,10 @@ Status RocksDBStorage::Del(const std::string& name,
 
     std::string ikey = ToInternalKey(name, key, ordered);
     auto handle = GetColumnFamilyHandle(ordered);
+    auto txn = ActiveTransaction();
     RocksDBPerfGuard guard(OP_DELETE);
-    ROCKSDB_NAMESPACE::Status s = InTransaction_ ?
-        txn_->Delete(handle, ikey) :
+    ROCKSDB_NAMESPACE::Status s = txn != nullptr ?
+        txn->Delete(handle, ikey) :
         db_->Delete(dbWriteOptions_, handle, ikey);
     return ToStorageStatus(s);
 }
@@ -289,7 +306,7 @@ size_t RocksDBStorage::Size(const std::string& name, bool ordered) {
 Status RocksDBStorage::Clear(const std::string& name, bool ordered) {
     if (!inited_) {
         return Status::DBClosed();
-    } else if (InTransaction_) {
+    } else if (ActiveTransaction() != nullptr) {
         return Status::NotSupported();
     }
 
@@ -311,6 +328,13 @@ Status RocksDBStorage::Clear(const std::string& name, bool ordered) {
 }
 
 std::shared_ptr<StorageTransaction> RocksDBStorage::BeginTransaction() {
+    // nest the transaction into the batch by a savepoint
+    if (!InTransaction_ && ActiveTransaction() != nullptr) {
+        ROCKSDB_NAMESPACE::Transaction* txn = ActiveTransaction();
+        txn->SetSavePoint();
+        return std::make_shared<RocksDBStorage>(*this, txn, true);
+    }
+
     RocksDBPerfGuard guard(OP_BEGIN_TRANSACTION);
     ROCKSDB_NAMESPACE::Transaction* txn =
         txnDB_->BeginTransaction(dbWriteOptions_);
@@ -323,6 +347,9 @@ std::shared_ptr<StorageTransaction> RocksDBStorage::BeginTransaction() {
 Status RocksDBStorage::Commit() {
     if (!InTransaction_ || nullptr == txn_) {
         return Status::NotSupported();
+    } else if (nested_) {
+        // writes are kept in the batch
+        return ToStorageStatus(txn_->PopSavePoint());
     }
 
     RocksDBPerfGuard guard(OP_COMMIT_TRANSACTION);
@@ -338,6 +365,9 @@ Status RocksDBStorage::Commit() {
 Status RocksDBStorage::Rollback()  {
     if (!InTransaction_ || nullptr == txn_) {
         return Status::NotSupported();
+    } else if (nested_) {
+        // only undo writes since the transaction begins
+        return ToStorageStatus(txn_->RollbackToSavePoint());
     }
 
     RocksDBPerfGuard guard(OP_ROLLBACK_TRANSACTION);
@@ -350,6 +380,53 @@ Status RocksDBStorage::Rollback()  {
     return ToStorageStatus(s);
 }
 
+Status RocksDBStorage::BeginBatch() {
+    if (!inited_) {
+        return Status::DBClosed();
+    } else if (InTransaction_ || batchContext.txn != nullptr) {
+        return Status::NotSupported();
+    }
+
+    RocksDBPerfGuard guard(OP_BEGIN_TRANSACTION);
+    ROCKSDB_NAMESPACE::Transaction* txn =
+        txnDB_->BeginTransaction(dbWriteOptions_);
+    if (nullptr == txn) {
+        return Status::InternalError();
+    }
+    batchContext.txnDB = txnDB_;
+    batchContext.txn = txn;
+    return Status::OK();
+}
+
+Status RocksDBStorage::CommitBatch() {
+    if (InTransaction_ || batchContext.txn == nullptr ||
+        batchContext.txnDB != txnDB_) {
+        return Status::NotSupported();
+    }
+
+    ROCKSDB_NAMESPACE::Transaction* txn = batchContext.txn;
+    batchContext = BatchContext();
+
+    RocksDBPerfGuard guard(OP_COMMIT_TRANSACTION);
+    ROCKSDB_NAMESPACE::Status s = txn->Commit();
+    if (!s.ok()) {
+        LOG(ERROR) << "RocksDBStorage commit batch failed"
+                   << ", status=" << s.ToString();
+    }
+    // an uncommitted transaction is rolled back when it's deleted
+    delete txn;
+    return ToStorageStatus(s);
+}
+
+ROCKSDB_NAMESPACE::Transaction* RocksDBStorage::ActiveTransaction() const {
+    if (InTransaction_) {
+        return txn_;
+    } else if (batchContext.txn != nullptr && batchContext.txnDB == txnDB_) {
+        return batchContext.txn;
+    }
+    return nullptr;
+}
+
 StorageOptions RocksDBStorage::GetStorageOptions() const {
     return options_;
 }
@@ -430,10 +507,45 @@ bool DuplicateRocksdbCheckpoint(const std::string& from,
     return DoCheckpoint(db, to);
 }
 
+// Table files are immutable, and the session of DB which created the file
+// together with its original file number identify the file's content (it's
+// also how rocksdb generates the unique id of table file), so use them as
+// checksum instead of reading the whole file.
+void GetTableChecksums(
+    rocksdb::DB* db,
+    const std::vector<rocksdb::ColumnFamilyHandle*>& handles,
+    std::unordered_map<std::string, std::string>* checksums) {
+    for (auto* handle : handles) {
+        rocksdb::TablePropertiesCollection props;
+        auto status = db->GetPropertiesOfAllTables(handle, &props);
+        if (!status.ok()) {
+            LOG(WARNING) << "Failed to get properties of tables, "
+                         << status.ToString();
+            continue;
+        }
+
+        for (const auto& prop : props) {
+            if (prop.second->db_session_id.empty() ||
+                prop.second->orig_file_number == 0) {
+                continue;
+            }
+
+            std::string filename = prop.first;
+            auto pos = filename.rfind('/');
+            if (pos != std::string::npos) {
+                filename = filename.substr(pos + 1);
+            }
+            (*checksums)[filename] =
+                absl::StrCat(prop.second->db_session_id, "-",
+                             prop.second->orig_file_number);
+        }
+    }
+}
+
 }  // namespace
 
 bool RocksDBStorage::Checkpoint(const std::string& dir,
-                                std::vector<std::string>* files) {
+                                std::vector<CheckpointFile>* files) {
     rocksdb::FlushOptions options;
     options.wait = true;
     options.allow_write_stall = true;
@@ -457,9 +569,16 @@ bool RocksDBStorage::Checkpoint(const std::string& dir,
         return false;
     }
 
+    // files without checksum (e.g. MANIFEST, CURRENT) are small, and they
+    // are always transferred while installing snapshot
+    std::unordered_map<std::string, std::string> checksums;
+    GetTableChecksums(db_, handles_, &checksums);
+
     files->reserve(filenames.size());
     for (const auto& f : filenames) {
-        files->push_back(std::string(kRocksdbCheckpointPath) + "/" + f);
+        auto it = checksums.find(f);
+        files->push_back({std::string(kRocksdbCheckpointPath) + "/" + f,
+                          it != checksums.end() ? it->second : ""});
     }
 
     return true;
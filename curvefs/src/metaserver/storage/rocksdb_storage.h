@@ -73,7 +73,8 @@ class RocksDBStorage : public KVStorage, public StorageTransaction {
 
     explicit RocksDBStorage(StorageOptions options);
 
-    RocksDBStorage(const RocksDBStorage& storage, Transaction* txn);
+    RocksDBStorage(const RocksDBStorage& storage, Transaction* txn,
+                   bool nested = false);
 
     bool Open() override;
 
@@ -126,8 +127,14 @@ class RocksDBStorage : public KVStorage, public StorageTransaction {
 
     Status Rollback() override;
 
+    // The batch transaction is kept in thread local storage, so partitions
+    // applied by other threads are not affected
+    Status BeginBatch() override;
+
+    Status CommitBatch() override;
+
     bool Checkpoint(const std::string& dir,
-                    std::vector<std::string>* files) override;
+                    std::vector<CheckpointFile>* files) override;
 
     bool Recover(const std::string& dir) override;
 
@@ -146,6 +153,11 @@ class RocksDBStorage : public KVStorage, public StorageTransaction {
 
     std::string ToUserKey(const std::string& ikey);
 
+    // Return the transaction which reads and writes go through, it's
+    // either current transaction or the batch transaction of the calling
+    // thread, nullptr means read and write the database directly
+    Transaction* ActiveTransaction() const;
+
     Status Get(const std::string& name,
                const std::string& key,
                ValueType* value,
@@ -198,6 +210,8 @@ class RocksDBStorage : public KVStorage, public StorageTransaction {
     // only for transaction
     bool InTransaction_;
     Transaction* txn_ = nullptr;
+    // whether the transaction is nested into a batch, see BeginBatch()
+    bool nested_ = false;
 
     // db options
     rocksdb::DBOptions dbOptions_;
@@ -285,12 +299,13 @@ class RocksDBStorageIterator : public Iterator {
           status_(status),
           prefixChecking_(true),
           ordered_(ordered),
-          iter_(nullptr) {
+          iter_(nullptr),
+          txn_(storage->ActiveTransaction()) {
         RocksDBPerfGuard guard(OP_GET_SNAPSHOT);
         if (status_ == 0) {
             readOptions_ = storage_->dbReadOptions_;
-            if (storage_->InTransaction_) {
-                readOptions_.snapshot = storage_->txn_->GetSnapshot();
+            if (txn_ != nullptr) {
+                readOptions_.snapshot = txn_->GetSnapshot();
             } else {
                 readOptions_.snapshot = storage_->db_->GetSnapshot();
             }
@@ -300,8 +315,8 @@ class RocksDBStorageIterator : public Iterator {
     ~RocksDBStorageIterator() {
         RocksDBPerfGuard guard(OP_CLEAR_SNAPSHOT);
         if (status_ == 0) {
-            if (storage_->InTransaction_) {
-                storage_->txn_->ClearSnapshot();
+            if (txn_ != nullptr) {
+                txn_->ClearSnapshot();
             } else {
                 storage_->db_->ReleaseSnapshot(readOptions_.snapshot);
             }
@@ -327,8 +342,8 @@ class RocksDBStorageIterator : public Iterator {
         auto handler = storage_->GetColumnFamilyHandle(ordered_);
         {
             RocksDBPerfGuard guard(OP_GET_ITERATOR);
-            if (storage_->InTransaction_) {
-                iter_.reset(storage_->txn_->GetIterator(readOptions_, handler));
+            if (txn_ != nullptr) {
+                iter_.reset(txn_->GetIterator(readOptions_, handler));
             } else {
                 iter_.reset(storage_->db_->NewIterator(readOptions_, handler));
             }
@@ -381,6 +396,7 @@ class RocksDBStorageIterator : public Iterator {
     bool prefixChecking_;
     bool ordered_;
     std::unique_ptr<rocksdb::Iterator> iter_;
+    Transaction* txn_;
     rocksdb::ReadOptions readOptions_;
 };
 
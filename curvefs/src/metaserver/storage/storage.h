@@ -37,6 +37,16 @@ namespace storage {
 
 using ::curvefs::metaserver::storage::Iterator;
 
+// File in the checkpoint of storage
+struct CheckpointFile {
+    // relative filename under the checkpoint directory
+    std::string filename;
+    // identity of the file's content, files with the same checksum have the
+    // same content, so raft can skip transferring the file to the follower
+    // which already has it, empty if unknown
+    std::string checksum;
+};
+
 // The interface inspired by redis, see also https://redis.io/commands
 class BaseStorage {
  public:
@@ -105,10 +115,23 @@ class KVStorage : public BaseStorage {
 
     virtual std::shared_ptr<StorageTransaction> BeginTransaction() = 0;
 
-    // Save storage's data into the destination directory, and return relative
-    // filenames of current checkpoint under the directory
+    // Collect writes of the calling thread into one transaction until
+    // CommitBatch() is called, transactions begun inside the batch are
+    // nested into it, i.e., their rollback only undoes their own writes.
+    // Storage without transaction can't make the writes atomic, so both
+    // return NotSupported by default.
+    virtual Status BeginBatch() {
+        return Status::NotSupported();
+    }
+
+    virtual Status CommitBatch() {
+        return Status::NotSupported();
+    }
+
+    // Save storage's data into the destination directory, and return files
+    // of current checkpoint under the directory
     virtual bool Checkpoint(const std::string& dir,
-                            std::vector<std::string>* files) = 0;
+                            std::vector<CheckpointFile>* files) = 0;
 
     // Recover storage from a given directory
     virtual bool Recover(const std::string& dir) = 0;
@@ -26,12 +26,16 @@
 #include <fstream>
 #include <algorithm>
 #include <functional>
+#include <utility>
+#include <vector>
 
 #include "src/common/string_util.h"
 #include "src/fs/fs_common.h"
 #include "src/fs/local_filesystem.h"
 #include "src/fs/ext4_filesystem_impl.h"
 #include "curvefs/src/metaserver/storage/utils.h"
+#include "curvefs/src/metaserver/storage/converter.h"
+#include "curvefs/src/metaserver/common/types.h"
 
 namespace curvefs {
 namespace metaserver {
@@ -92,6 +96,78 @@ bool GetProcMemory(uint64_t* vmRSS) {
     return false;
 }
 
+bool MigrateLegacyKeys(KVStorage* storage,
+                       const std::string& name,
+                       bool ordered,
+                       ValueType* value) {
+    auto iterator = ordered ? storage->SGetAll(name) : storage->HGetAll(name);
+    if (iterator->Status() != 0) {
+        LOG(ERROR) << "Failed to get iterator for table "
+                   << StringToHex(name);
+        return false;
+    }
+
+    // collect keys first, as iterator of memory storage is invalidated
+    // by modification
+    Converter conv;
+    std::string key;
+    std::vector<std::pair<std::string, std::string>> keys;
+    for (iterator->SeekToFirst(); iterator->Valid(); iterator->Next()) {
+        std::string legacy = iterator->Key();
+        if (!conv.UpgradeKey(legacy, &key)) {
+            LOG(ERROR) << "Failed to parse key `" << legacy << "` of table "
+                       << StringToHex(name);
+            return false;
+        } else if (key != legacy) {
+            keys.emplace_back(std::move(legacy), key);
+        }
+    }
+
+    if (keys.empty()) {
+        return true;
+    }
+
+    auto txn = storage->BeginTransaction();
+    if (nullptr == txn) {
+        LOG(ERROR) << "Failed to begin transaction";
+        return false;
+    }
+
+    Status s;
+    for (const auto& item : keys) {
+        if (ordered) {
+            s = txn->SGet(name, item.first, value);
+            s = s.ok() ? txn->SSet(name, item.second, *value) : s;
+            s = s.ok() ? txn->SDel(name, item.first) : s;
+        } else {
+            s = txn->HGet(name, item.first, value);
+            s = s.ok() ? txn->HSet(name, item.second, *value) : s;
+            s = s.ok() ? txn->HDel(name, item.first) : s;
+        }
+
+        if (!s.ok()) {
+            LOG(ERROR) << "Failed to migrate key `" << item.first
+                       << "` of table " << StringToHex(name)
+                       << ", status = " << s.ToString();
+            break;
+        }
+    }
+
+    if (!s.ok()) {
+        if (!txn->Rollback().ok()) {
+            LOG(ERROR) << "Rollback transaction failed";
+        }
+        return false;
+    } else if (!txn->Commit().ok()) {
+        LOG(ERROR) << "Commit transaction failed";
+        return false;
+    }
+
+    LOG(INFO) << "Migrated " << keys.size() << " keys of table "
+              << StringToHex(name);
+    return true;
+}
+
 }  // namespace storage
 }  // namespace metaserver
 }  // namespace curvefs
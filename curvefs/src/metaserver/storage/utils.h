@@ -29,6 +29,7 @@
 
 #include "absl/container/btree_set.h"
 #include "src/common/concurrent/rw_lock.h"
+#include "curvefs/src/metaserver/storage/storage.h"
 
 namespace curvefs {
 namespace metaserver {
@@ -42,6 +43,13 @@ bool GetFileSystemSpaces(const std::string& path,
 
 bool GetProcMemory(uint64_t* vmRSS);
 
+// Rewrite keys saved by previous versions in table |name| into current
+// format (see Converter::UpgradeKey), |value| holds the value being moved.
+bool MigrateLegacyKeys(KVStorage* storage,
+                       const std::string& name,
+                       bool ordered,
+                       ValueType* value);
+
 }  // namespace storage
 }  // namespace metaserver
 }  // namespace curvefs
@@ -33,13 +33,15 @@ namespace curvefs {
 namespace metaserver {
 namespace storage {
 
+// ValueWrapper is immutable, so copies of it share the same message
 class ValueWrapper {
  public:
     ValueWrapper() = default;
 
     explicit ValueWrapper(const ValueType& value) {
-        value_.reset(value.New());
-        value_->CopyFrom(value);
+        ValueType* message = value.New();
+        message->CopyFrom(value);
+        value_.reset(message);
     }
 
     void Swap(ValueWrapper& other) noexcept {
@@ -54,7 +56,7 @@ class ValueWrapper {
     }
 
  private:
-    std::unique_ptr<ValueType> value_;
+    std::shared_ptr<const ValueType> value_;
 };
 
 }  // namespace storage
@@ -58,5 +58,50 @@ MetaStatusCode StreamingSendVolumeExtent(StreamConnection* connection,
     return MetaStatusCode::OK;
 }
 
+namespace {
+
+const int kDentryPlusBatchSize = 1024;
+
+}  // namespace
+
+MetaStatusCode StreamingSendDentryPlus(StreamConnection* connection,
+                                       const DentryPlusList& entries) {
+    VLOG(9) << "StreamingSendDentryPlus, dentrys: " << entries.dentrys_size()
+            << ", attrs: " << entries.attr_size();
+    int dentryIndex = 0;
+    int attrIndex = 0;
+    while (dentryIndex < entries.dentrys_size() ||
+           attrIndex < entries.attr_size()) {
+        DentryPlusList batch;
+        for (int i = 0; i < kDentryPlusBatchSize &&
+                        dentryIndex < entries.dentrys_size(); i++) {
+            *batch.add_dentrys() = entries.dentrys(dentryIndex++);
+        }
+        for (int i = 0; i < kDentryPlusBatchSize &&
+                        attrIndex < entries.attr_size(); i++) {
+            *batch.add_attr() = entries.attr(attrIndex++);
+        }
+
+        butil::IOBuf data;
+        butil::IOBufAsZeroCopyOutputStream wrapper(&data);
+        if (!batch.SerializeToZeroCopyStream(&wrapper)) {
+            LOG(ERROR) << "Serialize dentry plus list failed";
+            return MetaStatusCode::PARAM_ERROR;
+        }
+
+        if (!connection->Write(data)) {
+            LOG(ERROR) << "Stream write dentry plus list failed";
+            return MetaStatusCode::RPC_STREAM_ERROR;
+        }
+    }
+
+    if (!connection->WriteDone()) {
+        LOG(ERROR) << "Stream write done failed in server side";
+        return MetaStatusCode::RPC_STREAM_ERROR;
+    }
+
+    return MetaStatusCode::OK;
+}
+
 }  // namespace metaserver
 }  // namespace curvefs
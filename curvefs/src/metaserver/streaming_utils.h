@@ -34,6 +34,10 @@ using ::curvefs::common::StreamConnection;
 MetaStatusCode StreamingSendVolumeExtent(StreamConnection* connection,
                                          const VolumeExtentSliceList& extents);
 
+// send dentrys and attributes in batches, each batch is a DentryPlusList
+MetaStatusCode StreamingSendDentryPlus(StreamConnection* connection,
+                                       const DentryPlusList& entries);
+
 }  // namespace metaserver
 }  // namespace curvefs
 
@@ -23,6 +23,7 @@
 #include <iostream>
 
 #include <functional>
+#include <string>
 #include <unordered_map>
 #include <vector>
 
@@ -58,12 +59,14 @@ DECLARE_string(s3_bucket_name);
 DECLARE_uint64(s3_blocksize);
 DECLARE_uint64(s3_chunksize);
 DECLARE_uint32(s3_objectPrefix);
+DECLARE_string(s3_objectCodec);
 DECLARE_uint32(rpcTimeoutMs);
 DECLARE_uint32(rpcRetryTimes);
 DECLARE_bool(enableSumInDir);
 DECLARE_uint64(capacity);
 DECLARE_string(user);
 DECLARE_uint32(recycleTimeHour);
+DECLARE_bool(enableFollowerRead);
 
 namespace curvefs {
 namespace tools {
@@ -72,6 +75,7 @@ namespace create {
 using ::curve::common::is_aligned;
 using ::curvefs::common::BitmapLocation;
 using ::curvefs::common::BitmapLocation_Parse;
+using ::curvefs::common::ObjectCodecType;
 
 void CreateFsTool::PrintHelp() {
     CurvefsToolRpc::PrintHelp();
@@ -83,6 +87,7 @@ void CreateFsTool::PrintHelp() {
               << "] [-rpcTimeoutMs=" << FLAGS_rpcTimeoutMs
               << " -rpcRetryTimes=" << FLAGS_rpcRetryTimes << "]"
               << "] [recycleTimeHour=" << FLAGS_recycleTimeHour
+              << "] [-enableFollowerRead=" << FLAGS_enableFollowerRead
               << "] \n[-fsType=volume -volumeBlockGroupSize="
               << FLAGS_volumeBlockGroupSize
               << " -volumeBlockSize=" << FLAGS_volumeBlockSize
@@ -100,6 +105,7 @@ void CreateFsTool::PrintHelp() {
               << " -s3_blocksize=" << FLAGS_s3_blocksize
               << " -s3_chunksize=" << FLAGS_s3_chunksize
               << " -s3_objectPrefix=" << FLAGS_s3_objectPrefix
+              << " -s3_objectCodec=none|lz4|zstd"
               << "]\n[-fsType=hybrid -volumeBlockGroupSize="
               << FLAGS_volumeBlockGroupSize
               << " -volumeBlockSize=" << FLAGS_volumeBlockSize
@@ -113,6 +119,7 @@ void CreateFsTool::PrintHelp() {
               << " -s3_blocksize=" << FLAGS_s3_blocksize
               << " -s3_chunksize=" << FLAGS_s3_chunksize
               << " -s3_objectPrefix=" << FLAGS_s3_objectPrefix
+              << " -s3_objectCodec=none|lz4|zstd"
               << "]" << std::endl;
 }
 
@@ -134,10 +141,12 @@ void CreateFsTool::AddUpdateFlags() {
     AddUpdateFlagsFunc(curvefs::tools::SetS3_blocksize);
     AddUpdateFlagsFunc(curvefs::tools::SetS3_chunksize);
     AddUpdateFlagsFunc(curvefs::tools::SetS3_objectPrefix);
+    AddUpdateFlagsFunc(curvefs::tools::SetS3_objectCodec);
     AddUpdateFlagsFunc(curvefs::tools::SetRpcTimeoutMs);
     AddUpdateFlagsFunc(curvefs::tools::SetRpcRetryTimes);
     AddUpdateFlagsFunc(curvefs::tools::SetEnableSumInDir);
     AddUpdateFlagsFunc(curvefs::tools::SetRecycleTimeHour);
+    AddUpdateFlagsFunc(curvefs::tools::SetEnableFollowerRead);
 }
 
 namespace {
@@ -152,6 +161,19 @@ google::protobuf::RepeatedPtrField<::std::string> ParseVolumeCluster(
 
     return res;
 }
+
+bool ParseObjectCodec(const std::string& name, ObjectCodecType* codec) {
+    static const std::unordered_map<std::string, ObjectCodecType> codecs{
+        {"none", curvefs::common::CODEC_NONE},
+        {"lz4", curvefs::common::CODEC_LZ4},
+        {"zstd", curvefs::common::CODEC_ZSTD}};
+    auto iter = codecs.find(name);
+    if (iter == codecs.end()) {
+        return false;
+    }
+    *codec = iter->second;
+    return true;
+}
 }  // namespace
 
 int CreateFsTool::Init() {
@@ -168,8 +190,15 @@ int CreateFsTool::Init() {
     request.set_blocksize(FLAGS_blockSize);
     request.set_enablesumindir(FLAGS_enableSumInDir);
     request.set_recycletimehour(FLAGS_recycleTimeHour);
+    request.set_enablefollowerread(FLAGS_enableFollowerRead);
 
     auto SetS3Request = [&]() -> int {
+        ObjectCodecType codec;
+        if (!ParseObjectCodec(FLAGS_s3_objectCodec, &codec)) {
+            std::cerr << "s3_objectCodec should be one of [none, lz4, zstd]";
+            return -1;
+        }
+
         request.set_fstype(common::FSType::TYPE_S3);
         auto* s3 = new common::S3Info();
         s3->set_ak(FLAGS_s3_ak);
@@ -179,6 +208,7 @@ int CreateFsTool::Init() {
         s3->set_blocksize(FLAGS_s3_blocksize);
         s3->set_chunksize(FLAGS_s3_chunksize);
         s3->set_objectprefix(FLAGS_s3_objectPrefix);
+        s3->set_objectcodec(codec);
         request.mutable_fsdetail()->set_allocated_s3info(s3);
         return 0;
     };
@@ -75,6 +75,8 @@ DEFINE_string(s3_bucket_name, "bucketname", "s3 bucket name");
 DEFINE_uint64(s3_blocksize, 1048576, "s3 block size");
 DEFINE_uint64(s3_chunksize, 4194304, "s3 chunk size");
 DEFINE_uint32(s3_objectPrefix, 0, "object prefix");
+DEFINE_string(s3_objectCodec, "none",
+              "codec of s3 objects, support |none|, |lz4| and |zstd|");
 DEFINE_bool(enableSumInDir, false, "statistic info in xattr");
 DEFINE_uint64(capacity, (uint64_t)100 * 1024 * 1024 * 1024,
               "capacity of fs, default 100G");
@@ -82,6 +84,8 @@ DEFINE_string(user, "anonymous", "user of request");
 DEFINE_string(inodeId, "1,2,3", "inodes id");
 
 DEFINE_uint32(recycleTimeHour, 1, "recycle time hour");
+DEFINE_bool(enableFollowerRead, false,
+            "whether readonly metadata requests can be served by followers");
 
 // list-topology
 DEFINE_string(jsonPath, "/tmp/topology.json", "output json path");
@@ -256,6 +260,12 @@ std::function<void(curve::common::Configuration*, google::CommandLineFlagInfo*)>
                   std::placeholders::_2, "s3_objectPrefix", "s3.objectPrefix",
                   &FLAGS_s3_objectPrefix);
 
+std::function<void(curve::common::Configuration*, google::CommandLineFlagInfo*)>
+    SetS3_objectCodec =
+        std::bind(&SetDiffFlagInfo<fLS::clstring>, std::placeholders::_1,
+                  std::placeholders::_2, "s3_objectCodec", "s3.objectCodec",
+                  &FLAGS_s3_objectCodec);
+
 std::function<void(curve::common::Configuration*, google::CommandLineFlagInfo*)>
     SetEnableSumInDir = std::bind(&SetFlagInfo<bool>, std::placeholders::_1,
                                   std::placeholders::_2, "enableSumInDir",
@@ -276,6 +286,12 @@ std::function<void(curve::common::Configuration*, google::CommandLineFlagInfo*)>
         &SetFlagInfo<uint32_t>, std::placeholders::_1, std::placeholders::_2,
         "recycleTimeHour", &FLAGS_recycleTimeHour);
 
+std::function<void(curve::common::Configuration*, google::CommandLineFlagInfo*)>
+    SetEnableFollowerRead = std::bind(&SetFlagInfo<bool>, std::placeholders::_1,
+                                      std::placeholders::_2,
+                                      "enableFollowerRead",
+                                      &FLAGS_enableFollowerRead);
+
 /* check flag */
 std::function<bool(google::CommandLineFlagInfo*)> CheckMetaserverIdDefault =
     std::bind(&CheckFlagInfoDefault<fLS::clstring>, std::placeholders::_1,
@@ -392,6 +408,10 @@ std::string CopysetOpStatus2Str(
             COPYSET_OP_STATUS_PEER_MISMATCH:
             ret << "parse mismatch ";
             break;
+        case metaserver::copyset::COPYSET_OP_STATUS::
+            COPYSET_OP_STATUS_NOT_LEASE_LEADER:
+            ret << "not lease leader ";
+            break;
         case metaserver::copyset::COPYSET_OP_STATUS::
             COPYSET_OP_STATUS_FAILURE_UNKNOWN:
         default:
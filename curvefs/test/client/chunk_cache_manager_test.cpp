@@ -23,6 +23,9 @@
 #include <gtest/gtest.h>
 #include <gmock/gmock.h>
 
+#include <string>
+#include <vector>
+
 #include "curvefs/src/client/s3/client_s3_adaptor.h"
 #include "curvefs/src/client/s3/client_s3_cache_manager.h"
 #include "curvefs/test/client/mock_client_s3_cache_manager.h"
@@ -87,6 +90,76 @@ TEST_F(ChunkCacheManagerTest, test_write_new_data) {
     delete[] buf;
 }
 
+TEST_F(ChunkCacheManagerTest, test_file_dirty_bytes) {
+    uint64_t len = 1024;
+    char *buf = new char[len];
+    auto fsCacheManager = s3ClientAdaptor_->GetFsCacheManager();
+    DirtyBytesPtr fileDirtyBytes =
+        std::make_shared<std::atomic<uint64_t>>(0);
+    auto chunkCacheManager = std::make_shared<ChunkCacheManager>(
+        1, s3ClientAdaptor_, nullptr, fileDirtyBytes);
+
+    chunkCacheManager->WriteNewDataCache(s3ClientAdaptor_, 0, len, buf);
+    chunkCacheManager->WriteNewDataCache(s3ClientAdaptor_, 2 * 65536, len,
+                                         buf);
+    ASSERT_EQ(2 * 65536, fileDirtyBytes->load());
+    ASSERT_EQ(2 * 65536, fsCacheManager->GetDataCacheSize());
+    ASSERT_EQ(1, fsCacheManager->GetDirtyFileNum());
+
+    chunkCacheManager->TruncateCache(65536);
+    ASSERT_EQ(65536, fileDirtyBytes->load());
+    ASSERT_EQ(1, fsCacheManager->GetDirtyFileNum());
+    chunkCacheManager->ReleaseCache();
+    ASSERT_EQ(0, fileDirtyBytes->load());
+    ASSERT_EQ(0, fsCacheManager->GetDataCacheSize());
+    ASSERT_EQ(0, fsCacheManager->GetDirtyFileNum());
+
+    delete[] buf;
+}
+
+TEST_F(ChunkCacheManagerTest, test_read_by_read_cache_segments) {
+    uint64_t offset = 64 * 1024;
+    uint64_t len = 512 * 1024;
+    std::string data(len, '\0');
+    for (uint64_t i = 0; i < len; i++) {
+        data[i] = 'a' + i % 26;
+    }
+    auto dataCache = std::make_shared<DataCache>(
+        s3ClientAdaptor_, chunkCacheManager_, offset, len, data.data(),
+        nullptr);
+    chunkCacheManager_->AddReadDataCache(dataCache);
+
+    // cross pages
+    std::vector<CacheSegment> segments;
+    uint64_t readPos = offset + 1000;
+    uint64_t readLen = 200 * 1024;
+    ASSERT_TRUE(chunkCacheManager_->ReadByReadCacheSegments(
+        readPos, readLen, &segments));
+    std::string read;
+    for (const auto &segment : segments) {
+        ASSERT_EQ(dataCache, segment.holder);
+        read.append(segment.data, segment.len);
+    }
+    ASSERT_EQ(data.substr(1000, readLen), read);
+
+    // not all in read cache
+    segments.clear();
+    ASSERT_FALSE(chunkCacheManager_->ReadByReadCacheSegments(
+        0, 128 * 1024, &segments));
+    ASSERT_FALSE(chunkCacheManager_->ReadByReadCacheSegments(
+        offset + len - 100, 200, &segments));
+
+    // overlapped by newer data in write cache
+    chunkCacheManager_->WriteNewDataCache(s3ClientAdaptor_, offset + 4096,
+                                          100, data.data());
+    ASSERT_FALSE(chunkCacheManager_->ReadByReadCacheSegments(
+        offset, 8192, &segments));
+    ASSERT_TRUE(chunkCacheManager_->ReadByReadCacheSegments(
+        offset + 4196, 8192, &segments));
+
+    chunkCacheManager_->ReleaseCacheForTest();
+}
+
 TEST_F(ChunkCacheManagerTest, test_add_read_data_cache) {
      VLOG(0) << "wghs000";
     uint64_t offset = 0;
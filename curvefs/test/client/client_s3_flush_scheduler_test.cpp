@@ -0,0 +1,142 @@
+/*
+ *  Copyright (c) 2023 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>  // NOLINT
+#include <mutex>  // NOLINT
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "curvefs/src/client/s3/client_s3_flush_scheduler.h"
+
+namespace curvefs {
+namespace client {
+
+class FlushSchedulerTest : public ::testing::Test {
+ protected:
+    void SetUp() override {
+        started_.store(false);
+        released_.store(false);
+        scheduler_.Start(1);
+        // hold the only worker, so the tasks below are all queued
+        scheduler_.Enqueue(kGateInode, [this]() {
+            started_.store(true);
+            while (!released_.load()) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+        });
+        while (!started_.load()) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+
+    void Enqueue(uint64_t inodeId, int num) {
+        for (int i = 0; i < num; i++) {
+            scheduler_.Enqueue(inodeId, [this, inodeId]() {
+                std::lock_guard<std::mutex> lk(mtx_);
+                order_.push_back(inodeId);
+            });
+        }
+    }
+
+    // release the worker and wait all tasks done
+    void Drain() {
+        released_.store(true);
+        scheduler_.Stop();
+        ASSERT_EQ(0, scheduler_.GetQueuedTaskNum());
+    }
+
+    static const uint64_t kGateInode = 100;
+
+    FlushScheduler scheduler_;
+    std::atomic<bool> started_;
+    std::atomic<bool> released_;
+    std::mutex mtx_;
+    std::vector<uint64_t> order_;
+};
+
+TEST_F(FlushSchedulerTest, RoundRobinTest) {
+    Enqueue(1, 4);
+    Enqueue(2, 2);
+    Enqueue(3, 1);
+    ASSERT_EQ(7, scheduler_.GetQueuedTaskNum());
+    Drain();
+    ASSERT_EQ(std::vector<uint64_t>({1, 2, 3, 1, 2, 1, 1}), order_);
+}
+
+TEST_F(FlushSchedulerTest, SyncFirstTest) {
+    Enqueue(1, 3);
+    Enqueue(2, 2);
+    // sync after queued
+    scheduler_.SyncBegin(2);
+    // sync before queued
+    scheduler_.SyncBegin(3);
+    Enqueue(3, 1);
+    Drain();
+    ASSERT_EQ(std::vector<uint64_t>({2, 3, 2, 1, 1, 1}), order_);
+    scheduler_.SyncEnd(2);
+    scheduler_.SyncEnd(3);
+}
+
+TEST_F(FlushSchedulerTest, BackgroundNotStarvedTest) {
+    {
+        FlushScheduler::SyncGuard guard(&scheduler_, 1);
+        Enqueue(1, 20);
+        Enqueue(2, 1);
+        Drain();
+    }
+    ASSERT_EQ(21, order_.size());
+    // one background task after every 8 sync tasks
+    ASSERT_EQ(2, order_[8]);
+}
+
+TEST(FlushSchedulerRunTest, NotRunningTest) {
+    FlushScheduler scheduler;
+    int done = 0;
+    scheduler.Enqueue(1, [&done]() { done++; });
+    ASSERT_EQ(1, done);
+
+    scheduler.Start(2);
+    scheduler.Stop();
+    scheduler.Enqueue(1, [&done]() { done++; });
+    ASSERT_EQ(2, done);
+}
+
+TEST(FlushSchedulerRunTest, ConcurrentTest) {
+    FlushScheduler scheduler;
+    scheduler.Start(4);
+    std::atomic<int> done(0);
+    std::vector<std::thread> threads;
+    for (uint64_t inodeId = 0; inodeId < 8; inodeId++) {
+        threads.emplace_back([&, inodeId]() {
+            FlushScheduler::SyncGuard guard(&scheduler, inodeId % 2);
+            for (int i = 0; i < 100; i++) {
+                scheduler.Enqueue(inodeId, [&done]() { done++; });
+            }
+        });
+    }
+    for (auto &t : threads) {
+        t.join();
+    }
+    scheduler.Stop();
+    ASSERT_EQ(800, done.load());
+    ASSERT_EQ(0, scheduler.GetQueuedTaskNum());
+}
+
+}  // namespace client
+}  // namespace curvefs
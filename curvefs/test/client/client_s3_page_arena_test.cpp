@@ -0,0 +1,123 @@
+/*
+ *  Copyright (c) 2023 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <set>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "curvefs/src/client/s3/client_s3_page_arena.h"
+
+namespace curvefs {
+namespace client {
+
+TEST(PageArenaTest, AllocateFreeTest) {
+    const uint32_t pageSize = 64 * 1024;
+    PageArena arena(pageSize, 16 * pageSize, true);
+    ASSERT_TRUE(arena.Init());
+    ASSERT_EQ(16 * pageSize, arena.GetCapacity());
+    ASSERT_FALSE(arena.IsExhausted());
+
+    std::vector<char *> pages;
+    std::set<char *> distinct;
+    for (int i = 0; i < 16; i++) {
+        char *page = arena.Allocate();
+        ASSERT_TRUE(arena.Contains(page));
+        memset(page, i, pageSize);
+        pages.push_back(page);
+        distinct.insert(page);
+    }
+    ASSERT_EQ(16, distinct.size());
+    ASSERT_TRUE(arena.IsExhausted());
+    ASSERT_EQ(16 * pageSize, arena.GetUsedBytes());
+    ASSERT_EQ(0, arena.GetOverflowBytes());
+
+    // exhausted, allocate from heap
+    char *overflow = arena.Allocate();
+    ASSERT_FALSE(arena.Contains(overflow));
+    ASSERT_EQ(pageSize, arena.GetOverflowBytes());
+    arena.Free(overflow);
+    ASSERT_EQ(0, arena.GetOverflowBytes());
+
+    // freed pages are reused
+    arena.Free(pages[3]);
+    arena.Free(pages[7]);
+    ASSERT_FALSE(arena.IsExhausted());
+    ASSERT_EQ(14 * pageSize, arena.GetUsedBytes());
+    std::set<char *> reused{arena.Allocate(), arena.Allocate()};
+    ASSERT_EQ((std::set<char *>{pages[3], pages[7]}), reused);
+    ASSERT_TRUE(arena.IsExhausted());
+
+    for (auto page : distinct) {
+        arena.Free(page);
+    }
+    ASSERT_EQ(0, arena.GetUsedBytes());
+}
+
+TEST(PageArenaTest, EmptyArenaTest) {
+    PageArena arena(4096, 0, false);
+    ASSERT_TRUE(arena.Init());
+    ASSERT_TRUE(arena.IsExhausted());
+
+    char *page = arena.Allocate();
+    ASSERT_NE(nullptr, page);
+    ASSERT_FALSE(arena.Contains(page));
+    ASSERT_EQ(4096, arena.GetOverflowBytes());
+    arena.Free(page);
+    ASSERT_EQ(0, arena.GetOverflowBytes());
+}
+
+TEST(PageArenaTest, ConcurrentTest) {
+    const uint32_t pageSize = 4096;
+    const int threadNum = 8;
+    PageArena arena(pageSize, 64 * pageSize, false);
+    ASSERT_TRUE(arena.Init());
+
+    // every page is owned by one thread at a time
+    std::vector<std::thread> threads;
+    std::atomic<int> corrupted(0);
+    for (int t = 0; t < threadNum; t++) {
+        threads.emplace_back([&, t]() {
+            std::vector<char *> pages;
+            for (int round = 0; round < 2000; round++) {
+                for (int i = 0; i < 16; i++) {
+                    char *page = arena.Allocate();
+                    memset(page, t, pageSize);
+                    pages.push_back(page);
+                }
+                for (auto page : pages) {
+                    if (page[0] != t || page[pageSize - 1] != t) {
+                        corrupted.fetch_add(1);
+                    }
+                    arena.Free(page);
+                }
+                pages.clear();
+            }
+        });
+    }
+    for (auto &t : threads) {
+        t.join();
+    }
+
+    ASSERT_EQ(0, corrupted.load());
+    ASSERT_EQ(0, arena.GetUsedBytes());
+    ASSERT_EQ(0, arena.GetOverflowBytes());
+}
+
+}  // namespace client
+}  // namespace curvefs
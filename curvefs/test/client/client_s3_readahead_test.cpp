@@ -0,0 +1,173 @@
+/*
+ *  Copyright (c) 2023 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include "curvefs/src/client/s3/client_s3_readahead.h"
+
+namespace curvefs {
+namespace client {
+
+namespace {
+
+const uint64_t kKiB = 1024;
+const uint64_t kMiB = 1024 * kKiB;
+
+ReadAheadOption TestOption() {
+    ReadAheadOption option;
+    option.enable = true;
+    option.minBytes = 1 * kMiB;
+    option.maxBytes = 8 * kMiB;
+    return option;
+}
+
+}  // namespace
+
+TEST(ReadAheadTest, SequentialStreamTest) {
+    ReadAhead readAhead(TestOption());
+    ReadAheadRange range;
+
+    // first read of a stream opens the first window after it
+    ASSERT_EQ(ReadAhead::Result::NONE,
+              readAhead.OnRead(0, 128 * kKiB, false, &range));
+    ASSERT_EQ(128 * kKiB, range.offset);
+    ASSERT_EQ(1 * kMiB, range.len);
+    ASSERT_EQ(1 * kMiB, readAhead.GetWindowSize());
+    readAhead.OnDone(range);
+
+    // the window is reached, next window doubles
+    ASSERT_EQ(ReadAhead::Result::HIT,
+              readAhead.OnRead(128 * kKiB, 128 * kKiB, true, &range));
+    ASSERT_EQ(128 * kKiB + 1 * kMiB, range.offset);
+    ASSERT_EQ(2 * kMiB, range.len);
+
+    // still in the previous window, nothing to issue
+    ASSERT_EQ(ReadAhead::Result::HIT,
+              readAhead.OnRead(256 * kKiB, 128 * kKiB, true, &range));
+    ASSERT_EQ(0, range.len);
+
+    // window grows up to maxBytes
+    uint64_t offset = 384 * kKiB;
+    uint64_t expected = 2 * kMiB;
+    uint64_t windowEnd = 128 * kKiB + 3 * kMiB;
+    while (expected < 8 * kMiB) {
+        uint64_t len = windowEnd - 128 * kKiB - offset;
+        readAhead.OnRead(offset, len + 1, true, &range);
+        offset += len + 1;
+        expected *= 2;
+        ASSERT_EQ(windowEnd, range.offset);
+        ASSERT_EQ(expected, range.len);
+        windowEnd += expected;
+    }
+    uint64_t len = windowEnd - 128 * kKiB - offset;
+    readAhead.OnRead(offset, len + 1, true, &range);
+    ASSERT_EQ(8 * kMiB, range.len);
+    ASSERT_EQ(8 * kMiB, readAhead.GetWindowSize());
+}
+
+TEST(ReadAheadTest, LargeReadTest) {
+    ReadAhead readAhead(TestOption());
+    ReadAheadRange range;
+
+    // window starts from twice of read length
+    readAhead.OnRead(0, 2 * kMiB, false, &range);
+    ASSERT_EQ(2 * kMiB, range.offset);
+    ASSERT_EQ(4 * kMiB, range.len);
+
+    // a read beyond the window, next window starts after the read
+    readAhead.OnRead(2 * kMiB, 6 * kMiB, false, &range);
+    ASSERT_EQ(8 * kMiB, range.offset);
+    ASSERT_EQ(8 * kMiB, range.len);
+}
+
+TEST(ReadAheadTest, RandomReadTest) {
+    ReadAhead readAhead(TestOption());
+    ReadAheadRange range;
+
+    readAhead.OnRead(0, 128 * kKiB, false, &range);
+    ASSERT_EQ(1 * kMiB, range.len);
+    uint64_t epoch = range.epoch;
+    ASSERT_FALSE(readAhead.IsCanceled(epoch));
+
+    // random read ends the stream and cancels inflight windows
+    ASSERT_EQ(ReadAhead::Result::NONE,
+              readAhead.OnRead(100 * kMiB, 128 * kKiB, false, &range));
+    ASSERT_EQ(0, range.len);
+    ASSERT_EQ(0, readAhead.GetWindowSize());
+    ASSERT_TRUE(readAhead.IsCanceled(epoch));
+
+    // it is the start of a new stream if it goes on
+    readAhead.OnRead(100 * kMiB + 128 * kKiB, 128 * kKiB, false, &range);
+    ASSERT_EQ(100 * kMiB + 256 * kKiB, range.offset);
+    ASSERT_EQ(1 * kMiB, range.len);
+    ASSERT_FALSE(readAhead.IsCanceled(range.epoch));
+
+    // repeat reading the same range is not sequential
+    readAhead.OnRead(0, 128 * kKiB, false, &range);
+    readAhead.OnRead(0, 128 * kKiB, false, &range);
+    ASSERT_EQ(0, range.len);
+}
+
+TEST(ReadAheadTest, ShrinkTest) {
+    ReadAhead readAhead(TestOption());
+    ReadAheadRange range;
+
+    readAhead.OnRead(0, 1 * kMiB, false, &range);
+    readAhead.OnDone(range);
+    readAhead.OnRead(1 * kMiB, 1 * kMiB, true, &range);
+    ASSERT_EQ(3 * kMiB, range.offset);
+    ASSERT_EQ(4 * kMiB, range.len);
+    ReadAheadRange second = range;
+
+    // miss before the data is ready, the window is not shrunk
+    ASSERT_EQ(ReadAhead::Result::MISS,
+              readAhead.OnRead(3 * kMiB, 1 * kMiB, false, &range));
+    ASSERT_EQ(7 * kMiB, range.offset);
+    ASSERT_EQ(8 * kMiB, range.len);
+
+    // miss in the ready range, data is evicted, next window is halved
+    readAhead.OnDone(second);
+    ASSERT_EQ(ReadAhead::Result::MISS,
+              readAhead.OnRead(4 * kMiB, 1 * kMiB, false, &range));
+    ASSERT_EQ(0, range.len);
+    readAhead.OnRead(5 * kMiB, 3 * kMiB, true, &range);
+    ASSERT_EQ(15 * kMiB, range.offset);
+    ASSERT_EQ(4 * kMiB, range.len);
+}
+
+TEST(ReadAheadTest, CancelTest) {
+    ReadAhead readAhead(TestOption());
+    ReadAheadRange range;
+
+    readAhead.OnRead(0, 128 * kKiB, false, &range);
+    ReadAheadRange first = range;
+    readAhead.Cancel();
+    ASSERT_TRUE(readAhead.IsCanceled(first.epoch));
+    ASSERT_EQ(0, readAhead.GetWindowSize());
+
+    // done of canceled window is ignored
+    readAhead.OnDone(first);
+
+    // stream restarts from the beginning of file
+    ASSERT_EQ(ReadAhead::Result::NONE,
+              readAhead.OnRead(0, 128 * kKiB, false, &range));
+    ASSERT_EQ(128 * kKiB, range.offset);
+    ASSERT_EQ(1 * kMiB, range.len);
+    ASSERT_FALSE(readAhead.IsCanceled(range.epoch));
+}
+
+}  // namespace client
+}  // namespace curvefs
@@ -0,0 +1,130 @@
+/*
+ *  Copyright (c) 2023 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "curvefs/src/client/s3/client_s3_single_flight.h"
+
+namespace curvefs {
+namespace client {
+
+TEST(ReadSingleFlightTest, JoinTest) {
+    ReadSingleFlight group(4);
+    std::string data(4096, '\0');
+    for (size_t i = 0; i < data.size(); i++) {
+        data[i] = 'a' + i % 26;
+    }
+
+    char leaderBuf[4096];
+    auto flight = group.JoinOrLead("obj", 0, 4096, leaderBuf,
+                                   [](bool) { FAIL(); });
+    ASSERT_NE(nullptr, flight);
+    ASSERT_EQ(1, group.GetFlightNum());
+
+    // covered by the flight
+    std::string buf1(100, '\0');
+    int served1 = -1;
+    ASSERT_EQ(nullptr, group.JoinOrLead("obj", 1000, 100, &buf1[0],
+                                        [&](bool ok) { served1 = ok; }));
+    // not covered, or another object, lead new flights
+    char buf2[4096];
+    auto flight2 = group.JoinOrLead("obj", 4000, 200, buf2,
+                                    [](bool) { FAIL(); });
+    ASSERT_NE(nullptr, flight2);
+    auto flight3 = group.JoinOrLead("obj2", 0, 100, buf2,
+                                    [](bool) { FAIL(); });
+    ASSERT_NE(nullptr, flight3);
+    ASSERT_EQ(3, group.GetFlightNum());
+    // waiter beyond the data actually read is not served
+    int served3 = -1;
+    ASSERT_EQ(nullptr, group.JoinOrLead("obj", 3000, 1000, buf2,
+                                        [&](bool ok) { served3 = ok; }));
+
+    group.Finish(flight, data.data(), 3500);
+    ASSERT_EQ(1, served1);
+    ASSERT_EQ(data.substr(1000, 100), buf1);
+    ASSERT_EQ(0, served3);
+
+    // finished flight can not be joined
+    auto flight4 = group.JoinOrLead("obj", 0, 100, buf2,
+                                    [](bool) { FAIL(); });
+    ASSERT_NE(nullptr, flight4);
+
+    // waiters of a failed flight are not served
+    int served5 = -1;
+    ASSERT_EQ(nullptr, group.JoinOrLead("obj2", 0, 100, buf2,
+                                        [&](bool ok) { served5 = ok; }));
+    group.Finish(flight3, nullptr, 0);
+    ASSERT_EQ(0, served5);
+
+    group.Finish(flight2, data.data(), 200);
+    group.Finish(flight4, data.data(), 100);
+    ASSERT_EQ(0, group.GetFlightNum());
+}
+
+TEST(ReadSingleFlightTest, ConcurrentTest) {
+    ReadSingleFlight group;
+    const int threadNum = 16;
+    const uint64_t len = 1024;
+    std::atomic<int> leaders(0);
+    std::atomic<int> served(0);
+    std::atomic<int> corrupted(0);
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < threadNum; t++) {
+        threads.emplace_back([&]() {
+            for (int round = 0; round < 1000; round++) {
+                std::string name = "obj_" + std::to_string(round % 10);
+                std::string buf(len, '\0');
+                std::atomic<bool> done(false);
+                auto flight = group.JoinOrLead(
+                    name, 0, len, &buf[0], [&](bool ok) {
+                        if (ok) {
+                            served++;
+                        }
+                        done = true;
+                    });
+                if (flight == nullptr) {
+                    while (!done) {
+                        std::this_thread::yield();
+                    }
+                } else {
+                    leaders++;
+                    std::fill(buf.begin(), buf.end(), name.back());
+                    group.Finish(flight, buf.data(), len);
+                }
+                if (buf != std::string(len, name.back())) {
+                    corrupted++;
+                }
+            }
+        });
+    }
+    for (auto &t : threads) {
+        t.join();
+    }
+
+    ASSERT_EQ(0, corrupted.load());
+    ASSERT_EQ(threadNum * 1000, leaders.load() + served.load());
+    ASSERT_EQ(0, group.GetFlightNum());
+}
+
+}  // namespace client
+}  // namespace curvefs
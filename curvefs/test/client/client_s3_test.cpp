@@ -25,7 +25,11 @@
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 
+#include <string>
+#include <thread>  // NOLINT
+
 #include "curvefs/test/client/mock_s3_adapter.h"
+#include "src/common/concurrent/count_down_event.h"
 
 namespace curvefs {
 namespace client {
@@ -137,6 +141,87 @@ TEST_F(ClientS3Test, downloadAsync) {
     delete[] buf;
 }
 
+TEST_F(ClientS3Test, downloadJoinInflight) {
+    const uint64_t len = 1024;
+    std::string data(len, '\0');
+    for (uint64_t i = 0; i < len; i++) {
+        data[i] = 'a' + i % 26;
+    }
+    auto metric = std::make_shared<S3Metric>("downloadJoinInflight");
+    client_->InitMetrics(metric);
+
+    auto newContext = [&](uint64_t offset, uint64_t length, int *done) {
+        auto context = std::make_shared<GetObjectAsyncContext>();
+        context->key = "name";
+        context->buf = new char[length];
+        context->offset = offset;
+        context->len = length;
+        context->retCode = -1;
+        context->cb = [done](const curve::common::S3Adapter*,
+                             const std::shared_ptr<GetObjectAsyncContext>&
+                                 ctx) {
+            *done = ctx->retCode == 0 ? 1 : 0;
+        };
+        return context;
+    };
+
+    // async download joins an inflight async download
+    std::shared_ptr<GetObjectAsyncContext> leader;
+    EXPECT_CALL(*s3Client_, GetObjectAsync(_))
+        .WillOnce(Invoke([&](std::shared_ptr<GetObjectAsyncContext> ctx) {
+            leader = ctx;
+        }));
+    int leaderDone = -1;
+    int waiterDone = -1;
+    auto context = newContext(0, len, &leaderDone);
+    auto waiter = newContext(100, 200, &waiterDone);
+    client_->DownloadAsync(context);
+    client_->DownloadAsync(waiter);
+    ASSERT_NE(nullptr, leader);
+    ASSERT_EQ(-1, waiterDone);
+
+    memcpy(leader->buf, data.data(), len);
+    leader->retCode = 0;
+    leader->actualLen = len;
+    leader->cb(s3Client_.get(), leader);
+    ASSERT_EQ(1, leaderDone);
+    ASSERT_EQ(1, waiterDone);
+    ASSERT_EQ(200, waiter->actualLen);
+    ASSERT_EQ(data.substr(100, 200), std::string(waiter->buf, 200));
+
+    // async download joins an inflight download
+    curve::common::CountDownEvent started(1);
+    curve::common::CountDownEvent release(1);
+    EXPECT_CALL(*s3Client_, GetObject(_, _, 0, len))
+        .WillOnce(Invoke([&](const std::string&, char* buf, off_t, size_t) {
+            started.Signal();
+            release.Wait();
+            memcpy(buf, data.data(), len);
+            return 0;
+        }));
+    std::string buf(len, '\0');
+    int ret = -1;
+    std::thread reader([&]() {
+        ret = client_->Download("name", &buf[0], 0, len);
+    });
+    started.Wait();
+    int waiterDone2 = -1;
+    auto waiter2 = newContext(512, 512, &waiterDone2);
+    client_->DownloadAsync(waiter2);
+    ASSERT_EQ(-1, waiterDone2);
+    release.Signal();
+    reader.join();
+    ASSERT_EQ(0, ret);
+    ASSERT_EQ(data, buf);
+    ASSERT_EQ(1, waiterDone2);
+    ASSERT_EQ(data.substr(512), std::string(waiter2->buf, 512));
+
+    ASSERT_EQ(2, metric->readDedupHit.get_value());
+    ASSERT_EQ(200 + 512, metric->readDedupBytes.get_value());
+    delete[] context->buf;
+    delete[] waiter->buf;
+    delete[] waiter2->buf;
+}
 
 }  // namespace client
 }  // namespace curvefs
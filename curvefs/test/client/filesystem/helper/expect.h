@@ -50,6 +50,12 @@ using ::curvefs::client::rpcclient::MockMetaServerClient;
  *              bool dirOnly = false,
  *              uint32_t nlink = 0);
  *
+ *   ListDentryPlus(uint64_t parent,
+ *                  std::list<Dentry> *dentryList,
+ *                  std::map<uint64_t, InodeAttr> *attrs,
+ *                  uint32_t limit,
+ *                  bool streaming);
+ *
  *
  * InodeCacheManager:
  *   GetInodeAttr(uint64_t inodeId, InodeAttr *out);
@@ -80,6 +86,12 @@ do {                                                 \
         .WillOnce(Return(CODE));                     \
 } while (0)
 
+#define EXPECT_CALL_RETURN_ListDentryPlus(MANAGER, CODE) \
+do {                                                     \
+    EXPECT_CALL(MANAGER, ListDentryPlus(_, _, _, _, _))  \
+        .WillOnce(Return(CODE));                         \
+} while (0)
+
 #define EXPECT_CALL_RETURN_GetInodeAttr(MANAGER, CODE) \
 do {                                                   \
     EXPECT_CALL(MANAGER, GetInodeAttr(_, _))           \
@@ -105,6 +117,12 @@ do {                                                     \
         .WillOnce(Invoke(CALLBACK));                     \
 } while (0)
 
+#define EXPECT_CALL_INVOKE_ListDentryPlus(MANAGER, CALLBACK) \
+do {                                                         \
+    EXPECT_CALL(MANAGER, ListDentryPlus(_, _, _, _, _))      \
+        .WillOnce(Invoke(CALLBACK));                         \
+} while (0)
+
 #define EXPECT_CALL_INVOKE_GetInodeAttr(MANAGER, CALLBACK) \
 do {                                                       \
     EXPECT_CALL(MANAGER, GetInodeAttr(_, _))               \
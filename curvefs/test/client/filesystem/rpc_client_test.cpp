@@ -127,6 +127,53 @@ TEST_F(RPCClientTest, ReadDir_Basic) {
     }
 }
 
+TEST_F(RPCClientTest, ReadDir_ListDentryPlus) {
+    auto builder = RPCClientBuilder().SetOption([](RPCOption* option) {
+        option->listDentryPlus = true;
+    });
+    auto rpc = builder.Build();
+
+    // CASE 1: only get attributes which are not returned with dentries
+    {
+        EXPECT_CALL_INVOKE_ListDentryPlus(*builder.GetDentryManager(),
+            [&](uint64_t parent,
+                std::list<Dentry>* dentries,
+                std::map<uint64_t, InodeAttr>* attrs,
+                uint32_t limit,
+                bool streaming) -> CURVEFS_ERROR {
+                dentries->push_back(MkDentry(1, "f1"));
+                dentries->push_back(MkDentry(2, "f2"));
+                dentries->push_back(MkDentry(3, "f3"));
+                attrs->emplace(1, MkAttr(1));
+                attrs->emplace(3, MkAttr(3));
+                return CURVEFS_ERROR::OK;
+            });
+        EXPECT_CALL_INVOKE_BatchGetInodeAttrAsync(*builder.GetInodeManager(),
+            [&](uint64_t parentId,
+                std::set<uint64_t>* inos,
+                std::map<uint64_t, InodeAttr>* attrs) -> CURVEFS_ERROR {
+                EXPECT_EQ(*inos, std::set<uint64_t>({ 2 }));
+                attrs->emplace(2, MkAttr(2));
+                return CURVEFS_ERROR::OK;
+            });
+
+        auto entries = std::make_shared<DirEntryList>();
+        auto rc = rpc->ReadDir(100, &entries);
+        ASSERT_EQ(rc, CURVEFS_ERROR::OK);
+        ASSERT_EQ(entries->Size(), 3);
+    }
+
+    // CASE 2: list dentry plus failed
+    {
+        EXPECT_CALL_RETURN_ListDentryPlus(*builder.GetDentryManager(),
+                                          CURVEFS_ERROR::INTERNAL);
+
+        auto entries = std::make_shared<DirEntryList>();
+        auto rc = rpc->ReadDir(100, &entries);
+        ASSERT_EQ(rc, CURVEFS_ERROR::INTERNAL);
+    }
+}
+
 TEST_F(RPCClientTest, Open_Basic) {
     auto builder = RPCClientBuilder();
     auto rpc = builder.Build();
@@ -54,6 +54,10 @@ class MockS3ClientAdaptor : public S3ClientAdaptor {
     MOCK_METHOD4(Read, int(uint64_t inodeId, uint64_t offset, uint64_t length,
                            char* buf));
     MOCK_METHOD1(ReleaseCache, void(uint64_t inodeId));
+    MOCK_METHOD1(CancelReadAhead, void(uint64_t inodeId));
+    MOCK_METHOD4(ReadCacheSegments,
+                 bool(uint64_t inodeId, uint64_t offset, uint64_t length,
+                      std::vector<CacheSegment> *segments));
     MOCK_METHOD1(Flush, CURVEFS_ERROR(uint64_t inodeId));
     MOCK_METHOD1(FlushAllCache, CURVEFS_ERROR(uint64_t inodeId));
     MOCK_METHOD0(FsSync, CURVEFS_ERROR());
@@ -27,6 +27,7 @@
 #include <cstdint>
 #include <string>
 #include <list>
+#include <map>
 #include "curvefs/src/client/dentry_cache_manager.h"
 
 namespace curvefs {
@@ -51,6 +52,11 @@ class MockDentryCacheManager : public DentryCacheManager {
                                            uint32_t limit,
                                            bool onlyDir,
                                            uint32_t nlink));
+
+    MOCK_METHOD5(ListDentryPlus,
+                 CURVEFS_ERROR(uint64_t parent, std::list<Dentry> *dentryList,
+                               std::map<uint64_t, InodeAttr> *attrs,
+                               uint32_t limit, bool streaming));
 };
 
 
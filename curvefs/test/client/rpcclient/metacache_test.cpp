@@ -324,6 +324,49 @@ TEST_F(MetaCacheTest, test_IsLeaderMayChange) {
     ASSERT_TRUE(metaCache_.IsLeaderMayChange(groupID));
 }
 
+TEST_F(MetaCacheTest, test_UpdateAppliedIndex) {
+    CopysetGroupID groupID(1, 1);
+    ASSERT_EQ(0, metaCache_.GetAppliedIndex(groupID));
+
+    metaCache_.UpdateAppliedIndex(groupID, 10);
+    ASSERT_EQ(10, metaCache_.GetAppliedIndex(groupID));
+
+    // applied index never goes back
+    metaCache_.UpdateAppliedIndex(groupID, 5);
+    ASSERT_EQ(10, metaCache_.GetAppliedIndex(groupID));
+
+    ASSERT_EQ(0, metaCache_.GetAppliedIndex(CopysetGroupID(1, 2)));
+}
+
+TEST_F(MetaCacheTest, test_SelectReadReplica) {
+    CopysetGroupID groupID(1, 1);
+    metaCache_.UpdateCopysetInfo(groupID, metaServerList_);
+
+    // test1: unknown copyset, read from leader
+    CopysetTarget target = expect;
+    target.groupID = CopysetGroupID(1, 2);
+    metaCache_.SelectReadReplica(&target);
+    target.groupID = expect.groupID;
+    ASSERT_TRUE(CopysetTargetEQ(target, expect));
+
+    // test2: replica with lower latency is preferred, even if no request
+    // of the copyset has returned
+    metaCache_.UpdateServerLatency(1, 100000);
+    metaCache_.UpdateServerLatency(2, 100000);
+    metaCache_.UpdateServerLatency(3, 10);
+
+    std::map<MetaserverID, int> selected;
+    for (int i = 0; i < 1000; i++) {
+        target = expect;
+        metaCache_.SelectReadReplica(&target);
+        ASSERT_EQ(9119 + target.metaServerID, target.endPoint.port);
+        selected[target.metaServerID]++;
+    }
+
+    ASSERT_GT(selected[3], selected[1]);
+    ASSERT_GT(selected[3], selected[2]);
+}
+
 TEST_F(MetaCacheTest, test_GetPartitionIdByInodeId) {
     std::vector<CopysetInfo<MetaserverID>> metaServerInfos;
     metaServerList_.UpdateLeaderIndex(-1);
@@ -58,6 +58,11 @@ class MockMetaCache : public MetaCache {
 
     MOCK_METHOD3(GetPartitionIdByInodeId,
                  bool(uint32_t fsID, uint64_t inodeID, PartitionID *pid));
+
+    MOCK_METHOD1(SelectReadReplica, void(CopysetTarget *target));
+
+    MOCK_METHOD2(UpdateServerLatency, void(MetaserverID id,
+                                           uint64_t latencyUs));
 };
 
 }  // namespace rpcclient
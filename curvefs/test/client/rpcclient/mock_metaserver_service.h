@@ -47,6 +47,13 @@ class MockMetaServerService : public curvefs::metaserver::MetaServerService {
                       ::curvefs::metaserver::ListDentryResponse *response,
                       ::google::protobuf::Closure *done));
 
+    MOCK_METHOD4(
+        ListDentryPlus,
+        void(::google::protobuf::RpcController *controller,
+             const ::curvefs::metaserver::ListDentryPlusRequest *request,
+             ::curvefs::metaserver::ListDentryPlusResponse *response,
+             ::google::protobuf::Closure *done));
+
     MOCK_METHOD4(CreateDentry,
                  void(::google::protobuf::RpcController *controller,
                       const ::curvefs::metaserver::CreateDentryRequest *request,
@@ -22,6 +22,8 @@
 
 #include <gtest/gtest.h>
 
+#include <string>
+
 #include "curvefs/proto/metaserver.pb.h"
 #include "curvefs/src/client/rpcclient/task_excutor.h"
 #include "curvefs/test/client/rpcclient/mock_metacache.h"
@@ -79,6 +81,61 @@ TEST(CreateInodeTaskExecutorTest, TestPartitionAllocIdFail) {
     EXPECT_EQ(MetaStatusCode::OK, executor.DoRPCTask());
 }
 
+TEST(TaskExecutorTest, TestFollowerReadRedirected) {
+    auto context = std::make_shared<TaskContext>();
+    context->followerRead = true;
+    context->rpctask = [](LogicPoolID poolID, CopysetID copysetID,
+                          PartitionID partitionID, uint64_t txId,
+                          brpc::Channel *channel, brpc::Controller *cntl,
+                          TaskExecutorDone *done) {
+        static int count = 0;
+        ++count;
+        if (count == 1) {
+            // follower falls behind, return REDIRECTED firstly
+            return MetaStatusCode::REDIRECTED;
+        }
+
+        return MetaStatusCode::OK;
+    };
+
+    auto mockMetaCache = std::make_shared<MockMetaCache>();
+    auto channelMgr = std::make_shared<ChannelManager<MetaserverID>>();
+    TaskExecutor executor(ExcutorOpt{}, mockMetaCache, channelMgr, context);
+
+    auto setTarget = [](MetaserverID id, const std::string &addr,
+                        CopysetTarget *target) {
+        target->groupID = CopysetGroupID{1, 1};
+        target->partitionID = 1;
+        target->txId = 1;
+        target->metaServerID = id;
+        butil::str2endpoint(addr.c_str(), &target->endPoint);
+    };
+
+    EXPECT_CALL(*mockMetaCache, GetTarget(_, _, _, _))
+        .WillOnce(Invoke([&](uint32_t, uint64_t, CopysetTarget *target,
+                             bool) {
+            setTarget(1, "127.0.0.1:12345", target);
+            return true;
+        }));
+    EXPECT_CALL(*mockMetaCache, SelectReadReplica(_))
+        .WillOnce(Invoke([&](CopysetTarget *target) {
+            setTarget(2, "127.0.0.1:12346", target);
+        }));
+    EXPECT_CALL(*mockMetaCache, UpdateServerLatency(2, _))
+        .Times(1);
+
+    // retry on the cached leader without refreshing
+    EXPECT_CALL(*mockMetaCache, GetTargetLeader(_, false))
+        .WillOnce(Invoke([&](CopysetTarget *target, bool) {
+            setTarget(1, "127.0.0.1:12345", target);
+            return true;
+        }));
+
+    EXPECT_EQ(MetaStatusCode::OK, executor.DoRPCTask());
+    EXPECT_FALSE(context->followerRead);
+    EXPECT_EQ(1, context->target.metaServerID);
+}
+
 }  // namespace rpcclient
 }  // namespace client
 }  // namespace curvefs
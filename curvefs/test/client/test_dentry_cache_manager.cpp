@@ -25,6 +25,8 @@
 #include <google/protobuf/util/message_differencer.h>
 #include <unistd.h>
 
+#include <map>
+
 #include "curvefs/test/client/mock_metaserver_client.h"
 #include "curvefs/src/client/dentry_cache_manager.h"
 
@@ -238,6 +240,59 @@ TEST_F(TestDentryCacheManager, ListDentryFailed) {
     ASSERT_EQ(0, out.size());
 }
 
+TEST_F(TestDentryCacheManager, ListDentryPlusNomal) {
+    uint64_t parent = 99;
+
+    std::list<Dentry> part1, part2;
+    std::list<InodeAttr> attrs1, attrs2;
+    uint32_t limit = 100;
+    for (uint32_t i = 0; i < 2 * limit - 1; i++) {
+        Dentry dentry;
+        dentry.set_name(std::to_string(i));
+        dentry.set_inodeid(i);
+        (i < limit ? part1 : part2).push_back(dentry);
+        // attributes of odd inodes are not returned
+        if (i % 2 == 0) {
+            InodeAttr attr;
+            attr.set_inodeid(i);
+            (i < limit ? attrs1 : attrs2).push_back(attr);
+        }
+    }
+
+    EXPECT_CALL(*metaClient_, ListDentryPlus(fsId_, parent, "", limit, true,
+                                             _, _))
+        .WillOnce(DoAll(SetArgPointee<5>(part1), SetArgPointee<6>(attrs1),
+                Return(MetaStatusCode::OK)));
+    EXPECT_CALL(*metaClient_, ListDentryPlus(fsId_, parent,
+                                             std::to_string(limit - 1), limit,
+                                             true, _, _))
+        .WillOnce(DoAll(SetArgPointee<5>(part2), SetArgPointee<6>(attrs2),
+                Return(MetaStatusCode::OK)));
+
+    std::list<Dentry> out;
+    std::map<uint64_t, InodeAttr> attrs;
+    CURVEFS_ERROR ret =
+        dCacheManager_->ListDentryPlus(parent, &out, &attrs, limit, true);
+    ASSERT_EQ(CURVEFS_ERROR::OK, ret);
+    ASSERT_EQ(2 * limit - 1, out.size());
+    ASSERT_EQ(limit, attrs.size());
+    ASSERT_EQ(1, attrs.count(2 * limit - 2));
+}
+
+TEST_F(TestDentryCacheManager, ListDentryPlusFailed) {
+    uint64_t parent = 99;
+
+    EXPECT_CALL(*metaClient_, ListDentryPlus(fsId_, parent, _, _, _, _, _))
+        .WillOnce(Return(MetaStatusCode::UNKNOWN_ERROR));
+
+    std::list<Dentry> out;
+    std::map<uint64_t, InodeAttr> attrs;
+    CURVEFS_ERROR ret =
+        dCacheManager_->ListDentryPlus(parent, &out, &attrs, 10, false);
+    ASSERT_EQ(CURVEFS_ERROR::UNKNOWN, ret);
+    ASSERT_EQ(0, out.size());
+}
+
 TEST_F(TestDentryCacheManager, GetTimeOutDentry) {
     curvefs::client::common::FLAGS_enableCto = false;
     uint64_t parent = 99;
@@ -0,0 +1,267 @@
+/*
+ *  Copyright (c) 2023 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <set>
+#include <string>
+
+#include "curvefs/src/client/s3/disk_cache_segment.h"
+
+namespace curvefs {
+namespace client {
+
+namespace {
+
+const char kTestDir[] = "./disk_cache_segment_test";
+const uint64_t kSegmentSize = 64 * 1024;
+const uint64_t kObjSize = 20 * 1024;
+
+std::string ObjData(const std::string &name) {
+    std::string data(kObjSize, '\0');
+    for (uint64_t i = 0; i < kObjSize; i++) {
+        data[i] = name[i % name.size()] + i % 7;
+    }
+    return data;
+}
+
+}  // namespace
+
+class TestDiskCacheSegment : public ::testing::Test {
+ protected:
+    void SetUp() override {
+        ASSERT_EQ(0, system((std::string("rm -rf ") + kTestDir).c_str()));
+        wrapper_ = std::make_shared<PosixWrapper>();
+    }
+
+    void TearDown() override {
+        ASSERT_EQ(0, system((std::string("rm -rf ") + kTestDir).c_str()));
+    }
+
+    std::unique_ptr<DiskCacheSegment> NewCache(uint64_t segmentNum) {
+        std::unique_ptr<DiskCacheSegment> cache(
+            new DiskCacheSegment(wrapper_));
+        EXPECT_EQ(0, cache->Init(kTestDir, kSegmentSize,
+                                 segmentNum * kSegmentSize));
+        return cache;
+    }
+
+    void Put(DiskCacheSegment *cache, const std::string &name) {
+        std::string data = ObjData(name);
+        ASSERT_EQ(kObjSize, cache->WriteDiskFile(name, data.data(),
+                                                 data.size(), false));
+    }
+
+    void ExpectCached(DiskCacheSegment *cache, const std::string &name) {
+        std::string expected = ObjData(name);
+        std::string buf(kObjSize, '\0');
+        ASSERT_TRUE(cache->IsCached(name));
+        ASSERT_EQ(kObjSize,
+                  cache->ReadDiskFile(name, &buf[0], 0, kObjSize));
+        ASSERT_EQ(expected, buf);
+        ASSERT_EQ(100, cache->ReadDiskFile(name, &buf[0], 1000, 100));
+        ASSERT_EQ(expected.substr(1000, 100), buf.substr(0, 100));
+    }
+
+    std::shared_ptr<PosixWrapper> wrapper_;
+};
+
+TEST_F(TestDiskCacheSegment, InitTest) {
+    DiskCacheSegment cache(wrapper_);
+    ASSERT_GT(0, cache.Init(kTestDir, kSegmentSize, kSegmentSize - 1));
+    ASSERT_GT(0, cache.Init(kTestDir, 0, kSegmentSize));
+
+    auto cache2 = NewCache(4);
+    ASSERT_EQ(4, cache2->GetSegmentNum());
+    ASSERT_EQ(0, cache2->GetCachedNum());
+}
+
+TEST_F(TestDiskCacheSegment, WriteReadTest) {
+    auto cache = NewCache(4);
+    std::string buf(kObjSize, '\0');
+    ASSERT_FALSE(cache->IsCached("obj_0"));
+    ASSERT_GT(0, cache->ReadDiskFile("obj_0", &buf[0], 0, kObjSize));
+
+    for (int i = 0; i < 6; i++) {
+        Put(cache.get(), "obj_" + std::to_string(i));
+    }
+    for (int i = 0; i < 6; i++) {
+        ExpectCached(cache.get(), "obj_" + std::to_string(i));
+    }
+    ASSERT_EQ(6, cache->GetCachedNum());
+    ASSERT_EQ(6 * kObjSize, cache->GetUsedBytes());
+
+    // out of range
+    ASSERT_GT(0, cache->ReadDiskFile("obj_0", &buf[0], 1, kObjSize));
+    // too large for a segment
+    std::string large(kSegmentSize, 'a');
+    ASSERT_GT(0, cache->WriteDiskFile("large", large.data(), large.size(),
+                                      false));
+
+    // write again is ignored
+    Put(cache.get(), "obj_0");
+    ASSERT_EQ(6, cache->GetCachedNum());
+
+    cache->ClearReadCache({"obj_1", "obj_not_exist"});
+    ASSERT_FALSE(cache->IsCached("obj_1"));
+    ASSERT_EQ(5 * kObjSize, cache->GetUsedBytes());
+}
+
+TEST_F(TestDiskCacheSegment, EvictTest) {
+    // 3 objs in a segment
+    auto cache = NewCache(3);
+    for (int i = 0; i < 9; i++) {
+        Put(cache.get(), "obj_" + std::to_string(i));
+    }
+    ASSERT_EQ(9, cache->GetCachedNum());
+
+    // segment of obj_0 ~ obj_2 is read recently, obj_3 ~ obj_5 is evicted
+    std::string buf(kObjSize, '\0');
+    ASSERT_EQ(kObjSize, cache->ReadDiskFile("obj_1", &buf[0], 0, kObjSize));
+    Put(cache.get(), "obj_9");
+    for (int i = 3; i < 6; i++) {
+        ASSERT_FALSE(cache->IsCached("obj_" + std::to_string(i)));
+    }
+    for (int i : {0, 1, 2, 6, 7, 8, 9}) {
+        ExpectCached(cache.get(), "obj_" + std::to_string(i));
+    }
+    ASSERT_EQ(7 * kObjSize, cache->GetUsedBytes());
+}
+
+TEST_F(TestDiskCacheSegment, PinTest) {
+    // 3 objs in a segment
+    auto cache = NewCache(3);
+    std::set<std::string> pinned{"obj_0"};
+    cache->SetPinnedFunc([&pinned](const std::string &name) {
+        return pinned.count(name) > 0;
+    });
+    for (int i = 0; i < 9; i++) {
+        Put(cache.get(), "obj_" + std::to_string(i));
+    }
+
+    // segment of obj_0 ~ obj_2 is the oldest but pinned
+    Put(cache.get(), "obj_9");
+    for (int i = 3; i < 6; i++) {
+        ASSERT_FALSE(cache->IsCached("obj_" + std::to_string(i)));
+    }
+    for (int i : {0, 1, 2, 6, 7, 8, 9}) {
+        ExpectCached(cache.get(), "obj_" + std::to_string(i));
+    }
+
+    // no segment can be evicted
+    pinned.insert("obj_6");
+    pinned.insert("obj_9");
+    Put(cache.get(), "obj_10");
+    Put(cache.get(), "obj_11");
+    std::string data = ObjData("obj_12");
+    ASSERT_GT(0, cache->WriteDiskFile("obj_12", data.data(), data.size(),
+                                      false));
+
+    // evictable again after uploaded
+    pinned.erase("obj_0");
+    Put(cache.get(), "obj_12");
+    ASSERT_FALSE(cache->IsCached("obj_0"));
+    ExpectCached(cache.get(), "obj_12");
+}
+
+TEST_F(TestDiskCacheSegment, ClearAndReloadTest) {
+    auto cache = NewCache(4);
+    for (int i = 0; i < 5; i++) {
+        Put(cache.get(), "obj_" + std::to_string(i));
+    }
+    // obj_1 is in a sealed segment, obj_4 is in the active one
+    cache->ClearReadCache({"obj_1", "obj_4"});
+    cache->Close();
+    cache.reset();
+
+    cache = NewCache(4);
+    ASSERT_EQ(3, cache->GetCachedNum());
+    ASSERT_FALSE(cache->IsCached("obj_4"));
+    for (int i : {0, 1, 2, 3}) {
+        if (i != 1) {
+            ExpectCached(cache.get(), "obj_" + std::to_string(i));
+        }
+    }
+    ASSERT_EQ(3 * kObjSize, cache->GetUsedBytes());
+}
+
+TEST_F(TestDiskCacheSegment, ReloadTest) {
+    auto cache = NewCache(4);
+    for (int i = 0; i < 5; i++) {
+        Put(cache.get(), "obj_" + std::to_string(i));
+    }
+    // seal the active segment
+    cache->Close();
+    cache.reset();
+
+    cache = NewCache(4);
+    ASSERT_EQ(5, cache->GetCachedNum());
+    for (int i = 0; i < 5; i++) {
+        ExpectCached(cache.get(), "obj_" + std::to_string(i));
+    }
+
+    // new objs go to a new segment
+    Put(cache.get(), "obj_5");
+    ExpectCached(cache.get(), "obj_5");
+    ASSERT_EQ(6, cache->GetCachedNum());
+}
+
+TEST_F(TestDiskCacheSegment, RecoverTest) {
+    auto cache = NewCache(4);
+    for (int i = 0; i < 5; i++) {
+        Put(cache.get(), "obj_" + std::to_string(i));
+    }
+
+    // crash, the active segment has no index
+    auto recovered = NewCache(4);
+    ASSERT_EQ(5, recovered->GetCachedNum());
+    for (int i = 0; i < 5; i++) {
+        ExpectCached(recovered.get(), "obj_" + std::to_string(i));
+    }
+    recovered.reset();
+
+    // corrupted index is dropped, and the segment is scanned
+    std::string index = std::string(kTestDir) + "/segment_0.index";
+    FILE *fp = fopen(index.c_str(), "r+");
+    ASSERT_NE(nullptr, fp);
+    ASSERT_EQ(0, fseek(fp, 50, SEEK_SET));
+    ASSERT_EQ(1, fwrite("x", 1, 1, fp));
+    fclose(fp);
+
+    // torn record at the tail of the segment is dropped
+    std::string segment = std::string(kTestDir) + "/segment_1";
+    fp = fopen(segment.c_str(), "r+");
+    ASSERT_NE(nullptr, fp);
+    ASSERT_EQ(0, fseek(fp, kObjSize + 100, SEEK_SET));
+    ASSERT_EQ(1, fwrite("x", 1, 1, fp));
+    fclose(fp);
+    ASSERT_EQ(0, remove((segment + ".index").c_str()));
+
+    recovered = NewCache(4);
+    ASSERT_EQ(4, recovered->GetCachedNum());
+    for (int i = 0; i < 4; i++) {
+        ExpectCached(recovered.get(), "obj_" + std::to_string(i));
+    }
+    ASSERT_FALSE(recovered->IsCached("obj_4"));
+    recovered.reset();
+    cache.reset();
+}
+
+}  // namespace client
+}  // namespace curvefs
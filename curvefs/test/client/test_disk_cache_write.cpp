@@ -428,6 +428,23 @@ TEST_F(TestDiskCacheWrite, RemoveFile) {
         .WillOnce(Return(0));
     ret = diskCacheWrite_->RemoveFile(file);
     ASSERT_EQ(0, ret);
+
+    // the length of removed file is reported
+    uint64_t removed = 0;
+    diskCacheWrite_->SetRemoveCallback([&removed](uint64_t length) {
+        removed += length;
+    });
+    struct stat rf;
+    rf.st_size = 1024;
+    EXPECT_CALL(*wrapper_, stat(NotNull(), NotNull()))
+        .WillRepeatedly(DoAll(SetArgPointee<1>(rf), Return(0)));
+    EXPECT_CALL(*wrapper_, remove(_))
+        .WillOnce(Return(-1))
+        .WillOnce(Return(0));
+    ASSERT_EQ(-1, diskCacheWrite_->RemoveFile(file));
+    ASSERT_EQ(0, removed);
+    ASSERT_EQ(0, diskCacheWrite_->RemoveFile(file));
+    ASSERT_EQ(1024, removed);
 }
 
 TEST_F(TestDiskCacheWrite, AsyncUploadRun) {
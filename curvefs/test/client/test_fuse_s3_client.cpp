@@ -1056,6 +1056,46 @@ TEST_F(TestFuseS3Client, FuseOpReadFailed) {
     ASSERT_EQ(CURVEFS_ERROR::INTERNAL, ret);
 }
 
+TEST_F(TestFuseS3Client, FuseOpReadCacheSegments) {
+    fuse_ino_t ino = 1;
+    size_t size = 8192;
+    struct fuse_file_info fi;
+    fi.flags = O_RDONLY;
+    std::vector<CacheSegment> segments;
+    size_t rSize = 0;
+
+    Inode inode;
+    inode.set_fsid(fsId);
+    inode.set_inodeid(ino);
+    inode.set_length(4096);
+    auto inodeWrapper = std::make_shared<InodeWrapper>(inode, metaClient_);
+
+    // direct io
+    fi.flags = O_RDONLY | O_DIRECT;
+    ASSERT_FALSE(client_->FuseOpReadCacheSegments(ino, size, 0, &fi,
+                                                  &segments, &rSize));
+
+    fi.flags = O_RDONLY;
+    EXPECT_CALL(*inodeManager_, GetInode(ino, _))
+        .Times(3)
+        .WillRepeatedly(
+            DoAll(SetArgReferee<1>(inodeWrapper), Return(CURVEFS_ERROR::OK)));
+    EXPECT_CALL(*s3ClientAdaptor_, ReadCacheSegments(ino, 0, 4096, _))
+        .WillOnce(Return(false))
+        .WillOnce(Return(true));
+    EXPECT_CALL(*inodeManager_, ShipToFlush(_)).Times(1);
+
+    // not all in memory cache
+    ASSERT_FALSE(client_->FuseOpReadCacheSegments(ino, size, 0, &fi,
+                                                  &segments, &rSize));
+    ASSERT_TRUE(client_->FuseOpReadCacheSegments(ino, size, 0, &fi,
+                                                 &segments, &rSize));
+    ASSERT_EQ(4096, rSize);
+    // over range
+    ASSERT_FALSE(client_->FuseOpReadCacheSegments(ino, size, 5000, &fi,
+                                                  &segments, &rSize));
+}
+
 TEST_F(TestFuseS3Client, FuseOpFsync) {
     fuse_req_t req = nullptr;
     fuse_ino_t ino = 1;
@@ -2031,5 +2071,16 @@ TEST_F(TestFuseS3Client, FuseOpReadQosTest) {
     qosReadTest(4, 200);
 }
 
+TEST_F(TestFuseS3Client, FuseOpRelease) {
+    fuse_req_t req = nullptr;
+    fuse_ino_t ino = 1;
+    struct fuse_file_info fi;
+    memset(&fi, 0, sizeof(fi));
+
+    EXPECT_CALL(*s3ClientAdaptor_, CancelReadAhead(ino))
+        .Times(1);
+    ASSERT_EQ(CURVEFS_ERROR::OK, client_->FuseOpRelease(req, ino, &fi));
+}
+
 }  // namespace client
 }  // namespace curvefs
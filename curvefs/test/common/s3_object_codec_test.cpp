@@ -0,0 +1,147 @@
+/*
+ *  Copyright (c) 2023 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include "curvefs/src/common/s3_object_codec.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+namespace curvefs {
+namespace common {
+
+namespace {
+
+const uint64_t kBlockSize = 1024 * 1024;
+
+// text like data in the front half, random data in the back half
+std::string GenData(uint64_t len) {
+    std::string data(len, '\0');
+    for (uint64_t i = 0; i < len; i++) {
+        data[i] = i < len / 2 ? 'a' + i % 7 : static_cast<char>(rand());
+    }
+    return data;
+}
+
+S3ObjectCodec::RangeReader ObjectReader(const std::string &object,
+                                        int *readNum) {
+    return [&object, readNum](uint64_t offset, uint64_t len, char *buf) {
+        (*readNum)++;
+        if (offset + len > object.size()) {
+            return -1;
+        }
+        memcpy(buf, object.data() + offset, len);
+        return 0;
+    };
+}
+
+}  // namespace
+
+class S3ObjectCodecTest : public ::testing::TestWithParam<ObjectCodecType> {};
+
+TEST_P(S3ObjectCodecTest, EncodeDecodeTest) {
+    for (uint64_t len : {0UL, 1UL, 4097UL, 3 * 64 * 1024UL, kBlockSize}) {
+        std::string data = GenData(len);
+        std::string object;
+        ASSERT_TRUE(S3ObjectCodec::Encode(GetParam(), kBlockSize, data.data(),
+                                          len, &object));
+        ASSERT_LE(object.size(),
+                  S3ObjectCodec::MaxObjectSize(kBlockSize, len));
+        std::string out;
+        ASSERT_TRUE(S3ObjectCodec::Decode(kBlockSize, object, &out));
+        ASSERT_EQ(data, out);
+    }
+}
+
+TEST_P(S3ObjectCodecTest, CompressTest) {
+    std::string data(kBlockSize, 'x');
+    std::string object;
+    ASSERT_TRUE(S3ObjectCodec::Encode(GetParam(), kBlockSize, data.data(),
+                                      data.size(), &object));
+    ASSERT_LT(object.size(), data.size() / 10);
+}
+
+TEST_P(S3ObjectCodecTest, DecodeRangeTest) {
+    const uint64_t len = kBlockSize - 100;
+    std::string data = GenData(len);
+    std::string object;
+    ASSERT_TRUE(S3ObjectCodec::Encode(GetParam(), kBlockSize, data.data(),
+                                      len, &object));
+    const std::string header =
+        object.substr(0, S3ObjectCodec::HeaderSize(kBlockSize));
+
+    struct Range {
+        uint64_t offset;
+        uint64_t len;
+    };
+    const uint64_t frame = S3ObjectCodec::kFrameSize;
+    for (const auto &range : {Range{0, 1}, Range{frame - 1, 2},
+                              Range{frame, frame}, Range{100, 3 * frame},
+                              Range{len / 2 - 10, 20}, Range{len - 1, 1},
+                              Range{0, len}}) {
+        std::string out(range.len, '\0');
+        int readNum = 0;
+        ASSERT_EQ(0, S3ObjectCodec::DecodeRange(
+                         kBlockSize, header, ObjectReader(object, &readNum),
+                         range.offset, range.len, &out[0]));
+        ASSERT_EQ(data.substr(range.offset, range.len), out);
+        // frames are read by one request
+        ASSERT_EQ(1, readNum);
+    }
+
+    // out of range
+    char buf[2];
+    int readNum = 0;
+    ASSERT_EQ(-1, S3ObjectCodec::DecodeRange(kBlockSize, header,
+                                             ObjectReader(object, &readNum),
+                                             len - 1, 2, buf));
+    // error of reader
+    auto failReader = [](uint64_t, uint64_t, char *) { return -2; };
+    ASSERT_EQ(-2, S3ObjectCodec::DecodeRange(kBlockSize, header, failReader,
+                                             0, 2, buf));
+}
+
+INSTANTIATE_TEST_CASE_P(Codec, S3ObjectCodecTest,
+                        ::testing::Values(CODEC_LZ4, CODEC_ZSTD));
+
+TEST(S3ObjectCodecBadTest, BadObjectTest) {
+    std::string data = GenData(4096);
+    std::string out;
+    // not encoded
+    ASSERT_FALSE(S3ObjectCodec::Decode(kBlockSize, data, &out));
+    ASSERT_FALSE(S3ObjectCodec::Encode(CODEC_NONE, kBlockSize, data.data(),
+                                       data.size(), &out));
+    // larger than block
+    ASSERT_FALSE(S3ObjectCodec::Encode(CODEC_LZ4, 1024, data.data(),
+                                       data.size(), &out));
+
+    std::string object;
+    ASSERT_TRUE(S3ObjectCodec::Encode(CODEC_LZ4, kBlockSize, data.data(),
+                                      data.size(), &object));
+    // truncated
+    ASSERT_FALSE(S3ObjectCodec::Decode(
+        kBlockSize, object.substr(0, object.size() - 1), &out));
+    // corrupted frame
+    object[S3ObjectCodec::HeaderSize(kBlockSize)] ^= 0xff;
+    object[S3ObjectCodec::HeaderSize(kBlockSize) + 1] ^= 0xff;
+    ASSERT_FALSE(S3ObjectCodec::Decode(kBlockSize, object, &out) &&
+                 out == data);
+}
+
+}  // namespace common
+}  // namespace curvefs
@@ -220,3 +220,42 @@ TEST(ApplyQueue, ConcurrentTest) {
     concurrentapply.Stop();
 }
 
+
+TEST(ApplyQueue, LockFreeQueueTest) {
+    std::vector<OperatorType> readTypeList;
+    std::vector<OperatorType> writeTypeList;
+    InitReadWriteTypeList(&readTypeList, &writeTypeList);
+
+    ApplyQueue concurrentapply;
+    ApplyOption opt(2, 1, 1, 1, true);
+    ASSERT_TRUE(concurrentapply.Init(opt));
+
+    // each key is hashed to one thread, its tasks run in push order
+    std::vector<uint32_t> next(2, 0);
+    std::atomic<bool> ordered(true);
+    auto wtask = [&next, &ordered](int key, uint32_t seq) {
+        if (next[key] != seq) {
+            ordered = false;
+        }
+        next[key]++;
+    };
+    std::atomic<uint32_t> rnum(0);
+    auto rtask = [&rnum]() {
+        rnum.fetch_add(1);
+    };
+
+    for (uint32_t i = 0; i < 5000; i++) {
+        auto read_type  = get_random_type(readTypeList);
+        auto write_type = get_random_type(writeTypeList);
+        concurrentapply.Push(0, write_type, wtask, 0, i);
+        concurrentapply.Push(1, write_type, wtask, 1, i);
+        concurrentapply.Push(i, read_type, rtask);
+    }
+
+    concurrentapply.FlushAll();
+    ASSERT_TRUE(ordered);
+    ASSERT_EQ(5000, next[0]);
+    ASSERT_EQ(5000, next[1]);
+    ASSERT_EQ(5000, rnum);
+    concurrentapply.Stop();
+}
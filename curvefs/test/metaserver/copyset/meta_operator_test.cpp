@@ -28,8 +28,13 @@
 #include <condition_variable>
 #include <mutex>
 #include <regex>
+#include <thread>  // NOLINT
+#include <vector>
 
 #include "absl/memory/memory.h"
+#include "curvefs/src/metaserver/copyset/meta_operator_closure.h"
+#include "curvefs/src/metaserver/copyset/raft_log_codec.h"
+#include "curvefs/test/metaserver/copyset/mock/mock_copyset_node.h"
 #include "curvefs/test/metaserver/copyset/mock/mock_copyset_node_manager.h"
 #include "curvefs/test/metaserver/copyset/mock/mock_raft_node.h"
 #include "curvefs/test/metaserver/mock/mock_metastore.h"
@@ -148,6 +153,7 @@ TEST_F(MetaOperatorTest, OperatorTypeTest) {
     TEST_OPERATOR_TYPE(DeletePartition);
     TEST_OPERATOR_TYPE(PrepareRenameTx);
     TEST_OPERATOR_TYPE(UpdateDeallocatableBlockGroup);
+    TEST_OPERATOR_TYPE(ListDentryPlus);
 
 
 #undef TEST_OPERATOR_TYPE
@@ -196,6 +202,7 @@ TEST_F(MetaOperatorTest, OnApplyErrorTest) {
     OPERATOR_ON_APPLY_TEST(CreatePartition);
     OPERATOR_ON_APPLY_TEST(DeletePartition);
     OPERATOR_ON_APPLY_TEST(PrepareRenameTx);
+    OPERATOR_ON_APPLY_TEST(ListDentryPlus);
 
 #undef OPERATOR_ON_APPLY_TEST
 
@@ -342,6 +349,7 @@ TEST_F(MetaOperatorTest, OnApplyFromLogErrorTest) {
     OPERATOR_ON_APPLY_FROM_LOG_DO_NOTHING_TEST(GetInode);
     OPERATOR_ON_APPLY_FROM_LOG_DO_NOTHING_TEST(BatchGetInodeAttr);
     OPERATOR_ON_APPLY_FROM_LOG_DO_NOTHING_TEST(BatchGetXAttr);
+    OPERATOR_ON_APPLY_FROM_LOG_DO_NOTHING_TEST(ListDentryPlus);
 
 
 #undef OPERATOR_ON_APPLY_FROM_LOG_DO_NOTHING_TEST
@@ -506,6 +514,135 @@ TEST_F(MetaOperatorTest, PropostTest_IsNotLeaseLeader) {
     EXPECT_FALSE(response.has_appliedindex());
 }
 
+TEST_F(MetaOperatorTest, PropostTest_FollowerRead) {
+    curve::fs::MockLocalFileSystem localFs;
+
+    MockCopysetNode node;
+    CopysetNodeOptions options;
+    options.dataUri = "local:///mnt/data";
+    options.localFileSystem = &localFs;
+    options.storageOptions.type = "memory";
+
+    EXPECT_CALL(localFs, Mkdir(_))
+        .WillOnce(Return(0));
+
+    EXPECT_TRUE(node.Init(options));
+    auto* mockMetaStore = new mock::MockMetaStore();
+    node.SetMetaStore(mockMetaStore);
+    auto* mockRaftNode = new MockRaftNode();
+    node.SetRaftNode(mockRaftNode);
+
+    EXPECT_CALL(*mockRaftNode, apply(_))
+        .Times(0);
+    EXPECT_CALL(node, IsLeaderTerm())
+        .WillRepeatedly(Return(false));
+    EXPECT_CALL(node, IsLoading())
+        .WillRepeatedly(Return(false));
+    EXPECT_CALL(node, GetDispatchedIndex())
+        .WillRepeatedly(Return(100));
+
+    // follower doesn't have leader
+    {
+        EXPECT_CALL(node, GetLeaderId())
+            .WillOnce(Return(braft::PeerId()));
+        EXPECT_CALL(node, FetchReadIndex(_, _))
+            .Times(0);
+
+        GetDentryRequest request;
+        request.set_appliedindex(100);
+        GetDentryResponse response;
+        auto op = absl::make_unique<GetDentryOperator>(&node, nullptr, &request,
+                                                       &response, nullptr);
+        op->Propose();
+        EXPECT_EQ(MetaStatusCode::REDIRECTED, response.statuscode());
+    }
+
+    braft::PeerId leader;
+    ASSERT_EQ(0, leader.parse("127.0.0.1:29960:0"));
+    EXPECT_CALL(node, GetLeaderId())
+        .WillRepeatedly(Return(leader));
+
+    // follower falls behind the logs client has seen
+    {
+        EXPECT_CALL(node, FetchReadIndex(_, _))
+            .Times(0);
+
+        GetDentryRequest request;
+        request.set_appliedindex(101);
+        GetDentryResponse response;
+        auto op = absl::make_unique<GetDentryOperator>(&node, nullptr, &request,
+                                                       &response, nullptr);
+        op->Propose();
+        EXPECT_EQ(MetaStatusCode::REDIRECTED, response.statuscode());
+    }
+
+    // leader doesn't give read index, e.g., its lease is expired
+    {
+        EXPECT_CALL(node, FetchReadIndex(leader, _))
+            .WillOnce(Return(false));
+
+        GetDentryRequest request;
+        request.set_appliedindex(100);
+        GetDentryResponse response;
+        auto op = absl::make_unique<GetDentryOperator>(&node, nullptr, &request,
+                                                       &response, nullptr);
+        op->Propose();
+        EXPECT_EQ(MetaStatusCode::REDIRECTED, response.statuscode());
+    }
+
+    // follower doesn't catch up with the read index in time
+    {
+        EXPECT_CALL(node, FetchReadIndex(leader, _))
+            .WillOnce(DoAll(SetArgPointee<1>(105), Return(true)));
+        EXPECT_CALL(node, WaitDispatchedIndex(105))
+            .WillOnce(Return(false));
+
+        GetDentryRequest request;
+        request.set_appliedindex(100);
+        GetDentryResponse response;
+        auto op = absl::make_unique<GetDentryOperator>(&node, nullptr, &request,
+                                                       &response, nullptr);
+        op->Propose();
+        EXPECT_EQ(MetaStatusCode::REDIRECTED, response.statuscode());
+    }
+
+    // write operator is always redirected
+    {
+        CreateInodeRequest request;
+        CreateInodeResponse response;
+        auto op = absl::make_unique<CreateInodeOperator>(
+            &node, nullptr, &request, &response, nullptr);
+        op->Propose();
+        EXPECT_EQ(MetaStatusCode::REDIRECTED, response.statuscode());
+    }
+
+    // follower read, request doesn't need to carry appliedindex
+    {
+        EXPECT_CALL(node, FetchReadIndex(leader, _))
+            .WillOnce(DoAll(SetArgPointee<1>(100), Return(true)));
+        EXPECT_CALL(node, WaitDispatchedIndex(100))
+            .WillOnce(Return(true));
+        EXPECT_CALL(*mockMetaStore, GetDentry(_, _))
+            .WillOnce(Return(MetaStatusCode::OK));
+
+        GetDentryRequest request;
+        GetDentryResponse response;
+        FakeClosure done;
+        auto op = absl::make_unique<GetDentryOperator>(&node, nullptr, &request,
+                                                       &response, &done);
+        op->Propose();
+        op.release();
+
+        done.WaitRunned();
+        EXPECT_TRUE(response.has_appliedindex());
+        EXPECT_EQ(100, response.appliedindex());
+        // applied index is only advanced by applying logs
+        EXPECT_EQ(0, node.GetAppliedIndex());
+    }
+
+    node.Stop();
+}
+
 TEST_F(MetaOperatorTest, PropostTest_PropostTaskFailed) {
     PoolId poolId = 100;
     CopysetId copysetId = 100;
@@ -556,6 +693,237 @@ TEST_F(MetaOperatorTest, PropostTest_PropostTaskFailed) {
     EXPECT_FALSE(response.has_appliedindex());
 }
 
+TEST_F(MetaOperatorTest, ProposeTest_BatchPropose) {
+    PoolId poolId = 100;
+    CopysetId copysetId = 100;
+    braft::Configuration conf;
+
+    CopysetNode node(poolId, copysetId, conf, &mockNodeManager_);
+
+    curve::fs::MockLocalFileSystem localFs;
+    CopysetNodeOptions options;
+    options.dataUri = "local:///mnt/data";
+    options.localFileSystem = &localFs;
+    options.storageOptions.type = "memory";
+    options.proposeBatchSize = 2;
+    options.proposeBatchWaitUs = 1000 * 1000;
+
+    EXPECT_CALL(localFs, Mkdir(_))
+        .WillOnce(Return(0));
+
+    EXPECT_TRUE(node.Init(options));
+    ASSERT_NE(nullptr, node.GetProposeBatcher());
+    auto* mockRaftNode = new MockRaftNode();
+    node.SetRaftNode(mockRaftNode);
+
+    node.on_leader_start(1);
+
+    // two operators are proposed in one raft log entry, and failed
+    EXPECT_CALL(*mockRaftNode, apply(_))
+        .WillOnce(Invoke([&node](const braft::Task& task) {
+            auto meta = RaftLogCodec::Decode(&node, *task.data);
+            EXPECT_NE(nullptr, meta);
+            EXPECT_EQ(OperatorType::Batch, meta->GetOperatorType());
+            auto* batch = dynamic_cast<BatchOperator*>(meta.get());
+            EXPECT_NE(nullptr, batch);
+            EXPECT_EQ(2, batch->Size());
+            task.done->status().set_error(EPERM, "not leader");
+            task.done->Run();
+        }));
+
+    CreateInodeRequest createInode;
+    createInode.set_poolid(poolId);
+    createInode.set_copysetid(copysetId);
+    createInode.set_partitionid(1);
+    createInode.set_fsid(1);
+    createInode.set_length(0);
+    createInode.set_uid(0);
+    createInode.set_gid(0);
+    createInode.set_mode(0644);
+    createInode.set_type(FsFileType::TYPE_FILE);
+    createInode.set_parent(1);
+    CreateInodeResponse createInodeResponse;
+    FakeClosure createInodeDone;
+
+    CreateDentryRequest createDentry;
+    createDentry.set_poolid(poolId);
+    createDentry.set_copysetid(copysetId);
+    createDentry.set_partitionid(1);
+    auto* dentry = createDentry.mutable_dentry();
+    dentry->set_fsid(1);
+    dentry->set_inodeid(100);
+    dentry->set_parentinodeid(1);
+    dentry->set_name("hello");
+    dentry->set_txid(0);
+    CreateDentryResponse createDentryResponse;
+    FakeClosure createDentryDone;
+
+    // the operator comes first waits for the other
+    std::thread th([&]() {
+        auto op = absl::make_unique<CreateInodeOperator>(
+            &node, nullptr, &createInode, &createInodeResponse,
+            &createInodeDone);
+        op.release()->Propose();
+    });
+    auto op = absl::make_unique<CreateDentryOperator>(
+        &node, nullptr, &createDentry, &createDentryResponse,
+        &createDentryDone);
+    op.release()->Propose();
+    th.join();
+
+    createInodeDone.WaitRunned();
+    createDentryDone.WaitRunned();
+    EXPECT_EQ(MetaStatusCode::REDIRECTED, createInodeResponse.statuscode());
+    EXPECT_EQ(MetaStatusCode::REDIRECTED, createDentryResponse.statuscode());
+}
+
+TEST_F(MetaOperatorTest, ProposeTest_BatchApply) {
+    PoolId poolId = 100;
+    CopysetId copysetId = 100;
+    braft::Configuration conf;
+
+    CopysetNode node(poolId, copysetId, conf, &mockNodeManager_);
+
+    curve::fs::MockLocalFileSystem localFs;
+    CopysetNodeOptions options;
+    options.dataUri = "local:///mnt/data";
+    options.localFileSystem = &localFs;
+    options.storageOptions.type = "memory";
+    options.proposeBatchSize = 3;
+    options.proposeBatchWaitUs = 1000 * 1000;
+
+    EXPECT_CALL(localFs, Mkdir(_))
+        .WillOnce(Return(0));
+
+    EXPECT_TRUE(node.Init(options));
+    ASSERT_NE(nullptr, node.GetProposeBatcher());
+    auto* mockMetaStore = new mock::MockMetaStore();
+    node.SetMetaStore(mockMetaStore);
+    auto* mockRaftNode = new MockRaftNode();
+    node.SetRaftNode(mockRaftNode);
+
+    ON_CALL(*mockMetaStore, Clear())
+        .WillByDefault(Return(true));
+
+    node.on_leader_start(1);
+
+    CreateInodeRequest createInode;
+    createInode.set_poolid(poolId);
+    createInode.set_copysetid(copysetId);
+    createInode.set_partitionid(1);
+    createInode.set_fsid(1);
+    createInode.set_length(0);
+    createInode.set_uid(0);
+    createInode.set_gid(0);
+    createInode.set_mode(0644);
+    createInode.set_type(FsFileType::TYPE_FILE);
+    createInode.set_parent(1);
+    CreateInodeResponse createInodeResponse;
+    FakeClosure createInodeDone;
+
+    CreateDentryRequest createDentry;
+    createDentry.set_poolid(poolId);
+    createDentry.set_copysetid(copysetId);
+    createDentry.set_partitionid(1);
+    auto* dentry = createDentry.mutable_dentry();
+    dentry->set_fsid(1);
+    dentry->set_inodeid(100);
+    dentry->set_parentinodeid(1);
+    dentry->set_name("hello");
+    dentry->set_txid(0);
+    CreateDentryResponse createDentryResponse;
+    FakeClosure createDentryDone;
+
+    DeleteDentryRequest deleteDentry;
+    deleteDentry.set_poolid(poolId);
+    deleteDentry.set_copysetid(copysetId);
+    deleteDentry.set_partitionid(1);
+    deleteDentry.set_fsid(1);
+    deleteDentry.set_txid(0);
+    deleteDentry.set_parentinodeid(1);
+    deleteDentry.set_name("world");
+    DeleteDentryResponse deleteDentryResponse;
+    FakeClosure deleteDentryDone;
+
+    // all operators are executed in one batch, and the failed one doesn't
+    // fail the others
+    testing::Sequence s1, s2, s3;
+    EXPECT_CALL(*mockMetaStore, BeginBatch())
+        .InSequence(s1, s2, s3)
+        .WillOnce(Return(true));
+    EXPECT_CALL(*mockMetaStore, CreateInode(_, _))
+        .InSequence(s1)
+        .WillOnce(Invoke(FakeOnApplyFunc<CreateInodeRequest,
+                                         CreateInodeResponse,
+                                         MetaStatusCode::OK>));
+    EXPECT_CALL(*mockMetaStore, CreateDentry(_, _))
+        .InSequence(s2)
+        .WillOnce(Invoke(FakeOnApplyFunc<CreateDentryRequest,
+                                         CreateDentryResponse,
+                                         MetaStatusCode::OK>));
+    EXPECT_CALL(*mockMetaStore, DeleteDentry(_, _))
+        .InSequence(s3)
+        .WillOnce(Invoke(FakeOnApplyFunc<DeleteDentryRequest,
+                                         DeleteDentryResponse,
+                                         MetaStatusCode::NOT_FOUND>));
+    // requests are replied after the batch is committed
+    EXPECT_CALL(*mockMetaStore, CommitBatch())
+        .InSequence(s1, s2, s3)
+        .WillOnce(Invoke([&]() {
+            EXPECT_FALSE(createInodeDone.Runned());
+            EXPECT_FALSE(createDentryDone.Runned());
+            EXPECT_FALSE(deleteDentryDone.Runned());
+            return true;
+        }));
+
+    // apply the batch as soon as it's proposed
+    EXPECT_CALL(*mockRaftNode, apply(_))
+        .WillOnce(Invoke([&node](const braft::Task& task) {
+            auto meta = RaftLogCodec::Decode(&node, *task.data);
+            ASSERT_NE(nullptr, meta);
+            auto* batch = dynamic_cast<BatchOperator*>(meta.get());
+            ASSERT_NE(nullptr, batch);
+            EXPECT_EQ(3, batch->Size());
+
+            auto* closure = dynamic_cast<MetaOperatorClosure*>(task.done);
+            ASSERT_NE(nullptr, closure);
+            closure->GetOperator()->OnApply(10, task.done,
+                                            TimeUtility::GetTimeofDayUs());
+        }));
+
+    // the operator comes first waits for the others
+    std::vector<std::thread> threads;
+    threads.emplace_back([&]() {
+        absl::make_unique<CreateInodeOperator>(
+            &node, nullptr, &createInode, &createInodeResponse,
+            &createInodeDone).release()->Propose();
+    });
+    threads.emplace_back([&]() {
+        absl::make_unique<CreateDentryOperator>(
+            &node, nullptr, &createDentry, &createDentryResponse,
+            &createDentryDone).release()->Propose();
+    });
+    threads.emplace_back([&]() {
+        absl::make_unique<DeleteDentryOperator>(
+            &node, nullptr, &deleteDentry, &deleteDentryResponse,
+            &deleteDentryDone).release()->Propose();
+    });
+    for (auto& th : threads) {
+        th.join();
+    }
+
+    createInodeDone.WaitRunned();
+    createDentryDone.WaitRunned();
+    deleteDentryDone.WaitRunned();
+    EXPECT_EQ(MetaStatusCode::OK, createInodeResponse.statuscode());
+    EXPECT_EQ(10, createInodeResponse.appliedindex());
+    EXPECT_EQ(MetaStatusCode::OK, createDentryResponse.statuscode());
+    EXPECT_EQ(10, createDentryResponse.appliedindex());
+    EXPECT_EQ(MetaStatusCode::NOT_FOUND, deleteDentryResponse.statuscode());
+    EXPECT_FALSE(deleteDentryResponse.has_appliedindex());
+    EXPECT_EQ(10, node.GetAppliedIndex());
+}
+
 }  // namespace copyset
 }  // namespace metaserver
 }  // namespace curvefs
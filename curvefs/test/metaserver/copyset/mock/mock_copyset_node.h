@@ -57,6 +57,9 @@ class MockCopysetNode : public CopysetNode {
 
     MOCK_METHOD1(GetPartitionInfoList, bool(std::list<PartitionInfo> *));
     MOCK_CONST_METHOD0(IsLoading, bool());
+    MOCK_CONST_METHOD0(GetDispatchedIndex, uint64_t());
+    MOCK_METHOD1(WaitDispatchedIndex, bool(uint64_t));
+    MOCK_METHOD2(FetchReadIndex, bool(const braft::PeerId&, uint64_t*));
     MOCK_METHOD1(GetBlockStatInfo,
                  bool(std::map<uint32_t, BlockGroupStatInfo> *));
 };
@@ -161,6 +161,66 @@ TEST(RaftLogCodecTest, DecodeSuccessTest) {
 #undef ENCODE_DECODE_TEST
 }
 
+TEST(RaftLogCodecTest, EncodeAndDecodeBatchTest) {
+    CreateInodeRequest createInode;
+    createInode.set_poolid(1);
+    createInode.set_copysetid(1);
+    createInode.set_partitionid(2);
+    createInode.set_fsid(1);
+    createInode.set_length(0);
+    createInode.set_uid(0);
+    createInode.set_gid(0);
+    createInode.set_mode(0644);
+    createInode.set_type(FsFileType::TYPE_FILE);
+    createInode.set_parent(1);
+
+    CreateDentryRequest createDentry;
+    createDentry.set_poolid(1);
+    createDentry.set_copysetid(1);
+    createDentry.set_partitionid(2);
+    auto* dentry = createDentry.mutable_dentry();
+    dentry->set_fsid(1);
+    dentry->set_inodeid(100);
+    dentry->set_parentinodeid(1);
+    dentry->set_name("hello");
+    dentry->set_txid(0);
+
+    butil::IOBuf entries;
+    ASSERT_TRUE(RaftLogCodec::Encode(OperatorType::CreateInode, &createInode,
+                                     &entries));
+    ASSERT_TRUE(RaftLogCodec::Encode(OperatorType::CreateDentry, &createDentry,
+                                     &entries));
+
+    // success
+    {
+        butil::IOBuf log;
+        ASSERT_TRUE(RaftLogCodec::EncodeBatch(entries, &log));
+        auto meta = RaftLogCodec::Decode(nullptr, log);
+        ASSERT_NE(nullptr, meta);
+        ASSERT_EQ(OperatorType::Batch, meta->GetOperatorType());
+        ASSERT_EQ(2, meta->HashCode());
+        auto* batch = dynamic_cast<BatchOperator*>(meta.get());
+        ASSERT_NE(nullptr, batch);
+        ASSERT_EQ(2, batch->Size());
+    }
+
+    // entry truncated
+    {
+        butil::IOBuf truncated;
+        entries.copy_to(&truncated, entries.size() - 1);
+        butil::IOBuf log;
+        ASSERT_TRUE(RaftLogCodec::EncodeBatch(truncated, &log));
+        ASSERT_EQ(nullptr, RaftLogCodec::Decode(nullptr, log));
+    }
+
+    // empty batch
+    {
+        butil::IOBuf log;
+        ASSERT_TRUE(RaftLogCodec::EncodeBatch(butil::IOBuf(), &log));
+        ASSERT_EQ(nullptr, RaftLogCodec::Decode(nullptr, log));
+    }
+}
+
 }  // namespace copyset
 }  // namespace metaserver
 }  // namespace curvefs
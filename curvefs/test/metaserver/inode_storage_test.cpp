@@ -742,7 +742,9 @@ TEST_F(InodeStorageTest, TestUpdateVolumeExtentSlice) {
 
         const std::string expectTableName =
             nameGenerator_->GetVolumeExtentTableName();
-        const std::string expectKey = "4:1:1:" + std::to_string(slice.offset());
+        const std::string expectKey =
+            storage::Key4VolumeExtentSlice(fsId, inodeId, slice.offset())
+                .SerializeToString();
         EXPECT_CALL(*kvStorage, SSet(expectTableName, expectKey, _))
             .WillOnce(Return(test.second));
 
@@ -995,5 +997,190 @@ TEST_F(InodeStorageTest, Test_UpdateDeallocatableBlockGroup) {
     ASSERT_EQ(1, deallocatableBlockGroupVec.size());
 }
 
+TEST_F(InodeStorageTest, TestMigrateLegacyKeys) {
+    StorageOptions opts;
+    opts.compression = false;
+
+    std::shared_ptr<KVStorage> memStore =
+        std::make_shared<storage::MemoryStorage>(opts);
+
+    for (auto &store : {kvStorage_, memStore}) {
+        InodeStorage storage(store, nameGenerator_, 0);
+        const uint32_t fsId = 1;
+        const uint64_t inodeId = 100;
+
+        // keys saved by previous versions
+        Inode inode = GenInode(fsId, inodeId);
+        ASSERT_TRUE(store->HSet(nameGenerator_->GetInodeTableName(),
+                                "1:1:100", inode).ok());
+        ASSERT_TRUE(
+            store->HSet(nameGenerator_->GetDeallocatableInodeTableName(),
+                        "1:1:100", google::protobuf::Empty()).ok());
+        S3ChunkInfoList list = GenS3ChunkInfoList(1, 10);
+        ASSERT_TRUE(store->SSet(nameGenerator_->GetS3ChunkInfoTableName(),
+            "2:1:100:0:00000000000000000001:00000000000000000010:0",
+            list).ok());
+        VolumeExtentSlice slice;
+        slice.set_offset(4096);
+        RandomSetExtent(slice.add_extents());
+        ASSERT_TRUE(store->SSet(nameGenerator_->GetVolumeExtentTableName(),
+                                "4:1:100:4096", slice).ok());
+
+        ASSERT_EQ(MetaStatusCode::OK, storage.MigrateLegacyKeys())
+            << ToString(store->Type());
+
+        Inode out;
+        ASSERT_EQ(MetaStatusCode::OK,
+                  storage.Get(Key4Inode(fsId, inodeId), &out));
+        ASSERT_TRUE(CompareInode(inode, out));
+        std::list<uint64_t> ids;
+        ASSERT_TRUE(storage.GetAllInodeId(&ids));
+        ASSERT_EQ(1, ids.size());
+        ASSERT_EQ(1, store->HSize(
+            nameGenerator_->GetDeallocatableInodeTableName()));
+
+        ASSERT_EQ(MetaStatusCode::OK,
+                  storage.PaddingInodeS3ChunkInfo(
+                      fsId, inodeId, out.mutable_s3chunkinfomap()));
+        auto m = out.s3chunkinfomap();
+        ASSERT_EQ(1, m.size());
+        ASSERT_TRUE(EqualS3ChunkInfoList(list, m[0]));
+        ASSERT_EQ(1, store->SSize(nameGenerator_->GetS3ChunkInfoTableName()));
+
+        VolumeExtentSlice sliceOut;
+        ASSERT_EQ(MetaStatusCode::OK, storage.GetVolumeExtentByOffset(
+                                          fsId, inodeId, 4096, &sliceOut));
+        ASSERT_EQ(slice, sliceOut);
+
+        // nothing to migrate
+        ASSERT_EQ(MetaStatusCode::OK, storage.MigrateLegacyKeys());
+        ASSERT_EQ(1, store->HSize(nameGenerator_->GetInodeTableName()));
+    }
+}
+
+TEST_F(InodeStorageTest, TestXAttrSavedApart) {
+    InodeStorage storage(kvStorage_, nameGenerator_, 0);
+    const std::string xattrTable = nameGenerator_->GetInodeXAttrTableName();
+    std::string skey = conv_->SerializeToString(Key4Inode(1, 1));
+    Inode inode = GenInode(1, 1);
+    inode.set_type(FsFileType::TYPE_DIRECTORY);
+    inode.mutable_xattr()->insert({XATTRFILES, "1"});
+    inode.mutable_xattr()->insert({XATTRSUBDIRS, "2"});
+    ASSERT_EQ(storage.Insert(inode), MetaStatusCode::OK);
+
+    // inode record carries no xattr
+    Inode out;
+    ASSERT_TRUE(kvStorage_->HGet(nameGenerator_->GetInodeTableName(), skey,
+                                 &out).ok());
+    ASSERT_TRUE(out.xattr().empty());
+    ASSERT_TRUE(out.hasxattr());
+    XAttr xattr;
+    ASSERT_TRUE(kvStorage_->HGet(xattrTable, skey, &xattr).ok());
+    ASSERT_EQ(2, xattr.xattrinfos_size());
+
+    ASSERT_EQ(storage.Get(Key4Inode(1, 1), &out, false), MetaStatusCode::OK);
+    ASSERT_TRUE(out.xattr().empty());
+    ASSERT_EQ(storage.Get(Key4Inode(1, 1), &out), MetaStatusCode::OK);
+    ASSERT_EQ(out.xattr().find(XATTRSUBDIRS)->second, "2");
+    ASSERT_FALSE(out.has_hasxattr());
+    InodeAttr attr;
+    ASSERT_EQ(storage.GetAttr(Key4Inode(1, 1), &attr), MetaStatusCode::OK);
+    ASSERT_EQ(attr.xattr().find(XATTRFILES)->second, "1");
+
+    // update attributes only, xattr is kept
+    ASSERT_EQ(storage.Get(Key4Inode(1, 1), &out, false), MetaStatusCode::OK);
+    out.set_nlink(3);
+    ASSERT_EQ(storage.Update(out, false, false), MetaStatusCode::OK);
+    ASSERT_EQ(storage.Get(Key4Inode(1, 1), &out), MetaStatusCode::OK);
+    ASSERT_EQ(3, out.nlink());
+    ASSERT_EQ(2, out.xattr_size());
+
+    // update xattr
+    (*out.mutable_xattr())[XATTRFILES] = "10";
+    ASSERT_EQ(storage.Update(out), MetaStatusCode::OK);
+    xattr.Clear();
+    ASSERT_EQ(storage.GetXAttr(Key4Inode(1, 1), &xattr), MetaStatusCode::OK);
+    ASSERT_EQ(xattr.xattrinfos().find(XATTRFILES)->second, "10");
+
+    // inode without xattr
+    Inode file = GenInode(1, 2);
+    ASSERT_EQ(storage.Insert(file), MetaStatusCode::OK);
+    xattr.Clear();
+    ASSERT_EQ(storage.GetXAttr(Key4Inode(1, 2), &xattr), MetaStatusCode::OK);
+    ASSERT_TRUE(xattr.xattrinfos().empty());
+    ASSERT_EQ(storage.GetXAttr(Key4Inode(1, 3), &xattr),
+              MetaStatusCode::NOT_FOUND);
+    ASSERT_EQ(1, kvStorage_->HSize(xattrTable));
+
+    // xattr table is skipped for inode recorded without xattr
+    std::string fkey = conv_->SerializeToString(Key4Inode(1, 2));
+    ASSERT_TRUE(kvStorage_->HGet(nameGenerator_->GetInodeTableName(), fkey,
+                                 &out).ok());
+    ASSERT_TRUE(out.has_hasxattr());
+    ASSERT_FALSE(out.hasxattr());
+    XAttr stale;
+    stale.set_fsid(1);
+    stale.set_inodeid(2);
+    stale.mutable_xattrinfos()->insert({XATTRFILES, "1"});
+    ASSERT_TRUE(kvStorage_->HSet(xattrTable, fkey, stale).ok());
+    attr.Clear();
+    ASSERT_EQ(storage.GetAttr(Key4Inode(1, 2), &attr), MetaStatusCode::OK);
+    ASSERT_TRUE(attr.xattr().empty());
+    ASSERT_TRUE(kvStorage_->HDel(xattrTable, fkey).ok());
+
+    // delete
+    ASSERT_EQ(storage.Delete(Key4Inode(1, 1)), MetaStatusCode::OK);
+    ASSERT_EQ(0, kvStorage_->HSize(xattrTable));
+    ASSERT_EQ(storage.GetXAttr(Key4Inode(1, 1), &xattr),
+              MetaStatusCode::NOT_FOUND);
+}
+
+TEST_F(InodeStorageTest, TestMigrateInodeXAttr) {
+    StorageOptions opts;
+    opts.compression = false;
+
+    std::shared_ptr<KVStorage> memStore =
+        std::make_shared<storage::MemoryStorage>(opts);
+
+    for (auto &store : {kvStorage_, memStore}) {
+        InodeStorage storage(store, nameGenerator_, 0);
+        const std::string inodeTable = nameGenerator_->GetInodeTableName();
+        std::string skey = conv_->SerializeToString(Key4Inode(1, 1));
+
+        // inode saved by previous versions with xattr inside
+        Inode inode = GenInode(1, 1);
+        inode.mutable_xattr()->insert({XATTRENTRIES, "5"});
+        ASSERT_TRUE(store->HSet(inodeTable, skey, inode).ok());
+        Inode file = GenInode(1, 2);
+        ASSERT_TRUE(store->HSet(inodeTable,
+            conv_->SerializeToString(Key4Inode(1, 2)), file).ok());
+
+        // xattr inside inode is still visible before migration
+        XAttr xattr;
+        ASSERT_EQ(MetaStatusCode::OK,
+                  storage.GetXAttr(Key4Inode(1, 1), &xattr));
+        ASSERT_EQ(1, xattr.xattrinfos_size());
+
+        ASSERT_EQ(MetaStatusCode::OK, storage.MigrateInodeXAttr())
+            << ToString(store->Type());
+
+        Inode out;
+        ASSERT_TRUE(store->HGet(inodeTable, skey, &out).ok());
+        ASSERT_TRUE(out.xattr().empty());
+        ASSERT_TRUE(out.hasxattr());
+        ASSERT_TRUE(store->HGet(inodeTable,
+            conv_->SerializeToString(Key4Inode(1, 2)), &out).ok());
+        ASSERT_TRUE(out.has_hasxattr());
+        ASSERT_FALSE(out.hasxattr());
+        ASSERT_EQ(1, store->HSize(nameGenerator_->GetInodeXAttrTableName()));
+        ASSERT_EQ(MetaStatusCode::OK, storage.Get(Key4Inode(1, 1), &out));
+        ASSERT_EQ(out.xattr().find(XATTRENTRIES)->second, "5");
+
+        // nothing to migrate
+        ASSERT_EQ(MetaStatusCode::OK, storage.MigrateInodeXAttr());
+        ASSERT_EQ(2, store->HSize(inodeTable));
+    }
+}
+
 }  // namespace metaserver
 }  // namespace curvefs
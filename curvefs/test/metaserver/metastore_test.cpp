@@ -1174,7 +1174,7 @@ TEST_F(MetastoreTest, persist_deleting_partition_success) {
     ASSERT_TRUE(metastore.Clear());
 }
 
-TEST_F(MetastoreTest, persist_partition_fail) {
+TEST_F(MetastoreTest, persist_partition_with_memory_storage) {
     MetaStoreImpl metastore(copyset_.get(), options_);
     ASSERT_TRUE(metastore.InitStorage());
 
@@ -1193,14 +1193,25 @@ TEST_F(MetastoreTest, persist_partition_fail) {
     // dump MetaStoreImpl to file
     OnSnapshotSaveDoneImpl done;
     LOG(INFO) << "MetastoreTest test Save";
-    ASSERT_FALSE(metastore.Save(test_path_, &done));
+    ASSERT_TRUE(metastore.Save(test_path_, &done));
 
     // wait meta save to file
     done.Wait();
-    ASSERT_FALSE(done.IsSuccess());
+    ASSERT_TRUE(done.IsSuccess());
+
+    // load MetaStoreImpl to new meta
+    StorageOptions optsNew = options_;
+    optsNew.dataDir = options_.dataDir + "_new";
+
+    MetaStoreImpl metastoreNew(copyset_.get(), optsNew);
+    ASSERT_TRUE(metastoreNew.InitStorage());
+    ASSERT_TRUE(metastoreNew.Load(test_path_));
+    ASSERT_TRUE(ComparePartition(
+        metastoreNew.GetPartition(partitionId)->GetPartitionInfo(),
+        metastore.GetPartition(partitionId)->GetPartitionInfo()));
 }
 
-TEST_F(MetastoreTest, persist_dentry_fail) {
+TEST_F(MetastoreTest, persist_dentry_with_memory_storage) {
     MetaStoreImpl metastore(copyset_.get(), options_);
     ASSERT_TRUE(metastore.InitStorage());
 
@@ -1275,11 +1286,36 @@ TEST_F(MetastoreTest, persist_dentry_fail) {
     // dump MetaStoreImpl to file
     OnSnapshotSaveDoneImpl done;
     LOG(INFO) << "MetastoreTest test Save";
-    ASSERT_FALSE(metastore.Save(test_path_, &done));
+    ASSERT_TRUE(metastore.Save(test_path_, &done));
+
+    // modifications after save don't affect the snapshot
+    dentry1.set_name("dentry2");
+    createDentryRequest.mutable_dentry()->CopyFrom(dentry1);
+    ret = metastore.CreateDentry(&createDentryRequest, &createDentryResponse2);
+    ASSERT_EQ(createDentryResponse2.statuscode(), MetaStatusCode::OK);
 
     // wait meta save to file
     done.Wait();
-    ASSERT_FALSE(done.IsSuccess());
+    ASSERT_TRUE(done.IsSuccess());
+
+    // load MetaStoreImpl to new meta
+    StorageOptions optsNew = options_;
+    optsNew.dataDir = options_.dataDir + "_new";
+
+    MetaStoreImpl metastoreNew(copyset_.get(), optsNew);
+    ASSERT_TRUE(metastoreNew.InitStorage());
+    ASSERT_TRUE(metastoreNew.Load(test_path_));
+
+    auto partition = metastoreNew.GetPartition(partitionId);
+    Dentry dentry;
+    dentry.set_fsid(fsId);
+    dentry.set_parentinodeid(parentId);
+    dentry.set_name("dentry1");
+    dentry.set_txid(0);
+    ASSERT_EQ(partition->GetDentry(&dentry), MetaStatusCode::OK);
+    ASSERT_EQ(dentry.inodeid(), 2000);
+    dentry.set_name("dentry2");
+    ASSERT_EQ(partition->GetDentry(&dentry), MetaStatusCode::NOT_FOUND);
 
     // clear meta
     LOG(INFO) << "MetastoreTest test Clear";
@@ -1360,6 +1396,108 @@ TEST_F(MetastoreTest, testBatchGetInodeAttr) {
     }
 }
 
+TEST_F(MetastoreTest, testListDentryPlus) {
+    MetaStoreImpl metastore(copyset_.get(), options_);
+    ASSERT_TRUE(metastore.InitStorage());
+
+    // create partition1
+    CreatePartitionRequest createPartitionRequest;
+    CreatePartitionResponse createPartitionResponse;
+    PartitionInfo partitionInfo1;
+    partitionInfo1.set_fsid(1);
+    partitionInfo1.set_poolid(2);
+    partitionInfo1.set_copysetid(3);
+    partitionInfo1.set_partitionid(1);
+    partitionInfo1.set_start(100);
+    partitionInfo1.set_end(1000);
+    createPartitionRequest.mutable_partition()->CopyFrom(partitionInfo1);
+    MetaStatusCode ret = metastore.CreatePartition(&createPartitionRequest,
+                                                   &createPartitionResponse);
+    ASSERT_EQ(ret, MetaStatusCode::OK);
+
+    // create parent and a file inode
+    uint32_t poolId = 2;
+    uint32_t copysetId = 3;
+    uint32_t partitionId = 1;
+    uint32_t fsId = 1;
+
+    CreateInodeRequest createInodeRequest;
+    CreateInodeResponse createInodeResponse;
+    createInodeRequest.set_poolid(poolId);
+    createInodeRequest.set_copysetid(copysetId);
+    createInodeRequest.set_partitionid(partitionId);
+    createInodeRequest.set_fsid(fsId);
+    createInodeRequest.set_length(0);
+    createInodeRequest.set_uid(100);
+    createInodeRequest.set_gid(200);
+    createInodeRequest.set_mode(777);
+    createInodeRequest.set_type(FsFileType::TYPE_DIRECTORY);
+    ret = metastore.CreateInode(&createInodeRequest, &createInodeResponse);
+    ASSERT_EQ(ret, MetaStatusCode::OK);
+    uint64_t parentId = createInodeResponse.inode().inodeid();
+
+    createInodeRequest.set_length(10);
+    createInodeRequest.set_type(FsFileType::TYPE_FILE);
+    ret = metastore.CreateInode(&createInodeRequest, &createInodeResponse);
+    ASSERT_EQ(ret, MetaStatusCode::OK);
+    uint64_t fileId = createInodeResponse.inode().inodeid();
+
+    // dentry1: inode in this partition
+    // dentry2: inode in other partition
+    // dentry3: inode not found
+    std::vector<uint64_t> inodeIds = {fileId, 5000, 999};
+    for (size_t i = 0; i < inodeIds.size(); i++) {
+        CreateDentryRequest createRequest;
+        CreateDentryResponse createResponse;
+        createRequest.set_poolid(poolId);
+        createRequest.set_copysetid(copysetId);
+        createRequest.set_partitionid(partitionId);
+        Dentry* dentry = createRequest.mutable_dentry();
+        dentry->set_fsid(fsId);
+        dentry->set_inodeid(inodeIds[i]);
+        dentry->set_parentinodeid(parentId);
+        dentry->set_name("dentry" + std::to_string(i + 1));
+        dentry->set_txid(0);
+        dentry->set_type(FsFileType::TYPE_FILE);
+        ret = metastore.CreateDentry(&createRequest, &createResponse);
+        ASSERT_EQ(ret, MetaStatusCode::OK);
+    }
+
+    ListDentryPlusRequest listRequest;
+    ListDentryPlusResponse listResponse;
+    listRequest.set_poolid(poolId);
+    listRequest.set_copysetid(copysetId);
+    listRequest.set_partitionid(666);
+    listRequest.set_fsid(fsId);
+    listRequest.set_dirinodeid(parentId);
+
+    // wrong partitionid
+    ret = metastore.ListDentryPlus(&listRequest, &listResponse);
+    ASSERT_EQ(listResponse.statuscode(), MetaStatusCode::PARTITION_NOT_FOUND);
+    ASSERT_EQ(listResponse.statuscode(), ret);
+
+    // only attribute of dentry1 is returned
+    listRequest.set_partitionid(partitionId);
+    listResponse.Clear();
+    ret = metastore.ListDentryPlus(&listRequest, &listResponse);
+    ASSERT_EQ(listResponse.statuscode(), MetaStatusCode::OK);
+    ASSERT_EQ(listResponse.statuscode(), ret);
+    ASSERT_EQ(listResponse.dentrys_size(), 3);
+    ASSERT_EQ(listResponse.attr_size(), 1);
+    ASSERT_EQ(listResponse.attr(0).inodeid(), fileId);
+    ASSERT_EQ(listResponse.attr(0).length(), 10);
+
+    // list from last
+    listRequest.set_last("dentry1");
+    listRequest.set_count(1);
+    listResponse.Clear();
+    ret = metastore.ListDentryPlus(&listRequest, &listResponse);
+    ASSERT_EQ(listResponse.statuscode(), MetaStatusCode::OK);
+    ASSERT_EQ(listResponse.dentrys_size(), 1);
+    ASSERT_EQ(listResponse.dentrys(0).name(), "dentry2");
+    ASSERT_EQ(listResponse.attr_size(), 0);
+}
+
 TEST_F(MetastoreTest, testBatchGetXAttr) {
     MetaStoreImpl metastore(copyset_.get(), options_);
     ASSERT_TRUE(metastore.InitStorage());
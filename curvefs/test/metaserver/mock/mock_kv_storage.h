@@ -85,7 +85,7 @@ class MockKVStorage : public KVStorage {
     MOCK_METHOD0(BeginTransaction, std::shared_ptr<StorageTransaction>());
 
     MOCK_METHOD2(Checkpoint,
-                 bool(const std::string&, std::vector<std::string>*));
+                 bool(const std::string&, std::vector<CheckpointFile>*));
 
     MOCK_METHOD1(Recover, bool(const std::string&));
 };
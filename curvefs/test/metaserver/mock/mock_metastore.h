@@ -59,6 +59,8 @@ class MockMetaStore : public curvefs::metaserver::MetaStore {
                  MetaStatusCode(const GetDentryRequest*, GetDentryResponse*));
     MOCK_METHOD2(ListDentry,
                  MetaStatusCode(const ListDentryRequest*, ListDentryResponse*));
+    MOCK_METHOD2(ListDentryPlus, MetaStatusCode(const ListDentryPlusRequest*,
+                                                ListDentryPlusResponse*));
 
     MOCK_METHOD2(CreateInode, MetaStatusCode(const CreateInodeRequest*,
                                              CreateInodeResponse*));
@@ -105,6 +107,9 @@ class MockMetaStore : public curvefs::metaserver::MetaStore {
     MOCK_METHOD2(UpdateDeallocatableBlockGroup,
                  MetaStatusCode(const UpdateDeallocatableBlockGroupRequest *,
                                 UpdateDeallocatableBlockGroupResponse *));
+
+    MOCK_METHOD0(BeginBatch, bool());
+    MOCK_METHOD0(CommitBatch, bool());
 };
 
 }  // namespace mock
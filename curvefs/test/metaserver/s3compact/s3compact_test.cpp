@@ -22,6 +22,7 @@
 
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
+#include <map>
 #include <memory>
 
 #include "curvefs/src/metaserver/s3compact_manager.h"
@@ -549,6 +550,51 @@ TEST_F(S3CompactTest, test_WriteFullChunk) {
     ASSERT_EQ(ret, -1);
 }
 
+TEST_F(S3CompactTest, test_CompressedChunk) {
+    struct CompactInodeJob::S3CompactCtx ctx {
+        100, 1, PartitionInfo(), 4096, 65536, 0, 0, s3adapter_.get(),
+            curvefs::common::CODEC_LZ4
+    };
+    struct CompactInodeJob::S3NewChunkInfo newChunkInfo {
+        2, 0, 3
+    };
+    std::map<std::string, std::string> objs;
+    auto mock_putobj = [&](const Aws::String& key, const std::string& data) {
+        objs[std::string(key.c_str(), key.size())] = data;
+        return 0;
+    };
+    auto mock_getobj = [&](const Aws::String& key, std::string* data) {
+        *data = objs[std::string(key.c_str(), key.size())];
+        return 0;
+    };
+    EXPECT_CALL(*s3adapter_, PutObject(_, _))
+        .WillRepeatedly(testing::Invoke(mock_putobj));
+    EXPECT_CALL(*s3adapter_, GetObject(_, _))
+        .WillRepeatedly(testing::Invoke(mock_getobj));
+
+    // objects are encoded
+    std::string fullChunk(10000, 'a');
+    std::vector<std::string> objsAdded;
+    int ret = impl_->WriteFullChunk(ctx, newChunkInfo, fullChunk, &objsAdded);
+    ASSERT_EQ(ret, 0);
+    ASSERT_EQ(3, objsAdded.size());
+    ASSERT_LT(objs[objsAdded[0]].size(), ctx.blockSize);
+
+    // and decoded on read
+    std::list<struct CompactInodeJob::Node> validList;
+    validList.emplace_back(0, 9999, 2, 3, 0, 10000, false, true);
+    std::string readChunk;
+    ret = impl_->ReadFullChunk(ctx, validList, &readChunk, &newChunkInfo);
+    ASSERT_EQ(ret, 0);
+    ASSERT_EQ(fullChunk, readChunk);
+
+    // not an encoded object
+    objs[objsAdded[0]] = std::string(ctx.blockSize, 'a');
+    readChunk.clear();
+    ret = impl_->ReadFullChunk(ctx, validList, &readChunk, &newChunkInfo);
+    ASSERT_EQ(ret, -1);
+}
+
 TEST_F(S3CompactTest, test_CompactChunks) {
     uint64_t blockSize = 4;
     uint64_t chunkSize = 64;
@@ -23,14 +23,20 @@
 #include <gtest/gtest.h>
 #include <glog/logging.h>
 
+#include <functional>
+#include <limits>
 #include <unordered_map>
+#include <utility>
 
 #include "curvefs/src/metaserver/storage/converter.h"
+#include "src/common/string_util.h"
 
 namespace curvefs {
 namespace metaserver {
 namespace storage {
 
+using ::curve::common::StringStartWith;
+
 class ConverterTest : public testing::Test {
  protected:
     void SetUp() override {}
@@ -66,7 +72,7 @@ TEST_F(ConverterTest, Key4Dentry) {
         LOG(INFO) << "TEST " << path;
         Key4Dentry key(1, 1, path);
         std::string skey = conv_.SerializeToString(key);
-        ASSERT_EQ(skey, "3:1:1:" + path);
+        ASSERT_EQ(skey.size(), 14 + path.size());
 
         Key4Dentry out;
         ASSERT_TRUE(conv_.ParseFromString(skey, &out));
@@ -79,7 +85,20 @@ TEST_F(ConverterTest, Key4Dentry) {
         LOG(INFO) << "TEST " << path;
         Key4Dentry key(100, 1001, path);
         std::string skey = conv_.SerializeToString(key);
-        ASSERT_EQ(skey, "3:100:1001:" + path);
+        ASSERT_TRUE(StringStartWith(
+            skey, conv_.SerializeToString(Prefix4SameParentDentry(100, 1001))));
+
+        Key4Dentry out;
+        ASSERT_TRUE(conv_.ParseFromString(skey, &out));
+        ASSERT_EQ(out.fsId, 100);
+        ASSERT_EQ(out.parentInodeId, 1001);
+        ASSERT_EQ(out.name, path);
+    }
+
+    // keys saved by previous versions
+    for (const auto& path : paths) {
+        LOG(INFO) << "TEST " << path;
+        std::string skey = "3:100:1001:" + path;
 
         Key4Dentry out;
         ASSERT_TRUE(conv_.ParseFromString(skey, &out));
@@ -92,7 +111,10 @@ TEST_F(ConverterTest, Key4Dentry) {
 TEST_F(ConverterTest, Prefix4SameParentDentry) {
     Prefix4SameParentDentry prefix(1, 100);
     std::string sprefix = conv_.SerializeToString(prefix);
-    ASSERT_EQ(sprefix, "3:1:100:");
+    ASSERT_TRUE(StringStartWith(
+        conv_.SerializeToString(Key4Dentry(1, 100, "a")), sprefix));
+    ASSERT_FALSE(StringStartWith(
+        conv_.SerializeToString(Key4Dentry(1, 1001, "a")), sprefix));
 
     Prefix4SameParentDentry out;
     ASSERT_TRUE(conv_.ParseFromString(sprefix, &out));
@@ -100,6 +122,134 @@ TEST_F(ConverterTest, Prefix4SameParentDentry) {
     ASSERT_EQ(out.parentInodeId, 100);
 }
 
+TEST_F(ConverterTest, Key4Inode) {
+    Key4Inode key(1, 100);
+    std::string skey = conv_.SerializeToString(key);
+    ASSERT_EQ(skey, std::string("\x01\x01\x00\x00\x00\x01"
+                                "\x00\x00\x00\x00\x00\x00\x00\x64", 14));
+    ASSERT_FALSE(IsTextKey(skey));
+    ASSERT_TRUE(StringStartWith(skey, conv_.SerializeToString(
+        Prefix4AllInode())));
+
+    Key4Inode out;
+    ASSERT_TRUE(conv_.ParseFromString(skey, &out));
+    ASSERT_EQ(out.fsId, 1);
+    ASSERT_EQ(out.inodeId, 100);
+
+    // keys saved by previous versions
+    ASSERT_TRUE(conv_.ParseFromString("1:2:200", &out));
+    ASSERT_EQ(out.fsId, 2);
+    ASSERT_EQ(out.inodeId, 200);
+
+    ASSERT_FALSE(conv_.ParseFromString(skey.substr(0, 13), &out));
+    ASSERT_FALSE(conv_.ParseFromString(skey + "x", &out));
+    ASSERT_FALSE(conv_.ParseFromString(
+        conv_.SerializeToString(Key4InodeAuxInfo(1, 100)), &out));
+}
+
+TEST_F(ConverterTest, KeysAreOrderedNumerically) {
+    std::vector<uint64_t> ids{0, 1, 2, 9, 10, 11, 100, 255, 256, 65536,
+                              std::numeric_limits<uint32_t>::max(),
+                              std::numeric_limits<uint64_t>::max()};
+
+    auto check = [&](const std::function<std::string(uint64_t)>& serialize) {
+        for (size_t i = 1; i < ids.size(); i++) {
+            ASSERT_LT(serialize(ids[i - 1]), serialize(ids[i]));
+        }
+    };
+
+    check([&](uint64_t id) {
+        return conv_.SerializeToString(Key4Inode(1, id));
+    });
+    check([&](uint64_t id) {
+        return conv_.SerializeToString(Key4S3ChunkInfoList(1, 1, id, 0, 0, 0));
+    });
+    check([&](uint64_t id) {
+        return conv_.SerializeToString(Key4S3ChunkInfoList(1, 1, 1, id, 0, 0));
+    });
+    check([&](uint64_t id) {
+        return conv_.SerializeToString(Key4Dentry(1, id, "a"));
+    });
+    check([&](uint64_t id) {
+        return conv_.SerializeToString(Key4VolumeExtentSlice(1, 1, id));
+    });
+}
+
+TEST_F(ConverterTest, Key4S3ChunkInfoList) {
+    Key4S3ChunkInfoList key(1, 2, 3, 4, 5, 6);
+    std::string skey = conv_.SerializeToString(key);
+    ASSERT_TRUE(StringStartWith(skey, conv_.SerializeToString(
+        Prefix4ChunkIndexS3ChunkInfoList(1, 2, 3))));
+    ASSERT_TRUE(StringStartWith(skey, conv_.SerializeToString(
+        Prefix4InodeS3ChunkInfoList(1, 2))));
+    ASSERT_TRUE(StringStartWith(skey, conv_.SerializeToString(
+        Prefix4AllS3ChunkInfoList())));
+
+    auto expect = [](const Key4S3ChunkInfoList& out) {
+        ASSERT_EQ(out.fsId, 1);
+        ASSERT_EQ(out.inodeId, 2);
+        ASSERT_EQ(out.chunkIndex, 3);
+        ASSERT_EQ(out.firstChunkId, 4);
+        ASSERT_EQ(out.lastChunkId, 5);
+        ASSERT_EQ(out.size, 6);
+    };
+
+    Key4S3ChunkInfoList out;
+    ASSERT_TRUE(conv_.ParseFromString(skey, &out));
+    expect(out);
+
+    // keys saved by previous versions
+    Key4S3ChunkInfoList legacy;
+    ASSERT_TRUE(conv_.ParseFromString(
+        "2:1:2:3:00000000000000000004:00000000000000000005:6", &legacy));
+    expect(legacy);
+}
+
+TEST_F(ConverterTest, Key4VolumeExtentSlice) {
+    Key4VolumeExtentSlice key(1, 2, 1ULL << 40);
+    std::string skey = conv_.SerializeToString(key);
+    ASSERT_TRUE(StringStartWith(skey, conv_.SerializeToString(
+        Prefix4InodeVolumeExtent(1, 2))));
+    ASSERT_TRUE(StringStartWith(skey, conv_.SerializeToString(
+        Prefix4AllVolumeExtent())));
+
+    Key4VolumeExtentSlice out;
+    ASSERT_TRUE(conv_.ParseFromString(skey, &out));
+    ASSERT_EQ(skey, conv_.SerializeToString(out));
+
+    // keys saved by previous versions
+    ASSERT_TRUE(conv_.ParseFromString("4:1:2:1099511627776", &out));
+    ASSERT_EQ(skey, conv_.SerializeToString(out));
+}
+
+TEST_F(ConverterTest, UpgradeKey) {
+    std::vector<std::pair<std::string, std::string>> cases{
+        {"1:1:100", conv_.SerializeToString(Key4Inode(1, 100))},
+        {"2:1:2:3:00000000000000000004:00000000000000000005:6",
+         conv_.SerializeToString(Key4S3ChunkInfoList(1, 2, 3, 4, 5, 6))},
+        {"3:1:2:/a:b", conv_.SerializeToString(Key4Dentry(1, 2, "/a:b"))},
+        {"3:1:2:", conv_.SerializeToString(Key4Dentry(1, 2, ""))},
+        {"4:1:2:4096",
+         conv_.SerializeToString(Key4VolumeExtentSlice(1, 2, 4096))},
+        // keys in text format currently
+        {"5:1:1", "5:1:1"},
+        {"7:1:4096", "7:1:4096"},
+    };
+
+    std::string out;
+    for (const auto& c : cases) {
+        ASSERT_TRUE(conv_.UpgradeKey(c.first, &out));
+        ASSERT_EQ(c.second, out);
+
+        // upgrade again
+        ASSERT_TRUE(conv_.UpgradeKey(out, &out));
+        ASSERT_EQ(c.second, out);
+    }
+
+    ASSERT_FALSE(conv_.UpgradeKey("1:1:abc", &out));
+    ASSERT_FALSE(conv_.UpgradeKey("2:1:2", &out));
+}
+
 TEST_F(ConverterTest, Key4InodeAuxInfo) {
     Key4InodeAuxInfo key(1, 1);
     std::string skey = conv_.SerializeToString(key);
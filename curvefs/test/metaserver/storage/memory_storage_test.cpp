@@ -23,15 +23,19 @@
 #include <gtest/gtest.h>
 
 #include <memory>
+#include <string>
+#include <vector>
 
 #include "curvefs/src/metaserver/storage/storage.h"
 #include "curvefs/src/metaserver/storage/memory_storage.h"
 #include "curvefs/test/metaserver/storage/storage_test.h"
+#include "src/fs/ext4_filesystem_impl.h"
 
 namespace curvefs {
 namespace metaserver {
 namespace storage {
 
+using ::curvefs::metaserver::storage::CheckpointFile;
 using ::curvefs::metaserver::storage::KVStorage;
 using ::curvefs::metaserver::storage::MemoryStorage;
 using ::curvefs::metaserver::storage::StorageOptions;
@@ -89,6 +93,87 @@ TEST_F(MemoryStorageTest, SClearTest) { TestSClear(kvStorage_);
 TEST_F(MemoryStorageTest, MixOperatorTest) { TestMixOperator(kvStorage_);
                                              TestMixOperator(kvStorage2_); }
 
+TEST_F(MemoryStorageTest, BatchTest) {
+    // memory storage can't commit writes atomically
+    ASSERT_TRUE(kvStorage_->BeginBatch().IsNotSupported());
+    ASSERT_TRUE(kvStorage_->CommitBatch().IsNotSupported());
+}
+
+TEST_F(MemoryStorageTest, SnapshotTest) {
+    for (bool compression : {false, true}) {
+        options_.compression = compression;
+        auto storage = std::make_shared<MemoryStorage>(options_);
+        ASSERT_TRUE(storage->HSet("1", "key1", Value("1")).ok());
+        ASSERT_TRUE(storage->SSet("2", "key1", Value("1")).ok());
+        ASSERT_TRUE(storage->SSet("2", "key2", Value("2")).ok());
+        auto iterator = storage->SGetAll("2");
+
+        auto snapshot = storage->Snapshot();
+        ASSERT_TRUE(storage->HSet("1", "key1", Value("3")).ok());
+        ASSERT_TRUE(storage->SDel("2", "key1").ok());
+        ASSERT_TRUE(storage->SSet("2", "key3", Value("3")).ok());
+        ASSERT_TRUE(storage->HSet("3", "key1", Value("1")).ok());
+
+        // snapshot keeps the values before modification
+        Dentry dentry;
+        ASSERT_TRUE(snapshot->HGet("1", "key1", &dentry).ok());
+        ASSERT_EQ(dentry, Value("1"));
+        ASSERT_EQ(2, snapshot->SSize("2"));
+        ASSERT_TRUE(snapshot->SGet("3", "key3", &dentry).IsNotFound());
+        ASSERT_EQ(0, snapshot->HSize("3"));
+
+        ASSERT_TRUE(storage->HGet("1", "key1", &dentry).ok());
+        ASSERT_EQ(dentry, Value("3"));
+        ASSERT_TRUE(storage->SGet("2", "key1", &dentry).IsNotFound());
+        ASSERT_EQ(2, storage->SSize("2"));
+
+        // iterator iterates the table when it's created
+        std::vector<std::string> keys;
+        for (iterator->SeekToFirst(); iterator->Valid(); iterator->Next()) {
+            keys.push_back(iterator->Key());
+        }
+        ASSERT_EQ(keys, std::vector<std::string>({"key1", "key2"}));
+    }
+}
+
+TEST_F(MemoryStorageTest, CheckpointAndRecoverTest) {
+    const std::string dir = "./memory_storage_test";
+    auto localfs = curve::fs::Ext4FileSystemImpl::getInstance();
+    ASSERT_EQ(0, localfs->Mkdir(dir));
+
+    for (bool compression : {false, true}) {
+        options_.compression = compression;
+        auto storage = std::make_shared<MemoryStorage>(options_);
+        for (int i = 0; i < 100; i++) {
+            std::string key = "key" + std::to_string(i);
+            ASSERT_TRUE(storage->HSet("1", key, Value(key)).ok());
+            ASSERT_TRUE(storage->SSet("1", key, Value(key)).ok());
+        }
+        ASSERT_TRUE(storage->SDel("1", "key0").ok());
+
+        std::vector<CheckpointFile> files;
+        ASSERT_TRUE(storage->Checkpoint(dir, &files));
+        ASSERT_EQ(1, files.size());
+
+        auto recovered = std::make_shared<MemoryStorage>(options_);
+        ASSERT_TRUE(recovered->HSet("2", "key1", Value("key1")).ok());
+        ASSERT_TRUE(recovered->Recover(dir));
+        ASSERT_EQ(100, recovered->HSize("1"));
+        ASSERT_EQ(99, recovered->SSize("1"));
+        ASSERT_EQ(0, recovered->HSize("2"));
+
+        Dentry dentry;
+        ASSERT_TRUE(recovered->HGet("1", "key0", &dentry).ok());
+        ASSERT_EQ(dentry, Value("key0"));
+        ASSERT_TRUE(recovered->SGet("1", "key0", &dentry).IsNotFound());
+        ASSERT_TRUE(recovered->SGet("1", "key99", &dentry).ok());
+        ASSERT_EQ(dentry, Value("key99"));
+        ASSERT_EQ(0, localfs->Delete(dir + "/" + files[0].filename));
+    }
+
+    ASSERT_EQ(0, localfs->Delete(dir));
+}
+
 }  // namespace storage
 }  // namespace metaserver
 }  // namespace curvefs
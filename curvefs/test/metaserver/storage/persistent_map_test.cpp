@@ -0,0 +1,230 @@
+/*
+ *  Copyright (c) 2023 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include "curvefs/src/metaserver/storage/persistent_map.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace curvefs {
+namespace metaserver {
+namespace storage {
+
+using Map = PersistentMap<std::string>;
+
+class PersistentMapTest : public testing::Test {
+ protected:
+    // Check the AVL invariants of the subtree, and return its height
+    template <typename NodePtr>
+    static int32_t CheckSubtree(const NodePtr& node,
+                                const std::string* lower,
+                                const std::string* upper) {
+        if (!node) {
+            return 0;
+        }
+
+        if (lower != nullptr) {
+            EXPECT_LT(*lower, node->key);
+        }
+        if (upper != nullptr) {
+            EXPECT_LT(node->key, *upper);
+        }
+
+        int32_t left = CheckSubtree(node->left, lower, &node->key);
+        int32_t right = CheckSubtree(node->right, &node->key, upper);
+        EXPECT_LE(std::abs(left - right), 1) << "key: " << node->key;
+        EXPECT_EQ(std::max(left, right) + 1, node->height)
+            << "key: " << node->key;
+        return node->height;
+    }
+
+    // Return height of the map
+    static int32_t CheckBalanced(const Map& map) {
+        return CheckSubtree(map.root_, nullptr, nullptr);
+    }
+
+    static void CheckEqual(const std::map<std::string, std::string>& expect,
+                           const Map& map) {
+        ASSERT_EQ(expect.size(), map.size());
+        auto iter = map.Begin();
+        for (const auto& kv : expect) {
+            ASSERT_TRUE(iter.Valid());
+            ASSERT_EQ(kv.first, iter.Key());
+            ASSERT_EQ(kv.second, iter.GetValue());
+            iter.Next();
+        }
+        ASSERT_FALSE(iter.Valid());
+    }
+
+    static std::string Key(uint32_t i) {
+        char buf[16];
+        snprintf(buf, sizeof(buf), "%08u", i);
+        return buf;
+    }
+};
+
+TEST_F(PersistentMapTest, InsertFindErase) {
+    Map map;
+    ASSERT_TRUE(map.empty());
+    ASSERT_EQ(nullptr, map.Find("a"));
+    ASSERT_FALSE(map.Erase("a"));
+
+    map.Insert("b", "1");
+    map.Insert("a", "2");
+    map.Insert("c", "3");
+    ASSERT_EQ(3, map.size());
+    ASSERT_EQ("2", *map.Find("a"));
+
+    // replace
+    map.Insert("a", "4");
+    ASSERT_EQ(3, map.size());
+    ASSERT_EQ("4", *map.Find("a"));
+
+    ASSERT_TRUE(map.Erase("b"));
+    ASSERT_FALSE(map.Erase("b"));
+    ASSERT_EQ(nullptr, map.Find("b"));
+    ASSERT_EQ(2, map.size());
+    CheckEqual({{"a", "4"}, {"c", "3"}}, map);
+
+    map.clear();
+    ASSERT_TRUE(map.empty());
+    ASSERT_FALSE(map.Begin().Valid());
+}
+
+TEST_F(PersistentMapTest, LowerBound) {
+    Map map;
+    for (uint32_t i = 0; i < 100; i += 2) {
+        map.Insert(Key(i), Key(i));
+    }
+
+    auto iter = map.LowerBound(Key(11));
+    ASSERT_TRUE(iter.Valid());
+    ASSERT_EQ(Key(12), iter.Key());
+    iter = map.LowerBound(Key(12));
+    ASSERT_TRUE(iter.Valid());
+    ASSERT_EQ(Key(12), iter.Key());
+    iter.Next();
+    ASSERT_EQ(Key(14), iter.Key());
+
+    ASSERT_EQ(Key(0), map.LowerBound("").Key());
+    ASSERT_FALSE(map.LowerBound(Key(99)).Valid());
+}
+
+TEST_F(PersistentMapTest, RandomInsertErase) {
+    std::mt19937 gen(12345);
+    std::uniform_int_distribution<uint32_t> dist(0, 2000);
+    std::map<std::string, std::string> expect;
+    Map map;
+
+    for (int round = 0; round < 20000; round++) {
+        std::string key = Key(dist(gen));
+        if (gen() % 3 == 0) {
+            ASSERT_EQ(expect.erase(key) == 1, map.Erase(key));
+        } else {
+            std::string value = std::to_string(round);
+            expect[key] = value;
+            map.Insert(key, value);
+        }
+
+        if (round % 1000 == 0) {
+            CheckBalanced(map);
+            CheckEqual(expect, map);
+        }
+    }
+
+    CheckBalanced(map);
+    CheckEqual(expect, map);
+    for (const auto& kv : expect) {
+        ASSERT_EQ(kv.second, *map.Find(kv.first));
+    }
+}
+
+TEST_F(PersistentMapTest, SequentialInsertKeepsBalanced) {
+    Map map;
+    for (uint32_t i = 0; i < 4096; i++) {
+        map.Insert(Key(i), "");
+    }
+    // a complete tree of 4096 nodes has 13 levels
+    ASSERT_EQ(13, CheckBalanced(map));
+
+    for (uint32_t i = 0; i < 4096; i += 3) {
+        ASSERT_TRUE(map.Erase(Key(i)));
+    }
+    CheckBalanced(map);
+}
+
+TEST_F(PersistentMapTest, SnapshotIsolation) {
+    std::mt19937 gen(54321);
+    std::map<std::string, std::string> expect;
+    Map map;
+    for (uint32_t i = 0; i < 1000; i++) {
+        map.Insert(Key(i), Key(i));
+        expect[Key(i)] = Key(i);
+    }
+
+    // the copy shares all nodes with the origin
+    Map snapshot = map;
+    auto snapshotExpect = expect;
+    auto iter = map.Begin();
+
+    // erase keys with two children, which moves the minimum of the right
+    // subtree up, and rotates nodes deep in the tree
+    for (int round = 0; round < 500; round++) {
+        std::string key = Key(gen() % 1000);
+        ASSERT_EQ(expect.erase(key) == 1, map.Erase(key));
+        if (round % 5 == 0) {
+            std::string other = Key(1000 + gen() % 1000);
+            map.Insert(other, "new");
+            expect[other] = "new";
+        }
+    }
+    map.Insert(Key(1), "replaced");
+    expect[Key(1)] = "replaced";
+
+    CheckBalanced(map);
+    CheckEqual(expect, map);
+    CheckBalanced(snapshot);
+    CheckEqual(snapshotExpect, snapshot);
+
+    // the iterator created before the modifications sees the old map
+    for (const auto& kv : snapshotExpect) {
+        ASSERT_TRUE(iter.Valid());
+        ASSERT_EQ(kv.first, iter.Key());
+        ASSERT_EQ(kv.second, iter.GetValue());
+        iter.Next();
+    }
+    ASSERT_FALSE(iter.Valid());
+
+    // and modifying the snapshot doesn't affect the origin either
+    for (uint32_t i = 0; i < 1000; i += 2) {
+        ASSERT_TRUE(snapshot.Erase(Key(i)));
+        snapshotExpect.erase(Key(i));
+    }
+    CheckBalanced(snapshot);
+    CheckEqual(snapshotExpect, snapshot);
+    CheckEqual(expect, map);
+}
+
+}  // namespace storage
+}  // namespace metaserver
+}  // namespace curvefs
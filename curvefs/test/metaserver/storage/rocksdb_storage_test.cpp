@@ -29,7 +29,9 @@
 #include <unistd.h>
 
 #include <memory>
+#include <thread>  // NOLINT
 
+#include "absl/strings/match.h"
 #include "curvefs/src/metaserver/storage/storage.h"
 #include "curvefs/src/metaserver/storage/utils.h"
 #include "curvefs/test/metaserver/storage/storage_test.h"
@@ -40,6 +42,7 @@ namespace curvefs {
 namespace metaserver {
 namespace storage {
 
+using ::curvefs::metaserver::storage::CheckpointFile;
 using ::curvefs::metaserver::storage::KVStorage;
 using ::curvefs::metaserver::storage::RocksDBStorage;
 using ::curvefs::metaserver::storage::StorageOptions;
@@ -217,7 +220,7 @@ TEST_F(RocksDBStorageTest, TestRecover) {
     ASSERT_TRUE(kvStorage_->Open());
 
     // do checkpoint
-    std::vector<std::string> files;
+    std::vector<CheckpointFile> files;
     ASSERT_TRUE(kvStorage_->Checkpoint(dirname_, &files));
 
     // recovery
@@ -261,10 +264,20 @@ TEST_F(RocksDBStorageTest, TestCheckpointAndRecover) {
 
     ASSERT_TRUE(s.ok()) << s.ToString();
 
-    std::vector<std::string> files;
+    std::vector<CheckpointFile> files;
     ASSERT_TRUE(kvStorage_->Checkpoint(dirname_, &files));
     EXPECT_FALSE(files.empty());
 
+    // table files have checksums
+    int tables = 0;
+    for (const auto& f : files) {
+        if (absl::EndsWith(f.filename, ".sst")) {
+            tables++;
+            EXPECT_FALSE(f.checksum.empty()) << f.filename;
+        }
+    }
+    EXPECT_GT(tables, 0);
+
     ASSERT_TRUE(kvStorage_->Recover(dirname_));
 
     // get values that checkpoint should have
@@ -294,6 +307,62 @@ TEST_F(RocksDBStorageTest, TestCheckpointAndRecover) {
     EXPECT_EQ(Value("7"), dummyDentry);
 }
 
+TEST_F(RocksDBStorageTest, BatchTest) {
+    Dentry value;
+    std::shared_ptr<StorageTransaction> txn;
+    auto getByOtherThread = [this](const std::string& key) {
+        Status s;
+        Dentry value;
+        std::thread th([&]() { s = kvStorage_->SGet("1", key, &value); });
+        th.join();
+        return s;
+    };
+
+    // CASE 1: commit without batch
+    ASSERT_TRUE(kvStorage_->CommitBatch().IsNotSupported());
+
+    // CASE 2: writes are invisible to other threads before commit
+    ASSERT_TRUE(kvStorage_->BeginBatch().ok());
+    ASSERT_TRUE(kvStorage_->BeginBatch().IsNotSupported());
+    ASSERT_TRUE(kvStorage_->SSet("1", "key1", Value("value1")).ok());
+    ASSERT_TRUE(kvStorage_->SGet("1", "key1", &value).ok());
+    ASSERT_EQ(value, Value("value1"));
+    ASSERT_TRUE(getByOtherThread("key1").IsNotFound());
+
+    // CASE 3: nested transaction only rolls back its own writes
+    txn = kvStorage_->BeginTransaction();
+    ASSERT_NE(txn, nullptr);
+    ASSERT_TRUE(txn->SSet("1", "key2", Value("value2")).ok());
+    ASSERT_TRUE(txn->SDel("1", "key1").ok());
+    ASSERT_TRUE(txn->Rollback().ok());
+    ASSERT_TRUE(kvStorage_->SGet("1", "key1", &value).ok());
+    ASSERT_TRUE(kvStorage_->SGet("1", "key2", &value).IsNotFound());
+
+    // CASE 4: nested transaction keeps its writes in the batch
+    txn = kvStorage_->BeginTransaction();
+    ASSERT_NE(txn, nullptr);
+    ASSERT_TRUE(txn->SSet("1", "key3", Value("value3")).ok());
+    ASSERT_TRUE(txn->Commit().ok());
+    ASSERT_TRUE(getByOtherThread("key3").IsNotFound());
+
+    // iterator sees writes of the batch
+    auto iterator = kvStorage_->SSeek("1", "key");
+    ASSERT_EQ(iterator->Status(), 0);
+    size_t size = 0;
+    for (iterator->SeekToFirst(); iterator->Valid(); iterator->Next()) {
+        size++;
+    }
+    ASSERT_EQ(size, 2);
+    iterator.reset();
+
+    // CASE 5: writes are visible after commit
+    ASSERT_TRUE(kvStorage_->CommitBatch().ok());
+    ASSERT_TRUE(getByOtherThread("key1").ok());
+    ASSERT_TRUE(getByOtherThread("key2").IsNotFound());
+    ASSERT_TRUE(getByOtherThread("key3").ok());
+    ASSERT_TRUE(kvStorage_->CommitBatch().IsNotSupported());
+}
+
 }  // namespace storage
 }  // namespace metaserver
 }  // namespace curvefs
@@ -51,6 +51,20 @@ void ChunkClosure::Run() {
     request_->RedirectChunkRequest();
 }
 
+void BatchReadChunkClosure::Run() {
+    if (pending_.fetch_sub(1, std::memory_order_acq_rel) != 1) {
+        return;
+    }
+
+    std::unique_ptr<BatchReadChunkClosure> selfGuard(this);
+    brpc::ClosureGuard doneGuard(done_);
+    // 只有读成功的子请求有数据
+    for (auto &data : subData_) {
+        cntl_->response_attachment().append(data);
+    }
+    response_->set_status(CHUNK_OP_STATUS::CHUNK_OP_STATUS_SUCCESS);
+}
+
 void ScanChunkClosure::Run() {
     // after run destory
     std::unique_ptr<ScanChunkClosure> selfGuard(this);
@@ -24,7 +24,9 @@
 #define SRC_CHUNKSERVER_CHUNK_CLOSURE_H_
 
 #include <brpc/closure_guard.h>
+#include <atomic>
 #include <memory>
+#include <vector>
 
 #include "src/chunkserver/op_request.h"
 #include "proto/chunk.pb.h"
@@ -53,6 +55,36 @@ class ChunkClosure : public braft::Closure {
     std::shared_ptr<ChunkOpRequest> request_;
 };
 
+/**
+ * 批量读请求拆分成多个ReadChunkRequest执行，各个子请求读到的数据先放在
+ * 各自的buffer中，全部完成后按子请求的顺序拼接到rpc的response attachment
+ */
+class BatchReadChunkClosure : public google::protobuf::Closure {
+ public:
+    BatchReadChunkClosure(brpc::Controller *cntl,
+                          BatchChunkResponse *response,
+                          google::protobuf::Closure *done,
+                          int count)
+        : cntl_(cntl), response_(response), done_(done),
+          pending_(count), subData_(count) {}
+
+    ~BatchReadChunkClosure() = default;
+
+    // 每个子请求完成时调用一次
+    void Run() override;
+
+    butil::IOBuf* SubData(int index) {
+        return &subData_[index];
+    }
+
+ private:
+    brpc::Controller *cntl_;
+    BatchChunkResponse *response_;
+    google::protobuf::Closure *done_;
+    std::atomic<int> pending_;
+    std::vector<butil::IOBuf> subData_;
+};
+
 class ScanChunkClosure : public google::protobuf::Closure {
  public:
     ScanChunkClosure(ChunkRequest *request, ChunkResponse *response) :
@@ -30,6 +30,7 @@
 #include <cerrno>
 #include <vector>
 
+#include "src/chunkserver/chunk_closure.h"
 #include "src/chunkserver/copyset_node.h"
 #include "src/chunkserver/copyset_node_manager.h"
 #include "src/chunkserver/chunkserver_metrics.h"
@@ -274,6 +275,182 @@ void ChunkServiceImpl::ReadChunk(RpcController *controller,
     req->Process();
 }
 
+void ChunkServiceImpl::ReadChunks(RpcController *controller,
+                                  const BatchChunkRequest *request,
+                                  BatchChunkResponse *response,
+                                  Closure *done) {
+    BatchChunkServiceClosure* closure =
+        new (std::nothrow) BatchChunkServiceClosure(inflightThrottle_,
+                                                    request,
+                                                    response,
+                                                    done);
+    CHECK(nullptr != closure) << "new batch chunk service closure failed";
+
+    brpc::ClosureGuard doneGuard(closure);
+
+    if (inflightThrottle_->IsOverLoad()) {
+        response->set_status(CHUNK_OP_STATUS::CHUNK_OP_STATUS_OVERLOAD);
+        LOG_EVERY_N(WARNING, 100)
+            << "ReadChunks: "
+            << "too many inflight requests to process in chunkserver";
+        return;
+    }
+
+    CHUNK_OP_STATUS status =
+        CheckBatchRequest(request, CHUNK_OP_TYPE::CHUNK_OP_READ);
+    if (status != CHUNK_OP_STATUS::CHUNK_OP_STATUS_SUCCESS) {
+        response->set_status(status);
+        return;
+    }
+
+    // 判断copyset是否存在
+    auto nodePtr = copysetNodeManager_->GetCopysetNode(request->logicpoolid(),
+                                                       request->copysetid());
+    if (nullptr == nodePtr) {
+        response->set_status(CHUNK_OP_STATUS::CHUNK_OP_STATUS_COPYSET_NOTEXIST);
+        LOG(WARNING) << "read chunks failed, copyset node is not found:"
+                     << request->logicpoolid() << "," << request->copysetid();
+        return;
+    }
+
+    // 整个请求重定向，避免子请求分别重定向
+    if (!nodePtr->IsLeaderTerm()) {
+        response->set_status(CHUNK_OP_STATUS::CHUNK_OP_STATUS_REDIRECTED);
+        return;
+    }
+
+    const int count = request->requests_size();
+    // 先分配好所有子请求的response，子请求并发执行时不能再修改repeated字段
+    for (int i = 0; i < count; ++i) {
+        response->add_responses()->set_status(
+            CHUNK_OP_STATUS::CHUNK_OP_STATUS_FAILURE_UNKNOWN);
+    }
+
+    brpc::Controller *cntl = dynamic_cast<brpc::Controller *>(controller);
+    BatchReadChunkClosure *batchDone =
+        new BatchReadChunkClosure(cntl, response, doneGuard.release(), count);
+    CloneManager* cloneMgr = chunkServiceOptions_.cloneManager;
+    for (int i = 0; i < count; ++i) {
+        std::shared_ptr<ReadChunkRequest> req =
+            std::make_shared<ReadChunkRequest>(nodePtr,
+                                               cloneMgr,
+                                               &request->requests(i),
+                                               response->mutable_responses(i),
+                                               batchDone->SubData(i),
+                                               batchDone);
+        req->Process();
+    }
+}
+
+void ChunkServiceImpl::WriteChunks(RpcController *controller,
+                                   const BatchChunkRequest *request,
+                                   BatchChunkResponse *response,
+                                   Closure *done) {
+    BatchChunkServiceClosure* closure =
+        new (std::nothrow) BatchChunkServiceClosure(inflightThrottle_,
+                                                    request,
+                                                    response,
+                                                    done);
+    CHECK(nullptr != closure) << "new batch chunk service closure failed";
+
+    brpc::ClosureGuard doneGuard(closure);
+
+    if (inflightThrottle_->IsOverLoad()) {
+        response->set_status(CHUNK_OP_STATUS::CHUNK_OP_STATUS_OVERLOAD);
+        LOG_EVERY_N(WARNING, 100)
+            << "WriteChunks: "
+            << "too many inflight requests to process in chunkserver";
+        return;
+    }
+
+    CHUNK_OP_STATUS status =
+        CheckBatchRequest(request, CHUNK_OP_TYPE::CHUNK_OP_WRITE);
+    if (status != CHUNK_OP_STATUS::CHUNK_OP_STATUS_SUCCESS) {
+        response->set_status(status);
+        return;
+    }
+
+    // 数据按子请求的顺序拼接在attachment中
+    brpc::Controller *cntl = dynamic_cast<brpc::Controller *>(controller);
+    uint64_t dataSize = 0;
+    for (const ChunkRequest &sub : request->requests()) {
+        dataSize += sub.size();
+    }
+    if (cntl->request_attachment().size() != dataSize) {
+        response->set_status(CHUNK_OP_STATUS::CHUNK_OP_STATUS_INVALID_REQUEST);
+        LOG(ERROR) << "write chunks failed, attachment size "
+                   << cntl->request_attachment().size()
+                   << " mismatch with request size " << dataSize;
+        return;
+    }
+
+    // 判断copyset是否存在
+    auto nodePtr = copysetNodeManager_->GetCopysetNode(request->logicpoolid(),
+                                                       request->copysetid());
+    if (nullptr == nodePtr) {
+        response->set_status(CHUNK_OP_STATUS::CHUNK_OP_STATUS_COPYSET_NOTEXIST);
+        LOG(WARNING) << "write chunks failed, copyset node is not found:"
+                     << request->logicpoolid() << "," << request->copysetid();
+        return;
+    }
+
+    std::shared_ptr<BatchWriteChunkRequest>
+        req = std::make_shared<BatchWriteChunkRequest>(nodePtr,
+                                                       controller,
+                                                       request,
+                                                       response,
+                                                       doneGuard.release());
+    req->Process();
+}
+
+void ChunkServiceImpl::DeleteChunks(RpcController *controller,
+                                    const BatchChunkRequest *request,
+                                    BatchChunkResponse *response,
+                                    Closure *done) {
+    BatchChunkServiceClosure* closure =
+        new (std::nothrow) BatchChunkServiceClosure(inflightThrottle_,
+                                                    request,
+                                                    response,
+                                                    done);
+    CHECK(nullptr != closure) << "new batch chunk service closure failed";
+
+    brpc::ClosureGuard doneGuard(closure);
+
+    if (inflightThrottle_->IsOverLoad()) {
+        response->set_status(CHUNK_OP_STATUS::CHUNK_OP_STATUS_OVERLOAD);
+        LOG_EVERY_N(WARNING, 100)
+            << "DeleteChunks: "
+            << "too many inflight requests to process in chunkserver";
+        return;
+    }
+
+    CHUNK_OP_STATUS status =
+        CheckBatchRequest(request, CHUNK_OP_TYPE::CHUNK_OP_DELETE);
+    if (status != CHUNK_OP_STATUS::CHUNK_OP_STATUS_SUCCESS) {
+        response->set_status(status);
+        return;
+    }
+
+    // 判断copyset是否存在
+    auto nodePtr = copysetNodeManager_->GetCopysetNode(request->logicpoolid(),
+                                                       request->copysetid());
+    if (nullptr == nodePtr) {
+        response->set_status(CHUNK_OP_STATUS::CHUNK_OP_STATUS_COPYSET_NOTEXIST);
+        LOG(WARNING) << "delete chunks failed, copyset node is not found:"
+                     << request->logicpoolid() << "," << request->copysetid();
+        return;
+    }
+
+    // 和批量写共用一条日志，apply时按子请求的类型执行
+    std::shared_ptr<BatchWriteChunkRequest>
+        req = std::make_shared<BatchWriteChunkRequest>(nodePtr,
+                                                       controller,
+                                                       request,
+                                                       response,
+                                                       doneGuard.release());
+    req->Process();
+}
+
 void ChunkServiceImpl::RecoverChunk(RpcController *controller,
                                     const ChunkRequest *request,
                                     ChunkResponse *response,
@@ -577,6 +754,36 @@ void ChunkServiceImpl::UpdateEpoch(RpcController *controller,
     }
 }
 
+CHUNK_OP_STATUS ChunkServiceImpl::CheckBatchRequest(
+    const BatchChunkRequest *request, CHUNK_OP_TYPE opType) const {
+    if (request->optype() != opType || request->requests_size() == 0) {
+        LOG(ERROR) << "invalid batch request, op: " << request->optype()
+                   << ", request count: " << request->requests_size();
+        return CHUNK_OP_STATUS::CHUNK_OP_STATUS_INVALID_REQUEST;
+    }
+
+    for (const ChunkRequest &sub : request->requests()) {
+        if (sub.optype() != opType ||
+            sub.logicpoolid() != request->logicpoolid() ||
+            sub.copysetid() != request->copysetid() ||
+            !CheckRequestOffsetAndLength(sub.offset(), sub.size())) {
+            LOG(ERROR) << "invalid batch sub request: "
+                       << sub.ShortDebugString();
+            return CHUNK_OP_STATUS::CHUNK_OP_STATUS_INVALID_REQUEST;
+        }
+
+        if (sub.has_epoch() &&
+            !epochMap_->CheckEpoch(sub.fileid(), sub.epoch())) {
+            LOG(WARNING) << "I/O request, op: " << sub.optype()
+                         << ", CheckEpoch failed, ChunkRequest: "
+                         << sub.ShortDebugString();
+            return CHUNK_OP_STATUS::CHUNK_OP_STATUS_EPOCH_TOO_OLD;
+        }
+    }
+
+    return CHUNK_OP_STATUS::CHUNK_OP_STATUS_SUCCESS;
+}
+
 bool ChunkServiceImpl::CheckRequestOffsetAndLength(uint32_t offset,
                                                    uint32_t len) const {
     // 检查offset+len是否越界
@@ -60,6 +60,21 @@ class ChunkServiceImpl : public ChunkService {
                     ChunkResponse *response,
                     Closure *done);
 
+    void ReadChunks(RpcController *controller,
+                    const BatchChunkRequest *request,
+                    BatchChunkResponse *response,
+                    Closure *done);
+
+    void WriteChunks(RpcController *controller,
+                     const BatchChunkRequest *request,
+                     BatchChunkResponse *response,
+                     Closure *done);
+
+    void DeleteChunks(RpcController *controller,
+                      const BatchChunkRequest *request,
+                      BatchChunkResponse *response,
+                      Closure *done);
+
     void ReadChunkSnapshot(RpcController *controller,
                            const ChunkRequest *request,
                            ChunkResponse *response,
@@ -107,6 +122,15 @@ class ChunkServiceImpl : public ChunkService {
      */
     bool CheckRequestOffsetAndLength(uint32_t offset, uint32_t len) const;
 
+    /**
+     * 检查批量请求，子请求的类型和copyset必须和批量请求一致，
+     * 并且每个子请求的offset和length都合法
+     * @param opType[in]: rpc对应的请求类型
+     * @return 合法返回CHUNK_OP_STATUS_SUCCESS，否则返回对应的错误码
+     */
+    CHUNK_OP_STATUS CheckBatchRequest(const BatchChunkRequest *request,
+                                      CHUNK_OP_TYPE opType) const;
+
  private:
     ChunkServiceOptions chunkServiceOptions_;
     CopysetNodeManager  *copysetNodeManager_;
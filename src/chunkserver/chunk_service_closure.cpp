@@ -151,5 +151,65 @@ void ChunkServiceClosure::OnResonse() {
     }
 }
 
+void BatchChunkServiceClosure::Run() {
+    std::unique_ptr<BatchChunkServiceClosure> selfGuard(this);
+
+    {
+        brpc::ClosureGuard doneGuard(brpcDone_);
+        OnResonse();
+    }
+
+    if (nullptr != inflightThrottle_) {
+        inflightThrottle_->Decrement();
+    }
+}
+
+void BatchChunkServiceClosure::OnRequest() {
+    if (request_ == nullptr || response_ == nullptr)
+        return;
+
+    CSIOMetricType type = request_->optype() == CHUNK_OP_TYPE::CHUNK_OP_READ ?
+                          CSIOMetricType::READ_CHUNK :
+                          CSIOMetricType::WRITE_CHUNK;
+    ChunkServerMetric* metric = ChunkServerMetric::GetInstance();
+    for (int i = 0; i < request_->requests_size(); ++i) {
+        metric->OnRequest(request_->logicpoolid(),
+                          request_->copysetid(),
+                          type);
+    }
+}
+
+void BatchChunkServiceClosure::OnResonse() {
+    if (request_ == nullptr || response_ == nullptr)
+        return;
+
+    bool isRead = request_->optype() == CHUNK_OP_TYPE::CHUNK_OP_READ;
+    CSIOMetricType type = isRead ? CSIOMetricType::READ_CHUNK :
+                                   CSIOMetricType::WRITE_CHUNK;
+    ChunkServerMetric* metric = ChunkServerMetric::GetInstance();
+    uint64_t latencyUs =
+        common::TimeUtility::GetTimeofDayUs() - receivedTimeUs_;
+    for (int i = 0; i < request_->requests_size(); ++i) {
+        // 整个请求失败时没有子请求的response
+        CHUNK_OP_STATUS status = response_->status();
+        if (status == CHUNK_OP_STATUS::CHUNK_OP_STATUS_SUCCESS &&
+            i < response_->responses_size()) {
+            status = response_->responses(i).status();
+        }
+        bool hasError = status != CHUNK_OP_STATUS::CHUNK_OP_STATUS_SUCCESS;
+        // 和单个请求一样，读返回CHUNK_OP_STATUS_CHUNK_NOTEXIST也认为是正确的
+        if (isRead &&
+            status == CHUNK_OP_STATUS::CHUNK_OP_STATUS_CHUNK_NOTEXIST) {
+            hasError = false;
+        }
+        metric->OnResponse(request_->logicpoolid(),
+                           request_->copysetid(),
+                           type,
+                           request_->requests(i).size(),
+                           latencyUs,
+                           hasError);
+    }
+}
+
 }  // namespace chunkserver
 }  // namespace curve
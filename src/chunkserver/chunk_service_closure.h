@@ -87,6 +87,41 @@ class ChunkServiceClosure : public braft::Closure {
     uint64_t receivedTimeUs_;
 };
 
+// 批量读写请求的闭包，按子请求分别统计metric
+class BatchChunkServiceClosure : public braft::Closure {
+ public:
+    BatchChunkServiceClosure(
+            std::shared_ptr<InflightThrottle> inflightThrottle,
+            const BatchChunkRequest *request,
+            BatchChunkResponse *response,
+            google::protobuf::Closure *done)
+        : inflightThrottle_(inflightThrottle)
+        , request_(request)
+        , response_(response)
+        , brpcDone_(done)
+        , receivedTimeUs_(common::TimeUtility::GetTimeofDayUs()) {
+            if (nullptr != inflightThrottle_) {
+                inflightThrottle_->Increment();
+            }
+            OnRequest();
+        }
+
+    ~BatchChunkServiceClosure() = default;
+
+    void Run() override;
+
+ private:
+    void OnRequest();
+    void OnResonse();
+
+ private:
+    std::shared_ptr<InflightThrottle> inflightThrottle_;
+    const BatchChunkRequest *request_;
+    BatchChunkResponse *response_;
+    google::protobuf::Closure *brpcDone_;
+    uint64_t receivedTimeUs_;
+};
+
 }  // namespace chunkserver
 }  // namespace curve
 
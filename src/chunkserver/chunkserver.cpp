@@ -125,11 +125,20 @@ int ChunkServer::Run(int argc, char** argv) {
         << "Failed to initialize concurrentapply module!";
 
     // 初始化本地文件系统
-    std::shared_ptr<LocalFileSystem> fs(
-        LocalFsFactory::CreateFs(FileSystemType::EXT4, ""));
+    bool enableIoUring = false;
+    LOG_IF(WARNING, !conf.GetBoolValue("fs.enable_io_uring", &enableIoUring))
+        << "config no fs.enable_io_uring info, using default value "
+        << enableIoUring;
+    std::shared_ptr<LocalFileSystem> fs(LocalFsFactory::CreateFs(
+        enableIoUring ? FileSystemType::EXT4_IOURING : FileSystemType::EXT4,
+        ""));
     LocalFileSystemOption lfsOption;
     LOG_IF(FATAL, !conf.GetBoolValue(
         "fs.enable_renameat2", &lfsOption.enableRenameat2));
+    LOG_IF(WARNING, !conf.GetUInt32Value(
+        "fs.io_uring_queue_depth", &lfsOption.ioUringQueueDepth))
+        << "config no fs.io_uring_queue_depth info, using default value "
+        << lfsOption.ioUringQueueDepth;
     LOG_IF(FATAL, 0 != fs->Init(lfsOption))
         << "Failed to initialize local filesystem module!";
 
@@ -311,6 +320,7 @@ int ChunkServer::Run(int argc, char** argv) {
     // 监控部分模块的metric指标
     metric->MonitorTrash(trash_.get());
     metric->MonitorChunkFilePool(chunkfilePool.get());
+    metric->MonitorReadBufferPool(ReadBufferPool::GetInstance());
     if (raftLogProtocol == kProtocalCurve && !useChunkFilePoolAsWalPool) {
         metric->MonitorWalFilePool(walFilePool.get());
     }
@@ -540,6 +550,10 @@ void ChunkServer::InitConcurrentApplyOptions(common::Configuration *conf,
         "rconcurrentapply.queuedepth", &concurrentApplyOptions->rqueuedepth));
     LOG_IF(FATAL, !conf->GetIntValue(
         "wconcurrentapply.queuedepth", &concurrentApplyOptions->wqueuedepth));
+    LOG_IF(WARNING, !conf->GetBoolValue("concurrentapply.lock_free_queue",
+        &concurrentApplyOptions->lockfreequeue))
+        << "config no concurrentapply.lock_free_queue info, "
+        << "using default value " << concurrentApplyOptions->lockfreequeue;
 }
 
 void ChunkServer::InitWalFilePoolOptions(
@@ -633,6 +647,17 @@ void ChunkServer::InitCopysetNodeOptions(
         LOG_IF(FATAL, !conf->GetUInt32Value("copyset.sync_trigger_seconds",
                 &copysetNodeOptions->syncTriggerSeconds));
     }
+
+    ret = conf->GetBoolValue("copyset.enable_write_ahead",
+        &copysetNodeOptions->enableWriteAhead);
+    LOG_IF(WARNING, ret == false)
+        << "config no copyset.enable_write_ahead info, using default value "
+        << copysetNodeOptions->enableWriteAhead;
+    ret = conf->GetUInt32Value("copyset.write_ahead_min_size",
+        &copysetNodeOptions->writeAheadMinSize);
+    LOG_IF(WARNING, ret == false)
+        << "config no copyset.write_ahead_min_size info, using default value "
+        << copysetNodeOptions->writeAheadMinSize;
 }
 
 void ChunkServer::InitCopyerOptions(
@@ -219,7 +219,8 @@ ChunkServerMetric::ChunkServerMetric()
     : hasInited_(false), leaderCount_(nullptr), chunkLeft_(nullptr),
       walSegmentLeft_(nullptr), chunkTrashed_(nullptr), chunkCount_(nullptr),
       walSegmentCount_(nullptr), snapshotCount_(nullptr),
-      cloneChunkCount_(nullptr) {}
+      cloneChunkCount_(nullptr), readBufferHit_(nullptr),
+      readBufferMiss_(nullptr), readBufferCachedBytes_(nullptr) {}
 
 ChunkServerMetric *ChunkServerMetric::self_ = nullptr;
 
@@ -284,6 +285,9 @@ int ChunkServerMetric::Fini() {
     chunkLeft_ = nullptr;
     walSegmentLeft_ = nullptr;
     chunkTrashed_ = nullptr;
+    readBufferHit_ = nullptr;
+    readBufferMiss_ = nullptr;
+    readBufferCachedBytes_ = nullptr;
     chunkCount_ = nullptr;
     snapshotCount_ = nullptr;
     cloneChunkCount_ = nullptr;
@@ -401,6 +405,20 @@ void ChunkServerMetric::MonitorTrash(Trash *trash) {
         chunkTrashedPrefix, GetChunkTrashedFunc, trash);
 }
 
+void ChunkServerMetric::MonitorReadBufferPool(ReadBufferPool *pool) {
+    if (!option_.collectMetric) {
+        return;
+    }
+
+    readBufferHit_ = std::make_shared<bvar::PassiveStatus<uint64_t>>(
+        Prefix() + "_read_buffer_pool_hit", GetReadBufferPoolHitFunc, pool);
+    readBufferMiss_ = std::make_shared<bvar::PassiveStatus<uint64_t>>(
+        Prefix() + "_read_buffer_pool_miss", GetReadBufferPoolMissFunc, pool);
+    readBufferCachedBytes_ = std::make_shared<bvar::PassiveStatus<uint64_t>>(
+        Prefix() + "_read_buffer_pool_cached_bytes",
+        GetReadBufferPoolCachedBytesFunc, pool);
+}
+
 void ChunkServerMetric::IncreaseLeaderCount() {
     if (!option_.collectMetric) {
         return;
@@ -35,6 +35,7 @@
 #include "src/common/concurrent/rw_lock.h"
 #include "src/common/configuration.h"
 #include "src/chunkserver/datastore/file_pool.h"
+#include "src/chunkserver/read_buffer_pool.h"
 
 using curve::common::Configuration;
 using curve::common::ReadLockGuard;
@@ -437,6 +438,12 @@ class ChunkServerMetric : public Uncopyable {
      */
     void MonitorTrash(Trash *trash);
 
+    /**
+     * 监视读buffer池，包括命中、未命中次数和缓存的buffer大小
+     * @param pool: ReadBufferPool的对象指针
+     */
+    void MonitorReadBufferPool(ReadBufferPool *pool);
+
     /**
      * 增加 leader count 计数
      */
@@ -534,6 +541,12 @@ class ChunkServerMetric : public Uncopyable {
     PassiveStatusPtr<uint32_t> walSegmentLeft_;
     // trash 中的 chunk 的数量
     PassiveStatusPtr<uint32_t> chunkTrashed_;
+    // 读buffer池的命中次数
+    PassiveStatusPtr<uint64_t> readBufferHit_;
+    // 读buffer池的未命中次数
+    PassiveStatusPtr<uint64_t> readBufferMiss_;
+    // 读buffer池中空闲buffer的总大小
+    PassiveStatusPtr<uint64_t> readBufferCachedBytes_;
     // chunkserver上的 chunk 的数量
     PassiveStatusPtr<uint32_t> chunkCount_;
     // The total number of WAL segment in chunkserver
@@ -29,6 +29,7 @@
 #include "src/chunkserver/copyset_node.h"
 #include "src/chunkserver/chunk_service_closure.h"
 #include "src/chunkserver/datastore/chunkserver_datastore.h"
+#include "src/chunkserver/read_buffer_pool.h"
 #include "src/common/timeutility.h"
 
 namespace curve {
@@ -264,12 +265,15 @@ int CloneCore::ReadChunk(std::shared_ptr<ReadChunkRequest> readRequest) {
     const ChunkRequest* request = readRequest->request_;
     off_t offset = request->offset();
     size_t length = request->size();
-    std::unique_ptr<char[]> chunkData(new char[length]);
+    ReadBufferPool::Deleter deleter = nullptr;
+    char* buf = ReadBufferPool::GetInstance()->Alloc(length, &deleter);
+    butil::IOBuf chunkData;
+    chunkData.append_user_data(buf, length, deleter);
     std::shared_ptr<CSDataStore> dataStore = readRequest->datastore_;
     CSErrorCode errorCode;
     errorCode = dataStore->ReadChunk(request->chunkid(),
                                      request->sn(),
-                                     chunkData.get(),
+                                     buf,
                                      offset,
                                      length);
     if (CSErrorCode::Success != errorCode) {
@@ -288,8 +292,7 @@ int CloneCore::ReadChunk(std::shared_ptr<ReadChunkRequest> readRequest) {
     // 读成功后需要更新 apply index
     readRequest->node_->UpdateAppliedIndex(readRequest->applyIndex);
     // Return 完成数据读取后可以将结果返回给用户
-    readRequest->cntl_->response_attachment().append(
-        chunkData.get(), length);
+    readRequest->ResponseData()->append(chunkData);
     SetResponse(readRequest, CHUNK_OP_STATUS::CHUNK_OP_STATUS_SUCCESS);
     return 0;
 }
@@ -329,10 +332,12 @@ int CloneCore::SetReadChunkResponse(
     butil::IOBuf responseData;
     // 如果chunk存在，则要从chunk中读取已经写过的区域合并后返回
     if (errorCode == CSErrorCode::Success) {
-        char* chunkData = new (std::nothrow) char[length];
+        ReadBufferPool::Deleter deleter = nullptr;
+        char* chunkData = ReadBufferPool::GetInstance()->Alloc(length,
+                                                               &deleter);
         int ret = ReadThenMerge(
             readRequest, chunkInfo, cloneData, chunkData);
-        responseData.append_user_data(chunkData, length, ReadBufferDeleter);
+        responseData.append_user_data(chunkData, length, deleter);
         if (ret < 0) {
             SetResponse(readRequest,
                         CHUNK_OP_STATUS::CHUNK_OP_STATUS_FAILURE_UNKNOWN);
@@ -341,7 +346,7 @@ int CloneCore::SetReadChunkResponse(
     } else {
         responseData = *cloneData;
     }
-    readRequest->cntl_->response_attachment().append(responseData);
+    readRequest->ResponseData()->append(responseData);
 
     // 读成功后需要更新 apply index
     readRequest->node_->UpdateAppliedIndex(readRequest->applyIndex);
@@ -71,6 +71,7 @@ bool ConcurrentApplyModule::checkOptAndInit(
     wqueuedepth_ = opt.wqueuedepth;
     rconcurrentsize_ = opt.rconcurrentsize;
     rqueuedepth_ = opt.rqueuedepth;
+    lockfreequeue_ = opt.lockfreequeue;
 
     return true;
 }
@@ -79,7 +80,7 @@ bool ConcurrentApplyModule::checkOptAndInit(
 void ConcurrentApplyModule::InitThreadPool(
     ApplyTaskType type, int concurrent, int depth) {
     for (int i = 0; i < concurrent; i++) {
-        auto asyncth = new (std::nothrow) TaskThread(depth);
+        auto asyncth = new (std::nothrow) TaskThread(depth, lockfreequeue_);
         CHECK(asyncth != nullptr) << "allocate failed!";
 
         switch (type) {
@@ -113,11 +114,11 @@ void ConcurrentApplyModule::Run(ApplyTaskType type, int index) {
     while (start_) {
         switch (type) {
         case ApplyTaskType::READ:
-            rapplyMap_[index]->tq.Pop()();
+            rapplyMap_[index]->RunOne();
             break;
 
         case ApplyTaskType::WRITE:
-            wapplyMap_[index]->tq.Pop()();
+            wapplyMap_[index]->RunOne();
             break;
         }
     }
@@ -128,14 +129,14 @@ void ConcurrentApplyModule::Stop() {
     start_ = false;
     auto wakeup = []() {};
     for (auto iter : rapplyMap_) {
-        iter.second->tq.Push(wakeup);
+        iter.second->Push(wakeup);
         iter.second->th.join();
         delete iter.second;
     }
     rapplyMap_.clear();
 
     for (auto iter : wapplyMap_) {
-        iter.second->tq.Push(wakeup);
+        iter.second->Push(wakeup);
         iter.second->th.join();
         delete iter.second;
     }
@@ -151,7 +152,7 @@ void ConcurrentApplyModule::Flush() {
     };
 
     for (int i = 0; i < wconcurrentsize_; i++) {
-        wapplyMap_[i]->tq.Push(flushtask);
+        wapplyMap_[i]->Push(flushtask);
     }
 
     event.Wait();
@@ -29,6 +29,7 @@
 
 #include <atomic>
 #include <condition_variable>  // NOLINT
+#include <memory>
 #include <mutex>               // NOLINT
 #include <thread>              // NOLINT
 #include <unordered_map>
@@ -37,6 +38,7 @@
 #include "include/curve_compiler_specific.h"
 #include "proto/chunk.pb.h"
 #include "src/common/concurrent/count_down_event.h"
+#include "src/common/concurrent/mpsc_task_queue.h"
 #include "src/common/concurrent/task_queue.h"
 
 using curve::common::CountDownEvent;
@@ -46,6 +48,7 @@ namespace curve {
 namespace chunkserver {
 namespace concurrent {
 
+using ::curve::common::GenericTaskThread;
 using ::curve::common::GenericTaskQueue;
 
 struct ConcurrentApplyOption {
@@ -53,11 +56,15 @@ struct ConcurrentApplyOption {
     int wqueuedepth;
     int rconcurrentsize;
     int rqueuedepth;
+    // use lock-free mpsc queue instead of mutex based task queue
+    bool lockfreequeue;
 
     ConcurrentApplyOption(int wconcurrentsize = 0, int wqueuedepth = 0,
-                          int rconcurrentsize = 0, int rqueuedepth = 0)
+                          int rconcurrentsize = 0, int rqueuedepth = 0,
+                          bool lockfreequeue = false)
         : wconcurrentsize(wconcurrentsize), wqueuedepth(wqueuedepth),
-          rconcurrentsize(rconcurrentsize), rqueuedepth(rqueuedepth) {}
+          rconcurrentsize(rconcurrentsize), rqueuedepth(rqueuedepth),
+          lockfreequeue(lockfreequeue) {}
 };
 
 enum class ApplyTaskType {READ, WRITE};
@@ -69,6 +76,7 @@ class CURVE_CACHELINE_ALIGNMENT ConcurrentApplyModule {
                              rqueuedepth_(0),
                              wconcurrentsize_(0),
                              wqueuedepth_(0),
+                             lockfreequeue_(false),
                              cond_(0) {}
 
     /**
@@ -91,11 +99,11 @@ class CURVE_CACHELINE_ALIGNMENT ConcurrentApplyModule {
     bool Push(uint64_t key, ApplyTaskType optype, F&& f, Args&&... args) {
         switch (optype) {
             case ApplyTaskType::READ:
-                rapplyMap_[Hash(key, rconcurrentsize_)]->tq.Push(
+                rapplyMap_[Hash(key, rconcurrentsize_)]->Push(
                         std::forward<F>(f), std::forward<Args>(args)...);
                 break;
             case ApplyTaskType::WRITE:
-                wapplyMap_[Hash(key, wconcurrentsize_)]->tq.Push(
+                wapplyMap_[Hash(key, wconcurrentsize_)]->Push(
                         std::forward<F>(f), std::forward<Args>(args)...);
                 break;
         }
@@ -122,17 +130,15 @@ class CURVE_CACHELINE_ALIGNMENT ConcurrentApplyModule {
     }
 
  private:
-    struct TaskThread {
-        std::thread th;
-        GenericTaskQueue<bthread::Mutex, bthread::ConditionVariable> tq;
-        explicit TaskThread(size_t capacity) : tq(capacity) {}
-    };
+    using TaskThread =
+        GenericTaskThread<bthread::Mutex, bthread::ConditionVariable>;
 
     bool start_;
     int rconcurrentsize_;
     int rqueuedepth_;
     int wconcurrentsize_;
     int wqueuedepth_;
+    bool lockfreequeue_;
     CountDownEvent cond_;
     CURVE_CACHELINE_ALIGNMENT std::unordered_map<int, TaskThread*> wapplyMap_;
     CURVE_CACHELINE_ALIGNMENT std::unordered_map<int, TaskThread*> rapplyMap_;
@@ -141,6 +141,13 @@ struct CopysetNodeOptions {
     // check syncing interval
     uint32_t checkSyncingIntervalMs = 500u;
 
+    // 大块对齐写先直接写入chunk文件，日志中只记录引用和crc，避免数据
+    // 在WAL和chunk文件中各写一次；follower依赖日志中的数据，所以只对
+    // 单副本的复制组生效
+    bool enableWriteAhead = false;
+    // 使用write ahead的最小请求大小
+    uint32_t writeAheadMinSize = 64 * 1024;
+
     CopysetNodeOptions();
 };
 
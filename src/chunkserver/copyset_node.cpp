@@ -61,6 +61,17 @@ using curve::fs::FileSystemInfo;
 
 const char *kCurveConfEpochFilename = "conf.epoch";
 
+namespace {
+// 只更新为更大的值
+void UpdateToMax(std::atomic<int64_t> *value, int64_t index) {
+    int64_t cur = value->load(std::memory_order_acquire);
+    while (index > cur &&
+           !value->compare_exchange_weak(cur, index,
+                                         std::memory_order_acq_rel)) {
+    }
+}
+}  // namespace
+
 uint32_t CopysetNode::syncTriggerSeconds_ = 25;
 std::shared_ptr<common::TaskThreadPool<>>
     CopysetNode::copysetSyncPool_ = nullptr;
@@ -156,6 +167,13 @@ int CopysetNode::Init(const CopysetNodeOptions &options) {
                   "syncthreshold = " << options.syncThreshold;
     }
 
+    enableWriteAhead_ = options.enableWriteAhead;
+    writeAheadMinSize_ = options.writeAheadMinSize;
+    if (enableWriteAhead_) {
+        LOG(INFO) << "write ahead enabled, min size = " << writeAheadMinSize_
+                  << ", copyset: " << GroupIdString();
+    }
+
     recyclerUri_ = options.recyclerUri;
 
     // init braft lease
@@ -220,6 +238,27 @@ int CopysetNode::Run() {
         return -1;
     }
 
+    if (enableWriteAhead_) {
+        /**
+         * 重启前的日志中可能有write ahead日志，回放时扫描日志会
+         * 一一区分，拿不到log storage时保守地认为到最后一条日志都是
+         */
+        NodeStatus status;
+        raftNode_->get_status(&status);
+        UpdateToMax(&startupLogIndex_, status.last_index);
+        Configuration conf;
+        {
+            std::lock_guard<std::mutex> lockguard(confLock_);
+            conf = conf_;
+        }
+        if (conf.empty()) {
+            conf = nodeOptions_.initial_conf;
+        }
+        if (conf.size() == 1 && conf.contains(peerId_)) {
+            UpdateWriteAheadIndex(status.last_index);
+        }
+    }
+
     if (!enableOdsyncWhenOpenChunkFile_) {
         syncThread_.Run();
     }
@@ -246,6 +285,9 @@ void CopysetNode::Fini() {
         // 将未刷盘的数据落盘，如果不刷盘
         // 迁移copyset时，copyset移除后再去执行WriteChunk操作可能出错
         concurrentapply_->Flush();
+        if (nullptr != dataStore_) {
+            dataStore_->WaitAsyncIo();
+        }
     }
 }
 
@@ -303,9 +345,14 @@ void CopysetNode::on_apply(::braft::Iterator &iter) {
             CHECK(nullptr != chunkClosure)
                 << "ChunkClosure dynamic cast failed";
             std::shared_ptr<ChunkOpRequest>& opRequest = chunkClosure->request_;
-            concurrentapply_->Push(opRequest->ChunkId(), ChunkOpRequest::Schedule(opRequest->OpType()),  // NOLINT
-                                   &ChunkOpRequest::OnApply, opRequest,
-                                   iter.index(), doneGuard.release());
+            if (opRequest->OpType() == CHUNK_OP_TYPE::CHUNK_OP_BATCH_WRITE) {
+                // 批量写涉及多个chunk，在这里按chunk拆分后分发
+                opRequest->OnApply(iter.index(), doneGuard.release());
+            } else {
+                concurrentapply_->Push(opRequest->ChunkId(), ChunkOpRequest::Schedule(opRequest->OpType()),  // NOLINT
+                                       &ChunkOpRequest::OnApply, opRequest,
+                                       iter.index(), doneGuard.release());
+            }
         } else {
             // 获取log entry
             butil::IOBuf log = iter.data();
@@ -315,14 +362,34 @@ void CopysetNode::on_apply(::braft::Iterator &iter) {
              * 然后获取Op信息进行apply
              * 2.2. follower apply
              */
+            if (!writeAheadLogsScanned_) {
+                ScanWriteAheadLogs(iter.index());
+            }
             ChunkRequest request;
             butil::IOBuf data;
             auto opReq = ChunkOpRequest::Decode(log, &request, &data,
                                                 iter.index(), GetLeaderId());
-            auto chunkId = request.chunkid();
-            concurrentapply_->Push(chunkId, ChunkOpRequest::Schedule(request.optype()),  // NOLINT
-                                   &ChunkOpRequest::OnApplyFromLog, opReq,
-                                   dataStore_, std::move(request), data);
+            if (request.has_writeaheadcrc()) {
+                UpdateWriteAheadIndex(iter.index());
+                /**
+                 * 重启前本节点写的write ahead日志，数据在propose之前已经
+                 * 落盘，之后的日志可能又覆盖了这些数据，无法再校验
+                 */
+                if (iter.index() <= startupLogIndex_) {
+                    continue;
+                }
+            }
+            if (request.optype() == CHUNK_OP_TYPE::CHUNK_OP_BATCH_WRITE) {
+                int64_t index = iter.index();
+                BatchWriteChunkRequest::DecodeFromLog(data,
+                    [this, index](std::shared_ptr<ChunkOpRequest> subReq,
+                                  const ChunkRequest &sub,
+                                  const butil::IOBuf &subData) {
+                        ApplyFromLog(index, subReq, sub, subData);
+                    });
+                continue;
+            }
+            ApplyFromLog(iter.index(), opReq, request, data);
         }
     }
 }
@@ -353,6 +420,9 @@ void CopysetNode::save_snapshot_background(::braft::SnapshotWriter *writer,
      * 1.flush I/O to disk，确保数据都落盘
      */
     concurrentapply_->Flush();
+    if (nullptr != dataStore_) {
+        dataStore_->WaitAsyncIo();
+    }
 
     if (!enableOdsyncWhenOpenChunkFile_) {
         ForceSyncAllChunks();
@@ -530,6 +600,12 @@ void CopysetNode::on_leader_start(int64_t term) {
      */
     ChunkServerMetric::GetInstance()->IncreaseLeaderCount();
     concurrentapply_->Flush();
+    if (nullptr != dataStore_) {
+        dataStore_->WaitAsyncIo();
+    }
+    inflightRanges_.ResumeWriteAhead();
+    // 重启前的日志已经回放完
+    replayWriteAheadRanges_.clear();
     leaderTerm_.store(term, std::memory_order_release);
     LOG(INFO) << "Copyset: " << GroupIdString()
               << ", peer id: " << peerId_.to_string()
@@ -662,6 +738,14 @@ void CopysetNode::ListPeers(std::vector<Peer>* peers) {
     }
 }
 
+bool CopysetNode::WriteAheadAvailable() const {
+    if (!enableWriteAhead_) {
+        return false;
+    }
+    std::lock_guard<std::mutex> lockguard(confLock_);
+    return conf_.size() == 1 && conf_.contains(peerId_);
+}
+
 void CopysetNode::SetCSDateStore(std::shared_ptr<CSDataStore> datastore) {
     dataStore_ = datastore;
 }
@@ -767,6 +851,10 @@ butil::Status CopysetNode::AddPeer(const Peer& peer) {
             return status;
         }
     }
+    butil::Status st = CheckWriteAheadLogs();
+    if (!st.ok()) {
+        return st;
+    }
     ConfigurationChangeDone* addPeerDone =
                     new ConfigurationChangeDone(configChange_);
     ConfigurationChange expectedCfgChange(ConfigChangeType::ADD_PEER, peer);
@@ -830,6 +918,10 @@ butil::Status CopysetNode::ChangePeer(const std::vector<Peer>& newPeers) {
         st.set_error(EPERM, "only support change on peer to another");
         return st;
     }
+    st = CheckWriteAheadLogs();
+    if (!st.ok()) {
+        return st;
+    }
     ConfigurationChangeDone* changePeerDone =
                         new ConfigurationChangeDone(configChange_);
     ConfigurationChange expectedCfgChange;
@@ -843,6 +935,153 @@ butil::Status CopysetNode::ChangePeer(const std::vector<Peer>& newPeers) {
     return changePeerDone->status();
 }
 
+void CopysetNode::UpdateWriteAheadIndex(int64_t index) {
+    UpdateToMax(&lastWriteAheadIndex_, index);
+}
+
+void CopysetNode::ScanWriteAheadLogs(int64_t firstIndex) {
+    writeAheadLogsScanned_ = true;
+    if (!enableWriteAhead_ || nullptr == logStorage_) {
+        return;
+    }
+    Configuration conf;
+    {
+        std::lock_guard<std::mutex> lockguard(confLock_);
+        conf = conf_;
+    }
+    if (conf.empty()) {
+        conf = nodeOptions_.initial_conf;
+    }
+    // 多副本的复制组在配置变更前已经没有write ahead日志了
+    if (conf.size() != 1 || !conf.contains(peerId_)) {
+        return;
+    }
+
+    /**
+     * 第一条日志回放时本节点还没有当选leader，日志中都是重启前写的，
+     * 只有刚当选时的配置日志可能在之后
+     */
+    int64_t lastIndex = logStorage_->last_log_index();
+    UpdateToMax(&startupLogIndex_, lastIndex);
+    size_t count = 0;
+    for (int64_t index = firstIndex; index <= lastIndex; ++index) {
+        braft::LogEntry *entry = logStorage_->get_entry(index);
+        if (nullptr == entry) {
+            LOG(FATAL) << "Copyset: " << GroupIdString()
+                       << " failed to get log entry " << index;
+            return;
+        }
+        if (entry->type == braft::ENTRY_TYPE_DATA) {
+            ChunkRequest request;
+            butil::IOBuf data;
+            ChunkOpRequest::Decode(entry->data, &request, &data, index,
+                                   PeerId());
+            if (request.has_writeaheadcrc()) {
+                replayWriteAheadRanges_[request.chunkid()].push_back(
+                    {index, static_cast<off_t>(request.offset()),
+                     request.size()});
+                ++count;
+            }
+        }
+        entry->Release();
+    }
+    LOG(INFO) << "Copyset: " << GroupIdString()
+              << " found " << count << " write ahead log entries in ["
+              << firstIndex << ", " << lastIndex << "]";
+}
+
+void CopysetNode::ApplyFromLog(int64_t index,
+                               std::shared_ptr<ChunkOpRequest> opReq,
+                               const ChunkRequest &request,
+                               const butil::IOBuf &data) {
+    auto push = [this, &opReq](const ChunkRequest &req,
+                               const butil::IOBuf &reqData) {
+        concurrentapply_->Push(req.chunkid(),
+                               ChunkOpRequest::Schedule(req.optype()),
+                               &ChunkOpRequest::OnApplyFromLog, opReq,
+                               dataStore_, req, reqData);
+    };
+
+    auto iter = replayWriteAheadRanges_.find(request.chunkid());
+    if (iter == replayWriteAheadRanges_.end() ||
+        request.optype() != CHUNK_OP_TYPE::CHUNK_OP_WRITE ||
+        request.has_writeaheadcrc() || index > startupLogIndex_) {
+        push(request, data);
+        return;
+    }
+
+    /**
+     * 之后的write ahead日志的数据已经在重启前落盘，回放时不能被
+     * 更早的写覆盖，只写剩下的区间。write ahead的区间是按块对齐的，
+     * 裁剪后的区间仍然对齐
+     */
+    std::vector<std::pair<off_t, size_t>> pieces;
+    pieces.emplace_back(request.offset(), request.size());
+    for (const WriteAheadRange &range : iter->second) {
+        if (range.index <= index) {
+            continue;
+        }
+        off_t rangeEnd = range.offset + range.length;
+        std::vector<std::pair<off_t, size_t>> remain;
+        for (const auto &piece : pieces) {
+            off_t end = piece.first + piece.second;
+            if (end <= range.offset || piece.first >= rangeEnd) {
+                remain.push_back(piece);
+                continue;
+            }
+            if (piece.first < range.offset) {
+                remain.emplace_back(piece.first,
+                                    range.offset - piece.first);
+            }
+            if (end > rangeEnd) {
+                remain.emplace_back(rangeEnd, end - rangeEnd);
+            }
+        }
+        pieces.swap(remain);
+    }
+
+    if (pieces.size() == 1 && pieces[0].second == request.size()) {
+        push(request, data);
+        return;
+    }
+    for (const auto &piece : pieces) {
+        ChunkRequest req(request);
+        req.set_offset(piece.first);
+        req.set_size(piece.second);
+        butil::IOBuf reqData;
+        data.append_to(&reqData, piece.second,
+                       piece.first - request.offset());
+        push(req, reqData);
+    }
+}
+
+butil::Status CopysetNode::CheckWriteAheadLogs() {
+    butil::Status st;
+    if (!enableWriteAhead_) {
+        return st;
+    }
+    // 先停止write ahead，之后不会再产生不带数据的日志
+    size_t inflight = inflightRanges_.SuspendWriteAhead();
+    int64_t lastIndex = lastWriteAheadIndex_.load(std::memory_order_acquire);
+    NodeStatus status;
+    raftNode_->get_status(&status);
+    if (inflight == 0 && status.first_index > lastIndex) {
+        return st;
+    }
+    /**
+     * braft打快照时只删除上一个快照之前的日志，
+     * 因此可能要经过多次快照这些日志才会被删除
+     */
+    LOG(INFO) << "Copyset: " << GroupIdString()
+              << " has write ahead logs, inflight: " << inflight
+              << ", last write ahead index: " << lastIndex
+              << ", first log index: " << status.first_index
+              << ", trigger snapshot before changing configuration";
+    raftNode_->snapshot(nullptr);
+    st.set_error(EBUSY, "write ahead logs without data remain in log");
+    return st;
+}
+
 void CopysetNode::UpdateAppliedIndex(uint64_t index) {
     uint64_t curIndex = appliedIndex_.load(std::memory_order_acquire);
     // 只更新比自己大的 index
@@ -33,12 +33,14 @@
 #include <climits>
 #include <memory>
 #include <deque>
+#include <unordered_map>
 
 #include "src/chunkserver/concurrent_apply/concurrent_apply.h"
 #include "src/chunkserver/datastore/chunkserver_datastore.h"
 #include "src/chunkserver/conf_epoch_file.h"
 #include "src/chunkserver/config_info.h"
 #include "src/chunkserver/chunkserver_metrics.h"
+#include "src/chunkserver/inflight_chunk_ranges.h"
 #include "src/chunkserver/raftlog/curve_segment_log_storage.h"
 #include "src/chunkserver/raftsnapshot/define.h"
 #include "src/chunkserver/raftsnapshot/curve_snapshot_writer.h"
@@ -107,6 +109,7 @@ class ConfigurationChangeDone : public braft::Closure {
 };
 
 class CopysetNode;
+class ChunkOpRequest;
 
 class SyncChunkThread : public curve::common::Uncopyable {
  public:
@@ -461,6 +464,45 @@ class CopysetNode : public braft::StateMachine,
         chunkIdsToSync_.push_back(chunkId);
     }
 
+    /**
+     * 是否开启了write ahead，开启后需要登记在途请求的chunk区间
+     */
+    bool EnableWriteAhead() const {
+        return enableWriteAhead_;
+    }
+
+    /**
+     * 当前是否可以使用write ahead，要求开启了write ahead，
+     * 并且复制组只有当前一个副本
+     */
+    virtual bool WriteAheadAvailable() const;
+
+    bool EnableOdsyncWhenOpenChunkFile() const {
+        return enableOdsyncWhenOpenChunkFile_;
+    }
+
+    uint32_t WriteAheadMinSize() const {
+        return writeAheadMinSize_;
+    }
+
+    InflightChunkRanges* GetInflightChunkRanges() {
+        return &inflightRanges_;
+    }
+
+    /**
+     * 记录write ahead日志的index，这些日志中不带数据
+     * @param index: 日志的index
+     */
+    void UpdateWriteAheadIndex(int64_t index);
+
+    /**
+     * write ahead的日志中不带数据，新加入的副本回放这些日志会缺少数据，
+     * 因此配置变更前要求这些日志已经被快照从日志中删除。
+     * 不满足时停止write ahead并触发快照，返回EBUSY，由mds稍后重试
+     * @return 检查通过返回OK
+     */
+    butil::Status CheckWriteAheadLogs();
+
     void HandleSyncTimerOut();
 
     void SyncAllChunks();
@@ -478,6 +520,24 @@ class CopysetNode : public braft::StateMachine,
         return ToGroupIdString(logicPoolId_, copysetId_);
     }
 
+    /**
+     * 重启后回放第一条日志时扫描日志中的write ahead日志，记录其区间。
+     * 这些区间的数据在propose之前已经落盘，之前的写日志回放时不能
+     * 覆盖这些区间
+     * @param firstIndex: 第一条回放的日志的index
+     */
+    void ScanWriteAheadLogs(int64_t firstIndex);
+
+    /**
+     * 回放日志时把请求交给并发apply模块，重启前的写请求会裁掉
+     * 被之后的write ahead日志覆盖的区间，可能拆成多个请求或者跳过
+     * @param index: 日志的index
+     */
+    void ApplyFromLog(int64_t index,
+                      std::shared_ptr<ChunkOpRequest> opReq,
+                      const ChunkRequest &request,
+                      const butil::IOBuf &data);
+
  private:
     // 逻辑池 id
     LogicPoolID logicPoolId_;
@@ -545,6 +605,28 @@ class CopysetNode : public braft::StateMachine,
     uint32_t checkSyncingIntervalMs_;
     // async snapshot future object
     std::future<void> snapshotFuture_;
+    // write data into chunk file before propose
+    bool enableWriteAhead_ = false;
+    // min request size to use write ahead
+    uint32_t writeAheadMinSize_ = 64 * 1024;
+    // chunk ranges of inflight requests, used by write ahead
+    InflightChunkRanges inflightRanges_;
+    // index of the last write ahead log entry, which carries no data
+    std::atomic<int64_t> lastWriteAheadIndex_{0};
+    // last log index when starting, entries before it are written by
+    // this node and their data has been persisted before propose
+    std::atomic<int64_t> startupLogIndex_{0};
+    // range written ahead by a log entry before restarting
+    struct WriteAheadRange {
+        int64_t index;
+        off_t offset;
+        size_t length;
+    };
+    // write ahead ranges of each chunk found when replaying, in log order
+    std::unordered_map<ChunkID, std::vector<WriteAheadRange>>
+        replayWriteAheadRanges_;
+    // whether the log has been scanned for write ahead ranges
+    bool writeAheadLogsScanned_ = false;
 };
 
 }  // namespace chunkserver
@@ -21,16 +21,58 @@
  */
 #include <fcntl.h>
 #include <algorithm>
+#include <atomic>
 #include <memory>
+#include <utility>
 
 #include "src/chunkserver/datastore/chunkserver_datastore.h"
 #include "src/chunkserver/datastore/chunkserver_chunkfile.h"
+#include "src/common/concurrent/count_down_event.h"
 #include "src/common/crc32.h"
 #include "src/common/curve_define.h"
 
 namespace curve {
 namespace chunkserver {
 
+namespace {
+// The local filesystem may complete an async io before the submission
+// returns, e.g., ext4 does it synchronously. The callback replies the
+// request, so in that case it's deferred until the chunk lock is released.
+class DeferredIoCallback {
+ public:
+    explicit DeferredIoCallback(ChunkIoCallback cb)
+        : cb_(std::move(cb)), state_(kSubmitting),
+          result_(CSErrorCode::Success) {}
+
+    // called when the io completes
+    void Done(CSErrorCode result) {
+        result_ = result;
+        int expected = kSubmitting;
+        if (state_.compare_exchange_strong(expected, kDoneInline)) {
+            return;
+        }
+        cb_(result);
+    }
+
+    // called after the io is submitted and the chunk lock is released
+    void Submitted() {
+        int expected = kSubmitting;
+        if (!state_.compare_exchange_strong(expected, kSubmitted)) {
+            cb_(result_);
+        }
+    }
+
+ private:
+    enum { kSubmitting, kSubmitted, kDoneInline };
+
+    ChunkIoCallback cb_;
+    std::atomic<int> state_;
+    CSErrorCode result_;
+};
+}  // namespace
+
+using curve::common::CountDownEvent;
+
 ChunkFileMetaPage::ChunkFileMetaPage(const ChunkFileMetaPage& metaPage) {
     version = metaPage.version;
     sn = metaPage.sn;
@@ -313,6 +355,7 @@ CSErrorCode CSChunkFile::Write(SequenceNum sn,
                      << ",correctedSn: " << metaPage_.correctedSn;
         return CSErrorCode::BackwardRequestError;
     }
+    waitAsyncIo(offset, length, true);
     // Determine whether to create a snapshot file
     if (needCreateSnapshot(sn)) {
         // There are historical snapshots that have not been deleted
@@ -412,18 +455,59 @@ CSErrorCode CSChunkFile::Write(SequenceNum sn,
         return errorCode;
     }
 
-    if (chunkrate_.get() && cvar_.get()) {
-        *chunkrate_ += length;
-        uint64_t res = *chunkrate_;
-        // if single write size > syncThreshold, for cache friend to
-        // delay to sync.
-        auto actualSyncChunkLimits = MayUpdateWriteLimits(res);
-        if (*chunkrate_ >= actualSyncChunkLimits &&
-                chunkrate_->compare_exchange_weak(res, 0)) {
-            cvar_->notify_one();
+    notifySyncThread(length);
+    return CSErrorCode::Success;
+}
+
+void CSChunkFile::WriteAsync(SequenceNum sn,
+                             const butil::IOBuf& buf,
+                             off_t offset,
+                             size_t length,
+                             ChunkIoCallback cb) {
+    std::shared_ptr<DeferredIoCallback> deferred;
+    {
+        WriteLockGuard writeGuard(rwLock_);
+        // Clone chunk, snapshot and sequence change need to update the
+        // metapage or the snapshot file after or before writing the data,
+        // they are left to the synchronous Write
+        if (CheckOffsetAndLength(offset, length) &&
+            !isCloneChunk_ &&
+            snapshot_ == nullptr &&
+            sn == metaPage_.sn &&
+            sn >= metaPage_.correctedSn) {
+            AsyncIoIter io = beginAsyncIo(offset, length, true);
+            deferred = std::make_shared<DeferredIoCallback>(cb);
+            int rc = lfs_->WriteAsync(fd_, buf, offset + metaPageSize_, length,
+                [this, io, sn, length, deferred](int res) {
+                    endAsyncIo(io);
+                    if (res < 0) {
+                        LOG(ERROR) << "Write data to chunk file failed."
+                                   << "ChunkID: " << chunkId_
+                                   << ",request sn: " << sn
+                                   << ",error: " << res;
+                        deferred->Done(CSErrorCode::InternalError);
+                        return;
+                    }
+                    notifySyncThread(length);
+                    deferred->Done(CSErrorCode::Success);
+                });
+            if (rc < 0) {
+                endAsyncIo(io);
+                deferred = nullptr;
+                LOG(WARNING) << "Submit async write failed, "
+                             << "write synchronously."
+                             << "ChunkID: " << chunkId_
+                             << ",request sn: " << sn
+                             << ",error: " << rc;
+            }
         }
     }
-    return CSErrorCode::Success;
+    if (deferred != nullptr) {
+        deferred->Submitted();
+        return;
+    }
+    uint32_t cost;
+    cb(Write(sn, buf, offset, length, &cost));
 }
 
 CSErrorCode CSChunkFile::Sync() {
@@ -453,6 +537,7 @@ CSErrorCode CSChunkFile::Paste(const char * buf, off_t offset, size_t length) {
     if (!isCloneChunk_) {
         return CSErrorCode::Success;
     }
+    waitAsyncIo(offset, length, true);
 
     // The request above must be blocksize aligned
     // the starting block index number of the paste area
@@ -467,19 +552,13 @@ CSErrorCode CSChunkFile::Paste(const char * buf, off_t offset, size_t length) {
                              nullptr);
 
     // For the unwritten range, write the corresponding data
-    off_t pasteOff;
-    size_t pasteSize;
-    for (auto& range : uncopiedRange) {
-        pasteOff = range.beginIndex * blockSize_;
-        pasteSize = (range.endIndex - range.beginIndex + 1) * blockSize_;
-        int rc = writeData(buf + (pasteOff - offset), pasteOff, pasteSize);
-        if (rc < 0) {
-            LOG(ERROR) << "Paste data to chunk failed."
-                       << "ChunkID: " << chunkId_
-                       << ", offset: " << offset
-                       << ", length: " << length;
-            return CSErrorCode::InternalError;
-        }
+    int rc = writeDataRanges(buf, offset, uncopiedRange);
+    if (rc < 0) {
+        LOG(ERROR) << "Paste data to chunk failed."
+                   << "ChunkID: " << chunkId_
+                   << ", offset: " << offset
+                   << ", length: " << length;
+        return CSErrorCode::InternalError;
     }
 
     // Update bitmap
@@ -496,34 +575,11 @@ CSErrorCode CSChunkFile::Paste(const char * buf, off_t offset, size_t length) {
 
 CSErrorCode CSChunkFile::Read(char * buf, off_t offset, size_t length) {
     ReadLockGuard readGuard(rwLock_);
-    if (!CheckOffsetAndLength(offset, length)) {
-        LOG(ERROR) << "Read chunk failed, invalid offset or length."
-                   << "ChunkID: " << chunkId_
-                   << ", offset: " << offset
-                   << ", length: " << length
-                   << ", page size: " << metaPageSize_
-                   << ", chunk size: " << size_
-                   << ", block size: " << blockSize_;
-        return CSErrorCode::InvalidArgError;
-    }
-
-    // If it is clonechunk, ensure that the read area has been written,
-    // otherwise an error is returned
-    if (isCloneChunk_) {
-        // The request above must be blocksize aligned
-        // the starting block index number of the paste area
-        uint32_t beginIndex = offset / blockSize_;
-        // the last block index number of the paste area
-        uint32_t endIndex = (offset + length - 1) / blockSize_;
-        if (metaPage_.bitmap->NextClearBit(beginIndex, endIndex)
-            != Bitmap::NO_POS) {
-            LOG(ERROR) << "Read chunk file failed, has page never written."
-                       << "ChunkID: " << chunkId_
-                       << ", offset: " << offset
-                       << ", length: " << length;
-            return CSErrorCode::PageNerverWrittenError;
-        }
+    CSErrorCode errorCode = checkReadable(offset, length);
+    if (errorCode != CSErrorCode::Success) {
+        return errorCode;
     }
+    waitAsyncIo(offset, length, false);
 
     int rc = readData(buf, offset, length);
     if (rc < 0) {
@@ -535,6 +591,45 @@ CSErrorCode CSChunkFile::Read(char * buf, off_t offset, size_t length) {
     return CSErrorCode::Success;
 }
 
+void CSChunkFile::ReadAsync(char * buf, off_t offset, size_t length,
+                            ChunkIoCallback cb) {
+    CSErrorCode errorCode;
+    std::shared_ptr<DeferredIoCallback> deferred;
+    {
+        ReadLockGuard readGuard(rwLock_);
+        errorCode = checkReadable(offset, length);
+        if (errorCode == CSErrorCode::Success) {
+            AsyncIoIter io = beginAsyncIo(offset, length, false);
+            deferred = std::make_shared<DeferredIoCallback>(cb);
+            int rc = lfs_->ReadAsync(fd_, buf, offset + metaPageSize_, length,
+                [this, io, deferred](int res) {
+                    endAsyncIo(io);
+                    if (res < 0) {
+                        LOG(ERROR) << "Read chunk file failed."
+                                   << "ChunkID: " << chunkId_
+                                   << ",error: " << res;
+                        deferred->Done(CSErrorCode::InternalError);
+                        return;
+                    }
+                    deferred->Done(CSErrorCode::Success);
+                });
+            if (rc < 0) {
+                endAsyncIo(io);
+                deferred = nullptr;
+                LOG(ERROR) << "Submit async read failed."
+                           << "ChunkID: " << chunkId_
+                           << ",error: " << rc;
+                errorCode = CSErrorCode::InternalError;
+            }
+        }
+    }
+    if (deferred != nullptr) {
+        deferred->Submitted();
+        return;
+    }
+    cb(errorCode);
+}
+
 CSErrorCode CSChunkFile::ReadMetaPage(char * buf) {
     ReadLockGuard readGuard(rwLock_);
     int rc = readMetaPage(buf);
@@ -562,6 +657,7 @@ CSErrorCode CSChunkFile::ReadSpecifiedChunk(SequenceNum sn,
                    << ", block size: " << blockSize_;
         return CSErrorCode::InvalidArgError;
     }
+    waitAsyncIo(offset, length, false);
     // If the sequence equals the sequence of the current chunk,
     // read the current chunk file
     if (sn == metaPage_.sn) {
@@ -605,18 +701,12 @@ CSErrorCode CSChunkFile::ReadSpecifiedChunk(SequenceNum sn,
     off_t readOff;
     size_t readSize;
     // For uncopied extents, read chunk data
-    for (auto& range : uncopiedRange) {
-        readOff = range.beginIndex * blockSize_;
-        readSize = (range.endIndex - range.beginIndex + 1) * blockSize_;
-        int rc = readData(buf + (readOff - offset),
-                          readOff,
-                          readSize);
-        if (rc < 0) {
-            LOG(ERROR) << "Read chunk file failed. "
-                       << "ChunkID: " << chunkId_
-                       << ", chunk sn: " << metaPage_.sn;
-            return CSErrorCode::InternalError;
-        }
+    int rc = readDataRanges(buf, offset, uncopiedRange);
+    if (rc < 0) {
+        LOG(ERROR) << "Read chunk file failed. "
+                   << "ChunkID: " << chunkId_
+                   << ", chunk sn: " << metaPage_.sn;
+        return CSErrorCode::InternalError;
     }
     // For the copied range, read the snapshot data
     for (auto& range : copiedRange) {
@@ -645,6 +735,8 @@ CSErrorCode CSChunkFile::Delete(SequenceNum sn)  {
                      << ", chunk sn: " << metaPage_.sn;
         return CSErrorCode::BackwardRequestError;
     }
+    // The fd is closed below
+    waitAsyncIo(0, size_, true);
 
     // If there is a snapshot, delete the snapshot first,
     // normally there will be no such situation
@@ -999,5 +1091,159 @@ CSErrorCode CSChunkFile::flush() {
     return CSErrorCode::Success;
 }
 
+CSErrorCode CSChunkFile::checkReadable(off_t offset, size_t length) {
+    if (!CheckOffsetAndLength(offset, length)) {
+        LOG(ERROR) << "Read chunk failed, invalid offset or length."
+                   << "ChunkID: " << chunkId_
+                   << ", offset: " << offset
+                   << ", length: " << length
+                   << ", page size: " << metaPageSize_
+                   << ", chunk size: " << size_
+                   << ", block size: " << blockSize_;
+        return CSErrorCode::InvalidArgError;
+    }
+
+    // If it is clonechunk, ensure that the read area has been written,
+    // otherwise an error is returned
+    if (isCloneChunk_) {
+        // The request above must be blocksize aligned
+        // the starting block index number of the paste area
+        uint32_t beginIndex = offset / blockSize_;
+        // the last block index number of the paste area
+        uint32_t endIndex = (offset + length - 1) / blockSize_;
+        if (metaPage_.bitmap->NextClearBit(beginIndex, endIndex)
+            != Bitmap::NO_POS) {
+            LOG(ERROR) << "Read chunk file failed, has page never written."
+                       << "ChunkID: " << chunkId_
+                       << ", offset: " << offset
+                       << ", length: " << length;
+            return CSErrorCode::PageNerverWrittenError;
+        }
+    }
+    return CSErrorCode::Success;
+}
+
+void CSChunkFile::notifySyncThread(size_t length) {
+    if (chunkrate_.get() && cvar_.get()) {
+        *chunkrate_ += length;
+        uint64_t res = *chunkrate_;
+        // if single write size > syncThreshold, for cache friend to
+        // delay to sync.
+        auto actualSyncChunkLimits = MayUpdateWriteLimits(res);
+        if (*chunkrate_ >= actualSyncChunkLimits &&
+                chunkrate_->compare_exchange_weak(res, 0)) {
+            cvar_->notify_one();
+        }
+    }
+}
+
+bool CSChunkFile::conflictAsyncIo(off_t offset, size_t length,
+                                  bool isWrite) {
+    for (const AsyncIoRange& io : asyncIos_) {
+        if ((isWrite || io.isWrite) &&
+            io.offset < static_cast<off_t>(offset + length) &&
+            offset < static_cast<off_t>(io.offset + io.length)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void CSChunkFile::waitAsyncIo(off_t offset, size_t length, bool isWrite) {
+    std::unique_lock<std::mutex> lk(asyncIoMutex_);
+    asyncIoCond_.wait(lk, [&] {
+        return !conflictAsyncIo(offset, length, isWrite);
+    });
+}
+
+CSChunkFile::AsyncIoIter CSChunkFile::beginAsyncIo(off_t offset,
+                                                   size_t length,
+                                                   bool isWrite) {
+    std::unique_lock<std::mutex> lk(asyncIoMutex_);
+    asyncIoCond_.wait(lk, [&] {
+        return !conflictAsyncIo(offset, length, isWrite);
+    });
+    return asyncIos_.insert(asyncIos_.end(),
+                            AsyncIoRange{offset, length, isWrite});
+}
+
+void CSChunkFile::endAsyncIo(AsyncIoIter io) {
+    {
+        std::lock_guard<std::mutex> lk(asyncIoMutex_);
+        asyncIos_.erase(io);
+    }
+    asyncIoCond_.notify_all();
+}
+
+int CSChunkFile::readDataRanges(char* buf, off_t offset,
+                                const std::vector<BitRange>& ranges) {
+    if (ranges.size() == 1) {
+        off_t readOff = ranges[0].beginIndex * blockSize_;
+        size_t readSize =
+            (ranges[0].endIndex - ranges[0].beginIndex + 1) * blockSize_;
+        int rc = readData(buf + (readOff - offset), readOff, readSize);
+        return rc < 0 ? rc : 0;
+    }
+    CountDownEvent event(ranges.size());
+    std::atomic<int> result(0);
+    for (auto& range : ranges) {
+        off_t readOff = range.beginIndex * blockSize_;
+        size_t readSize = (range.endIndex - range.beginIndex + 1) * blockSize_;
+        int rc = lfs_->ReadAsync(fd_, buf + (readOff - offset),
+                                 readOff + metaPageSize_, readSize,
+                                 [&event, &result](int res) {
+                                     if (res < 0) {
+                                         result.store(res);
+                                     }
+                                     event.Signal();
+                                 });
+        if (rc < 0) {
+            result.store(rc);
+            event.Signal();
+        }
+    }
+    event.Wait();
+    return result.load();
+}
+
+int CSChunkFile::writeDataRanges(const char* buf, off_t offset,
+                                 const std::vector<BitRange>& ranges) {
+    if (ranges.size() == 1) {
+        off_t writeOff = ranges[0].beginIndex * blockSize_;
+        size_t writeSize =
+            (ranges[0].endIndex - ranges[0].beginIndex + 1) * blockSize_;
+        int rc = writeData(buf + (writeOff - offset), writeOff, writeSize);
+        return rc < 0 ? rc : 0;
+    }
+    CountDownEvent event(ranges.size());
+    std::atomic<int> result(0);
+    for (auto& range : ranges) {
+        off_t writeOff = range.beginIndex * blockSize_;
+        size_t writeSize =
+            (range.endIndex - range.beginIndex + 1) * blockSize_;
+        int rc = lfs_->WriteAsync(fd_, buf + (writeOff - offset),
+                                  writeOff + metaPageSize_, writeSize,
+                                  [&event, &result](int res) {
+                                      if (res < 0) {
+                                          result.store(res);
+                                      }
+                                      event.Signal();
+                                  });
+        if (rc < 0) {
+            result.store(rc);
+            event.Signal();
+        }
+    }
+    event.Wait();
+    if (result.load() < 0) {
+        return result.load();
+    }
+    for (auto& range : ranges) {
+        markDirtyPages(range.beginIndex * blockSize_,
+                       (range.endIndex - range.beginIndex + 1) * blockSize_);
+    }
+    return 0;
+}
+
 }  // namespace chunkserver
 }  // namespace curve
@@ -30,6 +30,8 @@
 #include <atomic>
 #include <functional>
 #include <memory>
+#include <list>
+#include <mutex>  // NOLINT
 #include <condition_variable>
 
 #include "include/curve_compiler_specific.h"
@@ -58,6 +60,12 @@ class FilePool;
 class CSSnapshot;
 struct DataStoreMetric;
 
+/**
+ * Callback of the asynchronous read/write of chunk file
+ * @param errorCode: the result of the request
+ */
+using ChunkIoCallback = std::function<void(CSErrorCode errorCode)>;
+
 /**
  * Chunkfile Metapage Format
  * version: 1 byte
@@ -173,6 +181,22 @@ class CSChunkFile {
                       size_t length,
                       uint32_t* cost);
 
+    /**
+     * Write chunk files asynchronously
+     * The data of a normal chunk whose sequence number is unchanged is
+     * submitted by the asynchronous interface of lfs, and cb is called
+     * when the io completes. Writes which need to create snapshot, cow or
+     * update metapage run Write synchronously and call cb before return.
+     * @param buf: data requested to be written, must be valid until cb
+     * @param cb: called with the result when the write completes
+     * other params see Write
+     */
+    void WriteAsync(SequenceNum sn,
+                    const butil::IOBuf& buf,
+                    off_t offset,
+                    size_t length,
+                    ChunkIoCallback cb);
+
     CSErrorCode Sync();
 
     /**
@@ -195,6 +219,17 @@ class CSChunkFile {
      * @return: return error code
      */
     CSErrorCode Read(char * buf, off_t offset, size_t length);
+    /**
+     * Read chunk files asynchronously
+     * The read is submitted by the asynchronous interface of lfs and cb is
+     * called when the io completes, cb is called before return if the
+     * request is invalid
+     * @param buf: the data read, must be valid until cb
+     * @param cb: called with the result when the read completes
+     * other params see Read
+     */
+    void ReadAsync(char * buf, off_t offset, size_t length,
+                   ChunkIoCallback cb);
 
     /**
      * Read chunk meta data
@@ -316,6 +351,43 @@ class CSChunkFile {
      * to a normal chunk
      */
     CSErrorCode flush();
+    /**
+     * Check whether the area can be read
+     * @param offset: the starting offset of the data requested to be read
+     * @param length: The length of the data requested to be read
+     * @return: return error code
+     */
+    CSErrorCode checkReadable(off_t offset, size_t length);
+    /**
+     * Account the written length and wake up the sync thread if needed
+     * @param length: the length of the data written
+     */
+    void notifySyncThread(size_t length);
+
+    // area of the chunk which an async io submitted to lfs works on
+    struct AsyncIoRange {
+        off_t offset;
+        size_t length;
+        bool isWrite;
+    };
+    using AsyncIoIter = std::list<AsyncIoRange>::iterator;
+    /**
+     * Wait until no submitted async io conflicts with the area. io does
+     * not keep order once submitted, so an area can't be written while it
+     * is being read or written by an async io, and vice versa
+     * @param offset: the starting offset of the area
+     * @param length: the length of the area
+     * @param isWrite: whether the area is going to be written
+     */
+    void waitAsyncIo(off_t offset, size_t length, bool isWrite);
+    // whether asyncIos_ conflicts with the area, asyncIoMutex_ must be held
+    bool conflictAsyncIo(off_t offset, size_t length, bool isWrite);
+    /**
+     * Wait for the conflicting async io and record the new one
+     * @return: the record, which must be passed to endAsyncIo
+     */
+    AsyncIoIter beginAsyncIo(off_t offset, size_t length, bool isWrite);
+    void endAsyncIo(AsyncIoIter io);
 
     inline string path() {
         return baseDir_ + "/" +
@@ -343,18 +415,7 @@ class CSChunkFile {
         if (rc < 0) {
             return rc;
         }
-        // If it is a clone chunk, you need to determine whether you need to
-        // change the bitmap and update the metapage
-        if (isCloneChunk_) {
-            uint32_t beginIndex = offset / blockSize_;
-            uint32_t endIndex = (offset + length - 1) / blockSize_;
-            for (uint32_t i = beginIndex; i <= endIndex; ++i) {
-                // record dirty page
-                if (!metaPage_.bitmap->Test(i)) {
-                    dirtyPages_.insert(i);
-                }
-            }
-        }
+        markDirtyPages(offset, length);
         return rc;
     }
 
@@ -363,9 +424,13 @@ class CSChunkFile {
         if (rc < 0) {
             return rc;
         }
-        // If it is a clone chunk, you need to determine whether you need to
-        // change the bitmap and update the metapage
-        // page size to alignment
+        markDirtyPages(offset, length);
+        return rc;
+    }
+
+    // If it is a clone chunk, you need to determine whether you need to
+    // change the bitmap and update the metapage
+    inline void markDirtyPages(off_t offset, size_t length) {
         if (isCloneChunk_) {
             uint32_t beginIndex = offset / blockSize_;
             uint32_t endIndex = (offset + length - 1) / blockSize_;
@@ -376,9 +441,26 @@ class CSChunkFile {
                 }
             }
         }
-        return rc;
     }
 
+    /**
+     * Read several block ranges of the chunk, all the ranges are submitted
+     * by the asynchronous interface of lfs before waiting, so they can be
+     * in flight together when lfs is backed by io_uring
+     * @param buf: buffer of the whole request which starts at offset
+     * @param offset: the starting offset of the whole request
+     * @param ranges: block ranges to read, must be within the request
+     * @return: return 0 on success, otherwise return -errno
+     */
+    int readDataRanges(char* buf, off_t offset,
+                       const std::vector<BitRange>& ranges);
+    /**
+     * Write several block ranges of the chunk asynchronously, see
+     * readDataRanges
+     */
+    int writeDataRanges(const char* buf, off_t offset,
+                        const std::vector<BitRange>& ranges);
+
     inline int SyncData() {
         return lfs_->Sync(fd_);
     }
@@ -424,6 +506,10 @@ class CSChunkFile {
     std::set<uint32_t> dirtyPages_;
     // read-write lock
     RWLock rwLock_;
+    // async io submitted to lfs but not completed yet
+    std::list<AsyncIoRange> asyncIos_;
+    std::mutex asyncIoMutex_;
+    std::condition_variable asyncIoCond_;
     // Snapshot file pointer
     CSSnapshot* snapshot_;
     // Rely on FilePool to create and delete files
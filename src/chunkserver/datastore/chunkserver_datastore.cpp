@@ -163,6 +163,30 @@ CSErrorCode CSDataStore::ReadChunk(ChunkID id,
     return CSErrorCode::Success;
 }
 
+void CSDataStore::ReadChunkAsync(ChunkID id,
+                                 SequenceNum sn,
+                                 char * buf,
+                                 off_t offset,
+                                 size_t length,
+                                 ChunkIoCallback cb) {
+    (void)sn;
+    auto chunkFile = metaCache_.Get(id);
+    if (chunkFile == nullptr) {
+        cb(CSErrorCode::ChunkNotExistError);
+        return;
+    }
+
+    // chunkFile is held until the read completes
+    ChunkIoCallback done = TrackAsyncIo(cb);
+    chunkFile->ReadAsync(buf, offset, length,
+        [id, chunkFile, done](CSErrorCode errorCode) {
+            LOG_IF(WARNING, errorCode != CSErrorCode::Success)
+                << "Read chunk file failed."
+                << "ChunkID = " << id;
+            done(errorCode);
+        });
+}
+
 CSErrorCode CSDataStore::ReadChunkMetaPage(ChunkID id, SequenceNum sn,
                                            char * buf) {
     (void)sn;
@@ -228,13 +252,9 @@ CSErrorCode CSDataStore::CreateChunkFile(const ChunkOptions & options,
 }
 
 
-CSErrorCode CSDataStore::WriteChunk(ChunkID id,
-                            SequenceNum sn,
-                            const butil::IOBuf& buf,
-                            off_t offset,
-                            size_t length,
-                            uint32_t* cost,
-                            const std::string & cloneSourceLocation)  {
+CSErrorCode CSDataStore::GetOrCreateChunkFile(
+    ChunkID id, SequenceNum sn, const std::string& cloneSourceLocation,
+    CSChunkFilePtr* chunkFile) {
     // The requested sequence number is not allowed to be 0, when snapsn=0,
     // it will be used as the basis for judging that the snapshot does not exist
     if (sn == kInvalidSeq) {
@@ -242,9 +262,9 @@ CSErrorCode CSDataStore::WriteChunk(ChunkID id,
                    << "ChunkID = " << id;
         return CSErrorCode::InvalidArgError;
     }
-    auto chunkFile = metaCache_.Get(id);
+    *chunkFile = metaCache_.Get(id);
     // If the chunk file does not exist, create the chunk file first
-    if (chunkFile == nullptr) {
+    if (*chunkFile == nullptr) {
         ChunkOptions options;
         options.id = id;
         options.sn = sn;
@@ -255,17 +275,30 @@ CSErrorCode CSDataStore::WriteChunk(ChunkID id,
         options.metaPageSize = metaPageSize_;
         options.metric = metric_;
         options.enableOdsyncWhenOpenChunkFile = enableOdsyncWhenOpenChunkFile_;
-        CSErrorCode errorCode = CreateChunkFile(options, &chunkFile);
-        if (errorCode != CSErrorCode::Success) {
-            return errorCode;
-        }
+        return CreateChunkFile(options, chunkFile);
+    }
+    return CSErrorCode::Success;
+}
+
+CSErrorCode CSDataStore::WriteChunk(ChunkID id,
+                            SequenceNum sn,
+                            const butil::IOBuf& buf,
+                            off_t offset,
+                            size_t length,
+                            uint32_t* cost,
+                            const std::string & cloneSourceLocation)  {
+    CSChunkFilePtr chunkFile;
+    CSErrorCode errorCode =
+        GetOrCreateChunkFile(id, sn, cloneSourceLocation, &chunkFile);
+    if (errorCode != CSErrorCode::Success) {
+        return errorCode;
     }
     // write chunk file
-    CSErrorCode errorCode = chunkFile->Write(sn,
-                                             buf,
-                                             offset,
-                                             length,
-                                             cost);
+    errorCode = chunkFile->Write(sn,
+                                 buf,
+                                 offset,
+                                 length,
+                                 cost);
     if (errorCode != CSErrorCode::Success) {
         LOG(WARNING) << "Write chunk file failed."
                      << "ChunkID = " << id;
@@ -274,6 +307,52 @@ CSErrorCode CSDataStore::WriteChunk(ChunkID id,
     return CSErrorCode::Success;
 }
 
+void CSDataStore::WriteChunkAsync(ChunkID id,
+                                  SequenceNum sn,
+                                  const butil::IOBuf& buf,
+                                  off_t offset,
+                                  size_t length,
+                                  const std::string& cloneSourceLocation,
+                                  ChunkIoCallback cb) {
+    CSChunkFilePtr chunkFile;
+    CSErrorCode errorCode =
+        GetOrCreateChunkFile(id, sn, cloneSourceLocation, &chunkFile);
+    if (errorCode != CSErrorCode::Success) {
+        cb(errorCode);
+        return;
+    }
+
+    // chunkFile is held until the write completes
+    ChunkIoCallback done = TrackAsyncIo(cb);
+    chunkFile->WriteAsync(sn, buf, offset, length,
+        [id, chunkFile, done](CSErrorCode errorCode) {
+            LOG_IF(WARNING, errorCode != CSErrorCode::Success)
+                << "Write chunk file failed."
+                << "ChunkID = " << id;
+            done(errorCode);
+        });
+}
+
+void CSDataStore::WaitAsyncIo() {
+    std::unique_lock<std::mutex> lk(asyncIoMutex_);
+    asyncIoCond_.wait(lk, [this] { return asyncIoCount_ == 0; });
+}
+
+ChunkIoCallback CSDataStore::TrackAsyncIo(ChunkIoCallback cb) {
+    {
+        std::lock_guard<std::mutex> lk(asyncIoMutex_);
+        ++asyncIoCount_;
+    }
+    return [this, cb](CSErrorCode errorCode) {
+        cb(errorCode);
+        {
+            std::lock_guard<std::mutex> lk(asyncIoMutex_);
+            --asyncIoCount_;
+        }
+        asyncIoCond_.notify_all();
+    };
+}
+
 CSErrorCode CSDataStore::SyncChunk(ChunkID id) {
     auto chunkFile = metaCache_.Get(id);
     if (chunkFile == nullptr) {
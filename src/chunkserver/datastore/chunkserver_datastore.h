@@ -30,6 +30,7 @@
 #include <vector>
 #include <unordered_map>
 #include <memory>
+#include <mutex>  // NOLINT
 #include <condition_variable>
 
 #include "include/curve_compiler_specific.h"
@@ -205,6 +206,19 @@ class CSDataStore {
                                   char * buf,
                                   off_t offset,
                                   size_t length);
+    /**
+     * Read the data of the current chunk asynchronously
+     * @param buf: the content of the data read, must be valid until cb
+     * @param cb: called with the result when the read completes, may be
+     *            called before return
+     * other params see ReadChunk
+     */
+    virtual void ReadChunkAsync(ChunkID id,
+                                SequenceNum sn,
+                                char * buf,
+                                off_t offset,
+                                size_t length,
+                                ChunkIoCallback cb);
 
     /**
      * Read the metadata of the current chunk
@@ -255,6 +269,28 @@ class CSDataStore {
                                 const std::string & cloneSourceLocation = "");
 
 
+    /**
+     * Write data asynchronously
+     * @param buf: the content of the data to be written, must be valid
+     *             until cb
+     * @param cb: called with the result when the write completes, may be
+     *            called before return
+     * other params see WriteChunk
+     */
+    virtual void WriteChunkAsync(ChunkID id,
+                                 SequenceNum sn,
+                                 const butil::IOBuf& buf,
+                                 off_t offset,
+                                 size_t length,
+                                 const std::string& cloneSourceLocation,
+                                 ChunkIoCallback cb);
+
+    /**
+     * Wait until all the requests of ReadChunkAsync/WriteChunkAsync are
+     * completed
+     */
+    void WaitAsyncIo();
+
     virtual CSErrorCode SyncChunk(ChunkID id);
 
 
@@ -340,6 +376,13 @@ class CSDataStore {
     CSErrorCode loadChunkFile(ChunkID id);
     CSErrorCode CreateChunkFile(const ChunkOptions & ops,
                                 CSChunkFilePtr* chunkFile);
+    // Get the chunk file of a write request, create it if not exist
+    CSErrorCode GetOrCreateChunkFile(ChunkID id,
+                                     SequenceNum sn,
+                                     const std::string& cloneSourceLocation,
+                                     CSChunkFilePtr* chunkFile);
+    // Wrap cb to count the async request until it completes
+    ChunkIoCallback TrackAsyncIo(ChunkIoCallback cb);
 
  private:
     // The size of each chunk
@@ -362,6 +405,10 @@ class CSDataStore {
     DataStoreMetricPtr metric_;
     // enable O_DSYNC When Open ChunkFile
     bool enableOdsyncWhenOpenChunkFile_;
+    // number of async requests which are not completed
+    uint64_t asyncIoCount_ = 0;
+    std::mutex asyncIoMutex_;
+    std::condition_variable asyncIoCond_;
 };
 
 }  // namespace chunkserver
@@ -0,0 +1,131 @@
+/*
+ *  Copyright (c) 2023 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include "src/chunkserver/inflight_chunk_ranges.h"
+
+namespace curve {
+namespace chunkserver {
+
+const uint64_t InflightChunkRanges::kWholeChunk;
+
+uint64_t InflightChunkRanges::Begin(ChunkID id, uint64_t offset,
+                                    uint64_t length, bool tryWriteAhead,
+                                    bool* writeAhead) {
+    std::unique_lock<std::mutex> lk(mtx_);
+    // 与pending的write ahead重叠时需要等它propose之后再继续，
+    // 否则当前请求在日志中会排到它的前面
+    bool waitPending = true;
+    while (waitPending) {
+        waitPending = false;
+        auto iter = ranges_.find(id);
+        if (iter == ranges_.end()) {
+            break;
+        }
+        for (const auto& range : iter->second) {
+            if (range.pending && Overlap(range, offset, length)) {
+                waitPending = true;
+                break;
+            }
+        }
+        if (waitPending) {
+            cond_.wait(lk);
+        }
+    }
+
+    auto& chunkRanges = ranges_[id];
+    bool overlap = false;
+    for (const auto& range : chunkRanges) {
+        if (Overlap(range, offset, length)) {
+            overlap = true;
+            break;
+        }
+    }
+
+    Range range;
+    range.token = nextToken_++;
+    range.offset = offset;
+    range.length = length;
+    range.pending = tryWriteAhead && !overlap && !writeAheadSuspended_;
+    range.writeAhead = range.pending;
+    if (range.writeAhead) {
+        ++writeAheadCount_;
+    }
+    chunkRanges.push_back(range);
+    if (writeAhead != nullptr) {
+        *writeAhead = range.pending;
+    }
+    return range.token;
+}
+
+void InflightChunkRanges::Proposed(ChunkID id, uint64_t token) {
+    std::lock_guard<std::mutex> lk(mtx_);
+    auto iter = ranges_.find(id);
+    if (iter == ranges_.end()) {
+        return;
+    }
+    for (auto& range : iter->second) {
+        if (range.token == token) {
+            range.pending = false;
+            break;
+        }
+    }
+    cond_.notify_all();
+}
+
+void InflightChunkRanges::End(ChunkID id, uint64_t token) {
+    std::lock_guard<std::mutex> lk(mtx_);
+    auto iter = ranges_.find(id);
+    if (iter == ranges_.end()) {
+        return;
+    }
+    auto& chunkRanges = iter->second;
+    for (auto it = chunkRanges.begin(); it != chunkRanges.end(); ++it) {
+        if (it->token == token) {
+            if (it->writeAhead) {
+                --writeAheadCount_;
+            }
+            chunkRanges.erase(it);
+            break;
+        }
+    }
+    if (chunkRanges.empty()) {
+        ranges_.erase(iter);
+    }
+    cond_.notify_all();
+}
+
+size_t InflightChunkRanges::Size() {
+    std::lock_guard<std::mutex> lk(mtx_);
+    size_t size = 0;
+    for (const auto& item : ranges_) {
+        size += item.second.size();
+    }
+    return size;
+}
+
+size_t InflightChunkRanges::SuspendWriteAhead() {
+    std::lock_guard<std::mutex> lk(mtx_);
+    writeAheadSuspended_ = true;
+    return writeAheadCount_;
+}
+
+void InflightChunkRanges::ResumeWriteAhead() {
+    std::lock_guard<std::mutex> lk(mtx_);
+    writeAheadSuspended_ = false;
+}
+
+}  // namespace chunkserver
+}  // namespace curve
@@ -0,0 +1,118 @@
+/*
+ *  Copyright (c) 2023 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#ifndef SRC_CHUNKSERVER_INFLIGHT_CHUNK_RANGES_H_
+#define SRC_CHUNKSERVER_INFLIGHT_CHUNK_RANGES_H_
+
+#include <condition_variable>  // NOLINT
+#include <cstdint>
+#include <list>
+#include <mutex>  // NOLINT
+#include <unordered_map>
+
+#include "include/chunkserver/chunkserver_common.h"
+
+namespace curve {
+namespace chunkserver {
+
+/**
+ * 记录leader上已经propose但还没有执行完的请求所涉及的chunk区间，
+ * 供write ahead(数据先写chunk文件，日志里只记引用)判断是否安全:
+ * 只有和所有在途请求都不重叠的写才能提前落盘，否则日志中更早的请求
+ * 后apply时会覆盖提前写入的数据。
+ * write ahead的请求从Begin到Proposed之间处于pending状态，此时与之
+ * 重叠的新请求会在Begin中等待，保证它们在日志中排在write ahead之后。
+ */
+class InflightChunkRanges {
+ public:
+    // 覆盖整个chunk的长度，用于非读写请求
+    static const uint64_t kWholeChunk = UINT64_MAX;
+
+    InflightChunkRanges()
+        : nextToken_(1), writeAheadSuspended_(false), writeAheadCount_(0) {}
+
+    /**
+     * 登记一个在途请求
+     * @param id: chunk id
+     * @param offset: 请求起始偏移
+     * @param length: 请求长度，kWholeChunk表示整个chunk
+     * @param tryWriteAhead: 是否尝试以write ahead方式执行
+     * @param[out] writeAhead: 可以write ahead时为true，
+     *             此时请求处于pending状态，propose后需调用Proposed
+     * @return 登记的token，用于Proposed/End
+     */
+    uint64_t Begin(ChunkID id, uint64_t offset, uint64_t length,
+                   bool tryWriteAhead, bool* writeAhead);
+
+    /**
+     * write ahead请求已经propose，解除pending状态
+     */
+    void Proposed(ChunkID id, uint64_t token);
+
+    /**
+     * 请求结束(apply完成或者失败)，移除登记
+     */
+    void End(ChunkID id, uint64_t token);
+
+    /**
+     * 在途请求数量，用于测试
+     */
+    size_t Size();
+
+    /**
+     * 停止write ahead，之后Begin不再返回可以write ahead
+     * @return 还没有结束的write ahead请求数量
+     */
+    size_t SuspendWriteAhead();
+
+    /**
+     * 恢复write ahead
+     */
+    void ResumeWriteAhead();
+
+ private:
+    struct Range {
+        uint64_t token;
+        uint64_t offset;
+        uint64_t length;
+        bool pending;
+        // 以write ahead方式执行，结束之前一直计数
+        bool writeAhead;
+    };
+
+    static uint64_t RangeEnd(uint64_t offset, uint64_t length) {
+        return length > UINT64_MAX - offset ? UINT64_MAX : offset + length;
+    }
+
+    static bool Overlap(const Range& range, uint64_t offset,
+                        uint64_t length) {
+        return offset < RangeEnd(range.offset, range.length) &&
+               range.offset < RangeEnd(offset, length);
+    }
+
+ private:
+    std::mutex mtx_;
+    std::condition_variable cond_;
+    uint64_t nextToken_;
+    bool writeAheadSuspended_;
+    size_t writeAheadCount_;
+    std::unordered_map<ChunkID, std::list<Range>> ranges_;
+};
+
+}  // namespace chunkserver
+}  // namespace curve
+
+#endif  // SRC_CHUNKSERVER_INFLIGHT_CHUNK_RANGES_H_
@@ -28,6 +28,7 @@
 #include <brpc/closure_guard.h>
 
 #include <algorithm>
+#include <atomic>
 #include <memory>
 #include <string>
 
@@ -35,6 +36,8 @@
 #include "src/chunkserver/chunk_closure.h"
 #include "src/chunkserver/clone_manager.h"
 #include "src/chunkserver/clone_task.h"
+#include "src/chunkserver/read_buffer_pool.h"
+#include "src/common/crc32.h"
 
 namespace curve {
 namespace chunkserver {
@@ -45,7 +48,9 @@ ChunkOpRequest::ChunkOpRequest() :
     cntl_(nullptr),
     request_(nullptr),
     response_(nullptr),
-    done_(nullptr) {
+    done_(nullptr),
+    inflightToken_(0),
+    inflightChunkId_(0) {
 }
 
 ChunkOpRequest::ChunkOpRequest(std::shared_ptr<CopysetNode> nodePtr,
@@ -58,7 +63,15 @@ ChunkOpRequest::ChunkOpRequest(std::shared_ptr<CopysetNode> nodePtr,
     cntl_(dynamic_cast<brpc::Controller *>(cntl)),
     request_(request),
     response_(response),
-    done_(done) {
+    done_(done),
+    inflightToken_(0),
+    inflightChunkId_(0) {
+}
+
+ChunkOpRequest::~ChunkOpRequest() {
+    if (inflightToken_ != 0) {
+        node_->GetInflightChunkRanges()->End(inflightChunkId_, inflightToken_);
+    }
 }
 
 void ChunkOpRequest::Process() {
@@ -80,8 +93,36 @@ void ChunkOpRequest::Process() {
     }
 }
 
+bool ChunkOpRequest::TrackInflight(const ChunkRequest *request,
+                                   bool tryWriteAhead) {
+    uint64_t offset = 0;
+    uint64_t length = InflightChunkRanges::kWholeChunk;
+    switch (request->optype()) {
+        case CHUNK_OP_TYPE::CHUNK_OP_READ:
+        case CHUNK_OP_TYPE::CHUNK_OP_RECOVER:
+        case CHUNK_OP_TYPE::CHUNK_OP_WRITE:
+        case CHUNK_OP_TYPE::CHUNK_OP_PASTE:
+            offset = request->offset();
+            length = request->size();
+            break;
+        default:
+            break;
+    }
+
+    bool writeAhead = false;
+    inflightChunkId_ = request->chunkid();
+    inflightToken_ = node_->GetInflightChunkRanges()->Begin(
+        inflightChunkId_, offset, length, tryWriteAhead, &writeAhead);
+    return writeAhead;
+}
+
 int ChunkOpRequest::Propose(const ChunkRequest *request,
                             const butil::IOBuf *data) {
+    // write ahead的请求需要知道更早的在途请求，所以开启后所有请求都要登记
+    if (node_->EnableWriteAhead() && inflightToken_ == 0) {
+        TrackInflight(request, false);
+    }
+
     // 打包op request为task
     braft::Task task;
     butil::IOBuf log;
@@ -171,6 +212,8 @@ std::shared_ptr<ChunkOpRequest> ChunkOpRequest::Decode(butil::IOBuf log,
             return std::make_shared<CreateCloneChunkRequest>();
         case CHUNK_OP_TYPE::CHUNK_OP_SCAN:
             return std::make_shared<ScanChunkRequest>(index, leaderId);
+        case CHUNK_OP_TYPE::CHUNK_OP_BATCH_WRITE:
+            return std::make_shared<BatchWriteChunkRequest>();
         default:LOG(ERROR) << "Unknown chunk op";
             return nullptr;
     }
@@ -246,6 +289,20 @@ ReadChunkRequest::ReadChunkRequest(std::shared_ptr<CopysetNode> nodePtr,
                                    ::google::protobuf::Closure *done) :
     ChunkOpRequest(nodePtr, cntl, request, response, done),
     cloneMgr_(cloneMgr),
+    responseData_(cntl_ != nullptr ? &cntl_->response_attachment() : nullptr),
+    concurrentApplyModule_(nodePtr->GetConcurrentApplyModule()),
+    applyIndex(0) {
+}
+
+ReadChunkRequest::ReadChunkRequest(std::shared_ptr<CopysetNode> nodePtr,
+                                   CloneManager* cloneMgr,
+                                   const ChunkRequest *request,
+                                   ChunkResponse *response,
+                                   butil::IOBuf *responseData,
+                                   ::google::protobuf::Closure *done) :
+    ChunkOpRequest(nodePtr, nullptr, request, response, done),
+    cloneMgr_(cloneMgr),
+    responseData_(responseData),
     concurrentApplyModule_(nodePtr->GetConcurrentApplyModule()),
     applyIndex(0) {
 }
@@ -343,9 +400,10 @@ void ReadChunkRequest::OnApply(uint64_t index,
             // 如果请求成功转发给了clone manager就可以直接返回了
             return;
         }
-        // 如果是ReadChunk请求还需要从本地读取数据
+        // 如果是ReadChunk请求还需要从本地读取数据，读完成后再返回
         if (request_->optype() == CHUNK_OP_TYPE::CHUNK_OP_READ) {
-            ReadChunk();
+            ReadChunk(index, done);
+            return;
         }
         // 如果是recover请求，说明请求区域已经被写过了，可以直接返回成功
         if (request_->optype() == CHUNK_OP_TYPE::CHUNK_OP_RECOVER) {
@@ -388,28 +446,40 @@ bool ReadChunkRequest::NeedClone(const CSChunkInfo& chunkInfo) {
     return false;
 }
 
-static void ReadBufferDeleter(void* ptr) {
-    delete[] static_cast<char*>(ptr);
-}
-
-void ReadChunkRequest::ReadChunk() {
-    char *readBuffer = nullptr;
+void ReadChunkRequest::ReadChunk(uint64_t index,
+                                 ::google::protobuf::Closure *done) {
     size_t size = request_->size();
 
-    readBuffer = new(std::nothrow)char[size];
-    CHECK(nullptr != readBuffer)
-        << "new readBuffer failed " << strerror(errno);
+    // buffer来自池子，随response发送完成后由deleter归还
+    ReadBufferPool::Deleter deleter = nullptr;
+    char *readBuffer = ReadBufferPool::GetInstance()->Alloc(size, &deleter);
+
+    auto thisPtr =
+        std::dynamic_pointer_cast<ReadChunkRequest>(shared_from_this());
+    datastore_->ReadChunkAsync(request_->chunkid(),
+                               request_->sn(),
+                               readBuffer,
+                               request_->offset(),
+                               size,
+                               [thisPtr, readBuffer, deleter, index, done](
+                                   CSErrorCode ret) {
+        thisPtr->OnReadChunkDone(ret, readBuffer, deleter, index, done);
+    });
+}
+
+void ReadChunkRequest::OnReadChunkDone(CSErrorCode ret,
+                                       char *readBuffer,
+                                       void (*deleter)(void*),
+                                       uint64_t index,
+                                       ::google::protobuf::Closure *done) {
+    brpc::ClosureGuard doneGuard(done);
 
-    auto ret = datastore_->ReadChunk(request_->chunkid(),
-                                     request_->sn(),
-                                     readBuffer,
-                                     request_->offset(),
-                                     size);
     butil::IOBuf wrapper;
-    wrapper.append_user_data(readBuffer, size, ReadBufferDeleter);
+    wrapper.append_user_data(readBuffer, request_->size(), deleter);
     if (CSErrorCode::Success == ret) {
-        cntl_->response_attachment().append(wrapper);
+        responseData_->append(wrapper);
         response_->set_status(CHUNK_OP_STATUS::CHUNK_OP_STATUS_SUCCESS);
+        node_->UpdateAppliedIndex(index);
     } else if (CSErrorCode::ChunkNotExistError == ret) {
         response_->set_status(
             CHUNK_OP_STATUS::CHUNK_OP_STATUS_CHUNK_NOTEXIST);
@@ -424,12 +494,117 @@ void ReadChunkRequest::ReadChunk() {
         response_->set_status(
             CHUNK_OP_STATUS::CHUNK_OP_STATUS_FAILURE_UNKNOWN);
     }
+    response_->set_appliedindex(MaxAppliedIndex(node_, index));
+}
+
+namespace {
+uint32_t IOBufCrc(const butil::IOBuf& buf) {
+    uint32_t crc = 0;
+    for (size_t i = 0; i < buf.backing_block_num(); ++i) {
+        butil::StringPiece block = buf.backing_block(i);
+        crc = curve::common::CRC32(crc, block.data(), block.size());
+    }
+    return crc;
+}
+}  // namespace
+
+void WriteChunkRequest::Process() {
+    brpc::ClosureGuard doneGuard(done_);
+
+    // check if current node is leader
+    if (!node_->IsLeaderTerm()) {
+        RedirectChunkRequest();
+        return;
+    }
+
+    if (NeedWriteAhead() && TrackInflight(request_, true)) {
+        int ret = WriteAheadAndPropose();
+        node_->GetInflightChunkRanges()->Proposed(inflightChunkId_,
+                                                  inflightToken_);
+        if (0 == ret) {
+            doneGuard.release();
+        }
+        return;
+    }
+
+    /**
+     * 如果propose成功，说明request成功交给了raft处理，
+     * 那么done_就不能被调用，只有propose失败了才需要提前返回
+     */
+    if (0 == Propose(request_, cntl_ ? &cntl_->request_attachment() :
+                     nullptr)) {
+        doneGuard.release();
+    }
+}
+
+bool WriteChunkRequest::NeedWriteAhead() {
+    if (cntl_ == nullptr || existCloneInfo(request_)) {
+        return false;
+    }
+    if (request_->size() < node_->WriteAheadMinSize() ||
+        cntl_->request_attachment().size() != request_->size()) {
+        return false;
+    }
+    return node_->WriteAheadAvailable();
+}
+
+int WriteChunkRequest::WriteAheadAndPropose() {
+    const butil::IOBuf &data = cntl_->request_attachment();
+
+    // clone chunk和需要cow的chunk在apply时会读写其他文件，不能提前写
+    CSChunkInfo chunkInfo;
+    CSErrorCode errorCode = datastore_->GetChunkInfo(request_->chunkid(),
+                                                     &chunkInfo);
+    if (CSErrorCode::Success != errorCode ||
+        chunkInfo.isClone ||
+        chunkInfo.snapSn != 0 ||
+        request_->sn() != chunkInfo.curSn ||
+        request_->sn() < chunkInfo.correctedSn ||
+        request_->offset() % chunkInfo.blockSize != 0 ||
+        request_->size() % chunkInfo.blockSize != 0) {
+        return Propose(request_, &data);
+    }
+
+    uint32_t cost;
+    errorCode = datastore_->WriteChunk(request_->chunkid(),
+                                       request_->sn(),
+                                       data,
+                                       request_->offset(),
+                                       request_->size(),
+                                       &cost);
+    if (CSErrorCode::Success == errorCode &&
+        !node_->EnableOdsyncWhenOpenChunkFile()) {
+        // 日志中不再有数据，返回成功之前数据必须已经持久化
+        errorCode = datastore_->SyncChunk(request_->chunkid());
+    }
+    if (CSErrorCode::Success != errorCode) {
+        LOG(WARNING) << "write ahead failed, fallback to write through log: "
+                     << " data store return: " << errorCode
+                     << ", request: " << request_->ShortDebugString();
+        return Propose(request_, &data);
+    }
+
+    ChunkRequest request(*request_);
+    request.set_writeaheadcrc(IOBufCrc(data));
+    writeAhead_ = true;
+    if (0 != Propose(&request, nullptr)) {
+        writeAhead_ = false;
+        return -1;
+    }
+    return 0;
 }
 
 void WriteChunkRequest::OnApply(uint64_t index,
                                 ::google::protobuf::Closure *done) {
-    brpc::ClosureGuard doneGuard(done);
-    uint32_t cost;
+    if (writeAhead_) {
+        brpc::ClosureGuard doneGuard(done);
+        // 数据在propose之前已经写入chunk文件
+        response_->set_status(CHUNK_OP_STATUS::CHUNK_OP_STATUS_SUCCESS);
+        node_->UpdateWriteAheadIndex(index);
+        node_->UpdateAppliedIndex(index);
+        response_->set_appliedindex(MaxAppliedIndex(node_, index));
+        return;
+    }
 
     std::string  cloneSourceLocation;
     if (existCloneInfo(request_)) {
@@ -438,13 +613,26 @@ void WriteChunkRequest::OnApply(uint64_t index,
                             request_->clonefileoffset());
     }
 
-    auto ret = datastore_->WriteChunk(request_->chunkid(),
-                                      request_->sn(),
-                                      cntl_->request_attachment(),
-                                      request_->offset(),
-                                      request_->size(),
-                                      &cost,
-                                      cloneSourceLocation);
+    // 批量写拆分出的子请求没有cntl，数据在请求完成前一直有效
+    const butil::IOBuf &data =
+        cntl_ != nullptr ? cntl_->request_attachment() : data_;
+    auto thisPtr =
+        std::dynamic_pointer_cast<WriteChunkRequest>(shared_from_this());
+    datastore_->WriteChunkAsync(request_->chunkid(),
+                                request_->sn(),
+                                data,
+                                request_->offset(),
+                                request_->size(),
+                                cloneSourceLocation,
+                                [thisPtr, index, done](CSErrorCode ret) {
+        thisPtr->OnWriteChunkDone(ret, index, done);
+    });
+}
+
+void WriteChunkRequest::OnWriteChunkDone(CSErrorCode ret,
+                                         uint64_t index,
+                                         ::google::protobuf::Closure *done) {
+    brpc::ClosureGuard doneGuard(done);
 
     if (CSErrorCode::Success == ret) {
         response_->set_status(CHUNK_OP_STATUS::CHUNK_OP_STATUS_SUCCESS);
@@ -484,6 +672,11 @@ void WriteChunkRequest::OnApplyFromLog(std::shared_ptr<CSDataStore> datastore,
                                        const ChunkRequest &request,
                                        const butil::IOBuf &data) {
     // NOTE: 处理过程中优先使用参数传入的datastore/request
+    if (request.has_writeaheadcrc()) {
+        ValidateWriteAhead(datastore, request);
+        return;
+    }
+
     uint32_t cost;
     std::string  cloneSourceLocation;
     if (existCloneInfo(&request)) {
@@ -518,21 +711,280 @@ void WriteChunkRequest::OnApplyFromLog(std::shared_ptr<CSDataStore> datastore,
     }
 }
 
+void WriteChunkRequest::ValidateWriteAhead(
+    std::shared_ptr<CSDataStore> datastore, const ChunkRequest &request) {
+    /**
+     * 日志中不带数据，只有写入数据的节点自己能回放，重启前写的日志
+     * 在copyset node中已经跳过。其他情况下本地数据必须和日志一致，
+     * 否则说明副本已经不一致，不能继续运行
+     */
+    std::unique_ptr<char[]> buf(new char[request.size()]);
+    auto ret = datastore->ReadChunk(request.chunkid(),
+                                    request.sn(),
+                                    buf.get(),
+                                    request.offset(),
+                                    request.size());
+    if (CSErrorCode::Success != ret) {
+        LOG(FATAL) << "read write ahead data failed: "
+                   << " data store return: " << ret
+                   << ", request: " << request.ShortDebugString();
+        return;
+    }
+    uint32_t crc = curve::common::CRC32(buf.get(), request.size());
+    LOG_IF(FATAL, crc != request.writeaheadcrc())
+        << "write ahead data mismatch, crc: " << crc
+        << ", request: " << request.ShortDebugString();
+}
+
+class BatchWriteChunkRequest::SubWriteClosure
+    : public ::google::protobuf::Closure {
+ public:
+    SubWriteClosure(std::shared_ptr<BatchWriteChunkRequest> request,
+                    ::google::protobuf::Closure *done,
+                    int count) :
+        request_(request), done_(done), pending_(count) {}
+
+    // 最后一个子请求完成时返回整个批量请求
+    void Run() override {
+        if (pending_.fetch_sub(1, std::memory_order_acq_rel) != 1) {
+            return;
+        }
+        std::unique_ptr<SubWriteClosure> selfGuard(this);
+        brpc::ClosureGuard doneGuard(done_);
+        request_->batchResponse_->set_status(
+            CHUNK_OP_STATUS::CHUNK_OP_STATUS_SUCCESS);
+    }
+
+ private:
+    std::shared_ptr<BatchWriteChunkRequest> request_;
+    ::google::protobuf::Closure *done_;
+    std::atomic<int> pending_;
+};
+
+BatchWriteChunkRequest::BatchWriteChunkRequest(
+    std::shared_ptr<CopysetNode> nodePtr,
+    RpcController *cntl,
+    const BatchChunkRequest *request,
+    BatchChunkResponse *response,
+    ::google::protobuf::Closure *done) :
+    ChunkOpRequest(nodePtr, cntl, &header_, &headerResponse_, done),
+    concurrentApplyModule_(nodePtr->GetConcurrentApplyModule()),
+    batchRequest_(request),
+    batchResponse_(response) {
+    header_.set_optype(CHUNK_OP_TYPE::CHUNK_OP_BATCH_WRITE);
+    header_.set_logicpoolid(request->logicpoolid());
+    header_.set_copysetid(request->copysetid());
+    header_.set_chunkid(request->requests_size() > 0 ?
+                        request->requests(0).chunkid() : 0);
+    headerResponse_.set_status(CHUNK_OP_STATUS::CHUNK_OP_STATUS_SUCCESS);
+}
+
+BatchWriteChunkRequest::~BatchWriteChunkRequest() {
+    for (auto &token : inflightTokens_) {
+        node_->GetInflightChunkRanges()->End(token.first, token.second);
+    }
+}
+
+bool BatchWriteChunkRequest::TrackInflight(const ChunkRequest *request,
+                                           bool tryWriteAhead) {
+    (void)request;
+    (void)tryWriteAhead;
+    // 子请求可能落在不同的chunk上，都要登记，批量写不走write ahead
+    bool writeAhead = false;
+    for (const ChunkRequest &sub : batchRequest_->requests()) {
+        // 删除请求和单个的非读写请求一样，覆盖整个chunk
+        uint64_t offset = 0;
+        uint64_t length = InflightChunkRanges::kWholeChunk;
+        if (sub.optype() == CHUNK_OP_TYPE::CHUNK_OP_WRITE) {
+            offset = sub.offset();
+            length = sub.size();
+        }
+        uint64_t token = node_->GetInflightChunkRanges()->Begin(
+            sub.chunkid(), offset, length, false, &writeAhead);
+        inflightTokens_.emplace_back(sub.chunkid(), token);
+    }
+    return false;
+}
+
+void BatchWriteChunkRequest::Process() {
+    brpc::ClosureGuard doneGuard(done_);
+
+    if (!node_->IsLeaderTerm()) {
+        RedirectChunkRequest();
+        return;
+    }
+
+    butil::IOBuf data;
+    if (0 != EncodeBatch(*batchRequest_, cntl_->request_attachment(), &data) ||
+        0 != Propose(&header_, &data)) {
+        LOG(ERROR) << "propose batch write failed, logic pool id: "
+                   << batchRequest_->logicpoolid()
+                   << ", copyset id: " << batchRequest_->copysetid();
+        batchResponse_->set_status(
+            CHUNK_OP_STATUS::CHUNK_OP_STATUS_FAILURE_UNKNOWN);
+        return;
+    }
+    doneGuard.release();
+}
+
+void BatchWriteChunkRequest::RedirectChunkRequest() {
+    batchResponse_->set_status(CHUNK_OP_STATUS::CHUNK_OP_STATUS_REDIRECTED);
+}
+
+void BatchWriteChunkRequest::OnApply(uint64_t index,
+                                     ::google::protobuf::Closure *done) {
+    const int count = batchRequest_->requests_size();
+    if (count == 0) {
+        brpc::ClosureGuard doneGuard(done);
+        batchResponse_->set_status(CHUNK_OP_STATUS::CHUNK_OP_STATUS_SUCCESS);
+        return;
+    }
+
+    // 先分配好所有子请求的response，子请求并发执行时不能再修改repeated字段
+    for (int i = 0; i < count; ++i) {
+        batchResponse_->add_responses()->set_status(
+            CHUNK_OP_STATUS::CHUNK_OP_STATUS_FAILURE_UNKNOWN);
+    }
+
+    auto thisPtr =
+        std::dynamic_pointer_cast<BatchWriteChunkRequest>(shared_from_this());
+    SubWriteClosure *subDone = new SubWriteClosure(thisPtr, done, count);
+    butil::IOBuf data = cntl_->request_attachment();
+    for (int i = 0; i < count; ++i) {
+        const ChunkRequest &sub = batchRequest_->requests(i);
+        butil::IOBuf subData;
+        data.cutn(&subData, sub.size());
+        auto subReq = NewSubRequest(node_, &sub,
+                                    batchResponse_->mutable_responses(i),
+                                    &subData);
+        concurrentApplyModule_->Push(sub.chunkid(),
+                                     ChunkOpRequest::Schedule(sub.optype()),
+                                     &ChunkOpRequest::OnApply, subReq,
+                                     index, subDone);
+    }
+}
+
+void BatchWriteChunkRequest::OnApplyFromLog(
+    std::shared_ptr<CSDataStore> datastore,
+    const ChunkRequest &request,
+    const butil::IOBuf &data) {
+    (void)request;
+    BatchChunkRequest batch;
+    butil::IOBuf payload;
+    if (0 != DecodeBatch(data, &batch, &payload)) {
+        LOG(FATAL) << "decode batch write failed";
+        return;
+    }
+
+    for (const ChunkRequest &sub : batch.requests()) {
+        butil::IOBuf subData;
+        payload.cutn(&subData, sub.size());
+        NewSubRequest(nullptr, &sub, nullptr, nullptr)
+            ->OnApplyFromLog(datastore, sub, subData);
+    }
+}
+
+void BatchWriteChunkRequest::ApplyFromLog(
+    ConcurrentApplyModule *concurrentApplyModule,
+    std::shared_ptr<CSDataStore> datastore,
+    const butil::IOBuf &data) {
+    DecodeFromLog(data, [&](std::shared_ptr<ChunkOpRequest> opReq,
+                            const ChunkRequest &sub,
+                            const butil::IOBuf &subData) {
+        concurrentApplyModule->Push(sub.chunkid(),
+                                    ChunkOpRequest::Schedule(sub.optype()),
+                                    &ChunkOpRequest::OnApplyFromLog, opReq,
+                                    datastore, sub, subData);
+    });
+}
+
+void BatchWriteChunkRequest::DecodeFromLog(const butil::IOBuf &data,
+                                           const SubRequestHandler &handler) {
+    BatchChunkRequest batch;
+    butil::IOBuf payload;
+    if (0 != DecodeBatch(data, &batch, &payload)) {
+        LOG(FATAL) << "decode batch write failed";
+        return;
+    }
+
+    for (const ChunkRequest &sub : batch.requests()) {
+        butil::IOBuf subData;
+        payload.cutn(&subData, sub.size());
+        handler(NewSubRequest(nullptr, &sub, nullptr, nullptr), sub, subData);
+    }
+}
+
+std::shared_ptr<ChunkOpRequest> BatchWriteChunkRequest::NewSubRequest(
+    std::shared_ptr<CopysetNode> nodePtr,
+    const ChunkRequest *request,
+    ChunkResponse *response,
+    const butil::IOBuf *data) {
+    if (request->optype() == CHUNK_OP_TYPE::CHUNK_OP_DELETE) {
+        if (nodePtr == nullptr) {
+            return std::make_shared<DeleteChunkRequest>();
+        }
+        return std::make_shared<DeleteChunkRequest>(
+            nodePtr, nullptr, request, response, nullptr);
+    }
+
+    if (nodePtr == nullptr) {
+        return std::make_shared<WriteChunkRequest>();
+    }
+    return std::make_shared<WriteChunkRequest>(
+        nodePtr, request, response, data, nullptr);
+}
+
+int BatchWriteChunkRequest::EncodeBatch(const BatchChunkRequest &request,
+                                        const butil::IOBuf &data,
+                                        butil::IOBuf *out) {
+    const uint32_t metaSize = butil::HostToNet32(request.ByteSize());
+    out->append(&metaSize, sizeof(uint32_t));
+    butil::IOBufAsZeroCopyOutputStream wrapper(out);
+    if (!request.SerializeToZeroCopyStream(&wrapper)) {
+        LOG(ERROR) << "Fail to serialize batch request";
+        return -1;
+    }
+    out->append(data);
+    return 0;
+}
+
+int BatchWriteChunkRequest::DecodeBatch(butil::IOBuf in,
+                                        BatchChunkRequest *request,
+                                        butil::IOBuf *data) {
+    uint32_t metaSize = 0;
+    if (in.cutn(&metaSize, sizeof(uint32_t)) != sizeof(uint32_t)) {
+        LOG(ERROR) << "batch request too short";
+        return -1;
+    }
+    metaSize = butil::NetToHost32(metaSize);
+
+    butil::IOBuf meta;
+    if (in.cutn(&meta, metaSize) != metaSize) {
+        LOG(ERROR) << "batch request too short, meta size: " << metaSize;
+        return -1;
+    }
+    butil::IOBufAsZeroCopyInputStream wrapper(meta);
+    if (!request->ParseFromZeroCopyStream(&wrapper)) {
+        LOG(ERROR) << "failed deserialize batch request";
+        return -1;
+    }
+    data->swap(in);
+    return 0;
+}
+
 void ReadSnapshotRequest::OnApply(uint64_t index,
                                   ::google::protobuf::Closure *done) {
     brpc::ClosureGuard doneGuard(done);
-    char *readBuffer = nullptr;
     uint32_t size = request_->size();
-    readBuffer = new(std::nothrow)char[size];
-    CHECK(nullptr != readBuffer) << "new readBuffer failed, "
-                                 << errno << ":" << strerror(errno);
+    ReadBufferPool::Deleter deleter = nullptr;
+    char *readBuffer = ReadBufferPool::GetInstance()->Alloc(size, &deleter);
     auto ret = datastore_->ReadSnapshotChunk(request_->chunkid(),
                                              request_->sn(),
                                              readBuffer,
                                              request_->offset(),
                                              request_->size());
     butil::IOBuf wrapper;
-    wrapper.append_user_data(readBuffer, size, ReadBufferDeleter);
+    wrapper.append_user_data(readBuffer, size, deleter);
 
     do {
         /**
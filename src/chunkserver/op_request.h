@@ -27,7 +27,10 @@
 #include <butil/iobuf.h>
 #include <brpc/controller.h>
 
+#include <functional>
 #include <memory>
+#include <utility>
+#include <vector>
 
 #include "proto/chunk.pb.h"
 #include "include/chunkserver/chunkserver_common.h"
@@ -69,7 +72,7 @@ class ChunkOpRequest : public std::enable_shared_from_this<ChunkOpRequest> {
                    ChunkResponse *response,
                    ::google::protobuf::Closure *done);
 
-    virtual ~ChunkOpRequest() = default;
+    virtual ~ChunkOpRequest();
 
     /**
      * 处理request，实际上是Propose给相应的copyset
@@ -169,6 +172,14 @@ class ChunkOpRequest : public std::enable_shared_from_this<ChunkOpRequest> {
     int Propose(const ChunkRequest *request,
                 const butil::IOBuf *data);
 
+    /**
+     * 开启write ahead时登记在途请求的chunk区间，请求析构时移除
+     * @param tryWriteAhead: 是否尝试以write ahead方式执行
+     * @return 可以write ahead时返回true
+     */
+    virtual bool TrackInflight(const ChunkRequest *request,
+                               bool tryWriteAhead);
+
  protected:
     // chunk持久化接口
     std::shared_ptr<CSDataStore> datastore_;
@@ -182,6 +193,10 @@ class ChunkOpRequest : public std::enable_shared_from_this<ChunkOpRequest> {
     ChunkResponse *response_;
     // rpc done closure
     ::google::protobuf::Closure *done_;
+    // 登记在途chunk区间的token，0表示没有登记
+    uint64_t inflightToken_;
+    // 登记的chunk id，析构时request_可能已经释放
+    ChunkID inflightChunkId_;
 };
 
 class DeleteChunkRequest : public ChunkOpRequest {
@@ -212,13 +227,23 @@ class ReadChunkRequest : public ChunkOpRequest {
 
  public:
     ReadChunkRequest() :
-        ChunkOpRequest() {}
+        ChunkOpRequest(),
+        responseData_(nullptr) {}
     ReadChunkRequest(std::shared_ptr<CopysetNode> nodePtr,
                      CloneManager* cloneMgr,
                      RpcController *cntl,
                      const ChunkRequest *request,
                      ChunkResponse *response,
                      ::google::protobuf::Closure *done);
+    /**
+     * 批量读的子请求没有自己的controller，读到的数据放到responseData中
+     */
+    ReadChunkRequest(std::shared_ptr<CopysetNode> nodePtr,
+                     CloneManager* cloneMgr,
+                     const ChunkRequest *request,
+                     ChunkResponse *response,
+                     butil::IOBuf *responseData,
+                     ::google::protobuf::Closure *done);
 
     virtual ~ReadChunkRequest() = default;
 
@@ -232,14 +257,29 @@ class ReadChunkRequest : public ChunkOpRequest {
         return request_;
     }
 
+    /**
+     * 读到的数据放在这里，随response返回给client
+     */
+    butil::IOBuf* ResponseData() {
+        return responseData_;
+    }
+
  private:
     // 根据chunk信息判断是否需要拷贝数据
     bool NeedClone(const CSChunkInfo& chunkInfo);
-    // 从chunk文件中读数据
-    void ReadChunk();
+    // 从chunk文件中异步读数据，读完成后返回请求
+    void ReadChunk(uint64_t index, ::google::protobuf::Closure *done);
+    // 读完成的回调，设置response并调用done
+    void OnReadChunkDone(CSErrorCode ret,
+                         char *readBuffer,
+                         void (*deleter)(void*),
+                         uint64_t index,
+                         ::google::protobuf::Closure *done);
 
  private:
     CloneManager* cloneMgr_;
+    // 默认为cntl的response attachment
+    butil::IOBuf* responseData_;
     // 并发模块
     ConcurrentApplyModule* concurrentApplyModule_;
     // 保存 apply index
@@ -260,12 +300,164 @@ class WriteChunkRequest : public ChunkOpRequest {
                        request,
                        response,
                        done) {}
+    /**
+     * 批量写apply时拆分出的子请求，数据由调用者从批量请求中切出
+     */
+    WriteChunkRequest(std::shared_ptr<CopysetNode> nodePtr,
+                      const ChunkRequest *request,
+                      ChunkResponse *response,
+                      const butil::IOBuf* data,
+                      ::google::protobuf::Closure *done) :
+        ChunkOpRequest(nodePtr,
+                       nullptr,
+                       request,
+                       response,
+                       done) {
+            if (data != nullptr) {
+                data_ = *data;
+            }
+        }
     virtual ~WriteChunkRequest() = default;
 
+    void Process() override;
     void OnApply(uint64_t index, ::google::protobuf::Closure *done);
     void OnApplyFromLog(std::shared_ptr<CSDataStore> datastore,
                         const ChunkRequest &request,
                         const butil::IOBuf &data) override;
+
+ private:
+    /**
+     * 请求本身是否满足write ahead的条件：单副本复制组，非clone请求，
+     * 大小不小于writeAheadMinSize
+     */
+    bool NeedWriteAhead();
+
+    /**
+     * 先将数据写入chunk文件，再propose只带crc的日志；chunk状态不满足
+     * 条件(clone chunk、需要cow、未对齐)或者写失败时按正常流程propose
+     * @return 0成功，-1失败
+     */
+    int WriteAheadAndPropose();
+
+    /**
+     * 回放write ahead日志时校验chunk文件中的数据
+     */
+    static void ValidateWriteAhead(std::shared_ptr<CSDataStore> datastore,
+                                   const ChunkRequest &request);
+
+    /**
+     * 异步写完成的回调，设置response并调用done
+     */
+    void OnWriteChunkDone(CSErrorCode ret,
+                          uint64_t index,
+                          ::google::protobuf::Closure *done);
+
+ private:
+    // 数据已经在propose之前写入chunk文件
+    bool writeAhead_ = false;
+    // 没有cntl时要写入的数据
+    butil::IOBuf data_;
+};
+
+/**
+ * 同一copyset上多个chunk的写请求打包成一条日志propose，apply时在状态机
+ * 线程中按子请求拆分成WriteChunkRequest，依次push给各自chunk的并发apply
+ * 队列，所以每个chunk上的apply顺序和日志顺序一致。子请求都完成后才返回
+ * 批量删除也使用这个请求，子请求拆分成DeleteChunkRequest
+ * 日志格式：ChunkRequest(CHUNK_OP_BATCH_WRITE) + BatchChunkRequest + 数据
+ */
+class BatchWriteChunkRequest : public ChunkOpRequest {
+ public:
+    BatchWriteChunkRequest() :
+        ChunkOpRequest(),
+        concurrentApplyModule_(nullptr),
+        batchRequest_(nullptr),
+        batchResponse_(nullptr) {}
+    BatchWriteChunkRequest(std::shared_ptr<CopysetNode> nodePtr,
+                           RpcController *cntl,
+                           const BatchChunkRequest *request,
+                           BatchChunkResponse *response,
+                           ::google::protobuf::Closure *done);
+    virtual ~BatchWriteChunkRequest();
+
+    void Process() override;
+    void RedirectChunkRequest() override;
+
+    /**
+     * 在状态机线程中调用，拆分子请求并分发给并发apply模块
+     */
+    void OnApply(uint64_t index, ::google::protobuf::Closure *done) override;
+
+    /**
+     * 在调用线程中依次执行各个子请求
+     */
+    void OnApplyFromLog(std::shared_ptr<CSDataStore> datastore,
+                        const ChunkRequest &request,
+                        const butil::IOBuf &data) override;
+
+    /**
+     * follower apply和回放日志时使用，拆分子请求并分发给并发apply模块
+     * @param data: 日志中ChunkRequest之后的数据
+     */
+    static void ApplyFromLog(ConcurrentApplyModule *concurrentApplyModule,
+                             std::shared_ptr<CSDataStore> datastore,
+                             const butil::IOBuf &data);
+
+    using SubRequestHandler =
+        std::function<void(std::shared_ptr<ChunkOpRequest> opReq,
+                           const ChunkRequest &request,
+                           const butil::IOBuf &data)>;
+
+    /**
+     * 拆分日志中的子请求，依次交给handler处理，用于重启回放
+     * @param data: 日志中ChunkRequest之后的数据
+     */
+    static void DecodeFromLog(const butil::IOBuf &data,
+                              const SubRequestHandler &handler);
+
+    /**
+     * 序列化批量请求和数据，结果作为日志中ChunkRequest之后的数据
+     * | request length | BatchChunkRequest | 各子请求的数据 |
+     * @return 0成功，-1失败
+     */
+    static int EncodeBatch(const BatchChunkRequest &request,
+                           const butil::IOBuf &data,
+                           butil::IOBuf *out);
+
+    /**
+     * EncodeBatch的逆过程
+     * @return 0成功，-1失败
+     */
+    static int DecodeBatch(butil::IOBuf in,
+                           BatchChunkRequest *request,
+                           butil::IOBuf *data);
+
+ protected:
+    // 登记所有子请求的区间
+    bool TrackInflight(const ChunkRequest *request,
+                       bool tryWriteAhead) override;
+
+ private:
+    class SubWriteClosure;
+
+    /**
+     * 按子请求的类型创建对应的op，nodePtr为空时创建回放日志用的op
+     */
+    static std::shared_ptr<ChunkOpRequest> NewSubRequest(
+        std::shared_ptr<CopysetNode> nodePtr,
+        const ChunkRequest *request,
+        ChunkResponse *response,
+        const butil::IOBuf *data);
+
+    ConcurrentApplyModule* concurrentApplyModule_;
+    const BatchChunkRequest *batchRequest_;
+    BatchChunkResponse *batchResponse_;
+    // 日志头部的ChunkRequest，作为基类的request_
+    ChunkRequest header_;
+    // 基类的response_，结果都在batchResponse_中
+    ChunkResponse headerResponse_;
+    // 登记的在途区间
+    std::vector<std::pair<ChunkID, uint64_t>> inflightTokens_;
 };
 
 class ReadSnapshotRequest : public ChunkOpRequest {
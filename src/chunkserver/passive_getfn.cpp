@@ -97,6 +97,21 @@ uint32_t GetChunkTrashedFunc(void* arg) {
     return chunkTrashed;
 }
 
+uint64_t GetReadBufferPoolHitFunc(void* arg) {
+    ReadBufferPool* pool = reinterpret_cast<ReadBufferPool*>(arg);
+    return pool != nullptr ? pool->GetHitCount() : 0;
+}
+
+uint64_t GetReadBufferPoolMissFunc(void* arg) {
+    ReadBufferPool* pool = reinterpret_cast<ReadBufferPool*>(arg);
+    return pool != nullptr ? pool->GetMissCount() : 0;
+}
+
+uint64_t GetReadBufferPoolCachedBytesFunc(void* arg) {
+    ReadBufferPool* pool = reinterpret_cast<ReadBufferPool*>(arg);
+    return pool != nullptr ? pool->GetCachedBytes() : 0;
+}
+
 uint32_t GetTotalChunkCountFunc(void* arg) {
     uint32_t chunkCount = 0;
     ChunkServerMetric* csMetric = reinterpret_cast<ChunkServerMetric*>(arg);
@@ -26,6 +26,7 @@
 #include "src/chunkserver/trash.h"
 #include "src/chunkserver/copyset_node_manager.h"
 #include "src/chunkserver/datastore/file_pool.h"
+#include "src/chunkserver/read_buffer_pool.h"
 #include "src/chunkserver/raftlog/curve_segment_log_storage.h"
 
 namespace curve {
@@ -87,6 +88,21 @@ namespace chunkserver {
      * @param arg: trash的对象指针
      */
     uint32_t GetChunkTrashedFunc(void* arg);
+    /**
+     * 获取读buffer池的命中次数
+     * @param arg: ReadBufferPool的对象指针
+     */
+    uint64_t GetReadBufferPoolHitFunc(void* arg);
+    /**
+     * 获取读buffer池的未命中次数
+     * @param arg: ReadBufferPool的对象指针
+     */
+    uint64_t GetReadBufferPoolMissFunc(void* arg);
+    /**
+     * 获取读buffer池中空闲buffer的总大小
+     * @param arg: ReadBufferPool的对象指针
+     */
+    uint64_t GetReadBufferPoolCachedBytesFunc(void* arg);
 
 }  // namespace chunkserver
 }  // namespace curve
@@ -50,6 +50,8 @@ class BraftSegment : public Segment {
         return _segment->load(configuration_manager);
     }
 
+    using Segment::append;
+
     int append(const braft::LogEntry* entry) override {
         return _segment->append(entry);
     }
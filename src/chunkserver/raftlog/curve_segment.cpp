@@ -40,6 +40,7 @@
 
 #include <fcntl.h>
 #include <butil/fd_utility.h>
+#include <map>
 #include <butil/raw_pack.h>
 #include <braft/local_storage.pb.h>
 #include <braft/fsync.h>
@@ -52,6 +53,75 @@ namespace chunkserver {
 DEFINE_bool(raftSyncSegments, true, "call fsync when a segment is closed");
 DEFINE_bool(enableWalDirectWrite, true, "enable wal direct write or not");
 DEFINE_uint32(walAlignSize, 4096, "wal align size to write");
+DEFINE_bool(enableWalBatchAppend, true,
+            "pack entries of one append_entries into one direct write");
+DEFINE_uint32(walBatchMaxBytes, 4 * 1024 * 1024,
+              "max bytes of entries packed into one batched wal write");
+DEFINE_uint32(walBatchBufferPoolSize, 4,
+              "max cached buffers per size class for batched wal write");
+
+namespace {
+
+// Aligned buffers used by batched wal write. Buffers are classified by
+// power of two capacity, so a buffer can be reused by later batches of
+// similar size instead of posix_memalign/free on every append.
+class WalBufferPool {
+ public:
+    static WalBufferPool& GetInstance() {
+        static WalBufferPool pool;
+        return pool;
+    }
+
+    char* Get(size_t size, size_t* capacity) {
+        size_t cap = FLAGS_walAlignSize;
+        while (cap < size) {
+            cap <<= 1;
+        }
+        *capacity = cap;
+        {
+            BAIDU_SCOPED_LOCK(_mutex);
+            auto iter = _free.find(cap);
+            if (iter != _free.end() && !iter->second.empty()) {
+                char* buf = iter->second.back();
+                iter->second.pop_back();
+                return buf;
+            }
+        }
+        char* buf = nullptr;
+        int ret = posix_memalign(reinterpret_cast<void **>(&buf),
+                                 FLAGS_walAlignSize, cap);
+        LOG_IF(FATAL, ret != 0 || buf == nullptr)
+            << "posix_memalign WAL batch buffer failed " << strerror(ret);
+        return buf;
+    }
+
+    void Put(char* buf, size_t capacity) {
+        {
+            BAIDU_SCOPED_LOCK(_mutex);
+            std::vector<char*>& bufs = _free[capacity];
+            if (bufs.size() < FLAGS_walBatchBufferPoolSize) {
+                bufs.push_back(buf);
+                return;
+            }
+        }
+        free(buf);
+    }
+
+ private:
+    WalBufferPool() = default;
+
+    braft::raft_mutex_t _mutex;
+    std::map<size_t, std::vector<char*>> _free;
+};
+
+inline size_t align_up(size_t size) {
+    if (size % FLAGS_walAlignSize == 0) {
+        return size;
+    }
+    return (size / FLAGS_walAlignSize + 1) * FLAGS_walAlignSize;
+}
+
+}  // namespace
 
 int CurveSegment::create() {
     if (!_is_open) {
@@ -370,26 +440,17 @@ int CurveSegment::_load_entry(off_t offset, EntryHeader* head,
     return 0;
 }
 
-int CurveSegment::append(const braft::LogEntry* entry) {
-    if (BAIDU_UNLIKELY(!entry || !_is_open)) {
-        return EINVAL;
-    } else if (entry->id.index !=
-                    _last_index.load(butil::memory_order_consume) + 1) {
-        CHECK(false) << "entry->index=" << entry->id.index
-                  << " _last_index=" << _last_index
-                  << " _first_index=" << _first_index;
-        return ERANGE;
-    }
-    butil::IOBuf data;
+int CurveSegment::_serialize_data(const braft::LogEntry* entry,
+                                  butil::IOBuf* data) {
     switch (entry->type) {
     case braft::ENTRY_TYPE_DATA:
-        data.append(entry->data);
+        data->append(entry->data);
         break;
     case braft::ENTRY_TYPE_NO_OP:
         break;
     case braft::ENTRY_TYPE_CONFIGURATION:
         {
-            butil::Status status = serialize_configuration_meta(entry, data);
+            butil::Status status = serialize_configuration_meta(entry, *data);
             if (!status.ok()) {
                 LOG(ERROR) << "Fail to serialize ConfigurationPBMeta, path: "
                            << _path;
@@ -402,6 +463,23 @@ int CurveSegment::append(const braft::LogEntry* entry) {
                    << ", path: " << _path;
         return -1;
     }
+    return 0;
+}
+
+int CurveSegment::append(const braft::LogEntry* entry) {
+    if (BAIDU_UNLIKELY(!entry || !_is_open)) {
+        return EINVAL;
+    } else if (entry->id.index !=
+                    _last_index.load(butil::memory_order_consume) + 1) {
+        CHECK(false) << "entry->index=" << entry->id.index
+                  << " _last_index=" << _last_index
+                  << " _first_index=" << _first_index;
+        return ERANGE;
+    }
+    butil::IOBuf data;
+    if (_serialize_data(entry, &data) != 0) {
+        return -1;
+    }
     uint32_t data_check_sum = get_checksum(_checksum_type, data);
     uint32_t real_length = data.length();
     size_t to_write = kEntryHeaderSize + data.length();
@@ -472,14 +550,101 @@ int CurveSegment::append(const braft::LogEntry* entry) {
     return _update_meta_page();
 }
 
+int CurveSegment::append(const std::vector<braft::LogEntry*>& entries,
+                         size_t begin, size_t count) {
+    // batching only makes sense for direct write, buffered write has
+    // been merged by page cache already
+    if (!FLAGS_enableWalDirectWrite || !FLAGS_enableWalBatchAppend ||
+        count <= 1) {
+        return Segment::append(entries, begin, count);
+    }
+    if (BAIDU_UNLIKELY(!_is_open)) {
+        return 0;
+    } else if (entries[begin]->id.index !=
+                    _last_index.load(butil::memory_order_consume) + 1) {
+        CHECK(false) << "entry->index=" << entries[begin]->id.index
+                  << " _last_index=" << _last_index
+                  << " _first_index=" << _first_index;
+        return 0;
+    }
+
+    std::vector<butil::IOBuf> datas(count);
+    size_t to_write = 0;
+    for (size_t i = 0; i < count; i++) {
+        if (_serialize_data(entries[begin + i], &datas[i]) != 0) {
+            return 0;
+        }
+        CHECK_LE(datas[i].length(), 1ul << 56ul);
+        to_write += align_up(kEntryHeaderSize + datas[i].length());
+    }
+
+    size_t capacity = 0;
+    char* write_buf = WalBufferPool::GetInstance().Get(to_write, &capacity);
+    std::vector<int64_t> offsets(count);
+    size_t buf_off = 0;
+    for (size_t i = 0; i < count; i++) {
+        const braft::LogEntry* entry = entries[begin + i];
+        const butil::IOBuf& data = datas[i];
+        uint32_t real_length = data.length();
+        size_t entry_len = align_up(kEntryHeaderSize + real_length);
+        char* entry_buf = write_buf + buf_off;
+
+        const uint32_t meta_field =
+                    (entry->type << 24) | (_checksum_type << 16);
+        butil::RawPacker packer(entry_buf);
+        packer.pack64(entry->id.term)
+              .pack32(meta_field)
+              .pack32((uint32_t)(entry_len - kEntryHeaderSize))
+              .pack32(real_length)
+              .pack32(get_checksum(_checksum_type, data));
+        packer.pack32(get_checksum(
+                      _checksum_type, entry_buf, kEntryHeaderSize - 4));
+        data.copy_to(entry_buf + kEntryHeaderSize, real_length);
+        memset(entry_buf + kEntryHeaderSize + real_length, 0,
+               entry_len - kEntryHeaderSize - real_length);
+
+        offsets[i] = _meta.bytes + buf_off;
+        buf_off += entry_len;
+    }
+    CHECK_EQ(buf_off, to_write);
+
+    int ret = ::pwrite(_direct_fd, write_buf, to_write, _meta.bytes);
+    WalBufferPool::GetInstance().Put(write_buf, capacity);
+    if (ret != static_cast<int>(to_write)) {
+        LOG(ERROR) << "Fail to write batch directly to fd=" << _direct_fd
+                   << ", count=" << count << ", size=" << to_write
+                   << ", offset=" << _meta.bytes << ", error=" << berror();
+        return 0;
+    }
+    // the entries are exposed only after the meta page covers them, so
+    // a failed batch can be rewritten at the same offset
+    if (_write_meta_page(_meta.bytes + to_write) != 0) {
+        return 0;
+    }
+    {
+        BAIDU_SCOPED_LOCK(_mutex);
+        for (size_t i = 0; i < count; i++) {
+            _offset_and_term.push_back(
+                std::make_pair(offsets[i], entries[begin + i]->id.term));
+        }
+        _last_index.fetch_add(count, butil::memory_order_relaxed);
+        _meta.bytes += to_write;
+    }
+    return count;
+}
+
 int CurveSegment::_update_meta_page() {
+    return _write_meta_page(_meta.bytes);
+}
+
+int CurveSegment::_write_meta_page(int64_t bytes) {
     char* metaPage = nullptr;
     int ret = posix_memalign(reinterpret_cast<void **>(&metaPage),
                             FLAGS_walAlignSize, _meta_page_size);
     LOG_IF(FATAL, ret < 0 || metaPage == nullptr)
         << "posix_memalign WAL meta page failed " << strerror(ret);
     memset(metaPage, 0, _meta_page_size);
-    memcpy(metaPage, &_meta.bytes, sizeof(_meta.bytes));
+    memcpy(metaPage, &bytes, sizeof(bytes));
     if (FLAGS_enableWalDirectWrite) {
         ret = ::pwrite(_direct_fd, metaPage, _meta_page_size, 0);
     } else {
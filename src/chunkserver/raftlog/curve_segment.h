@@ -60,6 +60,9 @@ namespace curve {
 namespace chunkserver {
 
 DECLARE_bool(enableWalDirectWrite);
+DECLARE_uint32(walAlignSize);
+DECLARE_bool(enableWalBatchAppend);
+DECLARE_uint32(walBatchMaxBytes);
 
 struct CurveSegmentMeta {
     CurveSegmentMeta() : bytes(0) {}
@@ -111,6 +114,12 @@ class BAIDU_CACHELINE_ALIGNMENT CurveSegment:
     // serialize entry, and append to open segment
     int append(const braft::LogEntry* entry) override;
 
+    // serialize entries [begin, begin + count) into one aligned buffer,
+    // and append them to open segment with a single write,
+    // return the number of entries appended
+    int append(const std::vector<braft::LogEntry*>& entries,
+               size_t begin, size_t count) override;
+
     // get entry by index
     braft::LogEntry* get(const int64_t index) const override;
 
@@ -158,10 +167,15 @@ class BAIDU_CACHELINE_ALIGNMENT CurveSegment:
 
     int _get_meta(int64_t index, LogMeta* meta) const;
 
+    int _serialize_data(const braft::LogEntry* entry, butil::IOBuf* data);
+
     int _load_meta();
 
     int _update_meta_page();
 
+    // write bytes of the segment into meta page
+    int _write_meta_page(int64_t bytes);
+
     std::string _path;
     CurveSegmentMeta _meta;
     mutable braft::raft_mutex_t _mutex;
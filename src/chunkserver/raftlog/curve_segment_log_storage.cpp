@@ -38,6 +38,7 @@
 //          Zhangyi Chen(chenzhangyi01@baidu.com)
 //          Xiong,Kai(xiongkai@baidu.com)
 
+#include <braft/log_entry.h>
 #include <braft/protobuf_file.h>
 #include <braft/local_storage.pb.h>
 #include "src/chunkserver/raftlog/curve_segment_log_storage.h"
@@ -405,7 +406,7 @@ int64_t CurveSegmentLogStorage::get_term(const int64_t index) {
 
 int CurveSegmentLogStorage::append_entry(const braft::LogEntry* entry) {
     scoped_refptr<Segment> segment =
-                open_segment(entry->data.size() + kEntryHeaderSize);
+                open_segment(estimate_size(entry));
     if (NULL == segment) {
         return EIO;
     }
@@ -435,25 +436,64 @@ int CurveSegmentLogStorage::append_entries(
         return -1;
     }
     scoped_refptr<Segment> last_segment = NULL;
-    for (size_t i = 0; i < entries.size(); i++) {
-        braft::LogEntry* entry = entries[i];
-
-        scoped_refptr<Segment> segment =
-                    open_segment(entry->data.size() + kEntryHeaderSize);
+    size_t i = 0;
+    while (i < entries.size()) {
+        size_t to_write = estimate_size(entries[i]);
+        scoped_refptr<Segment> segment = open_segment(to_write);
         if (NULL == segment) {
             return i;
         }
-        int ret = segment->append(entry);
-        if (0 != ret) {
-            return i;
+        // pack following entries into the same write as long as they
+        // still fit in the open segment
+        size_t count = 1;
+        if (FLAGS_enableWalBatchAppend) {
+            const int64_t max_bytes = max_segment_size();
+            while (i + count < entries.size()) {
+                size_t next = estimate_size(entries[i + count]);
+                if (to_write + next > FLAGS_walBatchMaxBytes ||
+                    segment->bytes() + to_write + next > max_bytes) {
+                    break;
+                }
+                to_write += next;
+                ++count;
+            }
+        }
+        int appended = segment->append(entries, i, count);
+        if (appended > 0) {
+            _last_log_index.fetch_add(appended, butil::memory_order_release);
+            last_segment = segment;
         }
-        _last_log_index.fetch_add(1, butil::memory_order_release);
-        last_segment = segment;
+        if (static_cast<size_t>(appended) != count) {
+            return i + std::max(appended, 0);
+        }
+        i += count;
     }
     last_segment->sync(_enable_sync);
     return entries.size();
 }
 
+size_t CurveSegmentLogStorage::estimate_size(const braft::LogEntry* entry) {
+    size_t size = kEntryHeaderSize;
+    if (entry->type == braft::ENTRY_TYPE_CONFIGURATION) {
+        // peers are serialized into the entry, not carried in data
+        butil::IOBuf meta;
+        if (braft::serialize_configuration_meta(entry, meta).ok()) {
+            size += meta.size();
+        }
+    } else {
+        size += entry->data.size();
+    }
+    if (size % FLAGS_walAlignSize != 0) {
+        size = (size / FLAGS_walAlignSize + 1) * FLAGS_walAlignSize;
+    }
+    return size;
+}
+
+int64_t CurveSegmentLogStorage::max_segment_size() {
+    return static_cast<int64_t>(_walFilePool->GetFilePoolOpt().fileSize) +
+           _walFilePool->GetFilePoolOpt().metaPageSize;
+}
+
 int CurveSegmentLogStorage::truncate_prefix(const int64_t first_index_kept) {
     // segment files
     if (_first_log_index.load(butil::memory_order_acquire) >=
@@ -705,9 +745,7 @@ scoped_refptr<Segment> CurveSegmentLogStorage::open_segment(
                 return NULL;
             }
         }
-        uint32_t maxTotalFileSize = _walFilePool->GetFilePoolOpt().fileSize
-                                  + _walFilePool->GetFilePoolOpt().metaPageSize;
-        if (_open_segment->bytes() + to_write > maxTotalFileSize) {
+        if (_open_segment->bytes() + to_write > max_segment_size()) {
             _segments[_open_segment->first_index()] = _open_segment;
             prev_open_segment.swap(_open_segment);
         }
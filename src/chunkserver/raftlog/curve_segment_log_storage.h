@@ -154,6 +154,8 @@ class CurveSegmentLogStorage : public braft::LogStorage {
 
  private:
     scoped_refptr<Segment> open_segment(size_t to_write);
+    size_t estimate_size(const braft::LogEntry *entry);
+    int64_t max_segment_size();
     int save_meta(const int64_t log_index);
     int load_meta();
     int list_segments(bool is_empty);
@@ -27,6 +27,7 @@
 #include <braft/storage.h>
 #include <braft/util.h>
 #include <string>
+#include <vector>
 
 namespace curve {
 namespace chunkserver {
@@ -44,6 +45,18 @@ class Segment : public butil::RefCountedThreadSafe<Segment> {
     // serialize entry, and append to open segment
     virtual int append(const braft::LogEntry* entry) = 0;
 
+    // serialize entries [begin, begin + count), and append them to open
+    // segment, return the number of entries appended
+    virtual int append(const std::vector<braft::LogEntry*>& entries,
+                       size_t begin, size_t count) {
+        for (size_t i = 0; i < count; i++) {
+            if (append(entries[begin + i]) != 0) {
+                return i;
+            }
+        }
+        return count;
+    }
+
     // get entry by index
     virtual braft::LogEntry* get(const int64_t index) const = 0;
 
@@ -0,0 +1,190 @@
+/*
+ *  Copyright (c) 2023 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include "src/chunkserver/read_buffer_pool.h"
+
+#include <glog/logging.h>
+#include <stdlib.h>
+
+#include <algorithm>
+
+namespace curve {
+namespace chunkserver {
+
+DEFINE_uint64(readBufferPoolMaxBytes, 256 * 1024 * 1024,
+              "max bytes of free read buffers kept in the global pool");
+DEFINE_uint64(readBufferThreadCacheBytes, 4 * 1024 * 1024,
+              "max bytes of free read buffers of each size class kept "
+              "in a thread cache");
+
+const size_t ReadBufferPool::kAlignment;
+const size_t ReadBufferPool::kMinClassSize;
+const int ReadBufferPool::kClassNum;
+const size_t ReadBufferPool::kMaxClassSize;
+
+const ReadBufferPool::Deleter ReadBufferPool::kDeleters[kClassNum] = {
+    &ReadBufferPool::PooledDeleter<0>,
+    &ReadBufferPool::PooledDeleter<1>,
+    &ReadBufferPool::PooledDeleter<2>,
+    &ReadBufferPool::PooledDeleter<3>,
+    &ReadBufferPool::PooledDeleter<4>,
+    &ReadBufferPool::PooledDeleter<5>,
+    &ReadBufferPool::PooledDeleter<6>,
+    &ReadBufferPool::PooledDeleter<7>,
+    &ReadBufferPool::PooledDeleter<8>,
+    &ReadBufferPool::PooledDeleter<9>,
+    &ReadBufferPool::PooledDeleter<10>,
+};
+
+namespace {
+// 线程缓存析构之后线程里还可能释放IOBuf，此时直接分配和释放
+thread_local bool tlsCacheDestroyed = false;
+}  // namespace
+
+struct ReadBufferPool::ThreadCache {
+    std::vector<char*> freeList[kClassNum];
+
+    ~ThreadCache() {
+        tlsCacheDestroyed = true;
+        // 线程退出时把缓存的buffer还给全局池
+        ReadBufferPool* pool = ReadBufferPool::GetInstance();
+        for (int i = 0; i < kClassNum; ++i) {
+            pool->Release(this, i, freeList[i].size());
+        }
+    }
+};
+
+ReadBufferPool* ReadBufferPool::GetInstance() {
+    // 线程缓存在线程退出时还会访问，所以池子不析构
+    static ReadBufferPool* pool = new ReadBufferPool();
+    return pool;
+}
+
+ReadBufferPool::ReadBufferPool()
+    : globalBytes_(0),
+      cachedBytes_(0) {}
+
+int ReadBufferPool::SizeClass(size_t size) {
+    int index = 0;
+    while (index < kClassNum && ClassSize(index) < size) {
+        ++index;
+    }
+    return index;
+}
+
+char* ReadBufferPool::AllocAligned(size_t size) {
+    void* buf = nullptr;
+    int ret = posix_memalign(&buf, kAlignment, size);
+    CHECK(ret == 0) << "alloc read buffer failed, size: " << size
+                    << ", error: " << ret;
+    return static_cast<char*>(buf);
+}
+
+ReadBufferPool::ThreadCache* ReadBufferPool::GetThreadCache() {
+    static thread_local ThreadCache cache;
+    return &cache;
+}
+
+void ReadBufferPool::FreeDeleter(void* buf) {
+    free(buf);
+}
+
+char* ReadBufferPool::Alloc(size_t size, Deleter* deleter) {
+    int index = SizeClass(size);
+    if (index >= kClassNum) {
+        miss_ << 1;
+        *deleter = &ReadBufferPool::FreeDeleter;
+        return AllocAligned(size);
+    }
+
+    *deleter = kDeleters[index];
+    if (tlsCacheDestroyed) {
+        miss_ << 1;
+        return AllocAligned(ClassSize(index));
+    }
+    ThreadCache* cache = GetThreadCache();
+    std::vector<char*>& freeList = cache->freeList[index];
+    if (freeList.empty() && Refill(cache, index) == 0) {
+        miss_ << 1;
+        return AllocAligned(ClassSize(index));
+    }
+
+    hit_ << 1;
+    char* buf = freeList.back();
+    freeList.pop_back();
+    cachedBytes_.fetch_sub(ClassSize(index), std::memory_order_relaxed);
+    return buf;
+}
+
+void ReadBufferPool::Free(char* buf, int index) {
+    if (tlsCacheDestroyed) {
+        free(buf);
+        return;
+    }
+    ThreadCache* cache = GetThreadCache();
+    std::vector<char*>& freeList = cache->freeList[index];
+    freeList.push_back(buf);
+    cachedBytes_.fetch_add(ClassSize(index), std::memory_order_relaxed);
+
+    size_t maxCount = std::max<size_t>(
+        1, FLAGS_readBufferThreadCacheBytes / ClassSize(index));
+    if (freeList.size() > maxCount) {
+        Release(cache, index, freeList.size() - maxCount / 2);
+    }
+}
+
+size_t ReadBufferPool::Refill(ThreadCache* cache, int index) {
+    size_t classSize = ClassSize(index);
+    size_t batch = std::max<size_t>(
+        1, FLAGS_readBufferThreadCacheBytes / classSize / 2);
+
+    std::lock_guard<std::mutex> lk(mtx_);
+    std::vector<char*>& global = freeList_[index];
+    size_t count = std::min(batch, global.size());
+    std::vector<char*>& local = cache->freeList[index];
+    local.insert(local.end(), global.end() - count, global.end());
+    global.resize(global.size() - count);
+    globalBytes_ -= count * classSize;
+    return count;
+}
+
+void ReadBufferPool::Release(ThreadCache* cache, int index, size_t count) {
+    size_t classSize = ClassSize(index);
+    std::vector<char*>& local = cache->freeList[index];
+    count = std::min(count, local.size());
+
+    size_t freed = 0;
+    {
+        std::lock_guard<std::mutex> lk(mtx_);
+        std::vector<char*>& global = freeList_[index];
+        while (count > 0) {
+            char* buf = local.back();
+            local.pop_back();
+            --count;
+            if (globalBytes_ + classSize <= FLAGS_readBufferPoolMaxBytes) {
+                global.push_back(buf);
+                globalBytes_ += classSize;
+            } else {
+                free(buf);
+                ++freed;
+            }
+        }
+    }
+    cachedBytes_.fetch_sub(freed * classSize, std::memory_order_relaxed);
+}
+
+}  // namespace chunkserver
+}  // namespace curve
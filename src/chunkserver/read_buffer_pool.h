@@ -0,0 +1,116 @@
+/*
+ *  Copyright (c) 2023 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#ifndef SRC_CHUNKSERVER_READ_BUFFER_POOL_H_
+#define SRC_CHUNKSERVER_READ_BUFFER_POOL_H_
+
+#include <bvar/bvar.h>
+#include <gflags/gflags.h>
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>  // NOLINT
+#include <vector>
+
+#include "src/common/uncopyable.h"
+
+namespace curve {
+namespace chunkserver {
+
+DECLARE_uint64(readBufferPoolMaxBytes);
+DECLARE_uint64(readBufferThreadCacheBytes);
+
+/**
+ * 读请求使用的buffer池
+ * buffer按2的幂划分大小等级(4KB ~ 4MB)，按kAlignment对齐，可以直接用于
+ * O_DIRECT读。每个线程有一级缓存，分配和释放不需要加锁；线程缓存满了
+ * 或者空了时和全局池批量交换，这样在apply线程分配、在brpc线程随response
+ * 释放的buffer也能回到apply线程复用。
+ * 释放函数通过Alloc返回，可以直接交给IOBuf::append_user_data，避免拷贝。
+ */
+class ReadBufferPool : public curve::common::Uncopyable {
+ public:
+    using Deleter = void (*)(void*);
+
+    static const size_t kAlignment = 4096;
+    static const size_t kMinClassSize = 4096;
+    static const int kClassNum = 11;
+    static const size_t kMaxClassSize = kMinClassSize << (kClassNum - 1);
+
+    static ReadBufferPool* GetInstance();
+
+    /**
+     * 分配至少size字节的buffer，超过kMaxClassSize的不经过池子
+     * @param size: 需要的大小
+     * @param[out] deleter: buffer对应的释放函数
+     * @return buffer，分配失败会直接退出进程
+     */
+    char* Alloc(size_t size, Deleter* deleter);
+
+    uint64_t GetHitCount() const {
+        return hit_.get_value();
+    }
+
+    uint64_t GetMissCount() const {
+        return miss_.get_value();
+    }
+
+    // 池子(包括各线程缓存)中空闲buffer的总大小
+    uint64_t GetCachedBytes() const {
+        return cachedBytes_.load(std::memory_order_relaxed);
+    }
+
+ private:
+    struct ThreadCache;
+
+    ReadBufferPool();
+
+    static int SizeClass(size_t size);
+    static size_t ClassSize(int index) {
+        return kMinClassSize << index;
+    }
+    static char* AllocAligned(size_t size);
+    static ThreadCache* GetThreadCache();
+
+    // 将buffer还给所在大小等级，由Deleter调用
+    void Free(char* buf, int index);
+    // 线程缓存为空时从全局池批量取，返回取到的数量
+    size_t Refill(ThreadCache* cache, int index);
+    // 线程缓存满时将一半归还全局池，全局池满了则释放
+    void Release(ThreadCache* cache, int index, size_t count);
+
+    template <int kIndex>
+    static void PooledDeleter(void* buf) {
+        GetInstance()->Free(static_cast<char*>(buf), kIndex);
+    }
+    static void FreeDeleter(void* buf);
+    static const Deleter kDeleters[kClassNum];
+
+ private:
+    std::mutex mtx_;
+    // 全局池，按大小等级划分
+    std::vector<char*> freeList_[kClassNum];
+    // 全局池中空闲buffer的总大小
+    uint64_t globalBytes_;
+    std::atomic<uint64_t> cachedBytes_;
+    bvar::Adder<uint64_t> hit_;
+    bvar::Adder<uint64_t> miss_;
+};
+
+}  // namespace chunkserver
+}  // namespace curve
+
+#endif  // SRC_CHUNKSERVER_READ_BUFFER_POOL_H_
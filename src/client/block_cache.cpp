@@ -0,0 +1,274 @@
+/*
+ *  Copyright (c) 2023 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include "src/client/block_cache.h"
+
+#include <glog/logging.h>
+
+#include <algorithm>
+
+namespace curve {
+namespace client {
+
+namespace {
+
+const uint32_t kMinBlockSizeKB = 4;
+const uint32_t kMaxBlockSizeKB = 64;
+
+// invalidations kept by each shard, enough for the writes overlapped with
+// a read in flight, fills older than the dropped ones are discarded
+const size_t kMaxInvalidRanges = 64;
+
+}  // namespace
+
+BlockCache::BlockCache(const BlockCacheOption& option,
+                       BlockCacheMetric* metric)
+    : blockSize_(option.blockSizeKB * 1024ull),
+      shardCapacity_(option.capacityMB * 1024ull * 1024ull /
+                     std::max<uint32_t>(option.shardNum, 1)),
+      epoch_(0),
+      metric_(metric) {
+    uint32_t shardNum = std::max<uint32_t>(option.shardNum, 1);
+    for (uint32_t i = 0; i < shardNum; ++i) {
+        shards_.emplace_back(new Shard());
+    }
+}
+
+bool BlockCache::CheckOption(const BlockCacheOption& option) {
+    uint32_t size = option.blockSizeKB;
+    if (size < kMinBlockSizeKB || size > kMaxBlockSizeKB ||
+        (size & (size - 1)) != 0) {
+        LOG(ERROR) << "invalid block cache block size " << size
+                   << "KB, must be power of 2 in [" << kMinBlockSizeKB
+                   << ", " << kMaxBlockSizeKB << "]KB";
+        return false;
+    }
+    if (option.shardNum == 0) {
+        LOG(ERROR) << "block cache shard num must be greater than 0";
+        return false;
+    }
+    if (option.capacityMB * 1024ull * 1024ull / option.shardNum <
+        option.blockSizeKB * 1024ull) {
+        LOG(ERROR) << "block cache capacity " << option.capacityMB
+                   << "MB is too small for " << option.shardNum
+                   << " shards";
+        return false;
+    }
+    return true;
+}
+
+bool BlockCache::Read(uint64_t offset, uint64_t length, butil::IOBuf* data) {
+    data->clear();
+    if (length == 0) {
+        return true;
+    }
+
+    uint64_t end = offset + length;
+    for (uint64_t index = offset / blockSize_; index * blockSize_ < end;
+         ++index) {
+        uint64_t blockStart = index * blockSize_;
+        uint64_t from = std::max(offset, blockStart);
+        uint64_t to = std::min(end, blockStart + blockSize_);
+
+        Shard* shard = GetShard(index);
+        std::lock_guard<std::mutex> lk(shard->mtx);
+        auto iter = shard->index.find(index);
+        if (iter == shard->index.end()) {
+            data->clear();
+            metric_->miss << 1;
+            return false;
+        }
+        shard->lru.splice(shard->lru.begin(), shard->lru, iter->second);
+        iter->second->second.append_to(data, to - from, from - blockStart);
+    }
+
+    metric_->hit << 1;
+    return true;
+}
+
+void BlockCache::Fill(uint64_t epoch, uint64_t offset,
+                      const butil::IOBuf& data) {
+    if (offset % blockSize_ != 0) {
+        return;
+    }
+
+    uint64_t count = data.size() / blockSize_;
+    for (uint64_t i = 0; i < count; ++i) {
+        uint64_t index = offset / blockSize_ + i;
+        butil::IOBuf block;
+        data.append_to(&block, blockSize_, i * blockSize_);
+
+        Shard* shard = GetShard(index);
+        std::lock_guard<std::mutex> lk(shard->mtx);
+        // checked under shard lock, Invalidate records the range with it
+        if (InvalidatedLocked(*shard, epoch, index)) {
+            continue;
+        }
+
+        auto iter = shard->index.find(index);
+        if (iter != shard->index.end()) {
+            iter->second->second.swap(block);
+            shard->lru.splice(shard->lru.begin(), shard->lru, iter->second);
+            continue;
+        }
+
+        shard->lru.emplace_front(index, butil::IOBuf());
+        shard->lru.front().second.swap(block);
+        shard->index.emplace(index, shard->lru.begin());
+        shard->bytes += blockSize_;
+        metric_->cachedBytes << blockSize_;
+
+        while (shard->bytes > shardCapacity_) {
+            EraseLocked(shard, std::prev(shard->lru.end()));
+            metric_->evict << 1;
+        }
+    }
+}
+
+void BlockCache::Invalidate(uint64_t offset, uint64_t length) {
+    if (length == 0) {
+        return;
+    }
+
+    uint64_t first = offset / blockSize_;
+    uint64_t last = (offset + length - 1) / blockSize_;
+    InvalidRange range{epoch_.fetch_add(1, std::memory_order_acq_rel) + 1,
+                       first, last};
+    uint64_t dropped = 0;
+    for (auto& shard : shards_) {
+        bool covered = last - first + 1 >= shards_.size();
+        for (uint64_t index = first; !covered && index <= last; ++index) {
+            covered = GetShard(index) == shard.get();
+        }
+        if (!covered) {
+            continue;
+        }
+
+        std::lock_guard<std::mutex> lk(shard->mtx);
+        RecordInvalidLocked(shard.get(), range);
+        if (shard->index.empty()) {
+            continue;
+        }
+
+        // large discards cover far more blocks than cached
+        if ((last - first + 1) / shards_.size() > shard->index.size()) {
+            for (auto iter = shard->lru.begin(); iter != shard->lru.end();) {
+                auto cur = iter++;
+                if (cur->first >= first && cur->first <= last) {
+                    EraseLocked(shard.get(), cur);
+                    ++dropped;
+                }
+            }
+            continue;
+        }
+
+        for (uint64_t index = first; index <= last; ++index) {
+            if (GetShard(index) != shard.get()) {
+                continue;
+            }
+            auto iter = shard->index.find(index);
+            if (iter != shard->index.end()) {
+                EraseLocked(shard.get(), iter->second);
+                ++dropped;
+            }
+        }
+    }
+
+    metric_->invalidate << dropped;
+}
+
+void BlockCache::InvalidateAll() {
+    uint64_t epoch = epoch_.fetch_add(1, std::memory_order_acq_rel) + 1;
+
+    uint64_t dropped = 0;
+    for (auto& shard : shards_) {
+        std::lock_guard<std::mutex> lk(shard->mtx);
+        while (!shard->invalidated.empty() &&
+               shard->invalidated.front().epoch <= epoch) {
+            shard->invalidated.pop_front();
+        }
+        shard->staleEpoch = std::max(shard->staleEpoch, epoch);
+        dropped += shard->index.size();
+        metric_->cachedBytes << -static_cast<int64_t>(shard->bytes);
+        shard->index.clear();
+        shard->lru.clear();
+        shard->bytes = 0;
+    }
+
+    metric_->invalidate << dropped;
+}
+
+void BlockCache::AlignRange(uint64_t offset, uint64_t length,
+                            uint64_t fileLength, uint64_t* alignedOffset,
+                            uint64_t* alignedLength) const {
+    uint64_t start = offset / blockSize_ * blockSize_;
+    uint64_t end = (offset + length + blockSize_ - 1) / blockSize_ * blockSize_;
+    end = std::max(std::min(end, fileLength), offset + length);
+
+    *alignedOffset = start;
+    *alignedLength = end - start;
+}
+
+uint64_t BlockCache::CachedBytes() const {
+    uint64_t bytes = 0;
+    for (auto& shard : shards_) {
+        std::lock_guard<std::mutex> lk(shard->mtx);
+        bytes += shard->bytes;
+    }
+    return bytes;
+}
+
+void BlockCache::EraseLocked(Shard* shard,
+                             std::list<Shard::Entry>::iterator iter) {
+    shard->index.erase(iter->first);
+    shard->lru.erase(iter);
+    shard->bytes -= blockSize_;
+    metric_->cachedBytes << -static_cast<int64_t>(blockSize_);
+}
+
+bool BlockCache::InvalidatedLocked(const Shard& shard, uint64_t epoch,
+                                   uint64_t index) {
+    if (epoch < shard.staleEpoch) {
+        return true;
+    }
+
+    for (auto iter = shard.invalidated.rbegin();
+         iter != shard.invalidated.rend() && iter->epoch > epoch; ++iter) {
+        if (index >= iter->first && index <= iter->last) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void BlockCache::RecordInvalidLocked(Shard* shard, const InvalidRange& range) {
+    // epochs are taken before the shard lock, so keep them ordered
+    auto pos = shard->invalidated.end();
+    while (pos != shard->invalidated.begin() &&
+           std::prev(pos)->epoch > range.epoch) {
+        --pos;
+    }
+    shard->invalidated.insert(pos, range);
+
+    if (shard->invalidated.size() > kMaxInvalidRanges) {
+        shard->staleEpoch =
+            std::max(shard->staleEpoch, shard->invalidated.front().epoch);
+        shard->invalidated.pop_front();
+    }
+}
+
+}  // namespace client
+}  // namespace curve
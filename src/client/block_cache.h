@@ -0,0 +1,151 @@
+/*
+ *  Copyright (c) 2023 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#ifndef SRC_CLIENT_BLOCK_CACHE_H_
+#define SRC_CLIENT_BLOCK_CACHE_H_
+
+#include <butil/iobuf.h>
+
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <list>
+#include <memory>
+#include <mutex>  // NOLINT
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "src/client/client_metric.h"
+#include "src/client/config_info.h"
+#include "src/common/uncopyable.h"
+
+namespace curve {
+namespace client {
+
+/**
+ * Read cache of one file, data is cached in fixed size blocks and evicted
+ * in lru order. Blocks are spread over several shards by block index, each
+ * shard has its own lock and an equal share of the capacity.
+ *
+ * Only whole blocks are cached, a read is served from cache only when all
+ * the blocks it covers are cached, otherwise the caller reads the block
+ * aligned range from chunkserver and fills it back.
+ *
+ * Every invalidation takes a new epoch and is recorded in the shards it
+ * covers, the caller takes the epoch before issuing a read and passes it
+ * to Fill, blocks overlapped with invalidations after that epoch are not
+ * filled, so a write only discards the in-flight reads of its own range.
+ * Writes should invalidate both when they are issued and when they are
+ * done.
+ */
+class BlockCache : public curve::common::Uncopyable {
+ public:
+    BlockCache(const BlockCacheOption& option, BlockCacheMetric* metric);
+
+    static bool CheckOption(const BlockCacheOption& option);
+
+    uint64_t BlockSize() const {
+        return blockSize_;
+    }
+
+    /**
+     * @brief Read from cache
+     * @param offset file offset
+     * @param length read length
+     * @param[out] data cached data, only valid when return true
+     * @return true if all the data is cached
+     */
+    bool Read(uint64_t offset, uint64_t length, butil::IOBuf* data);
+
+    /**
+     * @brief Current epoch, take it before reading from chunkserver
+     */
+    uint64_t Epoch() const {
+        return epoch_.load(std::memory_order_acquire);
+    }
+
+    /**
+     * @brief Fill data read from chunkserver into cache
+     * @param epoch epoch taken before the read was issued
+     * @param offset file offset, must be aligned to block size
+     * @param data read data, the tail smaller than a block is ignored,
+     *             and so are blocks invalidated after epoch
+     */
+    void Fill(uint64_t epoch, uint64_t offset, const butil::IOBuf& data);
+
+    /**
+     * @brief Drop the cached blocks overlapped with [offset, offset + length)
+     */
+    void Invalidate(uint64_t offset, uint64_t length);
+
+    void InvalidateAll();
+
+    /**
+     * @brief Expand a read to block boundaries
+     * @param fileLength length of file, the aligned range never exceeds it
+     */
+    void AlignRange(uint64_t offset, uint64_t length, uint64_t fileLength,
+                    uint64_t* alignedOffset, uint64_t* alignedLength) const;
+
+    uint64_t CachedBytes() const;
+
+ private:
+    // blocks [first, last] are invalidated at epoch
+    struct InvalidRange {
+        uint64_t epoch;
+        uint64_t first;
+        uint64_t last;
+    };
+
+    struct Shard {
+        using Entry = std::pair<uint64_t, butil::IOBuf>;
+
+        std::mutex mtx;
+        // most recently used at front
+        std::list<Entry> lru;
+        std::unordered_map<uint64_t, std::list<Entry>::iterator> index;
+        uint64_t bytes = 0;
+        // recent invalidations covering this shard in epoch order, fills
+        // older than staleEpoch may race with the dropped ones
+        std::deque<InvalidRange> invalidated;
+        uint64_t staleEpoch = 0;
+    };
+
+    Shard* GetShard(uint64_t blockIndex) {
+        return shards_[blockIndex % shards_.size()].get();
+    }
+
+    void EraseLocked(Shard* shard, std::list<Shard::Entry>::iterator iter);
+
+    // Whether block index is invalidated after epoch
+    static bool InvalidatedLocked(const Shard& shard, uint64_t epoch,
+                                  uint64_t index);
+
+    void RecordInvalidLocked(Shard* shard, const InvalidRange& range);
+
+ private:
+    const uint64_t blockSize_;
+    const uint64_t shardCapacity_;
+    std::vector<std::unique_ptr<Shard>> shards_;
+    std::atomic<uint64_t> epoch_;
+    BlockCacheMetric* metric_;
+};
+
+}  // namespace client
+}  // namespace curve
+
+#endif  // SRC_CLIENT_BLOCK_CACHE_H_
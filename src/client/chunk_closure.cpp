@@ -570,6 +570,87 @@ void GetChunkInfoClosure::OnRedirected() {
     RefreshLeader();
 }
 
+void BatchChunkClosure::OnRedirected() {
+    LOG(WARNING) << OpTypeToString(reqCtx_->optype_)
+        << " batch redirected, " << *reqCtx_
+        << ", batch size = " << reqCtx_->subRequests_.size()
+        << ", status = " << status_
+        << ", retried times = " << reqDone_->GetRetriedTimes()
+        << ", IO id = " << reqDone_->GetIOTracker()->GetID()
+        << ", request id = " << reqCtx_->id_
+        << ", redirect leader is "
+        << (batchResponse_->has_redirect() ? batchResponse_->redirect()
+                                           : "empty")
+        << ", remote side = "
+        << butil::endpoint2str(cntl_->remote_side()).c_str();
+
+    if (batchResponse_->has_redirect()) {
+        int ret = UpdateLeaderWithRedirectInfo(batchResponse_->redirect());
+        if (0 == ret) {
+            return;
+        }
+    }
+
+    RefreshLeader();
+}
+
+CHUNK_OP_STATUS BatchChunkClosure::SubStatus(int index) const {
+    if (index >= batchResponse_->responses_size()) {
+        return CHUNK_OP_STATUS::CHUNK_OP_STATUS_FAILURE_UNKNOWN;
+    }
+    return batchResponse_->responses(index).status();
+}
+
+void WriteChunksClosure::SendRetryRequest() {
+    client_->WriteChunks(reqCtx_->idinfo_, reqCtx_->subRequests_, done_);
+}
+
+void WriteChunksClosure::OnSuccess() {
+    ClientClosure::OnSuccess();
+
+    // 失败的子请求由BatchRequestClosure重新入队单独重试
+    for (size_t i = 0; i < reqCtx_->subRequests_.size(); ++i) {
+        RequestContext* sub = reqCtx_->subRequests_[i];
+        CHUNK_OP_STATUS status = SubStatus(i);
+        sub->done_->SetFailed(
+            status == CHUNK_OP_STATUS::CHUNK_OP_STATUS_SUCCESS ? 0 : status);
+    }
+}
+
+void ReadChunksClosure::SendRetryRequest() {
+    client_->ReadChunks(reqCtx_->idinfo_, reqCtx_->subRequests_, done_);
+}
+
+void ReadChunksClosure::OnSuccess() {
+    ClientClosure::OnSuccess();
+
+    // 成功的子请求读到的数据按顺序拼接在attachment中
+    butil::IOBuf& data = cntl_->response_attachment();
+    for (size_t i = 0; i < reqCtx_->subRequests_.size(); ++i) {
+        RequestContext* sub = reqCtx_->subRequests_[i];
+        CHUNK_OP_STATUS status = SubStatus(i);
+        switch (status) {
+        case CHUNK_OP_STATUS::CHUNK_OP_STATUS_SUCCESS:
+            sub->readData_.clear();
+            if (data.cutn(&sub->readData_, sub->rawlength_) ==
+                sub->rawlength_) {
+                sub->done_->SetFailed(0);
+            } else {
+                sub->done_->SetFailed(
+                    CHUNK_OP_STATUS::CHUNK_OP_STATUS_FAILURE_UNKNOWN);
+            }
+            break;
+        case CHUNK_OP_STATUS::CHUNK_OP_STATUS_CHUNK_NOTEXIST:
+            sub->readData_.clear();
+            sub->readData_.resize(sub->rawlength_, 0);
+            sub->done_->SetFailed(0);
+            break;
+        default:
+            sub->done_->SetFailed(status);
+        }
+    }
+}
+
 void CreateCloneChunkClosure::SendRetryRequest() {
     client_->CreateCloneChunk(reqCtx_->idinfo_,
                               reqCtx_->location_,
@@ -39,6 +39,7 @@
 namespace curve {
 namespace client {
 
+using curve::chunkserver::BatchChunkResponse;
 using curve::chunkserver::CHUNK_OP_STATUS;
 using curve::chunkserver::ChunkResponse;
 using curve::chunkserver::GetChunkInfoResponse;
@@ -292,6 +293,50 @@ class GetChunkInfoClosure : public ClientClosure {
     std::unique_ptr<GetChunkInfoResponse> chunkinforesponse_;
 };
 
+/**
+ * 批量读写rpc的closure，批量请求整体的状态按照普通请求的逻辑处理和重试，
+ * 整体成功时在OnSuccess中为每个子请求设置结果
+ */
+class BatchChunkClosure : public ClientClosure {
+ public:
+    BatchChunkClosure(CopysetClient* client, Closure* done)
+        : ClientClosure(client, done) {}
+
+    void SetResponse(Message* message) override {
+        batchResponse_.reset(static_cast<BatchChunkResponse*>(message));
+    }
+
+    CHUNK_OP_STATUS GetResponseStatus() const override {
+        return batchResponse_->status();
+    }
+
+    void OnRedirected() override;
+
+ protected:
+    // 第index个子请求的返回状态
+    CHUNK_OP_STATUS SubStatus(int index) const;
+
+    std::unique_ptr<BatchChunkResponse> batchResponse_;
+};
+
+class WriteChunksClosure : public BatchChunkClosure {
+ public:
+    WriteChunksClosure(CopysetClient* client, Closure* done)
+        : BatchChunkClosure(client, done) {}
+
+    void OnSuccess() override;
+    void SendRetryRequest() override;
+};
+
+class ReadChunksClosure : public BatchChunkClosure {
+ public:
+    ReadChunksClosure(CopysetClient* client, Closure* done)
+        : BatchChunkClosure(client, done) {}
+
+    void OnSuccess() override;
+    void SendRetryRequest() override;
+};
+
 class CreateCloneChunkClosure : public ClientClosure {
  public:
     CreateCloneChunkClosure(CopysetClient* client, Closure* done)
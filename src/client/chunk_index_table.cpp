@@ -0,0 +1,158 @@
+/*
+ *  Copyright (c) 2023 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include "src/client/chunk_index_table.h"
+
+#include <sched.h>
+
+#include <algorithm>
+
+namespace curve {
+namespace client {
+
+namespace {
+
+const uint32_t kMaxReadSpin = 64;
+
+}  // namespace
+
+const uint32_t ChunkIndexTable::kBlockBits;
+const uint32_t ChunkIndexTable::kDirBits;
+
+ChunkIndexTable::ChunkIndexTable() {
+    for (auto& dir : dirs_) {
+        dir.store(nullptr, std::memory_order_relaxed);
+    }
+}
+
+ChunkIndexTable::~ChunkIndexTable() {
+    for (auto& dir : dirs_) {
+        Directory* directory = dir.load(std::memory_order_relaxed);
+        if (directory == nullptr) {
+            continue;
+        }
+        for (auto& block : directory->blocks) {
+            delete block.load(std::memory_order_relaxed);
+        }
+        delete directory;
+    }
+}
+
+ChunkIndexTable::Block* ChunkIndexTable::FindBlock(ChunkIndex index) const {
+    const uint32_t dirMask = (1u << kDirBits) - 1;
+    Directory* dir =
+        dirs_[index >> (kBlockBits + kDirBits)].load(std::memory_order_acquire);
+    if (dir == nullptr) {
+        return nullptr;
+    }
+    return dir->blocks[(index >> kBlockBits) & dirMask].load(
+        std::memory_order_acquire);
+}
+
+ChunkIndexTable::Block* ChunkIndexTable::GetOrCreateBlock(ChunkIndex index) {
+    const uint32_t dirMask = (1u << kDirBits) - 1;
+    auto& dirSlot = dirs_[index >> (kBlockBits + kDirBits)];
+    Directory* dir = dirSlot.load(std::memory_order_relaxed);
+    if (dir == nullptr) {
+        // value-initialized, all block pointers are null
+        dir = new Directory();
+        dirSlot.store(dir, std::memory_order_release);
+    }
+
+    auto& blockSlot = dir->blocks[(index >> kBlockBits) & dirMask];
+    Block* block = blockSlot.load(std::memory_order_relaxed);
+    if (block == nullptr) {
+        // value-initialized, all entries are empty
+        block = new Block();
+        blockSlot.store(block, std::memory_order_release);
+    }
+    return block;
+}
+
+bool ChunkIndexTable::Get(ChunkIndex index, ChunkIDInfo* info) const {
+    const Block* block = FindBlock(index);
+    if (block == nullptr) {
+        return false;
+    }
+
+    const Entry& entry = block->entries[index & ((1u << kBlockBits) - 1)];
+    uint32_t spin = 0;
+    while (true) {
+        uint32_t seq = entry.seq.load(std::memory_order_acquire);
+        if ((seq & 1) == 0) {
+            uint32_t state = entry.state.load(std::memory_order_relaxed);
+            ChunkID cid = entry.cid.load(std::memory_order_relaxed);
+            LogicPoolID lpid = entry.lpid.load(std::memory_order_relaxed);
+            CopysetID cpid = entry.cpid.load(std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (entry.seq.load(std::memory_order_relaxed) == seq) {
+                if (state == kEmpty) {
+                    return false;
+                }
+                *info = ChunkIDInfo(cid, lpid, cpid);
+                info->chunkExist = (state == kChunkExist);
+                return true;
+            }
+        }
+        // writer is in progress, it holds the entry for a few stores only
+        if (++spin >= kMaxReadSpin) {
+            sched_yield();
+            spin = 0;
+        }
+    }
+}
+
+void ChunkIndexTable::Store(Entry* entry, uint32_t state,
+                            const ChunkIDInfo& info) {
+    uint32_t seq = entry->seq.load(std::memory_order_relaxed);
+    entry->seq.store(seq + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    entry->state.store(state, std::memory_order_relaxed);
+    entry->cid.store(info.cid_, std::memory_order_relaxed);
+    entry->lpid.store(info.lpid_, std::memory_order_relaxed);
+    entry->cpid.store(info.cpid_, std::memory_order_relaxed);
+    entry->seq.store(seq + 2, std::memory_order_release);
+}
+
+void ChunkIndexTable::Set(ChunkIndex index, const ChunkIDInfo& info) {
+    std::lock_guard<std::mutex> lk(mtx_);
+    Block* block = GetOrCreateBlock(index);
+    Store(&block->entries[index & ((1u << kBlockBits) - 1)],
+          info.chunkExist ? kChunkExist : kChunkNotExist, info);
+}
+
+void ChunkIndexTable::Erase(ChunkIndex begin, ChunkIndex end) {
+    const uint64_t blockSize = 1ull << kBlockBits;
+    std::lock_guard<std::mutex> lk(mtx_);
+    uint64_t index = begin;
+    while (index < end) {
+        uint64_t blockEnd = (index / blockSize + 1) * blockSize;
+        uint64_t last = std::min<uint64_t>(blockEnd, end);
+        Block* block = FindBlock(static_cast<ChunkIndex>(index));
+        if (block != nullptr) {
+            for (; index < last; ++index) {
+                Entry* entry = &block->entries[index & (blockSize - 1)];
+                if (entry->state.load(std::memory_order_relaxed) != kEmpty) {
+                    Store(entry, kEmpty, ChunkIDInfo());
+                }
+            }
+        }
+        index = last;
+    }
+}
+
+}  // namespace client
+}  // namespace curve
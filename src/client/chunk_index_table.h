@@ -0,0 +1,100 @@
+/*
+ *  Copyright (c) 2023 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#ifndef SRC_CLIENT_CHUNK_INDEX_TABLE_H_
+#define SRC_CLIENT_CHUNK_INDEX_TABLE_H_
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>  // NOLINT
+
+#include "src/client/client_common.h"
+#include "src/common/uncopyable.h"
+
+namespace curve {
+namespace client {
+
+/**
+ * Chunk index to chunk id info table of one file, entries are addressed
+ * directly by chunk index, which suits the dense chunk indexes of volumes.
+ *
+ * The table is a two level directory of fixed size blocks, a block is
+ * allocated when an entry in it is first set and is never freed before
+ * the table is destroyed, so Get walks the directory without any lock.
+ * Each entry is guarded by a sequence number (seqlock), writers bump it
+ * before and after changing the entry, readers retry when it is odd or
+ * changed while reading. Writers are serialized by a mutex, they are rare
+ * compared to lookups.
+ */
+class ChunkIndexTable : public curve::common::Uncopyable {
+ public:
+    ChunkIndexTable();
+    ~ChunkIndexTable();
+
+    /**
+     * @brief Get chunk id info of chunk index
+     * @return true if found
+     */
+    bool Get(ChunkIndex index, ChunkIDInfo* info) const;
+
+    void Set(ChunkIndex index, const ChunkIDInfo& info);
+
+    /**
+     * @brief Erase entries of chunk index in [begin, end)
+     */
+    void Erase(ChunkIndex begin, ChunkIndex end);
+
+ private:
+    enum State : uint32_t {
+        kEmpty = 0,
+        kChunkExist = 1,
+        kChunkNotExist = 2,
+    };
+
+    struct Entry {
+        std::atomic<uint32_t> seq;
+        std::atomic<uint32_t> state;
+        std::atomic<uint64_t> cid;
+        std::atomic<uint32_t> lpid;
+        std::atomic<uint32_t> cpid;
+    };
+
+    // 10 bits for entry, 11 bits for each directory level
+    static const uint32_t kBlockBits = 10;
+    static const uint32_t kDirBits = 11;
+
+    struct Block {
+        Entry entries[1u << kBlockBits];
+    };
+
+    struct Directory {
+        std::atomic<Block*> blocks[1u << kDirBits];
+    };
+
+    Block* FindBlock(ChunkIndex index) const;
+    Block* GetOrCreateBlock(ChunkIndex index);
+    static void Store(Entry* entry, uint32_t state, const ChunkIDInfo& info);
+
+ private:
+    std::atomic<Directory*> dirs_[1u << kDirBits];
+    // serialize writers
+    std::mutex mtx_;
+};
+
+}  // namespace client
+}  // namespace curve
+
+#endif  // SRC_CLIENT_CHUNK_INDEX_TABLE_H_
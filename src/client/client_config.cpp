@@ -151,6 +151,24 @@ int ClientConfig::Init(const std::string& configpath) {
     LOG_IF(ERROR, ret == false) << "config no schedule.threadpoolSize info";
     RETURN_IF_FALSE(ret);
 
+    ret = conf_.GetUInt32Value("schedule.coalesceMaxKB",
+        &fileServiceOption_.ioOpt.reqSchdulerOpt.coalesceMaxKB);
+    LOG_IF(WARNING, ret == false)
+        << "config no schedule.coalesceMaxKB info, using default value "
+        << fileServiceOption_.ioOpt.reqSchdulerOpt.coalesceMaxKB;
+
+    ret = conf_.GetUInt32Value("schedule.coalesceWindowUs",
+        &fileServiceOption_.ioOpt.reqSchdulerOpt.coalesceWindowUs);
+    LOG_IF(WARNING, ret == false)
+        << "config no schedule.coalesceWindowUs info, using default value "
+        << fileServiceOption_.ioOpt.reqSchdulerOpt.coalesceWindowUs;
+
+    ret = conf_.GetUInt32Value("schedule.batchMaxCount",
+        &fileServiceOption_.ioOpt.reqSchdulerOpt.batchMaxCount);
+    LOG_IF(WARNING, ret == false)
+        << "config no schedule.batchMaxCount info, using default value "
+        << fileServiceOption_.ioOpt.reqSchdulerOpt.batchMaxCount;
+
     ret = conf_.GetUInt32Value("mds.refreshTimesPerLease",
         &fileServiceOption_.leaseOpt.mdsRefreshTimesPerLease);
     LOG_IF(ERROR, ret == false) << "config no mds.refreshTimesPerLease info";
@@ -271,6 +289,42 @@ int ClientConfig::Init(const std::string& configpath) {
     LOG_IF(ERROR, ret == false) << "config no discard.taskDelayMs info";
     RETURN_IF_FALSE(ret);
 
+    BlockCacheOption* blockCacheOpt = &fileServiceOption_.ioOpt.blockCacheOpt;
+    ret = conf_.GetBoolValue("blockcache.enable", &blockCacheOpt->enable);
+    LOG_IF(WARNING, ret == false)
+        << "config no blockcache.enable info, using default value "
+        << blockCacheOpt->enable;
+
+    ret = conf_.GetUInt32Value("blockcache.blockSizeKB",
+                               &blockCacheOpt->blockSizeKB);
+    LOG_IF(WARNING, ret == false)
+        << "config no blockcache.blockSizeKB info, using default value "
+        << blockCacheOpt->blockSizeKB;
+
+    ret = conf_.GetUInt32Value("blockcache.capacityMB",
+                               &blockCacheOpt->capacityMB);
+    LOG_IF(WARNING, ret == false)
+        << "config no blockcache.capacityMB info, using default value "
+        << blockCacheOpt->capacityMB;
+
+    ret = conf_.GetUInt32Value("blockcache.shardNum",
+                               &blockCacheOpt->shardNum);
+    LOG_IF(WARNING, ret == false)
+        << "config no blockcache.shardNum info, using default value "
+        << blockCacheOpt->shardNum;
+
+    ret = conf_.GetBoolValue("blockcache.writeCoalesce",
+                             &blockCacheOpt->writeCoalesce);
+    LOG_IF(WARNING, ret == false)
+        << "config no blockcache.writeCoalesce info, using default value "
+        << blockCacheOpt->writeCoalesce;
+
+    ret = conf_.GetUInt32Value("blockcache.writeCoalesceMaxKB",
+                               &blockCacheOpt->writeCoalesceMaxKB);
+    LOG_IF(WARNING, ret == false)
+        << "config no blockcache.writeCoalesceMaxKB info, using default value "
+        << blockCacheOpt->writeCoalesceMaxKB;
+
     // only client side need these follow 5 options
     ret = conf_.GetUInt32Value("csClientOpt.rpcTimeoutMs",
         &fileServiceOption_.csClientOpt.rpcTimeoutMs);
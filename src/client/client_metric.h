@@ -102,6 +102,28 @@ struct DiscardMetric {
     bvar::Adder<int64_t> pending;
 };
 
+// block cache of a file
+struct BlockCacheMetric {
+    explicit BlockCacheMetric(const std::string& prefix)
+        : hit(prefix, "block_cache_hit"),
+          miss(prefix, "block_cache_miss"),
+          evict(prefix, "block_cache_evict"),
+          invalidate(prefix, "block_cache_invalidate"),
+          cachedBytes(prefix, "block_cache_bytes"),
+          coalescedWrite(prefix, "block_cache_coalesced_write") {}
+
+    // read requests served entirely from cache
+    bvar::Adder<int64_t> hit;
+    bvar::Adder<int64_t> miss;
+    // blocks evicted because of capacity
+    bvar::Adder<int64_t> evict;
+    // blocks dropped by writes, discards and epoch changes
+    bvar::Adder<int64_t> invalidate;
+    bvar::Adder<int64_t> cachedBytes;
+    // user writes merged into a previous write
+    bvar::Adder<int64_t> coalescedWrite;
+};
+
 // 文件级别metric信息统计
 struct FileMetric {
     const std::string prefix = "curve_client";
@@ -135,6 +157,7 @@ struct FileMetric {
     IOSuspendMetric suspendRPCMetric;
 
     DiscardMetric discardMetric;
+    BlockCacheMetric blockCacheMetric;
 
     explicit FileMetric(const std::string& name)
         : filename(name),
@@ -149,7 +172,8 @@ struct FileMetric {
           userDiscard(prefix, filename + "_discard"),
           getLeaderRetryQPS(prefix, filename + "_get_leader_retry_rpc"),
           suspendRPCMetric(prefix, filename + "_suspend_io_num"),
-          discardMetric(prefix + filename) {}
+          discardMetric(prefix + filename),
+          blockCacheMetric(prefix + filename) {}
 };
 
 // 用于全局mds接口统计信息调用信息统计
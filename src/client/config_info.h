@@ -169,10 +169,18 @@ struct IOSenderOption {
  * 线程池，线程池中的线程各自配置一个队列
  * @scheduleQueueCapacity: schedule模块配置的队列深度
  * @scheduleThreadpoolSize: schedule模块线程池大小
+ * @coalesceMaxKB: 队列中同一chunk上相邻的读写请求合并成一个rpc的最大长度，
+ *                 0表示不合并
+ * @coalesceWindowUs: 队列为空时等待后续相邻请求的最长时间
+ * @batchMaxCount: 队列中同一copyset上连续的读写请求通过一个批量rpc发送，
+ *                 一个批量rpc最多包含的请求数，0和1表示不使用批量rpc
  */
 struct RequestScheduleOption {
     uint32_t scheduleQueueCapacity = 1024;
     uint32_t scheduleThreadpoolSize = 2;
+    uint32_t coalesceMaxKB = 0;
+    uint32_t coalesceWindowUs = 0;
+    uint32_t batchMaxCount = 0;
     IOSenderOption ioSenderOpt;
 };
 
@@ -250,6 +258,24 @@ struct ThrottleOption {
     bool enable = false;
 };
 
+/**
+ * per file block cache config
+ * @enable: cache read data in client memory
+ * @blockSizeKB: cache block size, power of 2 in [4, 64] KiB
+ * @capacityMB: memory budget of each file
+ * @shardNum: number of lru shards
+ * @writeCoalesce: merge adjacent small async writes before splitting them
+ * @writeCoalesceMaxKB: max length of a merged write
+ */
+struct BlockCacheOption {
+    bool enable = false;
+    uint32_t blockSizeKB = 16;
+    uint32_t capacityMB = 256;
+    uint32_t shardNum = 16;
+    bool writeCoalesce = false;
+    uint32_t writeCoalesceMaxKB = 1024;
+};
+
 /**
  * IOOption存储了当前io 操作所需要的所有配置信息
  */
@@ -262,6 +288,7 @@ struct IOOption {
     CloseFdThreadOption closeFdThreadOption;
     ThrottleOption throttleOption;
     DiscardOption discardOption;
+    BlockCacheOption blockCacheOpt;
 };
 
 /**
@@ -26,6 +26,7 @@
 #include <unistd.h>
 #include <memory>
 #include <utility>
+#include <vector>
 
 #include "src/client/request_sender.h"
 #include "src/client/metacache.h"
@@ -183,6 +184,68 @@ int CopysetClient::WriteChunk(const ChunkIDInfo& idinfo,
     return DoRPCTask(idinfo, task, doneGuard.release());
 }
 
+int CopysetClient::ReadChunks(const ChunkIDInfo& idinfo,
+                              const std::vector<RequestContext*>& subRequests,
+                              Closure* done) {
+    RequestClosure* reqclosure = static_cast<RequestClosure*>(done);
+    brpc::ClosureGuard doneGuard(done);
+
+    // session过期时的处理与ReadChunk相同
+    if (sessionNotValid_ == true) {
+        if (exitFlag_) {
+            LOG(WARNING) << " return directly for session not valid at exit!"
+                        << ", copyset id = " << idinfo.cpid_
+                        << ", logical pool id = " << idinfo.lpid_
+                        << ", batch size = " << subRequests.size();
+            return 0;
+        } else {
+            LOG(WARNING) << "session not valid, batch read rpc ReSchedule!";
+            doneGuard.release();
+            reqclosure->ReleaseInflightRPCToken();
+            scheduler_->ReSchedule(reqclosure->GetReqCtx());
+            return 0;
+        }
+    }
+
+    auto task = [&](Closure* done, std::shared_ptr<RequestSender> senderPtr) {
+        ReadChunksClosure* readDone = new ReadChunksClosure(this, done);
+        senderPtr->ReadChunks(idinfo, subRequests, readDone);
+    };
+
+    return DoRPCTask(idinfo, task, doneGuard.release());
+}
+
+int CopysetClient::WriteChunks(const ChunkIDInfo& idinfo,
+                               const std::vector<RequestContext*>& subRequests,
+                               Closure* done) {
+    RequestClosure* reqclosure = static_cast<RequestClosure*>(done);
+    brpc::ClosureGuard doneGuard(done);
+
+    // session过期时的处理与WriteChunk相同
+    if (sessionNotValid_ == true) {
+        if (exitFlag_) {
+            LOG(WARNING) << " return directly for session not valid at exit!"
+                        << ", copyset id = " << idinfo.cpid_
+                        << ", logical pool id = " << idinfo.lpid_
+                        << ", batch size = " << subRequests.size();
+            return 0;
+        } else {
+            LOG(WARNING) << "session not valid, batch write rpc ReSchedule!";
+            doneGuard.release();
+            reqclosure->ReleaseInflightRPCToken();
+            scheduler_->ReSchedule(reqclosure->GetReqCtx());
+            return 0;
+        }
+    }
+
+    auto task = [&](Closure* done, std::shared_ptr<RequestSender> senderPtr) {
+        WriteChunksClosure* writeDone = new WriteChunksClosure(this, done);
+        senderPtr->WriteChunks(idinfo, subRequests, writeDone);
+    };
+
+    return DoRPCTask(idinfo, task, doneGuard.release());
+}
+
 int CopysetClient::ReadChunkSnapshot(const ChunkIDInfo& idinfo,
     uint64_t sn, off_t offset, size_t length, Closure *done) {
 
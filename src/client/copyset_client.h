@@ -28,6 +28,7 @@
 
 #include <string>
 #include <memory>
+#include <vector>
 
 #include "include/curve_compiler_specific.h"
 #include "src/client/client_common.h"
@@ -117,6 +118,26 @@ class CopysetClient {
                    const RequestSourceInfo& sourceInfo,
                    Closure *done);
 
+    /**
+     * 批量读同一copyset上的多个chunk区间，通过一个ReadChunks rpc发送
+     * @param idinfo为第一个子请求的id信息，用于获取copyset leader
+     * @param subRequests:各个子请求，它们属于同一个copyset
+     * @param done:批量请求的closure
+     */
+    int ReadChunks(const ChunkIDInfo& idinfo,
+                   const std::vector<RequestContext*>& subRequests,
+                   Closure *done);
+
+    /**
+     * 批量写同一copyset上的多个chunk区间，通过一个WriteChunks rpc发送
+     * @param idinfo为第一个子请求的id信息，用于获取copyset leader
+     * @param subRequests:各个子请求，它们属于同一个copyset
+     * @param done:批量请求的closure
+     */
+    int WriteChunks(const ChunkIDInfo& idinfo,
+                    const std::vector<RequestContext*>& subRequests,
+                    Closure *done);
+
     /**
      * 读Chunk快照文件
      * @param idinfo为chunk相关的id信息
@@ -69,6 +69,11 @@ bool FileInstance::Initialize(const std::string& filename,
         finfo_.userinfo = userinfo;
         finfo_.fullPathName = filename;
 
+        // 只读打开时没有lease，感知不到其他client的写入，不使用block cache
+        if (readonly_) {
+            fileopt_.ioOpt.blockCacheOpt.enable = false;
+        }
+
         if (!iomanager4file_.Initialize(filename, fileopt_.ioOpt,
                                         mdsclient_.get())) {
             LOG(ERROR) << "Init io context manager failed, filename = "
@@ -32,14 +32,60 @@
 
 namespace curve {
 namespace client {
+
+namespace {
+
+// block对齐的异步读，完成之后填充cache并拷贝用户请求的部分
+struct CachedAioRead : public CurveAioContext {
+    CurveAioContext* userCtx;
+    UserDataType dataType;
+    BlockCache* cache;
+    uint64_t epoch;
+    butil::IOBuf data;
+};
+
+bool CopyReadData(const butil::IOBuf& data, size_t pos, CurveAioContext* ctx,
+                  UserDataType dataType) {
+    switch (dataType) {
+        case UserDataType::RawBuffer:
+            return data.copy_to(ctx->buf, ctx->length, pos) == ctx->length;
+        case UserDataType::IOBuffer: {
+            butil::IOBuf* userData = static_cast<butil::IOBuf*>(ctx->buf);
+            userData->clear();
+            return data.append_to(userData, ctx->length, pos) == ctx->length;
+        }
+    }
+    return false;
+}
+
+void CachedAioReadDone(CurveAioContext* ctx) {
+    CachedAioRead* read = static_cast<CachedAioRead*>(ctx);
+    CurveAioContext* userCtx = read->userCtx;
+    if (read->ret < 0) {
+        userCtx->ret = read->ret;
+    } else {
+        read->cache->Fill(read->epoch, read->offset, read->data);
+        bool ok = CopyReadData(read->data, userCtx->offset - read->offset,
+                               userCtx, read->dataType);
+        userCtx->ret = ok ? static_cast<int>(userCtx->length)
+                          : -LIBCURVE_ERROR::FAILED;
+    }
+    delete read;
+    userCtx->cb(userCtx);
+}
+
+}  // namespace
+
 Atomic<uint64_t> IOManager::idRecorder_(1);
-IOManager4File::IOManager4File() : scheduler_(nullptr), exit_(false) {}
+IOManager4File::IOManager4File()
+    : scheduler_(nullptr), exit_(false), mdsclient_(nullptr) {}
 
 bool IOManager4File::Initialize(const std::string& filename,
                                 const IOOption& ioOpt,
                                 MDSClient* mdsclient) {
     ioopt_ = ioOpt;
     disableStripe_ = false;
+    mdsclient_ = mdsclient;
 
     mc_.Init(ioopt_.metaCacheOpt, mdsclient);
 
@@ -87,6 +133,30 @@ bool IOManager4File::Initialize(const std::string& filename,
     discardTaskManager_.reset(
         new DiscardTaskManager(&(fileMetric_->discardMetric)));
 
+    const BlockCacheOption& cacheOpt = ioopt_.blockCacheOpt;
+    if (cacheOpt.enable) {
+        if (!BlockCache::CheckOption(cacheOpt)) {
+            return false;
+        }
+        blockCache_.reset(
+            new BlockCache(cacheOpt, &fileMetric_->blockCacheMetric));
+    }
+
+    // 开启cache时所有异步写都要经过coalescer，写完成时失效cache
+    if (cacheOpt.enable || cacheOpt.writeCoalesce) {
+        uint64_t maxBytes =
+            cacheOpt.writeCoalesce ? cacheOpt.writeCoalesceMaxKB * 1024ull : 0;
+        writeCoalescer_.reset(new WriteCoalescer(
+            maxBytes,
+            [this](CurveAioContext* ctx) {
+                SubmitAioWrite(ctx, mdsclient_, UserDataType::IOBuffer);
+            },
+            [this](uint64_t offset, uint64_t length) {
+                InvalidateCache(offset, length);
+            },
+            fileMetric_));
+    }
+
     LOG(INFO) << "iomanager init success, conf info: "
               << "isolationTaskThreadPoolSize = "
               << ioopt_.taskThreadOpt.isolationTaskThreadPoolSize
@@ -101,6 +171,11 @@ void IOManager4File::UnInitialize() {
         throttle_->Stop();
     }
 
+    // 合并的写需要在task pool停止之前下发
+    if (writeCoalescer_) {
+        writeCoalescer_->WaitIdle();
+    }
+
     bool exitFlag = false;
     std::mutex exitMtx;
     std::condition_variable exitCv;
@@ -133,6 +208,8 @@ void IOManager4File::UnInitialize() {
         std::unique_lock<std::mutex> lk(exitMtx_);
         exit_ = true;
 
+        writeCoalescer_.reset();
+        blockCache_.reset();
         delete scheduler_;
         delete fileMetric_;
         scheduler_ = nullptr;
@@ -145,6 +222,10 @@ int IOManager4File::Read(char* buf, off_t offset,
     MetricHelper::IncremUserRPSCount(fileMetric_, OpType::READ);
     FlightIOGuard guard(this);
 
+    if (blockCache_) {
+        return ReadWithCache(buf, offset, length, mdsclient);
+    }
+
     butil::IOBuf data;
 
     IOTracker temp(this, &mc_, scheduler_, fileMetric_, disableStripe_);
@@ -169,6 +250,8 @@ int IOManager4File::Write(const char* buf,
     MetricHelper::IncremUserRPSCount(fileMetric_, OpType::WRITE);
     FlightIOGuard guard(this);
 
+    InvalidateCache(offset, length);
+
     butil::IOBuf data;
     data.append_user_data(const_cast<char*>(buf), length, TrivialDeleter);
 
@@ -179,6 +262,8 @@ int IOManager4File::Write(const char* buf,
                     throttle_.get());
 
     int rc = temp.Wait();
+    // 写的过程中并发的读可能填充了旧数据
+    InvalidateCache(offset, length);
     return rc;
 }
 
@@ -186,6 +271,15 @@ int IOManager4File::AioRead(CurveAioContext* ctx, MDSClient* mdsclient,
                             UserDataType dataType) {
     MetricHelper::IncremUserRPSCount(fileMetric_, OpType::READ);
 
+    if (blockCache_) {
+        inflightCntl_.IncremInflightNum();
+        auto task = [this, ctx, mdsclient, dataType]() {
+            AioReadWithCache(ctx, mdsclient, dataType);
+        };
+        taskPool_.Enqueue(task);
+        return LIBCURVE_ERROR::OK;
+    }
+
     IOTracker* temp = new (std::nothrow)
         IOTracker(this, &mc_, scheduler_, fileMetric_, disableStripe_);
     if (temp == nullptr) {
@@ -210,13 +304,26 @@ int IOManager4File::AioWrite(CurveAioContext* ctx, MDSClient* mdsclient,
                              UserDataType dataType) {
     MetricHelper::IncremUserRPSCount(fileMetric_, OpType::WRITE);
 
+    if (writeCoalescer_) {
+        InvalidateCache(ctx->offset, ctx->length);
+        writeCoalescer_->Add(ctx, dataType);
+        return LIBCURVE_ERROR::OK;
+    }
+
+    SubmitAioWrite(ctx, mdsclient, dataType);
+    return LIBCURVE_ERROR::OK;
+}
+
+void IOManager4File::SubmitAioWrite(CurveAioContext* ctx,
+                                    MDSClient* mdsclient,
+                                    UserDataType dataType) {
     IOTracker* temp = new (std::nothrow)
         IOTracker(this, &mc_, scheduler_, fileMetric_, disableStripe_);
     if (temp == nullptr) {
         ctx->ret = -LIBCURVE_ERROR::FAILED;
         ctx->cb(ctx);
         LOG(ERROR) << "allocate tracker failed!";
-        return LIBCURVE_ERROR::OK;
+        return;
     }
 
     temp->SetUserDataType(dataType);
@@ -228,7 +335,84 @@ int IOManager4File::AioWrite(CurveAioContext* ctx, MDSClient* mdsclient,
     };
 
     taskPool_.Enqueue(task);
-    return LIBCURVE_ERROR::OK;
+}
+
+int IOManager4File::ReadWithCache(char* buf, off_t offset, size_t length,
+                                  MDSClient* mdsclient) {
+    uint64_t startUs = TimeUtility::GetTimeofDayUs();
+    butil::IOBuf data;
+    if (blockCache_->Read(offset, length, &data)) {
+        data.copy_to(buf, length);
+        MetricHelper::UserLatencyRecord(
+            fileMetric_, TimeUtility::GetTimeofDayUs() - startUs,
+            OpType::READ);
+        MetricHelper::IncremUserQPSCount(fileMetric_, length, OpType::READ);
+        return length;
+    }
+
+    uint64_t alignedOffset = 0;
+    uint64_t alignedLength = 0;
+    blockCache_->AlignRange(offset, length, GetFileInfo()->length,
+                            &alignedOffset, &alignedLength);
+    uint64_t epoch = blockCache_->Epoch();
+
+    IOTracker temp(this, &mc_, scheduler_, fileMetric_, disableStripe_);
+    temp.SetUserDataType(UserDataType::IOBuffer);
+    temp.StartRead(&data, alignedOffset, alignedLength, mdsclient,
+                   this->GetFileInfo(), throttle_.get());
+
+    int rc = temp.Wait();
+    if (rc < 0) {
+        return rc;
+    }
+
+    blockCache_->Fill(epoch, alignedOffset, data);
+    size_t nc = data.copy_to(buf, length, offset - alignedOffset);
+    return nc == length ? static_cast<int>(length) : -LIBCURVE_ERROR::FAILED;
+}
+
+void IOManager4File::AioReadWithCache(CurveAioContext* ctx,
+                                      MDSClient* mdsclient,
+                                      UserDataType dataType) {
+    uint64_t startUs = TimeUtility::GetTimeofDayUs();
+    butil::IOBuf data;
+    if (blockCache_->Read(ctx->offset, ctx->length, &data)) {
+        bool ok = CopyReadData(data, 0, ctx, dataType);
+        MetricHelper::UserLatencyRecord(
+            fileMetric_, TimeUtility::GetTimeofDayUs() - startUs,
+            OpType::READ);
+        MetricHelper::IncremUserQPSCount(fileMetric_, ctx->length,
+                                         OpType::READ);
+        ctx->ret = ok ? static_cast<int>(ctx->length)
+                      : -LIBCURVE_ERROR::FAILED;
+        ctx->cb(ctx);
+        inflightCntl_.DecremInflightNum();
+        return;
+    }
+
+    uint64_t alignedOffset = 0;
+    uint64_t alignedLength = 0;
+    blockCache_->AlignRange(ctx->offset, ctx->length, GetFileInfo()->length,
+                            &alignedOffset, &alignedLength);
+
+    CachedAioRead* read = new CachedAioRead();
+    read->offset = alignedOffset;
+    read->length = alignedLength;
+    read->ret = 0;
+    read->op = LIBCURVE_OP::LIBCURVE_OP_READ;
+    read->cb = CachedAioReadDone;
+    read->buf = &read->data;
+    read->userCtx = ctx;
+    read->dataType = dataType;
+    read->cache = blockCache_.get();
+    read->epoch = blockCache_->Epoch();
+
+    // inflight计数在AioRead中已经增加，由tracker完成时减少
+    IOTracker* temp = new IOTracker(this, &mc_, scheduler_, fileMetric_,
+                                    disableStripe_);
+    temp->SetUserDataType(UserDataType::IOBuffer);
+    temp->StartAioRead(read, mdsclient, this->GetFileInfo(),
+                       throttle_.get());
 }
 
 int IOManager4File::Discard(off_t offset, size_t length, MDSClient* mdsclient) {
@@ -238,6 +422,8 @@ int IOManager4File::Discard(off_t offset, size_t length, MDSClient* mdsclient) {
         return 0;
     }
 
+    // discard之后的数据是未定义的，只在下发时失效cache
+    InvalidateCache(offset, length);
     FlightIOGuard guard(this);
 
     IOTracker tracker(this, &mc_, scheduler_, fileMetric_);
@@ -255,6 +441,8 @@ int IOManager4File::AioDiscard(CurveAioContext* aioctx, MDSClient* mdsclient) {
         return LIBCURVE_ERROR::OK;
     }
 
+    InvalidateCache(aioctx->offset, aioctx->length);
+
     IOTracker* ioTracker =
         new (std::nothrow) IOTracker(this, &mc_, scheduler_, fileMetric_);
 
@@ -279,6 +467,18 @@ void IOManager4File::UpdateFileInfo(const FInfo_t& fi) {
     mc_.UpdateFileInfo(fi);
 }
 
+void IOManager4File::UpdateFileEpoch(const FileEpoch& fEpoch) {
+    const FileEpoch* current = mc_.GetFileEpoch();
+    bool changed = current->fileId != fEpoch.fileId ||
+                   current->epoch != fEpoch.epoch;
+    mc_.UpdateFileEpoch(fEpoch);
+
+    // 文件被重新打开或者被其他client写过，缓存的数据不再可信
+    if (changed && blockCache_) {
+        blockCache_->InvalidateAll();
+    }
+}
+
 void IOManager4File::UpdateFileThrottleParams(
     const common::ReadWriteThrottleParams& params) {
     if (throttle_) {
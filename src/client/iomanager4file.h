@@ -43,6 +43,8 @@
 #include "src/common/concurrent/task_thread_pool.h"
 #include "src/common/throttle.h"
 #include "src/client/discard_task.h"
+#include "src/client/block_cache.h"
+#include "src/client/write_coalescer.h"
 
 namespace curve {
 namespace client {
@@ -181,9 +183,10 @@ class IOManager4File : public IOManager {
         return mc_.GetFileInfo();
     }
 
-    void UpdateFileEpoch(const FileEpoch& fEpoch) {
-        mc_.UpdateFileEpoch(fEpoch);
-    }
+    /**
+     * 更新文件epoch，文件或epoch发生变化时清空block cache
+     */
+    void UpdateFileEpoch(const FileEpoch& fEpoch);
 
     const FileEpoch* GetFileEpoch() const {
         return mc_.GetFileEpoch();
@@ -260,6 +263,22 @@ class IOManager4File : public IOManager {
 
     bool IsNeedDiscard(size_t len) const;
 
+    // 将异步写交给task pool下发，writeCoalescer_合并之后也从这里下发
+    void SubmitAioWrite(CurveAioContext* ctx, MDSClient* mdsclient,
+                        UserDataType dataType);
+
+    // block cache未命中时按block对齐读取，读完之后填充cache
+    int ReadWithCache(char* buf, off_t offset, size_t length,
+                      MDSClient* mdsclient);
+    void AioReadWithCache(CurveAioContext* ctx, MDSClient* mdsclient,
+                          UserDataType dataType);
+
+    void InvalidateCache(off_t offset, size_t length) {
+        if (blockCache_) {
+            blockCache_->Invalidate(offset, length);
+        }
+    }
+
  private:
     // 每个IOManager都有其IO配置，保存在iooption里
     IOOption ioopt_;
@@ -306,6 +325,14 @@ class IOManager4File : public IOManager {
     bool disableStripe_;
 
     std::unique_ptr<DiscardTaskManager> discardTaskManager_;
+
+    MDSClient* mdsclient_;
+
+    // 文件数据读缓存，未开启时为空
+    std::unique_ptr<BlockCache> blockCache_;
+
+    // 开启写合并或者block cache时不为空，写完成时通过它失效cache
+    std::unique_ptr<WriteCoalescer> writeCoalescer_;
 };
 
 }  // namespace client
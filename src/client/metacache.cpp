@@ -55,12 +55,11 @@ void MetaCache::Init(const MetaCacheOption& metaCacheOpt,
     unstableHelper_.Init(metacacheopt_.chunkserverUnstableOption);
 }
 
+const size_t MetaCache::kCopysetShardNum;
+
 MetaCacheErrorType MetaCache::GetChunkInfoByIndex(ChunkIndex chunkidx,
                                                   ChunkIDInfo* chunxinfo) {
-    ReadLockGuard rdlk(rwlock4ChunkInfo_);
-    auto iter = chunkindex2idMap_.find(chunkidx);
-    if (iter != chunkindex2idMap_.end()) {
-        *chunxinfo = iter->second;
+    if (chunkindex2idTable_.Get(chunkidx, chunxinfo)) {
         return MetaCacheErrorType::OK;
     }
     return MetaCacheErrorType::CHUNKINFO_NOT_FOUND;
@@ -68,23 +67,20 @@ MetaCacheErrorType MetaCache::GetChunkInfoByIndex(ChunkIndex chunkidx,
 
 void MetaCache::UpdateChunkInfoByIndex(ChunkIndex cindex,
                                        const ChunkIDInfo& cinfo) {
-    WriteLockGuard wrlk(rwlock4ChunkInfo_);
-    chunkindex2idMap_[cindex] = cinfo;
+    chunkindex2idTable_.Set(cindex, cinfo);
 }
 
 bool MetaCache::IsLeaderMayChange(LogicPoolID logicPoolId,
                                   CopysetID copysetId) {
-    rwlock4ChunkInfo_.RDLock();
-    auto iter = lpcsid2CopsetInfoMap_.find(
-        CalcLogicPoolCopysetID(logicPoolId, copysetId));
-    if (iter == lpcsid2CopsetInfoMap_.end()) {
-        rwlock4ChunkInfo_.Unlock();
+    const auto key = CalcLogicPoolCopysetID(logicPoolId, copysetId);
+    CopysetShard& shard = GetCopysetShard(key);
+
+    ReadLockGuard rdlk(shard.rwlock);
+    auto iter = shard.copysets.find(key);
+    if (iter == shard.copysets.end()) {
         return false;
     }
-
-    bool flag = iter->second.LeaderMayChange();
-    rwlock4ChunkInfo_.Unlock();
-    return flag;
+    return iter->second.LeaderMayChange();
 }
 
 int MetaCache::GetLeader(LogicPoolID logicPoolId,
@@ -95,17 +91,23 @@ int MetaCache::GetLeader(LogicPoolID logicPoolId,
                          FileMetric* fm) {
     const auto key = CalcLogicPoolCopysetID(logicPoolId, copysetId);
 
+    CopysetShard& shard = GetCopysetShard(key);
+
     CopysetInfo<ChunkServerID> targetInfo;
-    rwlock4CopysetInfo_.RDLock();
-    auto iter = lpcsid2CopsetInfoMap_.find(key);
-    if (iter == lpcsid2CopsetInfoMap_.end()) {
-        rwlock4CopysetInfo_.Unlock();
-        LOG(ERROR) << "server list not exist, LogicPoolID = " << logicPoolId
-                   << ", CopysetID = " << copysetId;
-        return -1;
+    {
+        ReadLockGuard rdlk(shard.rwlock);
+        auto iter = shard.copysets.find(key);
+        if (iter == shard.copysets.end()) {
+            LOG(ERROR) << "server list not exist, LogicPoolID = "
+                       << logicPoolId << ", CopysetID = " << copysetId;
+            return -1;
+        }
+        // 不需要刷新leader时直接返回，避免拷贝copyset信息
+        if (!refresh && !iter->second.LeaderMayChange()) {
+            return iter->second.GetLeaderInfo(serverId, serverAddr);
+        }
+        targetInfo = iter->second;
     }
-    targetInfo = iter->second;
-    rwlock4CopysetInfo_.Unlock();
 
     int ret = 0;
     if (refresh || targetInfo.LeaderMayChange()) {
@@ -234,11 +236,12 @@ void MetaCache::UpdateCopysetInfoIfMatchCurrentLeader(
 CopysetInfo<ChunkServerID> MetaCache::GetServerList(LogicPoolID logicPoolId,
                                      CopysetID copysetId) {
     const auto key = CalcLogicPoolCopysetID(logicPoolId, copysetId);
+    CopysetShard& shard = GetCopysetShard(key);
     CopysetInfo<ChunkServerID> ret;
 
-    ReadLockGuard rdlk(rwlock4CopysetInfo_);
-    auto iter = lpcsid2CopsetInfoMap_.find(key);
-    if (iter == lpcsid2CopsetInfoMap_.end()) {
+    ReadLockGuard rdlk(shard.rwlock);
+    auto iter = shard.copysets.find(key);
+    if (iter == shard.copysets.end()) {
         // it's impossible to get here
         return ret;
     }
@@ -254,10 +257,11 @@ int MetaCache::UpdateLeader(LogicPoolID logicPoolId,
                             CopysetID copysetId,
                             const EndPoint& leaderAddr) {
     const auto key = CalcLogicPoolCopysetID(logicPoolId, copysetId);
+    CopysetShard& shard = GetCopysetShard(key);
 
-    ReadLockGuard rdlk(rwlock4CopysetInfo_);
-    auto iter = lpcsid2CopsetInfoMap_.find(key);
-    if (iter == lpcsid2CopsetInfoMap_.end()) {
+    ReadLockGuard rdlk(shard.rwlock);
+    auto iter = shard.copysets.find(key);
+    if (iter == shard.copysets.end()) {
         // it's impossible to get here
         return -1;
     }
@@ -269,8 +273,9 @@ int MetaCache::UpdateLeader(LogicPoolID logicPoolId,
 void MetaCache::UpdateCopysetInfo(LogicPoolID logicPoolid, CopysetID copysetid,
                                   const CopysetInfo<ChunkServerID>& csinfo) {
     const auto key = CalcLogicPoolCopysetID(logicPoolid, copysetid);
-    WriteLockGuard wrlk(rwlock4CopysetInfo_);
-    lpcsid2CopsetInfoMap_[key] = csinfo;
+    CopysetShard& shard = GetCopysetShard(key);
+    WriteLockGuard wrlk(shard.rwlock);
+    shard.copysets[key] = csinfo;
 }
 
 void MetaCache::UpdateChunkInfoByID(ChunkID cid, const ChunkIDInfo& cidinfo) {
@@ -307,11 +312,12 @@ void MetaCache::SetChunkserverUnstable(ChunkServerID csid) {
         }
     }
 
-    ReadLockGuard rdlk(rwlock4CopysetInfo_);
     for (auto it : copysetIDSet) {
         const auto key = CalcLogicPoolCopysetID(it.lpid, it.cpid);
-        auto cpinfo = lpcsid2CopsetInfoMap_.find(key);
-        if (cpinfo != lpcsid2CopsetInfoMap_.end()) {
+        CopysetShard& shard = GetCopysetShard(key);
+        ReadLockGuard rdlk(shard.rwlock);
+        auto cpinfo = shard.copysets.find(key);
+        if (cpinfo != shard.copysets.end()) {
             ChunkServerID leaderid;
             if (cpinfo->second.GetCurrentLeaderID(&leaderid)) {
                 if (leaderid == csid) {
@@ -334,11 +340,12 @@ void MetaCache::AddCopysetIDInfo(ChunkServerID csid,
 
 void MetaCache::UpdateChunkserverCopysetInfo(LogicPoolID lpid,
                                  const CopysetInfo<ChunkServerID>& cpinfo) {
-    ReadLockGuard rdlk(rwlock4CopysetInfo_);
     const auto key = CalcLogicPoolCopysetID(lpid, cpinfo.cpid_);
+    CopysetShard& shard = GetCopysetShard(key);
+    ReadLockGuard rdlk(shard.rwlock);
     // 先获取原来的chunkserver到copyset映射
-    auto previouscpinfo = lpcsid2CopsetInfoMap_.find(key);
-    if (previouscpinfo != lpcsid2CopsetInfoMap_.end()) {
+    auto previouscpinfo = shard.copysets.find(key);
+    if (previouscpinfo != shard.copysets.end()) {
         std::vector<ChunkServerID> newID;
         std::vector<ChunkServerID> changedID;
 
@@ -378,10 +385,11 @@ void MetaCache::UpdateChunkserverCopysetInfo(LogicPoolID lpid,
 
 CopysetInfo<ChunkServerID> MetaCache::GetCopysetinfo(
     LogicPoolID lpid, CopysetID csid) {
-    ReadLockGuard rdlk(rwlock4CopysetInfo_);
     const auto key = CalcLogicPoolCopysetID(lpid, csid);
-    auto cpinfo = lpcsid2CopsetInfoMap_.find(key);
-    if (cpinfo != lpcsid2CopsetInfoMap_.end()) {
+    CopysetShard& shard = GetCopysetShard(key);
+    ReadLockGuard rdlk(shard.rwlock);
+    auto cpinfo = shard.copysets.find(key);
+    if (cpinfo != shard.copysets.end()) {
         return cpinfo->second;
     }
     return CopysetInfo<ChunkServerID>();
@@ -408,17 +416,12 @@ FileSegment* MetaCache::GetFileSegment(SegmentIndex segmentIndex) {
 }
 
 void MetaCache::CleanChunksInSegment(SegmentIndex segmentIndex) {
-    WriteLockGuard lk(rwlock4chunkInfoMap_);
     ChunkIndex beginChunkIndex = static_cast<uint64_t>(segmentIndex) *
                                  fileInfo_.segmentsize / fileInfo_.chunksize;
     ChunkIndex endChunkIndex = static_cast<uint64_t>(segmentIndex + 1) *
                                fileInfo_.segmentsize / fileInfo_.chunksize;
 
-    auto currentIndex = beginChunkIndex;
-    while (currentIndex < endChunkIndex) {
-        chunkindex2idMap_.erase(currentIndex);
-        ++currentIndex;
-    }
+    chunkindex2idTable_.Erase(beginChunkIndex, endChunkIndex);
 }
 
 }   // namespace client
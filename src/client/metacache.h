@@ -26,6 +26,7 @@
 #include <string>
 #include <unordered_map>
 
+#include "src/client/chunk_index_table.h"
 #include "src/client/client_common.h"
 #include "src/client/client_config.h"
 #include "src/client/client_metric.h"
@@ -54,7 +55,6 @@ class MetaCache {
     using ChunkInfoMap = std::unordered_map<ChunkID, ChunkIDInfo>;
     using CopysetInfoMap =
         std::unordered_map<LogicPoolCopysetID, CopysetInfo<ChunkServerID>>;
-    using ChunkIndexInfoMap = std::unordered_map<ChunkIndex, ChunkIDInfo>;
 
     MetaCache() = default;
     virtual ~MetaCache() = default;
@@ -252,6 +252,18 @@ class MetaCache {
                              CopysetInfo<ChunkServerID> *toupdateCopyset,
                              FileMetric *fm = nullptr);
 
+    // copyset信息按key分片，每个分片有自己的读写锁
+    struct CURVE_CACHELINE_ALIGNMENT CopysetShard {
+        RWLock rwlock;
+        CopysetInfoMap copysets;
+    };
+
+    static const size_t kCopysetShardNum = 32;
+
+    CopysetShard& GetCopysetShard(LogicPoolCopysetID key) {
+        return copysetShards_[key % kCopysetShardNum];
+    }
+
     /**
      * 从mds拉去复制组信息，如果当前leader在复制组中
      * 则更新本地缓存，反之则不更新
@@ -267,23 +279,22 @@ class MetaCache {
     MDSClient *mdsclient_;
     MetaCacheOption metacacheopt_;
 
-    // chunkindex到chunkidinfo的映射表
-    CURVE_CACHELINE_ALIGNMENT ChunkIndexInfoMap chunkindex2idMap_;
+    // chunkindex到chunkidinfo的映射表，查询时不加锁
+    ChunkIndexTable chunkindex2idTable_;
 
     CURVE_CACHELINE_ALIGNMENT RWLock rwlock4Segments_;
     CURVE_CACHELINE_ALIGNMENT std::unordered_map<SegmentIndex, FileSegment>
         segments_;  // NOLINT
 
-    // logicalpoolid和copysetid到copysetinfo的映射表
-    CURVE_CACHELINE_ALIGNMENT CopysetInfoMap lpcsid2CopsetInfoMap_;
+    // logicalpoolid和copysetid到copysetinfo的映射表，copysetid在低位，
+    // 同一个逻辑池的copyset均匀分布在各个分片上
+    CopysetShard copysetShards_[kCopysetShardNum];
 
     // chunkid到chunkidinfo的映射表
     CURVE_CACHELINE_ALIGNMENT ChunkInfoMap chunkid2chunkInfoMap_;
 
-    // 三个读写锁分别保护上述三个映射表
+    // 保护chunkid2chunkInfoMap_
     CURVE_CACHELINE_ALIGNMENT RWLock rwlock4chunkInfoMap_;
-    CURVE_CACHELINE_ALIGNMENT RWLock rwlock4ChunkInfo_;
-    CURVE_CACHELINE_ALIGNMENT RWLock rwlock4CopysetInfo_;
 
     // chunkserverCopysetIDMap_存放当前chunkserver到copyset的映射
     // 当rpc closure设置SetChunkserverUnstable时，会设置该chunkserver
@@ -22,9 +22,12 @@
 
 #include "src/client/request_closure.h"
 
+#include <glog/logging.h>
+
 #include "src/client/io_tracker.h"
 #include "src/client/iomanager.h"
 #include "src/client/request_context.h"
+#include "src/client/request_scheduler.h"
 
 namespace curve {
 namespace client {
@@ -49,7 +52,58 @@ void RequestClosure::ReleaseInflightRPCToken() {
     if (ioManager_ != nullptr && ownInflight_) {
         ioManager_->ReleaseInflightRpcToken();
         MetricHelper::DecremInflightRPC(metric_);
+        // 重新入队的请求可能被合并，不会再次获取令牌
+        ownInflight_ = false;
+    }
+}
+
+void MergedRequestClosure::Run() {
+    ReleaseInflightRPCToken();
+    if (IsSuspendRPC()) {
+        MetricHelper::DecremIOSuspendNum(GetMetric());
+    }
+
+    RequestContext* merged = GetReqCtx();
+    int errcode = GetErrorCode();
+    for (RequestContext* sub : merged->subRequests_) {
+        if (errcode == 0 && merged->optype_ == OpType::READ) {
+            merged->readData_.cutn(&sub->readData_, sub->rawlength_);
+        }
+        // 原始请求的Run会回调tracker，之后不能再访问sub
+        sub->done_->SetFailed(errcode);
+        sub->done_->Run();
     }
+
+    merged->done_ = nullptr;
+    delete merged;
+    delete this;
+}
+
+void BatchRequestClosure::Run() {
+    ReleaseInflightRPCToken();
+    if (IsSuspendRPC()) {
+        MetricHelper::DecremIOSuspendNum(GetMetric());
+    }
+
+    RequestContext* batch = GetReqCtx();
+    int errcode = GetErrorCode();
+    for (RequestContext* sub : batch->subRequests_) {
+        if (errcode != 0) {
+            sub->done_->SetFailed(errcode);
+        } else if (sub->done_->GetErrorCode() != 0) {
+            // 子请求的错误码由批量rpc的closure设置
+            sub->unbatched_ = true;
+            if (scheduler_->ReSchedule(sub) == 0) {
+                continue;
+            }
+            LOG(WARNING) << "reschedule sub request of batch failed, " << *sub;
+        }
+        sub->done_->Run();
+    }
+
+    batch->done_ = nullptr;
+    delete batch;
+    delete this;
 }
 
 }  // namespace client
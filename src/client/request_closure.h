@@ -101,6 +101,10 @@ class CURVE_CACHELINE_ALIGNMENT RequestClosure
         ioManager_ = ioManager;
     }
 
+    IOManager* GetIOManager() const {
+        return ioManager_;
+    }
+
     /**
      * @brief 设置当前closure重试次数
      */
@@ -180,6 +184,34 @@ class CURVE_CACHELINE_ALIGNMENT RequestClosure
     uint64_t nextTimeoutMS_ = 0;
 };
 
+/**
+ * scheduler将同一chunk上相邻的读写请求合并成一个请求发送，
+ * 合并请求结束时将结果和读到的数据分发给各个原始请求，然后释放合并请求
+ */
+class MergedRequestClosure : public RequestClosure {
+ public:
+    explicit MergedRequestClosure(RequestContext* reqctx)
+        : RequestClosure(reqctx) {}
+
+    void Run() override;
+};
+
+/**
+ * scheduler将同一copyset上的多个读写请求组成一个批量请求发送，
+ * 批量请求失败时所有子请求失败返回；批量请求成功但是其中某些子请求失败时，
+ * 这些子请求重新入队，按照普通请求单独重试
+ */
+class BatchRequestClosure : public RequestClosure {
+ public:
+    BatchRequestClosure(RequestContext* reqctx, RequestScheduler* scheduler)
+        : RequestClosure(reqctx), scheduler_(scheduler) {}
+
+    void Run() override;
+
+ private:
+    RequestScheduler* scheduler_;
+};
+
 }  // namespace client
 }  // namespace curve
 
@@ -27,6 +27,7 @@
 
 #include <atomic>
 #include <string>
+#include <vector>
 
 #include "src/client/client_common.h"
 #include "src/client/request_closure.h"
@@ -115,6 +116,15 @@ struct CURVE_CACHELINE_ALIGNMENT RequestContext {
     // 当前request context id
     uint64_t            id_ = 0;
 
+    // scheduler合并之后的请求所包含的原始请求，按offset排列，
+    // 批量请求中为同一copyset上的各个请求，按入队顺序排列
+    std::vector<RequestContext*> subRequests_;
+
+    // 是否为scheduler生成的批量请求，通过ReadChunks/WriteChunks发送
+    bool                batch_ = false;
+    // 批量请求中失败的子请求重新入队单独重试，不再参与合并
+    bool                unbatched_ = false;
+
     static RequestContext* NewInitedRequestContext() {
         RequestContext* ctx = new (std::nothrow) RequestContext();
         if (ctx && ctx->Init()) {
@@ -25,9 +25,13 @@
 #include <brpc/closure_guard.h>
 #include <glog/logging.h>
 
+#include <utility>
+#include <vector>
+
 #include "src/client/request_context.h"
 #include "src/client/request_closure.h"
 #include "src/client/chunk_closure.h"
+#include "src/common/timeutility.h"
 
 namespace curve {
 namespace client {
@@ -61,7 +65,10 @@ int RequestScheduler::Init(const RequestScheduleOption& reqSchdulerOpt,
               << "scheduleQueueCapacity = "
               << reqschopt_.scheduleQueueCapacity
               << ", scheduleThreadpoolSize = "
-              << reqschopt_.scheduleThreadpoolSize;
+              << reqschopt_.scheduleThreadpoolSize
+              << ", coalesceMaxKB = " << reqschopt_.coalesceMaxKB
+              << ", coalesceWindowUs = " << reqschopt_.coalesceWindowUs
+              << ", batchMaxCount = " << reqschopt_.batchMaxCount;
     return 0;
 }
 
@@ -148,7 +155,7 @@ void RequestScheduler::Process() {
         BBQItem<RequestContext*> item = queue_.TakeFront();
         if (!item.IsStop()) {
             RequestContext* req = item.Item();
-            ProcessOne(req);
+            ProcessOne(Batch(Coalesce(req)));
         } else {
             /**
              * 一旦遇到stop item，所有线程都可以退出，因为此时
@@ -159,9 +166,155 @@ void RequestScheduler::Process() {
     }
 }
 
+bool RequestScheduler::CanCoalesce(const RequestContext* ctx) const {
+    // 合并过的请求重试时重新入队，不再参与合并
+    return (ctx->optype_ == OpType::READ || ctx->optype_ == OpType::WRITE) &&
+           !ctx->sourceInfo_.IsValid() && ctx->subRequests_.empty() &&
+           !ctx->unbatched_ &&
+           ctx->rawlength_ < reqschopt_.coalesceMaxKB * 1024ull;
+}
+
+RequestContext* RequestScheduler::Coalesce(RequestContext* ctx) {
+    if (reqschopt_.coalesceMaxKB == 0 || !CanCoalesce(ctx)) {
+        return ctx;
+    }
+
+    const uint64_t maxBytes = reqschopt_.coalesceMaxKB * 1024ull;
+    const uint64_t deadline =
+        TimeUtility::GetTimeofDayUs() + reqschopt_.coalesceWindowUs;
+    std::vector<RequestContext*> subs{ctx};
+    uint64_t end = ctx->offset_ + ctx->rawlength_;
+    uint64_t length = ctx->rawlength_;
+
+    auto adjacent = [&](BBQItem<RequestContext*>& item) {
+        if (item.IsStop()) {
+            return false;
+        }
+        RequestContext* next = item.Item();
+        return CanCoalesce(next) &&
+               next->optype_ == ctx->optype_ &&
+               next->idinfo_.lpid_ == ctx->idinfo_.lpid_ &&
+               next->idinfo_.cpid_ == ctx->idinfo_.cpid_ &&
+               next->idinfo_.cid_ == ctx->idinfo_.cid_ &&
+               next->seq_ == ctx->seq_ &&
+               next->fileId_ == ctx->fileId_ &&
+               next->epoch_ == ctx->epoch_ &&
+               static_cast<uint64_t>(next->offset_) == end &&
+               length + next->rawlength_ <= maxBytes;
+    };
+
+    BBQItem<RequestContext*> item(nullptr);
+    while (true) {
+        uint64_t now = TimeUtility::GetTimeofDayUs();
+        uint64_t waitUs = deadline > now ? deadline - now : 0;
+        if (!queue_.TakeFrontIf(adjacent, waitUs, &item)) {
+            break;
+        }
+        RequestContext* next = item.Item();
+        subs.push_back(next);
+        end += next->rawlength_;
+        length += next->rawlength_;
+    }
+
+    if (subs.size() == 1) {
+        return ctx;
+    }
+
+    RequestContext* merged = new RequestContext();
+    merged->idinfo_ = ctx->idinfo_;
+    merged->offset_ = ctx->offset_;
+    merged->optype_ = ctx->optype_;
+    merged->rawlength_ = length;
+    merged->fileId_ = ctx->fileId_;
+    merged->epoch_ = ctx->epoch_;
+    merged->seq_ = ctx->seq_;
+    if (merged->optype_ == OpType::WRITE) {
+        for (RequestContext* sub : subs) {
+            merged->writeData_.append(sub->writeData_);
+        }
+    }
+
+    // tracker只用于日志，metric和inflight令牌与原始请求一致
+    MergedRequestClosure* done = new MergedRequestClosure(merged);
+    done->SetIOTracker(ctx->done_->GetIOTracker());
+    done->SetFileMetric(ctx->done_->GetMetric());
+    done->SetIOManager(ctx->done_->GetIOManager());
+    merged->done_ = done;
+    merged->subRequests_ = std::move(subs);
+    return merged;
+}
+
+bool RequestScheduler::CanBatch(const RequestContext* ctx) const {
+    // 合并过的请求可以作为批量请求的子请求，批量请求重试时不再参与组合
+    return (ctx->optype_ == OpType::READ || ctx->optype_ == OpType::WRITE) &&
+           !ctx->sourceInfo_.IsValid() && !ctx->batch_ && !ctx->unbatched_;
+}
+
+RequestContext* RequestScheduler::Batch(RequestContext* ctx) {
+    if (reqschopt_.batchMaxCount <= 1 || !CanBatch(ctx)) {
+        return ctx;
+    }
+
+    std::vector<RequestContext*> subs{ctx};
+    uint64_t length = ctx->rawlength_;
+
+    // 只取队首已有的请求，不等待
+    auto sameCopyset = [&](BBQItem<RequestContext*>& item) {
+        if (item.IsStop()) {
+            return false;
+        }
+        RequestContext* next = item.Item();
+        return CanBatch(next) &&
+               next->optype_ == ctx->optype_ &&
+               next->idinfo_.lpid_ == ctx->idinfo_.lpid_ &&
+               next->idinfo_.cpid_ == ctx->idinfo_.cpid_;
+    };
+
+    BBQItem<RequestContext*> item(nullptr);
+    while (subs.size() < reqschopt_.batchMaxCount &&
+           queue_.TakeFrontIf(sameCopyset, 0, &item)) {
+        subs.push_back(item.Item());
+        length += item.Item()->rawlength_;
+    }
+
+    if (subs.size() == 1) {
+        return ctx;
+    }
+
+    RequestContext* batch = new RequestContext();
+    batch->idinfo_ = ctx->idinfo_;
+    batch->offset_ = ctx->offset_;
+    batch->optype_ = ctx->optype_;
+    batch->rawlength_ = length;
+    batch->fileId_ = ctx->fileId_;
+    batch->epoch_ = ctx->epoch_;
+    batch->seq_ = ctx->seq_;
+    batch->batch_ = true;
+
+    BatchRequestClosure* done = new BatchRequestClosure(batch, this);
+    done->SetIOTracker(ctx->done_->GetIOTracker());
+    done->SetFileMetric(ctx->done_->GetMetric());
+    done->SetIOManager(ctx->done_->GetIOManager());
+    batch->done_ = done;
+    batch->subRequests_ = std::move(subs);
+    return batch;
+}
+
 void RequestScheduler::ProcessOne(RequestContext* ctx) {
     brpc::ClosureGuard guard(ctx->done_);
 
+    if (ctx->batch_) {
+        ctx->done_->GetInflightRPCToken();
+        if (ctx->optype_ == OpType::READ) {
+            client_.ReadChunks(ctx->idinfo_, ctx->subRequests_,
+                               guard.release());
+        } else {
+            client_.WriteChunks(ctx->idinfo_, ctx->subRequests_,
+                                guard.release());
+        }
+        return;
+    }
+
     switch (ctx->optype_) {
         case OpType::READ:
             ctx->done_->GetInflightRPCToken();
@@ -140,6 +140,22 @@ class RequestScheduler : public Uncopyable {
 
     void ProcessOne(RequestContext* ctx);
 
+    /**
+     * 从队首取出与ctx在同一chunk上相邻的读写请求，合并成一个请求
+     * @return 合并后的请求，没有可以合并的请求时返回ctx
+     */
+    RequestContext* Coalesce(RequestContext* ctx);
+
+    bool CanCoalesce(const RequestContext* ctx) const;
+
+    /**
+     * 从队首取出与ctx在同一copyset上的读写请求，组成一个批量请求
+     * @return 批量请求，没有可以组合的请求时返回ctx
+     */
+    RequestContext* Batch(RequestContext* ctx);
+
+    bool CanBatch(const RequestContext* ctx) const;
+
     void WaitValidSession() {
         // lease续约失败的时候需要阻塞IO直到续约成功
         if (blockIO_.load(std::memory_order_acquire) && blockingQueue_) {
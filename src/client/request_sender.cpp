@@ -24,6 +24,7 @@
 #include <glog/logging.h>
 
 #include <algorithm>
+#include <vector>
 
 #include "proto/chunk.pb.h"
 #include "src/common/timeutility.h"
@@ -33,6 +34,8 @@
 namespace curve {
 namespace client {
 
+using curve::chunkserver::BatchChunkRequest;
+using curve::chunkserver::BatchChunkResponse;
 using curve::chunkserver::ChunkRequest;
 using curve::chunkserver::ChunkResponse;
 using curve::chunkserver::ChunkService_Stub;
@@ -150,6 +153,74 @@ int RequestSender::WriteChunk(const ChunkIDInfo& idinfo,
     return 0;
 }
 
+int RequestSender::ReadChunks(const ChunkIDInfo& idinfo,
+                              const std::vector<RequestContext*>& subRequests,
+                              ClientClosure *done) {
+    brpc::ClosureGuard doneGuard(done);
+    brpc::Controller *cntl = new brpc::Controller();
+    BatchChunkResponse *response = new BatchChunkResponse();
+
+    UpdateRpcRPS(done, OpType::READ);
+    SetRpcStuff(done, cntl, response);
+
+    BatchChunkRequest request;
+    request.set_optype(curve::chunkserver::CHUNK_OP_TYPE::CHUNK_OP_READ);
+    request.set_logicpoolid(idinfo.lpid_);
+    request.set_copysetid(idinfo.cpid_);
+    for (const RequestContext* sub : subRequests) {
+        ChunkRequest* subRequest = request.add_requests();
+        subRequest->set_optype(
+            curve::chunkserver::CHUNK_OP_TYPE::CHUNK_OP_READ);
+        subRequest->set_logicpoolid(sub->idinfo_.lpid_);
+        subRequest->set_copysetid(sub->idinfo_.cpid_);
+        subRequest->set_chunkid(sub->idinfo_.cid_);
+        subRequest->set_offset(sub->offset_);
+        subRequest->set_size(sub->rawlength_);
+    }
+
+    ChunkService_Stub stub(&channel_);
+    stub.ReadChunks(cntl, &request, response, doneGuard.release());
+
+    return 0;
+}
+
+int RequestSender::WriteChunks(const ChunkIDInfo& idinfo,
+                               const std::vector<RequestContext*>& subRequests,
+                               ClientClosure *done) {
+    brpc::ClosureGuard doneGuard(done);
+    brpc::Controller *cntl = new brpc::Controller();
+    BatchChunkResponse *response = new BatchChunkResponse();
+
+    UpdateRpcRPS(done, OpType::WRITE);
+    SetRpcStuff(done, cntl, response);
+
+    BatchChunkRequest request;
+    request.set_optype(curve::chunkserver::CHUNK_OP_TYPE::CHUNK_OP_WRITE);
+    request.set_logicpoolid(idinfo.lpid_);
+    request.set_copysetid(idinfo.cpid_);
+    for (const RequestContext* sub : subRequests) {
+        ChunkRequest* subRequest = request.add_requests();
+        subRequest->set_optype(
+            curve::chunkserver::CHUNK_OP_TYPE::CHUNK_OP_WRITE);
+        subRequest->set_logicpoolid(sub->idinfo_.lpid_);
+        subRequest->set_copysetid(sub->idinfo_.cpid_);
+        subRequest->set_chunkid(sub->idinfo_.cid_);
+        subRequest->set_sn(sub->seq_);
+        subRequest->set_offset(sub->offset_);
+        subRequest->set_size(sub->rawlength_);
+        subRequest->set_fileid(sub->fileId_);
+        if (sub->epoch_ != 0) {
+            subRequest->set_epoch(sub->epoch_);
+        }
+        cntl->request_attachment().append(sub->writeData_);
+    }
+
+    ChunkService_Stub stub(&channel_);
+    stub.WriteChunks(cntl, &request, response, doneGuard.release());
+
+    return 0;
+}
+
 int RequestSender::ReadChunkSnapshot(const ChunkIDInfo& idinfo,
                                      uint64_t sn,
                                      off_t offset,
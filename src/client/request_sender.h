@@ -28,6 +28,7 @@
 #include <butil/iobuf.h>
 
 #include <string>
+#include <vector>
 
 #include "src/client/client_config.h"
 #include "src/client/client_common.h"
@@ -91,6 +92,27 @@ class RequestSender {
                    const RequestSourceInfo& sourceInfo,
                    ClientClosure *done);
 
+    /**
+     * 批量读同一copyset上的多个chunk区间
+     * @param idinfo为第一个子请求的id信息
+     * @param subRequests:各个子请求
+     * @param done:上一层异步回调的closure
+     */
+    int ReadChunks(const ChunkIDInfo& idinfo,
+                   const std::vector<RequestContext*>& subRequests,
+                   ClientClosure *done);
+
+    /**
+     * 批量写同一copyset上的多个chunk区间，各个子请求的数据按顺序拼接在
+     * attachment中
+     * @param idinfo为第一个子请求的id信息
+     * @param subRequests:各个子请求
+     * @param done:上一层异步回调的closure
+     */
+    int WriteChunks(const ChunkIDInfo& idinfo,
+                    const std::vector<RequestContext*>& subRequests,
+                    ClientClosure *done);
+
     /**
      * 读Chunk快照文件
      * @param idinfo为chunk相关的id信息
@@ -0,0 +1,155 @@
+/*
+ *  Copyright (c) 2023 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include "src/client/write_coalescer.h"
+
+#include <utility>
+
+namespace curve {
+namespace client {
+
+WriteCoalescer::WriteCoalescer(uint64_t maxBytes, Submitter submitter,
+                               DoneHook doneHook, FileMetric* metric)
+    : maxBytes_(maxBytes),
+      submitter_(std::move(submitter)),
+      doneHook_(std::move(doneHook)),
+      metric_(metric),
+      inflight_(0),
+      lastEnd_(0),
+      pending_(nullptr) {}
+
+void WriteCoalescer::Add(CurveAioContext* ctx, UserDataType dataType) {
+    uint64_t offset = ctx->offset;
+    uint64_t length = ctx->length;
+    Batch* toSubmit[2] = {nullptr, nullptr};
+
+    {
+        std::lock_guard<std::mutex> lk(mtx_);
+        if (pending_ != nullptr &&
+            pending_->offset + pending_->length == offset &&
+            pending_->length + length <= maxBytes_) {
+            AppendUserData(pending_, ctx, dataType);
+            pending_->length += length;
+            pending_->users.push_back(ctx);
+            return;
+        }
+
+        if (pending_ != nullptr) {
+            toSubmit[0] = pending_;
+            lastEnd_ = pending_->offset + pending_->length;
+            pending_ = nullptr;
+            ++inflight_;
+        }
+
+        Batch* batch = NewBatch(ctx, dataType);
+        if (inflight_ > 0 && offset == lastEnd_ && length < maxBytes_) {
+            // sequential write, wait for more while previous ones inflight
+            pending_ = batch;
+        } else {
+            toSubmit[1] = batch;
+            lastEnd_ = offset + length;
+            ++inflight_;
+        }
+    }
+
+    for (Batch* batch : toSubmit) {
+        if (batch != nullptr) {
+            submitter_(batch);
+        }
+    }
+}
+
+void WriteCoalescer::WaitIdle() {
+    std::unique_lock<std::mutex> lk(mtx_);
+    idleCv_.wait(lk, [this]() { return inflight_ == 0; });
+}
+
+WriteCoalescer::Batch* WriteCoalescer::NewBatch(CurveAioContext* ctx,
+                                                UserDataType dataType) {
+    Batch* batch = new Batch();
+    batch->offset = ctx->offset;
+    batch->length = ctx->length;
+    batch->ret = 0;
+    batch->op = LIBCURVE_OP::LIBCURVE_OP_WRITE;
+    batch->cb = &WriteCoalescer::OnBatchDone;
+    batch->buf = &batch->data;
+    batch->owner = this;
+    AppendUserData(batch, ctx, dataType);
+    batch->users.push_back(ctx);
+    return batch;
+}
+
+void WriteCoalescer::AppendUserData(Batch* batch, CurveAioContext* ctx,
+                                    UserDataType dataType) {
+    switch (dataType) {
+        case UserDataType::RawBuffer:
+            // user buffer is valid until its callback is called
+            batch->data.append_user_data(ctx->buf, ctx->length,
+                                         TrivialDeleter);
+            break;
+        case UserDataType::IOBuffer:
+            batch->data.append(*static_cast<butil::IOBuf*>(ctx->buf));
+            break;
+    }
+}
+
+void WriteCoalescer::OnBatchDone(CurveAioContext* ctx) {
+    Batch* batch = static_cast<Batch*>(ctx);
+    batch->owner->HandleBatchDone(batch);
+}
+
+void WriteCoalescer::HandleBatchDone(Batch* batch) {
+    if (doneHook_) {
+        doneHook_(batch->offset, batch->length);
+    }
+
+    for (CurveAioContext* user : batch->users) {
+        user->ret = batch->ret < 0 ? batch->ret
+                                   : static_cast<int>(user->length);
+        user->cb(user);
+    }
+
+    if (metric_ != nullptr && batch->users.size() > 1) {
+        // the merged write is counted once by io tracker
+        int64_t merged = batch->users.size() - 1;
+        metric_->blockCacheMetric.coalescedWrite << merged;
+        metric_->userWrite.qps.count << merged;
+    }
+    delete batch;
+
+    Batch* next = nullptr;
+    {
+        std::lock_guard<std::mutex> lk(mtx_);
+        --inflight_;
+        if (pending_ != nullptr) {
+            next = pending_;
+            lastEnd_ = pending_->offset + pending_->length;
+            pending_ = nullptr;
+            ++inflight_;
+        }
+        if (inflight_ == 0) {
+            idleCv_.notify_all();
+            return;
+        }
+    }
+
+    if (next != nullptr) {
+        submitter_(next);
+    }
+}
+
+}  // namespace client
+}  // namespace curve
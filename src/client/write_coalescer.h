@@ -0,0 +1,104 @@
+/*
+ *  Copyright (c) 2023 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#ifndef SRC_CLIENT_WRITE_COALESCER_H_
+#define SRC_CLIENT_WRITE_COALESCER_H_
+
+#include <butil/iobuf.h>
+
+#include <condition_variable>  // NOLINT
+#include <cstdint>
+#include <functional>
+#include <mutex>  // NOLINT
+#include <vector>
+
+#include "include/client/libcurve_define.h"
+#include "src/client/client_common.h"
+#include "src/client/client_metric.h"
+#include "src/common/uncopyable.h"
+
+namespace curve {
+namespace client {
+
+/**
+ * Merge adjacent async writes of one file before they are split into
+ * chunk requests.
+ *
+ * A write that continues the last submitted write is held back while
+ * previous writes are still inflight, the following adjacent writes are
+ * appended to it until it reaches maxBytes, it is submitted as soon as
+ * any inflight write is done. Other writes are submitted at once, so
+ * random writes are never delayed, and writes are always submitted in
+ * the order they are added.
+ *
+ * All writes are submitted as IOBuffer, user callbacks are called after
+ * the merged write is done, so nothing is acknowledged before it is
+ * persisted.
+ */
+class WriteCoalescer : public curve::common::Uncopyable {
+ public:
+    // submit a write to chunkservers, data type is always IOBuffer
+    using Submitter = std::function<void(CurveAioContext*)>;
+    // called when a submitted write is done, before user callbacks
+    using DoneHook = std::function<void(uint64_t offset, uint64_t length)>;
+
+    /**
+     * @param maxBytes max length of a merged write, 0 means never merge
+     * @param metric metric of file, can be nullptr
+     */
+    WriteCoalescer(uint64_t maxBytes, Submitter submitter, DoneHook doneHook,
+                   FileMetric* metric);
+
+    void Add(CurveAioContext* ctx, UserDataType dataType);
+
+    /**
+     * @brief Wait until all added writes are done
+     */
+    void WaitIdle();
+
+ private:
+    struct Batch : public CurveAioContext {
+        WriteCoalescer* owner;
+        butil::IOBuf data;
+        std::vector<CurveAioContext*> users;
+    };
+
+    Batch* NewBatch(CurveAioContext* ctx, UserDataType dataType);
+    static void AppendUserData(Batch* batch, CurveAioContext* ctx,
+                               UserDataType dataType);
+    static void OnBatchDone(CurveAioContext* ctx);
+    void HandleBatchDone(Batch* batch);
+
+ private:
+    const uint64_t maxBytes_;
+    Submitter submitter_;
+    DoneHook doneHook_;
+    FileMetric* metric_;
+
+    std::mutex mtx_;
+    std::condition_variable idleCv_;
+    // submitted and not yet done
+    uint64_t inflight_;
+    // end offset of the last submitted write
+    uint64_t lastEnd_;
+    // held back write, only exists while inflight_ > 0
+    Batch* pending_;
+};
+
+}  // namespace client
+}  // namespace curve
+
+#endif  // SRC_CLIENT_WRITE_COALESCER_H_
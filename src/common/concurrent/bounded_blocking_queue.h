@@ -24,6 +24,8 @@
 #define SRC_COMMON_CONCURRENT_BOUNDED_BLOCKING_QUEUE_H_
 
 #include <cassert>
+#include <chrono>               //NOLINT
+#include <cstdint>
 #include <cstdio>
 #include <condition_variable>   //NOLINT
 #include <deque>
@@ -120,6 +122,30 @@ class BoundedBlockingDeque : public Uncopyable {
         return front;
     }
 
+    /**
+     * 队首元素满足pred时取出，队列为空时最多等待timeoutUs
+     * @return 是否取到元素
+     */
+    template <typename Pred>
+    bool TakeFrontIf(Pred pred, uint64_t timeoutUs, T* item) {
+        std::unique_lock<std::mutex> guard(mutex_);
+        if (deque_.empty() && timeoutUs > 0) {
+            notEmpty_.wait_for(guard, std::chrono::microseconds(timeoutUs),
+                               [this]() { return !deque_.empty(); });
+        }
+        if (deque_.empty() || !pred(deque_.front())) {
+            if (!deque_.empty()) {
+                // 可能消耗了其他TakeFront等待者的唤醒
+                notEmpty_.notify_one();
+            }
+            return false;
+        }
+        *item = std::move(deque_.front());
+        deque_.pop_front();
+        notFull_.notify_one();
+        return true;
+    }
+
     T TakeBack() {
         std::unique_lock<std::mutex> guard(mutex_);
         while (deque_.empty()) {
@@ -0,0 +1,354 @@
+/*
+ *  Copyright (c) 2023 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#ifndef SRC_COMMON_CONCURRENT_MPSC_TASK_QUEUE_H_
+#define SRC_COMMON_CONCURRENT_MPSC_TASK_QUEUE_H_
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>  // NOLINT
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>  // NOLINT
+#include <new>
+#include <thread>  // NOLINT
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "include/curve_compiler_specific.h"
+#include "src/common/concurrent/task_queue.h"
+#include "src/common/uncopyable.h"
+
+namespace curve {
+namespace common {
+
+/**
+ * Bounded multi-producer single-consumer task queue.
+ *
+ * Tasks are kept in a ring of slots, each slot carries a sequence number
+ * (Vyukov's bounded queue), so Push only needs a CAS on the tail and the
+ * consumer never takes a lock. Small tasks are constructed in the slot
+ * itself, only tasks larger than kInlineSize are allocated on heap.
+ *
+ * The consumer runs the task in its slot, so the ring has room for at
+ * least |capacity| waiting tasks besides the running one.
+ * Both sides spin for a while before parking on the condition variable,
+ * producers park when the ring is full and the consumer parks when it is
+ * empty, the other side only takes the lock when someone is parked.
+ *
+ * Push may be called from any thread, RunOne must be called from a single
+ * consumer thread.
+ */
+template <typename MutexT, typename CondVarT>
+class GenericMPSCTaskQueue : public Uncopyable {
+ public:
+    static const size_t kInlineSize = 112;
+
+    explicit GenericMPSCTaskQueue(size_t capacity)
+        : mask_(RoundUpPowerOfTwo(capacity + 1) - 1),
+          slots_(mask_ + 1),
+          enqueuePos_(0),
+          dequeuePos_(0),
+          minSpin_(std::thread::hardware_concurrency() > 1 ? kMinSpin : 0),
+          maxSpin_(std::thread::hardware_concurrency() > 1 ? kMaxSpin : 0),
+          spinLimit_(minSpin_),
+          sleeping_(false),
+          waitingProducers_(0) {
+        for (size_t i = 0; i <= mask_; ++i) {
+            slots_[i].seq.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    ~GenericMPSCTaskQueue() {
+        // destroy the tasks that have not been run
+        uint64_t pos = dequeuePos_.load(std::memory_order_relaxed);
+        while (Ready(pos)) {
+            Slot& slot = slots_[pos & mask_];
+            slot.op(&slot.storage, false);
+            ++pos;
+        }
+    }
+
+    template <class F, class... Args>
+    void Push(F&& f, Args&&... args) {
+        auto task = std::bind(std::forward<F>(f), std::forward<Args>(args)...);
+        uint64_t pos = Claim();
+        Slot& slot = slots_[pos & mask_];
+        Construct(&slot, std::move(task));
+        slot.seq.store(pos + 1, std::memory_order_release);
+
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (sleeping_.load(std::memory_order_relaxed)) {
+            std::lock_guard<MutexT> lk(mtx_);
+            notemptycv_.notify_one();
+        }
+    }
+
+    /**
+     * Run the next task, wait if the queue is empty.
+     * Only one thread can call it.
+     */
+    void RunOne() {
+        uint64_t pos = dequeuePos_.load(std::memory_order_relaxed);
+        WaitReady(pos);
+
+        Slot& slot = slots_[pos & mask_];
+        slot.op(&slot.storage, true);
+        dequeuePos_.store(pos + 1, std::memory_order_relaxed);
+        slot.seq.store(pos + mask_ + 1, std::memory_order_release);
+
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (waitingProducers_.load(std::memory_order_relaxed) > 0) {
+            std::lock_guard<MutexT> lk(mtx_);
+            notfullcv_.notify_one();
+        }
+    }
+
+    // number of tasks in queue, including the running one
+    size_t Size() const {
+        uint64_t tail = enqueuePos_.load(std::memory_order_relaxed);
+        uint64_t head = dequeuePos_.load(std::memory_order_relaxed);
+        return tail > head ? tail - head : 0;
+    }
+
+    // max number of tasks in queue, including the running one
+    size_t Capacity() const {
+        return mask_ + 1;
+    }
+
+ private:
+    using Op = void (*)(void* storage, bool run);
+
+    // 128 bytes, two cache lines
+    struct Slot {
+        std::atomic<uint64_t> seq;
+        Op op;
+        typename std::aligned_storage<kInlineSize,
+                                      alignof(std::max_align_t)>::type storage;
+    };
+
+    static const int kMinSpin = 16;
+    static const int kMaxSpin = 4096;
+    static const int kYieldCount = 4;
+
+    static size_t RoundUpPowerOfTwo(size_t n) {
+        size_t size = 1;
+        while (size < n) {
+            size <<= 1;
+        }
+        return size;
+    }
+
+    static void CpuRelax() {
+#if defined(__x86_64__) || defined(__i386__)
+        __asm__ __volatile__("pause");
+#elif defined(__aarch64__)
+        __asm__ __volatile__("yield");
+#endif
+    }
+
+    template <typename T>
+    static void InlineOp(void* storage, bool run) {
+        T* task = static_cast<T*>(storage);
+        if (run) {
+            (*task)();
+        }
+        task->~T();
+    }
+
+    template <typename T>
+    static void HeapOp(void* storage, bool run) {
+        T* task = *static_cast<T**>(storage);
+        if (run) {
+            (*task)();
+        }
+        delete task;
+    }
+
+    template <typename T>
+    static typename std::enable_if<
+        (sizeof(T) <= kInlineSize &&
+         alignof(T) <= alignof(std::max_align_t))>::type
+    Construct(Slot* slot, T&& task) {
+        new (&slot->storage) T(std::move(task));
+        slot->op = &InlineOp<T>;
+    }
+
+    template <typename T>
+    static typename std::enable_if<
+        !(sizeof(T) <= kInlineSize &&
+          alignof(T) <= alignof(std::max_align_t))>::type
+    Construct(Slot* slot, T&& task) {
+        new (&slot->storage) T*(new T(std::move(task)));
+        slot->op = &HeapOp<T>;
+    }
+
+    bool Ready(uint64_t pos) const {
+        return slots_[pos & mask_].seq.load(std::memory_order_acquire) ==
+               pos + 1;
+    }
+
+    bool Full() const {
+        uint64_t pos = enqueuePos_.load(std::memory_order_relaxed);
+        int64_t diff = static_cast<int64_t>(
+            slots_[pos & mask_].seq.load(std::memory_order_acquire) - pos);
+        return diff < 0;
+    }
+
+    // claim a free slot, wait if the ring is full
+    uint64_t Claim() {
+        int rounds = 0;
+        uint64_t pos = enqueuePos_.load(std::memory_order_relaxed);
+        while (true) {
+            const Slot& slot = slots_[pos & mask_];
+            uint64_t seq = slot.seq.load(std::memory_order_acquire);
+            int64_t diff = static_cast<int64_t>(seq - pos);
+            if (diff == 0) {
+                if (enqueuePos_.compare_exchange_weak(
+                        pos, pos + 1, std::memory_order_relaxed)) {
+                    return pos;
+                }
+            } else if (diff < 0) {
+                WaitNotFull(rounds++);
+                pos = enqueuePos_.load(std::memory_order_relaxed);
+            } else {
+                pos = enqueuePos_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    void WaitNotFull(int rounds) {
+        if (rounds < minSpin_) {
+            CpuRelax();
+            return;
+        }
+        if (rounds < minSpin_ + kYieldCount) {
+            std::this_thread::yield();
+            return;
+        }
+
+        std::unique_lock<MutexT> lk(mtx_);
+        waitingProducers_.fetch_add(1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        while (Full()) {
+            notfullcv_.wait(lk);
+        }
+        waitingProducers_.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    // spin for a while and then park until the slot at pos is published,
+    // the spin limit grows when spinning helps and shrinks when it doesn't
+    void WaitReady(uint64_t pos) {
+        for (int i = 0; i < spinLimit_; ++i) {
+            if (Ready(pos)) {
+                spinLimit_ = std::min(spinLimit_ * 2, maxSpin_);
+                return;
+            }
+            CpuRelax();
+        }
+        for (int i = 0; i < kYieldCount; ++i) {
+            if (Ready(pos)) {
+                return;
+            }
+            std::this_thread::yield();
+        }
+
+        spinLimit_ = std::max(spinLimit_ / 2, minSpin_);
+        std::unique_lock<MutexT> lk(mtx_);
+        sleeping_.store(true, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        while (!Ready(pos)) {
+            notemptycv_.wait(lk);
+        }
+        sleeping_.store(false, std::memory_order_relaxed);
+    }
+
+ private:
+    const size_t mask_;
+    std::vector<Slot> slots_;
+    // keep producer and consumer positions on different cache lines,
+    // padding instead of alignas so that the queue can be new'd in C++11
+    char pad0_[CURVE_CACHELINE_SIZE];
+    std::atomic<uint64_t> enqueuePos_;
+    char pad1_[CURVE_CACHELINE_SIZE - sizeof(std::atomic<uint64_t>)];
+    std::atomic<uint64_t> dequeuePos_;
+    // spinning only helps when the other side runs on another cpu
+    const int minSpin_;
+    const int maxSpin_;
+    // only accessed by consumer
+    int spinLimit_;
+    std::atomic<bool> sleeping_;
+    char pad2_[CURVE_CACHELINE_SIZE];
+    std::atomic<int> waitingProducers_;
+    MutexT mtx_;
+    CondVarT notemptycv_;
+    CondVarT notfullcv_;
+};
+
+template <typename MutexT, typename CondVarT>
+const size_t GenericMPSCTaskQueue<MutexT, CondVarT>::kInlineSize;
+
+using MPSCTaskQueue =
+    GenericMPSCTaskQueue<std::mutex, std::condition_variable>;
+
+/**
+ * A worker thread and its task queue, the queue is either a locked
+ * GenericTaskQueue or a lock-free GenericMPSCTaskQueue chosen on
+ * construction. The owner starts |th| to call RunOne in a loop.
+ */
+template <typename MutexT, typename CondVarT>
+struct GenericTaskThread {
+    using TaskQueue = GenericTaskQueue<MutexT, CondVarT>;
+    using LockFreeTaskQueue = GenericMPSCTaskQueue<MutexT, CondVarT>;
+
+    std::thread th;
+    // only one of them is used
+    std::unique_ptr<TaskQueue> tq;
+    std::unique_ptr<LockFreeTaskQueue> mpscq;
+
+    GenericTaskThread(size_t capacity, bool lockfree) {
+        if (lockfree) {
+            mpscq.reset(new LockFreeTaskQueue(capacity));
+        } else {
+            tq.reset(new TaskQueue(capacity));
+        }
+    }
+
+    template <class F, class... Args>
+    void Push(F&& f, Args&&... args) {
+        if (mpscq != nullptr) {
+            mpscq->Push(std::forward<F>(f), std::forward<Args>(args)...);
+        } else {
+            tq->Push(std::forward<F>(f), std::forward<Args>(args)...);
+        }
+    }
+
+    void RunOne() {
+        if (mpscq != nullptr) {
+            mpscq->RunOne();
+        } else {
+            tq->Pop()();
+        }
+    }
+};
+
+}  // namespace common
+}  // namespace curve
+
+#endif  // SRC_COMMON_CONCURRENT_MPSC_TASK_QUEUE_H_
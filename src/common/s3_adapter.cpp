@@ -112,6 +112,15 @@ void InitS3AdaptorOptionExceptS3InfoOption(Configuration* conf,
         LOG(WARNING) << "Not found s3.maxAsyncRequestInflightBytes in conf";
         s3Opt->maxAsyncRequestInflightBytes = 0;
     }
+    if (!conf->GetUInt64Value("s3.transfer.partSize",
+                              &s3Opt->transferOpt.partSize)) {
+        LOG(WARNING) << "Not found s3.transfer.partSize in conf";
+        s3Opt->transferOpt.partSize = 0;
+    }
+    if (!conf->GetUInt32Value("s3.transfer.maxConcurrency",
+                              &s3Opt->transferOpt.maxConcurrency)) {
+        LOG(WARNING) << "Not found s3.transfer.maxConcurrency in conf";
+    }
 }
 
 void S3Adapter::Init(const std::string& path) {
@@ -182,6 +191,8 @@ void S3Adapter::Init(const S3AdapterOption &option) {
         option.maxAsyncRequestInflightBytes == 0
             ? UINT64_MAX
             : option.maxAsyncRequestInflightBytes));
+
+    transferOpt_ = option.transferOpt;
 }
 
 void S3Adapter::Deinit() {
@@ -635,6 +646,64 @@ Aws::S3::Model::CompletedPart S3Adapter::UploadOnePart(
     }
 }
 
+void S3Adapter::UploadOnePartAsync(
+    std::shared_ptr<UploadPartAsyncContext> context) {
+    Aws::S3::Model::UploadPartRequest request;
+    request.SetBucket(bucketName_);
+    request.SetKey(Aws::String{context->key.c_str(), context->key.size()});
+    request.SetUploadId(
+        Aws::String{context->uploadId.c_str(), context->uploadId.size()});
+    request.SetPartNumber(context->partNum);
+    request.SetContentLength(context->bufferSize);
+
+    request.SetBody(Aws::MakeShared<PreallocatedIOStream>(
+        AWS_ALLOCATE_TAG, context->buffer, context->bufferSize));
+
+    auto originCallback = context->cb;
+    auto wrapperCallback =
+        [this,
+         originCallback](const std::shared_ptr<UploadPartAsyncContext>& ctx) {
+            inflightBytesThrottle_->OnComplete(ctx->bufferSize);
+            ctx->cb = originCallback;
+            ctx->cb(ctx);
+        };
+
+    Aws::S3::UploadPartResponseReceivedHandler handler =
+        [](const Aws::S3::S3Client * /*client*/,
+           const Aws::S3::Model::UploadPartRequest & /*request*/,
+           const Aws::S3::Model::UploadPartOutcome &response,
+           const std::shared_ptr<const Aws::Client::AsyncCallerContext>
+               &awsCtx) {
+            std::shared_ptr<UploadPartAsyncContext> ctx =
+                std::const_pointer_cast<UploadPartAsyncContext>(
+                    std::dynamic_pointer_cast<const UploadPartAsyncContext>(
+                        awsCtx));
+
+            LOG_IF(ERROR, !response.IsSuccess())
+                << "UploadOnePartAsync error: "
+                << response.GetError().GetExceptionName()
+                << "message: " << response.GetError().GetMessage()
+                << ", key: " << ctx->key << ", part: " << ctx->partNum;
+
+            if (response.IsSuccess()) {
+                const Aws::String &etag = response.GetResult().GetETag();
+                ctx->etag.assign(etag.c_str(), etag.size());
+                ctx->retCode = 0;
+            } else {
+                ctx->retCode = -1;
+            }
+            ctx->cb(ctx);
+        };
+
+    if (throttle_) {
+        throttle_->Add(false, context->bufferSize);
+    }
+
+    inflightBytesThrottle_->OnStart(context->bufferSize);
+    context->cb = std::move(wrapperCallback);
+    s3Client_->UploadPartAsync(request, handler, context);
+}
+
 int S3Adapter::CompleteMultiUpload(const Aws::String &key,
                 const Aws::String &uploadId,
             const Aws::Vector<Aws::S3::Model::CompletedPart> &cp_v) {
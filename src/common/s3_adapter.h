@@ -64,8 +64,19 @@ namespace common {
 
 struct GetObjectAsyncContext;
 struct PutObjectAsyncContext;
+struct UploadPartAsyncContext;
 class S3Adapter;
 
+/**
+ * 大对象的并发传输配置，见S3TransferEngine
+ */
+struct S3TransferOption {
+    // 大于partSize的对象拆分为多个分片并发传输，0表示不拆分
+    uint64_t partSize = 0;
+    // 同一个endpoint上最多同时进行的分片请求数
+    uint32_t maxConcurrency = 16;
+};
+
 struct S3AdapterOption {
     std::string ak;
     std::string sk;
@@ -89,6 +100,7 @@ struct S3AdapterOption {
     uint64_t bpsReadMB;
     uint64_t bpsWriteMB;
     bool useVirtualAddressing;
+    S3TransferOption transferOpt;
 };
 
 struct S3InfoOption {
@@ -100,6 +112,7 @@ struct S3InfoOption {
     uint64_t blockSize;
     uint64_t chunkSize;
     uint32_t objectPrefix;
+    uint32_t objectCodec;
 };
 
 void InitS3AdaptorOptionExceptS3InfoOption(Configuration *conf,
@@ -139,6 +152,23 @@ struct PutObjectAsyncContext : public Aws::Client::AsyncCallerContext {
     int retCode;
 };
 
+typedef std::function<void(const std::shared_ptr<UploadPartAsyncContext> &)>
+    UploadPartAsyncCallBack;
+
+struct UploadPartAsyncContext : public Aws::Client::AsyncCallerContext {
+    std::string key;
+    std::string uploadId;
+    // 从1开始
+    int partNum;
+    const char *buffer;
+    size_t bufferSize;
+    UploadPartAsyncCallBack cb;
+    int retCode;
+    uint32_t retry;
+    // 上传成功时分片的etag
+    std::string etag;
+};
+
 class S3Adapter {
  public:
     S3Adapter() {
@@ -294,6 +324,12 @@ class S3Adapter {
     virtual Aws::S3::Model::CompletedPart
     UploadOnePart(const Aws::String &key, const Aws::String &uploadId,
                   int partNum, int partSize, const char *buf);
+    /**
+     * 异步上传一个分片
+     * @param context 异步上下文，完成后retCode和etag被设置
+     */
+    virtual void
+    UploadOnePartAsync(std::shared_ptr<UploadPartAsyncContext> context);
     /**
      * 完成分片上传任务
      * @param 对象名
@@ -317,6 +353,10 @@ class S3Adapter {
 
     Aws::Client::ClientConfiguration *GetConfig() { return clientCfg_; }
 
+    const S3TransferOption &GetTransferOption() const {
+        return transferOpt_;
+    }
+
  private:
     class AsyncRequestInflightBytesThrottle {
      public:
@@ -351,6 +391,8 @@ class S3Adapter {
     Throttle *throttle_;
 
     std::unique_ptr<AsyncRequestInflightBytesThrottle> inflightBytesThrottle_;
+
+    S3TransferOption transferOpt_;
 };
 
 class FakeS3Adapter : public S3Adapter {
@@ -401,6 +443,7 @@ class FakeS3Adapter : public S3Adapter {
     GetObjectAsync(std::shared_ptr<GetObjectAsyncContext> context) override {
         memset(context->buf, '1', context->len);
         context->retCode = 0;
+        context->actualLen = context->len;
         context->cb(this, context);
     }
 
@@ -418,6 +461,34 @@ class FakeS3Adapter : public S3Adapter {
         (void)key;
         return true;
     }
+
+    Aws::String MultiUploadInit(const Aws::String &key) override {
+        (void)key;
+        return "fake";
+    }
+
+    void UploadOnePartAsync(
+        std::shared_ptr<UploadPartAsyncContext> context) override {
+        context->retCode = 0;
+        context->etag = "fake";
+        context->cb(context);
+    }
+
+    int CompleteMultiUpload(
+        const Aws::String &key, const Aws::String &uploadId,
+        const Aws::Vector<Aws::S3::Model::CompletedPart> &cp_v) override {
+        (void)key;
+        (void)uploadId;
+        (void)cp_v;
+        return 0;
+    }
+
+    int AbortMultiUpload(const Aws::String &key,
+                         const Aws::String &uploadId) override {
+        (void)key;
+        (void)uploadId;
+        return 0;
+    }
 };
 
 
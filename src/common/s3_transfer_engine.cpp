@@ -0,0 +1,265 @@
+/*
+ *  Copyright (c) 2023 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include "src/common/s3_transfer_engine.h"
+
+#include <glog/logging.h>
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <map>
+#include <mutex>
+
+#include "src/common/concurrent/count_down_event.h"
+
+namespace curve {
+namespace common {
+
+namespace {
+
+// s3要求除最后一个分片外，每个分片不小于5MiB，且分片数不超过10000
+const size_t kMinUploadPartSize = 5 * 1024 * 1024;
+const size_t kMaxUploadPartNum = 10000;
+// 单个分片失败后的重试次数
+const uint32_t kMaxPartRetry = 3;
+
+}  // namespace
+
+/**
+ * 一个endpoint上的并发额度
+ */
+class TransferPermits {
+ public:
+    explicit TransferPermits(uint32_t permits) : permits_(permits) {}
+
+    void Acquire() {
+        std::unique_lock<std::mutex> lk(mtx_);
+        cond_.wait(lk, [this]() { return permits_ > 0; });
+        permits_--;
+    }
+
+    void Release() {
+        std::lock_guard<std::mutex> lk(mtx_);
+        permits_++;
+        cond_.notify_one();
+    }
+
+    // 按endpoint共享，第一个使用该endpoint的engine决定额度
+    static std::shared_ptr<TransferPermits> Get(const std::string &endpoint,
+                                                uint32_t permits) {
+        static std::mutex mtx;
+        static std::map<std::string, std::shared_ptr<TransferPermits>> *
+            registry = new std::map<std::string,
+                                    std::shared_ptr<TransferPermits>>();
+        std::lock_guard<std::mutex> lk(mtx);
+        auto &ret = (*registry)[endpoint];
+        if (ret == nullptr) {
+            ret = std::make_shared<TransferPermits>(std::max(permits, 1u));
+        }
+        return ret;
+    }
+
+ private:
+    std::mutex mtx_;
+    std::condition_variable cond_;
+    uint32_t permits_;
+};
+
+namespace {
+
+struct TransferTracker {
+    explicit TransferTracker(int count) : done(count), failed(0) {}
+
+    CountDownEvent done;
+    std::atomic<int> failed;
+};
+
+}  // namespace
+
+S3TransferEngine::S3TransferEngine(S3Adapter *adapter,
+                                   const S3TransferOption &option)
+    : adapter_(adapter), option_(option),
+      permits_(TransferPermits::Get(adapter->GetS3Endpoint(),
+                                    option.maxConcurrency)) {}
+
+S3TransferEngine::~S3TransferEngine() {}
+
+int S3TransferEngine::GetObject(const std::string &key, char *buf,
+                                off_t offset, size_t len) {
+    const size_t partSize = option_.partSize;
+    if (partSize == 0 || len <= partSize) {
+        return adapter_->GetObject(key, buf, offset, len);
+    }
+
+    const int partNum = (len + partSize - 1) / partSize;
+    auto tracker = std::make_shared<TransferTracker>(partNum);
+    auto permits = permits_;
+    S3Adapter *adapter = adapter_;
+    GetObjectAsyncCallBack cb =
+        [tracker, permits, adapter](
+            const S3Adapter *,
+            const std::shared_ptr<GetObjectAsyncContext> &context) {
+            if (context->retCode != 0 && context->retry < kMaxPartRetry) {
+                context->retry++;
+                LOG(WARNING) << "get object part fail, retry: "
+                             << context->retry << ", key: " << context->key
+                             << ", offset: " << context->offset
+                             << ", len: " << context->len;
+                adapter->GetObjectAsync(context);
+                return;
+            }
+            if (context->retCode != 0) {
+                tracker->failed.fetch_add(1);
+            }
+            permits->Release();
+            tracker->done.Signal();
+        };
+
+    for (size_t partOff = 0; partOff < len; partOff += partSize) {
+        auto context = std::make_shared<GetObjectAsyncContext>();
+        context->key = key;
+        context->buf = buf + partOff;
+        context->offset = offset + partOff;
+        context->len = std::min(partSize, len - partOff);
+        context->cb = cb;
+        context->retCode = 0;
+        context->retry = 0;
+        context->actualLen = 0;
+        permits_->Acquire();
+        adapter_->GetObjectAsync(context);
+    }
+    tracker->done.Wait();
+
+    if (tracker->failed.load() != 0) {
+        LOG(ERROR) << "get object fail, key: " << key << ", offset: "
+                   << offset << ", len: " << len
+                   << ", failed parts: " << tracker->failed.load();
+        return -1;
+    }
+    return 0;
+}
+
+int S3TransferEngine::PutObject(const std::string &key, const char *buf,
+                                size_t len) {
+    const Aws::String awsKey(key.c_str(), key.size());
+    if (option_.partSize == 0 || len <= option_.partSize) {
+        return adapter_->PutObject(awsKey, buf, len);
+    }
+
+    Aws::String awsUploadId = adapter_->MultiUploadInit(awsKey);
+    if (awsUploadId.empty()) {
+        LOG(ERROR) << "put object init multipart upload fail, key: " << key;
+        return -1;
+    }
+    const std::string uploadId(awsUploadId.c_str(), awsUploadId.size());
+
+    const size_t partSize = UploadPartSize(len);
+    std::vector<S3TransferPart> parts;
+    for (size_t partOff = 0; partOff < len; partOff += partSize) {
+        S3TransferPart part;
+        part.partNum = parts.size() + 1;
+        part.buf = buf + partOff;
+        part.len = std::min(partSize, len - partOff);
+        parts.push_back(part);
+    }
+
+    Aws::Vector<Aws::S3::Model::CompletedPart> completed;
+    if (UploadParts(key, uploadId, parts, &completed) != 0) {
+        adapter_->AbortMultiUpload(awsKey, awsUploadId);
+        return -1;
+    }
+    // 失败时CompleteMultiUpload内部会abort
+    return adapter_->CompleteMultiUpload(awsKey, awsUploadId, completed);
+}
+
+int S3TransferEngine::UploadParts(
+    const std::string &key, const std::string &uploadId,
+    const std::vector<S3TransferPart> &parts,
+    Aws::Vector<Aws::S3::Model::CompletedPart> *completed) {
+    if (parts.empty()) {
+        return 0;
+    }
+
+    auto tracker = std::make_shared<TransferTracker>(parts.size());
+    auto permits = permits_;
+    S3Adapter *adapter = adapter_;
+    UploadPartAsyncCallBack cb =
+        [tracker, permits, adapter](
+            const std::shared_ptr<UploadPartAsyncContext> &context) {
+            if (context->retCode != 0 && context->retry < kMaxPartRetry) {
+                context->retry++;
+                LOG(WARNING) << "upload part fail, retry: " << context->retry
+                             << ", key: " << context->key
+                             << ", part: " << context->partNum;
+                adapter->UploadOnePartAsync(context);
+                return;
+            }
+            if (context->retCode != 0) {
+                tracker->failed.fetch_add(1);
+            }
+            permits->Release();
+            tracker->done.Signal();
+        };
+
+    std::vector<std::shared_ptr<UploadPartAsyncContext>> contexts;
+    contexts.reserve(parts.size());
+    for (const auto &part : parts) {
+        auto context = std::make_shared<UploadPartAsyncContext>();
+        context->key = key;
+        context->uploadId = uploadId;
+        context->partNum = part.partNum;
+        context->buffer = part.buf;
+        context->bufferSize = part.len;
+        context->cb = cb;
+        context->retCode = 0;
+        context->retry = 0;
+        contexts.push_back(context);
+        permits_->Acquire();
+        adapter_->UploadOnePartAsync(context);
+    }
+    tracker->done.Wait();
+
+    if (tracker->failed.load() != 0) {
+        LOG(ERROR) << "upload parts fail, key: " << key
+                   << ", uploadId: " << uploadId
+                   << ", failed parts: " << tracker->failed.load();
+        return -1;
+    }
+
+    std::sort(contexts.begin(), contexts.end(),
+              [](const std::shared_ptr<UploadPartAsyncContext> &a,
+                 const std::shared_ptr<UploadPartAsyncContext> &b) {
+                  return a->partNum < b->partNum;
+              });
+    for (const auto &context : contexts) {
+        completed->push_back(
+            Aws::S3::Model::CompletedPart()
+                .WithETag(Aws::String(context->etag.c_str(),
+                                      context->etag.size()))
+                .WithPartNumber(context->partNum));
+    }
+    return 0;
+}
+
+size_t S3TransferEngine::UploadPartSize(size_t len) const {
+    size_t partSize = std::max<size_t>(option_.partSize, kMinUploadPartSize);
+    size_t minPartSize = (len + kMaxUploadPartNum - 1) / kMaxUploadPartNum;
+    return std::max(partSize, minPartSize);
+}
+
+}  // namespace common
+}  // namespace curve
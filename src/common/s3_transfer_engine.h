@@ -0,0 +1,88 @@
+/*
+ *  Copyright (c) 2023 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#ifndef SRC_COMMON_S3_TRANSFER_ENGINE_H_
+#define SRC_COMMON_S3_TRANSFER_ENGINE_H_
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "src/common/s3_adapter.h"
+
+namespace curve {
+namespace common {
+
+class TransferPermits;
+
+struct S3TransferPart {
+    // 分片号，从1开始
+    int partNum;
+    const char *buf;
+    size_t len;
+};
+
+/**
+ * 大对象的并发传输
+ *
+ * 读：按partSize将[offset, offset + len)拆分为多个range GET并发下载，
+ *     每个分片直接写入调用者buf的对应位置，不需要再拼接
+ * 写：按partSize拆分为multipart upload的分片并发上传
+ *
+ * 同一个endpoint上所有engine共享maxConcurrency个并发额度，
+ * 不大于partSize的对象仍走一次请求
+ */
+class S3TransferEngine {
+ public:
+    S3TransferEngine(S3Adapter *adapter, const S3TransferOption &option);
+    ~S3TransferEngine();
+
+    /**
+     * 读取对象的[offset, offset + len)到buf
+     * @return 成功返回0，失败返回-1
+     */
+    int GetObject(const std::string &key, char *buf, off_t offset,
+                  size_t len);
+
+    /**
+     * 写入对象，大对象以multipart upload的方式写入，失败时abort
+     * @return 成功返回0，失败返回-1
+     */
+    int PutObject(const std::string &key, const char *buf, size_t len);
+
+    /**
+     * 在已初始化的multipart upload中并发上传一组分片
+     * @param[out] completed 按分片号排序的上传结果，用于CompleteMultiUpload
+     * @return 全部成功返回0，否则返回-1，由调用者决定是否abort
+     */
+    int UploadParts(const std::string &key, const std::string &uploadId,
+                    const std::vector<S3TransferPart> &parts,
+                    Aws::Vector<Aws::S3::Model::CompletedPart> *completed);
+
+ private:
+    // multipart upload每个分片的大小
+    size_t UploadPartSize(size_t len) const;
+
+ private:
+    S3Adapter *adapter_;
+    S3TransferOption option_;
+    std::shared_ptr<TransferPermits> permits_;
+};
+
+}  // namespace common
+}  // namespace curve
+
+#endif  // SRC_COMMON_S3_TRANSFER_ENGINE_H_
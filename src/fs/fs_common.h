@@ -29,6 +29,8 @@ namespace fs {
 enum class FileSystemType {
     // SFS,
     EXT4,
+    // ext4 with data read/write submitted by io_uring
+    EXT4_IOURING,
 };
 
 struct FileSystemInfo {
@@ -0,0 +1,526 @@
+/*
+ *  Copyright (c) 2023 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include <glog/logging.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#include <limits.h>
+
+#if defined(__has_include)
+#if __has_include(<linux/io_uring.h>)
+#include <linux/io_uring.h>
+#if defined(IORING_FEAT_SINGLE_MMAP) && defined(__NR_io_uring_setup)
+#define CURVE_HAVE_IO_URING 1
+#endif
+#endif
+#endif
+
+#include <algorithm>
+#include <utility>
+
+#include "src/fs/ext4_filesystem_impl.h"
+#include "src/fs/io_uring_filesystem_impl.h"
+
+namespace curve {
+namespace fs {
+
+struct IoUringRequest {
+    bool isRead;
+    int fd;
+    // 读请求的目标buffer，或者写请求的数据
+    char* buf;
+    // IOBuf写请求的数据，已经完成的部分会被pop掉
+    bool useIOBuf;
+    butil::IOBuf data;
+    std::vector<struct iovec> iov;
+    uint64_t offset;
+    int length;
+    // 已经完成的长度
+    int done;
+    int retryTimes;
+    AioCallback cb;
+};
+
+std::shared_ptr<IoUringFileSystemImpl> IoUringFileSystemImpl::self_ = nullptr;
+std::mutex IoUringFileSystemImpl::instanceMutex_;
+
+IoUringFileSystemImpl::IoUringFileSystemImpl(
+    std::shared_ptr<LocalFileSystem> ext4)
+    : ext4_(ext4), ringFd_(-1),
+      sqRing_(nullptr), sqRingSize_(0), sqHead_(nullptr), sqTail_(nullptr),
+      sqMask_(nullptr), sqArray_(nullptr), sqes_(nullptr), sqesSize_(0),
+      cqRing_(nullptr), cqRingSize_(0), cqHead_(nullptr), cqTail_(nullptr),
+      cqMask_(nullptr), cqes_(nullptr), cqEntries_(0),
+      inflight_(0), stopped_(true) {
+    CHECK(ext4_ != nullptr) << "ext4 local fs is null";
+}
+
+IoUringFileSystemImpl::~IoUringFileSystemImpl() {
+    DestroyRing();
+}
+
+std::shared_ptr<IoUringFileSystemImpl> IoUringFileSystemImpl::getInstance() {
+    std::lock_guard<std::mutex> lock(instanceMutex_);
+    if (self_ == nullptr) {
+        self_ = std::make_shared<IoUringFileSystemImpl>(
+            Ext4FileSystemImpl::getInstance());
+    }
+    return self_;
+}
+
+int IoUringFileSystemImpl::Init(const LocalFileSystemOption& option) {
+    int rc = ext4_->Init(option);
+    if (rc != 0) {
+        return rc;
+    }
+    if (IoUringAvailable()) {
+        return 0;
+    }
+    rc = SetupRing(option.ioUringQueueDepth);
+    if (rc != 0) {
+        LOG(WARNING) << "io_uring is not available, fallback to ext4, "
+                     << "error: " << strerror(-rc);
+        return 0;
+    }
+    stopped_.store(false, std::memory_order_release);
+    reaper_ = std::thread(&IoUringFileSystemImpl::ReapLoop, this);
+    LOG(INFO) << "io_uring local filesystem inited, queue depth: "
+              << option.ioUringQueueDepth;
+    return 0;
+}
+
+#ifdef CURVE_HAVE_IO_URING
+
+int IoUringFileSystemImpl::SetupRing(uint32_t queueDepth) {
+    struct io_uring_params params;
+    memset(&params, 0, sizeof(params));
+    int fd = syscall(__NR_io_uring_setup, queueDepth, &params);
+    if (fd < 0) {
+        return -errno;
+    }
+
+    sqRingSize_ = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    cqRingSize_ = params.cq_off.cqes +
+                  params.cq_entries * sizeof(struct io_uring_cqe);
+    bool singleMmap = params.features & IORING_FEAT_SINGLE_MMAP;
+    if (singleMmap) {
+        sqRingSize_ = cqRingSize_ = std::max(sqRingSize_, cqRingSize_);
+    }
+    sqRing_ = mmap(nullptr, sqRingSize_, PROT_READ | PROT_WRITE,
+                   MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING);
+    if (sqRing_ == MAP_FAILED) {
+        int err = errno;
+        sqRing_ = nullptr;
+        ::close(fd);
+        return -err;
+    }
+    if (singleMmap) {
+        cqRing_ = sqRing_;
+    } else {
+        cqRing_ = mmap(nullptr, cqRingSize_, PROT_READ | PROT_WRITE,
+                       MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_CQ_RING);
+        if (cqRing_ == MAP_FAILED) {
+            int err = errno;
+            cqRing_ = nullptr;
+            munmap(sqRing_, sqRingSize_);
+            sqRing_ = nullptr;
+            ::close(fd);
+            return -err;
+        }
+    }
+    sqesSize_ = params.sq_entries * sizeof(struct io_uring_sqe);
+    sqes_ = mmap(nullptr, sqesSize_, PROT_READ | PROT_WRITE,
+                 MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQES);
+    if (sqes_ == MAP_FAILED) {
+        int err = errno;
+        sqes_ = nullptr;
+        if (!singleMmap) {
+            munmap(cqRing_, cqRingSize_);
+        }
+        munmap(sqRing_, sqRingSize_);
+        sqRing_ = cqRing_ = nullptr;
+        ::close(fd);
+        return -err;
+    }
+
+    char* sq = static_cast<char*>(sqRing_);
+    sqHead_ = reinterpret_cast<unsigned*>(sq + params.sq_off.head);
+    sqTail_ = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+    sqMask_ = reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+    sqArray_ = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+    char* cq = static_cast<char*>(cqRing_);
+    cqHead_ = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+    cqTail_ = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+    cqMask_ = reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+    cqes_ = cq + params.cq_off.cqes;
+    // 每个在途请求最多占用一个sqe，sq在每次提交后都会被内核取空
+    cqEntries_ = std::min(params.sq_entries, params.cq_entries);
+    ringFd_ = fd;
+    return 0;
+}
+
+int IoUringFileSystemImpl::Submit(IoUringRequest* req) {
+    unsigned tail = *sqTail_;
+    unsigned head = __atomic_load_n(sqHead_, __ATOMIC_ACQUIRE);
+    CHECK(tail - head < cqEntries_) << "io_uring submission queue overflow";
+    unsigned index = tail & *sqMask_;
+    struct io_uring_sqe* sqe =
+        static_cast<struct io_uring_sqe*>(sqes_) + index;
+    memset(sqe, 0, sizeof(*sqe));
+    sqe->fd = req->fd;
+    sqe->off = req->offset + req->done;
+    sqe->user_data = reinterpret_cast<uint64_t>(req);
+    sqe->opcode = req->isRead ? IORING_OP_READV : IORING_OP_WRITEV;
+    if (!req->useIOBuf) {
+        req->iov.resize(1);
+        req->iov[0].iov_base = req->buf + req->done;
+        req->iov[0].iov_len = req->length - req->done;
+    } else {
+        // 直接引用IOBuf的内存块，不做拷贝
+        size_t blockNum = std::min<size_t>(req->data.backing_block_num(),
+                                           IOV_MAX);
+        req->iov.resize(blockNum);
+        for (size_t i = 0; i < blockNum; ++i) {
+            butil::StringPiece block = req->data.backing_block(i);
+            req->iov[i].iov_base = const_cast<char*>(block.data());
+            req->iov[i].iov_len = block.size();
+        }
+    }
+    sqe->addr = reinterpret_cast<uint64_t>(req->iov.data());
+    sqe->len = req->iov.size();
+    sqArray_[index] = index;
+    __atomic_store_n(sqTail_, tail + 1, __ATOMIC_RELEASE);
+
+    while (true) {
+        int ret = syscall(__NR_io_uring_enter, ringFd_, 1, 0, 0, nullptr, 0);
+        if (ret >= 0) {
+            return 0;
+        }
+        if (errno != EINTR && errno != EAGAIN) {
+            int err = errno;
+            // 内核没有取走sqe，撤销本次提交
+            __atomic_store_n(sqTail_, tail, __ATOMIC_RELEASE);
+            LOG(ERROR) << "io_uring_enter submit failed, fd: " << req->fd
+                       << ", error: " << strerror(err);
+            return -err;
+        }
+    }
+}
+
+void IoUringFileSystemImpl::ReapLoop() {
+    while (!stopped_.load(std::memory_order_acquire)) {
+        int ret = syscall(__NR_io_uring_enter, ringFd_, 0, 1,
+                          IORING_ENTER_GETEVENTS, nullptr, 0);
+        if (ret < 0 && errno != EINTR && errno != EAGAIN) {
+            LOG(ERROR) << "io_uring_enter wait failed, error: "
+                       << strerror(errno);
+        }
+
+        std::vector<std::pair<IoUringRequest*, int>> completed;
+        unsigned head = *cqHead_;
+        unsigned tail = __atomic_load_n(cqTail_, __ATOMIC_ACQUIRE);
+        for (; head != tail; ++head) {
+            struct io_uring_cqe* cqe =
+                static_cast<struct io_uring_cqe*>(cqes_) + (head & *cqMask_);
+            IoUringRequest* req =
+                reinterpret_cast<IoUringRequest*>(cqe->user_data);
+            // user_data为0的是停止时提交的nop
+            if (req != nullptr) {
+                completed.emplace_back(req, cqe->res);
+            }
+        }
+        __atomic_store_n(cqHead_, head, __ATOMIC_RELEASE);
+
+        for (auto& item : completed) {
+            Complete(item.first, item.second);
+        }
+    }
+}
+
+void IoUringFileSystemImpl::Complete(IoUringRequest* req, int res) {
+    bool retry = false;
+    if (res == -EINTR || res == -EAGAIN) {
+        retry = req->retryTimes++ < MAX_RETYR_TIME;
+    } else if (res > 0) {
+        req->done += res;
+        if (req->useIOBuf) {
+            req->data.pop_front(res);
+        }
+        retry = req->done < req->length;
+    }
+    // 读到文件末尾时返回已读到的长度，与pread的语义保持一致
+    if (retry) {
+        std::lock_guard<std::mutex> lock(submitMutex_);
+        int rc = Submit(req);
+        if (rc == 0) {
+            return;
+        }
+        res = rc;
+    }
+
+    int result = res < 0 ? res : req->done;
+    if (res < 0) {
+        LOG(ERROR) << (req->isRead ? "read" : "write")
+                   << " by io_uring failed, fd: " << req->fd
+                   << ", offset: " << req->offset
+                   << ", length: " << req->length
+                   << ", error: " << strerror(-res);
+    }
+    AioCallback cb = std::move(req->cb);
+    delete req;
+    {
+        std::lock_guard<std::mutex> lock(submitMutex_);
+        --inflight_;
+    }
+    // 提交者和DestroyRing都可能在等待
+    submitCond_.notify_all();
+    cb(result);
+}
+
+void IoUringFileSystemImpl::DestroyRing() {
+    if (ringFd_ < 0) {
+        return;
+    }
+    if (!stopped_.load(std::memory_order_acquire)) {
+        // 等在途请求都完成并执行回调，之后关闭ring会丢掉它们
+        std::unique_lock<std::mutex> lock(submitMutex_);
+        submitCond_.wait(lock, [this] { return inflight_ == 0; });
+    }
+    if (!stopped_.exchange(true)) {
+        // 提交一个nop唤醒收割线程
+        std::unique_lock<std::mutex> lock(submitMutex_);
+        unsigned tail = *sqTail_;
+        unsigned index = tail & *sqMask_;
+        struct io_uring_sqe* sqe =
+            static_cast<struct io_uring_sqe*>(sqes_) + index;
+        memset(sqe, 0, sizeof(*sqe));
+        sqe->opcode = IORING_OP_NOP;
+        sqArray_[index] = index;
+        __atomic_store_n(sqTail_, tail + 1, __ATOMIC_RELEASE);
+        syscall(__NR_io_uring_enter, ringFd_, 1, 0, 0, nullptr, 0);
+        lock.unlock();
+        if (reaper_.joinable()) {
+            reaper_.join();
+        }
+    }
+    munmap(sqes_, sqesSize_);
+    if (cqRing_ != sqRing_) {
+        munmap(cqRing_, cqRingSize_);
+    }
+    munmap(sqRing_, sqRingSize_);
+    sqes_ = sqRing_ = cqRing_ = nullptr;
+    ::close(ringFd_);
+    ringFd_ = -1;
+}
+
+#else
+
+int IoUringFileSystemImpl::SetupRing(uint32_t queueDepth) {
+    (void)queueDepth;
+    return -ENOSYS;
+}
+
+int IoUringFileSystemImpl::Submit(IoUringRequest* req) {
+    (void)req;
+    return -ENOSYS;
+}
+
+void IoUringFileSystemImpl::ReapLoop() {}
+
+void IoUringFileSystemImpl::Complete(IoUringRequest* req, int res) {
+    (void)req;
+    (void)res;
+}
+
+void IoUringFileSystemImpl::DestroyRing() {}
+
+#endif  // CURVE_HAVE_IO_URING
+
+int IoUringFileSystemImpl::SubmitNew(IoUringRequest* req) {
+    req->done = 0;
+    req->retryTimes = 0;
+    std::unique_lock<std::mutex> lock(submitMutex_);
+    if (inflight_ >= cqEntries_ &&
+        std::this_thread::get_id() == reaper_.get_id()) {
+        // 回调中提交的请求，只有收割线程自己能让在途请求数减少，
+        // 不能等待，改为同步执行
+        lock.unlock();
+        return RunByExt4(req);
+    }
+    submitCond_.wait(lock, [this] { return inflight_ < cqEntries_; });
+    int rc = Submit(req);
+    if (rc != 0) {
+        delete req;
+        return rc;
+    }
+    ++inflight_;
+    return 0;
+}
+
+int IoUringFileSystemImpl::RunByExt4(IoUringRequest* req) {
+    int rc;
+    if (req->isRead) {
+        rc = ext4_->ReadAsync(req->fd, req->buf, req->offset, req->length,
+                              std::move(req->cb));
+    } else if (req->useIOBuf) {
+        rc = ext4_->WriteAsync(req->fd, req->data, req->offset, req->length,
+                               std::move(req->cb));
+    } else {
+        rc = ext4_->WriteAsync(req->fd, req->buf, req->offset, req->length,
+                               std::move(req->cb));
+    }
+    delete req;
+    return rc;
+}
+
+int IoUringFileSystemImpl::ReadAsync(int fd, char* buf, uint64_t offset,
+                                     int length, AioCallback cb) {
+    if (!IoUringAvailable() || length <= 0) {
+        return ext4_->ReadAsync(fd, buf, offset, length, std::move(cb));
+    }
+    IoUringRequest* req = new IoUringRequest();
+    req->isRead = true;
+    req->fd = fd;
+    req->buf = buf;
+    req->useIOBuf = false;
+    req->offset = offset;
+    req->length = length;
+    req->cb = std::move(cb);
+    return SubmitNew(req);
+}
+
+int IoUringFileSystemImpl::WriteAsync(int fd, const char* buf,
+                                      uint64_t offset, int length,
+                                      AioCallback cb) {
+    if (!IoUringAvailable() || length <= 0) {
+        return ext4_->WriteAsync(fd, buf, offset, length, std::move(cb));
+    }
+    IoUringRequest* req = new IoUringRequest();
+    req->isRead = false;
+    req->fd = fd;
+    req->buf = const_cast<char*>(buf);
+    req->useIOBuf = false;
+    req->offset = offset;
+    req->length = length;
+    req->cb = std::move(cb);
+    return SubmitNew(req);
+}
+
+int IoUringFileSystemImpl::WriteAsync(int fd, const butil::IOBuf& buf,
+                                      uint64_t offset, int length,
+                                      AioCallback cb) {
+    if (length != static_cast<int>(buf.size())) {
+        LOG(ERROR) << "WriteAsync failed, fd: " << fd
+                   << ", data size doesn't equal to length, data size: "
+                   << buf.size() << ", length: " << length;
+        return -EINVAL;
+    }
+    if (!IoUringAvailable() || length <= 0) {
+        return ext4_->WriteAsync(fd, buf, offset, length, std::move(cb));
+    }
+    IoUringRequest* req = new IoUringRequest();
+    req->isRead = false;
+    req->fd = fd;
+    req->buf = nullptr;
+    req->useIOBuf = true;
+    req->data = buf;
+    req->offset = offset;
+    req->length = length;
+    req->cb = std::move(cb);
+    return SubmitNew(req);
+}
+
+int IoUringFileSystemImpl::Statfs(const string& path,
+                                  struct FileSystemInfo* info) {
+    return ext4_->Statfs(path, info);
+}
+
+int IoUringFileSystemImpl::Open(const string& path, int flags) {
+    return ext4_->Open(path, flags);
+}
+
+int IoUringFileSystemImpl::Close(int fd) {
+    return ext4_->Close(fd);
+}
+
+int IoUringFileSystemImpl::Delete(const string& path) {
+    return ext4_->Delete(path);
+}
+
+int IoUringFileSystemImpl::Mkdir(const string& dirPath) {
+    return ext4_->Mkdir(dirPath);
+}
+
+bool IoUringFileSystemImpl::DirExists(const string& dirPath) {
+    return ext4_->DirExists(dirPath);
+}
+
+bool IoUringFileSystemImpl::FileExists(const string& filePath) {
+    return ext4_->FileExists(filePath);
+}
+
+int IoUringFileSystemImpl::DoRename(const string& oldPath,
+                                    const string& newPath,
+                                    unsigned int flags) {
+    return ext4_->Rename(oldPath, newPath, flags);
+}
+
+int IoUringFileSystemImpl::List(const string& dirPath,
+                                vector<std::string>* names) {
+    return ext4_->List(dirPath, names);
+}
+
+// 单个同步IO走pread/pwrite的开销更小，只有异步接口走io_uring
+int IoUringFileSystemImpl::Read(int fd, char* buf, uint64_t offset,
+                                int length) {
+    return ext4_->Read(fd, buf, offset, length);
+}
+
+int IoUringFileSystemImpl::Write(int fd, const char* buf, uint64_t offset,
+                                 int length) {
+    return ext4_->Write(fd, buf, offset, length);
+}
+
+int IoUringFileSystemImpl::Write(int fd, butil::IOBuf buf, uint64_t offset,
+                                 int length) {
+    return ext4_->Write(fd, buf, offset, length);
+}
+
+int IoUringFileSystemImpl::Sync(int fd) {
+    return ext4_->Sync(fd);
+}
+
+int IoUringFileSystemImpl::Append(int fd, const char* buf, int length) {
+    return ext4_->Append(fd, buf, length);
+}
+
+int IoUringFileSystemImpl::Fallocate(int fd, int op, uint64_t offset,
+                                     int length) {
+    return ext4_->Fallocate(fd, op, offset, length);
+}
+
+int IoUringFileSystemImpl::Fstat(int fd, struct stat* info) {
+    return ext4_->Fstat(fd, info);
+}
+
+int IoUringFileSystemImpl::Fsync(int fd) {
+    return ext4_->Fsync(fd);
+}
+
+}  // namespace fs
+}  // namespace curve
@@ -0,0 +1,137 @@
+/*
+ *  Copyright (c) 2023 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#ifndef SRC_FS_IO_URING_FILESYSTEM_IMPL_H_
+#define SRC_FS_IO_URING_FILESYSTEM_IMPL_H_
+
+#include <butil/iobuf.h>
+
+#include <atomic>
+#include <condition_variable>  // NOLINT
+#include <memory>
+#include <mutex>  // NOLINT
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "src/fs/local_filesystem.h"
+
+namespace curve {
+namespace fs {
+
+struct IoUringRequest;
+
+/**
+ * 基于io_uring的本地文件系统
+ * 元数据操作以及同步读写直接交给ext4实现，ReadAsync/WriteAsync通过
+ * io_uring提交，由单独的线程收割完成事件并执行回调，这样一个调用线程
+ * 可以同时有多个IO在盘上。
+ * 回调在收割线程中执行，回调里不能再同步等待其他异步IO完成，
+ * 回调里提交新的请求时如果队列已满会同步执行。
+ * 析构时会等待在途请求完成并执行回调。
+ * 如果内核不支持io_uring，Init时会退化为ext4的实现。
+ */
+class IoUringFileSystemImpl : public LocalFileSystem {
+ public:
+    explicit IoUringFileSystemImpl(std::shared_ptr<LocalFileSystem> ext4);
+    ~IoUringFileSystemImpl() override;
+    static std::shared_ptr<IoUringFileSystemImpl> getInstance();
+
+    int Init(const LocalFileSystemOption& option) override;
+    int Statfs(const string& path, struct FileSystemInfo* info) override;
+    int Open(const string& path, int flags) override;
+    int Close(int fd) override;
+    int Delete(const string& path) override;
+    int Mkdir(const string& dirPath) override;
+    bool DirExists(const string& dirPath) override;
+    bool FileExists(const string& filePath) override;
+    int List(const string& dirPath, vector<std::string>* names) override;
+    int Read(int fd, char* buf, uint64_t offset, int length) override;
+    int Write(int fd, const char* buf, uint64_t offset, int length) override;
+    int Write(int fd, butil::IOBuf buf, uint64_t offset, int length) override;
+    int ReadAsync(int fd, char* buf, uint64_t offset, int length,
+                  AioCallback cb) override;
+    int WriteAsync(int fd, const char* buf, uint64_t offset, int length,
+                   AioCallback cb) override;
+    int WriteAsync(int fd, const butil::IOBuf& buf, uint64_t offset,
+                   int length, AioCallback cb) override;
+    int Sync(int fd) override;
+    int Append(int fd, const char* buf, int length) override;
+    int Fallocate(int fd, int op, uint64_t offset, int length) override;
+    int Fstat(int fd, struct stat* info) override;
+    int Fsync(int fd) override;
+
+    /**
+     * io_uring是否可用，不可用时所有接口都走ext4实现
+     */
+    bool IoUringAvailable() const {
+        return ringFd_ >= 0;
+    }
+
+ private:
+    int DoRename(const string& oldPath,
+                 const string& newPath,
+                 unsigned int flags) override;
+    int SetupRing(uint32_t queueDepth);
+    void DestroyRing();
+    // 等待在途请求数低于队列深度后提交，失败时释放请求
+    int SubmitNew(IoUringRequest* req);
+    // 交给ext4同步执行并释放请求
+    int RunByExt4(IoUringRequest* req);
+    // 将请求的剩余部分放入提交队列并通知内核，调用者需持有submitMutex_
+    int Submit(IoUringRequest* req);
+    // 收割完成事件，短读短写会重新提交剩余部分
+    void ReapLoop();
+    void Complete(IoUringRequest* req, int res);
+
+ private:
+    static std::shared_ptr<IoUringFileSystemImpl> self_;
+    static std::mutex instanceMutex_;
+
+    std::shared_ptr<LocalFileSystem> ext4_;
+
+    int ringFd_;
+    // 提交队列
+    void* sqRing_;
+    size_t sqRingSize_;
+    unsigned* sqHead_;
+    unsigned* sqTail_;
+    unsigned* sqMask_;
+    unsigned* sqArray_;
+    void* sqes_;
+    size_t sqesSize_;
+    // 完成队列
+    void* cqRing_;
+    size_t cqRingSize_;
+    unsigned* cqHead_;
+    unsigned* cqTail_;
+    unsigned* cqMask_;
+    void* cqes_;
+    unsigned cqEntries_;
+
+    // 保护提交队列，同时限制在途请求数不超过完成队列的容量
+    std::mutex submitMutex_;
+    std::condition_variable submitCond_;
+    unsigned inflight_;
+
+    std::atomic<bool> stopped_;
+    std::thread reaper_;
+};
+
+}  // namespace fs
+}  // namespace curve
+
+#endif  // SRC_FS_IO_URING_FILESYSTEM_IMPL_H_
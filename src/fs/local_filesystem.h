@@ -32,6 +32,7 @@
 #include <map>
 #include <string>
 #include <cstring>
+#include <functional>
 #include <mutex>  // NOLINT
 
 #include "src/fs/fs_common.h"
@@ -45,9 +46,17 @@ namespace fs {
 
 struct LocalFileSystemOption {
     bool enableRenameat2;
-    LocalFileSystemOption() : enableRenameat2(false) {}
+    // queue depth of io_uring, only used by FileSystemType::EXT4_IOURING
+    uint32_t ioUringQueueDepth;
+    LocalFileSystemOption() : enableRenameat2(false), ioUringQueueDepth(128) {}
 };
 
+/**
+ * 异步IO完成时的回调
+ * @param result: 成功返回读写的数据长度，失败返回-errno
+ */
+using AioCallback = std::function<void(int result)>;
+
 class LocalFileSystem {
  public:
      LocalFileSystem() {}
@@ -171,6 +180,54 @@ class LocalFileSystem {
     virtual int Write(int fd, butil::IOBuf buf, uint64_t offset,
                       int length) = 0;
 
+    /**
+     * 异步从文件指定区域读取数据
+     * 默认实现为同步读取后直接调用回调，支持异步的实现会在IO完成后回调
+     * @param fd：文件句柄id，通过Open接口获取
+     * @param buf：接收读取数据的buffer，回调之前需要保持有效
+     * @param offset：读取区域的起始偏移
+     * @param length：读取数据的长度
+     * @param cb：IO完成后的回调
+     * @return 提交成功返回0，提交失败返回-errno且不会调用回调
+     */
+    virtual int ReadAsync(int fd, char* buf, uint64_t offset, int length,
+                          AioCallback cb) {
+        cb(Read(fd, buf, offset, length));
+        return 0;
+    }
+
+    /**
+     * 异步向文件指定区域写入数据
+     * 默认实现为同步写入后直接调用回调，支持异步的实现会在IO完成后回调
+     * @param fd：文件句柄id，通过Open接口获取
+     * @param buf：待写入数据的buffer，回调之前需要保持有效
+     * @param offset：写入区域的起始偏移
+     * @param length：写入数据的长度
+     * @param cb：IO完成后的回调
+     * @return 提交成功返回0，提交失败返回-errno且不会调用回调
+     */
+    virtual int WriteAsync(int fd, const char* buf, uint64_t offset,
+                           int length, AioCallback cb) {
+        cb(Write(fd, buf, offset, length));
+        return 0;
+    }
+
+    /**
+     * 异步向文件指定区域写入数据
+     * 默认实现为同步写入后直接调用回调，支持异步的实现会在IO完成后回调
+     * @param fd：文件句柄id，通过Open接口获取
+     * @param buf：待写入数据，内部会持有引用直到IO完成
+     * @param offset：写入区域的起始偏移
+     * @param length：写入数据的长度
+     * @param cb：IO完成后的回调
+     * @return 提交成功返回0，提交失败返回-errno且不会调用回调
+     */
+    virtual int WriteAsync(int fd, const butil::IOBuf& buf, uint64_t offset,
+                           int length, AioCallback cb) {
+        cb(Write(fd, buf, offset, length));
+        return 0;
+    }
+
     /**
      * @brief sync one fd
      *
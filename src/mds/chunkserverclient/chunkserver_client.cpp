@@ -35,6 +35,8 @@ using ::curve::mds::topology::ONLINE;
 using ::curve::chunkserver::ChunkService_Stub;
 using ::curve::chunkserver::ChunkRequest;
 using ::curve::chunkserver::ChunkResponse;
+using ::curve::chunkserver::BatchChunkRequest;
+using ::curve::chunkserver::BatchChunkResponse;
 using ::curve::chunkserver::CHUNK_OP_TYPE;
 using ::curve::chunkserver::CHUNK_OP_STATUS;
 
@@ -228,6 +230,113 @@ int ChunkServerClient::DeleteChunk(ChunkServerIdType leaderId,
     return kMdsSuccess;
 }
 
+int ChunkServerClient::DeleteChunks(ChunkServerIdType leaderId,
+    LogicalPoolID logicalPoolId,
+    CopysetID copysetId,
+    const std::vector<ChunkID> &chunkIds,
+    uint64_t sn) {
+    ChannelPtr channelPtr;
+    int res = GetOrInitChannel(leaderId, &channelPtr);
+    if (res != kMdsSuccess) {
+        return res;
+    }
+    ChunkService_Stub stub(channelPtr.get());
+
+    brpc::Controller cntl;
+    cntl.set_timeout_ms(rpcTimeoutMs_);
+
+    BatchChunkRequest request;
+    request.set_optype(CHUNK_OP_TYPE::CHUNK_OP_DELETE);
+    request.set_logicpoolid(logicalPoolId);
+    request.set_copysetid(copysetId);
+    for (ChunkID chunkId : chunkIds) {
+        ChunkRequest *sub = request.add_requests();
+        sub->set_optype(CHUNK_OP_TYPE::CHUNK_OP_DELETE);
+        sub->set_logicpoolid(logicalPoolId);
+        sub->set_copysetid(copysetId);
+        sub->set_chunkid(chunkId);
+        sub->set_sn(sn);
+    }
+
+    BatchChunkResponse response;
+    uint32_t retry = 0;
+    do {
+        cntl.Reset();
+        cntl.set_timeout_ms(rpcTimeoutMs_);
+        stub.DeleteChunks(&cntl,
+            &request,
+            &response,
+            nullptr);
+        LOG(INFO) << "Send DeleteChunks[log_id=" << cntl.log_id()
+                  << "] from " << cntl.local_side()
+                  << " to " << cntl.remote_side()
+                  << ", logicalPoolId = " << logicalPoolId
+                  << ", copysetId = " << copysetId
+                  << ", chunk count = " << chunkIds.size();
+        if (cntl.Failed()) {
+            LOG(WARNING) << "Send DeleteChunks error, "
+                       << "cntl.errorText = "
+                       << cntl.ErrorText()
+                       << ", retry, time = "
+                       << retry;
+            std::this_thread::sleep_for(
+                std::chrono::milliseconds(rpcRetryIntervalMs_));
+        }
+        retry++;
+    } while (cntl.Failed() && retry < rpcRetryTimes_);
+
+    if (cntl.Failed()) {
+        LOG(ERROR) << "Send DeleteChunks error, retry fail,"
+                   << "cntl.errorText = "
+                   << cntl.ErrorText() << std::endl;
+        return kRpcFail;
+    }
+
+    switch (response.status()) {
+        case CHUNK_OP_STATUS::CHUNK_OP_STATUS_SUCCESS:
+            break;
+        case CHUNK_OP_STATUS::CHUNK_OP_STATUS_REDIRECTED:
+            LOG(INFO) << "Received DeleteChunks, not leader, redirect."
+                      << " [log_id=" << cntl.log_id()
+                      << "] from " << cntl.remote_side()
+                      << " to " << cntl.local_side()
+                      << ". [BatchChunkResponse] "
+                      << response.ShortDebugString();
+            return kCsClientNotLeader;
+        default:
+            LOG(ERROR) << "Received DeleteChunks error, [log_id="
+                       << cntl.log_id()
+                       << "] from " << cntl.remote_side()
+                       << " to " << cntl.local_side()
+                       << ". [BatchChunkResponse] "
+                       << response.ShortDebugString();
+            return kCsClientReturnFail;
+    }
+
+    if (response.responses_size() != request.requests_size()) {
+        LOG(ERROR) << "Received DeleteChunks error, response count "
+                   << response.responses_size() << " mismatch with "
+                   << request.requests_size();
+        return kCsClientReturnFail;
+    }
+    for (int i = 0; i < response.responses_size(); ++i) {
+        CHUNK_OP_STATUS status = response.responses(i).status();
+        if (status != CHUNK_OP_STATUS::CHUNK_OP_STATUS_SUCCESS &&
+            status != CHUNK_OP_STATUS::CHUNK_OP_STATUS_CHUNK_NOTEXIST) {
+            LOG(ERROR) << "Received DeleteChunks error, [log_id="
+                       << cntl.log_id()
+                       << "] chunkid = " << chunkIds[i]
+                       << ", status = " << status;
+            return kCsClientReturnFail;
+        }
+    }
+    LOG(INFO) << "Received DeleteChunks[log_id=" << cntl.log_id()
+              << "] from " << cntl.remote_side()
+              << " to " << cntl.local_side()
+              << ", chunk count = " << chunkIds.size();
+    return kMdsSuccess;
+}
+
 int ChunkServerClient::GetLeader(ChunkServerIdType csId,
     LogicalPoolID logicalPoolId,
     CopysetID copysetId,
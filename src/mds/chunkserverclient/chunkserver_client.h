@@ -28,6 +28,7 @@
 
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "src/mds/common/mds_define.h"
 #include "src/mds/topology/topology.h"
@@ -94,6 +95,24 @@ class ChunkServerClient {
         ChunkID chunkId,
         uint64_t sn);
 
+    /**
+     * @brief delete several chunks of one copyset in one rpc, chunks are
+     *        deleted in one raft log entry
+     *
+     * @param leaderId
+     * @param logicalPoolId
+     * @param copysetId
+     * @param chunkIds chunk file IDs
+     * @param sn file version number
+     *
+     * @return error code, fails if any chunk failed to be deleted
+     */
+    virtual int DeleteChunks(ChunkServerIdType leaderId,
+        LogicalPoolID logicalPoolId,
+        CopysetID copysetId,
+        const std::vector<ChunkID> &chunkIds,
+        uint64_t sn);
+
     /**
      * @brief get the leader
      * @detail
@@ -22,8 +22,96 @@
 
 #include "src/mds/nameserver2/clean_core.h"
 
+#include <algorithm>
+#include <condition_variable>  // NOLINT
+#include <map>
+#include <mutex>  // NOLINT
+#include <utility>
+
 namespace curve {
 namespace mds {
+
+struct CleanCore::PendingSegment {
+    PendingSegment(int index, uint64_t offset, const PageFileSegment& segment)
+        : index(index), offset(offset), segment(segment),
+          remaining(0), ret(kMdsSuccess) {}
+
+    int index;
+    uint64_t offset;
+    PageFileSegment segment;
+    // 未完成的删除请求数
+    std::atomic<uint32_t> remaining;
+    // 第一个失败的删除请求的错误码，在remaining减1之前设置
+    std::atomic<int> ret;
+};
+
+class CleanCore::DeleteTracker {
+ public:
+    explicit DeleteTracker(uint32_t maxInflight)
+        : maxInflight_(std::max(maxInflight, 1u)),
+          inflight_(0),
+          ret_(kMdsSuccess) {}
+
+    /**
+     * @brief 在途请求数达到上限时等待
+     * @return 已经有请求失败时返回false
+     */
+    bool Acquire() {
+        std::unique_lock<std::mutex> lk(mtx_);
+        cv_.wait(lk, [this]() {
+            return inflight_ < maxInflight_ || ret_ != kMdsSuccess;
+        });
+        if (ret_ != kMdsSuccess) {
+            return false;
+        }
+        ++inflight_;
+        return true;
+    }
+
+    void Release(int ret) {
+        std::lock_guard<std::mutex> lk(mtx_);
+        --inflight_;
+        if (ret != kMdsSuccess && ret_ == kMdsSuccess) {
+            ret_ = ret;
+        }
+        cv_.notify_all();
+    }
+
+    /**
+     * @brief 等待所有在途请求完成
+     * @return 第一个失败的请求的错误码
+     */
+    int Wait() {
+        std::unique_lock<std::mutex> lk(mtx_);
+        cv_.wait(lk, [this]() { return inflight_ == 0; });
+        return ret_;
+    }
+
+ private:
+    const uint32_t maxInflight_;
+    uint32_t inflight_;
+    int ret_;
+    std::mutex mtx_;
+    std::condition_variable cv_;
+};
+
+CleanCore::CleanCore(std::shared_ptr<NameServerStorage> storage,
+                     std::shared_ptr<CopysetClient> copysetClient,
+                     std::shared_ptr<AllocStatistic> allocStatistic,
+                     const CleanCoreOption &option)
+    : storage_(storage),
+      copysetClient_(copysetClient),
+      allocStatistic_(allocStatistic),
+      option_(option) {
+    if (option_.deleteThreadNum > 0) {
+        deletePool_.Start(option_.deleteThreadNum);
+    }
+}
+
+CleanCore::~CleanCore() {
+    deletePool_.Stop();
+}
+
 StatusCode CleanCore::CleanSnapShotFile(const FileInfo & fileInfo,
                                         TaskProgress* progress) {
     if (fileInfo.segmentsize() == 0) {
@@ -102,8 +190,12 @@ StatusCode CleanCore::CleanFile(const FileInfo & commonFile,
         return StatusCode::KInternalError;
     }
 
+    // 多个segment的chunk同时删除，chunk删除完成的segment依次从存储中删除
     int  segmentNum = commonFile.length() / commonFile.segmentsize();
     uint64_t segmentSize = commonFile.segmentsize();
+    DeleteTracker tracker(option_.deleteInflight);
+    PendingSegments pendings;
+    bool failed = false;
     for (int i = 0; i != segmentNum; i++) {
         // load  segment
         PageFileSegment segment;
@@ -116,37 +208,35 @@ StatusCode CleanCore::CleanFile(const FileInfo & commonFile,
                 << "GetSegment Error, inodeid = " << commonFile.id()
                 << ", filename = " << commonFile.filename()
                 << ", offset = " << i * segmentSize;
-            progress->SetStatus(TaskStatus::FAILED);
-            return StatusCode::kCommonFileDeleteError;
+            failed = true;
+            break;
         }
 
-        int ret = DeleteChunksInSegment(segment, commonFile.seqnum());
-        if (ret != 0) {
-            LOG(ERROR) << "Clean common File Error: "
-                       << ", ret = " << ret
-                       << ", inodeid = " << commonFile.id()
-                       << ", filename = " << commonFile.filename()
-                       << ", sequenceNum = " << commonFile.seqnum();
-            progress->SetStatus(TaskStatus::FAILED);
-            return StatusCode::kCommonFileDeleteError;
+        pendings.emplace_back(
+            new PendingSegment(i, i * segmentSize, segment));
+        if (!DeleteChunksAsync(pendings.back().get(), commonFile.seqnum(),
+                               &tracker) ||
+            !DeleteDoneSegments(commonFile, segmentNum, &pendings,
+                                progress)) {
+            failed = true;
+            break;
         }
+    }
 
-        // delete segment
-        int64_t revision;
-        storeRet = storage_->DeleteSegment(
-            commonFile.id(), i * segmentSize, &revision);
-        if (storeRet != StoreStatus::OK) {
-            LOG(ERROR) << "Clean common File Error: "
-            << "DeleteSegment Error, inodeid = " << commonFile.id()
-            << ", filename = " << commonFile.filename()
-            << ", offset = " << i * segmentSize
-            << ", sequenceNum = " << commonFile.seqnum();
-            progress->SetStatus(TaskStatus::FAILED);
-            return StatusCode::kCommonFileDeleteError;
-        }
-        allocStatistic_->DeAllocSpace(segment.logicalpoolid(),
-            segment.segmentsize(), revision);
-        progress->SetProgress(100 * (i + 1) / segmentNum);
+    // 失败时也要等在途的请求完成
+    int deleteRet = tracker.Wait();
+    if (!failed && deleteRet == 0) {
+        failed = !DeleteDoneSegments(commonFile, segmentNum, &pendings,
+                                     progress);
+    }
+    if (failed || deleteRet != 0) {
+        LOG(ERROR) << "Clean common File Error: "
+                   << ", ret = " << deleteRet
+                   << ", inodeid = " << commonFile.id()
+                   << ", filename = " << commonFile.filename()
+                   << ", sequenceNum = " << commonFile.seqnum();
+        progress->SetStatus(TaskStatus::FAILED);
+        return StatusCode::kCommonFileDeleteError;
     }
 
     // delete the storage
@@ -220,25 +310,100 @@ StatusCode CleanCore::CleanDiscardSegment(
 
 int CleanCore::DeleteChunksInSegment(const PageFileSegment& segment,
                                      const SeqNum& seq) {
-    const LogicalPoolID logicalPoolId = segment.logicalpoolid();
+    DeleteTracker tracker(option_.deleteInflight);
+    PendingSegment pending(0, segment.startoffset(), segment);
+    DeleteChunksAsync(&pending, seq, &tracker);
+    return tracker.Wait();
+}
+
+bool CleanCore::DeleteChunksAsync(PendingSegment* pending,
+                                  const SeqNum& seq,
+                                  DeleteTracker* tracker) {
+    const PageFileSegment& segment = pending->segment;
+    const uint32_t batchSize = std::max(option_.deleteBatchSize, 1u);
+
+    // 同一copyset上的chunk按batchSize分组
+    std::vector<ChunkBatch> batches;
+    std::map<CopysetID, size_t> lastBatch;
     for (int i = 0; i < segment.chunks_size(); ++i) {
-        int ret = copysetClient_->DeleteChunk(
-            logicalPoolId,
-            segment.chunks()[i].copysetid(),
-            segment.chunks()[i].chunkid(),
-            seq);
-
-        if (ret != 0) {
-            LOG(ERROR) << "DeleteChunk failed, ret = " << ret
-                       << ", logicalpoolid = " << logicalPoolId
-                       << ", copysetid = " << segment.chunks()[i].copysetid()
-                       << ", chunkid = " << segment.chunks()[i].chunkid()
-                       << ", seq = " << seq;
-            return ret;
+        CopysetID copysetId = segment.chunks(i).copysetid();
+        auto iter = lastBatch.find(copysetId);
+        if (iter == lastBatch.end() ||
+            batches[iter->second].chunkIds.size() >= batchSize) {
+            batches.emplace_back();
+            batches.back().copysetId = copysetId;
+            lastBatch[copysetId] = batches.size() - 1;
+            iter = lastBatch.find(copysetId);
         }
+        batches[iter->second].chunkIds.push_back(segment.chunks(i).chunkid());
     }
 
-    return 0;
+    pending->remaining.store(batches.size(), std::memory_order_relaxed);
+    for (auto& batch : batches) {
+        if (!tracker->Acquire()) {
+            return false;
+        }
+        if (option_.deleteThreadNum > 0) {
+            deletePool_.Enqueue(&CleanCore::DoDeleteChunks, this,
+                                segment.logicalpoolid(), std::move(batch),
+                                seq, pending, tracker);
+        } else {
+            DoDeleteChunks(segment.logicalpoolid(), batch, seq, pending,
+                           tracker);
+        }
+    }
+    return true;
+}
+
+void CleanCore::DoDeleteChunks(LogicalPoolID logicalPoolId,
+                               const ChunkBatch& batch,
+                               SeqNum seq,
+                               PendingSegment* pending,
+                               DeleteTracker* tracker) {
+    int ret = copysetClient_->DeleteChunks(
+        logicalPoolId, batch.copysetId, batch.chunkIds, seq);
+    if (ret != 0) {
+        LOG(ERROR) << "DeleteChunks failed, ret = " << ret
+                   << ", logicalpoolid = " << logicalPoolId
+                   << ", copysetid = " << batch.copysetId
+                   << ", first chunkid = " << batch.chunkIds.front()
+                   << ", chunk count = " << batch.chunkIds.size()
+                   << ", seq = " << seq;
+        pending->ret.store(ret, std::memory_order_relaxed);
+    }
+    pending->remaining.fetch_sub(1, std::memory_order_release);
+    tracker->Release(ret);
+}
+
+bool CleanCore::DeleteDoneSegments(const FileInfo& commonFile,
+                                   int segmentNum,
+                                   PendingSegments* pendings,
+                                   TaskProgress* progress) {
+    while (!pendings->empty() &&
+           pendings->front()->remaining.load(std::memory_order_acquire) == 0) {
+        const PendingSegment& pending = *pendings->front();
+        if (pending.ret.load(std::memory_order_relaxed) != 0) {
+            return false;
+        }
+
+        // delete segment
+        int64_t revision;
+        StoreStatus storeRet = storage_->DeleteSegment(
+            commonFile.id(), pending.offset, &revision);
+        if (storeRet != StoreStatus::OK) {
+            LOG(ERROR) << "Clean common File Error: "
+            << "DeleteSegment Error, inodeid = " << commonFile.id()
+            << ", filename = " << commonFile.filename()
+            << ", offset = " << pending.offset
+            << ", sequenceNum = " << commonFile.seqnum();
+            return false;
+        }
+        allocStatistic_->DeAllocSpace(pending.segment.logicalpoolid(),
+            pending.segment.segmentsize(), revision);
+        progress->SetProgress(100 * (pending.index + 1) / segmentNum);
+        pendings->pop_front();
+    }
+    return true;
 }
 
 }  // namespace mds
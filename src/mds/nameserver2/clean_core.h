@@ -23,8 +23,12 @@
 #ifndef SRC_MDS_NAMESERVER2_CLEAN_CORE_H_
 #define SRC_MDS_NAMESERVER2_CLEAN_CORE_H_
 
+#include <atomic>
+#include <deque>
 #include <memory>
 #include <string>
+#include <vector>
+#include "src/common/concurrent/task_thread_pool.h"
 #include "src/mds/nameserver2/namespace_storage.h"
 #include "src/mds/common/mds_define.h"
 #include "src/mds/nameserver2/task_progress.h"
@@ -38,14 +42,26 @@ using ::curve::mds::topology::Topology;
 namespace curve {
 namespace mds {
 
+struct CleanCoreOption {
+    // 一个DeleteChunks请求中最多删除的chunk数
+    uint32_t deleteBatchSize;
+    // 一个清理任务同时在途的删除请求数
+    uint32_t deleteInflight;
+    // 发送删除请求的线程数，为0时在清理任务的线程中依次发送
+    uint32_t deleteThreadNum;
+    CleanCoreOption()
+        : deleteBatchSize(64),
+          deleteInflight(16),
+          deleteThreadNum(16) {}
+};
+
 class CleanCore {
  public:
     CleanCore(std::shared_ptr<NameServerStorage> storage,
         std::shared_ptr<CopysetClient> copysetClient,
-        std::shared_ptr<AllocStatistic> allocStatistic)
-        : storage_(storage),
-          copysetClient_(copysetClient),
-          allocStatistic_(allocStatistic) {}
+        std::shared_ptr<AllocStatistic> allocStatistic,
+        const CleanCoreOption &option = CleanCoreOption());
+    ~CleanCore();
 
     /**
      * @brief 删除快照文件，更新task状态
@@ -74,12 +90,55 @@ class CleanCore {
                                    TaskProgress* progress);
 
  private:
+    // 一个copyset上待删除的一组chunk
+    struct ChunkBatch {
+        CopysetID copysetId;
+        std::vector<ChunkID> chunkIds;
+    };
+    // chunk正在删除中的segment
+    struct PendingSegment;
+    using PendingSegments = std::deque<std::unique_ptr<PendingSegment>>;
+    // 一个清理任务中在途的删除请求
+    class DeleteTracker;
+
+    /**
+     * @brief 删除segment中的所有chunk，等待删除完成
+     * @return 成功返回0，否则返回第一个失败的错误码
+     */
     int DeleteChunksInSegment(const PageFileSegment& segment,
                               const SeqNum& seq);
 
+    /**
+     * @brief 把segment中的chunk按copyset分组，每组最多deleteBatchSize个
+     *        chunk，分别发送DeleteChunks请求，不等待请求完成
+     *        在途请求数达到上限时阻塞
+     * @return 之前的请求已经失败时不再发送，返回false
+     */
+    bool DeleteChunksAsync(PendingSegment* pending,
+                           const SeqNum& seq,
+                           DeleteTracker* tracker);
+
+    void DoDeleteChunks(LogicalPoolID logicalPoolId,
+                        const ChunkBatch& batch,
+                        SeqNum seq,
+                        PendingSegment* pending,
+                        DeleteTracker* tracker);
+
+    /**
+     * @brief 从pendings头部开始，依次从存储中删除chunk已经删除完成的segment
+     * @return 有segment的chunk删除失败或者删除segment失败时返回false
+     */
+    bool DeleteDoneSegments(const FileInfo& commonFile,
+                            int segmentNum,
+                            PendingSegments* pendings,
+                            TaskProgress* progress);
+
     std::shared_ptr<NameServerStorage> storage_;
     std::shared_ptr<CopysetClient> copysetClient_;
     std::shared_ptr<AllocStatistic> allocStatistic_;
+    CleanCoreOption option_;
+    // 发送删除请求的线程池，所有清理任务共用
+    curve::common::TaskThreadPool<> deletePool_;
 };
 
 }  // namespace mds
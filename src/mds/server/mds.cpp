@@ -562,9 +562,12 @@ void MDS::InitCleanManager() {
         std::make_shared<CopysetClient>(topology_, chunkServerClientOption,
                                                         channelPool);
 
+    CleanCoreOption cleanCoreOption;
+    InitCleanCoreOption(&cleanCoreOption);
     auto cleanCore = std::make_shared<CleanCore>(nameServerStorage_,
                                                  copysetClient,
-                                                 segmentAllocStatistic_);
+                                                 segmentAllocStatistic_,
+                                                 cleanCoreOption);
 
     // init dlock options
     auto dlockOpts = std::make_shared<DLockOpts>();
@@ -590,6 +593,22 @@ void MDS::InitChunkServerClientOption(ChunkServerClientOption *option) {
         &option->updateLeaderRetryIntervalMs);
 }
 
+void MDS::InitCleanCoreOption(CleanCoreOption *option) {
+    // 旧的配置文件中没有这些配置项，使用默认值
+    LOG_IF(WARNING, !conf_->GetUInt32Value("mds.clean.deleteBatchSize",
+                                           &option->deleteBatchSize))
+        << "mds.clean.deleteBatchSize not found, use default value "
+        << option->deleteBatchSize;
+    LOG_IF(WARNING, !conf_->GetUInt32Value("mds.clean.deleteInflight",
+                                           &option->deleteInflight))
+        << "mds.clean.deleteInflight not found, use default value "
+        << option->deleteInflight;
+    LOG_IF(WARNING, !conf_->GetUInt32Value("mds.clean.deleteThreadNum",
+                                           &option->deleteThreadNum))
+        << "mds.clean.deleteThreadNum not found, use default value "
+        << option->deleteThreadNum;
+}
+
 void MDS::InitCoordinator() {
     // init option
     ScheduleOption scheduleOption;
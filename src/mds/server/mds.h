@@ -170,6 +170,8 @@ class MDS {
 
     void InitChunkServerClientOption(ChunkServerClientOption *option);
 
+    void InitCleanCoreOption(CleanCoreOption *option);
+
     void InitSnapshotCloneClientOption(SnapshotCloneClientOption *option);
 
     void InitEtcdClient(const EtcdConf& etcdConf,
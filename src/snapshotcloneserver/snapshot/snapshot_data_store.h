@@ -185,6 +185,13 @@ class TransferTask {
      std::map<int, std::string> partInfo_;
 };
 
+struct DataChunkPart {
+    // 第几个分片，从0开始
+    int partIndex;
+    int partSize;
+    const char *buf;
+};
+
 class SnapshotDataStore {
  public:
      SnapshotDataStore() {}
@@ -273,6 +280,26 @@ class SnapshotDataStore {
                                        int partNum,
                                        int partSize,
                                        const char* buf) = 0;
+    /**
+     * 添加数据chunk的一组分片到转储任务中，
+     * 默认逐个调用DataChunkTranferAddPart，实现可以并发转储
+     * @param 数据chunk名
+     * @param 转储任务
+     * @param 分片列表
+     * @return: 0 全部添加成功/ -1 添加失败
+     */
+    virtual int DataChunkTranferAddParts(
+        const ChunkDataName &name, std::shared_ptr<TransferTask> task,
+        const std::vector<DataChunkPart> &parts) {
+        for (const auto &part : parts) {
+            int ret = DataChunkTranferAddPart(name, task, part.partIndex,
+                                              part.partSize, part.buf);
+            if (ret < 0) {
+                return ret;
+            }
+        }
+        return 0;
+    }
     /**
      * 完成数据chunk的转储任务
      * @param 数据chunk名
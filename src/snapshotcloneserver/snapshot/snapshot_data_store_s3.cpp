@@ -35,6 +35,8 @@ int S3SnapshotDataStore::Init(const std::string &path) {
     // Init server conf
     s3Adapter4Meta_->Init(path);
     s3Adapter4Data_->Init(path);
+    transferEngine_.reset(new S3TransferEngine(
+        s3Adapter4Data_.get(), s3Adapter4Data_->GetTransferOption()));
     // create bucket if not exist
     if (!s3Adapter4Meta_->BucketExist()) {
         return s3Adapter4Meta_->CreateBucket();
@@ -177,6 +179,34 @@ int S3SnapshotDataStore::DataChunkTranferAddPart(const ChunkDataName &name,
     return 0;
 }
 
+int S3SnapshotDataStore::DataChunkTranferAddParts(
+    const ChunkDataName &name, std::shared_ptr<TransferTask> task,
+    const std::vector<DataChunkPart> &parts) {
+    if (transferEngine_ == nullptr) {
+        return SnapshotDataStore::DataChunkTranferAddParts(name, task, parts);
+    }
+    std::vector<S3TransferPart> s3Parts;
+    s3Parts.reserve(parts.size());
+    for (const auto &part : parts) {
+        S3TransferPart s3Part;
+        s3Part.partNum = part.partIndex + 1;
+        s3Part.buf = part.buf;
+        s3Part.len = part.partSize;
+        s3Parts.push_back(s3Part);
+    }
+    Aws::Vector<Aws::S3::Model::CompletedPart> cp_v;
+    if (transferEngine_->UploadParts(name.ToDataChunkKey(), task->uploadId_,
+                                     s3Parts, &cp_v) != 0) {
+        LOG(ERROR) << "Failed to UploadParts";
+        return -1;
+    }
+    for (auto &cp : cp_v) {
+        std::string etag(cp.GetETag().c_str(), cp.GetETag().size());
+        task->AddPartInfo(cp.GetPartNumber(), etag);
+    }
+    return 0;
+}
+
 int S3SnapshotDataStore::DataChunkTranferComplete(const ChunkDataName &name,
                                         std::shared_ptr<TransferTask> task) {
     std::string key = name.ToDataChunkKey();
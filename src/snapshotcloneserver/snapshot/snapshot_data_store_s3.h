@@ -30,8 +30,11 @@
 #include <memory>
 #include "src/snapshotcloneserver/snapshot/snapshot_data_store.h"
 #include "src/common/s3_adapter.h"
+#include "src/common/s3_transfer_engine.h"
 
 using ::curve::common::S3Adapter;
+using ::curve::common::S3TransferEngine;
+using ::curve::common::S3TransferPart;
 namespace curve {
 namespace snapshotcloneserver {
 
@@ -66,6 +69,9 @@ class S3SnapshotDataStore : public SnapshotDataStore {
                                         int partNum,
                                         int partSize,
                                         const char* buf) override;
+    int DataChunkTranferAddParts(
+        const ChunkDataName &name, std::shared_ptr<TransferTask> task,
+        const std::vector<DataChunkPart> &parts) override;
      int DataChunkTranferComplete(const ChunkDataName &name,
                                 std::shared_ptr<TransferTask> task) override;
      int DataChunkTranferAbort(const ChunkDataName &name,
@@ -79,6 +85,11 @@ class S3SnapshotDataStore : public SnapshotDataStore {
      }
      void SetDataAdapter(std::shared_ptr<S3Adapter> adapter) {
          s3Adapter4Data_ = adapter;
+         if (transferEngine_ != nullptr) {
+             transferEngine_.reset(new S3TransferEngine(
+                 s3Adapter4Data_.get(),
+                 s3Adapter4Data_->GetTransferOption()));
+         }
      }
      std::shared_ptr<S3Adapter> GetDataAdapter(void) {
          return s3Adapter4Data_;
@@ -87,6 +98,8 @@ class S3SnapshotDataStore : public SnapshotDataStore {
  private:
     std::shared_ptr<curve::common::S3Adapter> s3Adapter4Data_;
     std::shared_ptr<curve::common::S3Adapter> s3Adapter4Meta_;
+    // 并发上传数据chunk的分片
+    std::unique_ptr<S3TransferEngine> transferEngine_;
 };
 
 }   // namespace snapshotcloneserver
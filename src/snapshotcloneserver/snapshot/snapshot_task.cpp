@@ -21,6 +21,7 @@
  */
 
 #include <list>
+#include <vector>
 
 #include "src/common/timeutility.h"
 #include "src/snapshotcloneserver/snapshot/snapshot_task.h"
@@ -52,7 +53,7 @@ void ReadChunkSnapshotClosure::Run() {
  *  步骤如下：
  *  1. 创建一个转储任务transferTask，并调用DataChunkTranferInit初始化
  *  2. 调用ReadChunkSnapshot从curvefs读取chunk的一个分片
- *  3. 调用DataChunkTranferAddPart转储一个分片
+ *  3. 调用DataChunkTranferAddParts并发转储读取成功的分片
  *  4. 重复2、3直到所有分片转储完成，调用DataChunkTranferComplete结束转储任务
  *  5. 中间如有读取或转储发生错误，则调用DataChunkTranferAbort放弃转储，
  *  并返回错误码
@@ -191,6 +192,7 @@ int TransferSnapshotDataChunkTask::HandleReadChunkSnapshotResultsAndRetry(
     std::shared_ptr<TransferTask> transferTask,
     const std::list<ReadChunkSnapshotContextPtr> &results) {
     int ret = kErrCodeSuccess;
+    std::vector<DataChunkPart> parts;
     for (auto context : results) {
         if (context->retCode < 0) {
             uint64_t nowTime = TimeUtility::GetTimeofDaySec();
@@ -211,20 +213,24 @@ int TransferSnapshotDataChunkTask::HandleReadChunkSnapshotResultsAndRetry(
                 return ret;
             }
         } else {
-            ret = dataStore_->DataChunkTranferAddPart(
-                taskInfo_->name_,
-                transferTask,
-                context->partIndex,
-                context->len,
-                context->buf.get());
-            if (ret < 0) {
-                LOG(ERROR) << "DataChunkTranferAddPart fail"
-                           << ", ret = " << ret
-                           << ", chunkDataName = "
-                           << taskInfo_->name_.ToDataChunkKey()
-                           << ", index = " << context->partIndex;
-                return ret;
-            }
+            DataChunkPart part;
+            part.partIndex = context->partIndex;
+            part.partSize = context->len;
+            part.buf = context->buf.get();
+            parts.push_back(part);
+        }
+    }
+    if (!parts.empty()) {
+        // results持有分片的buf，直到转储完成
+        ret = dataStore_->DataChunkTranferAddParts(
+            taskInfo_->name_, transferTask, parts);
+        if (ret < 0) {
+            LOG(ERROR) << "DataChunkTranferAddParts fail"
+                       << ", ret = " << ret
+                       << ", chunkDataName = "
+                       << taskInfo_->name_.ToDataChunkKey()
+                       << ", partNum = " << parts.size();
+            return ret;
         }
     }
     return ret;
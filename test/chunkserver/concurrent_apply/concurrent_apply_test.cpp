@@ -24,6 +24,7 @@
 
 #include <atomic>
 #include <functional>
+#include <vector>
 
 #include "proto/chunk.pb.h"
 #include "src/common/timeutility.h"
@@ -166,3 +167,38 @@ TEST(ConcurrentApplyModule, ConcurrentTest) {
     concurrentapply.Stop();
 }
 
+
+TEST(ConcurrentApplyModule, LockFreeQueueTest) {
+    ConcurrentApplyModule concurrentapply;
+    ConcurrentApplyOption opt(2, 1, 1, 1, true);
+    ASSERT_TRUE(concurrentapply.Init(opt));
+
+    // each key is hashed to one thread, its tasks run in push order
+    std::vector<uint32_t> next(2, 0);
+    std::atomic<bool> ordered(true);
+    auto wtask = [&next, &ordered](int key, uint32_t seq) {
+        if (next[key] != seq) {
+            ordered = false;
+        }
+        next[key]++;
+    };
+    std::atomic<uint32_t> rnum(0);
+    auto rtask = [&rnum]() {
+        rnum.fetch_add(1);
+    };
+
+    for (uint32_t i = 0; i < 5000; i++) {
+        concurrentapply.Push(0, ApplyTaskType::WRITE, wtask, 0, i);
+        concurrentapply.Push(1, ApplyTaskType::WRITE, wtask, 1, i);
+        concurrentapply.Push(i, ApplyTaskType::READ, rtask);
+    }
+
+    concurrentapply.Flush();
+    ASSERT_TRUE(ordered);
+    ASSERT_EQ(5000, next[0]);
+    ASSERT_EQ(5000, next[1]);
+    while (rnum.load() < 5000) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    concurrentapply.Stop();
+}
@@ -791,6 +791,53 @@ TEST_F(CopysetNodeTest, get_conf_change) {
     }
 }
 
+TEST_F(CopysetNodeTest, write_ahead_conf_change) {
+    LogicPoolID logicPoolID = 1;
+    CopysetID copysetID = 1;
+    Configuration conf;
+    conf.add_peer(PeerId("127.0.0.1:3200:0"));
+    CopysetNodeOptions options = defaultOptions_;
+    options.enableWriteAhead = true;
+
+    CopysetNode copysetNode(logicPoolID, copysetID, conf);
+    std::shared_ptr<MockNode> mockNode
+        = std::make_shared<MockNode>(logicPoolID, copysetID);
+    ASSERT_EQ(0, copysetNode.Init(options));
+    copysetNode.SetCopysetNode(mockNode);
+    copysetNode.on_leader_start(8);
+    copysetNode.UpdateWriteAheadIndex(10);
+
+    Peer addPeer;
+    addPeer.set_address("127.0.0.1:3201:0");
+    std::vector<Peer> newPeers(1, addPeer);
+
+    // 日志中还有write ahead日志，触发快照并拒绝配置变更
+    NodeStatus status;
+    status.first_index = 5;
+    EXPECT_CALL(*mockNode, get_status(_))
+        .Times(2)
+        .WillRepeatedly(SetArgPointee<0>(status));
+    EXPECT_CALL(*mockNode, snapshot(_)).Times(2);
+    EXPECT_CALL(*mockNode, add_peer(_, _)).Times(0);
+    EXPECT_CALL(*mockNode, change_peers(_, _)).Times(0);
+    ASSERT_EQ(EBUSY, copysetNode.AddPeer(addPeer).error_code());
+    ASSERT_EQ(EBUSY, copysetNode.ChangePeer(newPeers).error_code());
+
+    // 之后不再write ahead
+    bool writeAhead = true;
+    uint64_t token = copysetNode.GetInflightChunkRanges()->Begin(
+        1, 0, 4096, true, &writeAhead);
+    ASSERT_FALSE(writeAhead);
+    copysetNode.GetInflightChunkRanges()->End(1, token);
+
+    // write ahead日志都已经删除，可以变更配置
+    status.first_index = 11;
+    EXPECT_CALL(*mockNode, get_status(_))
+        .WillOnce(SetArgPointee<0>(status));
+    EXPECT_CALL(*mockNode, add_peer(_, _)).Times(1);
+    ASSERT_TRUE(copysetNode.AddPeer(addPeer).ok());
+}
+
 TEST_F(CopysetNodeTest, get_hash) {
     std::shared_ptr<LocalFileSystem>
         fs(LocalFsFactory::CreateFs(FileSystemType::EXT4, ""));    //NOLINT
@@ -68,6 +68,11 @@ class MockDataStore : public CSDataStore {
     MOCK_METHOD2(GetChunkInfo, CSErrorCode(ChunkID, CSChunkInfo*));
     MOCK_METHOD0(GetStatus, DataStoreStatus());
     MOCK_METHOD0(GetChunkMap, ChunkMap());
+
+    void ReadChunkAsync(ChunkID id, SequenceNum sn, char* buf, off_t offset,
+                        size_t length, ChunkIoCallback cb) override {
+        cb(ReadChunk(id, sn, buf, offset, length));
+    }
 };
 
 }  // namespace chunkserver
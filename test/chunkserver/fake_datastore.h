@@ -112,6 +112,15 @@ class FakeCSDataStore : public CSDataStore {
         return CSErrorCode::Success;
     }
 
+    void ReadChunkAsync(ChunkID id,
+                        SequenceNum sn,
+                        char *buf,
+                        off_t offset,
+                        size_t length,
+                        ChunkIoCallback cb) override {
+        cb(ReadChunk(id, sn, buf, offset, length));
+    }
+
     CSErrorCode ReadSnapshotChunk(ChunkID id,
                                   SequenceNum sn,
                                   char *buf,
@@ -146,6 +155,17 @@ class FakeCSDataStore : public CSDataStore {
         return CSErrorCode::Success;
     }
 
+    void WriteChunkAsync(ChunkID id,
+                         SequenceNum sn,
+                         const butil::IOBuf& buf,
+                         off_t offset,
+                         size_t length,
+                         const std::string& csl,
+                         ChunkIoCallback cb) override {
+        uint32_t cost;
+        cb(WriteChunk(id, sn, buf, offset, length, &cost, csl));
+    }
+
     CSErrorCode CreateCloneChunk(ChunkID id,
                                  SequenceNum sn,
                                  SequenceNum correctedSn,
@@ -0,0 +1,122 @@
+/*
+ *  Copyright (c) 2023 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>  // NOLINT
+#include <thread>  // NOLINT
+
+#include "src/chunkserver/inflight_chunk_ranges.h"
+
+namespace curve {
+namespace chunkserver {
+
+TEST(InflightChunkRangesTest, basic) {
+    InflightChunkRanges ranges;
+    bool writeAhead = false;
+
+    // 没有在途请求，可以write ahead
+    uint64_t t1 = ranges.Begin(1, 0, 65536, true, &writeAhead);
+    ASSERT_TRUE(writeAhead);
+    ranges.Proposed(1, t1);
+
+    // 与在途请求重叠，不能write ahead
+    uint64_t t2 = ranges.Begin(1, 4096, 65536, true, &writeAhead);
+    ASSERT_FALSE(writeAhead);
+
+    // 不重叠的区间和其他chunk不受影响
+    uint64_t t3 = ranges.Begin(1, 131072, 65536, true, &writeAhead);
+    ASSERT_TRUE(writeAhead);
+    ranges.Proposed(1, t3);
+    uint64_t t4 = ranges.Begin(2, 0, 65536, true, &writeAhead);
+    ASSERT_TRUE(writeAhead);
+    ranges.Proposed(2, t4);
+    ASSERT_EQ(4, ranges.Size());
+
+    // 整个chunk的请求和所有区间重叠
+    uint64_t t5 = ranges.Begin(2, 0, InflightChunkRanges::kWholeChunk,
+                               false, &writeAhead);
+    ASSERT_FALSE(writeAhead);
+    uint64_t t6 = ranges.Begin(2, 1 << 20, 65536, true, &writeAhead);
+    ASSERT_FALSE(writeAhead);
+
+    ranges.End(1, t1);
+    ranges.End(1, t2);
+    ranges.End(1, t3);
+    ranges.End(2, t4);
+    ranges.End(2, t5);
+    ranges.End(2, t6);
+    ASSERT_EQ(0, ranges.Size());
+
+    uint64_t t7 = ranges.Begin(1, 0, 65536, true, &writeAhead);
+    ASSERT_TRUE(writeAhead);
+    ranges.End(1, t7);
+}
+
+TEST(InflightChunkRangesTest, WaitPendingWriteAhead) {
+    InflightChunkRanges ranges;
+    bool writeAhead = false;
+    uint64_t t1 = ranges.Begin(1, 0, 65536, true, &writeAhead);
+    ASSERT_TRUE(writeAhead);
+
+    // 与pending的write ahead重叠的请求要等它propose之后才能登记
+    std::atomic<bool> begun(false);
+    uint64_t t2 = 0;
+    std::thread th([&]() {
+        t2 = ranges.Begin(1, 0, 4096, false, nullptr);
+        begun.store(true);
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    ASSERT_FALSE(begun.load());
+
+    // 不重叠的请求不需要等待
+    uint64_t t3 = ranges.Begin(1, 65536, 4096, false, nullptr);
+
+    ranges.Proposed(1, t1);
+    th.join();
+    ASSERT_TRUE(begun.load());
+    ASSERT_EQ(3, ranges.Size());
+
+    ranges.End(1, t1);
+    ranges.End(1, t2);
+    ranges.End(1, t3);
+    ASSERT_EQ(0, ranges.Size());
+}
+
+TEST(InflightChunkRangesTest, SuspendWriteAhead) {
+    InflightChunkRanges ranges;
+    bool writeAhead = false;
+    uint64_t t1 = ranges.Begin(1, 0, 4096, true, &writeAhead);
+    ASSERT_TRUE(writeAhead);
+    ranges.Proposed(1, t1);
+
+    // 停止之后不再write ahead，返回还没结束的write ahead请求数量
+    ASSERT_EQ(1, ranges.SuspendWriteAhead());
+    uint64_t t2 = ranges.Begin(2, 0, 4096, true, &writeAhead);
+    ASSERT_FALSE(writeAhead);
+    ranges.End(1, t1);
+    ranges.End(2, t2);
+    ASSERT_EQ(0, ranges.SuspendWriteAhead());
+
+    ranges.ResumeWriteAhead();
+    uint64_t t3 = ranges.Begin(1, 0, 4096, true, &writeAhead);
+    ASSERT_TRUE(writeAhead);
+    ranges.End(1, t3);
+}
+
+}  // namespace chunkserver
+}  // namespace curve
@@ -62,6 +62,7 @@ class MockCopysetNode : public CopysetNode {
     MOCK_CONST_METHOD0(GetScan, bool());
     MOCK_METHOD1(SetLastScan, void(uint64_t));
     MOCK_CONST_METHOD0(GetLastScan, uint64_t());
+    MOCK_CONST_METHOD0(WriteAheadAvailable, bool());
 
     MOCK_METHOD1(on_apply, void(::braft::Iterator&));
     MOCK_METHOD0(on_shutdown, void());
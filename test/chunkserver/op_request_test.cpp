@@ -32,12 +32,17 @@
 #include "src/chunkserver/copyset_node.h"
 #include "src/chunkserver/copyset_node_manager.h"
 #include "src/chunkserver/op_request.h"
+#include "src/common/concurrent/count_down_event.h"
 #include "test/chunkserver/fake_datastore.h"
+#include "test/chunkserver/mock_copyset_node.h"
 
 namespace curve {
 namespace chunkserver {
 
 using ::google::protobuf::io::ZeroCopyOutputStream;
+using ::testing::_;
+using ::testing::Invoke;
+using ::testing::Return;
 
 class OpFakeClosure : public Closure {
  public:
@@ -406,13 +411,13 @@ TEST(ChunkOpRequestTest, OnApplyErrorTest) {
         request.set_size(size);
         request.set_sn(sn);
         brpc::Controller *cntl = new brpc::Controller();
-        ChunkOpRequest *opReq
-            = new ReadChunkRequest(nodePtr,
-                                   nullptr,
-                                   cntl,
-                                   &request,
-                                   &response,
-                                   nullptr);
+        std::shared_ptr<ChunkOpRequest> opReq
+            = std::make_shared<ReadChunkRequest>(nodePtr,
+                                                 nullptr,
+                                                 cntl,
+                                                 &request,
+                                                 &response,
+                                                 nullptr);
         dataStore->InjectError();
         OpFakeClosure done;
         opReq->OnApply(appliedIndex, &done);
@@ -420,7 +425,6 @@ TEST(ChunkOpRequestTest, OnApplyErrorTest) {
         ASSERT_EQ(0, cntl->ErrorCode());
         ASSERT_EQ(CHUNK_OP_STATUS::CHUNK_OP_STATUS_FAILURE_UNKNOWN,
                   response.status());
-        delete opReq;
         delete cntl;
     }
     // read: chunk not exist
@@ -435,13 +439,13 @@ TEST(ChunkOpRequestTest, OnApplyErrorTest) {
         request.set_size(size);
         request.set_sn(sn);
         brpc::Controller *cntl = new brpc::Controller();
-        ChunkOpRequest *opReq
-            = new ReadChunkRequest(nodePtr,
-                                   nullptr,
-                                   cntl,
-                                   &request,
-                                   &response,
-                                   nullptr);
+        std::shared_ptr<ChunkOpRequest> opReq
+            = std::make_shared<ReadChunkRequest>(nodePtr,
+                                                 nullptr,
+                                                 cntl,
+                                                 &request,
+                                                 &response,
+                                                 nullptr);
         dataStore->InjectError(CSErrorCode::ChunkNotExistError);
         OpFakeClosure done;
         opReq->OnApply(appliedIndex, &done);
@@ -449,7 +453,6 @@ TEST(ChunkOpRequestTest, OnApplyErrorTest) {
         ASSERT_EQ(0, cntl->ErrorCode());
         ASSERT_EQ(CHUNK_OP_STATUS::CHUNK_OP_STATUS_CHUNK_NOTEXIST,
                   response.status());
-        delete opReq;
         delete cntl;
     }
     // read snapshot: data store error
@@ -581,15 +584,15 @@ TEST(ChunkOpRequestTest, OnApplyErrorTest) {
         request.set_size(size);
         request.set_sn(sn);
         brpc::Controller *cntl = new brpc::Controller();
-        ChunkOpRequest *opReq = new WriteChunkRequest(nodePtr,
-                                                      cntl,
-                                                      &request,
-                                                      &response,
-                                                      nullptr);
+        std::shared_ptr<ChunkOpRequest> opReq =
+            std::make_shared<WriteChunkRequest>(nodePtr,
+                                                cntl,
+                                                &request,
+                                                &response,
+                                                nullptr);
         dataStore->InjectError();
         OpFakeClosure done;
         ASSERT_DEATH(opReq->OnApply(appliedIndex, &done), "");
-        delete opReq;
         delete cntl;
     }
     // write: backward request
@@ -604,11 +607,12 @@ TEST(ChunkOpRequestTest, OnApplyErrorTest) {
         request.set_size(size);
         request.set_sn(sn);
         brpc::Controller *cntl = new brpc::Controller();
-        ChunkOpRequest *opReq = new WriteChunkRequest(nodePtr,
-                                                      cntl,
-                                                      &request,
-                                                      &response,
-                                                      nullptr);
+        std::shared_ptr<ChunkOpRequest> opReq =
+            std::make_shared<WriteChunkRequest>(nodePtr,
+                                                cntl,
+                                                &request,
+                                                &response,
+                                                nullptr);
         dataStore->InjectError(CSErrorCode::BackwardRequestError);
         OpFakeClosure done;
         opReq->OnApply(appliedIndex, &done);
@@ -616,7 +620,6 @@ TEST(ChunkOpRequestTest, OnApplyErrorTest) {
         ASSERT_EQ(0, cntl->ErrorCode());
         ASSERT_EQ(CHUNK_OP_STATUS::CHUNK_OP_STATUS_BACKWARD,
                   response.status());
-        delete opReq;
         delete cntl;
     }
     // write: other failed
@@ -631,11 +634,12 @@ TEST(ChunkOpRequestTest, OnApplyErrorTest) {
         request.set_size(size);
         request.set_sn(sn);
         brpc::Controller *cntl = new brpc::Controller();
-        ChunkOpRequest *opReq = new WriteChunkRequest(nodePtr,
-                                                      cntl,
-                                                      &request,
-                                                      &response,
-                                                      nullptr);
+        std::shared_ptr<ChunkOpRequest> opReq =
+            std::make_shared<WriteChunkRequest>(nodePtr,
+                                                cntl,
+                                                &request,
+                                                &response,
+                                                nullptr);
         dataStore->InjectError(CSErrorCode::InvalidArgError);
         OpFakeClosure done;
         opReq->OnApply(appliedIndex, &done);
@@ -643,7 +647,6 @@ TEST(ChunkOpRequestTest, OnApplyErrorTest) {
         ASSERT_EQ(0, cntl->ErrorCode());
         ASSERT_EQ(CHUNK_OP_STATUS::CHUNK_OP_STATUS_FAILURE_UNKNOWN,
                   response.status());
-        delete opReq;
         delete cntl;
     }
     // scan: data store internal error
@@ -834,5 +837,398 @@ TEST(ChunkOpRequestTest, OnApplyFromLogTest) {
     }
 }
 
+TEST(ChunkOpRequestTest, WriteAheadTest) {
+    LogicPoolID logicPoolId = 1;
+    CopysetID copysetId = 10001;
+    uint64_t chunkId = 12345;
+    uint64_t sn = 1;
+    uint32_t size = 64 * 1024;
+    uint64_t appliedIndex = 12;
+
+    std::shared_ptr<LocalFileSystem>
+        fs(LocalFsFactory::CreateFs(FileSystemType::EXT4, ""));    //NOLINT
+    DataStoreOptions options;
+    options.baseDir = "./test-temp";
+    options.chunkSize = 16 * 1024 * 1024;
+    options.metaPageSize = 4 * 1024;
+    options.blockSize = 4 * 1024;
+    std::shared_ptr<FakeCSDataStore> dataStore =
+        std::make_shared<FakeCSDataStore>(options, fs);
+    std::shared_ptr<MockCopysetNode> nodePtr =
+        std::make_shared<MockCopysetNode>();
+    EXPECT_CALL(*nodePtr, GetDataStore()).WillRepeatedly(Return(dataStore));
+    EXPECT_CALL(*nodePtr, IsLeaderTerm()).WillRepeatedly(Return(true));
+    EXPECT_CALL(*nodePtr, WriteAheadAvailable()).WillRepeatedly(Return(true));
+
+    ChunkRequest request;
+    request.set_optype(CHUNK_OP_TYPE::CHUNK_OP_WRITE);
+    request.set_logicpoolid(logicPoolId);
+    request.set_copysetid(copysetId);
+    request.set_chunkid(chunkId);
+    request.set_offset(0);
+    request.set_size(size);
+    request.set_sn(sn);
+
+    // propose的日志解码后交给回调检查，task.done由测试释放
+    ChunkRequest logRequest;
+    butil::IOBuf logData;
+    auto decodeTask = [&](const braft::Task& task) {
+        logRequest.Clear();
+        logData.clear();
+        ASSERT_TRUE(ChunkOpRequest::Decode(*task.data, &logRequest, &logData,
+            0, PeerId("127.0.0.1:9010:0")) != nullptr);
+        delete task.done;
+    };
+
+    // chunk不存在，需要走正常的写日志流程
+    {
+        ChunkResponse response;
+        brpc::Controller cntl;
+        cntl.request_attachment().append(std::string(size, 'a'));
+        OpFakeClosure done;
+        auto opReq = std::make_shared<WriteChunkRequest>(
+            nodePtr, &cntl, &request, &response, &done);
+        EXPECT_CALL(*nodePtr, Propose(_)).WillOnce(Invoke(decodeTask));
+        opReq->Process();
+        ASSERT_FALSE(logRequest.has_writeaheadcrc());
+        ASSERT_EQ(size, logData.size());
+        opReq->OnApplyFromLog(dataStore, logRequest, logData);
+    }
+    // chunk存在且不需要cow，数据先写chunk文件，日志中只有crc
+    {
+        ChunkResponse response;
+        brpc::Controller cntl;
+        std::string str(size, 'b');
+        cntl.request_attachment().append(str);
+        OpFakeClosure done;
+        auto opReq = std::make_shared<WriteChunkRequest>(
+            nodePtr, &cntl, &request, &response, &done);
+        EXPECT_CALL(*nodePtr, Propose(_)).WillOnce(Invoke(decodeTask));
+        opReq->Process();
+        ASSERT_TRUE(logRequest.has_writeaheadcrc());
+        ASSERT_EQ(curve::common::CRC32(str.c_str(), size),
+                  logRequest.writeaheadcrc());
+        ASSERT_EQ(0, logData.size());
+
+        char buf[4096];
+        ASSERT_EQ(CSErrorCode::Success,
+                  dataStore->ReadChunk(chunkId, sn, buf, size - 4096, 4096));
+        ASSERT_EQ(std::string(4096, 'b'), std::string(buf, 4096));
+
+        // apply时不再写数据
+        EXPECT_CALL(*nodePtr, UpdateAppliedIndex(appliedIndex)).Times(1);
+        EXPECT_CALL(*nodePtr, GetAppliedIndex())
+            .WillOnce(Return(appliedIndex));
+        dataStore->InjectError();
+        opReq->OnApply(appliedIndex, &done);
+        ASSERT_EQ(CHUNK_OP_STATUS::CHUNK_OP_STATUS_SUCCESS, response.status());
+        ASSERT_EQ(appliedIndex, response.appliedindex());
+        ASSERT_EQ(CSErrorCode::InternalError, dataStore->HasInjectError());
+
+        // 回放日志时只校验数据
+        WriteChunkRequest req;
+        req.OnApplyFromLog(dataStore, logRequest, logData);
+        ASSERT_EQ(CSErrorCode::Success,
+                  dataStore->ReadChunk(chunkId, sn, buf, 0, 4096));
+        ASSERT_EQ(std::string(4096, 'b'), std::string(buf, 4096));
+
+        // 本地数据和日志不一致说明副本已经不一致，不能继续运行
+        ChunkRequest badRequest(logRequest);
+        badRequest.set_writeaheadcrc(logRequest.writeaheadcrc() + 1);
+        ASSERT_DEATH(req.OnApplyFromLog(dataStore, badRequest, logData), "");
+    }
+    // 小于writeAheadMinSize的请求走正常流程
+    {
+        ChunkResponse response;
+        brpc::Controller cntl;
+        request.set_size(4096);
+        cntl.request_attachment().append(std::string(4096, 'c'));
+        OpFakeClosure done;
+        auto opReq = std::make_shared<WriteChunkRequest>(
+            nodePtr, &cntl, &request, &response, &done);
+        EXPECT_CALL(*nodePtr, Propose(_)).WillOnce(Invoke(decodeTask));
+        opReq->Process();
+        ASSERT_FALSE(logRequest.has_writeaheadcrc());
+        ASSERT_EQ(4096, logData.size());
+    }
+    ASSERT_EQ(0, nodePtr->GetInflightChunkRanges()->Size());
+}
+
+TEST(ChunkOpRequestTest, BatchWriteTest) {
+    LogicPoolID logicPoolId = 1;
+    CopysetID copysetId = 10001;
+    uint64_t sn = 1;
+    uint32_t size = 4096;
+    uint64_t appliedIndex = 12;
+    const int kSubCount = 3;
+
+    std::shared_ptr<LocalFileSystem>
+        fs(LocalFsFactory::CreateFs(FileSystemType::EXT4, ""));    //NOLINT
+    DataStoreOptions options;
+    options.baseDir = "./test-temp";
+    options.chunkSize = 16 * 1024 * 1024;
+    options.metaPageSize = 4 * 1024;
+    options.blockSize = 4 * 1024;
+    std::shared_ptr<FakeCSDataStore> dataStore =
+        std::make_shared<FakeCSDataStore>(options, fs);
+    ConcurrentApplyModule concurrentModule;
+    // FakeCSDataStore不是线程安全的，只用一个写线程
+    ConcurrentApplyOption opt{1, 1, 1, 1};
+    ASSERT_TRUE(concurrentModule.Init(opt));
+    std::shared_ptr<MockCopysetNode> nodePtr =
+        std::make_shared<MockCopysetNode>();
+    EXPECT_CALL(*nodePtr, GetDataStore()).WillRepeatedly(Return(dataStore));
+    EXPECT_CALL(*nodePtr, GetConcurrentApplyModule())
+        .WillRepeatedly(Return(&concurrentModule));
+    EXPECT_CALL(*nodePtr, IsLeaderTerm()).WillRepeatedly(Return(true));
+
+    // 前两个子请求写同一个chunk，第三个写另一个chunk，
+    // FakeCSDataStore所有chunk共用一块内存，各个子请求的区间不重叠
+    BatchChunkRequest request;
+    request.set_optype(CHUNK_OP_TYPE::CHUNK_OP_WRITE);
+    request.set_logicpoolid(logicPoolId);
+    request.set_copysetid(copysetId);
+    brpc::Controller cntl;
+    for (int i = 0; i < kSubCount; ++i) {
+        ChunkRequest *sub = request.add_requests();
+        sub->set_optype(CHUNK_OP_TYPE::CHUNK_OP_WRITE);
+        sub->set_logicpoolid(logicPoolId);
+        sub->set_copysetid(copysetId);
+        sub->set_chunkid(i < 2 ? 1 : 2);
+        sub->set_offset(i * size);
+        sub->set_size(size);
+        sub->set_sn(sn);
+        cntl.request_attachment().append(std::string(size, 'a' + i));
+    }
+
+    // 整个批量请求只propose一条日志
+    ChunkRequest logRequest;
+    butil::IOBuf logData;
+    EXPECT_CALL(*nodePtr, Propose(_))
+        .WillOnce(Invoke([&](const braft::Task& task) {
+            auto opReq = ChunkOpRequest::Decode(*task.data, &logRequest,
+                &logData, 0, PeerId("127.0.0.1:9010:0"));
+            ASSERT_TRUE(dynamic_cast<BatchWriteChunkRequest*>(opReq.get())
+                        != nullptr);
+            delete task.done;
+        }));
+
+    BatchChunkResponse response;
+    OpFakeClosure done;
+    auto opReq = std::make_shared<BatchWriteChunkRequest>(
+        nodePtr, &cntl, &request, &response, &done);
+    opReq->Process();
+    ASSERT_EQ(CHUNK_OP_TYPE::CHUNK_OP_BATCH_WRITE, logRequest.optype());
+    ASSERT_EQ(logicPoolId, logRequest.logicpoolid());
+    ASSERT_EQ(copysetId, logRequest.copysetid());
+
+    BatchChunkRequest logBatch;
+    butil::IOBuf payload;
+    ASSERT_EQ(0, BatchWriteChunkRequest::DecodeBatch(logData, &logBatch,
+                                                     &payload));
+    ASSERT_EQ(kSubCount, logBatch.requests_size());
+    ASSERT_EQ(cntl.request_attachment().to_string(), payload.to_string());
+
+    // leader apply，每个子请求在各自chunk的队列中执行，全部完成后返回
+    {
+        curve::common::CountDownEvent cond(1);
+        class SignalClosure : public Closure {
+         public:
+            explicit SignalClosure(curve::common::CountDownEvent *cond)
+                : cond_(cond) {}
+            void Run() override { cond_->Signal(); }
+         private:
+            curve::common::CountDownEvent *cond_;
+        } applyDone(&cond);
+
+        EXPECT_CALL(*nodePtr, UpdateAppliedIndex(appliedIndex))
+            .Times(kSubCount);
+        EXPECT_CALL(*nodePtr, GetAppliedIndex())
+            .WillRepeatedly(Return(appliedIndex));
+        opReq->OnApply(appliedIndex, &applyDone);
+        cond.Wait();
+
+        ASSERT_EQ(CHUNK_OP_STATUS::CHUNK_OP_STATUS_SUCCESS, response.status());
+        ASSERT_EQ(kSubCount, response.responses_size());
+        for (int i = 0; i < kSubCount; ++i) {
+            ASSERT_EQ(CHUNK_OP_STATUS::CHUNK_OP_STATUS_SUCCESS,
+                      response.responses(i).status());
+            ASSERT_EQ(appliedIndex, response.responses(i).appliedindex());
+        }
+
+        char buf[4096];
+        ASSERT_EQ(CSErrorCode::Success,
+                  dataStore->ReadChunk(1, sn, buf, size, size));
+        ASSERT_EQ(std::string(size, 'b'), std::string(buf, size));
+        ASSERT_EQ(CSErrorCode::Success,
+                  dataStore->ReadChunk(2, sn, buf, 2 * size, size));
+        ASSERT_EQ(std::string(size, 'c'), std::string(buf, size));
+    }
+
+    // follower apply，从日志中拆分子请求
+    {
+        std::shared_ptr<FakeCSDataStore> followerStore =
+            std::make_shared<FakeCSDataStore>(options, fs);
+        BatchWriteChunkRequest::ApplyFromLog(&concurrentModule, followerStore,
+                                             logData);
+        concurrentModule.Flush();
+
+        char buf[4096];
+        ASSERT_EQ(CSErrorCode::Success,
+                  followerStore->ReadChunk(1, sn, buf, 0, size));
+        ASSERT_EQ(std::string(size, 'a'), std::string(buf, size));
+        ASSERT_EQ(CSErrorCode::Success,
+                  followerStore->ReadChunk(2, sn, buf, 2 * size, size));
+        ASSERT_EQ(std::string(size, 'c'), std::string(buf, size));
+    }
+
+    // 回放日志，在当前线程中依次执行
+    {
+        std::shared_ptr<FakeCSDataStore> replayStore =
+            std::make_shared<FakeCSDataStore>(options, fs);
+        BatchWriteChunkRequest req;
+        req.OnApplyFromLog(replayStore, logRequest, logData);
+
+        char buf[4096];
+        ASSERT_EQ(CSErrorCode::Success,
+                  replayStore->ReadChunk(1, sn, buf, size, size));
+        ASSERT_EQ(std::string(size, 'b'), std::string(buf, size));
+    }
+
+    // 非leader时整个请求重定向
+    {
+        EXPECT_CALL(*nodePtr, IsLeaderTerm()).WillRepeatedly(Return(false));
+        BatchChunkResponse redirectResponse;
+        auto redirectReq = std::make_shared<BatchWriteChunkRequest>(
+            nodePtr, &cntl, &request, &redirectResponse, &done);
+        redirectReq->Process();
+        ASSERT_EQ(CHUNK_OP_STATUS::CHUNK_OP_STATUS_REDIRECTED,
+                  redirectResponse.status());
+    }
+    concurrentModule.Stop();
+}
+
+
+TEST(ChunkOpRequestTest, BatchDeleteTest) {
+    LogicPoolID logicPoolId = 1;
+    CopysetID copysetId = 10001;
+    uint64_t sn = 1;
+    uint64_t appliedIndex = 13;
+    const int kSubCount = 3;
+
+    std::shared_ptr<LocalFileSystem>
+        fs(LocalFsFactory::CreateFs(FileSystemType::EXT4, ""));    //NOLINT
+    DataStoreOptions options;
+    options.baseDir = "./test-temp";
+    options.chunkSize = 16 * 1024 * 1024;
+    options.metaPageSize = 4 * 1024;
+    options.blockSize = 4 * 1024;
+    std::shared_ptr<FakeCSDataStore> dataStore =
+        std::make_shared<FakeCSDataStore>(options, fs);
+    ConcurrentApplyModule concurrentModule;
+    ConcurrentApplyOption opt{1, 1, 1, 1};
+    ASSERT_TRUE(concurrentModule.Init(opt));
+    std::shared_ptr<MockCopysetNode> nodePtr =
+        std::make_shared<MockCopysetNode>();
+    EXPECT_CALL(*nodePtr, GetDataStore()).WillRepeatedly(Return(dataStore));
+    EXPECT_CALL(*nodePtr, GetConcurrentApplyModule())
+        .WillRepeatedly(Return(&concurrentModule));
+    EXPECT_CALL(*nodePtr, IsLeaderTerm()).WillRepeatedly(Return(true));
+
+    BatchChunkRequest request;
+    request.set_optype(CHUNK_OP_TYPE::CHUNK_OP_DELETE);
+    request.set_logicpoolid(logicPoolId);
+    request.set_copysetid(copysetId);
+    uint32_t cost;
+    butil::IOBuf data;
+    data.append(std::string(4096, 'a'));
+    for (int i = 0; i < kSubCount; ++i) {
+        ChunkRequest *sub = request.add_requests();
+        sub->set_optype(CHUNK_OP_TYPE::CHUNK_OP_DELETE);
+        sub->set_logicpoolid(logicPoolId);
+        sub->set_copysetid(copysetId);
+        sub->set_chunkid(i + 1);
+        sub->set_sn(sn);
+        ASSERT_EQ(CSErrorCode::Success,
+                  dataStore->WriteChunk(i + 1, sn, data, 0, 4096, &cost));
+    }
+
+    ChunkRequest logRequest;
+    butil::IOBuf logData;
+    EXPECT_CALL(*nodePtr, Propose(_))
+        .WillOnce(Invoke([&](const braft::Task& task) {
+            ChunkOpRequest::Decode(*task.data, &logRequest, &logData, 0,
+                                   PeerId("127.0.0.1:9010:0"));
+            delete task.done;
+        }));
+
+    brpc::Controller cntl;
+    BatchChunkResponse response;
+    OpFakeClosure done;
+    auto opReq = std::make_shared<BatchWriteChunkRequest>(
+        nodePtr, &cntl, &request, &response, &done);
+    opReq->Process();
+    ASSERT_EQ(CHUNK_OP_TYPE::CHUNK_OP_BATCH_WRITE, logRequest.optype());
+
+    // leader apply，每个子请求删除一个chunk
+    {
+        curve::common::CountDownEvent cond(1);
+        class SignalClosure : public Closure {
+         public:
+            explicit SignalClosure(curve::common::CountDownEvent *cond)
+                : cond_(cond) {}
+            void Run() override { cond_->Signal(); }
+         private:
+            curve::common::CountDownEvent *cond_;
+        } applyDone(&cond);
+
+        EXPECT_CALL(*nodePtr, UpdateAppliedIndex(appliedIndex))
+            .Times(kSubCount);
+        EXPECT_CALL(*nodePtr, GetAppliedIndex())
+            .WillRepeatedly(Return(appliedIndex));
+        opReq->OnApply(appliedIndex, &applyDone);
+        cond.Wait();
+
+        ASSERT_EQ(CHUNK_OP_STATUS::CHUNK_OP_STATUS_SUCCESS, response.status());
+        ASSERT_EQ(kSubCount, response.responses_size());
+        CSChunkInfo info;
+        for (int i = 0; i < kSubCount; ++i) {
+            ASSERT_EQ(CHUNK_OP_STATUS::CHUNK_OP_STATUS_SUCCESS,
+                      response.responses(i).status());
+            ASSERT_EQ(CSErrorCode::ChunkNotExistError,
+                      dataStore->GetChunkInfo(i + 1, &info));
+        }
+    }
+
+    // follower apply和回放日志
+    {
+        std::shared_ptr<FakeCSDataStore> followerStore =
+            std::make_shared<FakeCSDataStore>(options, fs);
+        std::shared_ptr<FakeCSDataStore> replayStore =
+            std::make_shared<FakeCSDataStore>(options, fs);
+        for (int i = 0; i < kSubCount; ++i) {
+            ASSERT_EQ(CSErrorCode::Success, followerStore->WriteChunk(
+                i + 1, sn, data, 0, 4096, &cost));
+            ASSERT_EQ(CSErrorCode::Success, replayStore->WriteChunk(
+                i + 1, sn, data, 0, 4096, &cost));
+        }
+
+        BatchWriteChunkRequest::ApplyFromLog(&concurrentModule, followerStore,
+                                             logData);
+        concurrentModule.Flush();
+        BatchWriteChunkRequest req;
+        req.OnApplyFromLog(replayStore, logRequest, logData);
+
+        CSChunkInfo info;
+        for (int i = 0; i < kSubCount; ++i) {
+            ASSERT_EQ(CSErrorCode::ChunkNotExistError,
+                      followerStore->GetChunkInfo(i + 1, &info));
+            ASSERT_EQ(CSErrorCode::ChunkNotExistError,
+                      replayStore->GetChunkInfo(i + 1, &info));
+        }
+    }
+    concurrentModule.Stop();
+}
+
 }  // namespace chunkserver
 }  // namespace curve
@@ -0,0 +1,146 @@
+/*
+ *  Copyright (c) 2023 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+// Micro benchmark for CurveSegmentLogStorage::append_entries, reports
+// entries/sec for different number of entries per append_entries call.
+//
+// Usage:
+//   curve-segment-append-bench -bench_dir=/data/wal_bench -entry_size=4096
+
+#include <gflags/gflags.h>
+#include <glog/logging.h>
+#include <butil/time.h>
+#include <braft/log_entry.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "src/chunkserver/datastore/file_pool.h"
+#include "src/chunkserver/raftlog/curve_segment.h"
+#include "src/chunkserver/raftlog/curve_segment_log_storage.h"
+#include "src/fs/local_filesystem.h"
+
+DEFINE_string(bench_dir, "./wal_bench", "directory to put wal segments");
+DEFINE_int32(entry_size, 4096, "payload size of each log entry");
+DEFINE_int32(entry_count, 20000, "log entries appended for each batch size");
+DEFINE_int32(max_batch_size, 64, "max entries per append_entries call");
+DEFINE_uint32(segment_size, 8 * 1024 * 1024, "wal segment size");
+DEFINE_bool(compare_unbatched, true,
+            "also run with enableWalBatchAppend=false for comparison");
+
+using curve::chunkserver::CurveSegmentLogStorage;
+using curve::chunkserver::FilePool;
+using curve::chunkserver::FilePoolOptions;
+using curve::fs::FileSystemType;
+using curve::fs::LocalFsFactory;
+
+namespace {
+
+std::shared_ptr<FilePool> InitFilePool(const std::string& dir) {
+    auto fs = LocalFsFactory::CreateFs(FileSystemType::EXT4, "");
+    FilePoolOptions opt;
+    opt.getFileFromPool = false;
+    opt.fileSize = FLAGS_segment_size;
+    opt.metaPageSize = 4096;
+    opt.blockSize = 4096;
+    snprintf(opt.filePoolDir, sizeof(opt.filePoolDir), "%s/pool",
+             dir.c_str());
+    auto pool = std::make_shared<FilePool>(fs);
+    if (!pool->Initialize(opt)) {
+        LOG(ERROR) << "Init wal file pool failed, dir: " << dir;
+        return nullptr;
+    }
+    return pool;
+}
+
+// return entries/sec, or -1 on failure
+double RunOnce(int batch_size) {
+    std::string dir = FLAGS_bench_dir + "/batch_" + std::to_string(batch_size);
+    std::string cmd = "rm -rf " + dir + " && mkdir -p " + dir;
+    if (::system(cmd.c_str()) != 0) {
+        return -1;
+    }
+    auto pool = InitFilePool(dir);
+    if (pool == nullptr) {
+        return -1;
+    }
+    CurveSegmentLogStorage storage(dir + "/log", true, pool);
+    braft::ConfigurationManager configuration_manager;
+    if (storage.init(&configuration_manager) != 0) {
+        LOG(ERROR) << "Init log storage failed, dir: " << dir;
+        return -1;
+    }
+
+    std::string payload(FLAGS_entry_size, 'x');
+    braft::IOMetric metric;
+    int64_t index = 1;
+    butil::Timer timer;
+    timer.start();
+    while (index <= FLAGS_entry_count) {
+        std::vector<braft::LogEntry*> entries;
+        for (int i = 0; i < batch_size && index <= FLAGS_entry_count; i++) {
+            braft::LogEntry* entry = new braft::LogEntry();
+            entry->AddRef();
+            entry->type = braft::ENTRY_TYPE_DATA;
+            entry->id.term = 1;
+            entry->id.index = index++;
+            entry->data.append(payload);
+            entries.push_back(entry);
+        }
+        int ret = storage.append_entries(entries, &metric);
+        for (auto entry : entries) {
+            entry->Release();
+        }
+        if (ret != static_cast<int>(entries.size())) {
+            LOG(ERROR) << "append entries failed, expect " << entries.size()
+                       << ", appended " << ret;
+            return -1;
+        }
+    }
+    timer.stop();
+
+    cmd = "rm -rf " + dir;
+    ::system(cmd.c_str());
+    return FLAGS_entry_count * 1000000.0 / std::max<int64_t>(timer.u_elapsed(),
+                                                             1);
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    google::ParseCommandLineFlags(&argc, &argv, true);
+    google::InitGoogleLogging(argv[0]);
+
+    printf("%-12s %-20s %-20s\n", "batch_size", "batched(entries/s)",
+           "unbatched(entries/s)");
+    for (int batch = 1; batch <= FLAGS_max_batch_size; batch <<= 1) {
+        curve::chunkserver::FLAGS_enableWalBatchAppend = true;
+        double batched = RunOnce(batch);
+        double unbatched = 0;
+        if (FLAGS_compare_unbatched) {
+            curve::chunkserver::FLAGS_enableWalBatchAppend = false;
+            unbatched = RunOnce(batch);
+        }
+        if (batched < 0 || unbatched < 0) {
+            return -1;
+        }
+        printf("%-12d %-20.0f %-20.0f\n", batch, batched, unbatched);
+    }
+    return 0;
+}
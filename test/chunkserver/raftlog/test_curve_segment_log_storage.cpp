@@ -438,6 +438,49 @@ TEST_F(CurveSegmentLogStorageTest, compatibility) {
     delete configuration_manager;
 }
 
+TEST_F(CurveSegmentLogStorageTest, batch_append_across_segments) {
+    FLAGS_enableWalDirectWrite = true;
+    FLAGS_enableWalBatchAppend = true;
+    auto storage = std::make_shared<CurveSegmentLogStorage>(kRaftLogDataDir,
+            true, file_pool);
+    braft::ConfigurationManager* configuration_manager =
+                                new braft::ConfigurationManager;
+    ASSERT_EQ(0, storage->init(configuration_manager));
+
+    // 2048 entries per segment, batch of 48 entries will be split
+    // at the segment boundary
+    std::string path = kRaftLogDataDir;
+    butil::string_appendf(&path, "/" CURVE_SEGMENT_OPEN_PATTERN, 1L);
+    ASSERT_EQ(0,  prepare_segment(path));
+    path = kRaftLogDataDir;
+    butil::string_appendf(&path, "/" CURVE_SEGMENT_OPEN_PATTERN, 2049L);
+    ASSERT_EQ(0,  prepare_segment(path));
+    append_entries(storage, 80, 48);
+    ASSERT_EQ(1, storage->first_log_index());
+    ASSERT_EQ(3840, storage->last_log_index());
+    ASSERT_EQ(2, storage->GetStatus().walSegmentFileCount);
+    ASSERT_EQ(2048, storage->segments().begin()->second->last_index());
+    read_entries(storage, 0, 3840);
+
+    storage = nullptr;
+    delete configuration_manager;
+
+    // reload, entries written in batch should be loaded one by one
+    storage = std::make_shared<CurveSegmentLogStorage>(kRaftLogDataDir,
+            true, file_pool);
+    configuration_manager = new braft::ConfigurationManager;
+    ASSERT_EQ(0, storage->init(configuration_manager));
+    ASSERT_EQ(1, storage->first_log_index());
+    ASSERT_EQ(3840, storage->last_log_index());
+    read_entries(storage, 0, 3840);
+
+    // truncate in the middle of a batch
+    ASSERT_EQ(0, storage->truncate_suffix(3000));
+    ASSERT_EQ(3000, storage->last_log_index());
+    read_entries(storage, 0, 3000);
+    delete configuration_manager;
+}
+
 TEST_F(CurveSegmentLogStorageTest, basic_test_without_direct) {
     FLAGS_enableWalDirectWrite = false;
     auto storage = std::make_shared<CurveSegmentLogStorage>(kRaftLogDataDir,
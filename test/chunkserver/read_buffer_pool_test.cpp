@@ -0,0 +1,91 @@
+/*
+ *  Copyright (c) 2023 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <cstring>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "src/chunkserver/read_buffer_pool.h"
+
+namespace curve {
+namespace chunkserver {
+
+TEST(ReadBufferPoolTest, AllocAndFree) {
+    ReadBufferPool* pool = ReadBufferPool::GetInstance();
+    ReadBufferPool::Deleter deleter = nullptr;
+
+    // 第一次分配未命中，释放后同一线程再分配命中
+    uint64_t hit = pool->GetHitCount();
+    uint64_t miss = pool->GetMissCount();
+    char* buf = pool->Alloc(12 * 1024, &deleter);
+    ASSERT_TRUE(buf != nullptr);
+    ASSERT_EQ(0, reinterpret_cast<uintptr_t>(buf) %
+                 ReadBufferPool::kAlignment);
+    ASSERT_EQ(miss + 1, pool->GetMissCount());
+    // 按大小等级分配，可以写满16KB
+    memset(buf, 'a', 16 * 1024);
+    deleter(buf);
+    ASSERT_GE(pool->GetCachedBytes(), 16 * 1024);
+
+    char* buf2 = pool->Alloc(16 * 1024, &deleter);
+    ASSERT_EQ(buf, buf2);
+    ASSERT_EQ(hit + 1, pool->GetHitCount());
+    deleter(buf2);
+
+    // 超过最大等级的不经过池子
+    miss = pool->GetMissCount();
+    char* large = pool->Alloc(ReadBufferPool::kMaxClassSize + 1, &deleter);
+    ASSERT_EQ(0, reinterpret_cast<uintptr_t>(large) %
+                 ReadBufferPool::kAlignment);
+    ASSERT_EQ(miss + 1, pool->GetMissCount());
+    deleter(large);
+}
+
+TEST(ReadBufferPoolTest, FreeInOtherThread) {
+    ReadBufferPool* pool = ReadBufferPool::GetInstance();
+    const int kBufNum = 64;
+    const size_t kSize = 64 * 1024;
+
+    // 模拟apply线程分配，brpc线程释放
+    std::vector<char*> bufs;
+    ReadBufferPool::Deleter deleter = nullptr;
+    for (int i = 0; i < kBufNum; ++i) {
+        bufs.push_back(pool->Alloc(kSize, &deleter));
+    }
+    std::thread th([&]() {
+        for (auto buf : bufs) {
+            deleter(buf);
+        }
+    });
+    th.join();
+
+    // 释放线程退出后buffer回到全局池，分配线程可以复用
+    uint64_t hit = pool->GetHitCount();
+    bufs.clear();
+    for (int i = 0; i < kBufNum; ++i) {
+        bufs.push_back(pool->Alloc(kSize, &deleter));
+    }
+    ASSERT_EQ(hit + kBufNum, pool->GetHitCount());
+    for (auto buf : bufs) {
+        deleter(buf);
+    }
+}
+
+}  // namespace chunkserver
+}  // namespace curve
@@ -0,0 +1,197 @@
+/*
+ *  Copyright (c) 2023 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include "src/client/block_cache.h"
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <string>
+
+namespace curve {
+namespace client {
+
+namespace {
+
+const uint64_t kBlockSize = 4096;
+
+butil::IOBuf MakeData(uint64_t length, char c) {
+    butil::IOBuf data;
+    data.append(std::string(length, c));
+    return data;
+}
+
+}  // namespace
+
+class BlockCacheTest : public ::testing::Test {
+ public:
+    void SetUp() override {
+        option_.enable = true;
+        option_.blockSizeKB = kBlockSize / 1024;
+        option_.capacityMB = 1;
+        option_.shardNum = 4;
+        metric_.reset(new BlockCacheMetric("BlockCacheTest"));
+        cache_.reset(new BlockCache(option_, metric_.get()));
+    }
+
+ protected:
+    BlockCacheOption option_;
+    std::unique_ptr<BlockCacheMetric> metric_;
+    std::unique_ptr<BlockCache> cache_;
+};
+
+TEST_F(BlockCacheTest, CheckOptionTest) {
+    ASSERT_TRUE(BlockCache::CheckOption(option_));
+
+    BlockCacheOption option = option_;
+    option.blockSizeKB = 2;
+    ASSERT_FALSE(BlockCache::CheckOption(option));
+    option.blockSizeKB = 128;
+    ASSERT_FALSE(BlockCache::CheckOption(option));
+    option.blockSizeKB = 12;
+    ASSERT_FALSE(BlockCache::CheckOption(option));
+
+    option = option_;
+    option.shardNum = 0;
+    ASSERT_FALSE(BlockCache::CheckOption(option));
+}
+
+TEST_F(BlockCacheTest, AlignRangeTest) {
+    uint64_t offset = 0;
+    uint64_t length = 0;
+    cache_->AlignRange(100, 10, 1 << 20, &offset, &length);
+    ASSERT_EQ(0, offset);
+    ASSERT_EQ(kBlockSize, length);
+
+    cache_->AlignRange(kBlockSize - 1, 2, 1 << 20, &offset, &length);
+    ASSERT_EQ(0, offset);
+    ASSERT_EQ(2 * kBlockSize, length);
+
+    // never exceeds file length
+    cache_->AlignRange(kBlockSize, 10, kBlockSize + 100, &offset, &length);
+    ASSERT_EQ(kBlockSize, offset);
+    ASSERT_EQ(100, length);
+}
+
+TEST_F(BlockCacheTest, ReadFillTest) {
+    butil::IOBuf data;
+    ASSERT_FALSE(cache_->Read(0, kBlockSize, &data));
+    ASSERT_EQ(1, metric_->miss.get_value());
+
+    butil::IOBuf fill = MakeData(kBlockSize, 'a');
+    fill.append(MakeData(kBlockSize, 'b'));
+    // tail smaller than a block is not cached
+    fill.append(MakeData(100, 'c'));
+    cache_->Fill(cache_->Epoch(), 0, fill);
+    ASSERT_EQ(2 * kBlockSize, cache_->CachedBytes());
+
+    ASSERT_TRUE(cache_->Read(kBlockSize - 10, 20, &data));
+    ASSERT_EQ(std::string(10, 'a') + std::string(10, 'b'), data.to_string());
+    ASSERT_EQ(1, metric_->hit.get_value());
+
+    ASSERT_FALSE(cache_->Read(kBlockSize, kBlockSize + 1, &data));
+    ASSERT_EQ(2, metric_->miss.get_value());
+
+    // unaligned fill is ignored
+    cache_->Fill(cache_->Epoch(), 10, MakeData(kBlockSize, 'd'));
+    ASSERT_EQ(2 * kBlockSize, cache_->CachedBytes());
+}
+
+TEST_F(BlockCacheTest, InvalidateTest) {
+    cache_->Fill(cache_->Epoch(), 0, MakeData(4 * kBlockSize, 'a'));
+    ASSERT_EQ(4 * kBlockSize, cache_->CachedBytes());
+
+    butil::IOBuf data;
+    cache_->Invalidate(kBlockSize + 1, 1);
+    ASSERT_FALSE(cache_->Read(kBlockSize, 10, &data));
+    ASSERT_TRUE(cache_->Read(0, kBlockSize, &data));
+    ASSERT_TRUE(cache_->Read(2 * kBlockSize, 2 * kBlockSize, &data));
+    ASSERT_EQ(1, metric_->invalidate.get_value());
+
+    // large range is handled by scanning cached blocks
+    cache_->Invalidate(0, 1ull << 40);
+    ASSERT_EQ(0, cache_->CachedBytes());
+    ASSERT_EQ(4, metric_->invalidate.get_value());
+
+    cache_->Fill(cache_->Epoch(), 0, MakeData(4 * kBlockSize, 'a'));
+    cache_->InvalidateAll();
+    ASSERT_EQ(0, cache_->CachedBytes());
+    ASSERT_EQ(0, metric_->cachedBytes.get_value());
+}
+
+TEST_F(BlockCacheTest, StaleFillTest) {
+    uint64_t epoch = cache_->Epoch();
+    // a write happens while reading from chunkserver
+    cache_->Invalidate(0, kBlockSize);
+    cache_->Fill(epoch, 0, MakeData(kBlockSize, 'a'));
+    ASSERT_EQ(0, cache_->CachedBytes());
+
+    epoch = cache_->Epoch();
+    cache_->Fill(epoch, 0, MakeData(kBlockSize, 'a'));
+    ASSERT_EQ(kBlockSize, cache_->CachedBytes());
+
+    // only the blocks overlapped with the write are not filled
+    cache_->InvalidateAll();
+    epoch = cache_->Epoch();
+    cache_->Invalidate(kBlockSize + 1, 1);
+    cache_->Invalidate(100 * kBlockSize, kBlockSize);
+    cache_->Fill(epoch, 0, MakeData(4 * kBlockSize, 'a'));
+    ASSERT_EQ(3 * kBlockSize, cache_->CachedBytes());
+    butil::IOBuf data;
+    ASSERT_FALSE(cache_->Read(kBlockSize, 1, &data));
+    ASSERT_TRUE(cache_->Read(2 * kBlockSize, 2 * kBlockSize, &data));
+
+    // fill older than the invalidations kept is discarded
+    cache_->InvalidateAll();
+    epoch = cache_->Epoch();
+    for (int i = 0; i < 1000; ++i) {
+        cache_->Invalidate((100 + i) * kBlockSize, kBlockSize);
+    }
+    cache_->Fill(epoch, 0, MakeData(4 * kBlockSize, 'a'));
+    ASSERT_EQ(0, cache_->CachedBytes());
+
+    // fill older than InvalidateAll is discarded
+    epoch = cache_->Epoch();
+    cache_->InvalidateAll();
+    cache_->Fill(epoch, 0, MakeData(4 * kBlockSize, 'a'));
+    ASSERT_EQ(0, cache_->CachedBytes());
+}
+
+TEST_F(BlockCacheTest, EvictTest) {
+    option_.capacityMB = 1;
+    option_.shardNum = 1;
+    cache_.reset(new BlockCache(option_, metric_.get()));
+
+    uint64_t blocks = (1 << 20) / kBlockSize;
+    cache_->Fill(cache_->Epoch(), 0, MakeData(blocks * kBlockSize, 'a'));
+    ASSERT_EQ(blocks * kBlockSize, cache_->CachedBytes());
+    ASSERT_EQ(0, metric_->evict.get_value());
+
+    // touch block 0, block 1 is the least recently used
+    butil::IOBuf data;
+    ASSERT_TRUE(cache_->Read(0, 1, &data));
+    cache_->Fill(cache_->Epoch(), blocks * kBlockSize,
+                 MakeData(kBlockSize, 'b'));
+    ASSERT_EQ(blocks * kBlockSize, cache_->CachedBytes());
+    ASSERT_EQ(1, metric_->evict.get_value());
+    ASSERT_TRUE(cache_->Read(0, 1, &data));
+    ASSERT_FALSE(cache_->Read(kBlockSize, 1, &data));
+    ASSERT_TRUE(cache_->Read(blocks * kBlockSize, kBlockSize, &data));
+    ASSERT_EQ(std::string(kBlockSize, 'b'), data.to_string());
+}
+
+}  // namespace client
+}  // namespace curve
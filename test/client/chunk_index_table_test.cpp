@@ -0,0 +1,118 @@
+/*
+ *  Copyright (c) 2023 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include "src/client/chunk_index_table.h"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <limits>
+#include <thread>  // NOLINT
+#include <vector>
+
+namespace curve {
+namespace client {
+
+TEST(ChunkIndexTableTest, SetGetTest) {
+    ChunkIndexTable table;
+    ChunkIDInfo info;
+    ASSERT_FALSE(table.Get(0, &info));
+
+    table.Set(1, ChunkIDInfo(100, 2, 3));
+    ASSERT_TRUE(table.Get(1, &info));
+    ASSERT_EQ(100, info.cid_);
+    ASSERT_EQ(2, info.lpid_);
+    ASSERT_EQ(3, info.cpid_);
+    ASSERT_TRUE(info.chunkExist);
+    ASSERT_FALSE(table.Get(0, &info));
+    ASSERT_FALSE(table.Get(2, &info));
+
+    // unallocated chunk is cached too
+    ChunkIDInfo notExist(0, 0, 0);
+    notExist.chunkExist = false;
+    const ChunkIndex last = std::numeric_limits<ChunkIndex>::max();
+    table.Set(last, notExist);
+    ASSERT_TRUE(table.Get(last, &info));
+    ASSERT_FALSE(info.chunkExist);
+
+    table.Set(1, ChunkIDInfo(101, 2, 3));
+    ASSERT_TRUE(table.Get(1, &info));
+    ASSERT_EQ(101, info.cid_);
+}
+
+TEST(ChunkIndexTableTest, EraseTest) {
+    ChunkIndexTable table;
+    const ChunkIndex count = 5000;
+    for (ChunkIndex i = 0; i < count; ++i) {
+        table.Set(i, ChunkIDInfo(i, 1, 1));
+    }
+
+    // across several blocks
+    table.Erase(1000, 3000);
+    // not set before
+    table.Erase(1u << 30, (1u << 30) + 1024);
+
+    ChunkIDInfo info;
+    for (ChunkIndex i = 0; i < count; ++i) {
+        ASSERT_EQ(i < 1000 || i >= 3000, table.Get(i, &info)) << i;
+    }
+
+    table.Set(2000, ChunkIDInfo(2000, 1, 1));
+    ASSERT_TRUE(table.Get(2000, &info));
+    ASSERT_EQ(2000, info.cid_);
+}
+
+TEST(ChunkIndexTableTest, ConcurrentReadWriteTest) {
+    ChunkIndexTable table;
+    const ChunkIndex count = 2048;
+    for (ChunkIndex i = 0; i < count; ++i) {
+        table.Set(i, ChunkIDInfo(i, i, i));
+    }
+
+    // readers never see a partially updated entry
+    std::atomic<bool> stop(false);
+    std::atomic<uint64_t> torn(0);
+    std::vector<std::thread> readers;
+    for (int i = 0; i < 4; ++i) {
+        readers.emplace_back([&]() {
+            ChunkIDInfo info;
+            while (!stop.load()) {
+                for (ChunkIndex index = 0; index < count; ++index) {
+                    if (table.Get(index, &info) &&
+                        (info.cid_ != info.lpid_ || info.lpid_ != info.cpid_)) {
+                        torn.fetch_add(1);
+                    }
+                }
+            }
+        });
+    }
+
+    for (uint32_t round = 1; round <= 200; ++round) {
+        for (ChunkIndex i = 0; i < count; i += 3) {
+            table.Set(i, ChunkIDInfo(i + round, i + round, i + round));
+        }
+        table.Erase(round, round + 8);
+    }
+
+    stop.store(true);
+    for (auto& t : readers) {
+        t.join();
+    }
+    ASSERT_EQ(0, torn.load());
+}
+
+}  // namespace client
+}  // namespace curve
@@ -0,0 +1,194 @@
+/*
+ *  Copyright (c) 2023 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+// Micro benchmark for MetaCache lookups on the IO path, N threads call
+// GetChunkInfoByIndex and GetLeader on random chunks of one volume.
+// A single RWLock over unordered_map, as MetaCache used to be, is run
+// with the same workload for comparison.
+//
+// Usage:
+//   metacache-bench -threads=16 -chunks=65536 -copysets=1024
+
+#include <butil/endpoint.h>
+#include <gflags/gflags.h>
+
+#include <atomic>
+#include <chrono>  // NOLINT
+#include <cinttypes>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <thread>  // NOLINT
+#include <unordered_map>
+#include <vector>
+
+#include "src/client/metacache.h"
+#include "src/common/concurrent/rw_lock.h"
+
+DEFINE_int32(threads, 8, "number of lookup threads");
+DEFINE_int32(chunks, 65536, "number of chunks in volume");
+DEFINE_int32(copysets, 1024, "number of copysets");
+DEFINE_int32(lookups, 2000000, "lookups per thread");
+
+using curve::client::ChunkIDInfo;
+using curve::client::ChunkIndex;
+using curve::client::ChunkServerID;
+using curve::client::CopysetInfo;
+using curve::client::MetaCache;
+using curve::client::MetaCacheErrorType;
+using curve::client::MetaCacheOption;
+using curve::client::PeerAddr;
+using curve::common::ReadLockGuard;
+using curve::common::RWLock;
+using curve::common::WriteLockGuard;
+
+namespace {
+
+uint64_t NowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+CopysetInfo<ChunkServerID> MakeCopyset(uint32_t cpid) {
+    CopysetInfo<ChunkServerID> info;
+    info.lpid_ = 1;
+    info.cpid_ = cpid;
+    for (uint32_t i = 0; i < 3; ++i) {
+        butil::EndPoint ep;
+        std::string addr = "127.0.0.1:" + std::to_string(8200 + i);
+        butil::str2endpoint(addr.c_str(), &ep);
+        info.csinfos_.emplace_back(i + 1, PeerAddr(ep), PeerAddr(ep));
+    }
+    info.UpdateLeaderIndex(cpid % 3);
+    return info;
+}
+
+// MetaCache lookups as they were before sharding
+class GlobalLockCache {
+ public:
+    void UpdateChunkInfoByIndex(ChunkIndex index, const ChunkIDInfo& info) {
+        WriteLockGuard lk(chunkLock_);
+        chunks_[index] = info;
+    }
+
+    void UpdateCopysetInfo(uint32_t lpid, uint32_t cpid,
+                           const CopysetInfo<ChunkServerID>& info) {
+        WriteLockGuard lk(copysetLock_);
+        copysets_[MetaCache::CalcLogicPoolCopysetID(lpid, cpid)] = info;
+    }
+
+    MetaCacheErrorType GetChunkInfoByIndex(ChunkIndex index,
+                                           ChunkIDInfo* info) {
+        ReadLockGuard lk(chunkLock_);
+        auto iter = chunks_.find(index);
+        if (iter == chunks_.end()) {
+            return MetaCacheErrorType::CHUNKINFO_NOT_FOUND;
+        }
+        *info = iter->second;
+        return MetaCacheErrorType::OK;
+    }
+
+    int GetLeader(uint32_t lpid, uint32_t cpid, ChunkServerID* id,
+                  butil::EndPoint* ep) {
+        CopysetInfo<ChunkServerID> info;
+        {
+            ReadLockGuard lk(copysetLock_);
+            auto iter = copysets_.find(MetaCache::CalcLogicPoolCopysetID(
+                lpid, cpid));
+            if (iter == copysets_.end()) {
+                return -1;
+            }
+            info = iter->second;
+        }
+        return info.GetLeaderInfo(id, ep);
+    }
+
+ private:
+    RWLock chunkLock_;
+    std::unordered_map<ChunkIndex, ChunkIDInfo> chunks_;
+    RWLock copysetLock_;
+    std::unordered_map<uint64_t, CopysetInfo<ChunkServerID>> copysets_;
+};
+
+template <typename CacheT>
+void Fill(CacheT* cache) {
+    for (int i = 1; i <= FLAGS_copysets; ++i) {
+        cache->UpdateCopysetInfo(1, i, MakeCopyset(i));
+    }
+    for (int i = 0; i < FLAGS_chunks; ++i) {
+        cache->UpdateChunkInfoByIndex(
+            i, ChunkIDInfo(i + 1, 1, i % FLAGS_copysets + 1));
+    }
+}
+
+// what the splitor and copyset client do for each chunk request
+template <typename CacheT>
+double Run(CacheT* cache) {
+    std::atomic<uint64_t> failed(0);
+    std::vector<std::thread> threads;
+    uint64_t start = NowNs();
+    for (int t = 0; t < FLAGS_threads; ++t) {
+        threads.emplace_back([cache, t, &failed]() {
+            std::mt19937 rand(t);
+            ChunkIDInfo info;
+            ChunkServerID id;
+            butil::EndPoint ep;
+            for (int i = 0; i < FLAGS_lookups; ++i) {
+                ChunkIndex index = rand() % FLAGS_chunks;
+                if (cache->GetChunkInfoByIndex(index, &info) !=
+                        MetaCacheErrorType::OK ||
+                    cache->GetLeader(info.lpid_, info.cpid_, &id, &ep) != 0) {
+                    failed.fetch_add(1, std::memory_order_relaxed);
+                }
+            }
+        });
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+    uint64_t elapsed = NowNs() - start;
+
+    if (failed.load() != 0) {
+        fprintf(stderr, "%" PRIu64 " lookups failed\n", failed.load());
+    }
+    return 1e9 * FLAGS_threads * FLAGS_lookups / elapsed;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    google::ParseCommandLineFlags(&argc, &argv, false);
+    if (FLAGS_threads <= 0 || FLAGS_chunks <= 0 || FLAGS_copysets <= 0 ||
+        FLAGS_lookups <= 0) {
+        fprintf(stderr, "invalid arguments\n");
+        return -1;
+    }
+
+    printf("threads: %d, chunks: %d, copysets: %d, lookups: %d\n",
+           FLAGS_threads, FLAGS_chunks, FLAGS_copysets, FLAGS_lookups);
+    printf("%-20s %16s\n", "cache", "lookups/sec");
+
+    GlobalLockCache global;
+    Fill(&global);
+    printf("%-20s %16.0f\n", "GlobalLock", Run(&global));
+
+    MetaCache metaCache;
+    metaCache.Init(MetaCacheOption(), nullptr);
+    Fill(&metaCache);
+    printf("%-20s %16.0f\n", "MetaCache", Run(&metaCache));
+    return 0;
+}
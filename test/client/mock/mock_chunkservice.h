@@ -74,6 +74,47 @@ class FakeChunkServiceImpl : public ChunkService {
         response->set_status(CHUNK_OP_STATUS::CHUNK_OP_STATUS_SUCCESS);
     }
 
+    void WriteChunks(::google::protobuf::RpcController *controller,
+                     const ::curve::chunkserver::BatchChunkRequest *request,
+                     ::curve::chunkserver::BatchChunkResponse *response,
+                     google::protobuf::Closure *done) {
+        brpc::ClosureGuard doneGuard(done);
+
+        brpc::Controller *cntl = dynamic_cast<brpc::Controller *>(controller);
+        butil::IOBuf data = cntl->request_attachment();
+        for (int i = 0; i < request->requests_size(); ++i) {
+            const auto &sub = request->requests(i);
+            chunkIds_.insert(sub.chunkid());
+            data.cutn(chunk_ + sub.offset(), sub.size());
+            response->add_responses()->set_status(
+                CHUNK_OP_STATUS::CHUNK_OP_STATUS_SUCCESS);
+        }
+        response->set_status(CHUNK_OP_STATUS::CHUNK_OP_STATUS_SUCCESS);
+    }
+
+    /* 没有写过的chunk返回CHUNK_NOTEXIST */
+    void ReadChunks(::google::protobuf::RpcController *controller,
+                    const ::curve::chunkserver::BatchChunkRequest *request,
+                    ::curve::chunkserver::BatchChunkResponse *response,
+                    google::protobuf::Closure *done) {
+        brpc::ClosureGuard doneGuard(done);
+
+        brpc::Controller *cntl = dynamic_cast<brpc::Controller *>(controller);
+        for (int i = 0; i < request->requests_size(); ++i) {
+            const auto &sub = request->requests(i);
+            if (chunkIds_.find(sub.chunkid()) == chunkIds_.end()) {
+                response->add_responses()->set_status(
+                    CHUNK_OP_STATUS::CHUNK_OP_STATUS_CHUNK_NOTEXIST);
+                continue;
+            }
+            cntl->response_attachment().append(chunk_ + sub.offset(),
+                                               sub.size());
+            response->add_responses()->set_status(
+                CHUNK_OP_STATUS::CHUNK_OP_STATUS_SUCCESS);
+        }
+        response->set_status(CHUNK_OP_STATUS::CHUNK_OP_STATUS_SUCCESS);
+    }
+
     void ReadChunkSnapshot(::google::protobuf::RpcController *controller,
                            const ::curve::chunkserver::ChunkRequest *request,
                            ::curve::chunkserver::ChunkResponse *response,
@@ -26,6 +26,10 @@
 #include <brpc/channel.h>
 #include <butil/iobuf.h>
 
+#include <string>
+#include <utility>
+#include <vector>
+
 #include "src/client/request_scheduler.h"
 #include "src/client/client_common.h"
 #include "test/client/mock/mock_meta_cache.h"
@@ -597,5 +601,206 @@ TEST(RequestSchedulerTest, CommonTest) {
     ASSERT_EQ(0, sche.Fini());
 }
 
+TEST(RequestSchedulerTest, CoalesceTest) {
+    RequestScheduleOption opt;
+    opt.scheduleQueueCapacity = 4096;
+    opt.scheduleThreadpoolSize = 1;
+    opt.coalesceMaxKB = 1;
+    opt.coalesceWindowUs = 200 * 1000;
+    opt.ioSenderOpt.failRequestOpt.chunkserverRPCTimeoutMS = 200;
+    opt.ioSenderOpt.failRequestOpt.chunkserverOPMaxRetry = 5;
+    opt.ioSenderOpt.failRequestOpt.chunkserverOPRetryIntervalUS = 5000;
+
+    brpc::Server server;
+    std::string listenAddr = "127.0.0.1:9109";
+    FakeChunkServiceImpl fakeChunkService;
+    ASSERT_EQ(server.AddService(&fakeChunkService,
+                                brpc::SERVER_DOESNT_OWN_SERVICE), 0);
+    brpc::ServerOptions option;
+    option.idle_timeout_sec = -1;
+    ASSERT_EQ(server.Start(listenAddr.c_str(), &option), 0);
+
+    RequestScheduler requestScheduler;
+    MockMetaCache mockMetaCache;
+    mockMetaCache.DelegateToFake();
+    EXPECT_CALL(mockMetaCache, GetLeader(_, _, _, _, _, _)).Times(AnyNumber());
+    FileMetric fm("coalesce_test");
+    ASSERT_EQ(0, requestScheduler.Init(opt, &mockMetaCache, &fm));
+    ASSERT_EQ(0, requestScheduler.Run());
+
+    IOTracker iot(nullptr, nullptr, nullptr, &fm);
+    const int kReqNum = 4;
+    const size_t kLen = 256;
+    ChunkIDInfo idinfo(1, 1, 100001);
+
+    auto makeRequests = [&](OpType type, off_t offset,
+                            curve::common::CountDownEvent* cond) {
+        std::vector<RequestContext*> reqCtxs;
+        for (int i = 0; i < kReqNum; ++i) {
+            RequestContext* reqCtx = new FakeRequestContext();
+            reqCtx->optype_ = type;
+            reqCtx->idinfo_ = idinfo;
+            reqCtx->offset_ = offset + i * kLen;
+            reqCtx->rawlength_ = kLen;
+            if (type == OpType::WRITE) {
+                reqCtx->writeData_.append(std::string(kLen, 'a' + i));
+            }
+            RequestClosure* reqDone = new FakeRequestClosure(cond, reqCtx);
+            reqDone->SetFileMetric(&fm);
+            reqDone->SetIOTracker(&iot);
+            reqCtx->done_ = reqDone;
+            reqCtxs.push_back(reqCtx);
+        }
+        return reqCtxs;
+    };
+
+    // adjacent writes to the same chunk are sent in one rpc
+    {
+        curve::common::CountDownEvent cond(kReqNum);
+        auto reqCtxs = makeRequests(OpType::WRITE, 0, &cond);
+        ASSERT_EQ(0, requestScheduler.ScheduleRequest(reqCtxs));
+        cond.Wait();
+        for (auto reqCtx : reqCtxs) {
+            ASSERT_EQ(0, reqCtx->done_->GetErrorCode());
+        }
+        ASSERT_EQ(1, fm.writeRPC.qps.count.get_value());
+    }
+
+    // merged read data is split back to each request
+    {
+        curve::common::CountDownEvent cond(kReqNum);
+        auto reqCtxs = makeRequests(OpType::READ, 0, &cond);
+        ASSERT_EQ(0, requestScheduler.ScheduleRequest(reqCtxs));
+        cond.Wait();
+        for (int i = 0; i < kReqNum; ++i) {
+            ASSERT_EQ(0, reqCtxs[i]->done_->GetErrorCode());
+            ASSERT_EQ(std::string(kLen, 'a' + i),
+                      reqCtxs[i]->readData_.to_string());
+        }
+        ASSERT_EQ(1, fm.readRPC.qps.count.get_value());
+    }
+
+    // not adjacent, sent one by one
+    {
+        curve::common::CountDownEvent cond(kReqNum);
+        auto reqCtxs = makeRequests(OpType::READ, 0, &cond);
+        std::swap(reqCtxs[1], reqCtxs[2]);
+        ASSERT_EQ(0, requestScheduler.ScheduleRequest(reqCtxs));
+        cond.Wait();
+        for (auto reqCtx : reqCtxs) {
+            ASSERT_EQ(0, reqCtx->done_->GetErrorCode());
+        }
+        ASSERT_EQ(1 + kReqNum, fm.readRPC.qps.count.get_value());
+    }
+
+    requestScheduler.Fini();
+    ASSERT_EQ(0, server.Stop(0));
+    ASSERT_EQ(0, server.Join());
+}
+
+TEST(RequestSchedulerTest, BatchTest) {
+    RequestScheduleOption opt;
+    opt.scheduleQueueCapacity = 4096;
+    opt.scheduleThreadpoolSize = 1;
+    opt.batchMaxCount = 8;
+    opt.ioSenderOpt.failRequestOpt.chunkserverRPCTimeoutMS = 200;
+    opt.ioSenderOpt.failRequestOpt.chunkserverOPMaxRetry = 5;
+    opt.ioSenderOpt.failRequestOpt.chunkserverOPRetryIntervalUS = 5000;
+
+    brpc::Server server;
+    std::string listenAddr = "127.0.0.1:9109";
+    FakeChunkServiceImpl fakeChunkService;
+    ASSERT_EQ(server.AddService(&fakeChunkService,
+                                brpc::SERVER_DOESNT_OWN_SERVICE), 0);
+    brpc::ServerOptions option;
+    option.idle_timeout_sec = -1;
+    ASSERT_EQ(server.Start(listenAddr.c_str(), &option), 0);
+
+    MockMetaCache mockMetaCache;
+    mockMetaCache.DelegateToFake();
+    EXPECT_CALL(mockMetaCache, GetLeader(_, _, _, _, _, _)).Times(AnyNumber());
+    FileMetric fm("batch_test");
+    IOTracker iot(nullptr, nullptr, nullptr, &fm);
+    const int kReqNum = 4;
+    const size_t kLen = 256;
+
+    // 同一copyset上不同chunk的请求，chunk 100001 ~ 100004
+    auto makeRequests = [&](OpType type, ChunkID firstChunk,
+                            curve::common::CountDownEvent* cond) {
+        std::vector<RequestContext*> reqCtxs;
+        for (int i = 0; i < kReqNum; ++i) {
+            RequestContext* reqCtx = new FakeRequestContext();
+            reqCtx->optype_ = type;
+            reqCtx->idinfo_ = ChunkIDInfo(firstChunk + i, 1, 1);
+            reqCtx->offset_ = i * kLen;
+            reqCtx->rawlength_ = kLen;
+            if (type == OpType::WRITE) {
+                reqCtx->writeData_.append(std::string(kLen, 'a' + i));
+            }
+            RequestClosure* reqDone = new FakeRequestClosure(cond, reqCtx);
+            reqDone->SetFileMetric(&fm);
+            reqDone->SetIOTracker(&iot);
+            reqCtx->done_ = reqDone;
+            reqCtxs.push_back(reqCtx);
+        }
+        return reqCtxs;
+    };
+
+    // 请求在scheduler启动之前全部入队，保证第一个请求出队时后面的请求都在队列中
+    auto runRequests = [&](const std::vector<RequestContext*>& reqCtxs,
+                           curve::common::CountDownEvent* cond) {
+        RequestScheduler requestScheduler;
+        ASSERT_EQ(0, requestScheduler.Init(opt, &mockMetaCache, &fm));
+        for (auto reqCtx : reqCtxs) {
+            requestScheduler.GetQueue()->PutBack(
+                BBQItem<RequestContext*>(reqCtx));
+        }
+        ASSERT_EQ(0, requestScheduler.Run());
+        cond->Wait();
+        requestScheduler.Fini();
+    };
+
+    // 写不同chunk的请求通过一个WriteChunks rpc发送
+    {
+        curve::common::CountDownEvent cond(kReqNum);
+        auto reqCtxs = makeRequests(OpType::WRITE, 100001, &cond);
+        runRequests(reqCtxs, &cond);
+        for (auto reqCtx : reqCtxs) {
+            ASSERT_EQ(0, reqCtx->done_->GetErrorCode());
+        }
+        ASSERT_EQ(1, fm.writeRPC.qps.count.get_value());
+    }
+
+    // 读到的数据按顺序分发给各个请求
+    {
+        curve::common::CountDownEvent cond(kReqNum);
+        auto reqCtxs = makeRequests(OpType::READ, 100001, &cond);
+        runRequests(reqCtxs, &cond);
+        for (int i = 0; i < kReqNum; ++i) {
+            ASSERT_EQ(0, reqCtxs[i]->done_->GetErrorCode());
+            ASSERT_EQ(std::string(kLen, 'a' + i),
+                      reqCtxs[i]->readData_.to_string());
+        }
+        ASSERT_EQ(1, fm.readRPC.qps.count.get_value());
+    }
+
+    // 部分chunk不存在，不存在的chunk读到全0
+    {
+        curve::common::CountDownEvent cond(kReqNum);
+        auto reqCtxs = makeRequests(OpType::READ, 100003, &cond);
+        runRequests(reqCtxs, &cond);
+        for (int i = 0; i < kReqNum; ++i) {
+            ASSERT_EQ(0, reqCtxs[i]->done_->GetErrorCode());
+            std::string expect = i < 2 ? std::string(kLen, 'a' + i)
+                                       : std::string(kLen, '\0');
+            ASSERT_EQ(expect, reqCtxs[i]->readData_.to_string());
+        }
+        ASSERT_EQ(2, fm.readRPC.qps.count.get_value());
+    }
+
+    ASSERT_EQ(0, server.Stop(0));
+    ASSERT_EQ(0, server.Join());
+}
+
 }   // namespace client
 }   // namespace curve
@@ -0,0 +1,243 @@
+/*
+ *  Copyright (c) 2023 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include "src/client/write_coalescer.h"
+
+#include <gtest/gtest.h>
+
+#include <chrono>  // NOLINT
+#include <memory>
+#include <string>
+#include <thread>  // NOLINT
+#include <utility>
+#include <vector>
+
+namespace curve {
+namespace client {
+
+namespace {
+
+struct UserWrite {
+    struct Context : public CurveAioContext {
+        UserWrite* write;
+    };
+
+    Context ctx;
+    std::string data;
+    bool done = false;
+
+    UserWrite(uint64_t offset, uint64_t length, char c)
+        : data(length, c) {
+        ctx.offset = offset;
+        ctx.length = length;
+        ctx.ret = 0;
+        ctx.op = LIBCURVE_OP::LIBCURVE_OP_WRITE;
+        ctx.cb = &UserWrite::Done;
+        ctx.buf = &data[0];
+        ctx.write = this;
+    }
+
+    static void Done(CurveAioContext* ctx) {
+        static_cast<Context*>(ctx)->write->done = true;
+    }
+};
+
+}  // namespace
+
+class WriteCoalescerTest : public ::testing::Test {
+ public:
+    void SetUp() override {
+        Reset(16 * 1024);
+    }
+
+    void Reset(uint64_t maxBytes) {
+        submitted_.clear();
+        doneRanges_.clear();
+        coalescer_.reset(new WriteCoalescer(
+            maxBytes,
+            [this](CurveAioContext* ctx) { submitted_.push_back(ctx); },
+            [this](uint64_t offset, uint64_t length) {
+                doneRanges_.emplace_back(offset, length);
+            },
+            nullptr));
+    }
+
+    // complete the oldest submitted write
+    void Complete(int ret = 0) {
+        CurveAioContext* ctx = submitted_.front();
+        submitted_.erase(submitted_.begin());
+        ctx->ret = ret < 0 ? ret : static_cast<int>(ctx->length);
+        ctx->cb(ctx);
+    }
+
+ protected:
+    std::unique_ptr<WriteCoalescer> coalescer_;
+    std::vector<CurveAioContext*> submitted_;
+    std::vector<std::pair<uint64_t, uint64_t>> doneRanges_;
+};
+
+TEST_F(WriteCoalescerTest, SequentialWriteTest) {
+    UserWrite w1(0, 4096, 'a');
+    UserWrite w2(4096, 4096, 'b');
+    UserWrite w3(8192, 4096, 'c');
+
+    // nothing inflight, submitted at once
+    coalescer_->Add(&w1.ctx, UserDataType::RawBuffer);
+    ASSERT_EQ(1, submitted_.size());
+
+    // held back while w1 is inflight
+    coalescer_->Add(&w2.ctx, UserDataType::RawBuffer);
+    coalescer_->Add(&w3.ctx, UserDataType::RawBuffer);
+    ASSERT_EQ(1, submitted_.size());
+
+    Complete();
+    ASSERT_TRUE(w1.done);
+    ASSERT_EQ(4096, w1.ctx.ret);
+    ASSERT_FALSE(w2.done);
+
+    // w2 and w3 are merged into one write
+    ASSERT_EQ(1, submitted_.size());
+    CurveAioContext* merged = submitted_.front();
+    ASSERT_EQ(4096, merged->offset);
+    ASSERT_EQ(8192, merged->length);
+    butil::IOBuf* data = static_cast<butil::IOBuf*>(merged->buf);
+    ASSERT_EQ(std::string(4096, 'b') + std::string(4096, 'c'),
+              data->to_string());
+
+    Complete();
+    ASSERT_TRUE(w2.done);
+    ASSERT_TRUE(w3.done);
+    ASSERT_EQ(4096, w2.ctx.ret);
+    ASSERT_EQ(4096, w3.ctx.ret);
+    ASSERT_TRUE(submitted_.empty());
+
+    ASSERT_EQ(2, doneRanges_.size());
+    ASSERT_EQ(4096, doneRanges_[1].first);
+    ASSERT_EQ(8192, doneRanges_[1].second);
+    coalescer_->WaitIdle();
+}
+
+TEST_F(WriteCoalescerTest, RandomWriteTest) {
+    UserWrite w1(0, 4096, 'a');
+    UserWrite w2(8192, 4096, 'b');
+    UserWrite w3(4096, 4096, 'c');
+
+    // non adjacent writes are never delayed
+    coalescer_->Add(&w1.ctx, UserDataType::RawBuffer);
+    coalescer_->Add(&w2.ctx, UserDataType::RawBuffer);
+    ASSERT_EQ(2, submitted_.size());
+
+    // w3 is not adjacent to the last submitted write
+    coalescer_->Add(&w3.ctx, UserDataType::RawBuffer);
+    ASSERT_EQ(3, submitted_.size());
+
+    Complete();
+    Complete();
+    Complete();
+    ASSERT_TRUE(w1.done && w2.done && w3.done);
+    coalescer_->WaitIdle();
+}
+
+TEST_F(WriteCoalescerTest, MaxBytesTest) {
+    Reset(8192);
+    UserWrite w1(0, 4096, 'a');
+    UserWrite w2(4096, 4096, 'b');
+    UserWrite w3(8192, 4096, 'c');
+    UserWrite w4(12288, 4096, 'd');
+    UserWrite w5(16384, 8192, 'e');
+
+    coalescer_->Add(&w1.ctx, UserDataType::RawBuffer);
+    coalescer_->Add(&w2.ctx, UserDataType::RawBuffer);
+    coalescer_->Add(&w3.ctx, UserDataType::RawBuffer);
+    // pending w2 + w3 is full, submitted before w4 is held back
+    coalescer_->Add(&w4.ctx, UserDataType::RawBuffer);
+    ASSERT_EQ(2, submitted_.size());
+    ASSERT_EQ(4096, submitted_[1]->offset);
+    ASSERT_EQ(8192, submitted_[1]->length);
+
+    // write as large as max bytes is not held back
+    Complete();
+    ASSERT_EQ(2, submitted_.size());
+    coalescer_->Add(&w5.ctx, UserDataType::RawBuffer);
+    ASSERT_EQ(3, submitted_.size());
+    ASSERT_EQ(12288, submitted_[1]->offset);
+    ASSERT_EQ(16384, submitted_[2]->offset);
+
+    while (!submitted_.empty()) {
+        Complete();
+    }
+    ASSERT_TRUE(w4.done && w5.done);
+    coalescer_->WaitIdle();
+}
+
+TEST_F(WriteCoalescerTest, DisableCoalesceTest) {
+    Reset(0);
+    UserWrite w1(0, 4096, 'a');
+    UserWrite w2(4096, 4096, 'b');
+    coalescer_->Add(&w1.ctx, UserDataType::RawBuffer);
+    coalescer_->Add(&w2.ctx, UserDataType::RawBuffer);
+    ASSERT_EQ(2, submitted_.size());
+
+    Complete();
+    Complete();
+    ASSERT_TRUE(w1.done && w2.done);
+    // done hook is still called for each write
+    ASSERT_EQ(2, doneRanges_.size());
+}
+
+TEST_F(WriteCoalescerTest, IOBufferAndErrorTest) {
+    butil::IOBuf buf1;
+    buf1.append(std::string(4096, 'a'));
+    butil::IOBuf buf2;
+    buf2.append(std::string(4096, 'b'));
+    UserWrite w0(0, 4096, 'z');
+    UserWrite w1(4096, 4096, 'a');
+    UserWrite w2(8192, 4096, 'b');
+    w1.ctx.buf = &buf1;
+    w2.ctx.buf = &buf2;
+
+    coalescer_->Add(&w0.ctx, UserDataType::RawBuffer);
+    coalescer_->Add(&w1.ctx, UserDataType::IOBuffer);
+    coalescer_->Add(&w2.ctx, UserDataType::IOBuffer);
+    Complete();
+    ASSERT_EQ(1, submitted_.size());
+    ASSERT_EQ(std::string(4096, 'a') + std::string(4096, 'b'),
+              static_cast<butil::IOBuf*>(submitted_[0]->buf)->to_string());
+
+    // error is returned to every merged write
+    Complete(-LIBCURVE_ERROR::FAILED);
+    ASSERT_EQ(-LIBCURVE_ERROR::FAILED, w1.ctx.ret);
+    ASSERT_EQ(-LIBCURVE_ERROR::FAILED, w2.ctx.ret);
+}
+
+TEST_F(WriteCoalescerTest, WaitIdleTest) {
+    UserWrite w1(0, 4096, 'a');
+    UserWrite w2(4096, 4096, 'b');
+    coalescer_->Add(&w1.ctx, UserDataType::RawBuffer);
+    coalescer_->Add(&w2.ctx, UserDataType::RawBuffer);
+
+    std::thread completer([this]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        Complete();
+        Complete();
+    });
+    coalescer_->WaitIdle();
+    ASSERT_TRUE(w1.done && w2.done);
+    completer.join();
+}
+
+}  // namespace client
+}  // namespace curve
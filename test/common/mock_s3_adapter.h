@@ -46,6 +46,9 @@ class MockS3Adapter : public S3Adapter {
     MOCK_METHOD0(DeleteBucket, int());
     MOCK_METHOD0(BucketExist, bool());
 
+    MOCK_METHOD3(PutObject, int(const Aws::String &,
+                                const char *,
+                                const size_t));
     MOCK_METHOD2(PutObject, int(const Aws::String &,
                                 const std::string &));
     MOCK_METHOD2(GetObject, int(const Aws::String &,
@@ -71,6 +74,8 @@ class MockS3Adapter : public S3Adapter {
             int,
             int,
             const char*));
+    MOCK_METHOD1(UploadOnePartAsync,
+                 void(std::shared_ptr<UploadPartAsyncContext>));
     MOCK_METHOD3(CompleteMultiUpload,
                 int(const Aws::String &,
                 const Aws::String &,
@@ -0,0 +1,155 @@
+/*
+ *  Copyright (c) 2023 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+// Micro benchmark for apply task queues, compares GenericTaskQueue and
+// GenericMPSCTaskQueue with N producers and one consumer, reports tasks/sec
+// and enqueue-to-run latency.
+//
+// Usage:
+//   mpsc-task-queue-bench -producers=4 -queue_depth=1 -task_count=1000000
+
+#include <bthread/condition_variable.h>
+#include <bthread/mutex.h>
+#include <gflags/gflags.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>  // NOLINT
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "src/common/concurrent/mpsc_task_queue.h"
+#include "src/common/concurrent/task_queue.h"
+
+DEFINE_int32(producers, 4, "number of producer threads");
+DEFINE_int32(queue_depth, 1, "queue depth");
+DEFINE_int32(task_count, 1000000, "tasks pushed by all producers");
+DEFINE_bool(use_bthread_lock, true,
+            "use bthread mutex/condvar as the apply modules do");
+
+using curve::common::GenericMPSCTaskQueue;
+using curve::common::GenericTaskQueue;
+
+namespace {
+
+uint64_t NowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+struct Result {
+    double tasksPerSec;
+    uint64_t p50Ns;
+    uint64_t p99Ns;
+};
+
+// GenericTaskQueue has no RunOne, adapt it to the same interface
+template <typename QueueT>
+struct Runner {
+    static void RunOne(QueueT* q) {
+        q->Pop()();
+    }
+};
+
+template <typename MutexT, typename CondVarT>
+struct Runner<GenericMPSCTaskQueue<MutexT, CondVarT>> {
+    static void RunOne(GenericMPSCTaskQueue<MutexT, CondVarT>* q) {
+        q->RunOne();
+    }
+};
+
+template <typename QueueT>
+Result RunOnce() {
+    const int producers = FLAGS_producers;
+    const int perProducer = FLAGS_task_count / producers;
+    const int total = perProducer * producers;
+
+    QueueT queue(FLAGS_queue_depth);
+    std::vector<uint64_t> latency(total);
+    std::atomic<int> done(0);
+
+    auto task = [&latency, &done](uint64_t enqueueNs) {
+        int index = done.fetch_add(1, std::memory_order_relaxed);
+        latency[index] = NowNs() - enqueueNs;
+    };
+
+    uint64_t start = NowNs();
+    std::thread consumer([&queue, total]() {
+        for (int i = 0; i < total; ++i) {
+            Runner<QueueT>::RunOne(&queue);
+        }
+    });
+
+    std::vector<std::thread> threads;
+    for (int p = 0; p < producers; ++p) {
+        threads.emplace_back([&queue, &task, perProducer]() {
+            for (int i = 0; i < perProducer; ++i) {
+                queue.Push(task, NowNs());
+            }
+        });
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+    consumer.join();
+    uint64_t elapsed = NowNs() - start;
+
+    std::sort(latency.begin(), latency.end());
+    Result result;
+    result.tasksPerSec = total * 1e9 / elapsed;
+    result.p50Ns = latency[total / 2];
+    result.p99Ns = latency[static_cast<size_t>(total * 0.99)];
+    return result;
+}
+
+void Print(const std::string& name, const Result& result) {
+    printf("%-20s %14.0f %12lu %12lu\n", name.c_str(), result.tasksPerSec,
+           result.p50Ns / 1000, result.p99Ns / 1000);
+}
+
+template <typename MutexT, typename CondVarT>
+void RunAll() {
+    printf("%-20s %14s %12s %12s\n", "queue", "tasks/sec", "p50(us)",
+           "p99(us)");
+    Print("GenericTaskQueue",
+          RunOnce<GenericTaskQueue<MutexT, CondVarT>>());
+    Print("MPSCTaskQueue",
+          RunOnce<GenericMPSCTaskQueue<MutexT, CondVarT>>());
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    google::ParseCommandLineFlags(&argc, &argv, false);
+    if (FLAGS_producers <= 0 || FLAGS_queue_depth <= 0 ||
+        FLAGS_task_count < FLAGS_producers) {
+        fprintf(stderr, "invalid arguments\n");
+        return -1;
+    }
+
+    printf("producers: %d, queue depth: %d, tasks: %d\n", FLAGS_producers,
+           FLAGS_queue_depth, FLAGS_task_count);
+    if (FLAGS_use_bthread_lock) {
+        RunAll<bthread::Mutex, bthread::ConditionVariable>();
+    } else {
+        RunAll<std::mutex, std::condition_variable>();
+    }
+    return 0;
+}
@@ -0,0 +1,162 @@
+/*
+ *  Copyright (c) 2023 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <array>
+#include <atomic>
+#include <chrono>  // NOLINT
+#include <memory>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "src/common/concurrent/mpsc_task_queue.h"
+
+namespace curve {
+namespace common {
+
+TEST(MPSCTaskQueueTest, CapacityTest) {
+    MPSCTaskQueue q1(1);
+    ASSERT_GT(q1.Capacity(), 1);
+    MPSCTaskQueue q2(3);
+    ASSERT_GT(q2.Capacity(), 3);
+    MPSCTaskQueue q3(16);
+    ASSERT_GT(q3.Capacity(), 16);
+    ASSERT_EQ(0, q3.Size());
+}
+
+TEST(MPSCTaskQueueTest, RunInOrderTest) {
+    MPSCTaskQueue q(8);
+    std::vector<int> result;
+    for (int i = 0; i < 8; ++i) {
+        q.Push([&result](int v) { result.push_back(v); }, i);
+    }
+    ASSERT_EQ(8, q.Size());
+    for (int i = 0; i < 8; ++i) {
+        q.RunOne();
+    }
+    ASSERT_EQ(0, q.Size());
+    ASSERT_EQ(8, result.size());
+    for (int i = 0; i < 8; ++i) {
+        ASSERT_EQ(i, result[i]);
+    }
+}
+
+TEST(MPSCTaskQueueTest, LargeTaskTest) {
+    MPSCTaskQueue q(2);
+    std::array<uint64_t, 64> big;
+    big.fill(1);
+    uint64_t sum = 0;
+    // larger than kInlineSize, stored on heap
+    q.Push([&sum](const std::array<uint64_t, 64>& arr) {
+        for (auto v : arr) {
+            sum += v;
+        }
+    }, big);
+    q.RunOne();
+    ASSERT_EQ(64, sum);
+}
+
+TEST(MPSCTaskQueueTest, DestroyPendingTaskTest) {
+    auto counter = std::make_shared<int>(0);
+    {
+        MPSCTaskQueue q(4);
+        q.Push([](std::shared_ptr<int> c) { ++*c; }, counter);
+        q.Push([](std::shared_ptr<int> c) { ++*c; }, counter);
+        ASSERT_EQ(3, counter.use_count());
+    }
+    // pending tasks are released but not run
+    ASSERT_EQ(1, counter.use_count());
+    ASSERT_EQ(0, *counter);
+}
+
+TEST(MPSCTaskQueueTest, BlockWhenFullTest) {
+    MPSCTaskQueue q(1);
+    size_t capacity = q.Capacity();
+    for (size_t i = 0; i < capacity; ++i) {
+        q.Push([]() {});
+    }
+
+    std::atomic<bool> pushed(false);
+    std::thread producer([&q, &pushed]() {
+        q.Push([]() {});
+        pushed = true;
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    ASSERT_FALSE(pushed);
+
+    q.RunOne();
+    producer.join();
+    ASSERT_TRUE(pushed);
+    for (size_t i = 0; i < capacity; ++i) {
+        q.RunOne();
+    }
+    ASSERT_EQ(0, q.Size());
+}
+
+TEST(MPSCTaskQueueTest, ConsumerWaitTest) {
+    MPSCTaskQueue q(4);
+    std::atomic<int> value(0);
+    std::thread consumer([&q]() { q.RunOne(); });
+
+    // consumer parks after spinning
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    q.Push([&value]() { value = 1; });
+    consumer.join();
+    ASSERT_EQ(1, value);
+}
+
+TEST(MPSCTaskQueueTest, MultiProducerTest) {
+    const int kProducers = 8;
+    const int kTasksPerProducer = 10000;
+    MPSCTaskQueue q(4);
+    std::vector<int> last(kProducers, -1);
+    std::atomic<bool> ordered(true);
+
+    std::thread consumer([&]() {
+        for (int i = 0; i < kProducers * kTasksPerProducer; ++i) {
+            q.RunOne();
+        }
+    });
+
+    std::vector<std::thread> producers;
+    for (int p = 0; p < kProducers; ++p) {
+        producers.emplace_back([&, p]() {
+            for (int i = 0; i < kTasksPerProducer; ++i) {
+                // tasks of one producer run in push order
+                q.Push([&last, &ordered](int id, int seq) {
+                    if (last[id] + 1 != seq) {
+                        ordered = false;
+                    }
+                    last[id] = seq;
+                }, p, i);
+            }
+        });
+    }
+
+    for (auto& t : producers) {
+        t.join();
+    }
+    consumer.join();
+    ASSERT_TRUE(ordered);
+    for (int p = 0; p < kProducers; ++p) {
+        ASSERT_EQ(kTasksPerProducer - 1, last[p]);
+    }
+    ASSERT_EQ(0, q.Size());
+}
+
+}  // namespace common
+}  // namespace curve
@@ -0,0 +1,226 @@
+/*
+ *  Copyright (c) 2023 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include "src/common/s3_transfer_engine.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>  // NOLINT
+#include <functional>
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "test/common/mock_s3_adapter.h"
+
+namespace curve {
+namespace common {
+
+using ::testing::_;
+using ::testing::Invoke;
+using ::testing::Return;
+
+namespace {
+
+// 所有engine使用同一个endpoint，共享并发额度
+const uint32_t kMaxConcurrency = 2;
+const size_t kMiB = 1024 * 1024;
+
+char ByteAt(off_t offset) {
+    return static_cast<char>(offset % 251);
+}
+
+}  // namespace
+
+class S3TransferEngineTest : public ::testing::Test {
+ protected:
+    void SetUp() override {
+        inflight_ = 0;
+        maxInflight_ = 0;
+    }
+
+    S3TransferOption Option(uint64_t partSize) {
+        S3TransferOption option;
+        option.partSize = partSize;
+        option.maxConcurrency = kMaxConcurrency;
+        return option;
+    }
+
+    // 在另一个线程中完成请求，记录同时进行的请求数
+    void Complete(std::function<void()> done) {
+        int now = ++inflight_;
+        int max = maxInflight_.load();
+        while (now > max && !maxInflight_.compare_exchange_weak(max, now)) {
+        }
+        std::thread([this, done]() {
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+            --inflight_;
+            done();
+        }).detach();
+    }
+
+    MockS3Adapter adapter_;
+    std::atomic<int> inflight_;
+    std::atomic<int> maxInflight_;
+};
+
+TEST_F(S3TransferEngineTest, SmallObjectTest) {
+    S3TransferEngine engine(&adapter_, Option(4096));
+    char buf[4096];
+
+    EXPECT_CALL(adapter_, GetObject("obj", buf, 100, 4096))
+        .WillOnce(Return(0));
+    ASSERT_EQ(0, engine.GetObject("obj", buf, 100, 4096));
+
+    EXPECT_CALL(adapter_, PutObject(Aws::String("obj"), buf, 4096))
+        .WillOnce(Return(-1));
+    ASSERT_EQ(-1, engine.PutObject("obj", buf, 4096));
+
+    // partSize为0时不拆分
+    S3TransferEngine noSplit(&adapter_, Option(0));
+    EXPECT_CALL(adapter_, GetObject("obj", buf, 0, 4096))
+        .WillOnce(Return(0));
+    ASSERT_EQ(0, noSplit.GetObject("obj", buf, 0, 4096));
+}
+
+TEST_F(S3TransferEngineTest, RangedGetTest) {
+    const size_t partSize = 1000;
+    const off_t offset = 123;
+    const size_t len = 10 * partSize + 321;
+    S3TransferEngine engine(&adapter_, Option(partSize));
+    std::vector<char> buf(len, 0);
+
+    std::atomic<int> requests(0);
+    EXPECT_CALL(adapter_, GetObjectAsync(_))
+        .WillRepeatedly(Invoke(
+            [&](std::shared_ptr<GetObjectAsyncContext> ctx) {
+                requests++;
+                ASSERT_EQ("obj", ctx->key);
+                ASSERT_EQ(ctx->offset - offset, ctx->buf - buf.data());
+                ASSERT_LE(ctx->len, partSize);
+                Complete([ctx]() {
+                    for (size_t i = 0; i < ctx->len; i++) {
+                        ctx->buf[i] = ByteAt(ctx->offset + i);
+                    }
+                    ctx->actualLen = ctx->len;
+                    ctx->retCode = 0;
+                    ctx->cb(nullptr, ctx);
+                });
+            }));
+    ASSERT_EQ(0, engine.GetObject("obj", buf.data(), offset, len));
+    ASSERT_EQ(11, requests.load());
+    ASSERT_LE(maxInflight_.load(), kMaxConcurrency);
+    for (size_t i = 0; i < len; i++) {
+        ASSERT_EQ(ByteAt(offset + i), buf[i]) << "pos " << i;
+    }
+}
+
+TEST_F(S3TransferEngineTest, RangedGetFailTest) {
+    const size_t partSize = 1000;
+    S3TransferEngine engine(&adapter_, Option(partSize));
+    std::vector<char> buf(4 * partSize, 0);
+
+    // 第二个分片一直失败，重试后整体失败
+    std::atomic<int> requests(0);
+    EXPECT_CALL(adapter_, GetObjectAsync(_))
+        .WillRepeatedly(Invoke(
+            [&](std::shared_ptr<GetObjectAsyncContext> ctx) {
+                requests++;
+                Complete([ctx]() {
+                    ctx->retCode = (ctx->offset == 1000 ? -1 : 0);
+                    ctx->cb(nullptr, ctx);
+                });
+            }));
+    ASSERT_EQ(-1, engine.GetObject("obj", buf.data(), 0, buf.size()));
+    ASSERT_EQ(4 + 3, requests.load());
+}
+
+TEST_F(S3TransferEngineTest, MultipartPutTest) {
+    const size_t len = 12 * kMiB + 1;
+    // 分片大小不小于5MiB
+    S3TransferEngine engine(&adapter_, Option(kMiB));
+    std::vector<char> buf(len, 0);
+
+    EXPECT_CALL(adapter_, MultiUploadInit(Aws::String("obj")))
+        .WillOnce(Return("upload"));
+    std::atomic<int> retried(0);
+    EXPECT_CALL(adapter_, UploadOnePartAsync(_))
+        .WillRepeatedly(Invoke(
+            [&](std::shared_ptr<UploadPartAsyncContext> ctx) {
+                ASSERT_EQ("upload", ctx->uploadId);
+                ASSERT_EQ(buf.data() + (ctx->partNum - 1) * 5 * kMiB,
+                          ctx->buffer);
+                Complete([ctx, &retried]() {
+                    // 第一个分片失败一次
+                    if (ctx->partNum == 1 && retried.fetch_add(1) == 0) {
+                        ctx->retCode = -1;
+                    } else {
+                        ctx->retCode = 0;
+                        ctx->etag = "etag" + std::to_string(ctx->partNum);
+                    }
+                    ctx->cb(ctx);
+                });
+            }));
+    Aws::Vector<Aws::S3::Model::CompletedPart> completed;
+    EXPECT_CALL(adapter_, CompleteMultiUpload(Aws::String("obj"),
+                                              Aws::String("upload"), _))
+        .WillOnce(Invoke([&](const Aws::String &, const Aws::String &,
+                             const Aws::Vector<Aws::S3::Model::CompletedPart>
+                                 &cp) {
+            completed = cp;
+            return 0;
+        }));
+    ASSERT_EQ(0, engine.PutObject("obj", buf.data(), len));
+    ASSERT_LE(maxInflight_.load(), kMaxConcurrency);
+    ASSERT_EQ(3, completed.size());
+    for (int i = 0; i < 3; i++) {
+        ASSERT_EQ(i + 1, completed[i].GetPartNumber());
+        ASSERT_EQ("etag" + std::to_string(i + 1),
+                  std::string(completed[i].GetETag().c_str()));
+    }
+}
+
+TEST_F(S3TransferEngineTest, MultipartPutFailTest) {
+    const size_t len = 12 * kMiB;
+    S3TransferEngine engine(&adapter_, Option(5 * kMiB));
+    std::vector<char> buf(len, 0);
+
+    // init失败
+    EXPECT_CALL(adapter_, MultiUploadInit(_))
+        .WillOnce(Return(""))
+        .WillOnce(Return("upload"));
+    ASSERT_EQ(-1, engine.PutObject("obj", buf.data(), len));
+
+    // 分片失败则abort
+    EXPECT_CALL(adapter_, UploadOnePartAsync(_))
+        .WillRepeatedly(Invoke(
+            [&](std::shared_ptr<UploadPartAsyncContext> ctx) {
+                Complete([ctx]() {
+                    ctx->retCode = (ctx->partNum == 3 ? -1 : 0);
+                    ctx->cb(ctx);
+                });
+            }));
+    EXPECT_CALL(adapter_, CompleteMultiUpload(_, _, _)).Times(0);
+    EXPECT_CALL(adapter_, AbortMultiUpload(Aws::String("obj"),
+                                           Aws::String("upload")))
+        .WillOnce(Return(0));
+    ASSERT_EQ(-1, engine.PutObject("obj", buf.data(), len));
+}
+
+}  // namespace common
+}  // namespace curve
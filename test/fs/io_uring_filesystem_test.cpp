@@ -0,0 +1,193 @@
+/*
+ *  Copyright (c) 2023 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <fcntl.h>
+
+#include <atomic>
+#include <memory>
+#include <string>
+
+#include "src/common/concurrent/count_down_event.h"
+#include "src/fs/ext4_filesystem_impl.h"
+#include "src/fs/io_uring_filesystem_impl.h"
+#include "src/fs/wrap_posix.h"
+
+namespace curve {
+namespace fs {
+
+using curve::common::CountDownEvent;
+
+class IoUringFileSystemTest : public testing::Test {
+ public:
+    void SetUp() {
+        // other cases may replace the wrapper of the ext4 singleton by mock
+        Ext4FileSystemImpl::getInstance()->SetPosixWrapper(
+            std::make_shared<PosixWrapper>());
+        lfs_ = IoUringFileSystemImpl::getInstance();
+        LocalFileSystemOption option;
+        option.enableRenameat2 = false;
+        option.ioUringQueueDepth = 8;
+        ASSERT_EQ(0, lfs_->Init(option));
+        fd_ = lfs_->Open(path_, O_RDWR | O_CREAT);
+        ASSERT_GE(fd_, 0);
+    }
+
+    void TearDown() {
+        lfs_->Close(fd_);
+        lfs_->Delete(path_);
+    }
+
+ protected:
+    std::shared_ptr<IoUringFileSystemImpl> lfs_;
+    std::string path_ = "./io_uring_fs_test_file";
+    int fd_ = -1;
+};
+
+TEST_F(IoUringFileSystemTest, CreateTest) {
+    std::shared_ptr<LocalFileSystem> lfs =
+        LocalFsFactory::CreateFs(FileSystemType::EXT4_IOURING, "");
+    ASSERT_EQ(lfs.get(), lfs_.get());
+}
+
+TEST_F(IoUringFileSystemTest, AsyncReadWriteTest) {
+    const int kIoNum = 32;
+    const int kIoSize = 4096;
+
+    // more ios than queue depth are submitted without waiting
+    CountDownEvent writeEvent(kIoNum);
+    std::atomic<int> writeFailed(0);
+    for (int i = 0; i < kIoNum; ++i) {
+        butil::IOBuf data;
+        data.append(std::string(kIoSize, 'a' + i % 26));
+        ASSERT_EQ(0, lfs_->WriteAsync(fd_, data, i * kIoSize, kIoSize,
+            [&](int rc) {
+                if (rc != kIoSize) {
+                    writeFailed.fetch_add(1);
+                }
+                writeEvent.Signal();
+            }));
+    }
+    writeEvent.Wait();
+    ASSERT_EQ(0, writeFailed.load());
+
+    std::unique_ptr<char[]> buf(new char[kIoNum * kIoSize]);
+    CountDownEvent readEvent(kIoNum);
+    std::atomic<int> readFailed(0);
+    for (int i = 0; i < kIoNum; ++i) {
+        ASSERT_EQ(0, lfs_->ReadAsync(fd_, buf.get() + i * kIoSize,
+            i * kIoSize, kIoSize,
+            [&](int rc) {
+                if (rc != kIoSize) {
+                    readFailed.fetch_add(1);
+                }
+                readEvent.Signal();
+            }));
+    }
+    readEvent.Wait();
+    ASSERT_EQ(0, readFailed.load());
+    for (int i = 0; i < kIoNum; ++i) {
+        ASSERT_EQ(std::string(kIoSize, 'a' + i % 26),
+                  std::string(buf.get() + i * kIoSize, kIoSize));
+    }
+
+    // read beyond the end of file returns the length actually read
+    CountDownEvent eofEvent(1);
+    int eofResult = -1;
+    ASSERT_EQ(0, lfs_->ReadAsync(fd_, buf.get(), (kIoNum - 1) * kIoSize,
+        2 * kIoSize,
+        [&](int rc) {
+            eofResult = rc;
+            eofEvent.Signal();
+        }));
+    eofEvent.Wait();
+    ASSERT_EQ(kIoSize, eofResult);
+
+    // write with mismatched length is rejected at submit time
+    butil::IOBuf data;
+    data.append(std::string(kIoSize, 'x'));
+    ASSERT_EQ(-EINVAL, lfs_->WriteAsync(fd_, data, 0, kIoSize * 2,
+                                        [](int) {}));
+}
+
+TEST_F(IoUringFileSystemTest, SubmitInCallbackTest) {
+    const int kIoNum = 32;
+    const int kIoSize = 4096;
+
+    // callbacks run in the reaper thread, ios submitted there don't wait
+    // for the queue, which only the reaper itself can drain
+    std::unique_ptr<char[]> buf(new char[kIoNum * kIoSize]);
+    CountDownEvent event(2 * kIoNum);
+    std::atomic<int> failed(0);
+    for (int i = 0; i < kIoNum; ++i) {
+        butil::IOBuf data;
+        data.append(std::string(kIoSize, 'a' + i % 26));
+        ASSERT_EQ(0, lfs_->WriteAsync(fd_, data, i * kIoSize, kIoSize,
+            [&, i](int rc) {
+                if (rc != kIoSize) {
+                    failed.fetch_add(1);
+                }
+                int ret = lfs_->ReadAsync(fd_, buf.get() + i * kIoSize,
+                    i * kIoSize, kIoSize,
+                    [&](int rc) {
+                        if (rc != kIoSize) {
+                            failed.fetch_add(1);
+                        }
+                        event.Signal();
+                    });
+                if (ret != 0) {
+                    failed.fetch_add(1);
+                    event.Signal();
+                }
+                event.Signal();
+            }));
+    }
+    event.Wait();
+    ASSERT_EQ(0, failed.load());
+    for (int i = 0; i < kIoNum; ++i) {
+        ASSERT_EQ(std::string(kIoSize, 'a' + i % 26),
+                  std::string(buf.get() + i * kIoSize, kIoSize));
+    }
+}
+
+TEST_F(IoUringFileSystemTest, DestroyTest) {
+    const int kIoNum = 32;
+    const int kIoSize = 4096;
+
+    // callbacks of inflight ios are run before the ring is destroyed
+    auto lfs = std::make_shared<IoUringFileSystemImpl>(
+        Ext4FileSystemImpl::getInstance());
+    LocalFileSystemOption option;
+    option.enableRenameat2 = false;
+    option.ioUringQueueDepth = 8;
+    ASSERT_EQ(0, lfs->Init(option));
+    std::atomic<int> completed(0);
+    for (int i = 0; i < kIoNum; ++i) {
+        butil::IOBuf data;
+        data.append(std::string(kIoSize, 'a'));
+        ASSERT_EQ(0, lfs->WriteAsync(fd_, data, i * kIoSize, kIoSize,
+            [&](int rc) {
+                if (rc == kIoSize) {
+                    completed.fetch_add(1);
+                }
+            }));
+    }
+    lfs.reset();
+    ASSERT_EQ(kIoNum, completed.load());
+}
+
+}  // namespace fs
+}  // namespace curve
@@ -29,6 +29,7 @@
 
 #include <chrono>  //NOLINT
 #include <thread>  //NOLINT
+#include <vector>
 
 #include "proto/cli.pb.h"
 #include "proto/chunk.pb.h"
@@ -49,6 +50,8 @@ using ::curve::chunkserver::MockChunkService;
 using ::curve::chunkserver::MockCliService;
 using ::curve::chunkserver::ChunkRequest;
 using ::curve::chunkserver::ChunkResponse;
+using ::curve::chunkserver::BatchChunkRequest;
+using ::curve::chunkserver::BatchChunkResponse;
 using ::curve::chunkserver::CHUNK_OP_TYPE;
 using ::curve::chunkserver::CHUNK_OP_STATUS;
 using ::curve::chunkserver::CHUNK_OP_STATUS_FAILURE_UNKNOWN;
@@ -795,6 +798,102 @@ TEST_F(TestChunkServerClient, TestDeleteChunkReturnNotLeader) {
     ASSERT_EQ(kCsClientNotLeader, ret);
 }
 
+
+TEST_F(TestChunkServerClient, TestDeleteChunksSuccess) {
+    uint32_t port = listenAddr_.port;
+    ChunkServerIdType csId = 0x01;
+    LogicalPoolID logicalPoolId = 0x11;
+    CopysetID copysetId = 0x21;
+    std::vector<ChunkID> chunkIds = {0x31, 0x32, 0x33};
+    uint64_t sn = 100;
+
+    ChunkServer chunkserver(
+        csId, "", "", 0x101, "127.0.0.1", port, "", READWRITE);
+    ChunkServerState csState;
+    csState.SetDiskState(DISKNORMAL);
+    chunkserver.SetOnlineState(ONLINE);
+    chunkserver.SetChunkServerState(csState);
+
+    EXPECT_CALL(*topo_, GetChunkServer(csId, _))
+        .WillOnce(DoAll(SetArgPointee<1>(chunkserver),
+            Return(true)));
+    EXPECT_CALL(*chunkService, DeleteChunks(_, _, _, _))
+        .WillOnce(Invoke([&](RpcController *controller,
+                             const BatchChunkRequest *request,
+                             BatchChunkResponse *response,
+                             Closure *done){
+            brpc::ClosureGuard doneGuard(done);
+            ASSERT_EQ(CHUNK_OP_TYPE::CHUNK_OP_DELETE, request->optype());
+            ASSERT_EQ(chunkIds.size(), request->requests_size());
+            for (int i = 0; i < request->requests_size(); ++i) {
+                ASSERT_EQ(chunkIds[i], request->requests(i).chunkid());
+                ASSERT_EQ(sn, request->requests(i).sn());
+            }
+            response->set_status(CHUNK_OP_STATUS::CHUNK_OP_STATUS_SUCCESS);
+            response->add_responses()->set_status(
+                CHUNK_OP_STATUS::CHUNK_OP_STATUS_SUCCESS);
+            response->add_responses()->set_status(
+                CHUNK_OP_STATUS::CHUNK_OP_STATUS_CHUNK_NOTEXIST);
+            response->add_responses()->set_status(
+                CHUNK_OP_STATUS::CHUNK_OP_STATUS_SUCCESS);
+        }));
+
+    int ret = client_->DeleteChunks(
+        csId, logicalPoolId, copysetId, chunkIds, sn);
+    ASSERT_EQ(kMdsSuccess, ret);
+}
+
+TEST_F(TestChunkServerClient, TestDeleteChunksFail) {
+    uint32_t port = listenAddr_.port;
+    ChunkServerIdType csId = 0x01;
+    LogicalPoolID logicalPoolId = 0x11;
+    CopysetID copysetId = 0x21;
+    std::vector<ChunkID> chunkIds = {0x31, 0x32};
+    uint64_t sn = 100;
+
+    ChunkServer chunkserver(
+        csId, "", "", 0x101, "127.0.0.1", port, "", READWRITE);
+    ChunkServerState csState;
+    csState.SetDiskState(DISKNORMAL);
+    chunkserver.SetOnlineState(ONLINE);
+    chunkserver.SetChunkServerState(csState);
+
+    EXPECT_CALL(*topo_, GetChunkServer(csId, _))
+        .WillRepeatedly(DoAll(SetArgPointee<1>(chunkserver),
+            Return(true)));
+
+    // not leader
+    BatchChunkResponse response;
+    response.set_status(CHUNK_OP_STATUS::CHUNK_OP_STATUS_REDIRECTED);
+    EXPECT_CALL(*chunkService, DeleteChunks(_, _, _, _))
+        .WillOnce(DoAll(SetArgPointee<2>(response),
+                Invoke([](RpcController *controller,
+                          const BatchChunkRequest *request,
+                          BatchChunkResponse *response,
+                          Closure *done){
+                          brpc::ClosureGuard doneGuard(done);
+                    })));
+    ASSERT_EQ(kCsClientNotLeader, client_->DeleteChunks(
+        csId, logicalPoolId, copysetId, chunkIds, sn));
+
+    // one of the chunks failed
+    response.set_status(CHUNK_OP_STATUS::CHUNK_OP_STATUS_SUCCESS);
+    response.add_responses()->set_status(
+        CHUNK_OP_STATUS::CHUNK_OP_STATUS_SUCCESS);
+    response.add_responses()->set_status(
+        CHUNK_OP_STATUS::CHUNK_OP_STATUS_FAILURE_UNKNOWN);
+    EXPECT_CALL(*chunkService, DeleteChunks(_, _, _, _))
+        .WillOnce(DoAll(SetArgPointee<2>(response),
+                Invoke([](RpcController *controller,
+                          const BatchChunkRequest *request,
+                          BatchChunkResponse *response,
+                          Closure *done){
+                          brpc::ClosureGuard doneGuard(done);
+                    })));
+    ASSERT_EQ(kCsClientReturnFail, client_->DeleteChunks(
+        csId, logicalPoolId, copysetId, chunkIds, sn));
+}
+
 }  // namespace chunkserverclient
 }  // namespace mds
 }  // namespace curve
@@ -28,6 +28,7 @@
 
 #include <chrono>  //NOLINT
 #include <thread>  //NOLINT
+#include <vector>
 
 #include "proto/cli.pb.h"
 #include "proto/chunk.pb.h"
@@ -403,6 +404,64 @@ TEST_F(TestCopysetClient, TestDeleteChunkRedirectFail) {
         logicalPoolId, copysetId, chunkId, sn);
     ASSERT_EQ(kMdsFail, ret);
 }
+
+TEST_F(TestCopysetClient, TestDeleteChunksSuccess) {
+    ChunkServerIdType leader = 0x01;
+    LogicalPoolID logicalPoolId = 0x11;
+    CopysetID copysetId = 0x21;
+    std::vector<ChunkID> chunkIds = {0x31, 0x32};
+    uint64_t sn = 100;
+
+    CopySetInfo copyset(logicalPoolId, copysetId);
+    copyset.SetLeader(leader);
+    copyset.SetCopySetMembers({0x01, 0x02, 0x03});
+    EXPECT_CALL(*topo_, GetCopySet(_, _))
+        .WillOnce(DoAll(SetArgPointee<1>(copyset),
+            Return(true)));
+
+    EXPECT_CALL(*mockCsClient_, DeleteChunks(
+            _, logicalPoolId, copysetId, chunkIds, sn))
+        .WillOnce(Return(kCsClientNotLeader))
+        .WillOnce(Return(kMdsSuccess));
+
+    ChunkServerIdType newLeader = 0x02;
+    EXPECT_CALL(*mockCsClient_, GetLeader(
+        _, logicalPoolId, copysetId, _))
+        .WillOnce(DoAll(SetArgPointee<3>(newLeader),
+                Return(kMdsSuccess)));
+
+    int ret = client_->DeleteChunks(
+        logicalPoolId, copysetId, chunkIds, sn);
+    ASSERT_EQ(kMdsSuccess, ret);
+}
+
+TEST_F(TestCopysetClient, TestDeleteChunksOneChunk) {
+    ChunkServerIdType leader = 0x01;
+    LogicalPoolID logicalPoolId = 0x11;
+    CopysetID copysetId = 0x21;
+    ChunkID chunkId = 0x31;
+    uint64_t sn = 100;
+
+    CopySetInfo copyset(logicalPoolId, copysetId);
+    copyset.SetLeader(leader);
+    copyset.SetCopySetMembers({0x01, 0x02, 0x03});
+    EXPECT_CALL(*topo_, GetCopySet(_, _))
+        .WillOnce(DoAll(SetArgPointee<1>(copyset),
+            Return(true)));
+
+    // single chunk is deleted with DeleteChunk
+    EXPECT_CALL(*mockCsClient_, DeleteChunks(_, _, _, _, _))
+        .Times(0);
+    EXPECT_CALL(*mockCsClient_, DeleteChunk(
+            leader, logicalPoolId, copysetId, chunkId, sn))
+        .WillOnce(Return(kMdsSuccess));
+
+    ASSERT_EQ(kMdsSuccess, client_->DeleteChunks(
+        logicalPoolId, copysetId, {chunkId}, sn));
+    ASSERT_EQ(kMdsSuccess, client_->DeleteChunks(
+        logicalPoolId, copysetId, {}, sn));
+}
+
 }  // namespace chunkserverclient
 }  // namespace mds
 }  // namespace curve
@@ -310,8 +310,9 @@ TEST_F(CleanCoreTest, TestCleanDiscardSegment) {
 
     // CopysetClient DeleteChunk failed
     {
+        // chunks of other copysets may be deleting at the same time
         EXPECT_CALL(*topology_, GetCopySet(_, _))
-            .WillOnce(Return(false));
+            .WillRepeatedly(Return(false));
         EXPECT_CALL(*storage_, CleanDiscardSegment(_, _, _))
             .Times(0);
         EXPECT_CALL(*allocStatistic_, DeAllocSpace(_, _, _))
@@ -380,5 +381,86 @@ TEST_F(CleanCoreTest, TestCleanDiscardSegment) {
     }
 }
 
+
+TEST_F(CleanCoreTest, TestCleanFileBatchDelete) {
+    CleanCoreOption option;
+    option.deleteBatchSize = 2;
+    option.deleteInflight = 2;
+    option.deleteThreadNum = 2;
+    auto cleanCore =
+        std::make_shared<CleanCore>(storage_, client_, allocStatistic_, option);
+    client_->SetChunkServerClient(csClient_);
+
+    // 5 chunks in copyset 1 and 1 chunk in copyset 2 for every segment
+    PageFileSegment segment;
+    segment.set_logicalpoolid(1);
+    segment.set_segmentsize(DefaultSegmentSize);
+    for (int i = 0; i < 6; ++i) {
+        auto* chunk = segment.add_chunks();
+        chunk->set_copysetid(i < 5 ? 1 : 2);
+        chunk->set_chunkid(i);
+    }
+
+    FileInfo cleanFile;
+    cleanFile.set_id(1);
+    cleanFile.set_length(kMiniFileLength);
+    cleanFile.set_segmentsize(DefaultSegmentSize);
+    const int segmentNum = kMiniFileLength / DefaultSegmentSize;
+
+    CopySetInfo copyset;
+    copyset.SetLeader(1);
+    EXPECT_CALL(*topology_, GetCopySet(_, _))
+        .WillRepeatedly(DoAll(SetArgPointee<1>(copyset), Return(true)));
+
+    {
+        EXPECT_CALL(*storage_, GetSegment(_, _, _))
+            .Times(segmentNum)
+            .WillRepeatedly(
+                DoAll(SetArgPointee<2>(segment), Return(StoreStatus::OK)));
+        // [0, 1], [2, 3] of copyset 1 are deleted in batch
+        EXPECT_CALL(*csClient_, DeleteChunks(_, 1, 1, _, _))
+            .Times(2 * segmentNum)
+            .WillRepeatedly(Return(kMdsSuccess));
+        // [4] of copyset 1 and [5] of copyset 2 are deleted alone
+        EXPECT_CALL(*csClient_, DeleteChunk(_, 1, _, _, _))
+            .Times(2 * segmentNum)
+            .WillRepeatedly(Return(kMdsSuccess));
+        EXPECT_CALL(*storage_, DeleteSegment(_, _, _))
+            .Times(segmentNum)
+            .WillRepeatedly(Return(StoreStatus::OK));
+        EXPECT_CALL(*allocStatistic_, DeAllocSpace(_, _, _))
+            .Times(segmentNum);
+        EXPECT_CALL(*storage_, DeleteFile(_, _))
+            .WillOnce(Return(StoreStatus::OK));
+
+        TaskProgress progress;
+        ASSERT_EQ(StatusCode::kOK, cleanCore->CleanFile(cleanFile, &progress));
+        ASSERT_EQ(TaskStatus::SUCCESS, progress.GetStatus());
+        ASSERT_EQ(100, progress.GetProgress());
+    }
+
+    {
+        // segment is kept if its chunks are not all deleted
+        EXPECT_CALL(*storage_, GetSegment(_, _, _))
+            .WillRepeatedly(
+                DoAll(SetArgPointee<2>(segment), Return(StoreStatus::OK)));
+        EXPECT_CALL(*csClient_, DeleteChunks(_, _, _, _, _))
+            .WillRepeatedly(Return(kCsClientReturnFail));
+        EXPECT_CALL(*csClient_, DeleteChunk(_, _, _, _, _))
+            .WillRepeatedly(Return(kMdsSuccess));
+        EXPECT_CALL(*storage_, DeleteSegment(_, _, _))
+            .Times(0);
+        EXPECT_CALL(*allocStatistic_, DeAllocSpace(_, _, _))
+            .Times(0);
+        EXPECT_CALL(*storage_, DeleteFile(_, _))
+            .Times(0);
+
+        TaskProgress progress;
+        ASSERT_EQ(StatusCode::kCommonFileDeleteError,
+                  cleanCore->CleanFile(cleanFile, &progress));
+        ASSERT_EQ(TaskStatus::FAILED, progress.GetStatus());
+    }
+}
+
 }  // namespace mds
 }  // namespace curve
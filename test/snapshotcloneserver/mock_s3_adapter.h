@@ -63,6 +63,8 @@ class MockS3Adapter : public S3Adapter {
             int,
             int,
             const char*));
+    MOCK_METHOD1(UploadOnePartAsync,
+                 void(std::shared_ptr<curve::common::UploadPartAsyncContext>));
     MOCK_METHOD3(CompleteMultiUpload,
                 int(const Aws::String &,
                 const Aws::String &,
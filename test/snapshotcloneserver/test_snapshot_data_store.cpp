@@ -27,6 +27,8 @@
 #include "src/snapshotcloneserver/snapshot/snapshot_data_store.h"
 #include "test/snapshotcloneserver/mock_s3_adapter.h"
 using ::testing::_;
+using ::testing::Invoke;
+using ::curve::common::UploadPartAsyncContext;
 namespace curve {
 namespace snapshotcloneserver {
 
@@ -164,6 +166,50 @@ TEST_F(TestS3SnapshotDataStore, testDataChunkTransferAddPart) {
               DataChunkTranferAddPart(cdName, task, 2, 1024*1024, buf));
     delete [] buf;
 }
+TEST_F(TestS3SnapshotDataStore, testDataChunkTransferAddParts) {
+    EXPECT_CALL(*adapter4Meta_, Init(_)).Times(1);
+    EXPECT_CALL(*adapter4Data_, Init(_)).Times(1);
+    EXPECT_CALL(*adapter4Meta_, BucketExist()).WillOnce(Return(true));
+    ASSERT_EQ(0, store_->Init(""));
+
+    ChunkDataName cdName("test", 1, 1);
+    std::shared_ptr<TransferTask> task = std::make_shared<TransferTask>();
+    task->uploadId_ = "test-uploadID";
+    char* buf = new char[3 * 1024];
+    std::vector<DataChunkPart> parts;
+    for (int i = 0; i < 3; i++) {
+        parts.push_back({i, 1024, buf + i * 1024});
+    }
+
+    EXPECT_CALL(*adapter4Data_, UploadOnePartAsync(_))
+        .Times(3)
+        .WillRepeatedly(Invoke(
+            [&](std::shared_ptr<UploadPartAsyncContext> ctx) {
+                ASSERT_EQ("test-1-1", ctx->key);
+                ASSERT_EQ("test-uploadID", ctx->uploadId);
+                ASSERT_EQ(buf + (ctx->partNum - 1) * 1024, ctx->buffer);
+                ctx->retCode = 0;
+                ctx->etag = "etag" + std::to_string(ctx->partNum);
+                ctx->cb(ctx);
+            }));
+    ASSERT_EQ(0, store_->DataChunkTranferAddParts(cdName, task, parts));
+    auto partInfo = task->GetPartInfo();
+    ASSERT_EQ(3, partInfo.size());
+    ASSERT_EQ("etag1", partInfo[1]);
+    ASSERT_EQ("etag3", partInfo[3]);
+
+    // 分片重试后仍然失败
+    task = std::make_shared<TransferTask>();
+    EXPECT_CALL(*adapter4Data_, UploadOnePartAsync(_))
+        .WillRepeatedly(Invoke(
+            [](std::shared_ptr<UploadPartAsyncContext> ctx) {
+                ctx->retCode = (ctx->partNum == 2 ? -1 : 0);
+                ctx->cb(ctx);
+            }));
+    ASSERT_EQ(-1, store_->DataChunkTranferAddParts(cdName, task, parts));
+    ASSERT_TRUE(task->GetPartInfo().empty());
+    delete [] buf;
+}
 TEST_F(TestS3SnapshotDataStore, testDataChunkTransferComplete) {
     ChunkDataName cdName("test", 1, 1);
     std::shared_ptr<TransferTask> task = std::make_shared<TransferTask>();